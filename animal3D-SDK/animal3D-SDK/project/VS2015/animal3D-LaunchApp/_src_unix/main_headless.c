@@ -0,0 +1,304 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_headless.c
+	Unix (Mac/Linux) headless runner entry point (main): loads a demo
+		library from a demo info record with no window or rendering
+		context, drives its idle callback and reports throughput.
+
+	Build (from the SDK root):
+		cc -O2 -std=gnu89 -Isource/animal3D-LaunchApp
+			project/VS2015/animal3D-LaunchApp/_src_unix/main_headless.c
+			-o animal3D-headless -ldl
+	This builds the runner only: there is no Mac/Linux build of the demo
+		library or of the animal3D and A3DM libraries it links (see the
+		README), so one has to be provided separately.
+
+	Usage:
+		animal3D-headless [-f records] [-i index] [-l library]
+			[-r idle rate] [-n idle count] [-t seconds] [-k keys]
+	-f: demo info file (default: resource/animal3D-data/animal3D-demoinfo-headless.txt)
+	-i: record to load from the file (default 0)
+	-l: library path, overriding the record's (by default "name.dll"
+		becomes "./libname.so", or "./libname.dylib" on Mac)
+	-r: idle calls per second; zero runs as fast as possible (default 0)
+	-n: stop after this many idle calls
+	-t: stop after this many seconds (default 10 if neither limit is set)
+	-k: ASCII keys sent to the demo, in order, right after it loads
+*/
+
+
+#if !(defined _WINDOWS || defined _WIN32)
+
+
+#include "a3_dylib_config_load.h"
+#include "a3_app_utils/a3_app_load.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// hook names in the order of the callback container
+static const char *a3headlessHookName[A3NUMCALLBACKS] = {
+	"callback_load", "callback_unload", "callback_hotload",
+	"callback_display", "callback_idle",
+	"callback_windowActivate", "callback_windowDeactivate",
+	"callback_windowMove", "callback_windowResize",
+	"callback_keyPress", "callback_keyHold", "callback_keyRelease", "callback_keyCharPress", "callback_keyCharHold",
+	"callback_mouseClick", "callback_mouseDoubleClick", "callback_mouseRelease",
+	"callback_mouseWheel",
+	"callback_mouseMove",
+	"callback_mouseLeave",
+};
+
+// monotonic time in seconds
+static double a3headlessTime()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec * 1.0e-9;
+}
+
+// wait until the given time
+static void a3headlessWaitUntil(const double time)
+{
+	const double wait = time - a3headlessTime();
+	if (wait > 0.0)
+	{
+		struct timespec t;
+		t.tv_sec = (time_t)wait;
+		t.tv_nsec = (long)((wait - (double)t.tv_sec) * 1.0e9);
+		nanosleep(&t, 0);
+	}
+}
+
+// read one record from a demo info file, with the same syntax as the
+//	windowed launcher (see animal3D-demoinfo-example.txt); a leading
+//	count line is optional
+// returns 1 if the record was found, 0 if not, -1 if the file is missing
+static int a3headlessLoadRecord(a3_DemoDescriptor *record_out, const char *filePath, const unsigned int index)
+{
+	FILE *fp = fopen(filePath, "r");
+	char line[2048], *token, *save;
+	unsigned int records = 0;
+	int status = 0;
+
+	if (!fp)
+		return -1;
+
+	while (!status && fgets(line, sizeof(line), fp))
+	{
+		// only lines that start with @ mean anything; a bare number is
+		//	the record count, which the file does not need
+		token = line;
+		while (*token == ' ' || *token == '\t')
+			++token;
+		if (*token != '@')
+			continue;
+		++token;
+		while (*token == ' ' || *token == '\t')
+			++token;
+		if (*token != '[')
+			continue;
+		if (records++ != index)
+			continue;
+
+		memset(record_out, 0, sizeof(a3_DemoDescriptor));
+		if (sscanf(token, "[%31[^]]] [%31[^]]]", record_out->name, record_out->lib) != 2)
+			break;
+
+		// skip the names and the callback count, then take hook/function
+		//	pairs until the line runs out
+		token = strchr(strchr(token, ']') + 1, ']') + 1;
+		strtok_r(token, " \t\r\n", &save);
+		while (record_out->numCallbacks < A3NUMCALLBACKS &&
+			(token = strtok_r(0, " \t\r\n", &save)) && *token == ':')
+		{
+			strncpy(record_out->callbackHook[record_out->numCallbacks], token + 1, A3RECORDSTRSZ - 1);
+			if (!(token = strtok_r(0, " \t\r\n", &save)))
+				break;
+			strncpy(record_out->callbackName[record_out->numCallbacks], token, A3RECORDSTRSZ - 1);
+			++record_out->numCallbacks;
+		}
+		status = 1;
+	}
+
+	fclose(fp);
+	return status;
+}
+
+// link a record's callbacks from an open library; returns count linked
+static int a3headlessLinkCallbacks(a3_CallbackFunctions *callbacks, A3DYLIBHANDLE lib, const a3_DemoDescriptor *record)
+{
+	unsigned int i, j;
+	int count = 0;
+	memset(callbacks, 0, sizeof(a3_CallbackFunctions));
+	for (i = 0; i < record->numCallbacks; ++i)
+		for (j = 0; j < A3NUMCALLBACKS; ++j)
+			if (!strcmp(record->callbackHook[i], a3headlessHookName[j]))
+			{
+				callbacks->callback[j] = (void *)a3dylibGetSymbol(lib, record->callbackName[i]);
+				if (callbacks->callback[j])
+					++count;
+				else
+					printf(" headless: \"%s\" not found for %s\n", record->callbackName[i], record->callbackHook[i]);
+				break;
+			}
+	return count;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const char *filePath = "resource/animal3D-data/animal3D-demoinfo-headless.txt";
+	const char *libPath = 0, *keys = "";
+	char libBuffer[A3RECORDSTRSZ + 16], *ext;
+	unsigned int index = 0, idleLimit = 0;
+	double rate = 0.0, timeLimit = 0.0;
+
+	a3_DemoDescriptor record[1];
+	a3_CallbackFunctions callbacks[1];
+	A3DYLIBHANDLE lib;
+	void *data;
+	unsigned int idles = 0, updates = 0;
+	double start, now, last;
+	int i, status;
+
+	// options
+	for (i = 1; i < argc - 1; i += 2)
+	{
+		if (!strcmp(argv[i], "-f"))
+			filePath = argv[i + 1];
+		else if (!strcmp(argv[i], "-i"))
+			index = (unsigned int)atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-l"))
+			libPath = argv[i + 1];
+		else if (!strcmp(argv[i], "-r"))
+			rate = atof(argv[i + 1]);
+		else if (!strcmp(argv[i], "-n"))
+			idleLimit = (unsigned int)atoi(argv[i + 1]);
+		else if (!strcmp(argv[i], "-t"))
+			timeLimit = atof(argv[i + 1]);
+		else if (!strcmp(argv[i], "-k"))
+			keys = argv[i + 1];
+		else
+			break;
+	}
+	if (i < argc)
+	{
+		printf("usage: %s [-f records] [-i index] [-l library] [-r idle rate] [-n idle count] [-t seconds] [-k keys]\n", argv[0]);
+		return 1;
+	}
+	if (!idleLimit && timeLimit <= 0.0)
+		timeLimit = 10.0;
+
+	// record
+	status = a3headlessLoadRecord(record, filePath, index);
+	if (status <= 0)
+	{
+		printf(" headless: record %u not found in \"%s\"\n", index, filePath);
+		return 1;
+	}
+
+	// library: the records name Windows libraries
+	if (!libPath)
+	{
+		snprintf(libBuffer, sizeof(libBuffer), "./lib%s", record->lib);
+		ext = strrchr(libBuffer, '.');
+		if (ext && ext > libBuffer + 1 && !strcmp(ext, ".dll"))
+			*ext = 0;
+#ifdef __APPLE__
+		strcat(libBuffer, ".dylib");
+#else	// !__APPLE__
+		strcat(libBuffer, ".so");
+#endif	// __APPLE__
+		libPath = libBuffer;
+	}
+	lib = a3dylibLoad(libPath);
+	if (!lib)
+	{
+		printf(" headless: could not load \"%s\": %s\n", libPath, dlerror());
+		return 1;
+	}
+
+	// callbacks: a demo cannot run without load, unload and idle
+	a3headlessLinkCallbacks(callbacks, lib, record);
+	if (!callbacks->callback_load || !callbacks->callback_unload || !callbacks->callback_idle)
+	{
+		printf(" headless: \"%s\" does not link load, unload and idle\n", record->name);
+		a3dylibUnload(lib);
+		return 1;
+	}
+
+	// load, with the same calls a window makes when it opens
+	printf(" headless: %s (%s)\n", record->name, libPath);
+	data = callbacks->callback_load();
+	if (callbacks->callback_windowResize)
+		callbacks->callback_windowResize(data, 1024, 640);
+	if (callbacks->callback_windowActivate)
+		callbacks->callback_windowActivate(data);
+	if (callbacks->callback_keyCharPress)
+		while (*keys)
+			callbacks->callback_keyCharPress(data, *(keys++));
+
+	// idle until a limit is reached or the demo quits
+	start = last = a3headlessTime();
+	do
+	{
+		if (rate > 0.0)
+			a3headlessWaitUntil(start + (double)idles / rate);
+		status = callbacks->callback_idle(data);
+		++idles;
+		if (status > 0)
+			++updates;
+		now = a3headlessTime();
+
+		// progress, once a second
+		if (now - last >= 1.0)
+		{
+			printf(" headless: %u idles, %u updates, %.1f s\n", idles, updates, now - start);
+			last = now;
+		}
+	} while (status >= 0 &&
+		(!idleLimit || idles < idleLimit) &&
+		(timeLimit <= 0.0 || now - start < timeLimit));
+	now -= start;
+
+	printf("\n headless: %u idles (%.1f/s), %u updates (%.1f/s) in %.3f s%s\n",
+		idles, now > 0.0 ? (double)idles / now : 0.0,
+		updates, now > 0.0 ? (double)updates / now : 0.0,
+		now, status < 0 ? ", demo quit" : "");
+
+	// unload fully; the demo prints its own summary
+	callbacks->callback_unload(data, 0);
+	a3dylibUnload(lib);
+	return 0;
+}
+
+
+#endif	// !(defined _WINDOWS || defined _WIN32)
@@ -0,0 +1,363 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBodyStore.c
+	Body store implementation and integration kernels.
+*/
+
+#include "a3_DemoBodyStore.h"
+#include "../_utilities/a3_DemoSIMDLane.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// number of components stored per body (the last one is the flags)
+enum a3_DemoBodyStoreInternal
+{
+	a3demo_bodyStoreRealArrays = 12,
+	a3demo_bodyStoreArrays = 13,
+};
+
+
+int a3demo_createBodyStore(a3_DemoBodyStore *store, const unsigned int capacity)
+{
+	if (store && !store->memory && capacity)
+	{
+		// round capacity up so every array starts aligned and ends on a lane
+		const unsigned int padded = (capacity + a3demo_bodyStoreWidth - 1) / a3demo_bodyStoreWidth * a3demo_bodyStoreWidth;
+		const size_t arraySize = padded * sizeof(a3real);
+		const size_t totalSize = arraySize * a3demo_bodyStoreArrays + a3demo_bodyStoreAlignment;
+		a3real *base;
+		size_t address;
+
+		store->memory = malloc(totalSize);
+		if (store->memory)
+		{
+			memset(store->memory, 0, totalSize);
+			address = ((size_t)store->memory + a3demo_bodyStoreAlignment - 1) & ~((size_t)a3demo_bodyStoreAlignment - 1);
+			base = (a3real *)address;
+
+			store->posX = base + padded * 0;
+			store->posY = base + padded * 1;
+			store->posZ = base + padded * 2;
+			store->velX = base + padded * 3;
+			store->velY = base + padded * 4;
+			store->velZ = base + padded * 5;
+			store->accX = base + padded * 6;
+			store->accY = base + padded * 7;
+			store->accZ = base + padded * 8;
+			store->mass = base + padded * 9;
+			store->invMass = base + padded * 10;
+			store->radius = base + padded * 11;
+			store->flags = (unsigned int *)(base + padded * 12);
+			store->count = 0;
+			store->capacity = padded;
+			return padded;
+		}
+	}
+	return -1;
+}
+
+int a3demo_releaseBodyStore(a3_DemoBodyStore *store)
+{
+	if (store && store->memory)
+	{
+		free(store->memory);
+		memset(store, 0, sizeof(a3_DemoBodyStore));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_clearBodyStore(a3_DemoBodyStore *store)
+{
+	if (store && store->memory)
+	{
+		// whole block is contiguous from the first array
+		memset(store->posX, 0, store->capacity * sizeof(a3real) * a3demo_bodyStoreArrays);
+		store->count = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_addBody(a3_DemoBodyStore *store, const a3real *position, const a3real *velocity, const a3real mass, const a3real radius)
+{
+	if (store && store->memory && position && store->count < store->capacity)
+	{
+		const unsigned int i = store->count++;
+		store->posX[i] = position[0];
+		store->posY[i] = position[1];
+		store->posZ[i] = position[2];
+		store->velX[i] = velocity ? velocity[0] : a3realZero;
+		store->velY[i] = velocity ? velocity[1] : a3realZero;
+		store->velZ[i] = velocity ? velocity[2] : a3realZero;
+		store->accX[i] = store->accY[i] = store->accZ[i] = a3realZero;
+		store->mass[i] = mass;
+		store->invMass[i] = mass > a3realZero ? a3recip(mass) : a3realZero;
+		store->radius[i] = radius;
+		store->flags[i] = 0;
+		return i;
+	}
+	return -1;
+}
+
+int a3demo_removeBody(a3_DemoBodyStore *store, const unsigned int index)
+{
+	if (store && store->memory && index < store->count)
+	{
+		const unsigned int last = --store->count;
+		a3real *arr = store->posX;
+		unsigned int j;
+
+		// each array is capacity long and they sit back to back
+		for (j = 0; j < a3demo_bodyStoreRealArrays; ++j, arr += store->capacity)
+		{
+			arr[index] = arr[last];
+			arr[last] = a3realZero;
+		}
+		store->flags[index] = store->flags[last];
+		store->flags[last] = 0;
+		return store->count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+#if defined(A3_SIMD_AVX)
+// eight-wide mask of bodies that move; AVX has no eight-wide integer
+//	compare, so it is put together from two four-wide halves
+inline __m256 a3demo_bodyLaneMoving(const unsigned int *flags)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(a3demo_simdBitsClear(flags, a3demo_bodyFlags_held)),
+		a3demo_simdBitsClear(flags + 4, a3demo_bodyFlags_held), 1);
+}
+#endif	// A3_SIMD_AVX
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_clearBodyAccelerations(a3_DemoBodyStore *store)
+{
+	if (store && store->memory)
+	{
+		// acceleration arrays are adjacent
+		memset(store->accX, 0, store->capacity * sizeof(a3real) * 3);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_integrateBodyStore(a3_DemoBodyStore *store, const a3real dt)
+{
+	if (store && store->memory)
+	{
+		// run to the end of the last lane; padding is zero so it stays zero
+		const unsigned int n = (store->count + a3demo_bodyStoreWidth - 1) / a3demo_bodyStoreWidth * a3demo_bodyStoreWidth;
+		a3real *const px = store->posX, *const py = store->posY, *const pz = store->posZ;
+		a3real *const vx = store->velX, *const vy = store->velY, *const vz = store->velZ;
+		const a3real *const ax = store->accX, *const ay = store->accY, *const az = store->accZ;
+		const unsigned int *const flags = store->flags;
+		unsigned int i;
+
+		// held lanes step by zero, which leaves them exactly as they were
+#if defined(A3_SIMD_AVX)
+		const __m256 dt8 = _mm256_set1_ps(dt);
+		__m256 t, v;
+		for (i = 0; i < n; i += 8)
+		{
+			t = _mm256_and_ps(dt8, a3demo_bodyLaneMoving(flags + i));
+			v = _mm256_add_ps(_mm256_load_ps(vx + i), _mm256_mul_ps(_mm256_load_ps(ax + i), t));
+			_mm256_store_ps(vx + i, v);
+			_mm256_store_ps(px + i, _mm256_add_ps(_mm256_load_ps(px + i), _mm256_mul_ps(v, t)));
+			v = _mm256_add_ps(_mm256_load_ps(vy + i), _mm256_mul_ps(_mm256_load_ps(ay + i), t));
+			_mm256_store_ps(vy + i, v);
+			_mm256_store_ps(py + i, _mm256_add_ps(_mm256_load_ps(py + i), _mm256_mul_ps(v, t)));
+			v = _mm256_add_ps(_mm256_load_ps(vz + i), _mm256_mul_ps(_mm256_load_ps(az + i), t));
+			_mm256_store_ps(vz + i, v);
+			_mm256_store_ps(pz + i, _mm256_add_ps(_mm256_load_ps(pz + i), _mm256_mul_ps(v, t)));
+		}
+#elif defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+		const a3_DemoSIMDLane dt4 = a3demo_simdSet(dt);
+		a3_DemoSIMDLane t, v;
+		for (i = 0; i < n; i += 4)
+		{
+			t = a3demo_simdAnd(dt4, a3demo_simdBitsClear(flags + i, a3demo_bodyFlags_held));
+			v = a3demo_simdAdd(a3demo_simdLoad(vx + i), a3demo_simdMul(a3demo_simdLoad(ax + i), t));
+			a3demo_simdStore(vx + i, v);
+			a3demo_simdStore(px + i, a3demo_simdAdd(a3demo_simdLoad(px + i), a3demo_simdMul(v, t)));
+			v = a3demo_simdAdd(a3demo_simdLoad(vy + i), a3demo_simdMul(a3demo_simdLoad(ay + i), t));
+			a3demo_simdStore(vy + i, v);
+			a3demo_simdStore(py + i, a3demo_simdAdd(a3demo_simdLoad(py + i), a3demo_simdMul(v, t)));
+			v = a3demo_simdAdd(a3demo_simdLoad(vz + i), a3demo_simdMul(a3demo_simdLoad(az + i), t));
+			a3demo_simdStore(vz + i, v);
+			a3demo_simdStore(pz + i, a3demo_simdAdd(a3demo_simdLoad(pz + i), a3demo_simdMul(v, t)));
+		}
+#else
+		for (i = 0; i < n; ++i)
+		{
+			if (flags[i] & a3demo_bodyFlags_held)
+				continue;
+			vx[i] += ax[i] * dt;
+			vy[i] += ay[i] * dt;
+			vz[i] += az[i] * dt;
+			px[i] += vx[i] * dt;
+			py[i] += vy[i] * dt;
+			pz[i] += vz[i] * dt;
+		}
+#endif	// A3_SIMD_AVX
+
+		return store->count;
+	}
+	return -1;
+}
+
+
+int a3demo_kickBodyStore(a3_DemoBodyStore *store, const a3real dt)
+{
+	if (store && store->memory)
+	{
+		a3demo_bodyArrayMulAdd(store->velX, store->velX, store->accX, dt, store->flags, store->count);
+		a3demo_bodyArrayMulAdd(store->velY, store->velY, store->accY, dt, store->flags, store->count);
+		a3demo_bodyArrayMulAdd(store->velZ, store->velZ, store->accZ, dt, store->flags, store->count);
+		return store->count;
+	}
+	return -1;
+}
+
+int a3demo_driftBodyStore(a3_DemoBodyStore *store, const a3real dt)
+{
+	if (store && store->memory)
+	{
+		a3demo_bodyArrayMulAdd(store->posX, store->posX, store->velX, dt, store->flags, store->count);
+		a3demo_bodyArrayMulAdd(store->posY, store->posY, store->velY, dt, store->flags, store->count);
+		a3demo_bodyArrayMulAdd(store->posZ, store->posZ, store->velZ, dt, store->flags, store->count);
+		return store->count;
+	}
+	return -1;
+}
+
+int a3demo_bodyArrayMulAdd(a3real *out, const a3real *a, const a3real *b, const a3real s, const unsigned int *flags, const unsigned int count)
+{
+	if (out && a && b && flags)
+	{
+		const unsigned int n = (count + a3demo_bodyStoreWidth - 1) / a3demo_bodyStoreWidth * a3demo_bodyStoreWidth;
+		unsigned int i;
+
+#if defined(A3_SIMD_AVX)
+		const __m256 s8 = _mm256_set1_ps(s);
+		for (i = 0; i < n; i += 8)
+			_mm256_store_ps(out + i, _mm256_add_ps(_mm256_load_ps(a + i), _mm256_mul_ps(_mm256_load_ps(b + i),
+				_mm256_and_ps(s8, a3demo_bodyLaneMoving(flags + i)))));
+#elif defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+		const a3_DemoSIMDLane s4 = a3demo_simdSet(s);
+		for (i = 0; i < n; i += 4)
+			a3demo_simdStore(out + i, a3demo_simdAdd(a3demo_simdLoad(a + i), a3demo_simdMul(a3demo_simdLoad(b + i),
+				a3demo_simdAnd(s4, a3demo_simdBitsClear(flags + i, a3demo_bodyFlags_held)))));
+#else
+		for (i = 0; i < n; ++i)
+			out[i] = flags[i] & a3demo_bodyFlags_held ? a[i] : a[i] + b[i] * s;
+#endif	// A3_SIMD_AVX
+
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_getBodyStoreAngularMomentum(const a3_DemoBodyStore *store, double *momentum_out)
+{
+	if (store && store->memory && momentum_out)
+	{
+		// double so long runs measure drift, not round-off
+		double lx = 0.0, ly = 0.0, lz = 0.0;
+		unsigned int i;
+		for (i = 0; i < store->count; ++i)
+		{
+			lx += (double)store->mass[i] * ((double)store->posY[i] * store->velZ[i] - (double)store->posZ[i] * store->velY[i]);
+			ly += (double)store->mass[i] * ((double)store->posZ[i] * store->velX[i] - (double)store->posX[i] * store->velZ[i]);
+			lz += (double)store->mass[i] * ((double)store->posX[i] * store->velY[i] - (double)store->posY[i] * store->velX[i]);
+		}
+		momentum_out[0] = lx;
+		momentum_out[1] = ly;
+		momentum_out[2] = lz;
+		return store->count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_writeBodyPositions(const a3_DemoBodyStore *store, a3_DemoSceneObject *sceneObjects, const unsigned int first, const unsigned int count)
+{
+	if (store && store->memory && sceneObjects && first + count <= store->count)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i, ++sceneObjects)
+			if (!(store->flags[first + i] & a3demo_bodyFlag_sleeping))
+			{
+				sceneObjects->position.x = store->posX[first + i];
+				sceneObjects->position.y = store->posY[first + i];
+				sceneObjects->position.z = store->posZ[first + i];
+				a3demo_wakeSceneObject(sceneObjects);
+			}
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_packBodyPositions(const a3_DemoBodyStore *store, a3real *positions_out, const unsigned int first, const unsigned int count)
+{
+	if (store && store->memory && positions_out && first + count <= store->count)
+	{
+		const a3real *px = store->posX + first, *py = store->posY + first, *pz = store->posZ + first;
+		unsigned int i;
+		for (i = 0; i < count; ++i, positions_out += 3)
+		{
+			positions_out[0] = px[i];
+			positions_out[1] = py[i];
+			positions_out[2] = pz[i];
+		}
+		return count;
+	}
+	return -1;
+}
+
+const char *a3demo_getBodyStoreKernelName()
+{
+#if defined(A3_SIMD_AVX)
+	return "AVX";
+#elif defined(A3_SIMD_SSE)
+	return "SSE";
+#elif defined(A3_SIMD_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif	// A3_SIMD_AVX
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBodyStore.h
+	Structure-of-arrays storage for simulated bodies.
+*/
+
+#ifndef __ANIMAL3D_DEMOBODYSTORE_H
+#define __ANIMAL3D_DEMOBODYSTORE_H
+
+
+// math library
+#include "animal3D/a3math/A3DM.h"
+
+// scene objects for write-back
+#include "../_utilities/a3_DemoSceneObject.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoBodyStore	a3_DemoBodyStore;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// body store constants
+	enum a3_DemoBodyStoreConstants
+	{
+		a3demo_bodyStoreAlignment = 32,	// bytes; enough for AVX loads
+		a3demo_bodyStoreWidth = 8,		// capacity is padded to a multiple of this
+	};
+
+	// per-body flags
+	enum a3_DemoBodyFlag
+	{
+		a3demo_bodyFlag_kepler = 0x1,	// position comes from an analytic orbit
+		a3demo_bodyFlag_sleeping = 0x2,	// at rest; position is not changing
+		a3demo_bodyFlag_fast = 0x4,		// moved far enough this step to need sweeping
+		a3demo_bodyFlag_impact = 0x8,	// held back to its first impact this step
+
+		a3demo_bodyFlags_held = a3demo_bodyFlag_kepler | a3demo_bodyFlag_sleeping,	// bodies the integration kernels leave alone
+	};
+
+
+	// body store: one aligned array per component so that integration
+	//	only streams the data it actually touches
+	// padding slots past the count are kept at zero so kernels can run
+	//	over whole SIMD lanes without a scalar tail
+	struct a3_DemoBodyStore
+	{
+		a3real *posX, *posY, *posZ;		// position
+		a3real *velX, *velY, *velZ;		// velocity
+		a3real *accX, *accY, *accZ;		// acceleration accumulated this step
+		a3real *mass;					// mass
+		a3real *invMass;				// inverse mass (zero is immovable)
+		a3real *radius;					// bounding radius
+		unsigned int *flags;			// a3_DemoBodyFlag bits
+		void *memory;					// single raw allocation for all arrays
+		unsigned int count;				// number of live bodies
+		unsigned int capacity;			// padded capacity
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// allocate store for at least the requested number of bodies
+	int a3demo_createBodyStore(a3_DemoBodyStore *store, const unsigned int capacity);
+	int a3demo_releaseBodyStore(a3_DemoBodyStore *store);
+
+	// remove all bodies
+	int a3demo_clearBodyStore(a3_DemoBodyStore *store);
+
+	// add body; returns index or -1 if full
+	int a3demo_addBody(a3_DemoBodyStore *store, const a3real *position, const a3real *velocity, const a3real mass, const a3real radius);
+
+	// remove body by moving the last one into its slot; returns new count
+	int a3demo_removeBody(a3_DemoBodyStore *store, const unsigned int index);
+
+	// zero accelerations before accumulating forces
+	int a3demo_clearBodyAccelerations(a3_DemoBodyStore *store);
+
+	// semi-implicit Euler: v += a dt, then x += v dt; held bodies keep
+	//	their position and velocity here and in the kernels below
+	int a3demo_integrateBodyStore(a3_DemoBodyStore *store, const a3real dt);
+
+	// kick (v += a dt) and drift (x += v dt) on their own, for integrators
+	//	that split the step
+	int a3demo_kickBodyStore(a3_DemoBodyStore *store, const a3real dt);
+	int a3demo_driftBodyStore(a3_DemoBodyStore *store, const a3real dt);
+
+	// lane kernel over padded arrays: out = a + b * s, or out = a for
+	//	bodies whose flags hold any a3demo_bodyFlags_held bit; count is
+	//	rounded up to the lane width, so arrays must come from a body
+	//	store allocation
+	int a3demo_bodyArrayMulAdd(a3real *out, const a3real *a, const a3real *b, const a3real s, const unsigned int *flags, const unsigned int count);
+
+	// total angular momentum about the origin
+	int a3demo_getBodyStoreAngularMomentum(const a3_DemoBodyStore *store, double *momentum_out);
+
+	// copy positions into scene objects (rendering only), waking them;
+	//	sleeping bodies are skipped so their objects stay asleep
+	int a3demo_writeBodyPositions(const a3_DemoBodyStore *store, a3_DemoSceneObject *sceneObjects, const unsigned int first, const unsigned int count);
+
+	// interleave positions (xyz xyz ...) for upload
+	int a3demo_packBodyPositions(const a3_DemoBodyStore *store, a3real *positions_out, const unsigned int first, const unsigned int count);
+
+	// name of the kernel set compiled in
+	const char *a3demo_getBodyStoreKernelName();
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOBODYSTORE_H
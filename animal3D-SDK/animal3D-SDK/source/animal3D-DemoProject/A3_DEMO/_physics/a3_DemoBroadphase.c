@@ -0,0 +1,627 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBroadphase.c
+	Sweep-and-prune and spatial hash broadphase implementation.
+*/
+
+#include "a3_DemoBroadphase.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// broadphase internal constants
+enum a3_DemoBroadphaseInternal
+{
+	a3demo_broadphaseRadixBits = 11,		// three passes over 32-bit keys
+	a3demo_broadphaseRadixSize = 1 << a3demo_broadphaseRadixBits,
+	a3demo_broadphaseHashNeighbors = 4,		// forward half of the 8 neighbor cells
+	a3demo_broadphaseCellLimit = 1 << 30,	// cell coordinate clamp
+};
+
+// forward neighbor cell offsets (u, v); with their negatives and the cell
+//	itself these cover the 3x3 block, so each neighboring pair of cells is
+//	visited exactly once
+static const int a3demo_broadphaseNeighbor[a3demo_broadphaseHashNeighbors][2] = {
+	{ 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 },
+};
+
+// arguments for the sweeps; chunk c covers items [c*count/chunks, (c+1)*count/chunks)
+typedef struct a3_DemoBroadphaseTask
+{
+	a3_DemoBroadphase *broadphase;
+	unsigned int count;				// slots (sweep-and-prune) or cells (hash)
+	a3real reach;					// largest diameter
+	const unsigned int *flags;		// body flags when sleeping pairs are left out
+	unsigned int failed;
+} a3_DemoBroadphaseTask;
+
+
+// float to unsigned key with the same ordering
+inline unsigned int a3demo_broadphaseRadixKey(const a3real value)
+{
+	union { a3real f; unsigned int u; } bits;
+	bits.f = value;
+	return bits.u ^ ((bits.u >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+// hash of a cell on the cross axes: row-major with wraparound, so cells
+//	that are neighbors in space are mostly neighbors in the table too
+inline unsigned int a3demo_broadphaseHash(const int u, const int v, const unsigned int tableSize, const unsigned int tableStride)
+{
+	return ((unsigned int)u + (unsigned int)v * tableStride) & (tableSize - 1);
+}
+
+// cell coordinate of a value
+inline int a3demo_broadphaseCell(const a3real value, const a3real invCellSize)
+{
+	const a3real c = floorf(value * invCellSize);
+	return c < -(a3real)a3demo_broadphaseCellLimit ? -a3demo_broadphaseCellLimit
+		: c > (a3real)a3demo_broadphaseCellLimit ? a3demo_broadphaseCellLimit : (int)c;
+}
+
+// grow the per-body workspace; invalidates the kept order
+int a3demo_broadphaseReserve(a3_DemoBroadphase *broadphase, const unsigned int count)
+{
+	unsigned int capacity, tableSize, tableStride, bodyArrays, tableArrays;
+	unsigned char *block;
+
+	if (broadphase->capacity >= count && broadphase->memory)
+		return 1;
+
+	capacity = count + count / 2 + 1;
+	for (tableSize = 64; tableSize < capacity; tableSize <<= 1);
+	for (tableStride = 8; tableStride * tableStride < tableSize; tableStride <<= 1);
+
+	// 4-byte elements only, so everything stays aligned: order, scratch,
+	//	sortKey, sortScratch, minS, maxS, posU, posV, radius, cellU, cellV,
+	//	bucket and cellStart per body; bucketStart and bucketCell per bucket
+	bodyArrays = 13;
+	tableArrays = 2;
+	block = (unsigned char *)malloc((bodyArrays * (capacity + 1) + tableArrays * (tableSize + 1)) * 4);
+	if (!block)
+		return -1;
+	free(broadphase->memory);
+	broadphase->memory = block;
+	broadphase->order = (unsigned int *)block;			block += (capacity + 1) * 4;
+	broadphase->scratch = (unsigned int *)block;		block += (capacity + 1) * 4;
+	broadphase->sortKey = (unsigned int *)block;		block += (capacity + 1) * 4;
+	broadphase->sortScratch = (unsigned int *)block;	block += (capacity + 1) * 4;
+	broadphase->minS = (a3real *)block;					block += (capacity + 1) * 4;
+	broadphase->maxS = (a3real *)block;					block += (capacity + 1) * 4;
+	broadphase->posU = (a3real *)block;					block += (capacity + 1) * 4;
+	broadphase->posV = (a3real *)block;					block += (capacity + 1) * 4;
+	broadphase->radius = (a3real *)block;				block += (capacity + 1) * 4;
+	broadphase->cellU = (int *)block;					block += (capacity + 1) * 4;
+	broadphase->cellV = (int *)block;					block += (capacity + 1) * 4;
+	broadphase->bucket = (unsigned int *)block;			block += (capacity + 1) * 4;
+	broadphase->cellStart = (unsigned int *)block;		block += (capacity + 1) * 4;
+	broadphase->bucketStart = (unsigned int *)block;	block += (tableSize + 1) * 4;
+	broadphase->bucketCell = (unsigned int *)block;
+	broadphase->capacity = capacity;
+	broadphase->tableSize = tableSize;
+	broadphase->tableStride = tableStride;
+	broadphase->count = 0;
+	return 1;
+}
+
+// LSD radix sort of order by sortKey
+void a3demo_broadphaseRadixSort(a3_DemoBroadphase *broadphase, const unsigned int count)
+{
+	unsigned int histogram[a3demo_broadphaseRadixSize];
+	unsigned int *key = broadphase->sortKey, *keyOut = broadphase->sortScratch;
+	unsigned int *index = broadphase->order, *indexOut = broadphase->scratch, *swap;
+	unsigned int shift, i, d, sum, t;
+
+	for (shift = 0; shift < 32; shift += a3demo_broadphaseRadixBits)
+	{
+		memset(histogram, 0, sizeof(histogram));
+		for (i = 0; i < count; ++i)
+			++histogram[(key[i] >> shift) & (a3demo_broadphaseRadixSize - 1)];
+		for (d = sum = 0; d < a3demo_broadphaseRadixSize; ++d)
+		{
+			t = histogram[d];
+			histogram[d] = sum;
+			sum += t;
+		}
+		for (i = 0; i < count; ++i)
+		{
+			d = histogram[(key[i] >> shift) & (a3demo_broadphaseRadixSize - 1)]++;
+			keyOut[d] = key[i];
+			indexOut[d] = index[i];
+		}
+		swap = key; key = keyOut; keyOut = swap;
+		swap = index; index = indexOut; indexOut = swap;
+	}
+
+	// the passes ping-pong between arrays; keep whichever holds the result
+	broadphase->sortKey = key;
+	broadphase->sortScratch = keyOut;
+	broadphase->order = index;
+	broadphase->scratch = indexOut;
+}
+
+// hash sort order: cell first, then interval start
+inline int a3demo_broadphaseHashAfter(const int u0, const int v0, const a3real s0, const int u1, const int v1, const a3real s1)
+{
+	return u0 != u1 ? u0 > u1 : v0 != v1 ? v0 > v1 : s0 > s1;
+}
+
+// append a pair to a chunk; two sleepers cannot have moved into each
+//	other, so their pair is dropped when flags are given
+inline int a3demo_broadphaseEmit(a3_DemoBroadphaseChunk *chunk, const unsigned int *flags, const unsigned int a, const unsigned int b)
+{
+	if (flags && (flags[a] & flags[b] & a3demo_bodyFlag_sleeping))
+		return 1;
+	if (chunk->count == chunk->capacity)
+	{
+		const unsigned int capacity = chunk->capacity ? chunk->capacity * 2 : 256;
+		a3_DemoBodyPair *pair = (a3_DemoBodyPair *)realloc(chunk->pair, capacity * sizeof(a3_DemoBodyPair));
+		if (!pair)
+			return 0;
+		chunk->pair = pair;
+		chunk->capacity = capacity;
+	}
+	chunk->pair[chunk->count].a = a < b ? a : b;
+	chunk->pair[chunk->count].b = a < b ? b : a;
+	++chunk->count;
+	return 1;
+}
+
+// cross-axis overlap of two sorted slots
+inline int a3demo_broadphaseOverlapUV(const a3_DemoBroadphase *broadphase, const unsigned int i, const unsigned int j)
+{
+	const a3real r = broadphase->radius[i] + broadphase->radius[j];
+	return a3absolute(broadphase->posU[i] - broadphase->posU[j]) <= r
+		&& a3absolute(broadphase->posV[i] - broadphase->posV[j]) <= r;
+}
+
+// sweep-and-prune: each slot against the slots after it that start
+//	before it ends
+void a3demo_broadphaseSweepJob(a3_DemoBroadphaseTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoBroadphase *broadphase = task->broadphase;
+	const a3real *minS = broadphase->minS, *maxS = broadphase->maxS;
+	const unsigned int *order = broadphase->order;
+	const unsigned int n = task->count;
+	unsigned int c, i, j, end;
+	a3real hi;
+
+	for (c = first; c < first + count; ++c)
+	{
+		a3_DemoBroadphaseChunk *chunk = broadphase->chunk + c;
+		chunk->count = 0;
+		end = (unsigned int)((unsigned long long)(c + 1) * n / broadphase->chunkCount);
+		for (i = (unsigned int)((unsigned long long)c * n / broadphase->chunkCount); i < end; ++i)
+		{
+			hi = maxS[i];
+			for (j = i + 1; j < n && minS[j] <= hi; ++j)
+				if (a3demo_broadphaseOverlapUV(broadphase, i, j))
+					if (!a3demo_broadphaseEmit(chunk, task->flags, order[i], order[j]))
+						task->failed = 1;
+		}
+	}
+}
+
+// spatial hash: each cell swept against itself and its forward neighbors
+void a3demo_broadphaseHashJob(a3_DemoBroadphaseTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoBroadphase *broadphase = task->broadphase;
+	const a3real *minS = broadphase->minS, *maxS = broadphase->maxS;
+	const unsigned int *order = broadphase->order, *cellStart = broadphase->cellStart;
+	const a3real reach = task->reach;
+	unsigned int neighborStart[a3demo_broadphaseHashNeighbors], neighborEnd[a3demo_broadphaseHashNeighbors];
+	unsigned int c, cell, i, j, k, end, cellEnd, bucket, neighbors;
+	int u, v;
+	a3real lo, hi;
+
+	for (c = first; c < first + count; ++c)
+	{
+		a3_DemoBroadphaseChunk *chunk = broadphase->chunk + c;
+		chunk->count = 0;
+		end = (unsigned int)((unsigned long long)(c + 1) * task->count / broadphase->chunkCount);
+		for (cell = (unsigned int)((unsigned long long)c * task->count / broadphase->chunkCount); cell < end; ++cell)
+		{
+			cellEnd = cellStart[cell + 1];
+			u = broadphase->cellU[cellStart[cell]];
+			v = broadphase->cellV[cellStart[cell]];
+
+			// find occupied neighbors; hash collisions share a bucket, so
+			//	match the exact cell among the bucket's cells
+			for (k = neighbors = 0; k < a3demo_broadphaseHashNeighbors; ++k)
+			{
+				const int nu = u + a3demo_broadphaseNeighbor[k][0], nv = v + a3demo_broadphaseNeighbor[k][1];
+				bucket = a3demo_broadphaseHash(nu, nv, broadphase->tableSize, broadphase->tableStride);
+				for (j = broadphase->bucketCell[bucket]; j < broadphase->bucketCell[bucket + 1]; ++j)
+					if (broadphase->cellU[cellStart[j]] == nu && broadphase->cellV[cellStart[j]] == nv)
+					{
+						neighborStart[neighbors] = cellStart[j];
+						neighborEnd[neighbors] = cellStart[j + 1];
+						++neighbors;
+						break;
+					}
+			}
+
+			for (i = cellStart[cell]; i < cellEnd; ++i)
+			{
+				lo = minS[i];
+				hi = maxS[i];
+
+				// same cell: everything after i that starts before it ends
+				for (j = i + 1; j < cellEnd && minS[j] <= hi; ++j)
+					if (a3demo_broadphaseOverlapUV(broadphase, i, j))
+						if (!a3demo_broadphaseEmit(chunk, task->flags, order[i], order[j]))
+							task->failed = 1;
+
+				// neighbors: skip slots that must end before i starts (the
+				//	skip only moves forward since both lists are sorted),
+				//	then the same sweep with the lower bound checked too
+				for (k = 0; k < neighbors; ++k)
+				{
+					while (neighborStart[k] < neighborEnd[k] && minS[neighborStart[k]] < lo - reach)
+						++neighborStart[k];
+					for (j = neighborStart[k]; j < neighborEnd[k] && minS[j] <= hi; ++j)
+						if (maxS[j] >= lo && a3demo_broadphaseOverlapUV(broadphase, i, j))
+							if (!a3demo_broadphaseEmit(chunk, task->flags, order[i], order[j]))
+								task->failed = 1;
+				}
+			}
+		}
+	}
+}
+
+// run a sweep over chunks and concatenate their output
+int a3demo_broadphaseGather(a3_DemoBroadphase *broadphase, a3_DemoBroadphaseTask *task, a3_DemoJobFunc func, const unsigned int bodyCount)
+{
+	a3_DemoJobSystem *jobs = bodyCount >= broadphase->parallelThreshold ? broadphase->jobs : 0;
+	unsigned int c, total;
+
+	// a few chunks per worker so uneven regions balance out
+	broadphase->chunkCount = jobs ? a3minimum(jobs->workerCount * 8, a3demo_broadphaseMaxChunks) : 1;
+	broadphase->chunkCount = a3maximum(a3minimum(broadphase->chunkCount, task->count), 1);
+	task->broadphase = broadphase;
+	task->failed = 0;
+	a3demo_parallelFor(jobs, func, task, broadphase->chunkCount, 1);
+	if (task->failed)
+		return -1;
+
+	for (c = total = 0; c < broadphase->chunkCount; ++c)
+		total += broadphase->chunk[c].count;
+	if (broadphase->pairCapacity < total)
+	{
+		const unsigned int capacity = total + total / 2;
+		free(broadphase->pair);
+		broadphase->pair = (a3_DemoBodyPair *)malloc(capacity * sizeof(a3_DemoBodyPair));
+		broadphase->pairCapacity = broadphase->pair ? capacity : 0;
+		if (!broadphase->pair)
+			return -1;
+	}
+	for (c = total = 0; c < broadphase->chunkCount; ++c)
+	{
+		memcpy(broadphase->pair + total, broadphase->chunk[c].pair, broadphase->chunk[c].count * sizeof(a3_DemoBodyPair));
+		total += broadphase->chunk[c].count;
+	}
+	broadphase->pairCount = total;
+	return total;
+}
+
+// axis with the widest spread of centers
+unsigned int a3demo_broadphaseWidestAxis(const a3_DemoBodyStore *bodies, const unsigned int current)
+{
+	const a3real *pos[3] = { bodies->posX, bodies->posY, bodies->posZ };
+	const unsigned int n = bodies->count;
+	double sum, sumSq, spread[3];
+	unsigned int a, i, best = current;
+
+	for (a = 0; a < 3; ++a)
+	{
+		for (i = 0, sum = sumSq = 0.0; i < n; ++i)
+		{
+			sum += pos[a][i];
+			sumSq += pos[a][i] * pos[a][i];
+		}
+		spread[a] = sumSq - sum * sum / (double)n;
+	}
+
+	// only switch for a clear win: every switch costs a full re-sort
+	for (a = 0; a < 3; ++a)
+		if (spread[a] > spread[best] * 1.5)
+			best = a;
+	return best;
+}
+
+// sweep-and-prune update
+int a3demo_broadphaseSweepAndPrune(a3_DemoBroadphase *broadphase, const a3_DemoBodyStore *bodies)
+{
+	const unsigned int n = bodies->count;
+	const unsigned int axis = a3demo_broadphaseWidestAxis(bodies, broadphase->axis);
+	const a3real *pos[3] = { bodies->posX, bodies->posY, bodies->posZ };
+	const a3real *posS = pos[axis], *posU = pos[(axis + 1) % 3], *posV = pos[(axis + 2) % 3];
+	a3_DemoBroadphaseTask task[1];
+	unsigned int *order;
+	a3real *minS;
+	unsigned int i, j, b, swaps = 0;
+	a3real key;
+
+	// start over if the bodies or the axis changed, otherwise refresh the
+	//	kept order's keys and let insertion sort fix the few that moved
+	if (broadphase->count != n || broadphase->axis != axis)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			broadphase->order[i] = i;
+			broadphase->sortKey[i] = a3demo_broadphaseRadixKey(posS[i] - bodies->radius[i]);
+		}
+		a3demo_broadphaseRadixSort(broadphase, n);
+		broadphase->count = n;
+		broadphase->axis = axis;
+		++broadphase->rebuilds;
+	}
+	order = broadphase->order;
+	minS = broadphase->minS;
+	for (i = 0; i < n; ++i)
+	{
+		b = order[i];
+		minS[i] = posS[b] - bodies->radius[b];
+	}
+	for (i = 1; i < n; ++i)
+	{
+		key = minS[i];
+		if (minS[i - 1] > key)
+		{
+			b = order[i];
+			for (j = i; j > 0 && minS[j - 1] > key; --j)
+			{
+				minS[j] = minS[j - 1];
+				order[j] = order[j - 1];
+			}
+			minS[j] = key;
+			order[j] = b;
+			swaps += i - j;
+		}
+	}
+	broadphase->swaps = swaps;
+
+	// gather the rest in sweep order
+	for (i = 0; i < n; ++i)
+	{
+		b = order[i];
+		broadphase->maxS[i] = posS[b] + bodies->radius[b];
+		broadphase->posU[i] = posU[b];
+		broadphase->posV[i] = posV[b];
+		broadphase->radius[i] = bodies->radius[b];
+	}
+
+	task->count = n;
+	task->flags = broadphase->keepSleeping ? 0 : bodies->flags;
+	return a3demo_broadphaseGather(broadphase, task, (a3_DemoJobFunc)a3demo_broadphaseSweepJob, n);
+}
+
+// spatial hash update
+int a3demo_broadphaseSpatialHash(a3_DemoBroadphase *broadphase, const a3_DemoBodyStore *bodies)
+{
+	const unsigned int n = bodies->count, tableSize = broadphase->tableSize;
+	a3_DemoBroadphaseTask task[1];
+	unsigned int *order, *bucketStart = broadphase->bucketStart;
+	a3real *minS;
+	int *cellU, *cellV;
+	unsigned int i, j, b, t, sum, count, swaps = 0;
+	int u, v;
+	a3real maxRadius = a3realZero, cellSize, invCellSize, key;
+
+	// cells must be at least as wide as the widest body so overlapping
+	//	bodies are never more than one cell apart
+	for (i = 0; i < n; ++i)
+		maxRadius = a3maximum(maxRadius, bodies->radius[i]);
+	cellSize = a3maximum(broadphase->cellSize, maxRadius * a3realTwo);
+	if (cellSize <= a3realZero)
+		cellSize = a3realOne;
+	invCellSize = a3recip(cellSize);
+	broadphase->cellSizeUsed = cellSize;
+	broadphase->axis = 0;
+
+	// start from an x-sorted order if there is nothing to keep; either way
+	//	the stable bucket sort below keeps each bucket nearly sorted
+	if (broadphase->count != n)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			broadphase->order[i] = i;
+			broadphase->sortKey[i] = a3demo_broadphaseRadixKey(bodies->posX[i] - bodies->radius[i]);
+		}
+		a3demo_broadphaseRadixSort(broadphase, n);
+		broadphase->count = n;
+		++broadphase->rebuilds;
+	}
+
+	// bucket sort, stable over the kept order
+	//	(the radix key arrays are free by now and hold each body's cell)
+	memset(bucketStart, 0, (tableSize + 1) * sizeof(unsigned int));
+	for (i = 0; i < n; ++i)
+	{
+		u = a3demo_broadphaseCell(bodies->posY[i], invCellSize);
+		v = a3demo_broadphaseCell(bodies->posZ[i], invCellSize);
+		broadphase->sortKey[i] = (unsigned int)u;
+		broadphase->sortScratch[i] = (unsigned int)v;
+		t = broadphase->bucket[i] = a3demo_broadphaseHash(u, v, tableSize, broadphase->tableStride);
+		++bucketStart[t];
+	}
+	for (t = sum = 0; t <= tableSize; ++t)
+	{
+		count = bucketStart[t];
+		bucketStart[t] = sum;
+		sum += count;
+	}
+	for (i = 0; i < n; ++i)
+	{
+		b = broadphase->order[i];
+		broadphase->scratch[bucketStart[broadphase->bucket[b]]++] = b;
+	}
+	for (t = tableSize; t > 0; --t)
+		bucketStart[t] = bucketStart[t - 1];
+	bucketStart[0] = 0;
+	order = broadphase->scratch;
+	broadphase->scratch = broadphase->order;
+	broadphase->order = order;
+
+	// within each bucket: by cell, then by x
+	minS = broadphase->minS;
+	cellU = broadphase->cellU;
+	cellV = broadphase->cellV;
+	for (i = 0; i < n; ++i)
+	{
+		b = order[i];
+		minS[i] = bodies->posX[b] - bodies->radius[b];
+		cellU[i] = (int)broadphase->sortKey[b];
+		cellV[i] = (int)broadphase->sortScratch[b];
+	}
+	for (t = 0; t < tableSize; ++t)
+		for (i = bucketStart[t] + 1; i < bucketStart[t + 1]; ++i)
+		{
+			key = minS[i];
+			u = cellU[i];
+			v = cellV[i];
+			if (a3demo_broadphaseHashAfter(cellU[i - 1], cellV[i - 1], minS[i - 1], u, v, key))
+			{
+				b = order[i];
+				for (j = i; j > bucketStart[t] && a3demo_broadphaseHashAfter(cellU[j - 1], cellV[j - 1], minS[j - 1], u, v, key); --j)
+				{
+					minS[j] = minS[j - 1];
+					cellU[j] = cellU[j - 1];
+					cellV[j] = cellV[j - 1];
+					order[j] = order[j - 1];
+				}
+				minS[j] = key;
+				cellU[j] = u;
+				cellV[j] = v;
+				order[j] = b;
+				swaps += i - j;
+			}
+		}
+	broadphase->swaps = swaps;
+
+	// cells: runs of equal cell within each bucket
+	for (t = count = 0; t < tableSize; ++t)
+	{
+		broadphase->bucketCell[t] = count;
+		for (i = bucketStart[t]; i < bucketStart[t + 1]; ++i)
+			if (i == bucketStart[t] || cellU[i] != cellU[i - 1] || cellV[i] != cellV[i - 1])
+				broadphase->cellStart[count++] = i;
+	}
+	broadphase->bucketCell[tableSize] = count;
+	broadphase->cellStart[count] = n;
+	broadphase->cellCount = count;
+
+	// gather the rest in sweep order
+	for (i = 0; i < n; ++i)
+	{
+		b = order[i];
+		broadphase->maxS[i] = bodies->posX[b] + bodies->radius[b];
+		broadphase->posU[i] = bodies->posY[b];
+		broadphase->posV[i] = bodies->posZ[b];
+		broadphase->radius[i] = bodies->radius[b];
+	}
+
+	task->count = count;
+	task->reach = maxRadius * a3realTwo;
+	task->flags = broadphase->keepSleeping ? 0 : bodies->flags;
+	return a3demo_broadphaseGather(broadphase, task, (a3_DemoJobFunc)a3demo_broadphaseHashJob, n);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initBroadphase(a3_DemoBroadphase *broadphase, const a3_DemoBroadphaseType type, a3_DemoJobSystem *jobs)
+{
+	if (broadphase && type < a3demo_broadphase_count)
+	{
+		memset(broadphase, 0, sizeof(a3_DemoBroadphase));
+		broadphase->type = type;
+		broadphase->jobs = jobs;
+		broadphase->parallelThreshold = 4096;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseBroadphase(a3_DemoBroadphase *broadphase)
+{
+	if (broadphase)
+	{
+		unsigned int c;
+		for (c = 0; c < a3demo_broadphaseMaxChunks; ++c)
+			free(broadphase->chunk[c].pair);
+		free(broadphase->pair);
+		free(broadphase->memory);
+		memset(broadphase, 0, sizeof(a3_DemoBroadphase));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setBroadphaseType(a3_DemoBroadphase *broadphase, const a3_DemoBroadphaseType type)
+{
+	if (broadphase && type < a3demo_broadphase_count)
+	{
+		broadphase->type = type;
+		broadphase->count = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_updateBroadphase(a3_DemoBroadphase *broadphase, const a3_DemoBodyStore *bodies)
+{
+	if (broadphase && bodies)
+	{
+		broadphase->pairCount = 0;
+		if (bodies->count < 2)
+			return 0;
+		if (a3demo_broadphaseReserve(broadphase, bodies->count) < 0)
+			return -1;
+		switch (broadphase->type)
+		{
+		case a3demo_broadphase_sweepAndPrune:
+			return a3demo_broadphaseSweepAndPrune(broadphase, bodies);
+		case a3demo_broadphase_spatialHash:
+			return a3demo_broadphaseSpatialHash(broadphase, bodies);
+		default:
+			break;
+		}
+	}
+	return -1;
+}
+
+const char *a3demo_getBroadphaseName(const a3_DemoBroadphaseType type)
+{
+	static const char *name[a3demo_broadphase_count] = {
+		"sweep-and-prune",
+		"spatial hash",
+	};
+	return type < a3demo_broadphase_count ? name[type] : "unknown";
+}
+
+
+//-----------------------------------------------------------------------------
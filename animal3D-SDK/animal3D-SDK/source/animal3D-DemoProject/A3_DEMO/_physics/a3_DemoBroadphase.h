@@ -0,0 +1,160 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBroadphase.h
+	Collision broadphase: sweep-and-prune and spatial hash over body spheres.
+*/
+
+#ifndef __ANIMAL3D_DEMOBROADPHASE_H
+#define __ANIMAL3D_DEMOBROADPHASE_H
+
+
+#include "a3_DemoBodyStore.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoBodyPair			a3_DemoBodyPair;
+	typedef struct a3_DemoBroadphaseChunk	a3_DemoBroadphaseChunk;
+	typedef struct a3_DemoBroadphase		a3_DemoBroadphase;
+	typedef enum a3_DemoBroadphaseType		a3_DemoBroadphaseType;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// broadphase constants
+	enum a3_DemoBroadphaseConstants
+	{
+		a3demo_broadphaseMaxChunks = 256,	// parallel output lists
+	};
+
+
+	// available strategies
+	//	sweep-and-prune:	bodies kept sorted along one axis between steps
+	//						(insertion sort), overlaps found by sweeping;
+	//						best when bodies are spread out along that axis
+	//	spatial hash:		uniform grid over the other two axes, cells
+	//						hashed so the world is unbounded; each cell is
+	//						swept along the first axis against itself and
+	//						its forward neighbours; best for dense scenes
+	enum a3_DemoBroadphaseType
+	{
+		a3demo_broadphase_sweepAndPrune,
+		a3demo_broadphase_spatialHash,
+
+		a3demo_broadphase_count
+	};
+
+
+	// candidate pair of body indices, a < b
+	struct a3_DemoBodyPair
+	{
+		unsigned int a, b;
+	};
+
+	// pairs found by one parallel range
+	struct a3_DemoBroadphaseChunk
+	{
+		a3_DemoBodyPair *pair;
+		unsigned int count, capacity;
+	};
+
+	// broadphase state; the sorted order persists between updates so the
+	//	next sort starts out nearly done
+	struct a3_DemoBroadphase
+	{
+		a3_DemoBroadphaseType type;
+		a3_DemoJobSystem *jobs;			// scheduler for the sweeps; null is serial
+		unsigned int parallelThreshold;	// body count below which work stays serial
+		unsigned int keepSleeping;		// also report pairs of two sleeping bodies
+
+		// output: pairs whose sphere bounding boxes overlap
+		a3_DemoBodyPair *pair;
+		unsigned int pairCount, pairCapacity;
+
+		// per-body workspace (single allocation, capacity entries each)
+		void *memory;
+		unsigned int capacity;
+		unsigned int count;				// bodies in the kept order; 0 forces a re-sort
+		unsigned int *order;			// body index per sorted slot
+		unsigned int *scratch;			// sort workspace
+		unsigned int *sortKey;			// radix sort keys...
+		unsigned int *sortScratch;		// ...and their workspace
+		a3real *minS, *maxS;			// sorted: interval on the sweep axis
+		a3real *posU, *posV;			// sorted: center on the two cross axes
+		a3real *radius;					// sorted: radius
+		int *cellU, *cellV;				// sorted: hash cell on the cross axes
+		unsigned int *bucket;			// hash bucket per body
+
+		// hash table: each bucket is a range of cells, each cell a range
+		//	of sorted slots
+		unsigned int *bucketStart;		// first slot per bucket (tableSize + 1)
+		unsigned int *bucketCell;		// first cell per bucket (tableSize + 1)
+		unsigned int *cellStart;		// first slot per cell (capacity + 1)
+		unsigned int tableSize;			// power of two, at least the capacity
+		unsigned int tableStride;		// hash row length (power of two)
+		unsigned int cellCount;
+
+		// per-range output, concatenated in order so results do not depend
+		//	on which worker ran what
+		a3_DemoBroadphaseChunk chunk[a3demo_broadphaseMaxChunks];
+		unsigned int chunkCount;
+
+		// settings and stats
+		unsigned int axis;				// sweep-and-prune axis, picked by spread; hash sweeps x
+		a3real cellSize;				// hash cell size; raised to the largest diameter
+		a3real cellSizeUsed;			// what the last hash update used
+		unsigned int swaps;				// insertion sort moves in the last update
+		unsigned int rebuilds;			// full re-sorts so far
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown
+	int a3demo_initBroadphase(a3_DemoBroadphase *broadphase, const a3_DemoBroadphaseType type, a3_DemoJobSystem *jobs);
+	int a3demo_releaseBroadphase(a3_DemoBroadphase *broadphase);
+
+	// switch strategy; the next update re-sorts from scratch
+	int a3demo_setBroadphaseType(a3_DemoBroadphase *broadphase, const a3_DemoBroadphaseType type);
+
+	// find candidate pairs among all bodies; pairs where both bodies are
+	//	flagged sleeping are left out unless asked for; returns pair count
+	int a3demo_updateBroadphase(a3_DemoBroadphase *broadphase, const a3_DemoBodyStore *bodies);
+
+	// display name
+	const char *a3demo_getBroadphaseName(const a3_DemoBroadphaseType type);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOBROADPHASE_H
@@ -0,0 +1,327 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoCollider.c
+	Collider construction, fitted to generated procedural meshes.
+*/
+
+#include "a3_DemoCollider.h"
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// how far, as a fraction of the mesh's largest extent, a mesh may sit
+//	from where its collider puts the surface
+static const a3real a3demo_colliderFitTolerance = 0.001f;
+
+// split a procedural axis into index and sign
+inline void a3demo_colliderSetAxis(a3_DemoCollider *collider, const int axis)
+{
+	switch (axis)
+	{
+	case a3geomAxis_x: case a3geomAxis_y: case a3geomAxis_z:
+		collider->axis = (unsigned int)(axis - a3geomAxis_x);
+		collider->axisSign = a3realOne;
+		break;
+	case a3geomAxis_x_negative: case a3geomAxis_y_negative: case a3geomAxis_z_negative:
+		collider->axis = (unsigned int)(axis - a3geomAxis_x_negative);
+		collider->axisSign = -a3realOne;
+		break;
+	default:
+		collider->axis = a3geomAxis_default;
+		collider->axisSign = a3realOne;
+		break;
+	}
+}
+
+// long shapes: centered at an offset along the signed axis
+inline void a3demo_colliderSetLong(a3_DemoCollider *collider, const a3_DemoColliderType type, const a3real radius, const a3real halfLength, const a3real offset)
+{
+	collider->type = type;
+	collider->radius = radius;
+	collider->halfLength = halfLength;
+	collider->offset = offset;
+	collider->boundingRadius = (a3real)fabs(offset) +
+		(type == a3demo_collider_capsule ? halfLength + radius
+			: (a3real)sqrt(halfLength * halfLength + radius * radius));
+}
+
+// mesh position bounds; false if there are no positions
+inline int a3demo_colliderBounds(a3real *lo_out, a3real *hi_out, const a3_GeometryData *geom)
+{
+	const float *position = (const float *)geom->attribData[a3attrib_geomPosition];
+	unsigned int i, k;
+	if (!position || !geom->numVertices)
+		return 0;
+	for (k = 0; k < 3; ++k)
+		lo_out[k] = hi_out[k] = (a3real)position[k];
+	for (i = 1, position += 3; i < geom->numVertices; ++i, position += 3)
+		for (k = 0; k < 3; ++k)
+		{
+			lo_out[k] = a3minimum(lo_out[k], (a3real)position[k]);
+			hi_out[k] = a3maximum(hi_out[k], (a3real)position[k]);
+		}
+	return 1;
+}
+
+// widest a mesh gets across the axis within a tolerance of one end
+//	(signed coordinate 'end' along the signed axis)
+inline a3real a3demo_colliderEndRadius(const a3_DemoCollider *collider, const a3_GeometryData *geom, const a3real end, const a3real tolerance)
+{
+	const float *position = (const float *)geom->attribData[a3attrib_geomPosition];
+	const unsigned int u = (collider->axis + 1) % 3, v = (collider->axis + 2) % 3;
+	a3real radiusSq = a3realZero, distSq;
+	unsigned int i;
+	for (i = 0; i < geom->numVertices; ++i, position += 3)
+		if ((a3real)fabs(collider->axisSign * position[collider->axis] - end) <= tolerance)
+		{
+			distSq = position[u] * position[u] + position[v] * position[v];
+			radiusSq = a3maximum(radiusSq, distSq);
+		}
+	return (a3real)sqrt(radiusSq);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createColliderFromGeometry(a3_DemoCollider *collider_out, const a3_ProceduralGeometryDescriptor *shape, const a3_GeometryData *geom)
+{
+	if (collider_out && shape && geom)
+	{
+		a3real lo[3], hi[3], half[3], center[3], size, tolerance, radius, halfLength, base, apex;
+		unsigned int k, u, v;
+		int fits = 1;
+
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		switch (shape->shape)
+		{
+		case a3geomShape_sphere: case a3geomShape_box: case a3geomShape_plane:
+		case a3geomShape_capsule: case a3geomShape_cylinder: case a3geomShape_cone:
+			break;
+		default:
+			return 0;
+		}
+		if (!a3demo_colliderBounds(lo, hi, geom))
+			return -1;
+		for (k = 0, size = a3realZero; k < 3; ++k)
+		{
+			half[k] = (hi[k] - lo[k]) * a3realHalf;
+			center[k] = (hi[k] + lo[k]) * a3realHalf;
+			size = a3maximum(size, hi[k] - lo[k]);
+		}
+		tolerance = size * a3demo_colliderFitTolerance;
+
+		switch (shape->shape)
+		{
+		case a3geomShape_sphere:
+			a3demo_createColliderSphere(collider_out, a3maximum(half[0], a3maximum(half[1], half[2])));
+			break;
+		case a3geomShape_box:
+			a3demo_createColliderBox(collider_out, half[0] + half[0], half[1] + half[1], half[2] + half[2]);
+			break;
+
+			// length and radius from the extents along and across the
+			//	axis; the center may sit anywhere along it
+		case a3geomShape_capsule:
+		case a3geomShape_cylinder:
+		case a3geomShape_cone:
+			a3demo_colliderSetAxis(collider_out, a3proceduralGetDescriptorAxis(shape));
+			k = collider_out->axis;
+			u = (k + 1) % 3;
+			v = (k + 2) % 3;
+			radius = a3maximum(half[u], half[v]);
+			halfLength = shape->shape == a3geomShape_capsule ? half[k] - radius : half[k];
+			fits = halfLength >= -tolerance;
+			a3demo_colliderSetLong(collider_out,
+				shape->shape == a3geomShape_capsule ? a3demo_collider_capsule : shape->shape == a3geomShape_cylinder ? a3demo_collider_cylinder : a3demo_collider_cone,
+				radius, a3maximum(halfLength, a3realZero), collider_out->axisSign * center[k]);
+			center[k] = a3realZero;
+
+			// cones point along the positive axis; if the mesh comes to
+			//	its point at the other end, turn the collider around
+			if (shape->shape == a3geomShape_cone)
+			{
+				base = a3demo_colliderEndRadius(collider_out, geom, collider_out->offset - halfLength, tolerance);
+				apex = a3demo_colliderEndRadius(collider_out, geom, collider_out->offset + halfLength, tolerance);
+				if (apex > tolerance && base <= tolerance)
+				{
+					collider_out->axisSign = -collider_out->axisSign;
+					collider_out->offset = -collider_out->offset;
+				}
+				else if (apex > tolerance)
+					fits = 0;
+			}
+			break;
+
+			// a half-space through the mesh origin: the mesh must be flat
+			//	there, and its size does not matter
+		case a3geomShape_plane:
+			collider_out->type = a3demo_collider_plane;
+			a3demo_colliderSetAxis(collider_out, a3proceduralGetDescriptorAxis(shape));
+			k = collider_out->axis;
+			center[(k + 1) % 3] = center[(k + 2) % 3] = a3realZero;
+			center[k] = a3maximum((a3real)fabs(lo[k]), (a3real)fabs(hi[k]));
+			break;
+		default:
+			break;
+		}
+
+		// what the collider does not offset must sit on the mesh origin
+		for (k = 0; k < 3; ++k)
+			fits = fits && (a3real)fabs(center[k]) <= tolerance;
+		if (!fits)
+		{
+			memset(collider_out, 0, sizeof(a3_DemoCollider));
+			return -1;
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createColliderSphere(a3_DemoCollider *collider_out, const a3real radius)
+{
+	if (collider_out && radius >= a3realZero)
+	{
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		collider_out->type = a3demo_collider_sphere;
+		collider_out->axis = 2;
+		collider_out->axisSign = a3realOne;
+		collider_out->radius = collider_out->boundingRadius = radius;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createColliderBox(a3_DemoCollider *collider_out, const a3real width, const a3real height, const a3real length)
+{
+	if (collider_out && width >= a3realZero && height >= a3realZero && length >= a3realZero)
+	{
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		collider_out->type = a3demo_collider_box;
+		collider_out->axis = 2;
+		collider_out->axisSign = a3realOne;
+		collider_out->halfExtent[0] = width * a3realHalf;
+		collider_out->halfExtent[1] = height * a3realHalf;
+		collider_out->halfExtent[2] = length * a3realHalf;
+		collider_out->boundingRadius = (a3real)sqrt(
+			collider_out->halfExtent[0] * collider_out->halfExtent[0] +
+			collider_out->halfExtent[1] * collider_out->halfExtent[1] +
+			collider_out->halfExtent[2] * collider_out->halfExtent[2]);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createColliderCapsule(a3_DemoCollider *collider_out, const unsigned int axis, const a3real radius, const a3real lengthBody)
+{
+	if (collider_out && axis < 3 && radius >= a3realZero && lengthBody >= a3realZero)
+	{
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		collider_out->axis = axis;
+		collider_out->axisSign = a3realOne;
+		a3demo_colliderSetLong(collider_out, a3demo_collider_capsule, radius, lengthBody * a3realHalf, a3realZero);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createColliderPlane(a3_DemoCollider *collider_out, const unsigned int axis)
+{
+	if (collider_out && axis < 3)
+	{
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		collider_out->type = a3demo_collider_plane;
+		collider_out->axis = axis;
+		collider_out->axisSign = a3realOne;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createColliderHull(a3_DemoCollider *collider_out, const a3_DemoConvexHull *hull)
+{
+	if (collider_out && hull && hull->vertexCount)
+	{
+		memset(collider_out, 0, sizeof(a3_DemoCollider));
+		collider_out->type = a3demo_collider_hull;
+		collider_out->axis = 2;
+		collider_out->axisSign = a3realOne;
+		collider_out->hull = hull;
+		collider_out->boundingRadius = hull->radius + (a3real)sqrt(
+			hull->center[0] * hull->center[0] +
+			hull->center[1] * hull->center[1] +
+			hull->center[2] * hull->center[2]);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setColliderPose(a3_DemoColliderPose *pose_out, const a3real x, const a3real y, const a3real z)
+{
+	if (pose_out)
+	{
+		memset(pose_out, 0, sizeof(a3_DemoColliderPose));
+		pose_out->position[0] = x;
+		pose_out->position[1] = y;
+		pose_out->position[2] = z;
+		pose_out->rotation[0][0] = pose_out->rotation[1][1] = pose_out->rotation[2][2] = a3realOne;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_getColliderWorldFrame(const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, a3real *center_out, a3real *axis_out)
+{
+	if (collider && pose && center_out && axis_out)
+	{
+		const a3real *axis = pose->rotation[collider->axis];
+		axis_out[0] = axis[0] * collider->axisSign;
+		axis_out[1] = axis[1] * collider->axisSign;
+		axis_out[2] = axis[2] * collider->axisSign;
+		center_out[0] = pose->position[0] + axis_out[0] * collider->offset;
+		center_out[1] = pose->position[1] + axis_out[1] * collider->offset;
+		center_out[2] = pose->position[2] + axis_out[2] * collider->offset;
+		return 1;
+	}
+	return -1;
+}
+
+const char *a3demo_getColliderName(const a3_DemoColliderType type)
+{
+	static const char *name[a3demo_collider_count] = {
+		"none",
+		"sphere",
+		"box",
+		"capsule",
+		"cylinder",
+		"cone",
+		"hull",
+		"plane",
+	};
+	return type < a3demo_collider_count ? name[type] : "unknown";
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoCollider.h
+	Analytic collision shapes built from procedural geometry descriptors.
+*/
+
+#ifndef __ANIMAL3D_DEMOCOLLIDER_H
+#define __ANIMAL3D_DEMOCOLLIDER_H
+
+
+// math library
+#include "animal3D/a3math/A3DM.h"
+
+// procedural shapes the colliders mirror
+#include "animal3D/a3graphics/a3geometry/a3_ProceduralGeometry.h"
+
+// convex proxies for everything else
+#include "a3_DemoConvexHull.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoCollider			a3_DemoCollider;
+	typedef struct a3_DemoColliderPose		a3_DemoColliderPose;
+	typedef enum a3_DemoColliderType		a3_DemoColliderType;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// collider shapes, in the order pair tests expect them
+	enum a3_DemoColliderType
+	{
+		a3demo_collider_none,
+		a3demo_collider_sphere,
+		a3demo_collider_box,
+		a3demo_collider_capsule,
+		a3demo_collider_cylinder,
+		a3demo_collider_cone,
+		a3demo_collider_hull,
+		a3demo_collider_plane,
+
+		a3demo_collider_count
+	};
+
+
+	// analytic shape in its own frame; long shapes (capsule, cylinder,
+	//	cone) lie along one local axis and are stored about their center,
+	//	which may sit off the mesh origin
+	// planes are treated as half-spaces: the descriptor's width and
+	//	height only matter for drawing
+	struct a3_DemoCollider
+	{
+		a3_DemoColliderType type;
+		unsigned int axis;				// long axis or plane normal (0, 1, 2)
+		a3real axisSign;				// +1, or -1 for the negative axes
+		a3real halfExtent[3];			// box half sizes
+		a3real radius;					// sphere, capsule, cylinder, cone base
+		a3real halfLength;				// capsule/cylinder: half the segment between caps; cone: half height
+		a3real offset;					// center along the signed axis from the mesh origin
+		a3real boundingRadius;			// sphere about the mesh origin enclosing the shape
+		const a3_DemoConvexHull *hull;	// hull shapes: vertices in the mesh frame (not owned)
+	};
+
+	// placement of a collider: world position of the mesh origin and
+	//	rotation whose columns are the local axes in world space
+	struct a3_DemoColliderPose
+	{
+		a3real3 position;
+		a3real3x3 rotation;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// collider fitted to a generated procedural mesh: the descriptor only
+	//	says what kind of shape and along which axis, the sizes and where
+	//	the shape sits come from the mesh's bounds
+	//	-> returns 1, 0 for shapes with no analytic collider (torus etc.),
+	//		or -1 if invalid params or the mesh is not the shape the
+	//		collider would be (off center, cone without a point)
+	int a3demo_createColliderFromGeometry(a3_DemoCollider *collider_out, const a3_ProceduralGeometryDescriptor *shape, const a3_GeometryData *geom);
+
+	// direct constructors
+	int a3demo_createColliderSphere(a3_DemoCollider *collider_out, const a3real radius);
+	int a3demo_createColliderBox(a3_DemoCollider *collider_out, const a3real width, const a3real height, const a3real length);
+	int a3demo_createColliderCapsule(a3_DemoCollider *collider_out, const unsigned int axis, const a3real radius, const a3real lengthBody);
+	int a3demo_createColliderPlane(a3_DemoCollider *collider_out, const unsigned int axis);
+
+	// convex proxy; the hull must outlive the collider and anything
+	//	copied from it
+	int a3demo_createColliderHull(a3_DemoCollider *collider_out, const a3_DemoConvexHull *hull);
+
+	// pose from a position and no rotation
+	int a3demo_setColliderPose(a3_DemoColliderPose *pose_out, const a3real x, const a3real y, const a3real z);
+
+	// shape center and unit long axis (or plane normal) in world space
+	int a3demo_getColliderWorldFrame(const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, a3real *center_out, a3real *axis_out);
+
+	// display name
+	const char *a3demo_getColliderName(const a3_DemoColliderType type);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOCOLLIDER_H
@@ -0,0 +1,619 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoContactSolver.c
+	Projected Gauss-Seidel over contact points, one job per island range.
+*/
+
+#include "a3_DemoContactSolver.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// solver internal constants
+enum a3_DemoContactSolverInternal
+{
+	a3demo_solverDefaultIterations = 10,
+	a3demo_solverIslandGrain = 16,		// islands per job at the finest split
+	a3demo_solverEmpty = ~0u,
+};
+
+// arguments for the island jobs
+typedef struct a3_DemoContactSolverTask
+{
+	a3_DemoContactSolver *solver;
+	a3_DemoRigidBody *bodies;
+	a3real invDt;
+} a3_DemoContactSolverTask;
+
+
+inline a3real a3demo_solverDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_solverCross(a3real *out, const a3real *a, const a3real *b)
+{
+	const a3real x = a[1] * b[2] - a[2] * b[1], y = a[2] * b[0] - a[0] * b[2], z = a[0] * b[1] - a[1] * b[0];
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+}
+
+// farthest a cached point may have moved on body a and still be reused
+static const a3real a3demo_solverMatchDistance = 0.05f;
+
+// cache slot for a body pair; a pair's points share one probe run
+inline unsigned int a3demo_solverHash(const unsigned int a, const unsigned int b, const unsigned int size)
+{
+	return (a * 73856093u ^ b * 19349663u) & (size - 1);
+}
+
+// contact point in body a's frame (rotation columns are its axes)
+inline void a3demo_solverLocal(a3real *out, const a3_DemoRigidBody *body, const a3real *r)
+{
+	const a3real(*R)[3] = (const a3real(*)[3])body->pose.rotation;
+	out[0] = R[0][0] * r[0] + R[0][1] * r[1] + R[0][2] * r[2];
+	out[1] = R[1][0] * r[0] + R[1][1] * r[1] + R[1][2] * r[2];
+	out[2] = R[2][0] * r[0] + R[2][1] * r[1] + R[2][2] * r[2];
+}
+
+// union-find root with path halving
+inline unsigned int a3demo_solverFind(unsigned int *parent, unsigned int i)
+{
+	while (parent[i] != i)
+		i = parent[i] = parent[parent[i]];
+	return i;
+}
+
+// fill a row's jacobian from its direction: the arms r x d and their
+//	images under each body's inverse inertia, so that iterating needs no
+//	cross products or matrix products
+inline void a3demo_solverSetRow(a3_DemoContactRow *row, const a3_DemoRigidBody *bodyA, const a3_DemoRigidBody *bodyB, const a3real *rA, const a3real *rB)
+{
+	a3real k;
+	a3demo_solverCross(row->armA, rA, row->direction);
+	a3demo_solverCross(row->armB, rB, row->direction);
+	a3demo_applyRigidBodyInvInertia(bodyA, row->angularA, row->armA);
+	a3demo_applyRigidBodyInvInertia(bodyB, row->angularB, row->armB);
+	k = bodyA->invMass + bodyB->invMass + a3demo_solverDot(row->armA, row->angularA) + a3demo_solverDot(row->armB, row->angularB);
+	row->mass = k > a3realZero ? a3recip(k) : a3realZero;
+}
+
+// velocity of b relative to a along a row
+inline a3real a3demo_solverRowVelocity(const a3_DemoContactRow *row, const a3real *velocityA, const a3real *angularA, const a3real *velocityB, const a3real *angularB)
+{
+	return (velocityB[0] - velocityA[0]) * row->direction[0] + (velocityB[1] - velocityA[1]) * row->direction[1] + (velocityB[2] - velocityA[2]) * row->direction[2]
+		+ a3demo_solverDot(row->armB, angularB) - a3demo_solverDot(row->armA, angularA);
+}
+
+// impulse along a row to b and its opposite to a; static bodies are
+//	never written, since other islands may be reading them
+inline void a3demo_solverApplyRow(const a3_DemoContactRow *row, const a3real lambda, const a3real invMassA, a3real *velocityA, a3real *angularA, const a3real invMassB, a3real *velocityB, a3real *angularB)
+{
+	a3real scale;
+	if (invMassA > a3realZero)
+	{
+		scale = lambda * invMassA;
+		velocityA[0] -= row->direction[0] * scale;
+		velocityA[1] -= row->direction[1] * scale;
+		velocityA[2] -= row->direction[2] * scale;
+		angularA[0] -= row->angularA[0] * lambda;
+		angularA[1] -= row->angularA[1] * lambda;
+		angularA[2] -= row->angularA[2] * lambda;
+	}
+	if (invMassB > a3realZero)
+	{
+		scale = lambda * invMassB;
+		velocityB[0] += row->direction[0] * scale;
+		velocityB[1] += row->direction[1] * scale;
+		velocityB[2] += row->direction[2] * scale;
+		angularB[0] += row->angularB[0] * lambda;
+		angularB[1] += row->angularB[1] * lambda;
+		angularB[2] += row->angularB[2] * lambda;
+	}
+}
+
+// solve one row on the real velocities, clamped to [lo, hi]
+inline a3real a3demo_solverRow(a3_DemoContactRow *row, a3_DemoRigidBody *bodyA, a3_DemoRigidBody *bodyB, const a3real target, const a3real lo, const a3real hi)
+{
+	const a3real old = row->impulse;
+	const a3real velocity = a3demo_solverRowVelocity(row, bodyA->velocity, bodyA->angularVelocity, bodyB->velocity, bodyB->angularVelocity);
+	row->impulse = a3minimum(a3maximum(old + (target - velocity) * row->mass, lo), hi);
+	a3demo_solverApplyRow(row, row->impulse - old, bodyA->invMass, bodyA->velocity, bodyA->angularVelocity, bodyB->invMass, bodyB->velocity, bodyB->angularVelocity);
+	return row->impulse - old;
+}
+
+// friction basis that depends only on the normal, so cached friction
+//	impulses stay meaningful from one step to the next
+inline void a3demo_solverTangents(a3real *t0_out, a3real *t1_out, const a3real *n)
+{
+	a3real len;
+	if (a3absolute(n[0]) < 0.57735f)
+	{
+		t0_out[0] = a3realZero;
+		t0_out[1] = n[2];
+		t0_out[2] = -n[1];
+	}
+	else
+	{
+		t0_out[0] = n[1];
+		t0_out[1] = -n[0];
+		t0_out[2] = a3realZero;
+	}
+	len = a3recip((a3real)sqrt(a3demo_solverDot(t0_out, t0_out)));
+	t0_out[0] *= len;
+	t0_out[1] *= len;
+	t0_out[2] *= len;
+	a3demo_solverCross(t1_out, n, t0_out);
+}
+
+// grow workspace
+int a3demo_solverReserve(a3_DemoContactSolver *solver, const unsigned int bodyCount, const unsigned int constraintCount, const unsigned int islandCount)
+{
+	unsigned int capacity;
+	if (solver->bodyCapacity < bodyCount)
+	{
+		capacity = bodyCount + bodyCount / 2;
+		free(solver->parent);
+		solver->parent = (unsigned int *)malloc(capacity * 2 * sizeof(unsigned int));
+		solver->islandOf = solver->parent + capacity;
+		solver->bodyCapacity = solver->parent ? capacity : 0;
+		if (!solver->parent)
+			return -1;
+	}
+	if (solver->constraintCapacity < constraintCount)
+	{
+		capacity = constraintCount + constraintCount / 2;
+		free(solver->constraint);
+		solver->constraint = (a3_DemoContactConstraint *)malloc(capacity * sizeof(a3_DemoContactConstraint));
+		solver->constraintCapacity = solver->constraint ? capacity : 0;
+		if (!solver->constraint)
+			return -1;
+	}
+	if (solver->islandCapacity < islandCount)
+	{
+		capacity = islandCount + islandCount / 2;
+		free(solver->island);
+		solver->island = (a3_DemoContactIsland *)malloc(capacity * sizeof(a3_DemoContactIsland));
+		solver->islandCapacity = solver->island ? capacity : 0;
+		if (!solver->island)
+			return -1;
+	}
+	return 1;
+}
+
+// grow body store mirrors; the store map starts out empty and is left
+//	empty after every solve
+int a3demo_solverReserveMirror(a3_DemoContactSolver *solver, const unsigned int storeCapacity, const unsigned int mirrorCount)
+{
+	unsigned int capacity;
+	if (solver->storeCapacity < storeCapacity)
+	{
+		free(solver->mirrorOf);
+		solver->mirrorOf = (unsigned int *)malloc(storeCapacity * sizeof(unsigned int));
+		solver->storeCapacity = solver->mirrorOf ? storeCapacity : 0;
+		if (!solver->mirrorOf)
+			return -1;
+		memset(solver->mirrorOf, 0xff, storeCapacity * sizeof(unsigned int));
+	}
+	if (solver->mirrorCapacity < mirrorCount)
+	{
+		capacity = mirrorCount + mirrorCount / 2;
+		free(solver->mirror);
+		solver->mirror = (a3_DemoRigidBody *)malloc(capacity * (sizeof(a3_DemoRigidBody) + sizeof(unsigned int)));
+		solver->mirrorBody = (unsigned int *)(solver->mirror + capacity);
+		solver->mirrorCapacity = solver->mirror ? capacity : 0;
+		if (!solver->mirror)
+			return -1;
+	}
+	return 1;
+}
+
+// store what was solved for the next step
+int a3demo_solverRebuildCache(a3_DemoContactSolver *solver, const a3_DemoRigidBody *bodies)
+{
+	const a3_DemoContactConstraint *c = solver->constraint, *end = c + solver->constraintCount;
+	a3_DemoContactImpulse *entry;
+	unsigned int size, slot;
+
+	for (size = 64; size < solver->constraintCount * 2; size <<= 1);
+	if (solver->cacheSize != size)
+	{
+		free(solver->cache);
+		solver->cache = (a3_DemoContactImpulse *)malloc(size * sizeof(a3_DemoContactImpulse));
+		solver->cacheSize = solver->cache ? size : 0;
+		if (!solver->cache)
+			return -1;
+	}
+	memset(solver->cache, 0xff, size * sizeof(a3_DemoContactImpulse));
+	for (solver->cacheCount = 0; c < end; ++c)
+	{
+		for (slot = a3demo_solverHash(c->a, c->b, size); solver->cache[slot].a != a3demo_solverEmpty; slot = (slot + 1) & (size - 1));
+		entry = solver->cache + slot;
+		entry->a = c->a;
+		entry->b = c->b;
+		entry->feature = c->feature;
+		a3demo_solverLocal(entry->localA, bodies + c->a, c->rA);
+		entry->normal = c->normal.impulse;
+		entry->tangent0 = c->tangent[0].impulse;
+		entry->tangent1 = c->tangent[1].impulse;
+		++solver->cacheCount;
+	}
+	return 1;
+}
+
+// cached impulse for a contact: same pair, and the same feature near
+//	where it was, or failing that the nearest point; clipping can retag a
+//	point when edges line up exactly, so the feature alone is not enough
+const a3_DemoContactImpulse *a3demo_solverLookup(const a3_DemoContactSolver *solver, const unsigned int a, const unsigned int b, const unsigned int feature, const a3real *localA)
+{
+	const a3_DemoContactImpulse *entry, *nearest = 0;
+	a3real d[3], distSq, nearestSq = a3demo_solverMatchDistance * a3demo_solverMatchDistance;
+	unsigned int slot;
+	if (solver->cacheCount)
+		for (slot = a3demo_solverHash(a, b, solver->cacheSize); (entry = solver->cache + slot)->a != a3demo_solverEmpty; slot = (slot + 1) & (solver->cacheSize - 1))
+			if (entry->a == a && entry->b == b)
+			{
+				d[0] = entry->localA[0] - localA[0];
+				d[1] = entry->localA[1] - localA[1];
+				d[2] = entry->localA[2] - localA[2];
+				distSq = a3demo_solverDot(d, d);
+				if (distSq < nearestSq)
+				{
+					if (entry->feature == feature)
+						return entry;
+					nearestSq = distSq;
+					nearest = entry;
+				}
+			}
+	return nearest;
+}
+
+// prepare, warm start and iterate a range of islands
+void a3demo_solverIslands(a3_DemoContactSolverTask *task, const unsigned int first, const unsigned int count)
+{
+	const a3_DemoContactSolver *solver = task->solver;
+	const a3real friction = solver->friction, biasFactor = solver->baumgarte * task->invDt, slop = solver->slop;
+	const unsigned int iterations = solver->iterations;
+	a3_DemoRigidBody *bodies = task->bodies, *bodyA, *bodyB;
+	a3_DemoContactConstraint *c, *begin, *end;
+	a3_DemoContactIsland *island;
+	a3real velocity, limit, old, residual;
+	unsigned int i, n, iteration;
+
+	for (i = first; i < first + count; ++i)
+	{
+		island = solver->island + i;
+		begin = solver->constraint + island->first;
+		end = begin + island->count;
+
+		// jacobians and targets (depth was parked in the bias): points
+		//	not yet touching may close no faster than the gap closes in
+		//	one step; overlap beyond the slop is pushed out through the
+		//	push velocities, so correcting it adds no energy; then apply
+		//	last step's impulses
+		for (c = begin; c < end; ++c)
+		{
+			bodyA = bodies + c->a;
+			bodyB = bodies + c->b;
+			a3demo_solverTangents(c->tangent[0].direction, c->tangent[1].direction, c->normal.direction);
+			a3demo_solverSetRow(&c->normal, bodyA, bodyB, c->rA, c->rB);
+			a3demo_solverSetRow(c->tangent + 0, bodyA, bodyB, c->rA, c->rB);
+			a3demo_solverSetRow(c->tangent + 1, bodyA, bodyB, c->rA, c->rB);
+			c->push = c->bias > slop ? biasFactor * (c->bias - slop) : a3realZero;
+			c->bias = c->bias < a3realZero ? c->bias * task->invDt : a3realZero;
+			c->impulsePush = a3realZero;
+			a3demo_solverApplyRow(&c->normal, c->normal.impulse, bodyA->invMass, bodyA->velocity, bodyA->angularVelocity, bodyB->invMass, bodyB->velocity, bodyB->angularVelocity);
+			a3demo_solverApplyRow(c->tangent + 0, c->tangent[0].impulse, bodyA->invMass, bodyA->velocity, bodyA->angularVelocity, bodyB->invMass, bodyB->velocity, bodyB->angularVelocity);
+			a3demo_solverApplyRow(c->tangent + 1, c->tangent[1].impulse, bodyA->invMass, bodyA->velocity, bodyA->angularVelocity, bodyB->invMass, bodyB->velocity, bodyB->angularVelocity);
+		}
+
+		// friction first so the normal rows get the last word; sweeps
+		//	alternate direction so no contact is always solved last
+		for (iteration = 0; iteration < iterations; ++iteration)
+		{
+			residual = a3realZero;
+			for (n = 0; n < island->count; ++n)
+			{
+				c = (iteration & 1) ? end - 1 - n : begin + n;
+				bodyA = bodies + c->a;
+				bodyB = bodies + c->b;
+
+				limit = friction * c->normal.impulse;
+				a3demo_solverRow(c->tangent + 0, bodyA, bodyB, a3realZero, -limit, limit);
+				a3demo_solverRow(c->tangent + 1, bodyA, bodyB, a3realZero, -limit, limit);
+
+				// separating velocity at least the bias; impulses only push
+				velocity = a3demo_solverRow(&c->normal, bodyA, bodyB, c->bias, a3realZero, (a3real)FLT_MAX);
+				residual += a3absolute(velocity);
+
+				// overlap, on the push velocities only
+				if (c->push > a3realZero || c->impulsePush > a3realZero)
+				{
+					old = c->impulsePush;
+					velocity = a3demo_solverRowVelocity(&c->normal, bodyA->pushVelocity, bodyA->pushAngularVelocity, bodyB->pushVelocity, bodyB->pushAngularVelocity);
+					c->impulsePush = a3maximum(old + (c->push - velocity) * c->normal.mass, a3realZero);
+					a3demo_solverApplyRow(&c->normal, c->impulsePush - old, bodyA->invMass, bodyA->pushVelocity, bodyA->pushAngularVelocity, bodyB->invMass, bodyB->pushVelocity, bodyB->pushAngularVelocity);
+				}
+			}
+			if (iteration == 0)
+				island->residualFirst = residual;
+			island->residualLast = residual;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initContactSolver(a3_DemoContactSolver *solver, const unsigned int iterations, a3_DemoJobSystem *jobs)
+{
+	if (solver)
+	{
+		memset(solver, 0, sizeof(a3_DemoContactSolver));
+		solver->jobs = jobs;
+		solver->iterations = iterations ? iterations : a3demo_solverDefaultIterations;
+		solver->warmStart = 1;
+		solver->friction = 0.6f;
+		solver->baumgarte = 0.2f;
+		solver->slop = 0.005f;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseContactSolver(a3_DemoContactSolver *solver)
+{
+	if (solver)
+	{
+		free(solver->constraint);
+		free(solver->island);
+		free(solver->parent);
+		free(solver->cache);
+		free(solver->mirror);
+		free(solver->mirrorOf);
+		solver->constraint = 0;
+		solver->island = 0;
+		solver->parent = solver->islandOf = 0;
+		solver->cache = 0;
+		solver->mirror = 0;
+		solver->mirrorBody = solver->mirrorOf = 0;
+		solver->mirrorCapacity = solver->storeCapacity = 0;
+		solver->constraintCount = solver->constraintCapacity = 0;
+		solver->islandCount = solver->islandCapacity = 0;
+		solver->bodyCount = solver->bodyCapacity = solver->cacheSize = solver->cacheCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_resetContactSolver(a3_DemoContactSolver *solver)
+{
+	if (solver)
+	{
+		solver->cacheCount = solver->bodyCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_solveContacts(a3_DemoContactSolver *solver, a3_DemoRigidBody *bodies, const unsigned int bodyCount, const a3_DemoContactManifold *manifolds, const unsigned int manifoldCount, const a3real dt)
+{
+	if (solver && (bodies || !bodyCount) && (manifolds || !manifoldCount) && dt > a3realZero)
+	{
+		a3_DemoContactSolverTask task[1];
+		const a3_DemoContactManifold *m;
+		const a3_DemoContactImpulse *cached;
+		a3_DemoContactConstraint *c;
+		a3_DemoContactIsland *island;
+		a3real local[3];
+		unsigned int i, k, a, b, root, total;
+
+		// reserve for every point; islands can be no more than manifolds
+		for (i = total = 0; i < manifoldCount; ++i)
+			total += manifolds[i].count;
+		if (a3demo_solverReserve(solver, bodyCount, total, manifoldCount) < 0)
+			return -1;
+
+		// union dynamic bodies that touch; static bodies stay apart, so a
+		//	floor does not merge everything resting on it into one island
+		solver->bodyCount = bodyCount;
+		for (i = 0; i < bodyCount; ++i)
+		{
+			solver->parent[i] = i;
+			solver->islandOf[i] = a3demo_solverEmpty;
+		}
+		for (i = 0, m = manifolds; i < manifoldCount; ++i, ++m)
+			if (m->count && bodies[m->a].invMass > a3realZero && bodies[m->b].invMass > a3realZero)
+			{
+				a = a3demo_solverFind(solver->parent, m->a);
+				b = a3demo_solverFind(solver->parent, m->b);
+				if (a < b)
+					solver->parent[b] = a;
+				else if (b < a)
+					solver->parent[a] = b;
+			}
+
+		// number islands in order of first appearance and count points
+		solver->islandCount = 0;
+		for (i = 0, m = manifolds; i < manifoldCount; ++i, ++m)
+			if (m->count && (bodies[m->a].invMass > a3realZero || bodies[m->b].invMass > a3realZero))
+			{
+				root = a3demo_solverFind(solver->parent, bodies[m->a].invMass > a3realZero ? m->a : m->b);
+				if (solver->islandOf[root] == a3demo_solverEmpty)
+				{
+					island = solver->island + solver->islandCount;
+					island->count = 0;
+					island->residualFirst = island->residualLast = a3realZero;
+					solver->islandOf[root] = solver->islandCount++;
+				}
+				solver->island[solver->islandOf[root]].count += m->count;
+			}
+		for (i = total = 0; i < solver->islandCount; ++i)
+		{
+			solver->island[i].first = total;
+			total += solver->island[i].count;
+			solver->island[i].count = 0;
+		}
+		solver->constraintCount = total;
+
+		// raw constraints in island order, picking up cached impulses
+		solver->warmStarted = 0;
+		for (i = 0, m = manifolds; i < manifoldCount; ++i, ++m)
+			if (m->count && (bodies[m->a].invMass > a3realZero || bodies[m->b].invMass > a3realZero))
+			{
+				root = a3demo_solverFind(solver->parent, bodies[m->a].invMass > a3realZero ? m->a : m->b);
+				island = solver->island + solver->islandOf[root];
+				for (k = 0; k < m->count; ++k)
+				{
+					c = solver->constraint + island->first + island->count++;
+					c->a = m->a;
+					c->b = m->b;
+					c->feature = m->point[k].feature;
+					c->normal.direction[0] = m->normal[0];
+					c->normal.direction[1] = m->normal[1];
+					c->normal.direction[2] = m->normal[2];
+					c->rA[0] = m->point[k].position[0] - bodies[m->a].pose.position[0];
+					c->rA[1] = m->point[k].position[1] - bodies[m->a].pose.position[1];
+					c->rA[2] = m->point[k].position[2] - bodies[m->a].pose.position[2];
+					c->rB[0] = m->point[k].position[0] - bodies[m->b].pose.position[0];
+					c->rB[1] = m->point[k].position[1] - bodies[m->b].pose.position[1];
+					c->rB[2] = m->point[k].position[2] - bodies[m->b].pose.position[2];
+					c->bias = m->point[k].depth;
+					a3demo_solverLocal(local, bodies + c->a, c->rA);
+					cached = solver->warmStart ? a3demo_solverLookup(solver, c->a, c->b, c->feature, local) : 0;
+					if (cached)
+					{
+						c->normal.impulse = cached->normal;
+						c->tangent[0].impulse = cached->tangent0;
+						c->tangent[1].impulse = cached->tangent1;
+						++solver->warmStarted;
+					}
+					else
+						c->normal.impulse = c->tangent[0].impulse = c->tangent[1].impulse = a3realZero;
+				}
+			}
+
+		// islands share no dynamic bodies, so they solve independently
+		task->solver = solver;
+		task->bodies = bodies;
+		task->invDt = a3recip(dt);
+		a3demo_parallelFor(solver->jobs, (a3_DemoJobFunc)a3demo_solverIslands, task, solver->islandCount, a3demo_solverIslandGrain);
+
+		solver->largestIsland = 0;
+		solver->residualFirst = solver->residualLast = a3realZero;
+		for (i = 0; i < solver->islandCount; ++i)
+		{
+			solver->largestIsland = a3maximum(solver->largestIsland, solver->island[i].count);
+			solver->residualFirst += solver->island[i].residualFirst;
+			solver->residualLast += solver->island[i].residualLast;
+		}
+		if (a3demo_solverRebuildCache(solver, bodies) < 0)
+			return -1;
+		return solver->constraintCount;
+	}
+	return -1;
+}
+
+int a3demo_solveBodyStoreContacts(a3_DemoContactSolver *solver, a3_DemoBodyStore *bodies, a3_DemoContactManifold *manifolds, const unsigned int manifoldCount, const a3real dt)
+{
+	if (solver && bodies && bodies->memory && (manifolds || !manifoldCount) && dt > a3realZero)
+	{
+		a3_DemoCollider sphere[1];
+		a3_DemoRigidBody *mirror;
+		unsigned int i, k, index, count;
+		int result;
+
+		if (!manifoldCount)
+			return 0;
+		if (a3demo_solverReserveMirror(solver, bodies->capacity, manifoldCount * 2) < 0)
+			return -1;
+
+		// mirror each body the first time it shows up and point the
+		//	manifolds at the mirrors; with no inverse inertia the mirrors
+		//	take contact and friction impulses linearly only
+		for (i = count = 0; i < manifoldCount; ++i)
+			for (k = 0; k < 2; ++k)
+			{
+				index = k ? manifolds[i].b : manifolds[i].a;
+				if (solver->mirrorOf[index] == a3demo_solverEmpty)
+				{
+					mirror = solver->mirror + count;
+					a3demo_createColliderSphere(sphere, bodies->radius[index]);
+					a3demo_initRigidBody(mirror, sphere, bodies->invMass[index] > a3realZero && !(bodies->flags[index] & a3demo_bodyFlags_held) ? bodies->mass[index] : a3realZero,
+						bodies->posX[index], bodies->posY[index], bodies->posZ[index]);
+					memset(mirror->invInertiaLocal, 0, sizeof(a3real3));
+					memset(mirror->invInertia, 0, sizeof(a3real3x3));
+					mirror->velocity[0] = bodies->velX[index];
+					mirror->velocity[1] = bodies->velY[index];
+					mirror->velocity[2] = bodies->velZ[index];
+					solver->mirrorBody[count] = index;
+					solver->mirrorOf[index] = count++;
+				}
+				if (k)
+					manifolds[i].b = solver->mirrorOf[index];
+				else
+					manifolds[i].a = solver->mirrorOf[index];
+			}
+
+		result = a3demo_solveContacts(solver, solver->mirror, count, manifolds, manifoldCount, dt);
+
+		// results back to the store, and the manifolds and map back as
+		//	they were
+		for (i = 0, mirror = solver->mirror; i < count; ++i, ++mirror)
+		{
+			index = solver->mirrorBody[i];
+			if (result >= 0)
+			{
+				bodies->velX[index] = mirror->velocity[0];
+				bodies->velY[index] = mirror->velocity[1];
+				bodies->velZ[index] = mirror->velocity[2];
+				bodies->posX[index] += mirror->pushVelocity[0] * dt;
+				bodies->posY[index] += mirror->pushVelocity[1] * dt;
+				bodies->posZ[index] += mirror->pushVelocity[2] * dt;
+			}
+			solver->mirrorOf[index] = a3demo_solverEmpty;
+		}
+		for (i = 0; i < manifoldCount; ++i)
+		{
+			manifolds[i].a = solver->mirrorBody[manifolds[i].a];
+			manifolds[i].b = solver->mirrorBody[manifolds[i].b];
+		}
+		return result;
+	}
+	return -1;
+}
+
+int a3demo_getContactIslandRoot(a3_DemoContactSolver *solver, const unsigned int body)
+{
+	if (solver && body < solver->bodyCount)
+		return a3demo_solverFind(solver->parent, body);
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,173 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoContactSolver.h
+	Sequential impulse contact solver with warm starting and islands.
+*/
+
+#ifndef __ANIMAL3D_DEMOCONTACTSOLVER_H
+#define __ANIMAL3D_DEMOCONTACTSOLVER_H
+
+
+#include "a3_DemoRigidBody.h"
+#include "a3_DemoNarrowphase.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoContactRow			a3_DemoContactRow;
+	typedef struct a3_DemoContactConstraint	a3_DemoContactConstraint;
+	typedef struct a3_DemoContactImpulse	a3_DemoContactImpulse;
+	typedef struct a3_DemoContactIsland		a3_DemoContactIsland;
+	typedef struct a3_DemoContactSolver		a3_DemoContactSolver;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// one constraint direction: jacobian, effective mass and the impulse
+	//	accumulated so far
+	struct a3_DemoContactRow
+	{
+		a3real3 direction;
+		a3real3 armA, armB;				// contact arm cross direction
+		a3real3 angularA, angularB;		// inverse inertia times the arms
+		a3real mass;					// effective mass along the direction
+		a3real impulse;
+	};
+
+	// one contact point between two bodies: a normal row and two
+	//	friction rows
+	struct a3_DemoContactConstraint
+	{
+		unsigned int a, b;				// body indices; normal points from a to b
+		unsigned int feature;			// manifold feature id, for the cache
+		a3_DemoContactRow normal, tangent[2];
+		a3real3 rA, rB;					// contact point relative to each center
+		a3real bias;					// least separating velocity (negative: gap)
+		a3real push;					// push velocity that removes overlap
+		a3real impulsePush;				// not cached: overlap is new each step
+	};
+
+	// impulses kept from the previous step, found again by body pair,
+	//	feature and position so the next solve starts from last step's answer
+	struct a3_DemoContactImpulse
+	{
+		unsigned int a, b, feature;		// a is ~0 for an empty slot
+		a3real3 localA;					// point in body a's frame
+		a3real normal, tangent0, tangent1;
+	};
+
+	// bodies connected through contacts (static bodies do not connect);
+	//	each island's constraints are contiguous and solved by one job
+	struct a3_DemoContactIsland
+	{
+		unsigned int first, count;		// constraint range
+		a3real residualFirst;			// total normal impulse change, first iteration
+		a3real residualLast;			// and last iteration
+	};
+
+	// solver state and workspace
+	struct a3_DemoContactSolver
+	{
+		a3_DemoJobSystem *jobs;			// scheduler for islands; null is serial
+
+		// settings
+		unsigned int iterations;		// velocity iterations per step
+		unsigned int warmStart;			// start from cached impulses
+		a3real friction;				// Coulomb coefficient
+		a3real baumgarte;				// fraction of overlap pushed out per step
+		a3real slop;					// overlap left alone, for resting contact
+
+		// constraints in island order
+		a3_DemoContactConstraint *constraint;
+		unsigned int constraintCount, constraintCapacity;
+
+		// islands and per-body workspace
+		a3_DemoContactIsland *island;
+		unsigned int islandCount, islandCapacity;
+		unsigned int *parent;			// union-find forest
+		unsigned int *islandOf;			// island per root body (~0 for none)
+		unsigned int bodyCount;			// bodies in the last solve
+		unsigned int bodyCapacity;
+
+		// impulse cache: open addressing, power-of-two size; rebuilt after
+		//	every solve from what was solved
+		a3_DemoContactImpulse *cache;
+		unsigned int cacheSize, cacheCount;
+
+		// body store contacts: the bodies in them mirrored as rigid bodies,
+		//	the store index of each mirror, and each store body's mirror
+		//	(~0 for none)
+		a3_DemoRigidBody *mirror;
+		unsigned int *mirrorBody;
+		unsigned int *mirrorOf;
+		unsigned int mirrorCapacity, storeCapacity;
+
+		// stats from the last solve
+		unsigned int warmStarted;		// constraints that found a cached impulse
+		unsigned int largestIsland;		// constraints in the biggest island
+		a3real residualFirst;			// summed over islands
+		a3real residualLast;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup with default settings, warm started; zero iterations uses 10
+	int a3demo_initContactSolver(a3_DemoContactSolver *solver, const unsigned int iterations, a3_DemoJobSystem *jobs);
+	int a3demo_releaseContactSolver(a3_DemoContactSolver *solver);
+
+	// forget cached impulses (after bodies are added, removed or teleported)
+	int a3demo_resetContactSolver(a3_DemoContactSolver *solver);
+
+	// build constraints from manifolds (manifold a and b are body indices),
+	//	split them into islands and apply impulses to the bodies' velocities
+	//	-> returns constraint count or -1 if out of memory
+	int a3demo_solveContacts(a3_DemoContactSolver *solver, a3_DemoRigidBody *bodies, const unsigned int bodyCount, const a3_DemoContactManifold *manifolds, const unsigned int manifoldCount, const a3real dt);
+
+	// the same for a body store (manifold a and b are store indices, as
+	//	a3demo_collideBodySpheres writes them): bodies in contact are
+	//	solved as spheres that do not spin, since the store keeps no
+	//	rotation, and get their new velocities and overlap correction
+	//	back; held bodies (a3demo_bodyFlags_held) are immovable; the mirrors are numbered afresh each call, so warm starting
+	//	should be off for a solver used this way
+	//	-> returns constraint count or -1 if out of memory
+	int a3demo_solveBodyStoreContacts(a3_DemoContactSolver *solver, a3_DemoBodyStore *bodies, a3_DemoContactManifold *manifolds, const unsigned int manifoldCount, const a3real dt);
+
+	// representative body of the island a body was solved in by the last
+	//	solve (a body that touched nothing is its own); -1 if out of range
+	int a3demo_getContactIslandRoot(a3_DemoContactSolver *solver, const unsigned int body);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOCONTACTSOLVER_H
@@ -0,0 +1,471 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoContinuous.c
+	Swept spheres, conservative advancement and impact ordering.
+*/
+
+#include "a3_DemoContinuous.h"
+#include "a3_DemoGJK.h"
+#include "../_utilities/a3_DemoTrig.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// gap at which advancement counts as touching
+static const a3real a3demo_continuousTolerance = 0.005f;
+
+
+inline a3real a3demo_continuousDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// rotate v about a unit axis by an angle in radians (Rodrigues)
+inline void a3demo_continuousRotate(a3real *out, const a3real *v, const a3real *axis, const a3real angle)
+{
+	a3real s, c, k;
+	a3demo_sinCosr(angle, &s, &c, a3demo_trig_full);
+	k = a3demo_continuousDot(axis, v) * (a3realOne - c);
+	out[0] = v[0] * c + (axis[1] * v[2] - axis[2] * v[1]) * s + axis[0] * k;
+	out[1] = v[1] * c + (axis[2] * v[0] - axis[0] * v[2]) * s + axis[1] * k;
+	out[2] = v[2] * c + (axis[0] * v[1] - axis[1] * v[0]) * s + axis[2] * k;
+}
+
+// pose after moving and spinning at constant rates for some time
+inline void a3demo_continuousPoseAt(a3_DemoColliderPose *out, const a3_DemoColliderPose *pose, const a3real *velocity, const a3real *spinAxis, const a3real spin, const a3real time)
+{
+	unsigned int i;
+	out->position[0] = pose->position[0] + velocity[0] * time;
+	out->position[1] = pose->position[1] + velocity[1] * time;
+	out->position[2] = pose->position[2] + velocity[2] * time;
+	if (spin > a3realZero)
+		for (i = 0; i < 3; ++i)
+			a3demo_continuousRotate(out->rotation[i], pose->rotation[i], spinAxis, spin * time);
+	else
+		memcpy(out->rotation, pose->rotation, sizeof(a3real3x3));
+}
+
+// time a separating plane with the shape a gap in front of it needs to
+//	close down to the target, when the plane's normal (toward the shape)
+//	is n and no point of the shape moves faster than the velocity plus
+//	the spin reach
+inline a3real a3demo_continuousFaceTime(const a3real gap, const a3real *n, const a3real *velocity, const a3real spinReach, const a3real target)
+{
+	a3real approach = -a3demo_continuousDot(velocity, n);
+	approach = a3maximum(approach, a3realZero) + spinReach;
+	if (gap <= target)
+		return a3realZero;
+	return approach > a3realZero ? (gap - target) / approach : (a3real)FLT_MAX;
+}
+
+// lower bound on the distance from a shape to an obstacle, the direction
+//	from the obstacle toward the shape it was measured along, and how
+//	long the shape can certainly move before it drops to the target:
+//	exact for planes; for boxes the widest separation along a face
+//	normal, which is never more than the true distance, and since every
+//	face must close before the box is reached, the slowest face to close
+//	sets the time; for anything else the gap between bounding spheres
+a3real a3demo_continuousGap(a3real *normal_out, a3real *time_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *velocity, const a3real spinReach, const a3_DemoCollider *obstacle, const a3_DemoColliderPose *obstaclePose, const a3real target)
+{
+	a3real center[3], obstacleCenter[3], axis[3], offset[3], toward[3], side, gap, time, best = a3realZero;
+	unsigned int i;
+
+	a3demo_getColliderWorldFrame(obstacle, obstaclePose, obstacleCenter, axis);
+	a3demo_getColliderWorldFrame(collider, pose, center, toward);
+	offset[0] = center[0] - obstacleCenter[0];
+	offset[1] = center[1] - obstacleCenter[1];
+	offset[2] = center[2] - obstacleCenter[2];
+	switch (obstacle->type)
+	{
+	case a3demo_collider_plane:
+		toward[0] = -axis[0];
+		toward[1] = -axis[1];
+		toward[2] = -axis[2];
+		memcpy(normal_out, axis, sizeof(a3real3));
+		gap = a3demo_continuousDot(offset, axis) - a3demo_getColliderExtent(collider, pose, toward);
+		*time_out = a3demo_continuousFaceTime(gap, axis, velocity, spinReach, target);
+		return gap;
+	case a3demo_collider_box:
+		*time_out = a3realZero;
+		for (i = 0; i < 3; ++i)
+		{
+			side = a3demo_continuousDot(offset, obstaclePose->rotation[i]) < a3realZero ? -a3realOne : a3realOne;
+			toward[0] = -obstaclePose->rotation[i][0] * side;
+			toward[1] = -obstaclePose->rotation[i][1] * side;
+			toward[2] = -obstaclePose->rotation[i][2] * side;
+			gap = -a3demo_continuousDot(offset, toward) - obstacle->halfExtent[i] - a3demo_getColliderExtent(collider, pose, toward);
+			axis[0] = -toward[0];
+			axis[1] = -toward[1];
+			axis[2] = -toward[2];
+			time = a3demo_continuousFaceTime(gap, axis, velocity, spinReach, target);
+			*time_out = a3maximum(*time_out, time);
+			if (!i || gap > best)
+			{
+				best = gap;
+				memcpy(normal_out, axis, sizeof(a3real3));
+			}
+		}
+		return best;
+	default:
+		offset[0] = pose->position[0] - obstaclePose->position[0];
+		offset[1] = pose->position[1] - obstaclePose->position[1];
+		offset[2] = pose->position[2] - obstaclePose->position[2];
+		gap = (a3real)sqrt(a3demo_continuousDot(offset, offset));
+		if (gap > a3realZero)
+		{
+			normal_out[0] = offset[0] / gap;
+			normal_out[1] = offset[1] / gap;
+			normal_out[2] = offset[2] / gap;
+		}
+		else
+		{
+			normal_out[0] = normal_out[1] = a3realZero;
+			normal_out[2] = a3realOne;
+		}
+		gap -= collider->boundingRadius + obstacle->boundingRadius;
+		time = (a3real)sqrt(a3demo_continuousDot(velocity, velocity)) + spinReach;
+		*time_out = gap <= target ? a3realZero : time > a3realZero ? (gap - target) / time : (a3real)FLT_MAX;
+		return gap;
+	}
+}
+
+// events earliest first, ties by pair so the order is reproducible
+int a3demo_continuousCompareEvents(const a3_DemoImpactEvent *a, const a3_DemoImpactEvent *b)
+{
+	if (a->toi != b->toi)
+		return a->toi < b->toi ? -1 : +1;
+	if (a->a != b->a)
+		return a->a < b->a ? -1 : +1;
+	return a->b < b->b ? -1 : a->b > b->b;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createContinuous(a3_DemoContinuous *ccd, const unsigned int capacity, const a3real threshold)
+{
+	if (ccd && capacity && threshold >= a3realZero)
+	{
+		memset(ccd, 0, sizeof(a3_DemoContinuous));
+		ccd->startX = (a3real *)malloc(capacity * 3 * sizeof(a3real));
+		ccd->fast = (unsigned int *)malloc(capacity * sizeof(unsigned int));
+		if (!ccd->startX || !ccd->fast || a3demo_createBodyStore(ccd->swept, capacity) < 0)
+		{
+			a3demo_releaseContinuous(ccd);
+			return -1;
+		}
+		ccd->startY = ccd->startX + capacity;
+		ccd->startZ = ccd->startY + capacity;
+		ccd->threshold = threshold;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseContinuous(a3_DemoContinuous *ccd)
+{
+	if (ccd)
+	{
+		a3demo_releaseBodyStore(ccd->swept);
+		free(ccd->startX);
+		free(ccd->fast);
+		free(ccd->event);
+		memset(ccd, 0, sizeof(a3_DemoContinuous));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_beginContinuous(a3_DemoContinuous *ccd, const a3_DemoBodyStore *bodies)
+{
+	if (ccd && ccd->startX && bodies && bodies->count <= ccd->swept->capacity)
+	{
+		memcpy(ccd->startX, bodies->posX, bodies->count * sizeof(a3real));
+		memcpy(ccd->startY, bodies->posY, bodies->count * sizeof(a3real));
+		memcpy(ccd->startZ, bodies->posZ, bodies->count * sizeof(a3real));
+		ccd->swept->count = bodies->count;
+		return bodies->count;
+	}
+	return -1;
+}
+
+int a3demo_sweepContinuous(a3_DemoContinuous *ccd, const a3_DemoBodyStore *bodies)
+{
+	if (ccd && ccd->startX && bodies && bodies->count == ccd->swept->count)
+	{
+		a3_DemoBodyStore *const swept = ccd->swept;
+		a3real d[3], length;
+		unsigned int i;
+
+		// the sphere around the middle of the path, grown by half its
+		//	length, holds the body everywhere along it
+		ccd->fastCount = 0;
+		for (i = 0; i < bodies->count; ++i)
+		{
+			d[0] = bodies->posX[i] - ccd->startX[i];
+			d[1] = bodies->posY[i] - ccd->startY[i];
+			d[2] = bodies->posZ[i] - ccd->startZ[i];
+			length = (a3real)sqrt(a3demo_continuousDot(d, d));
+			swept->posX[i] = ccd->startX[i] + d[0] * a3realHalf;
+			swept->posY[i] = ccd->startY[i] + d[1] * a3realHalf;
+			swept->posZ[i] = ccd->startZ[i] + d[2] * a3realHalf;
+			swept->radius[i] = bodies->radius[i] + length * a3realHalf;
+			swept->flags[i] = bodies->flags[i] & a3demo_bodyFlag_sleeping;
+			if (bodies->radius[i] > a3realZero && length > ccd->threshold * bodies->radius[i])
+			{
+				swept->flags[i] |= a3demo_bodyFlag_fast;
+				ccd->fast[ccd->fastCount++] = i;
+			}
+		}
+		return ccd->fastCount;
+	}
+	return -1;
+}
+
+int a3demo_collectImpacts(a3_DemoContinuous *ccd, const a3_DemoBodyPair *pair, const unsigned int pairCount, const a3_DemoBodyStore *bodies)
+{
+	if (ccd && ccd->startX && (pair || !pairCount) && bodies && bodies->count == ccd->swept->count)
+	{
+		const unsigned int *flags = ccd->swept->flags;
+		a3_DemoImpactEvent *event;
+		a3real startA[3], startB[3], moveA[3], moveB[3];
+		unsigned int i, a, b;
+
+		ccd->eventCount = 0;
+		for (i = 0; i < pairCount; ++i, ++pair)
+		{
+			a = pair->a;
+			b = pair->b;
+			if (!((flags[a] | flags[b]) & a3demo_bodyFlag_fast))
+				continue;
+
+			startA[0] = ccd->startX[a];
+			startA[1] = ccd->startY[a];
+			startA[2] = ccd->startZ[a];
+			startB[0] = ccd->startX[b];
+			startB[1] = ccd->startY[b];
+			startB[2] = ccd->startZ[b];
+			moveA[0] = bodies->posX[a] - startA[0];
+			moveA[1] = bodies->posY[a] - startA[1];
+			moveA[2] = bodies->posZ[a] - startA[2];
+			moveB[0] = bodies->posX[b] - startB[0];
+			moveB[1] = bodies->posY[b] - startB[1];
+			moveB[2] = bodies->posZ[b] - startB[2];
+
+			if (ccd->eventCount == ccd->eventCapacity)
+			{
+				const unsigned int capacity = ccd->eventCapacity ? ccd->eventCapacity + ccd->eventCapacity / 2 : 64;
+				event = (a3_DemoImpactEvent *)realloc(ccd->event, capacity * sizeof(a3_DemoImpactEvent));
+				if (!event)
+					break;
+				ccd->event = event;
+				ccd->eventCapacity = capacity;
+			}
+			event = ccd->event + ccd->eventCount;
+			if (a3demo_sweepSpheres(&event->toi, event->normal, startA, moveA, bodies->radius[a], startB, moveB, bodies->radius[b]))
+			{
+				event->a = a;
+				event->b = b;
+				++ccd->eventCount;
+			}
+		}
+
+		return a3demo_sortImpacts(ccd->event, ccd->eventCount);
+	}
+	return -1;
+}
+
+int a3demo_applyImpacts(a3_DemoContinuous *ccd, a3_DemoBodyStore *bodies)
+{
+	if (ccd && ccd->startX && bodies && bodies->count == ccd->swept->count)
+	{
+		unsigned int *const flags = ccd->swept->flags;
+		const a3_DemoImpactEvent *event = ccd->event, *const end = event + ccd->eventCount;
+		unsigned int i, k, moved = 0;
+
+		// events are earliest first, so a body's first one is its stop
+		for (; event < end; ++event)
+			for (k = 0; k < 2; ++k)
+			{
+				i = k ? event->b : event->a;
+				if ((flags[i] & a3demo_bodyFlag_impact) || (bodies->flags[i] & a3demo_bodyFlags_held))
+					continue;
+				flags[i] |= a3demo_bodyFlag_impact;
+				bodies->posX[i] = ccd->startX[i] + (bodies->posX[i] - ccd->startX[i]) * event->toi;
+				bodies->posY[i] = ccd->startY[i] + (bodies->posY[i] - ccd->startY[i]) * event->toi;
+				bodies->posZ[i] = ccd->startZ[i] + (bodies->posZ[i] - ccd->startZ[i]) * event->toi;
+				++moved;
+			}
+		return moved;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_sortImpacts(a3_DemoImpactEvent *event, const unsigned int count)
+{
+	if (event || !count)
+	{
+		if (count > 1)
+			qsort(event, count, sizeof(a3_DemoImpactEvent), (int(*)(const void *, const void *))a3demo_continuousCompareEvents);
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_sweepSpheres(a3real *toi_out, a3real *normal_out, const a3real *startA, const a3real *moveA, const a3real radiusA, const a3real *startB, const a3real *moveB, const a3real radiusB)
+{
+	if (toi_out && startA && moveA && startB && moveB)
+	{
+		// b relative to a: |p + t d| = r is a quadratic in t; the first
+		//	root is where they meet
+		const a3real r = radiusA + radiusB;
+		const a3real p[3] = { startB[0] - startA[0], startB[1] - startA[1], startB[2] - startA[2] };
+		const a3real d[3] = { moveB[0] - moveA[0], moveB[1] - moveA[1], moveB[2] - moveA[2] };
+		const a3real dd = a3demo_continuousDot(d, d), pd = a3demo_continuousDot(p, d);
+		const a3real c = a3demo_continuousDot(p, p) - r * r;
+		a3real disc, t, n[3], len;
+
+		if (c <= a3realZero || pd >= a3realZero || dd <= a3realZero)
+			return 0;
+		disc = pd * pd - dd * c;
+		if (disc < a3realZero)
+			return 0;
+		t = (-pd - (a3real)sqrt(disc)) / dd;
+		if (t > a3realOne)
+			return 0;
+
+		*toi_out = t;
+		if (normal_out)
+		{
+			n[0] = p[0] + d[0] * t;
+			n[1] = p[1] + d[1] * t;
+			n[2] = p[2] + d[2] * t;
+			len = (a3real)sqrt(a3demo_continuousDot(n, n));
+			len = len > a3realZero ? a3recip(len) : a3realZero;
+			normal_out[0] = n[0] * len;
+			normal_out[1] = n[1] * len;
+			normal_out[2] = n[2] * len;
+		}
+		return 1;
+	}
+	return 0;
+}
+
+a3real a3demo_getColliderExtent(const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *direction)
+{
+	a3real center[3], axis[3], along, across;
+	if (!collider || !pose || !direction)
+		return a3realZero;
+	a3demo_getColliderWorldFrame(collider, pose, center, axis);
+	along = a3demo_continuousDot(direction, axis);
+	across = (a3real)sqrt(a3maximum(a3realOne - along * along, a3realZero));
+	switch (collider->type)
+	{
+	case a3demo_collider_sphere:
+		return collider->radius;
+	case a3demo_collider_box:
+		return collider->halfExtent[0] * (a3real)fabs(a3demo_continuousDot(direction, pose->rotation[0]))
+			+ collider->halfExtent[1] * (a3real)fabs(a3demo_continuousDot(direction, pose->rotation[1]))
+			+ collider->halfExtent[2] * (a3real)fabs(a3demo_continuousDot(direction, pose->rotation[2]));
+	case a3demo_collider_capsule:
+		return collider->halfLength * (a3real)fabs(along) + collider->radius;
+	case a3demo_collider_cylinder:
+		return collider->halfLength * (a3real)fabs(along) + collider->radius * across;
+	case a3demo_collider_cone:
+		// apex along the axis, base rim the other way
+		return a3maximum(collider->halfLength * along, collider->radius * across - collider->halfLength * along);
+	case a3demo_collider_hull:
+		if (a3demo_getColliderSupport(axis, collider, pose, direction, 0) <= 0)
+			return collider->boundingRadius;
+		axis[0] -= center[0];
+		axis[1] -= center[1];
+		axis[2] -= center[2];
+		return a3demo_continuousDot(axis, direction);
+	default:
+		return collider->boundingRadius;
+	}
+}
+
+int a3demo_advanceCollider(a3real *toi_out, a3real *normal_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *velocity, const a3real *angularVelocity, const a3real dt, const a3_DemoCollider *obstacle, const a3_DemoColliderPose *obstaclePose)
+{
+	if (toi_out && normal_out && collider && pose && velocity && angularVelocity && dt > a3realZero && obstacle && obstaclePose)
+	{
+		a3_DemoColliderPose current[1];
+		a3real normal[3], spinAxis[3] = { a3realZero };
+		a3real spin, spinReach, gap, target, step, time = a3realZero;
+		unsigned int i;
+
+		spin = (a3real)sqrt(a3demo_continuousDot(angularVelocity, angularVelocity));
+		if (spin > a3realZero)
+		{
+			spinAxis[0] = angularVelocity[0] / spin;
+			spinAxis[1] = angularVelocity[1] / spin;
+			spinAxis[2] = angularVelocity[2] / spin;
+		}
+
+		// no point of the shape is further than its bounding radius from
+		//	the pose position, so spin moves none faster than this; a
+		//	sphere spinning about its own center does not change at all
+		spinReach = (collider->type == a3demo_collider_sphere && collider->offset == a3realZero) ?
+			a3realZero : spin * collider->boundingRadius;
+
+		// clear shapes stop just short of touching, where the discrete
+		//	test picks them up; shapes already touching (e.g. a corner that
+		//	just landed) may sink only a little further, so whatever else
+		//	the spin swings around is stopped as well
+		gap = a3demo_continuousGap(normal, &step, collider, pose, velocity, spinReach, obstacle, obstaclePose, a3realZero);
+		target = gap > a3demo_continuousTolerance + a3demo_continuousTolerance ? a3realZero : gap - a3demo_continuousTolerance - a3demo_continuousTolerance;
+
+		for (i = 0; i < a3demo_continuousMaxIterations; ++i)
+		{
+			a3demo_continuousPoseAt(current, pose, velocity, spinAxis, spin, time);
+			gap = a3demo_continuousGap(normal, &step, collider, current, velocity, spinReach, obstacle, obstaclePose, target);
+			if (gap <= target + a3demo_continuousTolerance)
+				break;
+			if (step >= dt - time)
+				return 0;
+			time += step;
+		}
+
+		// touching at the start is the discrete test's business; running
+		//	out of passes stops short, which is still safe
+		if (time <= a3realZero)
+			return 0;
+		*toi_out = time / dt;
+		normal_out[0] = -normal[0];
+		normal_out[1] = -normal[1];
+		normal_out[2] = -normal[2];
+		return 1;
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
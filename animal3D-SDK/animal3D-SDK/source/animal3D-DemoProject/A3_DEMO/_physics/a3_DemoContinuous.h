@@ -0,0 +1,150 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoContinuous.h
+	Continuous collision: time of impact for bodies that move too far in
+		one step for discrete tests to see them touch.
+*/
+
+#ifndef __ANIMAL3D_DEMOCONTINUOUS_H
+#define __ANIMAL3D_DEMOCONTINUOUS_H
+
+
+#include "a3_DemoBroadphase.h"
+#include "a3_DemoCollider.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoImpactEvent		a3_DemoImpactEvent;
+	typedef struct a3_DemoContinuous		a3_DemoContinuous;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// continuous collision constants
+	enum a3_DemoContinuousConstants
+	{
+		a3demo_continuousMaxIterations = 32,	// advancement passes before giving up
+	};
+
+
+	// first touch of a pair during a step, at the fraction toi of the step,
+	//	with the normal from a to b at that moment
+	struct a3_DemoImpactEvent
+	{
+		a3real toi;
+		unsigned int a, b;
+		a3real3 normal;
+	};
+
+
+	// swept collision for a body store: positions are recorded before the
+	//	step, and afterwards every body gets a sphere enclosing its whole
+	//	path for the broadphase to run on, so pairs that crossed during
+	//	the step are still found
+	// bodies that moved further than the threshold times their radius
+	//	are fast (points, with no radius, never are); only pairs with a
+	//	fast body are swept, and those that first touched during the step
+	//	come out as events sorted by time of impact, for the caller to
+	//	handle in order or to apply
+	struct a3_DemoContinuous
+	{
+		a3real threshold;				// motion per step, in radii, that makes a body fast
+		a3_DemoBodyStore swept[1];		// path spheres: mid-path positions, inflated radii
+		a3real *startX, *startY, *startZ;	// positions before the step (heap)
+		unsigned int *fast;				// indices of fast bodies (heap)
+		unsigned int fastCount;
+
+		// events from the last sweep, earliest first
+		a3_DemoImpactEvent *event;
+		unsigned int eventCount, eventCapacity;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown for up to the given number of bodies
+	int a3demo_createContinuous(a3_DemoContinuous *ccd, const unsigned int capacity, const a3real threshold);
+	int a3demo_releaseContinuous(a3_DemoContinuous *ccd);
+
+	// record where every body is before it moves
+	int a3demo_beginContinuous(a3_DemoContinuous *ccd, const a3_DemoBodyStore *bodies);
+
+	// after the move: fill the swept store (sleeping flags carried over for
+	//	the broadphase) and pick out the fast bodies; returns fast count
+	int a3demo_sweepContinuous(a3_DemoContinuous *ccd, const a3_DemoBodyStore *bodies);
+
+	// sweep candidate pairs (from a broadphase on the swept store) that
+	//	have a fast body, and sort what hits by time of impact; pairs
+	//	already touching at the start are left to the discrete test
+	//	-> returns event count
+	int a3demo_collectImpacts(a3_DemoContinuous *ccd, const a3_DemoBodyPair *pair, const unsigned int pairCount, const a3_DemoBodyStore *bodies);
+
+	// take every body in an event back along its path to where it was at
+	//	its earliest impact, so that it stops touching rather than passing
+	//	through; velocities are left for the contact that follows, and held
+	//	bodies (on rails or asleep) stay where they are
+	//	-> returns bodies moved (their integrator state is stale)
+	int a3demo_applyImpacts(a3_DemoContinuous *ccd, a3_DemoBodyStore *bodies);
+
+
+	// order events by time of impact, then by pair, so handling them in
+	//	turn is reproducible; returns count
+	int a3demo_sortImpacts(a3_DemoImpactEvent *event, const unsigned int count);
+
+
+	// two spheres moving in straight lines: fraction of the motion at
+	//	which they first touch, and the normal from a to b there
+	//	-> returns 1 on a hit within the motion, 0 if they miss or
+	//		already overlap at the start
+	int a3demo_sweepSpheres(a3real *toi_out, a3real *normal_out, const a3real *startA, const a3real *moveA, const a3real radiusA, const a3real *startB, const a3real *moveB, const a3real radiusB);
+
+	// conservative advancement of a collider moving and spinning at
+	//	constant rates for time dt toward an obstacle held still: steps
+	//	forward by a lower bound on the distance over the fastest any point
+	//	can approach, so it can never step past the surface; exact against
+	//	planes, and against boxes it uses the face normals only, so near
+	//	edges it may stop a little early; other obstacles are taken as
+	//	their bounding spheres
+	//	-> returns 1 on a hit within dt (fraction in toi_out, normal from
+	//		the collider toward the obstacle), 0 if it stays clear or
+	//		already touches at the start
+	int a3demo_advanceCollider(a3real *toi_out, a3real *normal_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *velocity, const a3real *angularVelocity, const a3real dt, const a3_DemoCollider *obstacle, const a3_DemoColliderPose *obstaclePose);
+
+	// how far a posed collider reaches from its center along a unit
+	//	direction (its support distance)
+	a3real a3demo_getColliderExtent(const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *direction);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOCONTINUOUS_H
@@ -0,0 +1,919 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoConvexHull.c
+	Quickhull and hull support queries.
+*/
+
+#include "a3_DemoConvexHull.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// no face, point or vertex
+#define A3_HULL_NONE	0xffffffff
+
+
+// hull face while building; faces that go away are kept for reuse
+typedef struct a3_DemoHullFace
+{
+	a3real plane[4];				// outward unit normal and offset
+	unsigned int v[3];				// corner points, counterclockwise from outside
+	unsigned int adj[3];			// face across each edge v[i] -> v[i + 1]
+	unsigned int outside;			// first point of its outside set
+	unsigned int farthest;			// the one farthest out
+	a3real farthestDistance;
+	unsigned int visit;				// step it was last looked at in
+	int visible, alive;
+} a3_DemoHullFace;
+
+// edge of the horizon: a -> b on the visible side, and where it is on
+//	the hidden face across it
+typedef struct a3_DemoHullEdge
+{
+	unsigned int a, b;
+	unsigned int face, edge;
+} a3_DemoHullEdge;
+
+// everything one hull build needs; per-point arrays are sized to the cloud
+typedef struct a3_DemoHullBuilder
+{
+	const a3real *point;
+	unsigned int count;
+	unsigned int maxVertices;
+	a3real tolerance;
+	a3real outside;					// farthest point left out so far
+
+	a3_DemoHullFace *face;
+	unsigned int faceCount, faceCapacity;
+	unsigned int *freeFace;			// faces that went away, for reuse
+	unsigned int freeCount, freeCapacity;
+	unsigned int *pending;			// faces that may have outside points
+	unsigned int pendingCount, pendingCapacity;
+	unsigned int *visible;			// faces seen by the current eye point
+	unsigned int visibleCount, visibleCapacity;
+	a3_DemoHullEdge *horizon;
+	unsigned int horizonCount, horizonCapacity;
+
+	unsigned int *next;				// per point: next in its outside set
+	unsigned int *mark;				// per point: step it was last marked in
+	unsigned int *from;				// per point: horizon edge or new face from it
+	a3real *distance;				// per point: height over the face it is assigned to
+	unsigned int step, vertexCount;
+} a3_DemoHullBuilder;
+
+// one chunk of a large cloud, hulled on its own
+typedef struct a3_DemoHullChunk
+{
+	const a3real *point;
+	unsigned int count;
+	a3real tolerance;
+	a3real *vertex;					// what survives of it (heap)
+	unsigned int vertexCount;
+	int status;
+} a3_DemoHullChunk;
+
+
+inline a3real a3demo_hullDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_hullCross(a3real *out, const a3real *a, const a3real *b)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// height of a point over a face's plane
+inline a3real a3demo_hullDistance(const a3_DemoHullFace *face, const a3real *p)
+{
+	return a3demo_hullDot(face->plane, p) - face->plane[3];
+}
+
+// make room for one more of something in a growing array
+inline int a3demo_hullReserve(void **array, unsigned int *capacity, const unsigned int count, const unsigned int size)
+{
+	if (count >= *capacity)
+	{
+		const unsigned int grown = *capacity ? *capacity * 2 : 64;
+		void *resized = realloc(*array, grown * size);
+		if (!resized)
+			return 0;
+		*array = resized;
+		*capacity = grown;
+	}
+	return 1;
+}
+
+// plane of a face from its corners, worked out in double: slivers are
+//	common on round clouds, and their normals lose everything to rounding
+//	in float; the offset is taken at the centroid
+void a3demo_hullFacePlane(a3_DemoHullFace *face, const a3real *point)
+{
+	const a3real *a = point + face->v[0] * 3, *b = point + face->v[1] * 3, *c = point + face->v[2] * 3;
+	const double e0[3] = { (double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2] };
+	const double e1[3] = { (double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2] };
+	double n[3], length;
+
+	n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+	n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+	n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	if (length > 0.0)
+	{
+		n[0] /= length;
+		n[1] /= length;
+		n[2] /= length;
+	}
+	face->plane[0] = (a3real)n[0];
+	face->plane[1] = (a3real)n[1];
+	face->plane[2] = (a3real)n[2];
+	face->plane[3] = (a3real)((n[0] * ((double)a[0] + b[0] + c[0]) + n[1] * ((double)a[1] + b[1] + c[1]) + n[2] * ((double)a[2] + b[2] + c[2])) / 3.0);
+}
+
+// new face, reusing one that went away if there is one
+//	-> returns face index, A3_HULL_NONE if out of memory
+unsigned int a3demo_hullNewFace(a3_DemoHullBuilder *builder, const unsigned int a, const unsigned int b, const unsigned int c)
+{
+	a3_DemoHullFace *face;
+	unsigned int i;
+	if (builder->freeCount)
+		i = builder->freeFace[--builder->freeCount];
+	else if (a3demo_hullReserve((void **)&builder->face, &builder->faceCapacity, builder->faceCount, sizeof(a3_DemoHullFace)))
+		i = builder->faceCount++;
+	else
+		return A3_HULL_NONE;
+
+	face = builder->face + i;
+	face->v[0] = a;
+	face->v[1] = b;
+	face->v[2] = c;
+	face->adj[0] = face->adj[1] = face->adj[2] = A3_HULL_NONE;
+	face->outside = face->farthest = A3_HULL_NONE;
+	face->farthestDistance = a3realZero;
+	face->visit = 0;
+	face->visible = 0;
+	face->alive = 1;
+	a3demo_hullFacePlane(face, builder->point);
+	return i;
+}
+
+// put a point in a face's outside set
+//	-> returns 0 if out of memory
+int a3demo_hullAssign(a3_DemoHullBuilder *builder, const unsigned int f, const unsigned int p, const a3real distance)
+{
+	a3_DemoHullFace *face = builder->face + f;
+	if (face->outside == A3_HULL_NONE && !builder->maxVertices)
+	{
+		if (!a3demo_hullReserve((void **)&builder->pending, &builder->pendingCapacity, builder->pendingCount, sizeof(unsigned int)))
+			return 0;
+		builder->pending[builder->pendingCount++] = f;
+	}
+	if (face->farthest == A3_HULL_NONE || distance > face->farthestDistance)
+	{
+		face->farthest = p;
+		face->farthestDistance = distance;
+	}
+	builder->next[p] = face->outside;
+	face->outside = p;
+	return 1;
+}
+
+// give up on a point that cannot be added cleanly (its horizon would not
+//	be a single loop, which only happens within rounding of the hull);
+//	it is left out, and counted as outside by its height
+//	-> returns 0 if out of memory
+int a3demo_hullDrop(a3_DemoHullBuilder *builder, const unsigned int f, const unsigned int p)
+{
+	a3_DemoHullFace *face = builder->face + f;
+	unsigned int *link = &face->outside, q;
+
+	builder->outside = a3maximum(builder->outside, face->farthestDistance);
+	while (*link != p)
+		link = builder->next + *link;
+	*link = builder->next[p];
+
+	face->farthest = A3_HULL_NONE;
+	face->farthestDistance = a3realZero;
+	for (q = face->outside; q != A3_HULL_NONE; q = builder->next[q])
+		if (face->farthest == A3_HULL_NONE || builder->distance[q] > face->farthestDistance)
+		{
+			face->farthest = q;
+			face->farthestDistance = builder->distance[q];
+		}
+
+	// the face came off the pending list, so it goes back if it still
+	//	has points
+	if (face->outside != A3_HULL_NONE && !builder->maxVertices)
+	{
+		if (!a3demo_hullReserve((void **)&builder->pending, &builder->pendingCapacity, builder->pendingCount, sizeof(unsigned int)))
+			return 0;
+		builder->pending[builder->pendingCount++] = f;
+	}
+	return 1;
+}
+
+// distance of every point to the first four faces (parallel range)
+void a3demo_hullClassify(a3_DemoHullBuilder *builder, const unsigned int first, const unsigned int count)
+{
+	const a3_DemoHullFace *const face = builder->face;
+	const a3real *p = builder->point + first * 3;
+	unsigned int i, f, best;
+	a3real d, bestDistance;
+
+	for (i = first; i < first + count; ++i, p += 3)
+	{
+		best = A3_HULL_NONE;
+		bestDistance = builder->tolerance;
+		for (f = 0; f < 4; ++f)
+		{
+			d = a3demo_hullDistance(face + f, p);
+			if (d > bestDistance)
+			{
+				best = f;
+				bestDistance = d;
+			}
+		}
+		builder->next[i] = best;
+		builder->distance[i] = bestDistance;
+	}
+}
+
+// first tetrahedron, from the widest pair of axis extremes, the point
+//	farthest from their line and the point farthest from that plane
+//	-> returns 1, 0 if the cloud is flat within tolerance
+int a3demo_hullSimplex(unsigned int *simplex_out, const a3_DemoHullBuilder *builder)
+{
+	const a3real *const point = builder->point, *p, *p0, *p1, *p2;
+	unsigned int lo[3] = { 0 }, hi[3] = { 0 }, i, k, axis = 0, swap;
+	a3real d[3], e[3], n[3], spread, best, value;
+
+	for (i = 1; i < builder->count; ++i)
+		for (k = 0; k < 3; ++k)
+		{
+			if (point[i * 3 + k] < point[lo[k] * 3 + k])
+				lo[k] = i;
+			if (point[i * 3 + k] > point[hi[k] * 3 + k])
+				hi[k] = i;
+		}
+	best = a3realZero;
+	for (k = 0; k < 3; ++k)
+	{
+		spread = point[hi[k] * 3 + k] - point[lo[k] * 3 + k];
+		if (spread > best)
+		{
+			best = spread;
+			axis = k;
+		}
+	}
+	if (best <= builder->tolerance)
+		return 0;
+	simplex_out[0] = lo[axis];
+	simplex_out[1] = hi[axis];
+	p0 = point + simplex_out[0] * 3;
+	p1 = point + simplex_out[1] * 3;
+
+	// off the line: squared length of the cross product with its direction
+	e[0] = p1[0] - p0[0];
+	e[1] = p1[1] - p0[1];
+	e[2] = p1[2] - p0[2];
+	value = a3recip(a3demo_hullDot(e, e));
+	for (i = 0, best = a3realZero, simplex_out[2] = 0; i < builder->count; ++i)
+	{
+		p = point + i * 3;
+		d[0] = p[0] - p0[0];
+		d[1] = p[1] - p0[1];
+		d[2] = p[2] - p0[2];
+		a3demo_hullCross(n, d, e);
+		spread = a3demo_hullDot(n, n) * value;
+		if (spread > best)
+		{
+			best = spread;
+			simplex_out[2] = i;
+		}
+	}
+	if (best <= builder->tolerance * builder->tolerance)
+		return 0;
+	p2 = point + simplex_out[2] * 3;
+
+	// off the plane
+	d[0] = p2[0] - p0[0];
+	d[1] = p2[1] - p0[1];
+	d[2] = p2[2] - p0[2];
+	a3demo_hullCross(n, e, d);
+	value = a3recip((a3real)sqrt(a3demo_hullDot(n, n)));
+	n[0] *= value;
+	n[1] *= value;
+	n[2] *= value;
+	for (i = 0, best = a3realZero, simplex_out[3] = 0; i < builder->count; ++i)
+	{
+		p = point + i * 3;
+		d[0] = p[0] - p0[0];
+		d[1] = p[1] - p0[1];
+		d[2] = p[2] - p0[2];
+		spread = a3demo_hullDot(n, d);
+		if ((a3real)fabs(spread) > best)
+		{
+			best = (a3real)fabs(spread);
+			simplex_out[3] = i;
+		}
+	}
+	if (best <= builder->tolerance)
+		return 0;
+
+	// base faces away from the apex
+	p = point + simplex_out[3] * 3;
+	d[0] = p[0] - p0[0];
+	d[1] = p[1] - p0[1];
+	d[2] = p[2] - p0[2];
+	if (a3demo_hullDot(n, d) > a3realZero)
+	{
+		swap = simplex_out[1];
+		simplex_out[1] = simplex_out[2];
+		simplex_out[2] = swap;
+	}
+	return 1;
+}
+
+// height of a point over the plane through three others, in double for
+//	the same reason as face planes
+a3real a3demo_hullHeight(const a3real *point, const unsigned int a, const unsigned int b, const unsigned int c, const unsigned int q)
+{
+	const a3real *pa = point + a * 3, *pb = point + b * 3, *pc = point + c * 3, *pq = point + q * 3;
+	const double e0[3] = { (double)pb[0] - pa[0], (double)pb[1] - pa[1], (double)pb[2] - pa[2] };
+	const double e1[3] = { (double)pc[0] - pa[0], (double)pc[1] - pa[1], (double)pc[2] - pa[2] };
+	const double d[3] = { (double)pq[0] - pa[0], (double)pq[1] - pa[1], (double)pq[2] - pa[2] };
+	double n[3], length;
+
+	n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+	n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+	n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	return length > 0.0 ? (a3real)((n[0] * d[0] + n[1] * d[1] + n[2] * d[2]) / length) : a3realZero;
+}
+
+// add a face to the ones the current point sees
+//	-> returns 0 if out of memory
+inline int a3demo_hullSee(a3_DemoHullBuilder *builder, const unsigned int f)
+{
+	if (!a3demo_hullReserve((void **)&builder->visible, &builder->visibleCapacity, builder->visibleCount, sizeof(unsigned int)))
+		return 0;
+	builder->visible[builder->visibleCount++] = f;
+	return 1;
+}
+
+// add the farthest point of a face: find the faces it sees, check that
+//	their boundary is one loop, fan new faces from it to the point, and
+//	hand the old faces' outside points to the new ones
+//	-> returns 1 if added, 0 if it had to be left out, -1 if out of memory
+int a3demo_hullAddPoint(a3_DemoHullBuilder *builder, const unsigned int f, const unsigned int eye)
+{
+	const a3real *const p = builder->point + eye * 3;
+	const unsigned int step = ++builder->step;
+	a3_DemoHullFace *face = builder->face, *other;
+	a3_DemoHullEdge *edge;
+	unsigned int i, k, e, n, m, q, nextQ, best, length, spread;
+	a3real d, bestDistance;
+
+	// faces it sees, spreading out from the first; the hidden faces next
+	//	to them give the horizon
+	builder->visibleCount = 0;
+	builder->visible[builder->visibleCount++] = f;
+	face[f].visit = step;
+	face[f].visible = 1;
+	spread = 0;
+	do
+	{
+		for (; spread < builder->visibleCount; ++spread)
+			for (e = 0; e < 3; ++e)
+			{
+				n = face[builder->visible[spread]].adj[e];
+				other = face + n;
+				if (other->visit != step)
+				{
+					other->visit = step;
+					other->visible = a3demo_hullDistance(other, p) > builder->tolerance;
+					if (other->visible && !a3demo_hullSee(builder, n))
+						return -1;
+				}
+			}
+
+		builder->horizonCount = 0;
+		for (i = 0; i < builder->visibleCount; ++i)
+			for (e = 0; e < 3; ++e)
+			{
+				k = builder->visible[i];
+				n = face[k].adj[e];
+				other = face + n;
+				if (other->visible)
+					continue;
+				if (!a3demo_hullReserve((void **)&builder->horizon, &builder->horizonCapacity, builder->horizonCount, sizeof(a3_DemoHullEdge)))
+					return -1;
+				edge = builder->horizon + builder->horizonCount++;
+				edge->a = face[k].v[e];
+				edge->b = face[k].v[(e + 1) % 3];
+				edge->face = n;
+				for (m = 0; m < 3 && (other->v[m] != edge->b || other->v[(m + 1) % 3] != edge->a); ++m);
+				edge->edge = m;
+				if (m == 3)
+					return 0;
+			}
+
+		// a hidden face the point is only just under can still meet its
+		//	new face at a fold, if the point is close to the edge between
+		//	them and the new face is a sliver; the fold shows as the hidden
+		//	face's far corner over the new face, and the cure is to let the
+		//	point see that face too
+		for (i = 0, k = spread; i < builder->horizonCount; ++i)
+		{
+			edge = builder->horizon + i;
+			other = face + edge->face;
+			if (!other->visible && a3demo_hullHeight(builder->point, edge->a, edge->b, eye, other->v[(edge->edge + 2) % 3]) > builder->tolerance)
+			{
+				other->visible = 1;
+				if (!a3demo_hullSee(builder, edge->face))
+					return -1;
+			}
+		}
+	} while (builder->visibleCount > k);
+
+	// one loop: every corner starts exactly one edge, and walking from
+	//	edge to edge comes back around through all of them
+	for (i = 0; i < builder->horizonCount; ++i)
+	{
+		edge = builder->horizon + i;
+		if (builder->mark[edge->a] == step)
+			return 0;
+		builder->mark[edge->a] = step;
+		builder->from[edge->a] = i;
+	}
+	for (i = 0; i < builder->horizonCount; ++i)
+		if (builder->mark[builder->horizon[i].b] != step)
+			return 0;
+	for (i = builder->from[builder->horizon[0].b], length = 1; i && length <= builder->horizonCount; i = builder->from[builder->horizon[i].b], ++length);
+	if (length != builder->horizonCount)
+		return 0;
+
+	// fan of new faces, stitched to the hidden faces and to each other
+	for (i = 0; i < builder->horizonCount; ++i)
+	{
+		edge = builder->horizon + i;
+		n = a3demo_hullNewFace(builder, edge->a, edge->b, eye);
+		if (n == A3_HULL_NONE)
+			return -1;
+		face = builder->face;
+		face[n].adj[0] = edge->face;
+		face[edge->face].adj[edge->edge] = n;
+		builder->from[edge->a] = n;
+	}
+	for (i = 0; i < builder->horizonCount; ++i)
+	{
+		edge = builder->horizon + i;
+		n = builder->from[edge->a];
+		m = builder->from[edge->b];
+		face[n].adj[1] = m;
+		face[m].adj[2] = n;
+	}
+
+	// outside points move to whichever new face they are highest over;
+	//	the rest are inside now
+	for (i = 0; i < builder->visibleCount; ++i)
+	{
+		k = builder->visible[i];
+		for (q = face[k].outside; q != A3_HULL_NONE; q = nextQ)
+		{
+			nextQ = builder->next[q];
+			if (q == eye)
+				continue;
+			best = A3_HULL_NONE;
+			bestDistance = builder->tolerance;
+			for (e = 0; e < builder->horizonCount; ++e)
+			{
+				n = builder->from[builder->horizon[e].a];
+				d = a3demo_hullDistance(face + n, builder->point + q * 3);
+				if (d > bestDistance)
+				{
+					best = n;
+					bestDistance = d;
+				}
+			}
+			if (best != A3_HULL_NONE)
+			{
+				builder->distance[q] = bestDistance;
+				if (!a3demo_hullAssign(builder, best, q, bestDistance))
+					return -1;
+			}
+		}
+		face[k].alive = 0;
+		face[k].outside = A3_HULL_NONE;
+		if (!a3demo_hullReserve((void **)&builder->freeFace, &builder->freeCapacity, builder->freeCount, sizeof(unsigned int)))
+			return -1;
+		builder->freeFace[builder->freeCount++] = k;
+	}
+	++builder->vertexCount;
+	return 1;
+}
+
+// next face to grow from: with a vertex limit, the one with the farthest
+//	point of all, so the hull takes the most important points first;
+//	otherwise any that has outside points
+unsigned int a3demo_hullNextFace(a3_DemoHullBuilder *builder)
+{
+	const a3_DemoHullFace *face = builder->face;
+	unsigned int i, best = A3_HULL_NONE;
+	if (builder->maxVertices)
+	{
+		for (i = 0; i < builder->faceCount; ++i)
+			if (face[i].alive && face[i].outside != A3_HULL_NONE && (best == A3_HULL_NONE || face[i].farthestDistance > face[best].farthestDistance))
+				best = i;
+		if (best != A3_HULL_NONE && builder->vertexCount >= builder->maxVertices)
+		{
+			builder->outside = a3maximum(builder->outside, face[best].farthestDistance);
+			best = A3_HULL_NONE;
+		}
+	}
+	else while (builder->pendingCount && best == A3_HULL_NONE)
+	{
+		i = builder->pending[--builder->pendingCount];
+		if (face[i].alive && face[i].outside != A3_HULL_NONE)
+			best = i;
+	}
+	return best;
+}
+
+void a3demo_hullReleaseBuilder(a3_DemoHullBuilder *builder)
+{
+	free(builder->face);
+	free(builder->freeFace);
+	free(builder->pending);
+	free(builder->visible);
+	free(builder->horizon);
+	free(builder->next);
+	memset(builder, 0, sizeof(a3_DemoHullBuilder));
+}
+
+// build the hull of a cloud into a builder
+//	-> returns 1, 0 if flat, -1 if out of memory
+int a3demo_hullBuild(a3_DemoHullBuilder *builder, const a3real *point, const unsigned int count, const unsigned int maxVertices, const a3real tolerance, a3_DemoJobSystem *jobs)
+{
+	const unsigned int corner[4][3] = { { 0, 1, 2 }, { 1, 0, 3 }, { 2, 1, 3 }, { 0, 2, 3 } };
+	unsigned int simplex[4], i, j, e, m, f;
+
+	memset(builder, 0, sizeof(a3_DemoHullBuilder));
+	builder->point = point;
+	builder->count = count;
+	builder->maxVertices = maxVertices ? a3maximum(maxVertices, 4) : 0;
+	builder->tolerance = tolerance;
+	if (count < 4 || !a3demo_hullSimplex(simplex, builder))
+		return 0;
+
+	// per-point arrays in one block
+	builder->next = (unsigned int *)malloc(count * 4 * sizeof(unsigned int));
+	if (!builder->next)
+		return -1;
+	builder->mark = builder->next + count;
+	builder->from = builder->mark + count;
+	builder->distance = (a3real *)(builder->from + count);
+	memset(builder->mark, 0, count * sizeof(unsigned int));
+	if (!a3demo_hullReserve((void **)&builder->visible, &builder->visibleCapacity, 0, sizeof(unsigned int)))
+		return -1;
+
+	// tetrahedron, with each edge matched to the face that has it reversed
+	for (f = 0; f < 4; ++f)
+		if (a3demo_hullNewFace(builder, simplex[corner[f][0]], simplex[corner[f][1]], simplex[corner[f][2]]) == A3_HULL_NONE)
+			return -1;
+	for (f = 0; f < 4; ++f)
+		for (e = 0; e < 3; ++e)
+			for (i = 0; i < 4; ++i)
+				for (m = 0; m < 3; ++m)
+					if (builder->face[i].v[m] == builder->face[f].v[(e + 1) % 3] && builder->face[i].v[(m + 1) % 3] == builder->face[f].v[e])
+						builder->face[f].adj[e] = i;
+	builder->vertexCount = 4;
+
+	// every point against the tetrahedron is the one pass over the whole
+	//	cloud, so it runs in parallel; linking the sets up stays in order
+	//	so the result does not depend on the threads
+	a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_hullClassify, builder, count, a3demo_hullGrain);
+	for (i = 0; i < count; ++i)
+		if ((f = builder->next[i]) != A3_HULL_NONE)
+			if (!a3demo_hullAssign(builder, f, i, builder->distance[i]))
+				return -1;
+
+	while ((f = a3demo_hullNextFace(builder)) != A3_HULL_NONE)
+	{
+		j = builder->face[f].farthest;
+		switch (a3demo_hullAddPoint(builder, f, j))
+		{
+		case 0:
+			if (!a3demo_hullDrop(builder, f, j))
+				return -1;
+			break;
+		case -1:
+			return -1;
+		}
+	}
+	return 1;
+}
+
+// hull the points of a chunk, keeping its vertices (all of its points if
+//	it is flat, since they may still matter to the whole)
+void a3demo_hullChunkJob(a3_DemoHullChunk *chunk, const unsigned int first, const unsigned int count)
+{
+	a3_DemoHullBuilder builder[1];
+	const a3_DemoHullFace *face;
+	unsigned int i, k, c, p;
+
+	for (c = first, chunk += first; c < first + count; ++c, ++chunk)
+	{
+		chunk->status = a3demo_hullBuild(builder, chunk->point, chunk->count, 0, chunk->tolerance, 0);
+		chunk->vertexCount = chunk->status > 0 ? builder->vertexCount : chunk->count;
+		chunk->vertex = (a3real *)malloc(chunk->vertexCount * 3 * sizeof(a3real));
+		if (chunk->status > 0 && chunk->vertex)
+		{
+			++builder->step;
+			chunk->vertexCount = 0;
+			for (i = 0, face = builder->face; i < builder->faceCount; ++i, ++face)
+				if (face->alive)
+					for (k = 0; k < 3; ++k)
+						if (builder->mark[p = face->v[k]] != builder->step)
+						{
+							builder->mark[p] = builder->step;
+							memcpy(chunk->vertex + chunk->vertexCount++ * 3, chunk->point + p * 3, 3 * sizeof(a3real));
+						}
+		}
+		else if (chunk->status == 0 && chunk->vertex)
+			memcpy(chunk->vertex, chunk->point, chunk->vertexCount * 3 * sizeof(a3real));
+		else
+			chunk->status = -1;
+		a3demo_hullReleaseBuilder(builder);
+	}
+}
+
+// copy a finished build into hull storage
+//	-> returns vertex count, -1 if out of memory
+int a3demo_hullOutput(a3_DemoConvexHull *hull_out, a3_DemoHullBuilder *builder)
+{
+	const a3_DemoHullFace *face;
+	unsigned int i, k, v, w, faceCount = 0, vertexCount = 0;
+	unsigned char *block;
+	a3real *vertex, *plane, d[3], r;
+	unsigned int *corner;
+
+	// number the vertices in the order faces use them
+	++builder->step;
+	for (i = 0, face = builder->face; i < builder->faceCount; ++i, ++face)
+		if (face->alive)
+		{
+			++faceCount;
+			for (k = 0; k < 3; ++k)
+				if (builder->mark[v = face->v[k]] != builder->step)
+				{
+					builder->mark[v] = builder->step;
+					builder->from[v] = vertexCount++;
+				}
+		}
+
+	block = (unsigned char *)malloc(
+		(vertexCount * 3 + faceCount * 4) * sizeof(a3real) + (faceCount * 6 + vertexCount + 1) * sizeof(unsigned int));
+	if (!block)
+		return -1;
+	hull_out->memory = block;
+	hull_out->vertex = vertex = (a3real *)block;
+	hull_out->plane = plane = vertex + vertexCount * 3;
+	hull_out->face = corner = (unsigned int *)(plane + faceCount * 4);
+	hull_out->neighborStart = corner + faceCount * 3;
+	hull_out->neighbor = hull_out->neighborStart + vertexCount + 1;
+	hull_out->vertexCount = vertexCount;
+	hull_out->faceCount = faceCount;
+	hull_out->edgeCount = faceCount * 3 / 2;
+	hull_out->tolerance = builder->tolerance;
+	memset(hull_out->neighborStart, 0, (vertexCount + 1) * sizeof(unsigned int));
+
+	for (i = 0, face = builder->face; i < builder->faceCount; ++i, ++face)
+		if (face->alive)
+		{
+			for (k = 0; k < 3; ++k)
+			{
+				v = builder->from[face->v[k]];
+				memcpy(vertex + v * 3, builder->point + face->v[k] * 3, 3 * sizeof(a3real));
+				*(corner++) = v;
+				++hull_out->neighborStart[v + 1];
+			}
+			memcpy(plane, face->plane, 4 * sizeof(a3real));
+			plane += 4;
+		}
+
+	// every edge is used once each way, so each vertex's outgoing edges
+	//	name each of its neighbors once
+	for (v = 0; v < vertexCount; ++v)
+		hull_out->neighborStart[v + 1] += hull_out->neighborStart[v];
+	for (i = 0, corner = hull_out->face; i < faceCount; ++i, corner += 3)
+		for (k = 0; k < 3; ++k)
+		{
+			v = corner[k];
+			w = corner[(k + 1) % 3];
+			hull_out->neighbor[hull_out->neighborStart[v]++] = w;
+		}
+	for (v = vertexCount; v > 0; --v)
+		hull_out->neighborStart[v] = hull_out->neighborStart[v - 1];
+	hull_out->neighborStart[0] = 0;
+
+	hull_out->center[0] = hull_out->center[1] = hull_out->center[2] = a3realZero;
+	for (v = 0; v < vertexCount; ++v)
+		for (k = 0; k < 3; ++k)
+			hull_out->center[k] += vertex[v * 3 + k];
+	for (k = 0, r = a3recip((a3real)vertexCount); k < 3; ++k)
+		hull_out->center[k] *= r;
+	hull_out->radius = a3realZero;
+	for (v = 0; v < vertexCount; ++v)
+	{
+		d[0] = vertex[v * 3 + 0] - hull_out->center[0];
+		d[1] = vertex[v * 3 + 1] - hull_out->center[1];
+		d[2] = vertex[v * 3 + 2] - hull_out->center[2];
+		hull_out->radius = a3maximum(hull_out->radius, a3demo_hullDot(d, d));
+	}
+	hull_out->radius = (a3real)sqrt(hull_out->radius);
+	return vertexCount;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createConvexHull(a3_DemoConvexHull *hull_out, const a3real *point, const unsigned int count, const unsigned int maxVertices, const a3real tolerance, a3_DemoJobSystem *jobs)
+{
+	if (hull_out && point)
+	{
+		a3_DemoHullBuilder builder[1];
+		a3_DemoHullChunk *chunk = 0;
+		const unsigned int chunkCount = count / a3demo_hullChunkSize;
+		const a3real *cloud = point;
+		a3real *merged = 0, scale[3] = { a3realZero }, autoTolerance;
+		unsigned int i, k, cloudCount = count;
+		int status;
+
+		memset(hull_out, 0, sizeof(a3_DemoConvexHull));
+		hull_out->inputCount = count;
+
+		// a few ulps at the size of the coordinates covers the rounding in
+		//	the plane tests
+		for (i = 0; i < count * 3; i += 3)
+			for (k = 0; k < 3; ++k)
+				scale[k] = a3maximum(scale[k], (a3real)fabs(point[i + k]));
+		autoTolerance = (a3real)(3.0 * FLT_EPSILON) * (scale[0] + scale[1] + scale[2]);
+		autoTolerance = a3maximum(autoTolerance, tolerance);
+
+		// large clouds: hull fixed chunks, in parallel, and keep only their
+		//	vertices; the chunks do not depend on the thread count, so
+		//	neither does the hull
+		if (chunkCount >= 2)
+		{
+			chunk = (a3_DemoHullChunk *)malloc(chunkCount * sizeof(a3_DemoHullChunk));
+			if (!chunk)
+				return -1;
+			for (i = 0; i < chunkCount; ++i)
+			{
+				chunk[i].point = point + i * a3demo_hullChunkSize * 3;
+				chunk[i].count = (i + 1 < chunkCount) ? a3demo_hullChunkSize : count - i * a3demo_hullChunkSize;
+				chunk[i].tolerance = autoTolerance;
+				chunk[i].vertex = 0;
+			}
+			a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_hullChunkJob, chunk, chunkCount, 1);
+
+			for (i = cloudCount = 0, status = 1; i < chunkCount; ++i)
+			{
+				cloudCount += chunk[i].vertexCount;
+				status &= chunk[i].status >= 0;
+			}
+			merged = status ? (a3real *)malloc(cloudCount * 3 * sizeof(a3real)) : 0;
+			for (i = cloudCount = 0; i < chunkCount; ++i)
+			{
+				if (merged)
+					memcpy(merged + cloudCount * 3, chunk[i].vertex, chunk[i].vertexCount * 3 * sizeof(a3real));
+				cloudCount += chunk[i].vertexCount;
+				free(chunk[i].vertex);
+			}
+			free(chunk);
+			if (!merged)
+				return -1;
+			cloud = merged;
+		}
+
+		status = a3demo_hullBuild(builder, cloud, cloudCount, maxVertices, autoTolerance, jobs);
+		if (status > 0)
+		{
+			status = a3demo_hullOutput(hull_out, builder);
+			hull_out->outside = builder->outside;
+		}
+		a3demo_hullReleaseBuilder(builder);
+		free(merged);
+		return status;
+	}
+	return -1;
+}
+
+int a3demo_createConvexHullGeometry(a3_DemoConvexHull *hull_out, const a3_GeometryData *geom, const unsigned int maxVertices, const a3real tolerance, a3_DemoJobSystem *jobs)
+{
+	if (hull_out && geom && geom->attribData[a3attrib_geomPosition])
+	{
+		const float *const position = (const float *)geom->attribData[a3attrib_geomPosition];
+		const unsigned int count = geom->numVertices;
+		a3real *point;
+		unsigned int i;
+		int status;
+
+		// positions are always float; only convert if reals are not
+		if (sizeof(a3real) == sizeof(float))
+			return a3demo_createConvexHull(hull_out, (const a3real *)position, count, maxVertices, tolerance, jobs);
+		point = (a3real *)malloc(count * 3 * sizeof(a3real));
+		if (!point)
+			return -1;
+		for (i = 0; i < count * 3; ++i)
+			point[i] = (a3real)position[i];
+		status = a3demo_createConvexHull(hull_out, point, count, maxVertices, tolerance, jobs);
+		free(point);
+		return status;
+	}
+	return -1;
+}
+
+int a3demo_releaseConvexHull(a3_DemoConvexHull *hull)
+{
+	if (hull)
+	{
+		free(hull->memory);
+		memset(hull, 0, sizeof(a3_DemoConvexHull));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_getConvexHullSupport(a3real *point_out, const a3_DemoConvexHull *hull, const a3real *direction, unsigned int *hint)
+{
+	if (point_out && hull && hull->vertexCount && direction)
+	{
+		const a3real *const vertex = hull->vertex;
+		unsigned int best = (hint && *hint < hull->vertexCount) ? *hint : 0, at, i;
+		a3real bestDot = a3demo_hullDot(vertex + best * 3, direction), d;
+
+		if (hull->vertexCount < a3demo_hullClimbMin)
+		{
+			for (i = 0; i < hull->vertexCount; ++i)
+				if ((d = a3demo_hullDot(vertex + i * 3, direction)) > bestDot)
+				{
+					best = i;
+					bestDot = d;
+				}
+		}
+		else
+		{
+			// a convex hull has no local maxima, so a vertex with no
+			//	neighbor further along is the farthest
+			do
+			{
+				at = best;
+				for (i = hull->neighborStart[at]; i < hull->neighborStart[at + 1]; ++i)
+					if ((d = a3demo_hullDot(vertex + hull->neighbor[i] * 3, direction)) > bestDot)
+					{
+						best = hull->neighbor[i];
+						bestDot = d;
+					}
+			} while (best != at);
+		}
+
+		point_out[0] = vertex[best * 3 + 0];
+		point_out[1] = vertex[best * 3 + 1];
+		point_out[2] = vertex[best * 3 + 2];
+		if (hint)
+			*hint = best;
+		return best;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoConvexHull.h
+	Quickhull over point clouds and geometry data, producing convex
+		collision proxies with the data a support mapping needs.
+*/
+
+#ifndef __ANIMAL3D_DEMOCONVEXHULL_H
+#define __ANIMAL3D_DEMOCONVEXHULL_H
+
+
+#include "animal3D/a3math/A3DM.h"
+#include "animal3D/a3graphics/a3geometry/a3_GeometryData.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoConvexHull	a3_DemoConvexHull;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// hull constants
+	enum a3_DemoConvexHullConstants
+	{
+		a3demo_hullChunkSize = 8192,	// clouds of at least two chunks are hulled
+										//	chunk by chunk first, in parallel
+		a3demo_hullGrain = 4096,		// points per parallel range
+		a3demo_hullClimbMin = 16,		// smaller hulls are searched outright
+	};
+
+
+	// convex hull as a closed triangle mesh wound counterclockwise from
+	//	outside, with the face planes and vertex adjacency for hill climbing
+	//	support queries (GJK, EPA, separating axes)
+	struct a3_DemoConvexHull
+	{
+		a3real *vertex;					// xyz per vertex
+		a3real *plane;					// outward unit normal and offset per face
+		unsigned int *face;				// three vertex indices per face
+		unsigned int *neighborStart;	// per vertex, first entry in neighbor
+										//	(one extra at the end)
+		unsigned int *neighbor;			// vertices sharing an edge with each vertex
+		a3real center[3];				// average of the vertices, inside the hull
+		a3real radius;					// bounding sphere about the center
+		a3real tolerance;				// distance within which points counted as on it
+		a3real outside;					// farthest any input point ended up outside:
+										//	zero-ish unless the vertex count was limited
+		unsigned int vertexCount, faceCount, edgeCount;
+		unsigned int inputCount;		// points it was built from
+		void *memory;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// hull of a cloud of points (xyz each)
+	//	param maxVertices: stop growing once the hull has this many vertices
+	//		(at least 4); each step adds the point farthest out, so the result
+	//		is the usual simplified proxy just inside the full hull, and
+	//		outside says by how much; zero for no limit
+	//	param tolerance: points within this of the hull being built are taken
+	//		as on it, which also merges near duplicates and near-coplanar
+	//		bumps; zero uses a few float ulps at the scale of the cloud
+	//	param jobs: large clouds are first hulled in fixed chunks in
+	//		parallel; null does the same serially with the same result
+	//	-> returns vertex count, 0 if the points are flat or too few to
+	//		enclose anything, -1 if invalid params
+	int a3demo_createConvexHull(a3_DemoConvexHull *hull_out, const a3real *point, const unsigned int count, const unsigned int maxVertices, const a3real tolerance, a3_DemoJobSystem *jobs);
+
+	// hull of the vertex positions of geometry data (indices ignored)
+	int a3demo_createConvexHullGeometry(a3_DemoConvexHull *hull_out, const a3_GeometryData *geom, const unsigned int maxVertices, const a3real tolerance, a3_DemoJobSystem *jobs);
+
+	// free hull storage
+	int a3demo_releaseConvexHull(a3_DemoConvexHull *hull);
+
+	// support mapping in the hull's own frame: the vertex farthest along
+	//	direction, found by climbing the vertex adjacency from a starting
+	//	vertex; pass the same hint every frame and it stays a step or two
+	//	from the answer (null starts from vertex 0)
+	//	-> returns vertex index, -1 if invalid params
+	int a3demo_getConvexHullSupport(a3real *point_out, const a3_DemoConvexHull *hull, const a3real *direction, unsigned int *hint);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOCONVEXHULL_H
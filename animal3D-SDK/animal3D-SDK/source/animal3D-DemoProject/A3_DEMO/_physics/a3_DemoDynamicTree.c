@@ -0,0 +1,685 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoDynamicTree.c
+	Dynamic bounding volume tree maintenance and queries.
+*/
+
+#include "a3_DemoDynamicTree.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// half the surface area of a box, which is what SAH costs compare
+inline a3real a3demo_dynamicTreeArea(const a3real *boundsMin, const a3real *boundsMax)
+{
+	const a3real x = boundsMax[0] - boundsMin[0], y = boundsMax[1] - boundsMin[1], z = boundsMax[2] - boundsMin[2];
+	return x * y + y * z + z * x;
+}
+
+// area of the union of a node's box and another box
+inline a3real a3demo_dynamicTreeUnionArea(const a3_DemoDynamicTreeNode *node, const a3real *boundsMin, const a3real *boundsMax)
+{
+	a3real lo[3], hi[3];
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		lo[i] = a3minimum(node->boundsMin[i], boundsMin[i]);
+		hi[i] = a3maximum(node->boundsMax[i], boundsMax[i]);
+	}
+	return a3demo_dynamicTreeArea(lo, hi);
+}
+
+inline int a3demo_dynamicTreeContains(const a3_DemoDynamicTreeNode *node, const a3real *boundsMin, const a3real *boundsMax)
+{
+	return node->boundsMin[0] <= boundsMin[0] && node->boundsMin[1] <= boundsMin[1] && node->boundsMin[2] <= boundsMin[2] &&
+		node->boundsMax[0] >= boundsMax[0] && node->boundsMax[1] >= boundsMax[1] && node->boundsMax[2] >= boundsMax[2];
+}
+
+inline int a3demo_dynamicTreeOverlaps(const a3_DemoDynamicTreeNode *node, const a3real *boundsMin, const a3real *boundsMax)
+{
+	return node->boundsMin[0] <= boundsMax[0] && node->boundsMin[1] <= boundsMax[1] && node->boundsMin[2] <= boundsMax[2] &&
+		node->boundsMax[0] >= boundsMin[0] && node->boundsMax[1] >= boundsMin[1] && node->boundsMax[2] >= boundsMin[2];
+}
+
+int a3demo_dynamicTreeAllocate(a3_DemoDynamicTree *tree)
+{
+	const int index = tree->freeNode;
+	a3_DemoDynamicTreeNode *const node = tree->node + index;
+	tree->freeNode = node->parent;
+	node->parent = node->child[0] = node->child[1] = -1;
+	node->height = 0;
+	++tree->nodeCount;
+	return index;
+}
+
+void a3demo_dynamicTreeFree(a3_DemoDynamicTree *tree, const int index)
+{
+	tree->node[index].parent = tree->freeNode;
+	tree->node[index].height = (unsigned int)-1;
+	tree->freeNode = index;
+	--tree->nodeCount;
+}
+
+inline void a3demo_dynamicTreeUnion(a3_DemoDynamicTreeNode *node, const a3_DemoDynamicTreeNode *c0, const a3_DemoDynamicTreeNode *c1)
+{
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		node->boundsMin[i] = a3minimum(c0->boundsMin[i], c1->boundsMin[i]);
+		node->boundsMax[i] = a3maximum(c0->boundsMax[i], c1->boundsMax[i]);
+	}
+	node->height = 1 + a3maximum(c0->height, c1->height);
+}
+
+// tree rotation: swap one child of a node with a grandchild under its
+//	other child, if that shrinks the other child's box; of the four
+//	possible swaps the one saving the most area is taken (the node's own
+//	box covers the same leaves either way, so only that child changes)
+void a3demo_dynamicTreeRotate(a3_DemoDynamicTree *tree, const int index)
+{
+	a3_DemoDynamicTreeNode *const node = tree->node, *const a = node + index;
+	a3real area, gain, best = a3realZero;
+	int c, g, x, y, z, w, bestC = -1, bestG = -1;
+
+	for (c = 0; c < 2; ++c)
+	{
+		x = a->child[c];
+		z = a->child[!c];
+		if (node[z].child[0] < 0)
+			continue;
+		area = a3demo_dynamicTreeArea(node[z].boundsMin, node[z].boundsMax);
+		for (g = 0; g < 2; ++g)
+		{
+			w = node[z].child[!g];
+			gain = area - a3demo_dynamicTreeUnionArea(node + x, node[w].boundsMin, node[w].boundsMax);
+			if (gain > best)
+			{
+				best = gain;
+				bestC = c;
+				bestG = g;
+			}
+		}
+	}
+	if (bestC >= 0)
+	{
+		x = a->child[bestC];
+		z = a->child[!bestC];
+		y = node[z].child[bestG];
+		w = node[z].child[!bestG];
+		a->child[bestC] = y;
+		node[y].parent = index;
+		node[z].child[bestG] = x;
+		node[x].parent = z;
+		a3demo_dynamicTreeUnion(node + z, node + x, node + w);
+		a->height = 1 + a3maximum(node[z].height, node[y].height);
+		++tree->rotations;
+	}
+}
+
+// boxes and heights from a node up to the root, rotating on the way
+//	param early: stop once a node comes out the same as it was, as
+//		nothing above it changes; a full walk gives every node on the
+//		way a chance to rotate, which insertions need to stay shallow
+void a3demo_dynamicTreeRefit(a3_DemoDynamicTree *tree, int index, const int early)
+{
+	a3_DemoDynamicTreeNode *node, before;
+	for (; index >= 0; index = node->parent)
+	{
+		node = tree->node + index;
+		before = *node;
+		a3demo_dynamicTreeUnion(node, tree->node + node->child[0], tree->node + node->child[1]);
+		if (tree->rotate)
+			a3demo_dynamicTreeRotate(tree, index);
+		if (early && node->height == before.height &&
+			node->boundsMin[0] == before.boundsMin[0] && node->boundsMin[1] == before.boundsMin[1] && node->boundsMin[2] == before.boundsMin[2] &&
+			node->boundsMax[0] == before.boundsMax[0] && node->boundsMax[1] == before.boundsMax[1] && node->boundsMax[2] == before.boundsMax[2])
+			break;
+	}
+}
+
+// hang a leaf next to the node where it adds the least area to the tree:
+//	going down a level is only worth it while the area the leaf would add
+//	below, plus what every box on the way grows by, beats pairing it here
+void a3demo_dynamicTreeInsertLeaf(a3_DemoDynamicTree *tree, const int leaf)
+{
+	a3_DemoDynamicTreeNode *const node = tree->node, *n;
+	const a3real *const lo = node[leaf].boundsMin, *const hi = node[leaf].boundsMax;
+	a3real area, combined, cost, inherit, childCost[2];
+	int index = tree->root, parent, c;
+
+	if (index < 0)
+	{
+		tree->root = leaf;
+		node[leaf].parent = -1;
+		return;
+	}
+	while (node[index].child[0] >= 0)
+	{
+		n = node + index;
+		area = a3demo_dynamicTreeArea(n->boundsMin, n->boundsMax);
+		combined = a3demo_dynamicTreeUnionArea(n, lo, hi);
+		cost = combined + combined;
+		inherit = (combined - area) * a3realTwo;
+		for (c = 0; c < 2; ++c)
+		{
+			childCost[c] = a3demo_dynamicTreeUnionArea(node + n->child[c], lo, hi) + inherit;
+			if (node[n->child[c]].child[0] >= 0)
+				childCost[c] -= a3demo_dynamicTreeArea(node[n->child[c]].boundsMin, node[n->child[c]].boundsMax);
+		}
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+		index = n->child[childCost[1] < childCost[0]];
+	}
+
+	// new parent of the leaf and the node it ended up next to
+	parent = a3demo_dynamicTreeAllocate(tree);
+	n = node + parent;
+	n->parent = node[index].parent;
+	n->child[0] = index;
+	n->child[1] = leaf;
+	if (n->parent >= 0)
+		node[n->parent].child[node[n->parent].child[1] == index] = parent;
+	else
+		tree->root = parent;
+	node[index].parent = node[leaf].parent = parent;
+	a3demo_dynamicTreeRefit(tree, parent, 0);
+}
+
+// unhook a leaf; its sibling takes its parent's place
+void a3demo_dynamicTreeRemoveLeaf(a3_DemoDynamicTree *tree, const int leaf)
+{
+	a3_DemoDynamicTreeNode *const node = tree->node;
+	const int parent = node[leaf].parent;
+	int sibling, grandparent;
+
+	if (parent < 0)
+	{
+		tree->root = -1;
+		return;
+	}
+	sibling = node[parent].child[node[parent].child[0] == leaf];
+	grandparent = node[parent].parent;
+	node[sibling].parent = grandparent;
+	if (grandparent >= 0)
+	{
+		node[grandparent].child[node[grandparent].child[1] == parent] = sibling;
+		a3demo_dynamicTreeRefit(tree, grandparent, 0);
+	}
+	else
+		tree->root = sibling;
+	a3demo_dynamicTreeFree(tree, parent);
+	node[leaf].parent = -1;
+}
+
+inline void a3demo_dynamicTreeFatten(a3_DemoDynamicTreeNode *node, const a3real *boundsMin, const a3real *boundsMax, const a3real margin)
+{
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		node->boundsMin[i] = boundsMin[i] - margin;
+		node->boundsMax[i] = boundsMax[i] + margin;
+	}
+}
+
+// where a ray enters a node's box; axes the ray runs along are checked
+//	by position so no infinities meet zeros
+//	-> returns distance, FLT_MAX if it misses within the limit
+inline a3real a3demo_dynamicTreeEntry(const a3_DemoDynamicTreeNode *node, const a3real *origin, const a3real *direction, const a3real *invDirection, const a3real limit)
+{
+	a3real t0, t1, entryT = a3realZero, exitT = limit;
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		if (direction[i] != a3realZero)
+		{
+			t0 = (node->boundsMin[i] - origin[i]) * invDirection[i];
+			t1 = (node->boundsMax[i] - origin[i]) * invDirection[i];
+			if (t0 > t1)
+			{
+				const a3real swap = t0;
+				t0 = t1;
+				t1 = swap;
+			}
+			entryT = t0 > entryT ? t0 : entryT;
+			exitT = t1 < exitT ? t1 : exitT;
+		}
+		else if (origin[i] < node->boundsMin[i] || origin[i] > node->boundsMax[i])
+			return FLT_MAX;
+	}
+	return entryT <= exitT ? entryT : FLT_MAX;
+}
+
+
+// how far a point is from a node's box; zero inside
+inline a3real a3demo_dynamicTreeDistance(const a3_DemoDynamicTreeNode *node, const a3real *point)
+{
+	a3real d, sum = a3realZero;
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		d = a3maximum(node->boundsMin[i] - point[i], point[i] - node->boundsMax[i]);
+		if (d > a3realZero)
+			sum += d * d;
+	}
+	return (a3real)sqrt(sum);
+}
+
+// binary heap of nodes by distance, nearest on top, kept in the
+//	traversal workspace
+void a3demo_dynamicTreeHeapPush(a3_DemoDynamicTree *tree, unsigned int count, const int index, const a3real key)
+{
+	int *const heap = tree->stack;
+	a3real *const heapKey = tree->stackEntry;
+	unsigned int up;
+	for (; count; count = up)
+	{
+		up = (count - 1) / 2;
+		if (heapKey[up] <= key)
+			break;
+		heap[count] = heap[up];
+		heapKey[count] = heapKey[up];
+	}
+	heap[count] = index;
+	heapKey[count] = key;
+}
+
+void a3demo_dynamicTreeHeapPop(a3_DemoDynamicTree *tree, const unsigned int count)
+{
+	int *const heap = tree->stack;
+	a3real *const heapKey = tree->stackEntry;
+	const int index = heap[count];
+	const a3real key = heapKey[count];
+	unsigned int i = 0, down;
+	for (down = 1; down < count; i = down, down = i * 2 + 1)
+	{
+		if (down + 1 < count && heapKey[down + 1] < heapKey[down])
+			++down;
+		if (key <= heapKey[down])
+			break;
+		heap[i] = heap[down];
+		heapKey[i] = heapKey[down];
+	}
+	heap[i] = index;
+	heapKey[i] = key;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createDynamicTree(a3_DemoDynamicTree *tree, const unsigned int capacity, const a3real margin)
+{
+	if (tree && capacity && margin >= a3realZero)
+	{
+		const unsigned int nodes = capacity * 2 - 1;
+		memset(tree, 0, sizeof(a3_DemoDynamicTree));
+		tree->memory = malloc(nodes * (sizeof(a3_DemoDynamicTreeNode) + sizeof(int) + sizeof(a3real)) + capacity * sizeof(int));
+		if (!tree->memory)
+			return -1;
+		tree->node = (a3_DemoDynamicTreeNode *)tree->memory;
+		tree->stackEntry = (a3real *)(tree->node + nodes);
+		tree->stack = (int *)(tree->stackEntry + nodes);
+		tree->leaf = tree->stack + nodes;
+		tree->capacity = capacity;
+		tree->margin = margin;
+		tree->rotate = 1;
+		return a3demo_clearDynamicTree(tree);
+	}
+	return -1;
+}
+
+int a3demo_releaseDynamicTree(a3_DemoDynamicTree *tree)
+{
+	if (tree)
+	{
+		free(tree->memory);
+		memset(tree, 0, sizeof(a3_DemoDynamicTree));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_clearDynamicTree(a3_DemoDynamicTree *tree)
+{
+	if (tree && tree->memory)
+	{
+		const unsigned int nodes = tree->capacity * 2 - 1;
+		unsigned int i;
+		for (i = 0; i < nodes; ++i)
+		{
+			tree->node[i].parent = (int)i + 1;
+			tree->node[i].height = (unsigned int)-1;
+		}
+		tree->node[nodes - 1].parent = -1;
+		for (i = 0; i < tree->capacity; ++i)
+			tree->leaf[i] = -1;
+		tree->root = -1;
+		tree->freeNode = 0;
+		tree->count = tree->nodeCount = 0;
+		tree->reinserts = tree->refits = tree->rotations = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_insertDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object, const a3real *boundsMin, const a3real *boundsMax)
+{
+	if (tree && tree->memory && object < tree->capacity && boundsMin && boundsMax)
+	{
+		int leaf;
+		if (tree->leaf[object] >= 0)
+			return 0;
+		leaf = a3demo_dynamicTreeAllocate(tree);
+		a3demo_dynamicTreeFatten(tree->node + leaf, boundsMin, boundsMax, tree->margin);
+		tree->node[leaf].object = object;
+		a3demo_dynamicTreeInsertLeaf(tree, leaf);
+		tree->leaf[object] = leaf;
+		++tree->count;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_removeDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object)
+{
+	if (tree && tree->memory && object < tree->capacity)
+	{
+		const int leaf = tree->leaf[object];
+		if (leaf < 0)
+			return 0;
+		a3demo_dynamicTreeRemoveLeaf(tree, leaf);
+		a3demo_dynamicTreeFree(tree, leaf);
+		tree->leaf[object] = -1;
+		--tree->count;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_moveDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object, const a3real *boundsMin, const a3real *boundsMax)
+{
+	if (tree && tree->memory && object < tree->capacity && boundsMin && boundsMax)
+	{
+		const int leaf = tree->leaf[object];
+		a3_DemoDynamicTreeNode *n;
+		if (leaf < 0)
+			return a3demo_insertDynamicTreeObject(tree, object, boundsMin, boundsMax);
+		n = tree->node + leaf;
+		if (a3demo_dynamicTreeContains(n, boundsMin, boundsMax))
+			return 0;
+
+		// still overlapping where it was: the leaf keeps its place and
+		//	the boxes above it are refit (and rotated); further than that
+		//	it goes back in from the top
+		if (a3demo_dynamicTreeOverlaps(n, boundsMin, boundsMax))
+		{
+			a3demo_dynamicTreeFatten(n, boundsMin, boundsMax, tree->margin);
+			a3demo_dynamicTreeRefit(tree, n->parent, 1);
+			++tree->refits;
+		}
+		else
+		{
+			a3demo_dynamicTreeRemoveLeaf(tree, leaf);
+			a3demo_dynamicTreeFatten(n, boundsMin, boundsMax, tree->margin);
+			a3demo_dynamicTreeInsertLeaf(tree, leaf);
+			++tree->reinserts;
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_raycastDynamicTree(unsigned int *object_out, a3real *distance_inout, a3_DemoDynamicTree *tree, const a3real *origin, const a3real *direction, a3_DemoDynamicTreeRayFunc test, void *user)
+{
+	if (object_out && distance_inout && tree && tree->memory && origin && direction)
+	{
+		const a3_DemoDynamicTreeNode *const node = tree->node, *n;
+		int *const stack = tree->stack;
+		a3real *const stackEntry = tree->stackEntry;
+		a3real invDirection[3], limit = *distance_inout, left, right, t;
+		unsigned int top = 0, i;
+		int index = tree->root, hit = 0;
+
+		if (index < 0)
+			return 0;
+		for (i = 0; i < 3; ++i)
+			invDirection[i] = direction[i] != a3realZero ? a3recip(direction[i]) : a3realZero;
+		if (a3demo_dynamicTreeEntry(node + index, origin, direction, invDirection, limit) == FLT_MAX)
+			return 0;
+		for (;;)
+		{
+			n = node + index;
+			if (n->child[0] < 0)
+			{
+				t = test ? test(user, n->object, origin, direction, limit) : a3demo_dynamicTreeEntry(n, origin, direction, invDirection, limit);
+				if (t < limit)
+				{
+					limit = t;
+					*object_out = n->object;
+					hit = 1;
+				}
+			}
+			else
+			{
+				// nearer child next, the other one waits with its entry
+				left = a3demo_dynamicTreeEntry(node + n->child[0], origin, direction, invDirection, limit);
+				right = a3demo_dynamicTreeEntry(node + n->child[1], origin, direction, invDirection, limit);
+				if (left <= right && left != FLT_MAX)
+				{
+					if (right != FLT_MAX)
+					{
+						stack[top] = n->child[1];
+						stackEntry[top++] = right;
+					}
+					index = n->child[0];
+					continue;
+				}
+				else if (right != FLT_MAX)
+				{
+					if (left != FLT_MAX)
+					{
+						stack[top] = n->child[0];
+						stackEntry[top++] = left;
+					}
+					index = n->child[1];
+					continue;
+				}
+			}
+
+			// next waiting node still in reach
+			while (top && stackEntry[top - 1] >= limit)
+				--top;
+			if (!top)
+				break;
+			index = stack[--top];
+		}
+		if (hit)
+			*distance_inout = limit;
+		return hit;
+	}
+	return -1;
+}
+
+
+int a3demo_queryDynamicTreeOverlap(unsigned int *objects_out, const unsigned int maxCount, a3_DemoDynamicTree *tree, const a3real *boundsMin, const a3real *boundsMax)
+{
+	if ((objects_out || !maxCount) && tree && tree->memory && boundsMin && boundsMax)
+	{
+		const a3_DemoDynamicTreeNode *const node = tree->node, *n;
+		int *const stack = tree->stack;
+		unsigned int top = 0;
+		int found = 0;
+
+		if (tree->root >= 0)
+			stack[top++] = tree->root;
+		while (top)
+		{
+			n = node + stack[--top];
+			if (!a3demo_dynamicTreeOverlaps(n, boundsMin, boundsMax))
+				continue;
+			if (n->child[0] < 0)
+			{
+				if ((unsigned int)found < maxCount)
+					objects_out[found] = n->object;
+				++found;
+			}
+			else
+			{
+				stack[top++] = n->child[1];
+				stack[top++] = n->child[0];
+			}
+		}
+		return found;
+	}
+	return -1;
+}
+
+int a3demo_queryDynamicTreePlanes(unsigned int *objects_out, const unsigned int maxCount, a3_DemoDynamicTree *tree, const a3real *planes, const unsigned int planeCount)
+{
+	if ((objects_out || !maxCount) && tree && tree->memory && planes && planeCount <= a3demo_dynamicTreeMaxPlanes)
+	{
+		const a3_DemoDynamicTreeNode *const node = tree->node, *n;
+		int *const stack = tree->stack;
+		const a3real *plane;
+		a3real far, near;
+		unsigned int top = 0, p, mask;
+		int found = 0, out;
+
+		// each waiting node carries the planes it still has to be tested
+		//	against; a box wholly in front of a plane passes it on to its
+		//	children already passed, so subtrees inside the frustum are
+		//	taken without any more tests
+		if (tree->root >= 0)
+			stack[top++] = tree->root << a3demo_dynamicTreeMaxPlanes | ((1 << planeCount) - 1);
+		while (top)
+		{
+			n = node + (stack[--top] >> a3demo_dynamicTreeMaxPlanes);
+			mask = stack[top] & ((1 << a3demo_dynamicTreeMaxPlanes) - 1);
+			for (p = 0, out = 0; p < planeCount && !out; ++p)
+				if (mask & (1 << p))
+				{
+					plane = planes + p * 4;
+					far = plane[3] +
+						plane[0] * (plane[0] >= a3realZero ? n->boundsMax[0] : n->boundsMin[0]) +
+						plane[1] * (plane[1] >= a3realZero ? n->boundsMax[1] : n->boundsMin[1]) +
+						plane[2] * (plane[2] >= a3realZero ? n->boundsMax[2] : n->boundsMin[2]);
+					near = plane[3] +
+						plane[0] * (plane[0] >= a3realZero ? n->boundsMin[0] : n->boundsMax[0]) +
+						plane[1] * (plane[1] >= a3realZero ? n->boundsMin[1] : n->boundsMax[1]) +
+						plane[2] * (plane[2] >= a3realZero ? n->boundsMin[2] : n->boundsMax[2]);
+					if (far < a3realZero)
+						out = 1;
+					else if (near >= a3realZero)
+						mask &= ~(1u << p);
+				}
+			if (out)
+				continue;
+			if (n->child[0] < 0)
+			{
+				if ((unsigned int)found < maxCount)
+					objects_out[found] = n->object;
+				++found;
+			}
+			else
+			{
+				stack[top++] = n->child[1] << a3demo_dynamicTreeMaxPlanes | mask;
+				stack[top++] = n->child[0] << a3demo_dynamicTreeMaxPlanes | mask;
+			}
+		}
+		return found;
+	}
+	return -1;
+}
+
+int a3demo_queryDynamicTreeNearest(unsigned int *objects_out, a3real *distances_out, const unsigned int k, a3_DemoDynamicTree *tree, const a3real *point, const a3real maxDistance, a3_DemoDynamicTreeDistanceFunc distance, void *user)
+{
+	if (objects_out && distances_out && k && tree && tree->memory && point)
+	{
+		const a3_DemoDynamicTreeNode *const node = tree->node, *n;
+		a3real bound = maxDistance, key, d;
+		unsigned int heapCount = 0, found = 0, i, c;
+
+		// best first: the nearest waiting box is opened next, and the
+		//	search ends when it is further than the k-th object found
+		if (tree->root >= 0 && (key = a3demo_dynamicTreeDistance(node + tree->root, point)) <= bound)
+			a3demo_dynamicTreeHeapPush(tree, heapCount++, tree->root, key);
+		while (heapCount && (key = tree->stackEntry[0]) <= bound)
+		{
+			n = node + tree->stack[0];
+			a3demo_dynamicTreeHeapPop(tree, --heapCount);
+			if (n->child[0] < 0)
+			{
+				d = distance ? distance(user, n->object, point) : key;
+				if (d > bound || (found == k && d >= bound))
+					continue;
+
+				// insert in order, dropping the furthest if full
+				if (found < k)
+					++found;
+				for (i = found - 1; i && distances_out[i - 1] > d; --i)
+				{
+					objects_out[i] = objects_out[i - 1];
+					distances_out[i] = distances_out[i - 1];
+				}
+				objects_out[i] = n->object;
+				distances_out[i] = d;
+				if (found == k)
+					bound = distances_out[k - 1];
+			}
+			else for (c = 0; c < 2; ++c)
+			{
+				key = a3demo_dynamicTreeDistance(node + n->child[c], point);
+				if (key <= bound)
+					a3demo_dynamicTreeHeapPush(tree, heapCount++, n->child[c], key);
+			}
+		}
+		return found;
+	}
+	return -1;
+}
+
+a3real a3demo_getDynamicTreeCost(const a3_DemoDynamicTree *tree)
+{
+	if (tree && tree->memory && tree->root >= 0)
+	{
+		const a3_DemoDynamicTreeNode *const node = tree->node, *n;
+		const unsigned int nodes = tree->capacity * 2 - 1;
+		const a3real rootArea = a3demo_dynamicTreeArea(node[tree->root].boundsMin, node[tree->root].boundsMax);
+		a3real sum = a3realZero;
+		unsigned int i;
+		for (i = 0; i < nodes; ++i)
+		{
+			n = node + i;
+			if (n->height != (unsigned int)-1 && n->child[0] >= 0)
+				sum += a3demo_dynamicTreeArea(n->boundsMin, n->boundsMax);
+		}
+		return rootArea > a3realZero ? sum / rootArea : a3realZero;
+	}
+	return a3realZero;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoDynamicTree.h
+	Bounding volume tree over boxes that come, go and move: objects are
+		inserted and removed one at a time, and one that moved is only
+		touched when it leaves the fattened box the tree holds; boxes on
+		the way up are refit and rotated to keep the tree shallow. Rays,
+		boxes, frustum planes and nearest neighbors can be queried.
+*/
+
+#ifndef __ANIMAL3D_DEMODYNAMICTREE_H
+#define __ANIMAL3D_DEMODYNAMICTREE_H
+
+
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoDynamicTreeNode	a3_DemoDynamicTreeNode;
+	typedef struct a3_DemoDynamicTree		a3_DemoDynamicTree;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// most planes a plane query takes
+	enum a3_DemoDynamicTreeLimits
+	{
+		a3demo_dynamicTreeMaxPlanes = 8,
+	};
+
+
+	// node of the tree; a leaf holds one object's fattened box, an inner
+	//	node the union of its children's
+	struct a3_DemoDynamicTreeNode
+	{
+		a3real boundsMin[3], boundsMax[3];
+		int parent;						// -1 at the root; next free node while unused
+		int child[2];					// both -1 at a leaf
+		unsigned int object;			// leaf: object index
+		unsigned int height;			// leaf: zero
+	};
+
+	// tree over up to a fixed number of objects, each known by its index
+	//	(a body or scene object); nodes come from one pool and are
+	//	recycled through a free list, so nothing is allocated after create
+	struct a3_DemoDynamicTree
+	{
+		a3_DemoDynamicTreeNode *node;	// pool of 2 capacity - 1
+		int *leaf;						// leaf node per object, -1 if not in the tree
+		int *stack;						// traversal workspace, one slot per node
+		a3real *stackEntry;				// ...and how far along a ray each one starts
+		void *memory;
+		int root, freeNode;
+		unsigned int capacity, count;	// objects
+		unsigned int nodeCount;
+		a3real margin;					// leaf boxes are fattened by this on every side
+		unsigned int rotate;			// rotate subtrees while refitting; on after create
+		unsigned int reinserts;			// objects put back in from the top since clear
+		unsigned int refits;			// ...moved only a little and refit in place
+		unsigned int rotations;			// subtrees swapped to make boxes smaller
+	};
+
+	// exact ray test for one object, for the shape inside its box
+	//	-> returns distance along the ray to the hit, or anything not less
+	//		than maxDistance for a miss
+	typedef a3real(*a3_DemoDynamicTreeRayFunc)(void *user, const unsigned int object, const a3real *origin, const a3real *direction, const a3real maxDistance);
+
+	// exact distance from a point to one object; may not be less than the
+	//	distance to its box
+	typedef a3real(*a3_DemoDynamicTreeDistanceFunc)(void *user, const unsigned int object, const a3real *point);
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown for object indices below the capacity
+	int a3demo_createDynamicTree(a3_DemoDynamicTree *tree, const unsigned int capacity, const a3real margin);
+	int a3demo_releaseDynamicTree(a3_DemoDynamicTree *tree);
+
+	// remove every object
+	int a3demo_clearDynamicTree(a3_DemoDynamicTree *tree);
+
+	// add an object by its (tight) box
+	//	-> returns 1, 0 if it is already in, -1 if invalid params
+	int a3demo_insertDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object, const a3real *boundsMin, const a3real *boundsMax);
+
+	// take an object out
+	//	-> returns 1, 0 if it was not in, -1 if invalid params
+	int a3demo_removeDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object);
+
+	// tell the tree where an object's box is now; inserts it if absent
+	// an object that left its fattened box but still overlaps it keeps
+	//	its leaf and the path above is refit, otherwise it is put back in
+	//	from the top; either way the tree only changes along the paths of
+	//	objects that moved
+	//	-> returns 1 if its leaf changed, 0 if its fattened box still holds
+	//		it, -1 if invalid params
+	int a3demo_moveDynamicTreeObject(a3_DemoDynamicTree *tree, const unsigned int object, const a3real *boundsMin, const a3real *boundsMax);
+
+	// nearest object along a ray, nearer boxes first; boxes that start
+	//	past the nearest hit so far are skipped
+	//	param distance_inout: in, how far to look (units of the direction's
+	//		length); out, distance to the hit
+	//	param test: exact test for objects whose box the ray enters; null
+	//		takes the boxes themselves
+	//	-> returns 1 if hit, 0 if not, -1 if invalid params
+	int a3demo_raycastDynamicTree(unsigned int *object_out, a3real *distance_inout, a3_DemoDynamicTree *tree, const a3real *origin, const a3real *direction, a3_DemoDynamicTreeRayFunc test, void *user);
+
+	// objects whose fattened boxes overlap a box; the caller tests the
+	//	shapes themselves
+	//	param objects_out: the first maxCount found
+	//	-> returns how many overlap (may be more than maxCount), -1 if
+	//		invalid params
+	int a3demo_queryDynamicTreeOverlap(unsigned int *objects_out, const unsigned int maxCount, a3_DemoDynamicTree *tree, const a3real *boundsMin, const a3real *boundsMax);
+
+	// objects whose fattened boxes are not wholly behind any of a set of
+	//	planes (a frustum, for culling)
+	//	param planes: xyzw each, inside where xyz dot point + w >= 0
+	//	param planeCount: at most a3demo_dynamicTreeMaxPlanes
+	//	-> returns how many pass (may be more than maxCount), -1 if
+	//		invalid params
+	int a3demo_queryDynamicTreePlanes(unsigned int *objects_out, const unsigned int maxCount, a3_DemoDynamicTree *tree, const a3real *planes, const unsigned int planeCount);
+
+	// the k objects nearest a point within maxDistance, nearest first
+	//	param distance: exact distance to an object; null takes the
+	//		distance to its fattened box
+	//	-> returns how many were found (up to k), -1 if invalid params
+	int a3demo_queryDynamicTreeNearest(unsigned int *objects_out, a3real *distances_out, const unsigned int k, a3_DemoDynamicTree *tree, const a3real *point, const a3real maxDistance, a3_DemoDynamicTreeDistanceFunc distance, void *user);
+
+	// surface area heuristic cost: the area of every inner box over the
+	//	root's; lower is a better tree for the same objects
+	a3real a3demo_getDynamicTreeCost(const a3_DemoDynamicTree *tree);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMODYNAMICTREE_H
@@ -0,0 +1,828 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGJK.c
+	Support mappings, GJK and EPA.
+*/
+
+#include "a3_DemoGJK.h"
+
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// GJK stops once a new support point brings the distance squared down by
+//	less than this fraction; the origin counts as touched when the
+//	distance squared is this small a fraction of the simplex's size
+static const a3real a3demo_gjkTolerance = 1.0e-5f;
+static const a3real a3demo_gjkTouch = 1.0e-10f;
+
+// EPA stops once the closest face is within this of the true surface
+static const a3real a3demo_epaTolerance = 1.0e-4f;
+
+
+// point of the Minkowski difference a - b, the support points on a and
+//	b it came from and the direction that found it
+typedef struct a3_DemoGJKVertex
+{
+	a3real w[3], a[3], b[3], d[3];
+} a3_DemoGJKVertex;
+
+// simplex and the barycentric weights of its point closest to the origin
+typedef struct a3_DemoGJKSimplex
+{
+	a3_DemoGJKVertex vertex[4];
+	a3real weight[4];
+	unsigned int count;
+} a3_DemoGJKSimplex;
+
+// pair being queried; the cores are the shapes without their rounding
+typedef struct a3_DemoGJKPair
+{
+	const a3_DemoCollider *colliderA, *colliderB;
+	const a3_DemoColliderPose *poseA, *poseB;
+	a3real marginA, marginB;
+	unsigned int hintA, hintB;
+} a3_DemoGJKPair;
+
+// face of the expanding polytope, wound counterclockwise from outside
+typedef struct a3_DemoEPAFace
+{
+	unsigned int v[3];
+	a3real normal[3], distance;
+	int alive;
+} a3_DemoEPAFace;
+
+typedef struct a3_DemoEPAPolytope
+{
+	a3_DemoGJKVertex vertex[a3demo_epaMaxVertices];
+	a3_DemoEPAFace face[a3demo_epaMaxFaces];
+	unsigned int edge[a3demo_epaMaxFaces][2];
+	unsigned char visible[a3demo_epaMaxFaces];
+	unsigned int vertexCount, faceCount;
+} a3_DemoEPAPolytope;
+
+
+inline a3real a3demo_gjkDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_gjkCross(a3real *out, const a3real *a, const a3real *b)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline void a3demo_gjkDiff(a3real *out, const a3real *a, const a3real *b)
+{
+	out[0] = a[0] - b[0];
+	out[1] = a[1] - b[1];
+	out[2] = a[2] - b[2];
+}
+
+inline void a3demo_gjkMulAdd(a3real *out, const a3real *a, const a3real *b, const a3real s)
+{
+	out[0] = a[0] + b[0] * s;
+	out[1] = a[1] + b[1] * s;
+	out[2] = a[2] + b[2] * s;
+}
+
+// spheres and capsules are a point or segment plus this
+inline a3real a3demo_gjkMargin(const a3_DemoCollider *collider)
+{
+	return (collider->type == a3demo_collider_sphere || collider->type == a3demo_collider_capsule) ? collider->radius : a3realZero;
+}
+
+// support of a shape without its margin, along a world direction
+void a3demo_gjkCoreSupport(a3real *point_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *direction, unsigned int *hint)
+{
+	a3real center[3], axis[3], radial[3], rim[3], local[3], along, length;
+	unsigned int i;
+
+	a3demo_getColliderWorldFrame(collider, pose, center, axis);
+	along = a3demo_gjkDot(direction, axis);
+	switch (collider->type)
+	{
+	case a3demo_collider_capsule:
+		a3demo_gjkMulAdd(point_out, center, axis, along >= a3realZero ? collider->halfLength : -collider->halfLength);
+		break;
+	case a3demo_collider_box:
+		memcpy(point_out, pose->position, sizeof(a3real3));
+		for (i = 0; i < 3; ++i)
+			a3demo_gjkMulAdd(point_out, point_out, pose->rotation[i],
+				a3demo_gjkDot(direction, pose->rotation[i]) >= a3realZero ? collider->halfExtent[i] : -collider->halfExtent[i]);
+		break;
+	case a3demo_collider_cylinder:
+	case a3demo_collider_cone:
+		// farthest point of the base rim; cones compare it with the apex
+		a3demo_gjkMulAdd(radial, direction, axis, -along);
+		length = (a3real)sqrt(a3demo_gjkDot(radial, radial));
+		if (collider->type == a3demo_collider_cylinder)
+			a3demo_gjkMulAdd(rim, center, axis, along >= a3realZero ? collider->halfLength : -collider->halfLength);
+		else
+			a3demo_gjkMulAdd(rim, center, axis, -collider->halfLength);
+		if (length > a3realZero)
+			a3demo_gjkMulAdd(rim, rim, radial, collider->radius / length);
+		if (collider->type == a3demo_collider_cone)
+		{
+			a3demo_gjkMulAdd(point_out, center, axis, collider->halfLength);
+			if (a3demo_gjkDot(direction, point_out) >= a3demo_gjkDot(direction, rim))
+				break;
+		}
+		memcpy(point_out, rim, sizeof(a3real3));
+		break;
+	case a3demo_collider_hull:
+		for (i = 0; i < 3; ++i)
+			local[i] = a3demo_gjkDot(direction, pose->rotation[i]);
+		a3demo_getConvexHullSupport(radial, collider->hull, local, hint);
+		memcpy(point_out, pose->position, sizeof(a3real3));
+		for (i = 0; i < 3; ++i)
+			a3demo_gjkMulAdd(point_out, point_out, pose->rotation[i], radial[i]);
+		break;
+	default:
+		memcpy(point_out, center, sizeof(a3real3));
+		break;
+	}
+}
+
+// support point of a - b along a direction
+inline void a3demo_gjkSupport(a3_DemoGJKVertex *vertex_out, a3_DemoGJKPair *pair, const a3real *direction)
+{
+	const a3real opposite[3] = { -direction[0], -direction[1], -direction[2] };
+	a3demo_gjkCoreSupport(vertex_out->a, pair->colliderA, pair->poseA, direction, &pair->hintA);
+	a3demo_gjkCoreSupport(vertex_out->b, pair->colliderB, pair->poseB, opposite, &pair->hintB);
+	a3demo_gjkDiff(vertex_out->w, vertex_out->a, vertex_out->b);
+	memcpy(vertex_out->d, direction, sizeof(a3real3));
+}
+
+// closest point to the origin on segment (i, j) of a simplex, keeping
+//	only the vertices it depends on
+void a3demo_gjkSegment(a3_DemoGJKSimplex *out, const a3_DemoGJKSimplex *in, const unsigned int i, const unsigned int j)
+{
+	const a3real *a = in->vertex[i].w, *b = in->vertex[j].w;
+	a3real ab[3], denom, t;
+	a3demo_gjkDiff(ab, b, a);
+	denom = a3demo_gjkDot(ab, ab);
+	t = denom > a3realZero ? -a3demo_gjkDot(a, ab) / denom : a3realZero;
+	if (t <= a3realZero || t >= a3realOne)
+	{
+		out->vertex[0] = in->vertex[t <= a3realZero ? i : j];
+		out->weight[0] = a3realOne;
+		out->count = 1;
+	}
+	else
+	{
+		out->vertex[0] = in->vertex[i];
+		out->vertex[1] = in->vertex[j];
+		out->weight[0] = a3realOne - t;
+		out->weight[1] = t;
+		out->count = 2;
+	}
+}
+
+// same for triangle (i, j, k), by its Voronoi regions
+void a3demo_gjkTriangle(a3_DemoGJKSimplex *out, const a3_DemoGJKSimplex *in, const unsigned int i, const unsigned int j, const unsigned int k)
+{
+	const a3real *a = in->vertex[i].w, *b = in->vertex[j].w, *c = in->vertex[k].w;
+	a3real ab[3], ac[3], d1, d2, d3, d4, d5, d6, va, vb, vc, denom;
+	a3_DemoGJKSimplex edge[1];
+
+	a3demo_gjkDiff(ab, b, a);
+	a3demo_gjkDiff(ac, c, a);
+	d1 = -a3demo_gjkDot(ab, a);
+	d2 = -a3demo_gjkDot(ac, a);
+	d3 = -a3demo_gjkDot(ab, b);
+	d4 = -a3demo_gjkDot(ac, b);
+	d5 = -a3demo_gjkDot(ab, c);
+	d6 = -a3demo_gjkDot(ac, c);
+	vc = d1 * d4 - d3 * d2;
+	vb = d5 * d2 - d1 * d6;
+	va = d3 * d6 - d5 * d4;
+
+	if (d1 <= a3realZero && d2 <= a3realZero)
+	{
+		out->vertex[0] = in->vertex[i];
+		out->weight[0] = a3realOne;
+		out->count = 1;
+	}
+	else if (d3 >= a3realZero && d4 <= d3)
+	{
+		out->vertex[0] = in->vertex[j];
+		out->weight[0] = a3realOne;
+		out->count = 1;
+	}
+	else if (d6 >= a3realZero && d5 <= d6)
+	{
+		out->vertex[0] = in->vertex[k];
+		out->weight[0] = a3realOne;
+		out->count = 1;
+	}
+	else if (vc <= a3realZero && d1 >= a3realZero && d3 <= a3realZero)
+		a3demo_gjkSegment(out, in, i, j);
+	else if (vb <= a3realZero && d2 >= a3realZero && d6 <= a3realZero)
+		a3demo_gjkSegment(out, in, i, k);
+	else if (va <= a3realZero && d4 >= d3 && d5 >= d6)
+		a3demo_gjkSegment(out, in, j, k);
+	else if ((denom = va + vb + vc) > a3realZero)
+	{
+		out->vertex[0] = in->vertex[i];
+		out->vertex[1] = in->vertex[j];
+		out->vertex[2] = in->vertex[k];
+		out->weight[1] = vb / denom;
+		out->weight[2] = vc / denom;
+		out->weight[0] = a3realOne - out->weight[1] - out->weight[2];
+		out->count = 3;
+	}
+	else
+	{
+		// flat: the best of its edges
+		a3demo_gjkSegment(out, in, i, j);
+		a3demo_gjkSegment(edge, in, j, k);
+		if (edge->count < out->count)
+			*out = *edge;
+		a3demo_gjkSegment(edge, in, i, k);
+		if (edge->count < out->count)
+			*out = *edge;
+	}
+}
+
+// point of a simplex for its weights
+inline void a3demo_gjkPoint(a3real *v_out, const a3_DemoGJKSimplex *simplex)
+{
+	unsigned int i;
+	v_out[0] = v_out[1] = v_out[2] = a3realZero;
+	for (i = 0; i < simplex->count; ++i)
+		a3demo_gjkMulAdd(v_out, v_out, simplex->vertex[i].w, simplex->weight[i]);
+}
+
+// closest point to the origin on the simplex, which shrinks to the
+//	vertices it depends on
+//	-> returns 1 if the origin is inside (the simplex stays a tetrahedron)
+int a3demo_gjkClosest(a3_DemoGJKSimplex *simplex, a3real *v_out)
+{
+	static const unsigned int face[4][4] = { { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+	a3_DemoGJKSimplex in[1], best[1], candidate[1];
+	a3real ab[3], ac[3], ad[3], n[3], v[3], sideOrigin, sideOther, volume, dist, bestDist = FLT_MAX;
+	unsigned int f, outside = 0;
+	const a3real *a;
+
+	*in = *simplex;
+	switch (simplex->count)
+	{
+	case 1:
+		simplex->weight[0] = a3realOne;
+		break;
+	case 2:
+		a3demo_gjkSegment(simplex, in, 0, 1);
+		break;
+	case 3:
+		a3demo_gjkTriangle(simplex, in, 0, 1, 2);
+		break;
+	case 4:
+		// faces the origin is beyond, told apart by the opposite vertex;
+		//	a flat tetrahedron has no inside, so all faces are tried
+		a3demo_gjkDiff(ab, in->vertex[1].w, in->vertex[0].w);
+		a3demo_gjkDiff(ac, in->vertex[2].w, in->vertex[0].w);
+		a3demo_gjkDiff(ad, in->vertex[3].w, in->vertex[0].w);
+		a3demo_gjkCross(n, ab, ac);
+		volume = a3demo_gjkDot(n, ad);
+		dist = a3demo_gjkDot(ab, ab) + a3demo_gjkDot(ac, ac) + a3demo_gjkDot(ad, ad);
+		for (f = 0; f < 4; ++f)
+		{
+			a = in->vertex[face[f][0]].w;
+			a3demo_gjkDiff(ab, in->vertex[face[f][1]].w, a);
+			a3demo_gjkDiff(ac, in->vertex[face[f][2]].w, a);
+			a3demo_gjkDiff(ad, in->vertex[face[f][3]].w, a);
+			a3demo_gjkCross(n, ab, ac);
+			sideOrigin = -a3demo_gjkDot(n, a);
+			sideOther = a3demo_gjkDot(n, ad);
+			if (sideOrigin * sideOther < a3realZero || volume * volume <= 1.0e-12f * dist * dist * dist)
+			{
+				++outside;
+				a3demo_gjkTriangle(candidate, in, face[f][0], face[f][1], face[f][2]);
+				a3demo_gjkPoint(v, candidate);
+				if ((dist = a3demo_gjkDot(v, v)) < bestDist)
+				{
+					bestDist = dist;
+					*best = *candidate;
+				}
+			}
+		}
+		if (!outside)
+		{
+			simplex->weight[0] = simplex->weight[1] = simplex->weight[2] = simplex->weight[3] = 0.25f;
+			v_out[0] = v_out[1] = v_out[2] = a3realZero;
+			return 1;
+		}
+		*simplex = *best;
+		break;
+	}
+	a3demo_gjkPoint(v_out, simplex);
+	return 0;
+}
+
+// the pair as the queries see it
+inline void a3demo_gjkSetPair(a3_DemoGJKPair *pair, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, const a3_DemoGJKCache *cache)
+{
+	pair->colliderA = colliderA;
+	pair->colliderB = colliderB;
+	pair->poseA = poseA;
+	pair->poseB = poseB;
+	pair->marginA = a3demo_gjkMargin(colliderA);
+	pair->marginB = a3demo_gjkMargin(colliderB);
+	pair->hintA = cache ? cache->hintA : 0;
+	pair->hintB = cache ? cache->hintB : 0;
+}
+
+// whether a pair can be queried at all
+inline int a3demo_gjkConvex(const a3_DemoCollider *collider)
+{
+	return collider->type > a3demo_collider_none && collider->type < a3demo_collider_plane &&
+		(collider->type != a3demo_collider_hull || (collider->hull && collider->hull->vertexCount));
+}
+
+// GJK on the cores: the simplex ends up holding the closest features
+//	-> returns 1 if the cores are apart (v_out is the point of a - b
+//		closest to the origin), 0 if they touch or overlap
+int a3demo_gjkRun(a3_DemoGJKSimplex *simplex, a3real *v_out, unsigned int *iterations_out, a3_DemoGJKPair *pair, a3_DemoGJKCache *cache)
+{
+	const a3real *rotation;
+	a3_DemoGJKVertex w[1];
+	a3real d[3], diff[3], vv, vw, size, previous = FLT_MAX;
+	unsigned int i, k;
+	int apart = 1;
+
+	// last frame's simplex, its directions turned with a; points that
+	//	came out the same as others are skipped
+	simplex->count = 0;
+	if (cache)
+		for (i = 0; i < cache->count && i < 4; ++i)
+		{
+			d[0] = d[1] = d[2] = a3realZero;
+			for (k = 0; k < 3; ++k)
+				a3demo_gjkMulAdd(d, d, pair->poseA->rotation[k], cache->direction[i][k]);
+			a3demo_gjkSupport(w, pair, d);
+			for (k = 0; k < simplex->count; ++k)
+			{
+				a3demo_gjkDiff(diff, w->w, simplex->vertex[k].w);
+				if (a3demo_gjkDot(diff, diff) <= a3realEpsilon * a3realEpsilon)
+					break;
+			}
+			if (k == simplex->count)
+				simplex->vertex[simplex->count++] = *w;
+		}
+	if (!simplex->count)
+	{
+		a3demo_gjkDiff(d, pair->poseB->position, pair->poseA->position);
+		if (a3demo_gjkDot(d, d) <= a3realZero)
+			d[0] = a3realOne;
+		a3demo_gjkSupport(simplex->vertex, pair, d);
+		simplex->count = 1;
+	}
+
+	for (*iterations_out = 0; ; ++*iterations_out)
+	{
+		if (a3demo_gjkClosest(simplex, v_out))
+		{
+			apart = 0;
+			break;
+		}
+		vv = a3demo_gjkDot(v_out, v_out);
+		for (i = 0, size = a3realZero; i < simplex->count; ++i)
+			size = a3maximum(size, a3demo_gjkDot(simplex->vertex[i].w, simplex->vertex[i].w));
+		if (vv <= a3demo_gjkTouch * size)
+		{
+			apart = 0;
+			break;
+		}
+
+		// stop when a new point gets no closer, or rounding stalls it
+		if (vv >= previous || *iterations_out >= a3demo_gjkMaxIterations)
+			break;
+		previous = vv;
+		d[0] = -v_out[0];
+		d[1] = -v_out[1];
+		d[2] = -v_out[2];
+		a3demo_gjkSupport(w, pair, d);
+		vw = a3demo_gjkDot(v_out, w->w);
+		if (vv - vw <= a3demo_gjkTolerance * vv)
+			break;
+		for (i = 0; i < simplex->count; ++i)
+		{
+			a3demo_gjkDiff(diff, w->w, simplex->vertex[i].w);
+			if (a3demo_gjkDot(diff, diff) <= a3realEpsilon * a3realEpsilon)
+				break;
+		}
+		if (i < simplex->count)
+			break;
+		simplex->vertex[simplex->count++] = *w;
+	}
+
+	if (cache)
+	{
+		rotation = pair->poseA->rotation[0];
+		for (i = 0; i < simplex->count; ++i)
+			for (k = 0; k < 3; ++k)
+				cache->direction[i][k] = a3demo_gjkDot(simplex->vertex[i].d, rotation + k * 3);
+		cache->count = simplex->count;
+		cache->hintA = pair->hintA;
+		cache->hintB = pair->hintB;
+	}
+	return apart;
+}
+
+// fill a result from core points and a normal, putting the margins back
+inline void a3demo_gjkSetResult(a3_DemoGJKResult *result_out, const a3real *coreA, const a3real *coreB, const a3real *normal, const a3real coreDistance, const a3_DemoGJKPair *pair)
+{
+	memcpy(result_out->normal, normal, sizeof(a3real3));
+	a3demo_gjkMulAdd(result_out->pointA, coreA, normal, pair->marginA);
+	a3demo_gjkMulAdd(result_out->pointB, coreB, normal, -pair->marginB);
+	result_out->distance = coreDistance - pair->marginA - pair->marginB;
+}
+
+// closest points of separated cores from GJK's simplex
+void a3demo_gjkSeparated(a3_DemoGJKResult *result_out, const a3_DemoGJKSimplex *simplex, const a3real *v, const a3_DemoGJKPair *pair)
+{
+	a3real pointA[3] = { a3realZero }, pointB[3] = { a3realZero }, normal[3], dist;
+	unsigned int i;
+	for (i = 0; i < simplex->count; ++i)
+	{
+		a3demo_gjkMulAdd(pointA, pointA, simplex->vertex[i].a, simplex->weight[i]);
+		a3demo_gjkMulAdd(pointB, pointB, simplex->vertex[i].b, simplex->weight[i]);
+	}
+	dist = (a3real)sqrt(a3demo_gjkDot(v, v));
+	normal[0] = -v[0] / dist;
+	normal[1] = -v[1] / dist;
+	normal[2] = -v[2] / dist;
+	a3demo_gjkSetResult(result_out, pointA, pointB, normal, dist, pair);
+}
+
+// grow a simplex that touches or holds the origin into a tetrahedron
+//	that still does, by pushing out in directions it has no extent in
+//	-> returns 0 if the difference is flat there
+int a3demo_epaTetrahedron(a3_DemoGJKSimplex *simplex, a3_DemoGJKPair *pair)
+{
+	static const a3real axis[6][3] = {
+		{ +1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+		{ 0.0f, +1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+		{ 0.0f, 0.0f, +1.0f }, { 0.0f, 0.0f, -1.0f },
+	};
+	a3_DemoGJKVertex w[1];
+	a3real d[6][3], e[3], f[3], n[3], size, extent;
+	unsigned int i, tries;
+
+	while (simplex->count < 4)
+	{
+		for (i = 0, size = a3realZero; i < simplex->count; ++i)
+			size = a3maximum(size, (a3real)sqrt(a3demo_gjkDot(simplex->vertex[i].w, simplex->vertex[i].w)));
+		size = a3maximum(size, a3realOne) * 1.0e-5f;
+
+		// directions to try: any axis for a point; around a segment; to
+		//	either side of a triangle
+		switch (simplex->count)
+		{
+		case 1:
+			memcpy(d, axis, sizeof(axis));
+			tries = 6;
+			break;
+		case 2:
+			a3demo_gjkDiff(e, simplex->vertex[1].w, simplex->vertex[0].w);
+			i = (a3absolute(e[0]) < a3absolute(e[1])) ? (a3absolute(e[0]) < a3absolute(e[2]) ? 0 : 2) : (a3absolute(e[1]) < a3absolute(e[2]) ? 1 : 2);
+			a3demo_gjkCross(f, e, axis[i * 2]);
+			a3demo_gjkCross(n, e, f);
+			for (i = 0; i < 3; ++i)
+			{
+				d[0][i] = f[i];
+				d[1][i] = -f[i];
+				d[2][i] = n[i];
+				d[3][i] = -n[i];
+			}
+			tries = 4;
+			break;
+		default:
+			a3demo_gjkDiff(e, simplex->vertex[1].w, simplex->vertex[0].w);
+			a3demo_gjkDiff(f, simplex->vertex[2].w, simplex->vertex[0].w);
+			a3demo_gjkCross(n, e, f);
+			for (i = 0; i < 3; ++i)
+			{
+				d[0][i] = n[i];
+				d[1][i] = -n[i];
+			}
+			tries = 2;
+			break;
+		}
+
+		for (i = 0; i < tries; ++i)
+		{
+			a3demo_gjkSupport(w, pair, d[i]);
+			a3demo_gjkDiff(f, w->w, simplex->vertex[0].w);
+			switch (simplex->count)
+			{
+			case 1:
+				extent = (a3real)sqrt(a3demo_gjkDot(f, f));
+				break;
+			case 2:
+				a3demo_gjkCross(n, f, e);
+				extent = (a3real)sqrt(a3demo_gjkDot(n, n) / a3demo_gjkDot(e, e));
+				break;
+			default:
+				extent = a3absolute(a3demo_gjkDot(f, d[0])) / (a3real)sqrt(a3demo_gjkDot(d[0], d[0]));
+				break;
+			}
+			if (extent > size)
+				break;
+		}
+		if (i == tries)
+			return 0;
+		simplex->vertex[simplex->count++] = *w;
+	}
+	return 1;
+}
+
+// add a polytope face in the first free slot, normal by its winding
+//	-> returns face index
+unsigned int a3demo_epaAddFace(a3_DemoEPAPolytope *polytope, const unsigned int a, const unsigned int b, const unsigned int c)
+{
+	a3_DemoEPAFace *face;
+	a3real ab[3], ac[3], length;
+	unsigned int i;
+
+	for (i = 0; i < polytope->faceCount && polytope->face[i].alive; ++i);
+	if (i == polytope->faceCount)
+		++polytope->faceCount;
+	face = polytope->face + i;
+	face->v[0] = a;
+	face->v[1] = b;
+	face->v[2] = c;
+	face->alive = 1;
+	a3demo_gjkDiff(ab, polytope->vertex[b].w, polytope->vertex[a].w);
+	a3demo_gjkDiff(ac, polytope->vertex[c].w, polytope->vertex[a].w);
+	a3demo_gjkCross(face->normal, ab, ac);
+	length = (a3real)sqrt(a3demo_gjkDot(face->normal, face->normal));
+	if (length > a3realZero)
+	{
+		face->normal[0] /= length;
+		face->normal[1] /= length;
+		face->normal[2] /= length;
+		face->distance = a3demo_gjkDot(face->normal, polytope->vertex[a].w);
+	}
+	else
+		face->distance = FLT_MAX;
+	return i;
+}
+
+// EPA from a tetrahedron holding the origin: push the face closest to
+//	the origin out to the surface of a - b until it stops moving
+//	-> returns the depth; core points and normal written out
+a3real a3demo_epaRun(a3real *pointA_out, a3real *pointB_out, a3real *normal_out, unsigned int *iterations_out, const a3_DemoGJKSimplex *simplex, a3_DemoGJKPair *pair)
+{
+	static const unsigned int corner[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+	a3_DemoEPAPolytope polytope[1];
+	a3_DemoEPAFace *face, *best = 0;
+	a3_DemoGJKVertex *w;
+	a3real d[3], v0[3], v1[3], v2[3], d00, d01, d11, d20, d21, denom, weight[3];
+	unsigned int i, k, e, f, a, b, edgeCount, alive, swap;
+
+	polytope->vertexCount = 4;
+	polytope->faceCount = 0;
+	for (i = 0; i < 4; ++i)
+		polytope->vertex[i] = simplex->vertex[i];
+	for (i = 0; i < 4; ++i)
+	{
+		f = a3demo_epaAddFace(polytope, corner[i][0], corner[i][1], corner[i][2]);
+		face = polytope->face + f;
+		a3demo_gjkDiff(d, polytope->vertex[corner[i][3]].w, polytope->vertex[corner[i][0]].w);
+		if (a3demo_gjkDot(face->normal, d) > a3realZero)
+		{
+			swap = face->v[1];
+			face->v[1] = face->v[2];
+			face->v[2] = swap;
+			face->normal[0] = -face->normal[0];
+			face->normal[1] = -face->normal[1];
+			face->normal[2] = -face->normal[2];
+			face->distance = -face->distance;
+		}
+	}
+
+	for (*iterations_out = 0; ; ++*iterations_out)
+	{
+		for (f = 0, best = 0, alive = 0; f < polytope->faceCount; ++f)
+			if (polytope->face[f].alive)
+			{
+				++alive;
+				if (!best || polytope->face[f].distance < best->distance)
+					best = polytope->face + f;
+			}
+		if (polytope->vertexCount == a3demo_epaMaxVertices)
+			break;
+		w = polytope->vertex + polytope->vertexCount;
+		a3demo_gjkSupport(w, pair, best->normal);
+		if (a3demo_gjkDot(w->w, best->normal) - best->distance <= a3demo_epaTolerance)
+			break;
+
+		// faces the new point sees come off, leaving a hole whose rim is
+		//	the edges only one of them had
+		for (f = 0, edgeCount = 0; f < polytope->faceCount; ++f)
+		{
+			face = polytope->face + f;
+			a3demo_gjkDiff(d, w->w, polytope->vertex[face->v[0]].w);
+			polytope->visible[f] = face->alive && a3demo_gjkDot(face->normal, d) > a3realZero;
+			if (polytope->visible[f])
+			{
+				--alive;
+				for (k = 0; k < 3; ++k)
+				{
+					a = face->v[k];
+					b = face->v[(k + 1) % 3];
+					for (e = 0; e < edgeCount && (polytope->edge[e][0] != b || polytope->edge[e][1] != a); ++e);
+					if (e < edgeCount)
+					{
+						--edgeCount;
+						polytope->edge[e][0] = polytope->edge[edgeCount][0];
+						polytope->edge[e][1] = polytope->edge[edgeCount][1];
+					}
+					else if (edgeCount < a3demo_epaMaxFaces)
+					{
+						polytope->edge[edgeCount][0] = a;
+						polytope->edge[edgeCount][1] = b;
+						++edgeCount;
+					}
+					else
+						alive = a3demo_epaMaxFaces;
+				}
+			}
+		}
+
+		// out of room: the closest face is as good as it gets
+		if (alive + edgeCount > a3demo_epaMaxFaces)
+			break;
+		for (f = 0; f < polytope->faceCount; ++f)
+			if (polytope->visible[f])
+				polytope->face[f].alive = 0;
+		for (e = 0; e < edgeCount; ++e)
+			a3demo_epaAddFace(polytope, polytope->edge[e][0], polytope->edge[e][1], polytope->vertexCount);
+		++polytope->vertexCount;
+	}
+
+	// where the origin projects onto the closest face, in its corners'
+	//	terms, gives the points on either shape
+	d[0] = best->normal[0] * best->distance;
+	d[1] = best->normal[1] * best->distance;
+	d[2] = best->normal[2] * best->distance;
+	a3demo_gjkDiff(v0, polytope->vertex[best->v[1]].w, polytope->vertex[best->v[0]].w);
+	a3demo_gjkDiff(v1, polytope->vertex[best->v[2]].w, polytope->vertex[best->v[0]].w);
+	a3demo_gjkDiff(v2, d, polytope->vertex[best->v[0]].w);
+	d00 = a3demo_gjkDot(v0, v0);
+	d01 = a3demo_gjkDot(v0, v1);
+	d11 = a3demo_gjkDot(v1, v1);
+	d20 = a3demo_gjkDot(v2, v0);
+	d21 = a3demo_gjkDot(v2, v1);
+	denom = d00 * d11 - d01 * d01;
+	if (denom > a3realZero)
+	{
+		weight[1] = (d11 * d20 - d01 * d21) / denom;
+		weight[2] = (d00 * d21 - d01 * d20) / denom;
+		weight[0] = a3realOne - weight[1] - weight[2];
+	}
+	else
+	{
+		weight[0] = a3realOne;
+		weight[1] = weight[2] = a3realZero;
+	}
+	pointA_out[0] = pointA_out[1] = pointA_out[2] = a3realZero;
+	pointB_out[0] = pointB_out[1] = pointB_out[2] = a3realZero;
+	for (i = 0; i < 3; ++i)
+	{
+		a3demo_gjkMulAdd(pointA_out, pointA_out, polytope->vertex[best->v[i]].a, weight[i]);
+		a3demo_gjkMulAdd(pointB_out, pointB_out, polytope->vertex[best->v[i]].b, weight[i]);
+	}
+	memcpy(normal_out, best->normal, sizeof(a3real3));
+	return best->distance;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_getColliderSupport(a3real *point_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *direction, unsigned int *hint)
+{
+	if (point_out && collider && pose && direction)
+	{
+		const a3real length = (a3real)sqrt(a3demo_gjkDot(direction, direction));
+		if (!a3demo_gjkConvex(collider))
+			return 0;
+		a3demo_gjkCoreSupport(point_out, collider, pose, direction, hint);
+		if (length > a3realZero)
+			a3demo_gjkMulAdd(point_out, point_out, direction, a3demo_gjkMargin(collider) / length);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_initGJKCache(a3_DemoGJKCache *cache)
+{
+	if (cache)
+	{
+		memset(cache, 0, sizeof(a3_DemoGJKCache));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_queryGJKDistance(a3_DemoGJKResult *result_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache)
+{
+	if (result_out && colliderA && poseA && colliderB && poseB && a3demo_gjkConvex(colliderA) && a3demo_gjkConvex(colliderB))
+	{
+		a3_DemoGJKPair pair[1];
+		a3_DemoGJKSimplex simplex[1];
+		a3real v[3];
+
+		a3demo_gjkSetPair(pair, colliderA, poseA, colliderB, poseB, cache);
+		if (a3demo_gjkRun(simplex, v, &result_out->iterations, pair, cache))
+		{
+			a3demo_gjkSeparated(result_out, simplex, v, pair);
+			return result_out->distance > a3realZero;
+		}
+		result_out->distance = a3realZero;
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_queryGJKPenetration(a3_DemoGJKResult *result_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache)
+{
+	if (result_out && colliderA && poseA && colliderB && poseB && a3demo_gjkConvex(colliderA) && a3demo_gjkConvex(colliderB))
+	{
+		a3_DemoGJKPair pair[1];
+		a3_DemoGJKSimplex simplex[1];
+		a3_DemoGJKVertex w[1];
+		a3real v[3], pointA[3], pointB[3], normal[3], depth, length;
+		unsigned int iterations;
+
+		a3demo_gjkSetPair(pair, colliderA, poseA, colliderB, poseB, cache);
+		if (a3demo_gjkRun(simplex, v, &result_out->iterations, pair, cache))
+		{
+			// apart, or overlapping only within the margins
+			a3demo_gjkSeparated(result_out, simplex, v, pair);
+			return result_out->distance < a3realZero;
+		}
+
+		// cores overlap: EPA, unless the difference is flat where they
+		//	meet (segments crossing, a sphere's center on a capsule's
+		//	axis); then the overlap along the line between the shapes
+		//	is as good an answer as any
+		if (a3demo_epaTetrahedron(simplex, pair))
+		{
+			depth = a3demo_epaRun(pointA, pointB, normal, &iterations, simplex, pair);
+			result_out->iterations += iterations;
+		}
+		else
+		{
+			a3demo_gjkDiff(normal, poseB->position, poseA->position);
+			length = (a3real)sqrt(a3demo_gjkDot(normal, normal));
+			if (length > a3realZero)
+			{
+				normal[0] /= length;
+				normal[1] /= length;
+				normal[2] /= length;
+			}
+			else
+			{
+				normal[0] = normal[1] = a3realZero;
+				normal[2] = a3realOne;
+			}
+			a3demo_gjkSupport(w, pair, normal);
+			depth = a3demo_gjkDot(w->w, normal);
+			memcpy(pointA, w->a, sizeof(a3real3));
+			memcpy(pointB, w->b, sizeof(a3real3));
+		}
+		a3demo_gjkSetResult(result_out, pointA, pointB, normal, -depth, pair);
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGJK.h
+	Support mappings and GJK distance with EPA penetration depth for any
+		pair of convex colliders.
+*/
+
+#ifndef __ANIMAL3D_DEMOGJK_H
+#define __ANIMAL3D_DEMOGJK_H
+
+
+#include "a3_DemoCollider.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoGJKCache		a3_DemoGJKCache;
+	typedef struct a3_DemoGJKResult		a3_DemoGJKResult;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// query limits; everything lives on the stack, nothing is allocated
+	enum a3_DemoGJKConstants
+	{
+		a3demo_gjkMaxIterations = 32,	// support points per distance query
+		a3demo_epaMaxVertices = 64,		// penetration polytope size
+		a3demo_epaMaxFaces = 128,
+	};
+
+
+	// what one pair keeps from one frame to the next: the directions that
+	//	found the last simplex's points, in the first shape's frame so they
+	//	turn with it, and where hull searches ended
+	// zero it (or call init) for a pair seen for the first time
+	struct a3_DemoGJKCache
+	{
+		a3real3 direction[4];
+		unsigned int count;
+		unsigned int hintA, hintB;
+	};
+
+	// result of a query between shapes a and b
+	//	member distance: gap between the surfaces, negative when they
+	//		overlap (then minus the penetration depth)
+	//	member normal: unit, from a toward b; moving b along it by the
+	//		depth separates overlapping shapes
+	//	member pointA, pointB: closest points when apart, deepest points
+	//		when overlapping
+	struct a3_DemoGJKResult
+	{
+		a3real3 pointA, pointB;
+		a3real3 normal;
+		a3real distance;
+		unsigned int iterations;		// GJK steps plus EPA steps
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// support mapping: point of a posed collider farthest along a world
+	//	direction (any length); hint is where a hull's search starts and
+	//	ends (may be null); planes have none
+	//	-> returns 1, 0 for planes, -1 if invalid params
+	int a3demo_getColliderSupport(a3real *point_out, const a3_DemoCollider *collider, const a3_DemoColliderPose *pose, const a3real *direction, unsigned int *hint);
+
+	// forget a pair
+	int a3demo_initGJKCache(a3_DemoGJKCache *cache);
+
+	// distance between two convex colliders (not planes); spheres and
+	//	capsules are handled as a point or segment plus a radius, so they
+	//	stay exact and shallow overlaps of them still get a depth
+	//	param cache: optional; starts from last frame's simplex, and is
+	//		updated for the next
+	//	-> returns 1 if apart, 0 if overlapping (distance is then only
+	//		known for overlaps within the radii; otherwise it is zero and
+	//		the rest of the result is not filled in), -1 if invalid params
+	int a3demo_queryGJKDistance(a3_DemoGJKResult *result_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache);
+
+	// distance, and when the shapes overlap, penetration depth and normal
+	//	by expanding GJK's simplex into a polytope (EPA)
+	//	-> returns 1 if overlapping, 0 if apart, -1 if invalid params
+	int a3demo_queryGJKPenetration(a3_DemoGJKResult *result_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOGJK_H
@@ -0,0 +1,547 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGravity.c
+	Barnes-Hut octree build and walk.
+*/
+
+#include "a3_DemoGravity.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// arguments for one subtree build
+typedef struct a3_DemoGravityBuildTask
+{
+	a3_DemoGravityTree *tree;
+	const a3_DemoBodyStore *bodies;
+	a3_DemoGravityPool *pool;
+	unsigned int first, count;
+	a3real center[3], halfSize;
+	unsigned int failed;
+} a3_DemoGravityBuildTask;
+
+// arguments for force evaluation over a range of bodies
+typedef struct a3_DemoGravityWalkTask
+{
+	const a3_DemoGravityTree *tree;
+	a3_DemoBodyStore *bodies;
+	unsigned int first;
+} a3_DemoGravityWalkTask;
+
+
+// which octant of a cell a point falls in
+inline unsigned int a3demo_gravityOctant(const a3real *center, const a3real x, const a3real y, const a3real z)
+{
+	return (x >= center[0] ? 1 : 0) | (y >= center[1] ? 2 : 0) | (z >= center[2] ? 4 : 0);
+}
+
+// child cell center from parent
+inline void a3demo_gravityChildCenter(a3real *center_out, const a3real *center, const a3real halfSize, const unsigned int octant)
+{
+	const a3real q = halfSize * a3realHalf;
+	center_out[0] = center[0] + (octant & 1 ? q : -q);
+	center_out[1] = center[1] + (octant & 2 ? q : -q);
+	center_out[2] = center[2] + (octant & 4 ? q : -q);
+}
+
+// get a fresh node from a pool, growing it if needed
+int a3demo_gravityPoolAlloc(a3_DemoGravityPool *pool)
+{
+	if (pool->count >= pool->capacity)
+	{
+		const unsigned int capacity = pool->capacity ? pool->capacity * 2 : 256;
+		a3_DemoGravityNode *node = (a3_DemoGravityNode *)realloc(pool->node, capacity * sizeof(a3_DemoGravityNode));
+		if (!node)
+			return -1;
+		pool->node = node;
+		pool->capacity = capacity;
+	}
+	return pool->count++;
+}
+
+// split index range into octants around a center (counting sort)
+void a3demo_gravityPartition(const a3_DemoBodyStore *bodies, unsigned int *index, unsigned int *scratch, const unsigned int count, const a3real *center, unsigned int *octantFirst_out, unsigned int *octantCount_out)
+{
+	unsigned int i, o, b, offset[a3demo_gravityOctants];
+	unsigned char octant;
+
+	memset(octantCount_out, 0, sizeof(unsigned int) * a3demo_gravityOctants);
+	for (i = 0; i < count; ++i)
+	{
+		b = index[i];
+		octant = (unsigned char)a3demo_gravityOctant(center, bodies->posX[b], bodies->posY[b], bodies->posZ[b]);
+		++octantCount_out[octant];
+	}
+	for (o = 0, b = 0; o < a3demo_gravityOctants; ++o)
+	{
+		octantFirst_out[o] = offset[o] = b;
+		b += octantCount_out[o];
+	}
+	for (i = 0; i < count; ++i)
+	{
+		b = index[i];
+		octant = (unsigned char)a3demo_gravityOctant(center, bodies->posX[b], bodies->posY[b], bodies->posZ[b]);
+		scratch[offset[octant]++] = b;
+	}
+	memcpy(index, scratch, sizeof(unsigned int) * count);
+}
+
+// recursive cell build; returns node index in pool
+int a3demo_gravityBuildNode(const a3_DemoGravityTree *tree, const a3_DemoBodyStore *bodies, a3_DemoGravityPool *pool, const unsigned int first, const unsigned int count, const a3real *center, const a3real halfSize, const unsigned int depth)
+{
+	const int nodeIndex = a3demo_gravityPoolAlloc(pool);
+	a3_DemoGravityNode *node;
+	a3real mass = a3realZero, mx = a3realZero, my = a3realZero, mz = a3realZero;
+	unsigned int i, b, o;
+
+	if (nodeIndex < 0)
+		return -1;
+
+	node = pool->node + nodeIndex;
+	node->center[0] = center[0];
+	node->center[1] = center[1];
+	node->center[2] = center[2];
+	node->halfSize = halfSize;
+	node->first = first;
+	node->count = count;
+	for (o = 0; o < a3demo_gravityOctants; ++o)
+		node->child[o] = -1;
+
+	if (count <= tree->leafSize || depth >= a3demo_gravityMaxDepth)
+	{
+		// leaf: sum bodies directly
+		for (i = 0; i < count; ++i)
+		{
+			b = tree->index[first + i];
+			mass += bodies->mass[b];
+			mx += bodies->mass[b] * bodies->posX[b];
+			my += bodies->mass[b] * bodies->posY[b];
+			mz += bodies->mass[b] * bodies->posZ[b];
+		}
+	}
+	else
+	{
+		unsigned int octantFirst[a3demo_gravityOctants], octantCount[a3demo_gravityOctants];
+		a3real childCenter[3];
+		int child;
+
+		a3demo_gravityPartition(bodies, tree->index + first, tree->scratch + first, count, center, octantFirst, octantCount);
+		for (o = 0; o < a3demo_gravityOctants; ++o)
+		{
+			if (octantCount[o])
+			{
+				a3demo_gravityChildCenter(childCenter, center, halfSize, o);
+				child = a3demo_gravityBuildNode(tree, bodies, pool, first + octantFirst[o], octantCount[o], childCenter, halfSize * a3realHalf, depth + 1);
+				if (child < 0)
+					return -1;
+
+				// pool may have moved while building the child
+				pool->node[nodeIndex].child[o] = child;
+				mass += pool->node[child].mass;
+				mx += pool->node[child].mass * pool->node[child].com[0];
+				my += pool->node[child].mass * pool->node[child].com[1];
+				mz += pool->node[child].mass * pool->node[child].com[2];
+			}
+		}
+	}
+
+	node = pool->node + nodeIndex;
+	node->mass = mass;
+	if (mass > a3realZero)
+	{
+		mass = a3recip(mass);
+		node->com[0] = mx * mass;
+		node->com[1] = my * mass;
+		node->com[2] = mz * mass;
+	}
+	else
+	{
+		node->com[0] = center[0];
+		node->com[1] = center[1];
+		node->com[2] = center[2];
+	}
+	return nodeIndex;
+}
+
+// build the subtrees of a range of octants
+void a3demo_gravityBuildJob(a3_DemoGravityBuildTask *task, const unsigned int first, const unsigned int count)
+{
+	unsigned int o;
+	for (o = first; o < first + count; ++o)
+		if (task[o].count)
+			task[o].failed = a3demo_gravityBuildNode(task[o].tree, task[o].bodies, task[o].pool, task[o].first, task[o].count, task[o].center, task[o].halfSize, 1) < 0;
+}
+
+
+// accumulate acceleration on one body by walking the tree
+void a3demo_gravityWalkBody(const a3_DemoGravityTree *tree, a3_DemoBodyStore *bodies, const unsigned int b)
+{
+	const a3_DemoGravityNode *node;
+	const a3real px = bodies->posX[b], py = bodies->posY[b], pz = bodies->posZ[b];
+	const a3real thetaSq = tree->theta * tree->theta;
+	const a3real epsSq = tree->softening * tree->softening;
+	a3real ax = a3realZero, ay = a3realZero, az = a3realZero;
+	a3real dx, dy, dz, distSq, size, s;
+	unsigned int i, j, o;
+	int stack[a3demo_gravityMaxDepth * (a3demo_gravityOctants - 1) + a3demo_gravityOctants], top = 0;
+
+	stack[top++] = 0;
+	while (top)
+	{
+		node = tree->node + stack[--top];
+		dx = node->com[0] - px;
+		dy = node->com[1] - py;
+		dz = node->com[2] - pz;
+		distSq = dx * dx + dy * dy + dz * dz;
+		size = node->halfSize + node->halfSize;
+
+		// far enough and not containing the body: use the cell's monopole
+		if (size * size < thetaSq * distSq &&
+			(a3absolute(px - node->center[0]) > node->halfSize ||
+			a3absolute(py - node->center[1]) > node->halfSize ||
+			a3absolute(pz - node->center[2]) > node->halfSize))
+		{
+			distSq += epsSq;
+			s = node->mass / (distSq * sqrtf(distSq));
+			ax += dx * s;
+			ay += dy * s;
+			az += dz * s;
+		}
+		else if (node->child[0] < 0 && node->child[1] < 0 && node->child[2] < 0 && node->child[3] < 0 &&
+			node->child[4] < 0 && node->child[5] < 0 && node->child[6] < 0 && node->child[7] < 0)
+		{
+			// leaf: direct sum
+			for (i = 0; i < node->count; ++i)
+			{
+				j = tree->index[node->first + i];
+				if (j != b)
+				{
+					dx = bodies->posX[j] - px;
+					dy = bodies->posY[j] - py;
+					dz = bodies->posZ[j] - pz;
+					distSq = dx * dx + dy * dy + dz * dz + epsSq;
+					s = bodies->mass[j] / (distSq * sqrtf(distSq));
+					ax += dx * s;
+					ay += dy * s;
+					az += dz * s;
+				}
+			}
+		}
+		else
+		{
+			for (o = 0; o < a3demo_gravityOctants; ++o)
+				if (node->child[o] >= 0)
+					stack[top++] = node->child[o];
+		}
+	}
+
+	bodies->accX[b] += ax * tree->gravity;
+	bodies->accY[b] += ay * tree->gravity;
+	bodies->accZ[b] += az * tree->gravity;
+}
+
+// walk a range of bodies (offset from the task's first)
+void a3demo_gravityWalkJob(a3_DemoGravityWalkTask *task, const unsigned int first, const unsigned int count)
+{
+	unsigned int i;
+	for (i = task->first + first; i < task->first + first + count; ++i)
+		a3demo_gravityWalkBody(task->tree, task->bodies, i);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initGravityTree(a3_DemoGravityTree *tree, const a3real gravity, const a3real softening, const a3real theta, const unsigned int leafSize, a3_DemoJobSystem *jobs)
+{
+	if (tree)
+	{
+		memset(tree, 0, sizeof(a3_DemoGravityTree));
+		tree->gravity = gravity;
+		tree->softening = softening;
+		tree->theta = theta;
+		tree->leafSize = leafSize ? leafSize : 1;
+		tree->jobs = jobs;
+		tree->parallelThreshold = 4096;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseGravityTree(a3_DemoGravityTree *tree)
+{
+	if (tree)
+	{
+		unsigned int o;
+		for (o = 0; o < a3demo_gravityOctants; ++o)
+			free(tree->pool[o].node);
+		free(tree->node);
+		free(tree->index);
+		free(tree->scratch);
+		memset(tree, 0, sizeof(a3_DemoGravityTree));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setGravityTreeTheta(a3_DemoGravityTree *tree, const a3real theta)
+{
+	if (tree && theta >= a3realZero)
+	{
+		tree->theta = theta;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_buildGravityTree(a3_DemoGravityTree *tree, const a3_DemoBodyStore *bodies)
+{
+	if (tree && bodies && bodies->count)
+	{
+		const unsigned int n = bodies->count;
+		a3_DemoGravityBuildTask task[a3demo_gravityOctants];
+		a3_DemoGravityNode *root;
+		unsigned int octantFirst[a3demo_gravityOctants], octantCount[a3demo_gravityOctants], offset[a3demo_gravityOctants];
+		unsigned int i, o, total;
+		a3real lo[3], hi[3], center[3], halfSize;
+
+		// index storage
+		if (tree->indexCapacity < n)
+		{
+			free(tree->index);
+			free(tree->scratch);
+			tree->index = (unsigned int *)malloc(n * sizeof(unsigned int));
+			tree->scratch = (unsigned int *)malloc(n * sizeof(unsigned int));
+			if (!tree->index || !tree->scratch)
+			{
+				tree->indexCapacity = 0;
+				return -1;
+			}
+			tree->indexCapacity = n;
+		}
+
+		// bounding cube
+		lo[0] = hi[0] = bodies->posX[0];
+		lo[1] = hi[1] = bodies->posY[0];
+		lo[2] = hi[2] = bodies->posZ[0];
+		for (i = 0; i < n; ++i)
+		{
+			tree->index[i] = i;
+			lo[0] = a3minimum(lo[0], bodies->posX[i]);
+			lo[1] = a3minimum(lo[1], bodies->posY[i]);
+			lo[2] = a3minimum(lo[2], bodies->posZ[i]);
+			hi[0] = a3maximum(hi[0], bodies->posX[i]);
+			hi[1] = a3maximum(hi[1], bodies->posY[i]);
+			hi[2] = a3maximum(hi[2], bodies->posZ[i]);
+		}
+		center[0] = (lo[0] + hi[0]) * a3realHalf;
+		center[1] = (lo[1] + hi[1]) * a3realHalf;
+		center[2] = (lo[2] + hi[2]) * a3realHalf;
+		halfSize = a3maximum(hi[0] - lo[0], a3maximum(hi[1] - lo[1], hi[2] - lo[2])) * a3realHalf;
+		halfSize = halfSize * 1.001f + a3realEpsilon;
+
+		// split once at the root, then build each octant's subtree in its
+		//	own pool so the builds share nothing; one job per octant
+		a3demo_gravityPartition(bodies, tree->index, tree->scratch, n, center, octantFirst, octantCount);
+		for (o = 0; o < a3demo_gravityOctants; ++o)
+		{
+			task[o].tree = tree;
+			task[o].bodies = bodies;
+			task[o].pool = tree->pool + o;
+			task[o].first = octantFirst[o];
+			task[o].count = octantCount[o];
+			task[o].halfSize = halfSize * a3realHalf;
+			a3demo_gravityChildCenter(task[o].center, center, halfSize, o);
+			task[o].failed = 0;
+			tree->pool[o].count = 0;
+		}
+		a3demo_parallelFor(n >= tree->parallelThreshold ? tree->jobs : 0,
+			(a3_DemoJobFunc)a3demo_gravityBuildJob, task, a3demo_gravityOctants, 1);
+
+		// a subtree that ran out of pool memory leaves the tree unusable
+		for (o = 0; o < a3demo_gravityOctants; ++o)
+			if (task[o].failed)
+			{
+				tree->nodeCount = 0;
+				return -1;
+			}
+
+		// flatten: root, then each pool in order
+		for (o = 0, total = 1; o < a3demo_gravityOctants; ++o)
+		{
+			offset[o] = total;
+			total += tree->pool[o].count;
+		}
+		if (tree->nodeCapacity < total)
+		{
+			free(tree->node);
+			tree->nodeCapacity = total + total / 2;
+			tree->node = (a3_DemoGravityNode *)malloc(tree->nodeCapacity * sizeof(a3_DemoGravityNode));
+			if (!tree->node)
+			{
+				tree->nodeCapacity = tree->nodeCount = 0;
+				return -1;
+			}
+		}
+
+		root = tree->node;
+		memset(root, 0, sizeof(a3_DemoGravityNode));
+		root->center[0] = center[0];
+		root->center[1] = center[1];
+		root->center[2] = center[2];
+		root->halfSize = halfSize;
+		root->count = n;
+		for (o = 0; o < a3demo_gravityOctants; ++o)
+		{
+			const a3_DemoGravityPool *pool = tree->pool + o;
+			a3_DemoGravityNode *node = tree->node + offset[o];
+			root->child[o] = -1;
+			if (pool->count)
+			{
+				memcpy(node, pool->node, pool->count * sizeof(a3_DemoGravityNode));
+				for (i = 0; i < pool->count; ++i, ++node)
+				{
+					node->child[0] += node->child[0] >= 0 ? offset[o] : 0;
+					node->child[1] += node->child[1] >= 0 ? offset[o] : 0;
+					node->child[2] += node->child[2] >= 0 ? offset[o] : 0;
+					node->child[3] += node->child[3] >= 0 ? offset[o] : 0;
+					node->child[4] += node->child[4] >= 0 ? offset[o] : 0;
+					node->child[5] += node->child[5] >= 0 ? offset[o] : 0;
+					node->child[6] += node->child[6] >= 0 ? offset[o] : 0;
+					node->child[7] += node->child[7] >= 0 ? offset[o] : 0;
+				}
+				node = tree->node + offset[o];
+				root->child[o] = offset[o];
+				root->mass += node->mass;
+				root->com[0] += node->mass * node->com[0];
+				root->com[1] += node->mass * node->com[1];
+				root->com[2] += node->mass * node->com[2];
+			}
+		}
+		if (root->mass > a3realZero)
+		{
+			const a3real invMass = a3recip(root->mass);
+			root->com[0] *= invMass;
+			root->com[1] *= invMass;
+			root->com[2] *= invMass;
+		}
+		tree->nodeCount = total;
+		return total;
+	}
+	return -1;
+}
+
+int a3demo_applyGravityTree(const a3_DemoGravityTree *tree, a3_DemoBodyStore *bodies, const unsigned int first, const unsigned int count)
+{
+	if (tree && tree->nodeCount && bodies && first + count <= bodies->count)
+	{
+		a3_DemoGravityWalkTask task[1];
+		const unsigned int workers = tree->jobs ? tree->jobs->workerCount : 1;
+		const unsigned int grain = a3maximum(count / (workers * 8), 64);
+
+		// walks only read the tree, so ranges run independently; a few
+		//	ranges per worker leaves room to balance uneven walks
+		task->tree = tree;
+		task->bodies = bodies;
+		task->first = first;
+		a3demo_parallelFor(count >= tree->parallelThreshold ? tree->jobs : 0,
+			(a3_DemoJobFunc)a3demo_gravityWalkJob, task, count, grain);
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_accelerateGravityTree(a3_DemoBodyStore *bodies, a3_DemoGravityTree *tree)
+{
+	if (a3demo_clearBodyAccelerations(bodies) > 0 && bodies->count && a3demo_buildGravityTree(tree, bodies) > 0)
+		return a3demo_applyGravityTree(tree, bodies, 0, bodies->count);
+	return -1;
+}
+
+int a3demo_getGravityEnergy(const a3_DemoBodyStore *bodies, const a3real gravity, const a3real softening, double *kinetic_out, double *potential_out)
+{
+	if (bodies && kinetic_out && potential_out)
+	{
+		const double epsSq = (double)softening * (double)softening;
+		double kinetic = 0.0, potential = 0.0, dx, dy, dz;
+		unsigned int i, j;
+
+		for (i = 0; i < bodies->count; ++i)
+		{
+			kinetic += 0.5 * bodies->mass[i] * ((double)bodies->velX[i] * bodies->velX[i] + (double)bodies->velY[i] * bodies->velY[i] + (double)bodies->velZ[i] * bodies->velZ[i]);
+			for (j = i + 1; j < bodies->count; ++j)
+			{
+				dx = (double)bodies->posX[j] - bodies->posX[i];
+				dy = (double)bodies->posY[j] - bodies->posY[i];
+				dz = (double)bodies->posZ[j] - bodies->posZ[i];
+				potential -= (double)bodies->mass[i] * bodies->mass[j] / sqrt(dx * dx + dy * dy + dz * dz + epsSq);
+			}
+		}
+		*kinetic_out = kinetic;
+		*potential_out = potential * gravity;
+		return bodies->count;
+	}
+	return -1;
+}
+
+int a3demo_applyGravityBruteForce(a3_DemoBodyStore *bodies, const a3real gravity, const a3real softening, const unsigned int first, const unsigned int count)
+{
+	if (bodies && first + count <= bodies->count)
+	{
+		const unsigned int n = bodies->count;
+		const a3real epsSq = softening * softening;
+		a3real px, py, pz, ax, ay, az, dx, dy, dz, distSq, s;
+		unsigned int i, j;
+
+		for (i = first; i < first + count; ++i)
+		{
+			px = bodies->posX[i];
+			py = bodies->posY[i];
+			pz = bodies->posZ[i];
+			ax = ay = az = a3realZero;
+			for (j = 0; j < n; ++j)
+			{
+				if (j == i)
+					continue;
+				dx = bodies->posX[j] - px;
+				dy = bodies->posY[j] - py;
+				dz = bodies->posZ[j] - pz;
+				distSq = dx * dx + dy * dy + dz * dz + epsSq;
+				s = bodies->mass[j] / (distSq * sqrtf(distSq));
+				ax += dx * s;
+				ay += dy * s;
+				az += dz * s;
+			}
+			bodies->accX[i] += ax * gravity;
+			bodies->accY[i] += ay * gravity;
+			bodies->accZ[i] += az * gravity;
+		}
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
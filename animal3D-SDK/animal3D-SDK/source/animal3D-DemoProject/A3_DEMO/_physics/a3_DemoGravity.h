@@ -0,0 +1,128 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGravity.h
+	N-body gravity: Barnes-Hut octree and brute-force reference.
+*/
+
+#ifndef __ANIMAL3D_DEMOGRAVITY_H
+#define __ANIMAL3D_DEMOGRAVITY_H
+
+
+#include "a3_DemoBodyStore.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoGravityNode	a3_DemoGravityNode;
+	typedef struct a3_DemoGravityPool	a3_DemoGravityPool;
+	typedef struct a3_DemoGravityTree	a3_DemoGravityTree;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// gravity constants
+	enum a3_DemoGravityConstants
+	{
+		a3demo_gravityOctants = 8,
+		a3demo_gravityMaxDepth = 32,
+	};
+
+
+	// octree cell
+	struct a3_DemoGravityNode
+	{
+		a3real com[3];			// center of mass
+		a3real mass;			// total mass
+		a3real center[3];		// cell center
+		a3real halfSize;		// half cell width
+		int child[a3demo_gravityOctants];	// child node indices; -1 if empty
+		unsigned int first;		// first entry in the tree's index list
+		unsigned int count;		// bodies in this cell
+	};
+
+	// growable node list; one per top-level octant so subtrees build
+	//	independently
+	struct a3_DemoGravityPool
+	{
+		a3_DemoGravityNode *node;
+		unsigned int count, capacity;
+	};
+
+	// Barnes-Hut tree, rebuilt every step
+	struct a3_DemoGravityTree
+	{
+		a3_DemoGravityNode *node;		// final flattened tree; root is node 0
+		unsigned int nodeCount, nodeCapacity;
+		unsigned int *index;			// body indices grouped by cell
+		unsigned int *scratch;			// partition workspace
+		unsigned int indexCapacity;
+		a3_DemoGravityPool pool[a3demo_gravityOctants];
+
+		a3real gravity;					// gravitational constant
+		a3real softening;				// Plummer softening length
+		a3real theta;					// opening angle; 0 is exact
+		unsigned int leafSize;			// max bodies per leaf
+		a3_DemoJobSystem *jobs;			// scheduler for build and walk; null is serial
+		unsigned int parallelThreshold;	// body count below which work stays serial
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown
+	int a3demo_initGravityTree(a3_DemoGravityTree *tree, const a3real gravity, const a3real softening, const a3real theta, const unsigned int leafSize, a3_DemoJobSystem *jobs);
+	int a3demo_releaseGravityTree(a3_DemoGravityTree *tree);
+
+	// change opening angle
+	int a3demo_setGravityTreeTheta(a3_DemoGravityTree *tree, const a3real theta);
+
+	// rebuild tree from all bodies; returns node count, or -1 if any
+	//	subtree could not allocate its nodes
+	int a3demo_buildGravityTree(a3_DemoGravityTree *tree, const a3_DemoBodyStore *bodies);
+
+	// add tree-approximated gravity to the accelerations of a range of bodies
+	int a3demo_applyGravityTree(const a3_DemoGravityTree *tree, a3_DemoBodyStore *bodies, const unsigned int first, const unsigned int count);
+
+	// integrator callback: clear accelerations, rebuild and apply the tree
+	int a3demo_accelerateGravityTree(a3_DemoBodyStore *bodies, a3_DemoGravityTree *tree);
+
+	// kinetic and (softened) potential energy, exact O(N^2)
+	int a3demo_getGravityEnergy(const a3_DemoBodyStore *bodies, const a3real gravity, const a3real softening, double *kinetic_out, double *potential_out);
+
+	// add exact O(N^2) gravity to the accelerations of a range of bodies
+	int a3demo_applyGravityBruteForce(a3_DemoBodyStore *bodies, const a3real gravity, const a3real softening, const unsigned int first, const unsigned int count);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOGRAVITY_H
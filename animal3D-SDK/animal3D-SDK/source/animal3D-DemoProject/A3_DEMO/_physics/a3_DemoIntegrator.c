@@ -0,0 +1,239 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoIntegrator.c
+	Integrator implementations.
+*/
+
+#include "a3_DemoIntegrator.h"
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// evaluate forces at the current state
+inline int a3demo_integratorAccelerate(a3_DemoIntegrator *integrator, a3_DemoBodyStore *bodies)
+{
+	++integrator->evaluations;
+	return integrator->accelerate(bodies, integrator->user);
+}
+
+// make sure RK4 scratch matches the body store
+int a3demo_integratorPrepareScratch(a3_DemoIntegrator *integrator, const a3_DemoBodyStore *bodies)
+{
+	unsigned int i;
+	for (i = 0; i < 2; ++i)
+	{
+		if (integrator->scratch[i].capacity != bodies->capacity)
+		{
+			a3demo_releaseBodyStore(integrator->scratch + i);
+			if (a3demo_createBodyStore(integrator->scratch + i, bodies->capacity) < 0)
+				return -1;
+		}
+		integrator->scratch[i].count = bodies->count;
+	}
+	return 1;
+}
+
+// x_out = x0 + v * s and v_out = v0 + a * s, all three axes
+void a3demo_integratorStage(a3_DemoBodyStore *bodies, const a3_DemoBodyStore *start, const a3real s)
+{
+	const unsigned int n = bodies->count;
+	a3demo_bodyArrayMulAdd(bodies->posX, start->posX, bodies->velX, s, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(bodies->posY, start->posY, bodies->velY, s, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(bodies->posZ, start->posZ, bodies->velZ, s, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(bodies->velX, start->velX, bodies->accX, s, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(bodies->velY, start->velY, bodies->accY, s, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(bodies->velZ, start->velZ, bodies->accZ, s, bodies->flags, n);
+}
+
+// sum += (v, a) * w
+void a3demo_integratorAccumulate(a3_DemoBodyStore *sum, const a3_DemoBodyStore *bodies, const a3real w)
+{
+	const unsigned int n = bodies->count;
+	a3demo_bodyArrayMulAdd(sum->posX, sum->posX, bodies->velX, w, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(sum->posY, sum->posY, bodies->velY, w, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(sum->posZ, sum->posZ, bodies->velZ, w, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(sum->velX, sum->velX, bodies->accX, w, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(sum->velY, sum->velY, bodies->accY, w, bodies->flags, n);
+	a3demo_bodyArrayMulAdd(sum->velZ, sum->velZ, bodies->accZ, w, bodies->flags, n);
+}
+
+// classic RK4 on y = (x, v), y' = (v, a(x))
+int a3demo_integratorStepRK4(a3_DemoIntegrator *integrator, a3_DemoBodyStore *bodies, const a3real dt)
+{
+	a3_DemoBodyStore *const start = integrator->scratch + 0, *const sum = integrator->scratch + 1;
+	const size_t size = bodies->capacity * sizeof(a3real) * 3;
+	const a3real h = dt * a3realHalf;
+
+	if (a3demo_integratorPrepareScratch(integrator, bodies) < 0)
+		return -1;
+
+	// x and v arrays are adjacent, so one copy each
+	memcpy(start->posX, bodies->posX, size);
+	memcpy(start->velX, bodies->velX, size);
+	memset(sum->posX, 0, size);
+	memset(sum->velX, 0, size);
+
+	// k1 at start, k2 and k3 at the midpoint, k4 at the end
+	a3demo_integratorAccelerate(integrator, bodies);
+	a3demo_integratorAccumulate(sum, bodies, a3realOne);
+	a3demo_integratorStage(bodies, start, h);
+
+	a3demo_integratorAccelerate(integrator, bodies);
+	a3demo_integratorAccumulate(sum, bodies, a3realTwo);
+	a3demo_integratorStage(bodies, start, h);
+
+	a3demo_integratorAccelerate(integrator, bodies);
+	a3demo_integratorAccumulate(sum, bodies, a3realTwo);
+	a3demo_integratorStage(bodies, start, dt);
+
+	a3demo_integratorAccelerate(integrator, bodies);
+	a3demo_integratorAccumulate(sum, bodies, a3realOne);
+
+	// y = y0 + (k1 + 2 k2 + 2 k3 + k4) dt / 6
+	a3demo_bodyArrayMulAdd(bodies->posX, start->posX, sum->posX, dt * a3realSixth, bodies->flags, bodies->count);
+	a3demo_bodyArrayMulAdd(bodies->posY, start->posY, sum->posY, dt * a3realSixth, bodies->flags, bodies->count);
+	a3demo_bodyArrayMulAdd(bodies->posZ, start->posZ, sum->posZ, dt * a3realSixth, bodies->flags, bodies->count);
+	a3demo_bodyArrayMulAdd(bodies->velX, start->velX, sum->velX, dt * a3realSixth, bodies->flags, bodies->count);
+	a3demo_bodyArrayMulAdd(bodies->velY, start->velY, sum->velY, dt * a3realSixth, bodies->flags, bodies->count);
+	a3demo_bodyArrayMulAdd(bodies->velZ, start->velZ, sum->velZ, dt * a3realSixth, bodies->flags, bodies->count);
+	return bodies->count;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initIntegrator(a3_DemoIntegrator *integrator, const a3_DemoIntegratorType type, a3_DemoAccelerationFunc accelerate, void *user)
+{
+	if (integrator && accelerate && type < a3demo_integrator_count)
+	{
+		memset(integrator, 0, sizeof(a3_DemoIntegrator));
+		integrator->type = type;
+		integrator->accelerate = accelerate;
+		integrator->user = user;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseIntegrator(a3_DemoIntegrator *integrator)
+{
+	if (integrator)
+	{
+		a3demo_releaseBodyStore(integrator->scratch + 0);
+		a3demo_releaseBodyStore(integrator->scratch + 1);
+		integrator->accelerationValid = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setIntegratorType(a3_DemoIntegrator *integrator, const a3_DemoIntegratorType type)
+{
+	if (integrator && type < a3demo_integrator_count)
+	{
+		integrator->type = type;
+		return a3demo_resetIntegrator(integrator);
+	}
+	return -1;
+}
+
+int a3demo_resetIntegrator(a3_DemoIntegrator *integrator)
+{
+	if (integrator)
+	{
+		integrator->accelerationValid = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_stepIntegrator(a3_DemoIntegrator *integrator, a3_DemoBodyStore *bodies, const a3real dt)
+{
+	if (integrator && integrator->accelerate && bodies && bodies->memory)
+	{
+		const a3real h = dt * a3realHalf;
+
+		switch (integrator->type)
+		{
+		case a3demo_integrator_explicitEuler:
+			// both updates use the old state
+			a3demo_integratorAccelerate(integrator, bodies);
+			a3demo_driftBodyStore(bodies, dt);
+			a3demo_kickBodyStore(bodies, dt);
+			break;
+
+		case a3demo_integrator_semiImplicitEuler:
+			// new velocity moves the position (fused kernel)
+			a3demo_integratorAccelerate(integrator, bodies);
+			a3demo_integrateBodyStore(bodies, dt);
+			break;
+
+		case a3demo_integrator_velocityVerlet:
+			// end-of-step accelerations carry over as next start
+			if (!integrator->accelerationValid)
+				a3demo_integratorAccelerate(integrator, bodies);
+			a3demo_kickBodyStore(bodies, h);
+			a3demo_driftBodyStore(bodies, dt);
+			a3demo_integratorAccelerate(integrator, bodies);
+			a3demo_kickBodyStore(bodies, h);
+			integrator->accelerationValid = 1;
+			return bodies->count;
+
+		case a3demo_integrator_leapfrog:
+			// forces at the half-step position
+			a3demo_driftBodyStore(bodies, h);
+			a3demo_integratorAccelerate(integrator, bodies);
+			a3demo_kickBodyStore(bodies, dt);
+			a3demo_driftBodyStore(bodies, h);
+			break;
+
+		case a3demo_integrator_rk4:
+			if (a3demo_integratorStepRK4(integrator, bodies, dt) < 0)
+				return -1;
+			break;
+
+		default:
+			return -1;
+		}
+
+		integrator->accelerationValid = 0;
+		return bodies->count;
+	}
+	return -1;
+}
+
+const char *a3demo_getIntegratorName(const a3_DemoIntegratorType type)
+{
+	const char *names[a3demo_integrator_count] = {
+		"explicit Euler",
+		"semi-implicit Euler",
+		"velocity Verlet",
+		"leapfrog",
+		"RK4",
+	};
+	return type < a3demo_integrator_count ? names[type] : "unknown";
+}
+
+
+//-----------------------------------------------------------------------------
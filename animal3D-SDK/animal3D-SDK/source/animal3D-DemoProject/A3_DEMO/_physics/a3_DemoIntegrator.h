@@ -0,0 +1,117 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoIntegrator.h
+	Selectable time integrators operating on the body store.
+*/
+
+#ifndef __ANIMAL3D_DEMOINTEGRATOR_H
+#define __ANIMAL3D_DEMOINTEGRATOR_H
+
+
+#include "a3_DemoBodyStore.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoIntegrator		a3_DemoIntegrator;
+	typedef enum a3_DemoIntegratorType		a3_DemoIntegratorType;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// force callback: must overwrite every body's acceleration using the
+	//	current positions (and velocities, if it cares)
+	//	-> same signature as a3demo_accelerateGravityTree with a void pointer
+	typedef int(*a3_DemoAccelerationFunc)(a3_DemoBodyStore *bodies, void *user);
+
+
+	// available schemes
+	//	explicit Euler:			1st order, not symplectic; energy grows
+	//	semi-implicit Euler:	1st order, symplectic
+	//	velocity Verlet:		2nd order, symplectic, kick-drift-kick
+	//	leapfrog:				2nd order, symplectic, drift-kick-drift
+	//	RK4:					4th order, not symplectic; 4 force calls
+	enum a3_DemoIntegratorType
+	{
+		a3demo_integrator_explicitEuler,
+		a3demo_integrator_semiImplicitEuler,
+		a3demo_integrator_velocityVerlet,
+		a3demo_integrator_leapfrog,
+		a3demo_integrator_rk4,
+
+		a3demo_integrator_count
+	};
+
+
+	// integrator: scheme, force callback and any state the scheme carries
+	//	between steps
+	struct a3_DemoIntegrator
+	{
+		a3_DemoIntegratorType type;
+		a3_DemoAccelerationFunc accelerate;
+		void *user;
+
+		// velocity Verlet reuses the previous step's end accelerations
+		unsigned int accelerationValid;
+
+		// RK4 start state [0] and weighted stage sums [1], both kept in the 
+		//	position and velocity arrays of spare body stores (heap)
+		a3_DemoBodyStore scratch[2];
+
+		// force evaluations so far
+		unsigned int evaluations;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown
+	int a3demo_initIntegrator(a3_DemoIntegrator *integrator, const a3_DemoIntegratorType type, a3_DemoAccelerationFunc accelerate, void *user);
+	int a3demo_releaseIntegrator(a3_DemoIntegrator *integrator);
+
+	// switch scheme; also resets
+	int a3demo_setIntegratorType(a3_DemoIntegrator *integrator, const a3_DemoIntegratorType type);
+
+	// forget carried state; call whenever bodies are added, removed or
+	//	teleported outside the integrator
+	int a3demo_resetIntegrator(a3_DemoIntegrator *integrator);
+
+	// advance all bodies by one step
+	int a3demo_stepIntegrator(a3_DemoIntegrator *integrator, a3_DemoBodyStore *bodies, const a3real dt);
+
+	// display name
+	const char *a3demo_getIntegratorName(const a3_DemoIntegratorType type);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOINTEGRATOR_H
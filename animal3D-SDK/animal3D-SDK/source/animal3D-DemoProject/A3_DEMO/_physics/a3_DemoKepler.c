@@ -0,0 +1,337 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoKepler.c
+	Kepler orbit implementations.
+*/
+
+#include "a3_DemoKepler.h"
+#include "../_utilities/a3_DemoTrig.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// array counts per orbit, grouped by element type
+enum a3_DemoKeplerInternal
+{
+	a3demo_keplerDoubleArrays = 2,
+	a3demo_keplerRealArrays = 14,
+	a3demo_keplerIndexArrays = 2,
+};
+
+static const double a3demo_keplerPi = 3.14159265358979323846;
+
+
+// move the last orbit into a slot
+void a3demo_keplerMoveOrbit(a3_DemoKeplerOrbits *orbits, const unsigned int index, const unsigned int last)
+{
+	double *arrD = orbits->meanMotion;
+	a3real *arrR = orbits->semiMajor;
+	unsigned int *arrI = orbits->body;
+	unsigned int j;
+
+	// arrays of each type sit back to back
+	for (j = 0; j < a3demo_keplerDoubleArrays; ++j, arrD += orbits->capacity)
+		arrD[index] = arrD[last];
+	for (j = 0; j < a3demo_keplerRealArrays; ++j, arrR += orbits->capacity)
+		arrR[index] = arrR[last];
+	for (j = 0; j < a3demo_keplerIndexArrays; ++j, arrI += orbits->capacity)
+		arrI[index] = arrI[last];
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createKeplerOrbits(a3_DemoKeplerOrbits *orbits, const unsigned int capacity)
+{
+	if (orbits && !orbits->memory && capacity)
+	{
+		// same padding and alignment as the body store; doubles go first so
+		//	every array stays aligned
+		const unsigned int padded = (capacity + a3demo_bodyStoreWidth - 1) / a3demo_bodyStoreWidth * a3demo_bodyStoreWidth;
+		const size_t totalSize = padded * (
+			sizeof(double) * a3demo_keplerDoubleArrays +
+			sizeof(a3real) * a3demo_keplerRealArrays +
+			sizeof(unsigned int) * a3demo_keplerIndexArrays) + a3demo_bodyStoreAlignment;
+		a3real *base;
+		size_t address;
+
+		orbits->memory = malloc(totalSize);
+		if (orbits->memory)
+		{
+			memset(orbits->memory, 0, totalSize);
+			address = ((size_t)orbits->memory + a3demo_bodyStoreAlignment - 1) & ~((size_t)a3demo_bodyStoreAlignment - 1);
+
+			orbits->meanMotion = (double *)address;
+			orbits->epoch = orbits->meanMotion + padded;
+			base = (a3real *)(orbits->epoch + padded);
+			orbits->semiMajor = base + padded * 0;
+			orbits->semiMinor = base + padded * 1;
+			orbits->eccentricity = base + padded * 2;
+			orbits->meanAnomaly = base + padded * 3;
+			orbits->periX = base + padded * 4;
+			orbits->periY = base + padded * 5;
+			orbits->periZ = base + padded * 6;
+			orbits->sideX = base + padded * 7;
+			orbits->sideY = base + padded * 8;
+			orbits->sideZ = base + padded * 9;
+			orbits->anomalyM = base + padded * 10;
+			orbits->anomalyE = base + padded * 11;
+			orbits->sinE = base + padded * 12;
+			orbits->cosE = base + padded * 13;
+			orbits->body = (unsigned int *)(base + padded * 14);
+			orbits->central = orbits->body + padded;
+			orbits->count = 0;
+			orbits->capacity = padded;
+			orbits->tolerance = 1.0e-6f;
+			orbits->iterations = 0;
+			return padded;
+		}
+	}
+	return -1;
+}
+
+int a3demo_releaseKeplerOrbits(a3_DemoKeplerOrbits *orbits)
+{
+	if (orbits && orbits->memory)
+	{
+		free(orbits->memory);
+		memset(orbits, 0, sizeof(a3_DemoKeplerOrbits));
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_addKeplerOrbit(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const unsigned int body, const unsigned int central, const a3real gravity, const double time)
+{
+	if (orbits && orbits->memory && bodies && bodies->memory &&
+		body < bodies->count && central < bodies->count && body != central &&
+		!(bodies->flags[body] & a3demo_bodyFlag_kepler) && orbits->count < orbits->capacity)
+	{
+		// relative state, worked in double since elements are kept forever
+		const double rx = bodies->posX[body] - bodies->posX[central];
+		const double ry = bodies->posY[body] - bodies->posY[central];
+		const double rz = bodies->posZ[body] - bodies->posZ[central];
+		const double vx = bodies->velX[body] - bodies->velX[central];
+		const double vy = bodies->velY[body] - bodies->velY[central];
+		const double vz = bodies->velZ[body] - bodies->velZ[central];
+		const double mu = (double)gravity * ((double)bodies->mass[central] + (double)bodies->mass[body]);
+		const double r = sqrt(rx * rx + ry * ry + rz * rz);
+		const double energy = (vx * vx + vy * vy + vz * vz) * 0.5 - mu / r;
+
+		// angular momentum and eccentricity vector
+		const double hx = ry * vz - rz * vy, hy = rz * vx - rx * vz, hz = rx * vy - ry * vx;
+		const double h = sqrt(hx * hx + hy * hy + hz * hz);
+		double ex = (vy * hz - vz * hy) / mu - rx / r;
+		double ey = (vz * hx - vx * hz) / mu - ry / r;
+		double ez = (vx * hy - vy * hx) / mu - rz / r;
+		const double e = sqrt(ex * ex + ey * ey + ez * ez);
+
+		double a, b, px, py, pz, qx, qy, qz, cosE, sinE, E;
+		unsigned int i;
+
+		// ellipses only; parabolic, hyperbolic and radial paths stay with
+		//	the integrator
+		if (r <= 0.0 || mu <= 0.0 || energy >= 0.0 || h <= 0.0 || e >= 1.0)
+			return -1;
+
+		// periapsis direction; circles have none, so start from the body
+		a = -mu / (2.0 * energy);
+		b = a * sqrt(1.0 - e * e);
+		if (e > 1.0e-9)
+		{
+			px = ex / e;
+			py = ey / e;
+			pz = ez / e;
+		}
+		else
+		{
+			px = rx / r;
+			py = ry / r;
+			pz = rz / r;
+		}
+		qx = (hy * pz - hz * py) / h;
+		qy = (hz * px - hx * pz) / h;
+		qz = (hx * py - hy * px) / h;
+
+		// eccentric anomaly from the position in the orbit plane:
+		//	x = a (cos E - e), y = b sin E
+		cosE = (rx * px + ry * py + rz * pz) / a + e;
+		sinE = (rx * qx + ry * qy + rz * qz) / b;
+		E = atan2(sinE, cosE);
+
+		i = orbits->count++;
+		orbits->meanMotion[i] = sqrt(mu / (a * a * a));
+		orbits->epoch[i] = time;
+		orbits->semiMajor[i] = (a3real)a;
+		orbits->semiMinor[i] = (a3real)b;
+		orbits->eccentricity[i] = (a3real)e;
+		orbits->meanAnomaly[i] = (a3real)(E - e * sin(E));
+		orbits->periX[i] = (a3real)px;
+		orbits->periY[i] = (a3real)py;
+		orbits->periZ[i] = (a3real)pz;
+		orbits->sideX[i] = (a3real)qx;
+		orbits->sideY[i] = (a3real)qy;
+		orbits->sideZ[i] = (a3real)qz;
+		orbits->body[i] = body;
+		orbits->central[i] = central;
+		bodies->flags[body] |= a3demo_bodyFlag_kepler;
+		return i;
+	}
+	return -1;
+}
+
+int a3demo_removeKeplerOrbit(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const unsigned int body)
+{
+	if (orbits && orbits->memory && bodies && bodies->memory)
+	{
+		unsigned int i;
+		for (i = 0; i < orbits->count; ++i)
+			if (orbits->body[i] == body)
+			{
+				a3demo_keplerMoveOrbit(orbits, i, --orbits->count);
+				if (body < bodies->count)
+					bodies->flags[body] &= ~a3demo_bodyFlag_kepler;
+				break;
+			}
+		return orbits->count;
+	}
+	return -1;
+}
+
+int a3demo_clearKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies)
+{
+	if (orbits && orbits->memory && bodies && bodies->memory)
+	{
+		unsigned int i;
+		for (i = 0; i < orbits->count; ++i)
+			if (orbits->body[i] < bodies->count)
+				bodies->flags[orbits->body[i]] &= ~a3demo_bodyFlag_kepler;
+		orbits->count = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_pruneKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies)
+{
+	if (orbits && orbits->memory && bodies && bodies->memory)
+	{
+		unsigned int i;
+
+		// swap-removal leaves a flagged body at a new index with no orbit,
+		//	so flags are rebuilt from what survives
+		for (i = 0; i < orbits->count; )
+		{
+			if (orbits->body[i] >= bodies->count || orbits->central[i] >= bodies->count)
+				a3demo_keplerMoveOrbit(orbits, i, --orbits->count);
+			else
+				++i;
+		}
+		for (i = 0; i < bodies->count; ++i)
+			bodies->flags[i] &= ~a3demo_bodyFlag_kepler;
+		for (i = 0; i < orbits->count; ++i)
+			bodies->flags[orbits->body[i]] |= a3demo_bodyFlag_kepler;
+		return orbits->count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_propagateKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const double time)
+{
+	if (orbits && orbits->memory && bodies && bodies->memory)
+	{
+		const unsigned int n = orbits->count;
+		const a3real *const e = orbits->eccentricity;
+		a3real *const M = orbits->anomalyM, *const E = orbits->anomalyE, *const S = orbits->sinE, *const C = orbits->cosE;
+		a3real f, error, r, x, y, vx, vy;
+		double m;
+		unsigned int i, j, k, pass;
+
+		// mean anomaly in double, wrapped to [-pi, pi] before dropping to
+		//	float, so precision does not depend on how far time has warped
+		for (i = 0; i < n; ++i)
+		{
+			m = (double)orbits->meanAnomaly[i] + orbits->meanMotion[i] * (time - orbits->epoch[i]);
+			m -= 2.0 * a3demo_keplerPi * floor(m / (2.0 * a3demo_keplerPi) + 0.5);
+			M[i] = (a3real)m;
+
+			// Danby's starting guess converges for any e < 1
+			E[i] = M[i] + 0.85f * e[i] * (M[i] < a3realZero ? -a3realOne : a3realOne);
+		}
+
+		// Newton on E - e sin E = M, one pass over every orbit at a time:
+		//	each pass is the same branch-free work per element, which keeps
+		//	the loop vectorizable; stop once the worst residual is small
+		// sine and cosine of every E come from one batched call per pass
+		for (pass = 0; pass < a3demo_keplerMaxIterations; )
+		{
+			error = a3realZero;
+			a3demo_sinCosrArray(S, C, E, n, a3demo_trig_full);
+			for (i = 0; i < n; ++i)
+			{
+				f = E[i] - e[i] * S[i] - M[i];
+				E[i] -= f / (a3realOne - e[i] * C[i]);
+				error = a3maximum(error, fabsf(f));
+			}
+			++pass;
+			if (error <= orbits->tolerance)
+				break;
+		}
+		orbits->iterations = pass;
+
+		// place bodies: perifocal position and velocity rotated into the
+		//	orbit plane and offset by the central body
+		a3demo_sinCosrArray(S, C, E, n, a3demo_trig_full);
+		for (i = 0; i < n; ++i)
+		{
+			r = (a3real)orbits->meanMotion[i] / (a3realOne - e[i] * C[i]);
+			x = orbits->semiMajor[i] * (C[i] - e[i]);
+			y = orbits->semiMinor[i] * S[i];
+			vx = -orbits->semiMajor[i] * S[i] * r;
+			vy = orbits->semiMinor[i] * C[i] * r;
+
+			j = orbits->body[i];
+			k = orbits->central[i];
+			bodies->posX[j] = bodies->posX[k] + x * orbits->periX[i] + y * orbits->sideX[i];
+			bodies->posY[j] = bodies->posY[k] + x * orbits->periY[i] + y * orbits->sideY[i];
+			bodies->posZ[j] = bodies->posZ[k] + x * orbits->periZ[i] + y * orbits->sideZ[i];
+			bodies->velX[j] = bodies->velX[k] + vx * orbits->periX[i] + vy * orbits->sideX[i];
+			bodies->velY[j] = bodies->velY[k] + vx * orbits->periY[i] + vy * orbits->sideY[i];
+			bodies->velZ[j] = bodies->velZ[k] + vx * orbits->periZ[i] + vy * orbits->sideZ[i];
+		}
+		return n;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoKepler.h
+	Closed-form two-body orbits: bodies on rails evaluated at any time.
+*/
+
+#ifndef __ANIMAL3D_DEMOKEPLER_H
+#define __ANIMAL3D_DEMOKEPLER_H
+
+
+#include "a3_DemoBodyStore.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoKeplerOrbits	a3_DemoKeplerOrbits;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// Kepler constants
+	enum a3_DemoKeplerConstants
+	{
+		a3demo_keplerMaxIterations = 16,	// Newton passes before giving up
+	};
+
+
+	// elliptic orbits, one per flagged body, stored like the body store
+	//	(one aligned array per element) so Kepler's equation is solved for
+	//	all of them in straight passes
+	// position at time t depends only on t and the elements, so cost per
+	//	body is constant no matter how far apart two evaluations are
+	struct a3_DemoKeplerOrbits
+	{
+		double *meanMotion;				// n = sqrt(mu / a^3), radians per second
+		double *epoch;					// time at which the elements were taken
+		a3real *semiMajor;				// a
+		a3real *semiMinor;				// b = a sqrt(1 - e^2)
+		a3real *eccentricity;			// e in [0, 1)
+		a3real *meanAnomaly;			// mean anomaly at epoch
+		a3real *periX, *periY, *periZ;	// unit vector toward periapsis
+		a3real *sideX, *sideY, *sideZ;	// unit vector 90 degrees ahead in the orbit plane
+		a3real *anomalyM, *anomalyE;	// mean and eccentric anomaly workspace
+		a3real *sinE, *cosE;			// sine and cosine of E workspace
+		unsigned int *body;				// body placed by this orbit
+		unsigned int *central;			// body it orbits
+		void *memory;					// single raw allocation for all arrays
+		unsigned int count;				// number of live orbits
+		unsigned int capacity;			// padded capacity
+
+		a3real tolerance;				// Newton stops when every residual is below this
+		unsigned int iterations;		// Newton passes taken by the last propagation
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// allocate room for at least the requested number of orbits
+	int a3demo_createKeplerOrbits(a3_DemoKeplerOrbits *orbits, const unsigned int capacity);
+	int a3demo_releaseKeplerOrbits(a3_DemoKeplerOrbits *orbits);
+
+	// put a body on rails around another using its current relative state;
+	//	mu is G times both masses; fails (-1) for unbound, radial or
+	//	already-flagged bodies, otherwise returns the orbit index
+	int a3demo_addKeplerOrbit(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const unsigned int body, const unsigned int central, const a3real gravity, const double time);
+
+	// hand a body back to the integrator; returns remaining count
+	int a3demo_removeKeplerOrbit(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const unsigned int body);
+
+	// hand every body back
+	int a3demo_clearKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies);
+
+	// drop orbits whose bodies were removed or moved, and reset all flags
+	//	to match; call after removing bodies from the store
+	int a3demo_pruneKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies);
+
+	// overwrite position and velocity of every orbiting body with the
+	//	exact solution at the given time (relative to its central body's
+	//	current state; central bodies on rails must have been added first)
+	int a3demo_propagateKeplerOrbits(a3_DemoKeplerOrbits *orbits, a3_DemoBodyStore *bodies, const double time);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOKEPLER_H
@@ -0,0 +1,470 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMassProperties.c
+	Mass property integration and analytic shapes.
+*/
+
+#include "a3_DemoMassProperties.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// cache record header: tag, version, then the structure as it is in memory
+enum a3_DemoMassPropertiesRecord
+{
+	a3demo_massRecordTag = 0x504d3341,	// "A3MP"
+	a3demo_massRecordVersion = 1,
+};
+
+// procedural descriptor parameter slots (see a3_DemoCollider.c)
+enum a3_DemoMassDescriptorParam
+{
+	a3demo_massParam_radius = 0,		// sphere, capsule, cylinder, cone
+	a3demo_massParam_length = 2,		// capsule body, cylinder, cone
+	a3demo_massParam_width = 0,			// box x
+	a3demo_massParam_height = 1,		// box y
+	a3demo_massParam_depth = 2,			// box z
+};
+
+
+// index of the n-th vertex the mesh draws
+inline unsigned int a3demo_massMeshIndex(const a3_GeometryData *geom, const unsigned int n)
+{
+	if (geom->indexData)
+		switch (geom->indexFormat->indexSize)
+		{
+		case 1:
+			return ((const unsigned char *)geom->indexData)[n];
+		case 2:
+			return ((const unsigned short *)geom->indexData)[n];
+		case 4:
+			return ((const unsigned int *)geom->indexData)[n];
+		}
+	return n;
+}
+
+// corners of the n-th triangle the mesh draws; strips flip every other
+//	triangle so they all wind the same way
+// returns 1 if the mesh has that triangle
+inline int a3demo_massMeshTriangle(unsigned int *corner_out, const a3_GeometryData *geom, const unsigned int n)
+{
+	const unsigned int count = geom->indexData ? geom->numIndices : geom->numVertices;
+	switch (geom->primType)
+	{
+	case a3prim_triangles:
+		if (n * 3 + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_massMeshIndex(geom, n * 3 + 0);
+		corner_out[1] = a3demo_massMeshIndex(geom, n * 3 + 1);
+		corner_out[2] = a3demo_massMeshIndex(geom, n * 3 + 2);
+		return 1;
+	case a3prim_triangleStrip:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_massMeshIndex(geom, n + (n & 1));
+		corner_out[1] = a3demo_massMeshIndex(geom, n + 1 - (n & 1));
+		corner_out[2] = a3demo_massMeshIndex(geom, n + 2);
+		return 1;
+	case a3prim_triangleFan:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_massMeshIndex(geom, 0);
+		corner_out[1] = a3demo_massMeshIndex(geom, n + 1);
+		corner_out[2] = a3demo_massMeshIndex(geom, n + 2);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+// solid of revolution or box about its center: diagonal moments, center
+//	on the signed axis, then principal frame
+inline void a3demo_massSetDiagonal(a3_DemoMassProperties *props, const a3real volume, const a3real density, const a3real *momentPerMass, const unsigned int axis, const a3real center)
+{
+	memset(props, 0, sizeof(a3_DemoMassProperties));
+	props->volume = volume;
+	props->mass = volume * density;
+	props->center[axis] = center;
+	props->inertia[0][0] = props->mass * momentPerMass[0];
+	props->inertia[1][1] = props->mass * momentPerMass[1];
+	props->inertia[2][2] = props->mass * momentPerMass[2];
+	a3demo_updateMassPropertiesPrincipal(props);
+}
+
+// long axis index and sign of a procedural axis
+inline unsigned int a3demo_massAxis(const a3_ProceduralGeometryDescriptor *geom, a3real *sign_out)
+{
+	const int axis = a3proceduralGetDescriptorAxis(geom);
+	*sign_out = a3realOne;
+	switch (axis)
+	{
+	case a3geomAxis_x: case a3geomAxis_y: case a3geomAxis_z:
+		return (unsigned int)(axis - a3geomAxis_x);
+	case a3geomAxis_x_negative: case a3geomAxis_y_negative: case a3geomAxis_z_negative:
+		*sign_out = -a3realOne;
+		return (unsigned int)(axis - a3geomAxis_x_negative);
+	}
+	return 2;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_computeMassPropertiesMesh(a3_DemoMassProperties *props_out, const a3_GeometryData *geom, const a3real density)
+{
+	if (props_out && geom && geom->attribData[a3attrib_geomPosition] && density > a3realZero)
+	{
+		const float *const vertex = (const float *)geom->attribData[a3attrib_geomPosition];
+		double volume6 = 0.0, first[3] = { 0.0 }, second[3][3] = { { 0.0 } }, area[3] = { 0.0 };
+		double center[3], volume, trace, det, s[3], e0[3], e1[3];
+		float lo[3], hi[3];
+		const float *v[3];
+		a3real ref[3];
+		unsigned int corner[3], n, i, j, k;
+
+		memset(props_out, 0, sizeof(a3_DemoMassProperties));
+		if (!geom->numVertices)
+			return 0;
+
+		// reference point in the middle of the bounds keeps the numbers
+		//	small, and is where holes get capped from
+		lo[0] = hi[0] = vertex[0];
+		lo[1] = hi[1] = vertex[1];
+		lo[2] = hi[2] = vertex[2];
+		for (i = 1; i < geom->numVertices; ++i)
+			for (k = 0; k < 3; ++k)
+			{
+				lo[k] = a3minimum(lo[k], vertex[i * 3 + k]);
+				hi[k] = a3maximum(hi[k], vertex[i * 3 + k]);
+			}
+		for (k = 0; k < 3; ++k)
+			ref[k] = (lo[k] + hi[k]) * a3realHalf;
+
+		// each triangle and the reference point form a tetrahedron; its
+		//	signed volume is det / 6, its first moment det (a + b + c) / 24,
+		//	and its second moment det / 120 (aa' + bb' + cc' + ss') with s
+		//	the sum of the corners; they sum to the solid's
+		for (n = 0; a3demo_massMeshTriangle(corner, geom, n); ++n)
+		{
+			double p[3][3];
+			for (i = 0; i < 3; ++i)
+			{
+				if (corner[i] >= geom->numVertices)
+					break;
+				v[i] = vertex + corner[i] * 3;
+				p[i][0] = (double)v[i][0] - (double)ref[0];
+				p[i][1] = (double)v[i][1] - (double)ref[1];
+				p[i][2] = (double)v[i][2] - (double)ref[2];
+			}
+			if (i < 3)
+				continue;
+
+			det = p[0][0] * (p[1][1] * p[2][2] - p[1][2] * p[2][1])
+				- p[0][1] * (p[1][0] * p[2][2] - p[1][2] * p[2][0])
+				+ p[0][2] * (p[1][0] * p[2][1] - p[1][1] * p[2][0]);
+			for (k = 0; k < 3; ++k)
+				s[k] = p[0][k] + p[1][k] + p[2][k];
+			volume6 += det;
+			for (k = 0; k < 3; ++k)
+				first[k] += det * s[k];
+			for (i = 0; i < 3; ++i)
+				for (j = i; j < 3; ++j)
+					second[i][j] += det * (p[0][i] * p[0][j] + p[1][i] * p[1][j] + p[2][i] * p[2][j] + s[i] * s[j]);
+
+			// twice the vector area; cancels out over a closed surface
+			for (k = 0; k < 3; ++k)
+			{
+				e0[k] = p[1][k] - p[0][k];
+				e1[k] = p[2][k] - p[0][k];
+			}
+			area[0] += e0[1] * e1[2] - e0[2] * e1[1];
+			area[1] += e0[2] * e1[0] - e0[0] * e1[2];
+			area[2] += e0[0] * e1[1] - e0[1] * e1[0];
+		}
+		props_out->triangleCount = n;
+		props_out->openArea = (a3real)(0.5 * sqrt(area[0] * area[0] + area[1] * area[1] + area[2] * area[2]));
+
+		// inward winding flips every sign
+		if (volume6 < 0.0)
+		{
+			volume6 = -volume6;
+			for (i = 0; i < 3; ++i)
+			{
+				first[i] = -first[i];
+				for (j = i; j < 3; ++j)
+					second[i][j] = -second[i][j];
+			}
+		}
+		if (volume6 <= 0.0)
+			return 0;
+
+		// center, then second moment moved there from the reference point
+		volume = volume6 / 6.0;
+		for (k = 0; k < 3; ++k)
+			center[k] = first[k] / 24.0 / volume;
+		for (i = 0; i < 3; ++i)
+			for (j = i; j < 3; ++j)
+				second[i][j] = second[i][j] / 120.0 - volume * center[i] * center[j];
+
+		// inertia is trace(C) - C, times density
+		trace = second[0][0] + second[1][1] + second[2][2];
+		for (i = 0; i < 3; ++i)
+			for (j = i; j < 3; ++j)
+				props_out->inertia[i][j] = props_out->inertia[j][i] =
+					(a3real)((double)density * ((i == j ? trace : 0.0) - second[i][j]));
+		props_out->volume = (a3real)volume;
+		props_out->mass = (a3real)volume * density;
+		for (k = 0; k < 3; ++k)
+			props_out->center[k] = ref[k] + (a3real)center[k];
+		a3demo_updateMassPropertiesPrincipal(props_out);
+		return n;
+	}
+	return -1;
+}
+
+int a3demo_computeMassPropertiesDescriptor(a3_DemoMassProperties *props_out, const a3_ProceduralGeometryDescriptor *geom, const a3real density)
+{
+	if (props_out && geom && density > a3realZero)
+	{
+		const float *param = geom->fParams;
+		const a3real pi = a3realPi;
+		a3real r, r2, l, sign, volume, moment[3], cylinder, caps;
+		unsigned int axis;
+
+		switch (geom->shape)
+		{
+		case a3geomShape_sphere:
+			r = param[a3demo_massParam_radius];
+			moment[0] = moment[1] = moment[2] = 0.4f * r * r;
+			a3demo_massSetDiagonal(props_out, 4.0f / 3.0f * pi * r * r * r, density, moment, 2, a3realZero);
+			return 1;
+
+		case a3geomShape_box:
+		{
+			const a3real w = param[a3demo_massParam_width], h = param[a3demo_massParam_height], d = param[a3demo_massParam_depth];
+			moment[0] = (h * h + d * d) / 12.0f;
+			moment[1] = (w * w + d * d) / 12.0f;
+			moment[2] = (w * w + h * h) / 12.0f;
+			a3demo_massSetDiagonal(props_out, w * h * d, density, moment, 2, a3realZero);
+		}	return 1;
+
+			// long shapes start at the mesh origin and extend along the
+			//	signed axis; cones have their base there
+		case a3geomShape_cylinder:
+			axis = a3demo_massAxis(geom, &sign);
+			r = param[a3demo_massParam_radius];
+			l = param[a3demo_massParam_length];
+			r2 = r * r;
+			moment[0] = moment[1] = moment[2] = (3.0f * r2 + l * l) / 12.0f;
+			moment[axis] = a3realHalf * r2;
+			a3demo_massSetDiagonal(props_out, pi * r2 * l, density, moment, axis, sign * l * a3realHalf);
+			return 1;
+
+		case a3geomShape_cone:
+			axis = a3demo_massAxis(geom, &sign);
+			r = param[a3demo_massParam_radius];
+			l = param[a3demo_massParam_length];
+			r2 = r * r;
+			moment[0] = moment[1] = moment[2] = 0.15f * r2 + 0.0375f * l * l;
+			moment[axis] = 0.3f * r2;
+			a3demo_massSetDiagonal(props_out, pi * r2 * l / 3.0f, density, moment, axis, sign * l * 0.25f);
+			return 1;
+
+			// body plus two hemispheres: each cap's own center sits 3r/8
+			//	out from its flat face, with 83/320 m r^2 about it laterally
+		case a3geomShape_capsule:
+			axis = a3demo_massAxis(geom, &sign);
+			r = param[a3demo_massParam_radius];
+			l = param[a3demo_massParam_length];
+			r2 = r * r;
+			cylinder = pi * r2 * l;
+			caps = 4.0f / 3.0f * pi * r2 * r;
+			volume = cylinder + caps;
+			moment[0] = moment[1] = moment[2] = (cylinder * (l * l / 12.0f + r2 * 0.25f) +
+				caps * (83.0f / 320.0f * r2 + (l * a3realHalf + 0.375f * r) * (l * a3realHalf + 0.375f * r))) / volume;
+			moment[axis] = (cylinder * a3realHalf * r2 + caps * 0.4f * r2) / volume;
+			a3demo_massSetDiagonal(props_out, volume, density, moment, axis, sign * l * a3realHalf);
+			return 1;
+
+		default:
+			return 0;
+		}
+	}
+	return -1;
+}
+
+int a3demo_computeMassPropertiesProcedural(a3_DemoMassProperties *props_out, const a3_ProceduralGeometryDescriptor *geom, const a3real density)
+{
+	int result = a3demo_computeMassPropertiesDescriptor(props_out, geom, density);
+	if (!result)
+	{
+		a3_GeometryData data[1] = { 0 };
+		if (a3proceduralGenerateGeometryData(data, geom) > 0)
+		{
+			result = a3demo_computeMassPropertiesMesh(props_out, data, density);
+			a3geometryReleaseData(data);
+		}
+	}
+	return result;
+}
+
+int a3demo_setMassPropertiesDensity(a3_DemoMassProperties *props, const a3real density)
+{
+	if (props && props->volume > a3realZero && props->mass > a3realZero && density > a3realZero)
+	{
+		const a3real scale = density * props->volume / props->mass;
+		unsigned int i, j;
+		props->mass *= scale;
+		for (i = 0; i < 3; ++i)
+		{
+			props->moment[i] *= scale;
+			for (j = 0; j < 3; ++j)
+				props->inertia[i][j] *= scale;
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_updateMassPropertiesPrincipal(a3_DemoMassProperties *props)
+{
+	if (props)
+	{
+		// cyclic Jacobi: rotate away the largest off-diagonal terms until
+		//	there are none left; three by three converges in a few sweeps
+		double a[3][3], v[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+		double theta, t, c, s, apq, app, aqq, tmp, scale;
+		unsigned int sweep, p, q, k, order[3] = { 0, 1, 2 };
+
+		for (p = 0; p < 3; ++p)
+			for (q = 0; q < 3; ++q)
+				a[p][q] = (double)props->inertia[p][q];
+		scale = fabs(a[0][0]) + fabs(a[1][1]) + fabs(a[2][2]);
+
+		for (sweep = 0; sweep < 16; ++sweep)
+		{
+			if (fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]) <= scale * 1.0e-12)
+				break;
+			for (p = 0; p < 2; ++p)
+				for (q = p + 1; q < 3; ++q)
+				{
+					apq = a[p][q];
+					if (apq == 0.0)
+						continue;
+					app = a[p][p];
+					aqq = a[q][q];
+					theta = (aqq - app) / (2.0 * apq);
+					t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+					c = 1.0 / sqrt(t * t + 1.0);
+					s = t * c;
+
+					// A' = J' A J and V' = V J with J the rotation in p, q
+					for (k = 0; k < 3; ++k)
+					{
+						tmp = a[k][p];
+						a[k][p] = c * tmp - s * a[k][q];
+						a[k][q] = s * tmp + c * a[k][q];
+					}
+					for (k = 0; k < 3; ++k)
+					{
+						tmp = a[p][k];
+						a[p][k] = c * tmp - s * a[q][k];
+						a[q][k] = s * tmp + c * a[q][k];
+					}
+					for (k = 0; k < 3; ++k)
+					{
+						tmp = v[k][p];
+						v[k][p] = c * tmp - s * v[k][q];
+						v[k][q] = s * tmp + c * v[k][q];
+					}
+				}
+		}
+
+		// ascending moments; columns of v are the axes
+		for (p = 0; p < 2; ++p)
+			for (q = p + 1; q < 3; ++q)
+				if (a[order[q]][order[q]] < a[order[p]][order[p]])
+				{
+					k = order[p];
+					order[p] = order[q];
+					order[q] = k;
+				}
+		for (p = 0; p < 3; ++p)
+		{
+			props->moment[p] = (a3real)a[order[p]][order[p]];
+			for (k = 0; k < 3; ++k)
+				props->axes[p][k] = (a3real)v[k][order[p]];
+		}
+
+		// keep it a rotation
+		if (props->axes[0][0] * (props->axes[1][1] * props->axes[2][2] - props->axes[1][2] * props->axes[2][1]) -
+			props->axes[0][1] * (props->axes[1][0] * props->axes[2][2] - props->axes[1][2] * props->axes[2][0]) +
+			props->axes[0][2] * (props->axes[1][0] * props->axes[2][1] - props->axes[1][1] * props->axes[2][0]) < a3realZero)
+		{
+			props->axes[2][0] = -props->axes[2][0];
+			props->axes[2][1] = -props->axes[2][1];
+			props->axes[2][2] = -props->axes[2][2];
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_saveMassPropertiesBinary(const a3_DemoMassProperties *props, const a3_FileStream *fileStream)
+{
+	if (props && fileStream && fileStream->stream)
+	{
+		FILE *const fp = (FILE *)fileStream->stream;
+		const unsigned int header[2] = { a3demo_massRecordTag, a3demo_massRecordVersion };
+		int bytes = 0;
+		bytes += (int)fwrite(header, 1, sizeof(header), fp);
+		bytes += (int)fwrite(props, 1, sizeof(a3_DemoMassProperties), fp);
+		return bytes;
+	}
+	return -1;
+}
+
+int a3demo_loadMassPropertiesBinary(a3_DemoMassProperties *props_out, const a3_FileStream *fileStream)
+{
+	if (props_out && fileStream && fileStream->stream)
+	{
+		FILE *const fp = (FILE *)fileStream->stream;
+		unsigned int header[2] = { 0 };
+		int bytes = (int)fread(header, 1, sizeof(header), fp);
+		if (bytes != sizeof(header) || header[0] != a3demo_massRecordTag || header[1] != a3demo_massRecordVersion)
+			return 0;
+		if (fread(props_out, 1, sizeof(a3_DemoMassProperties), fp) != sizeof(a3_DemoMassProperties))
+		{
+			memset(props_out, 0, sizeof(a3_DemoMassProperties));
+			return 0;
+		}
+		return bytes + (int)sizeof(a3_DemoMassProperties);
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
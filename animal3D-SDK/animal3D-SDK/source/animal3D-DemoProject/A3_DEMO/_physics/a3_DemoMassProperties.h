@@ -0,0 +1,114 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMassProperties.h
+	Mass, center of mass and inertia tensor of solid shapes, from triangle
+		meshes or procedural descriptors, with a binary form for caching.
+*/
+
+#ifndef __ANIMAL3D_DEMOMASSPROPERTIES_H
+#define __ANIMAL3D_DEMOMASSPROPERTIES_H
+
+
+#include "animal3D/a3math/A3DM.h"
+#include "animal3D/a3graphics/a3geometry/a3_GeometryData.h"
+#include "animal3D/a3graphics/a3geometry/a3_ProceduralGeometry.h"
+#include "animal3D/a3utility/a3_Stream.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoMassProperties	a3_DemoMassProperties;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// mass properties of a solid of uniform density, in the frame of the
+	//	mesh or shape it came from
+	// the inertia tensor is about the center of mass along the mesh axes;
+	//	the principal moments are its eigenvalues (ascending) and the
+	//	principal axes the matching columns, forming a rotation from the
+	//	principal frame to the mesh frame
+	struct a3_DemoMassProperties
+	{
+		a3real mass;
+		a3real volume;
+		a3real3 center;					// center of mass from the mesh origin
+		a3real3x3 inertia;				// about the center, mesh axes (symmetric)
+		a3real3 moment;					// principal moments
+		a3real3x3 axes;					// principal axes as columns
+		a3real openArea;				// length of the surface's vector area: zero
+										//	if closed, roughly the area of any holes
+		unsigned int triangleCount;		// triangles integrated, zero if analytic
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// integrate over the triangles of geometry data (positions, indexed or
+	//	not, as triangles, strips or fans) by the divergence theorem; the
+	//	surface should be closed, and may wind either way
+	// open surfaces come out as if each hole were capped by a fan from the
+	//	middle of the mesh's bounds; openArea says how much that mattered
+	//	-> returns triangle count, 0 if the mesh encloses no volume, -1 if
+	//		invalid params
+	int a3demo_computeMassPropertiesMesh(a3_DemoMassProperties *props_out, const a3_GeometryData *geom, const a3real density);
+
+	// exact properties of the ideal shape a procedural descriptor
+	//	approximates (sphere, box, cylinder, cone, capsule), placed as the
+	//	procedural generator places it
+	//	-> returns 1, 0 for shapes with no analytic form here (use the mesh
+	//		instead), -1 if invalid params
+	int a3demo_computeMassPropertiesDescriptor(a3_DemoMassProperties *props_out, const a3_ProceduralGeometryDescriptor *geom, const a3real density);
+
+	// analytic form if there is one, else generate the geometry and
+	//	integrate it
+	//	-> returns 1 if analytic, triangle count if integrated, 0 if the
+	//		shape encloses no volume, -1 if invalid params
+	int a3demo_computeMassPropertiesProcedural(a3_DemoMassProperties *props_out, const a3_ProceduralGeometryDescriptor *geom, const a3real density);
+
+	// same properties for a different density (scales mass and inertia)
+	int a3demo_setMassPropertiesDensity(a3_DemoMassProperties *props, const a3real density);
+
+	// fill in the principal moments and axes from the inertia tensor
+	int a3demo_updateMassPropertiesPrincipal(a3_DemoMassProperties *props);
+
+	// file stream functions, in the same form as a3geometrySaveDataBinary
+	//	and a3geometryLoadDataBinary, so the results can ride along in a
+	//	geometry cache; loading fails (returns 0) on anything that is not a
+	//	record of this version, so a cache from before is simply recomputed
+	int a3demo_saveMassPropertiesBinary(const a3_DemoMassProperties *props, const a3_FileStream *fileStream);
+	int a3demo_loadMassPropertiesBinary(a3_DemoMassProperties *props_out, const a3_FileStream *fileStream);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOMASSPROPERTIES_H
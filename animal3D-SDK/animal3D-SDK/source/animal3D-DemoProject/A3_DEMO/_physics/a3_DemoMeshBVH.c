@@ -0,0 +1,1093 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMeshBVH.c
+	Triangle BVH build and queries.
+*/
+
+#include "a3_DemoMeshBVH.h"
+#include "../_utilities/a3_DemoSIMDLane.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+
+// packet lanes: eight wide where the shared selection picked AVX,
+//	otherwise its four-wide lanes
+#if defined(A3_SIMD_AVX)
+typedef __m256 a3_DemoMeshBVHLane;
+#define a3demo_bvhWidth					8
+#define a3demo_laneSet(x)				_mm256_set1_ps(x)
+#define a3demo_laneSetBits(x)			_mm256_castsi256_ps(_mm256_set1_epi32(x))
+#define a3demo_laneLoad(p)				_mm256_loadu_ps(p)
+#define a3demo_laneStore(p, a)			_mm256_storeu_ps(p, a)
+#define a3demo_laneAdd(a, b)			_mm256_add_ps(a, b)
+#define a3demo_laneSub(a, b)			_mm256_sub_ps(a, b)
+#define a3demo_laneMul(a, b)			_mm256_mul_ps(a, b)
+#define a3demo_laneDiv(a, b)			_mm256_div_ps(a, b)
+#define a3demo_laneMin(a, b)			_mm256_min_ps(a, b)
+#define a3demo_laneMax(a, b)			_mm256_max_ps(a, b)
+#define a3demo_laneAnd(a, b)			_mm256_and_ps(a, b)
+#define a3demo_laneLess(a, b)			_mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define a3demo_laneLessEqual(a, b)		_mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define a3demo_laneSelect(m, a, b)		_mm256_blendv_ps(b, a, m)
+#define a3demo_laneAny(m)				_mm256_movemask_ps(m)
+#elif defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+typedef a3_DemoSIMDLane a3_DemoMeshBVHLane;
+#define a3demo_bvhWidth					4
+#define a3demo_laneSet(x)				a3demo_simdSet(x)
+#define a3demo_laneSetBits(x)			a3demo_simdSetBits(x)
+#define a3demo_laneLoad(p)				a3demo_simdLoad(p)
+#define a3demo_laneStore(p, a)			a3demo_simdStore(p, a)
+#define a3demo_laneAdd(a, b)			a3demo_simdAdd(a, b)
+#define a3demo_laneSub(a, b)			a3demo_simdSub(a, b)
+#define a3demo_laneMul(a, b)			a3demo_simdMul(a, b)
+#define a3demo_laneDiv(a, b)			a3demo_simdDiv(a, b)
+#define a3demo_laneMin(a, b)			a3demo_simdMin(a, b)
+#define a3demo_laneMax(a, b)			a3demo_simdMax(a, b)
+#define a3demo_laneAnd(a, b)			a3demo_simdAnd(a, b)
+#define a3demo_laneLess(a, b)			a3demo_simdLess(a, b)
+#define a3demo_laneLessEqual(a, b)		a3demo_simdLessEqual(a, b)
+#define a3demo_laneSelect(m, a, b)		a3demo_simdSelect(m, a, b)
+#define a3demo_laneAny(m)				a3demo_simdAny(m)
+#else
+#define a3demo_bvhWidth					1
+#endif
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// build node: children by index in the scratch array, zero for leaves
+//	(the root is nobody's child); a range of n triangles owns 2n - 1
+//	slots starting at its node, left subtree first, so subtrees can be
+//	built at the same time without sharing anything
+typedef struct a3_DemoMeshBVHBuildNode
+{
+	float boundsMin[3], boundsMax[3];
+	unsigned int first, count, left, right, depth;
+} a3_DemoMeshBVHBuildNode;
+
+// subtree left for a job
+typedef struct a3_DemoMeshBVHTask
+{
+	unsigned int node, first, count, depth;
+} a3_DemoMeshBVHTask;
+
+typedef struct a3_DemoMeshBVHBuild
+{
+	a3_DemoMeshBVHBuildNode *node;
+	a3_DemoMeshBVHTask *task;
+	unsigned int *order;			// triangles, partitioned in place
+	float *box;						// bounds per triangle, min then max
+	float *centroid;				// box center per triangle
+	const float *position;
+	const unsigned int *index;
+	unsigned int taskCount;
+} a3_DemoMeshBVHBuild;
+
+// SAH bin
+typedef struct a3_DemoMeshBVHBin
+{
+	float boundsMin[3], boundsMax[3];
+	unsigned int count;
+} a3_DemoMeshBVHBin;
+
+// ray as the slab test wants it
+typedef struct a3_DemoMeshRay
+{
+	float origin[3], direction[3], invDirection[3];
+} a3_DemoMeshRay;
+
+
+// corner k of triangle t in the source
+inline const float *a3demo_meshBVHCorner(const a3_DemoMeshBVHBuild *build, const unsigned int t, const unsigned int k)
+{
+	return build->position + (build->index ? build->index[t * 3 + k] : t * 3 + k) * 3;
+}
+
+inline void a3demo_meshBVHBoundsReset(float *boundsMin, float *boundsMax)
+{
+	boundsMin[0] = boundsMin[1] = boundsMin[2] = +FLT_MAX;
+	boundsMax[0] = boundsMax[1] = boundsMax[2] = -FLT_MAX;
+}
+
+inline void a3demo_meshBVHBoundsGrow(float *boundsMin, float *boundsMax, const float *lo, const float *hi)
+{
+	boundsMin[0] = a3minimum(boundsMin[0], lo[0]);
+	boundsMin[1] = a3minimum(boundsMin[1], lo[1]);
+	boundsMin[2] = a3minimum(boundsMin[2], lo[2]);
+	boundsMax[0] = a3maximum(boundsMax[0], hi[0]);
+	boundsMax[1] = a3maximum(boundsMax[1], hi[1]);
+	boundsMax[2] = a3maximum(boundsMax[2], hi[2]);
+}
+
+// half the surface area; only ratios matter
+inline float a3demo_meshBVHArea(const float *boundsMin, const float *boundsMax)
+{
+	const float x = boundsMax[0] - boundsMin[0], y = boundsMax[1] - boundsMin[1], z = boundsMax[2] - boundsMin[2];
+	return (x < 0.0f) ? 0.0f : (x * y + y * z + z * x);
+}
+
+// bin of a centroid coordinate; the same expression sorts and partitions
+inline unsigned int a3demo_meshBVHBinOf(const float c, const float lo, const float scale)
+{
+	const unsigned int b = (unsigned int)((c - lo) * scale);
+	return b < a3demo_meshBVHBins ? b : a3demo_meshBVHBins - 1;
+}
+
+// triangle bounds, centroids and the starting order
+void a3demo_meshBVHBoundsJob(a3_DemoMeshBVHBuild *build, const unsigned int first, const unsigned int count)
+{
+	const float *v;
+	float *box, *centroid;
+	unsigned int i, k, end = first + count;
+	for (i = first; i < end; ++i)
+	{
+		box = build->box + i * 6;
+		centroid = build->centroid + i * 3;
+		a3demo_meshBVHBoundsReset(box, box + 3);
+		for (k = 0; k < 3; ++k)
+		{
+			v = a3demo_meshBVHCorner(build, i, k);
+			a3demo_meshBVHBoundsGrow(box, box + 3, v, v);
+		}
+		centroid[0] = (box[0] + box[3]) * 0.5f;
+		centroid[1] = (box[1] + box[4]) * 0.5f;
+		centroid[2] = (box[2] + box[5]) * 0.5f;
+		build->order[i] = i;
+	}
+}
+
+// build the subtree over a range: bounds, then the cheapest of the binned
+//	splits on each axis by the surface area heuristic, or a leaf if that
+//	is cheaper still (and the range small enough); with spawn set, small
+//	ranges are left as tasks instead
+void a3demo_meshBVHSplit(a3_DemoMeshBVHBuild *build, const unsigned int nodeIndex, const unsigned int first, const unsigned int count, const unsigned int depth, const int spawn)
+{
+	a3_DemoMeshBVHBuildNode *node = build->node + nodeIndex;
+	a3_DemoMeshBVHBin bin[a3demo_meshBVHBins];
+	float centroidMin[3], centroidMax[3], scale = 0.0f, bestScale = 0.0f, lo[3], hi[3];
+	float leftArea[a3demo_meshBVHBins], area, cost, bestCost = FLT_MAX;
+	unsigned int leftCount[a3demo_meshBVHBins], axis, bestAxis = 0, bestBin = 0, i, k, b, n, t, end = first + count;
+	const float *c;
+
+	if (spawn && count <= a3demo_meshBVHTaskSize)
+	{
+		build->task[build->taskCount].node = nodeIndex;
+		build->task[build->taskCount].first = first;
+		build->task[build->taskCount].count = count;
+		build->task[build->taskCount].depth = depth;
+		++build->taskCount;
+		return;
+	}
+
+	node->first = first;
+	node->count = count;
+	node->left = node->right = 0;
+	node->depth = depth;
+	a3demo_meshBVHBoundsReset(node->boundsMin, node->boundsMax);
+	a3demo_meshBVHBoundsReset(centroidMin, centroidMax);
+	for (i = first; i < end; ++i)
+	{
+		t = build->order[i];
+		a3demo_meshBVHBoundsGrow(node->boundsMin, node->boundsMax, build->box + t * 6, build->box + t * 6 + 3);
+		a3demo_meshBVHBoundsGrow(centroidMin, centroidMax, build->centroid + t * 3, build->centroid + t * 3);
+	}
+	if (count <= 1 || depth >= a3demo_meshBVHMaxDepth)
+		return;
+
+	for (axis = 0; axis < 3; ++axis)
+	{
+		if (centroidMax[axis] <= centroidMin[axis])
+			continue;
+		scale = (float)a3demo_meshBVHBins / (centroidMax[axis] - centroidMin[axis]);
+		for (b = 0; b < a3demo_meshBVHBins; ++b)
+		{
+			a3demo_meshBVHBoundsReset(bin[b].boundsMin, bin[b].boundsMax);
+			bin[b].count = 0;
+		}
+		for (i = first; i < end; ++i)
+		{
+			t = build->order[i];
+			b = a3demo_meshBVHBinOf(build->centroid[t * 3 + axis], centroidMin[axis], scale);
+			a3demo_meshBVHBoundsGrow(bin[b].boundsMin, bin[b].boundsMax, build->box + t * 6, build->box + t * 6 + 3);
+			++bin[b].count;
+		}
+
+		// sweep from the left, then from the right, pricing each split
+		a3demo_meshBVHBoundsReset(lo, hi);
+		for (b = 0, n = 0; b < a3demo_meshBVHBins - 1; ++b)
+		{
+			a3demo_meshBVHBoundsGrow(lo, hi, bin[b].boundsMin, bin[b].boundsMax);
+			n += bin[b].count;
+			leftArea[b] = a3demo_meshBVHArea(lo, hi);
+			leftCount[b] = n;
+		}
+		a3demo_meshBVHBoundsReset(lo, hi);
+		for (b = a3demo_meshBVHBins - 1, n = 0; b > 0; --b)
+		{
+			a3demo_meshBVHBoundsGrow(lo, hi, bin[b].boundsMin, bin[b].boundsMax);
+			n += bin[b].count;
+			if (!n || !leftCount[b - 1])
+				continue;
+			cost = leftArea[b - 1] * (float)leftCount[b - 1] + a3demo_meshBVHArea(lo, hi) * (float)n;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b - 1;
+				bestScale = scale;
+			}
+		}
+	}
+
+	// leaf if it is cheaper than a traversal step plus both children
+	area = a3demo_meshBVHArea(node->boundsMin, node->boundsMax);
+	if (bestCost == FLT_MAX)
+	{
+		// centroids all in one place: any halving will do
+		if (count <= a3demo_meshBVHLeafMax)
+			return;
+		n = count / 2;
+	}
+	else
+	{
+		if (count <= a3demo_meshBVHLeafMax && area + bestCost >= area * (float)count)
+			return;
+		for (i = first, k = end; i < k; )
+		{
+			t = build->order[i];
+			c = build->centroid + t * 3;
+			if (a3demo_meshBVHBinOf(c[bestAxis], centroidMin[bestAxis], bestScale) <= bestBin)
+				++i;
+			else
+			{
+				build->order[i] = build->order[--k];
+				build->order[k] = t;
+			}
+		}
+		n = i - first;
+	}
+
+	node->left = nodeIndex + 1;
+	node->right = nodeIndex + n * 2;
+	a3demo_meshBVHSplit(build, node->left, first, n, depth + 1, spawn);
+	a3demo_meshBVHSplit(build, node->right, first + n, count - n, depth + 1, spawn);
+}
+
+// subtrees left as tasks
+void a3demo_meshBVHTaskJob(a3_DemoMeshBVHBuild *build, const unsigned int first, const unsigned int count)
+{
+	const a3_DemoMeshBVHTask *task = build->task + first, *const end = task + count;
+	for (; task < end; ++task)
+		a3demo_meshBVHSplit(build, task->node, task->first, task->count, task->depth, 0);
+}
+
+// nodes in a built subtree
+unsigned int a3demo_meshBVHCount(const a3_DemoMeshBVHBuild *build, const unsigned int nodeIndex)
+{
+	const a3_DemoMeshBVHBuildNode *node = build->node + nodeIndex;
+	return node->left ? (1 + a3demo_meshBVHCount(build, node->left) + a3demo_meshBVHCount(build, node->right)) : 1;
+}
+
+// copy a subtree into the final array depth-first, closing its gaps
+//	-> returns where the subtree's root went
+unsigned int a3demo_meshBVHFlatten(a3_DemoMeshBVH *bvh, const a3_DemoMeshBVHBuild *build, const unsigned int nodeIndex)
+{
+	const a3_DemoMeshBVHBuildNode *in = build->node + nodeIndex;
+	const unsigned int i = bvh->nodeCount++;
+	a3_DemoMeshBVHNode *out = bvh->node + i;
+
+	memcpy(out->boundsMin, in->boundsMin, sizeof(out->boundsMin));
+	memcpy(out->boundsMax, in->boundsMax, sizeof(out->boundsMax));
+	if (in->left)
+	{
+		out->count = 0;
+		a3demo_meshBVHFlatten(bvh, build, in->left);
+		out->index = a3demo_meshBVHFlatten(bvh, build, in->right);
+	}
+	else
+	{
+		out->index = in->first;
+		out->count = in->count;
+		bvh->depth = a3maximum(bvh->depth, in->depth);
+	}
+	return i;
+}
+
+// index of the n-th vertex geometry data draws
+inline unsigned int a3demo_meshBVHGeometryIndex(const a3_GeometryData *geom, const unsigned int n)
+{
+	if (geom->indexData)
+		switch (geom->indexFormat->indexSize)
+		{
+		case 1:
+			return ((const unsigned char *)geom->indexData)[n];
+		case 2:
+			return ((const unsigned short *)geom->indexData)[n];
+		case 4:
+			return ((const unsigned int *)geom->indexData)[n];
+		}
+	return n;
+}
+
+// corners of the n-th triangle geometry data draws; strips flip every
+//	other triangle so they all wind the same way
+//	-> returns 1 if there is one
+inline int a3demo_meshBVHGeometryTriangle(unsigned int *corner_out, const a3_GeometryData *geom, const unsigned int n)
+{
+	const unsigned int count = geom->indexData ? geom->numIndices : geom->numVertices;
+	switch (geom->primType)
+	{
+	case a3prim_triangles:
+		if (n * 3 + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_meshBVHGeometryIndex(geom, n * 3 + 0);
+		corner_out[1] = a3demo_meshBVHGeometryIndex(geom, n * 3 + 1);
+		corner_out[2] = a3demo_meshBVHGeometryIndex(geom, n * 3 + 2);
+		return 1;
+	case a3prim_triangleStrip:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_meshBVHGeometryIndex(geom, n + (n & 1));
+		corner_out[1] = a3demo_meshBVHGeometryIndex(geom, n + 1 - (n & 1));
+		corner_out[2] = a3demo_meshBVHGeometryIndex(geom, n + 2);
+		return 1;
+	case a3prim_triangleFan:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_meshBVHGeometryIndex(geom, 0);
+		corner_out[1] = a3demo_meshBVHGeometryIndex(geom, n + 1);
+		corner_out[2] = a3demo_meshBVHGeometryIndex(geom, n + 2);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// internal queries
+
+inline void a3demo_meshBVHDiff(float *out, const float *a, const float *b)
+{
+	out[0] = a[0] - b[0];
+	out[1] = a[1] - b[1];
+	out[2] = a[2] - b[2];
+}
+
+inline void a3demo_meshBVHCross(float *out, const float *a, const float *b)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline float a3demo_meshBVHDot(const float *a, const float *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_meshBVHSetRay(a3_DemoMeshRay *ray, const a3real *origin, const a3real *direction)
+{
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		ray->origin[i] = (float)origin[i];
+		ray->direction[i] = (float)direction[i];
+		ray->invDirection[i] = 1.0f / ray->direction[i];
+	}
+}
+
+// where a ray (or a sphere of the given radius) enters a node's box
+//	-> returns distance, FLT_MAX if it misses within the limit
+inline float a3demo_meshBVHEntry(const a3_DemoMeshBVHNode *node, const a3_DemoMeshRay *ray, const float radius, const float limit)
+{
+	float t0, t1, entryT = 0.0f, exitT = limit;
+	unsigned int i;
+	for (i = 0; i < 3; ++i)
+	{
+		t0 = (node->boundsMin[i] - radius - ray->origin[i]) * ray->invDirection[i];
+		t1 = (node->boundsMax[i] + radius - ray->origin[i]) * ray->invDirection[i];
+		if (t0 > t1)
+		{
+			const float swap = t0;
+			t0 = t1;
+			t1 = swap;
+		}
+		entryT = t0 > entryT ? t0 : entryT;
+		exitT = t1 < exitT ? t1 : exitT;
+	}
+	return entryT <= exitT ? entryT : FLT_MAX;
+}
+
+// ray against a triangle from either side (Moller-Trumbore)
+//	-> returns distance, or the limit if it misses before that
+inline float a3demo_meshBVHRayTriangle(float *u_out, float *v_out, const float *triangle, const a3_DemoMeshRay *ray, const float limit)
+{
+	float e1[3], e2[3], p[3], s[3], q[3], det, u, v, t;
+	a3demo_meshBVHDiff(e1, triangle + 3, triangle);
+	a3demo_meshBVHDiff(e2, triangle + 6, triangle);
+	a3demo_meshBVHCross(p, ray->direction, e2);
+	det = a3demo_meshBVHDot(e1, p);
+	if (det == 0.0f)
+		return limit;
+	det = 1.0f / det;
+	a3demo_meshBVHDiff(s, ray->origin, triangle);
+	u = a3demo_meshBVHDot(s, p) * det;
+	if (u < 0.0f || u > 1.0f)
+		return limit;
+	a3demo_meshBVHCross(q, s, e1);
+	v = a3demo_meshBVHDot(ray->direction, q) * det;
+	if (v < 0.0f || u + v > 1.0f)
+		return limit;
+	t = a3demo_meshBVHDot(e2, q) * det;
+	if (t < 0.0f || t >= limit)
+		return limit;
+	*u_out = u;
+	*v_out = v;
+	return t;
+}
+
+// ray against a sphere (moving point against a corner)
+inline float a3demo_meshBVHRaySphere(const a3_DemoMeshRay *ray, const float *center, const float radius, const float limit)
+{
+	float m[3], b, c, a, disc, t;
+	a3demo_meshBVHDiff(m, ray->origin, center);
+	c = a3demo_meshBVHDot(m, m) - radius * radius;
+	if (c <= 0.0f)
+		return 0.0f;
+	b = a3demo_meshBVHDot(m, ray->direction);
+	if (b >= 0.0f)
+		return limit;
+	a = a3demo_meshBVHDot(ray->direction, ray->direction);
+	disc = b * b - a * c;
+	if (disc < 0.0f)
+		return limit;
+	t = (-b - (float)sqrt(disc)) / a;
+	return t < limit ? t : limit;
+}
+
+// ray against the side of a cylinder around a segment (moving point
+//	against an edge); the ends are left to the corners
+inline float a3demo_meshBVHRayCylinder(const a3_DemoMeshRay *ray, const float *p, const float *q, const float radius, const float limit)
+{
+	float e[3], m[3], md, nd, dd, a, b, c, disc, t, s;
+	a3demo_meshBVHDiff(e, q, p);
+	a3demo_meshBVHDiff(m, ray->origin, p);
+	md = a3demo_meshBVHDot(m, e);
+	nd = a3demo_meshBVHDot(ray->direction, e);
+	dd = a3demo_meshBVHDot(e, e);
+	c = dd * (a3demo_meshBVHDot(m, m) - radius * radius) - md * md;
+	if (c <= 0.0f)
+		return (md >= 0.0f && md <= dd) ? 0.0f : limit;
+	a = dd * a3demo_meshBVHDot(ray->direction, ray->direction) - nd * nd;
+	if (a <= 0.0f)
+		return limit;
+	b = dd * a3demo_meshBVHDot(m, ray->direction) - nd * md;
+	disc = b * b - a * c;
+	if (b >= 0.0f || disc < 0.0f)
+		return limit;
+	t = (-b - (float)sqrt(disc)) / a;
+	s = md + t * nd;
+	return (t < limit && s >= 0.0f && s <= dd) ? t : limit;
+}
+
+// barycentric weights of a point in a triangle's plane
+//	-> returns 1 if it is inside
+inline int a3demo_meshBVHInside(float *u_out, float *v_out, const float *point, const float *triangle)
+{
+	float e1[3], e2[3], d[3], d11, d12, d22, dp1, dp2, det;
+	a3demo_meshBVHDiff(e1, triangle + 3, triangle);
+	a3demo_meshBVHDiff(e2, triangle + 6, triangle);
+	a3demo_meshBVHDiff(d, point, triangle);
+	d11 = a3demo_meshBVHDot(e1, e1);
+	d12 = a3demo_meshBVHDot(e1, e2);
+	d22 = a3demo_meshBVHDot(e2, e2);
+	dp1 = a3demo_meshBVHDot(d, e1);
+	dp2 = a3demo_meshBVHDot(d, e2);
+	det = d11 * d22 - d12 * d12;
+	if (det <= 0.0f)
+		return 0;
+	*u_out = (d22 * dp1 - d12 * dp2) / det;
+	*v_out = (d11 * dp2 - d12 * dp1) / det;
+	return *u_out >= 0.0f && *v_out >= 0.0f && *u_out + *v_out <= 1.0f;
+}
+
+// sphere moving along a ray against a triangle: the face if the sphere
+//	reaches its plane inside it (nothing can come sooner), otherwise
+//	the edges and corners
+inline float a3demo_meshBVHSphereTriangle(const float *triangle, const a3_DemoMeshRay *ray, const float radius, const float limit)
+{
+	float e1[3], e2[3], n[3], m[3], p[3], length, dist, speed, t = limit, u, v;
+	unsigned int i;
+
+	a3demo_meshBVHDiff(e1, triangle + 3, triangle);
+	a3demo_meshBVHDiff(e2, triangle + 6, triangle);
+	a3demo_meshBVHCross(n, e1, e2);
+	length = (float)sqrt(a3demo_meshBVHDot(n, n));
+	if (length > 0.0f)
+	{
+		a3demo_meshBVHDiff(m, ray->origin, triangle);
+		dist = a3demo_meshBVHDot(m, n) / length;
+		speed = a3demo_meshBVHDot(ray->direction, n) / length;
+		if (dist < 0.0f)
+		{
+			dist = -dist;
+			speed = -speed;
+			length = -length;
+		}
+		if (dist <= radius)
+			t = 0.0f;
+		else if (speed < 0.0f)
+			t = (radius - dist) / speed;
+		if (t < limit)
+		{
+			// the point of the plane the sphere touches first
+			for (i = 0; i < 3; ++i)
+				p[i] = ray->origin[i] + ray->direction[i] * t - n[i] / length * (t > 0.0f ? radius : dist);
+			if (a3demo_meshBVHInside(&u, &v, p, triangle))
+				return t;
+		}
+		t = limit;
+	}
+	for (i = 0; i < 3; ++i)
+	{
+		t = a3demo_meshBVHRayCylinder(ray, triangle + i * 3, triangle + (i + 1) % 3 * 3, radius, t);
+		t = a3demo_meshBVHRaySphere(ray, triangle + i * 3, radius, t);
+	}
+	return t;
+}
+
+// closest point of a triangle to a point, as barycentric weights of the
+//	second and third corners (Voronoi regions)
+void a3demo_meshBVHClosest(float *u_out, float *v_out, const float *point, const float *triangle)
+{
+	const float *a = triangle, *b = triangle + 3, *c = triangle + 6;
+	float ab[3], ac[3], ap[3], bp[3], cp[3], d1, d2, d3, d4, d5, d6, va, vb, vc, w;
+	a3demo_meshBVHDiff(ab, b, a);
+	a3demo_meshBVHDiff(ac, c, a);
+	a3demo_meshBVHDiff(ap, point, a);
+	a3demo_meshBVHDiff(bp, point, b);
+	a3demo_meshBVHDiff(cp, point, c);
+	d1 = a3demo_meshBVHDot(ab, ap);
+	d2 = a3demo_meshBVHDot(ac, ap);
+	d3 = a3demo_meshBVHDot(ab, bp);
+	d4 = a3demo_meshBVHDot(ac, bp);
+	d5 = a3demo_meshBVHDot(ab, cp);
+	d6 = a3demo_meshBVHDot(ac, cp);
+	vc = d1 * d4 - d3 * d2;
+	vb = d5 * d2 - d1 * d6;
+	va = d3 * d6 - d5 * d4;
+	*u_out = *v_out = 0.0f;
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return;
+	if (d3 >= 0.0f && d4 <= d3)
+		*u_out = 1.0f;
+	else if (d6 >= 0.0f && d5 <= d6)
+		*v_out = 1.0f;
+	else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		*u_out = d1 / (d1 - d3);
+	else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		*v_out = d2 / (d2 - d6);
+	else if (va <= 0.0f && d4 >= d3 && d5 >= d6)
+	{
+		w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		*u_out = 1.0f - w;
+		*v_out = w;
+	}
+	else if ((w = va + vb + vc) > 0.0f)
+	{
+		*u_out = vb / w;
+		*v_out = vc / w;
+	}
+}
+
+// depth-first walk, nearer child first; a radius makes it a sphere cast
+//	-> returns the position (in leaf order) of the triangle hit, -1 if none
+int a3demo_meshBVHTrace(float *distance_inout, float *u_out, float *v_out, const a3_DemoMeshBVH *bvh, const a3_DemoMeshRay *ray, const float radius)
+{
+	unsigned int stackNode[a3demo_meshBVHMaxDepth + 1], node = 0, top = 0, i, end;
+	float stackEntry[a3demo_meshBVHMaxDepth + 1], limit = *distance_inout, left, right, t, u, v;
+	const a3_DemoMeshBVHNode *n;
+	int hit = -1;
+
+	if (a3demo_meshBVHEntry(bvh->node, ray, radius, limit) == FLT_MAX)
+		return -1;
+	for (;;)
+	{
+		n = bvh->node + node;
+		if (n->count)
+		{
+			for (i = n->index, end = i + n->count; i < end; ++i)
+			{
+				if (radius > 0.0f)
+				{
+					t = a3demo_meshBVHSphereTriangle(bvh->triangle + i * 9, ray, radius, limit);
+					u = v = 0.0f;
+				}
+				else
+					t = a3demo_meshBVHRayTriangle(&u, &v, bvh->triangle + i * 9, ray, limit);
+				if (t < limit)
+				{
+					limit = t;
+					*u_out = u;
+					*v_out = v;
+					hit = (int)i;
+				}
+			}
+		}
+		else
+		{
+			left = a3demo_meshBVHEntry(n + 1, ray, radius, limit);
+			right = a3demo_meshBVHEntry(bvh->node + n->index, ray, radius, limit);
+			if (left <= right && left != FLT_MAX)
+			{
+				if (right != FLT_MAX)
+				{
+					stackNode[top] = n->index;
+					stackEntry[top++] = right;
+				}
+				++node;
+				continue;
+			}
+			else if (right != FLT_MAX)
+			{
+				if (left != FLT_MAX)
+				{
+					stackNode[top] = node + 1;
+					stackEntry[top++] = left;
+				}
+				node = n->index;
+				continue;
+			}
+		}
+
+		// next waiting node still in reach
+		while (top && stackEntry[top - 1] >= limit)
+			--top;
+		if (!top)
+			break;
+		node = stackNode[--top];
+	}
+	*distance_inout = limit;
+	return hit;
+}
+
+// fill in a ray hit
+void a3demo_meshBVHRayHit(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const unsigned int i, const float *direction, const float distance, const float u, const float v)
+{
+	const float *triangle = bvh->triangle + i * 9;
+	float e1[3], e2[3], n[3], length;
+	a3demo_meshBVHDiff(e1, triangle + 3, triangle);
+	a3demo_meshBVHDiff(e2, triangle + 6, triangle);
+	a3demo_meshBVHCross(n, e1, e2);
+	length = (float)sqrt(a3demo_meshBVHDot(n, n));
+	if (a3demo_meshBVHDot(n, direction) > 0.0f)
+		length = -length;
+	length = length != 0.0f ? 1.0f / length : 0.0f;
+	hit_out->distance = (a3real)distance;
+	hit_out->u = (a3real)u;
+	hit_out->v = (a3real)v;
+	hit_out->normal[0] = (a3real)(n[0] * length);
+	hit_out->normal[1] = (a3real)(n[1] * length);
+	hit_out->normal[2] = (a3real)(n[2] * length);
+	hit_out->triangle = bvh->triangleIndex[i];
+}
+
+inline void a3demo_meshBVHMiss(a3_DemoMeshHit *hit_out, const a3real maxDistance)
+{
+	memset(hit_out, 0, sizeof(a3_DemoMeshHit));
+	hit_out->distance = maxDistance;
+	hit_out->triangle = -1;
+}
+
+
+#if (a3demo_bvhWidth > 1)
+// one packet: a node is entered if any of its rays reaches it before
+//	its own nearest hit so far, and its triangles are tested against all
+//	of them at once; lanes past the count never hit anything
+int a3demo_meshBVHPacket(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real maxDistance, const unsigned int count)
+{
+	float o[3][a3demo_bvhWidth], d[3][a3demo_bvhWidth], inv[3][a3demo_bvhWidth], best[a3demo_bvhWidth], bestU[a3demo_bvhWidth], bestV[a3demo_bvhWidth], entry[2][a3demo_bvhWidth];
+	int bestHit[a3demo_bvhWidth];
+	a3_DemoMeshBVHLane ox, oy, oz, dx, dy, dz, ix, iy, iz, tBest, uBest, vBest, hitBest;
+	a3_DemoMeshBVHLane e1x, e1y, e1z, e2x, e2y, e2z, px, py, pz, sx, sy, sz, qx, qy, qz, det, u, v, t, mask, entryT, exitT, t0, t1;
+	const a3_DemoMeshBVHLane zero = a3demo_laneSet(0.0f), one = a3demo_laneSet(1.0f);
+	const a3_DemoMeshBVHNode *n, *child[2];
+	unsigned int stack[a3demo_meshBVHMaxDepth + 1], node = 0, top = 0, i, k, c, end, hits = 0;
+	const float *triangle;
+	float stackEntry[a3demo_meshBVHMaxDepth + 1], nearest[2], farthest;
+	int visit[2];
+
+	for (i = 0; i < a3demo_bvhWidth; ++i)
+	{
+		c = i < count ? i : 0;
+		for (k = 0; k < 3; ++k)
+		{
+			o[k][i] = (float)origin[c * 3 + k];
+			d[k][i] = (float)direction[c * 3 + k];
+			inv[k][i] = 1.0f / d[k][i];
+		}
+		best[i] = i < count ? (float)maxDistance : -1.0f;
+	}
+	ox = a3demo_laneLoad(o[0]);
+	oy = a3demo_laneLoad(o[1]);
+	oz = a3demo_laneLoad(o[2]);
+	dx = a3demo_laneLoad(d[0]);
+	dy = a3demo_laneLoad(d[1]);
+	dz = a3demo_laneLoad(d[2]);
+	ix = a3demo_laneLoad(inv[0]);
+	iy = a3demo_laneLoad(inv[1]);
+	iz = a3demo_laneLoad(inv[2]);
+	tBest = a3demo_laneLoad(best);
+	uBest = vBest = zero;
+	hitBest = a3demo_laneSetBits(-1);
+
+	for (;;)
+	{
+		n = bvh->node + node;
+		if (n->count)
+		{
+			for (i = n->index, end = i + n->count; i < end; ++i)
+			{
+				triangle = bvh->triangle + i * 9;
+				e1x = a3demo_laneSet(triangle[3] - triangle[0]);
+				e1y = a3demo_laneSet(triangle[4] - triangle[1]);
+				e1z = a3demo_laneSet(triangle[5] - triangle[2]);
+				e2x = a3demo_laneSet(triangle[6] - triangle[0]);
+				e2y = a3demo_laneSet(triangle[7] - triangle[1]);
+				e2z = a3demo_laneSet(triangle[8] - triangle[2]);
+				px = a3demo_laneSub(a3demo_laneMul(dy, e2z), a3demo_laneMul(dz, e2y));
+				py = a3demo_laneSub(a3demo_laneMul(dz, e2x), a3demo_laneMul(dx, e2z));
+				pz = a3demo_laneSub(a3demo_laneMul(dx, e2y), a3demo_laneMul(dy, e2x));
+				det = a3demo_laneDiv(one, a3demo_laneAdd(a3demo_laneAdd(a3demo_laneMul(e1x, px), a3demo_laneMul(e1y, py)), a3demo_laneMul(e1z, pz)));
+				sx = a3demo_laneSub(ox, a3demo_laneSet(triangle[0]));
+				sy = a3demo_laneSub(oy, a3demo_laneSet(triangle[1]));
+				sz = a3demo_laneSub(oz, a3demo_laneSet(triangle[2]));
+				u = a3demo_laneMul(a3demo_laneAdd(a3demo_laneAdd(a3demo_laneMul(sx, px), a3demo_laneMul(sy, py)), a3demo_laneMul(sz, pz)), det);
+				qx = a3demo_laneSub(a3demo_laneMul(sy, e1z), a3demo_laneMul(sz, e1y));
+				qy = a3demo_laneSub(a3demo_laneMul(sz, e1x), a3demo_laneMul(sx, e1z));
+				qz = a3demo_laneSub(a3demo_laneMul(sx, e1y), a3demo_laneMul(sy, e1x));
+				v = a3demo_laneMul(a3demo_laneAdd(a3demo_laneAdd(a3demo_laneMul(dx, qx), a3demo_laneMul(dy, qy)), a3demo_laneMul(dz, qz)), det);
+				t = a3demo_laneMul(a3demo_laneAdd(a3demo_laneAdd(a3demo_laneMul(e2x, qx), a3demo_laneMul(e2y, qy)), a3demo_laneMul(e2z, qz)), det);
+
+				// ordered compares: a parallel triangle's infinities and
+				//	NaNs fail them all
+				mask = a3demo_laneAnd(a3demo_laneLessEqual(zero, u), a3demo_laneLessEqual(zero, v));
+				mask = a3demo_laneAnd(mask, a3demo_laneLessEqual(a3demo_laneAdd(u, v), one));
+				mask = a3demo_laneAnd(mask, a3demo_laneLessEqual(zero, t));
+				mask = a3demo_laneAnd(mask, a3demo_laneLess(t, tBest));
+				if (a3demo_laneAny(mask))
+				{
+					tBest = a3demo_laneSelect(mask, t, tBest);
+					uBest = a3demo_laneSelect(mask, u, uBest);
+					vBest = a3demo_laneSelect(mask, v, vBest);
+					hitBest = a3demo_laneSelect(mask, a3demo_laneSetBits((int)i), hitBest);
+				}
+			}
+		}
+		else
+		{
+			// slab test of both children for every ray
+			child[0] = n + 1;
+			child[1] = bvh->node + n->index;
+			for (c = 0; c < 2; ++c)
+			{
+				t0 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMin[0]), ox), ix);
+				t1 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMax[0]), ox), ix);
+				entryT = a3demo_laneMax(zero, a3demo_laneMin(t0, t1));
+				exitT = a3demo_laneMin(tBest, a3demo_laneMax(t0, t1));
+				t0 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMin[1]), oy), iy);
+				t1 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMax[1]), oy), iy);
+				entryT = a3demo_laneMax(entryT, a3demo_laneMin(t0, t1));
+				exitT = a3demo_laneMin(exitT, a3demo_laneMax(t0, t1));
+				t0 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMin[2]), oz), iz);
+				t1 = a3demo_laneMul(a3demo_laneSub(a3demo_laneSet(child[c]->boundsMax[2]), oz), iz);
+				entryT = a3demo_laneMax(entryT, a3demo_laneMin(t0, t1));
+				exitT = a3demo_laneMin(exitT, a3demo_laneMax(t0, t1));
+				mask = a3demo_laneLessEqual(entryT, exitT);
+				visit[c] = a3demo_laneAny(mask) != 0;
+				nearest[c] = FLT_MAX;
+				if (visit[c])
+				{
+					a3demo_laneStore(entry[c], a3demo_laneSelect(mask, entryT, a3demo_laneSet(FLT_MAX)));
+					for (k = 0; k < a3demo_bvhWidth; ++k)
+						nearest[c] = a3minimum(nearest[c], entry[c][k]);
+				}
+			}
+			if (visit[0] || visit[1])
+			{
+				c = (visit[0] && visit[1]) ? (nearest[1] < nearest[0]) : visit[1];
+				if (visit[!c])
+				{
+					stack[top] = (unsigned int)(child[!c] - bvh->node);
+					stackEntry[top++] = nearest[!c];
+				}
+				node = (unsigned int)(child[c] - bvh->node);
+				continue;
+			}
+		}
+		// next waiting node some ray can still reach before its hit
+		if (top)
+		{
+			a3demo_laneStore(best, tBest);
+			for (k = 1, farthest = best[0]; k < a3demo_bvhWidth; ++k)
+				farthest = a3maximum(farthest, best[k]);
+			while (top && stackEntry[top - 1] >= farthest)
+				--top;
+		}
+		if (!top)
+			break;
+		node = stack[--top];
+	}
+
+	a3demo_laneStore(best, tBest);
+	a3demo_laneStore(bestU, uBest);
+	a3demo_laneStore(bestV, vBest);
+	a3demo_laneStore((float *)bestHit, hitBest);
+	for (i = 0; i < count; ++i)
+	{
+		if (bestHit[i] >= 0)
+		{
+			for (k = 0; k < 3; ++k)
+				entry[0][k] = d[k][i];
+			a3demo_meshBVHRayHit(hit_out + i, bvh, bestHit[i], entry[0], best[i], bestU[i], bestV[i]);
+			++hits;
+		}
+		else
+			a3demo_meshBVHMiss(hit_out + i, maxDistance);
+	}
+	return hits;
+}
+#endif	// a3demo_bvhWidth > 1
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createMeshBVH(a3_DemoMeshBVH *bvh_out, const float *position, const unsigned int *index, const unsigned int triangleCount, a3_DemoJobSystem *jobs)
+{
+	if (bvh_out && position && triangleCount)
+	{
+		a3_DemoMeshBVHBuild build[1];
+		const unsigned int n = triangleCount, taskMax = n / a3demo_meshBVHTaskSize * 2 + 2;
+		const float *v;
+		float *triangle;
+		unsigned int i, k, t;
+		size_t size;
+		void *scratch;
+
+		memset(bvh_out, 0, sizeof(a3_DemoMeshBVH));
+		size = (n * 2 - 1) * sizeof(a3_DemoMeshBVHBuildNode) + taskMax * sizeof(a3_DemoMeshBVHTask) + n * (sizeof(unsigned int) + sizeof(float) * 9);
+		scratch = malloc(size);
+		if (!scratch)
+			return -1;
+		build->node = (a3_DemoMeshBVHBuildNode *)scratch;
+		build->task = (a3_DemoMeshBVHTask *)(build->node + n * 2 - 1);
+		build->box = (float *)(build->task + taskMax);
+		build->centroid = build->box + n * 6;
+		build->order = (unsigned int *)(build->centroid + n * 3);
+		build->position = position;
+		build->index = index;
+		build->taskCount = 0;
+
+		// top of the tree serially, then its small subtrees as jobs
+		a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_meshBVHBoundsJob, build, n, a3demo_meshBVHTaskSize);
+		a3demo_meshBVHSplit(build, 0, 0, n, 0, 1);
+		a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_meshBVHTaskJob, build, build->taskCount, 1);
+
+		// flatten and copy the triangles into leaf order
+		k = a3demo_meshBVHCount(build, 0);
+		bvh_out->memory = malloc(k * sizeof(a3_DemoMeshBVHNode) + n * (sizeof(float) * 9 + sizeof(unsigned int)));
+		if (!bvh_out->memory)
+		{
+			free(scratch);
+			return -1;
+		}
+		bvh_out->node = (a3_DemoMeshBVHNode *)bvh_out->memory;
+		bvh_out->triangle = (float *)(bvh_out->node + k);
+		bvh_out->triangleIndex = (unsigned int *)(bvh_out->triangle + n * 9);
+		bvh_out->triangleCount = n;
+		a3demo_meshBVHFlatten(bvh_out, build, 0);
+		for (i = 0, triangle = bvh_out->triangle; i < n; ++i, triangle += 9)
+		{
+			t = build->order[i];
+			for (k = 0; k < 3; ++k)
+			{
+				v = a3demo_meshBVHCorner(build, t, k);
+				triangle[k * 3 + 0] = v[0];
+				triangle[k * 3 + 1] = v[1];
+				triangle[k * 3 + 2] = v[2];
+			}
+			bvh_out->triangleIndex[i] = t;
+		}
+		free(scratch);
+		return bvh_out->nodeCount;
+	}
+	return -1;
+}
+
+int a3demo_createMeshBVHGeometry(a3_DemoMeshBVH *bvh_out, const a3_GeometryData *geom, a3_DemoJobSystem *jobs)
+{
+	if (bvh_out && geom && geom->attribData[a3attrib_geomPosition])
+	{
+		const float *const position = (const float *)geom->attribData[a3attrib_geomPosition];
+		unsigned int *index, corner[3], n, count;
+		int status;
+
+		for (count = 0; a3demo_meshBVHGeometryTriangle(corner, geom, count); ++count);
+		index = (unsigned int *)malloc((count + 1) * 3 * sizeof(unsigned int));
+		if (!index)
+			return -1;
+
+		// triangles with a corner past the vertex data are dropped
+		for (n = 0, count = 0; a3demo_meshBVHGeometryTriangle(index + count * 3, geom, n); ++n)
+			count += index[count * 3 + 0] < geom->numVertices && index[count * 3 + 1] < geom->numVertices && index[count * 3 + 2] < geom->numVertices;
+		status = a3demo_createMeshBVH(bvh_out, position, index, count, jobs);
+		free(index);
+		return status;
+	}
+	return -1;
+}
+
+int a3demo_releaseMeshBVH(a3_DemoMeshBVH *bvh)
+{
+	if (bvh)
+	{
+		free(bvh->memory);
+		memset(bvh, 0, sizeof(a3_DemoMeshBVH));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_raycastMeshBVH(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real maxDistance)
+{
+	if (hit_out && bvh && bvh->nodeCount && origin && direction)
+	{
+		a3_DemoMeshRay ray[1];
+		float distance = (float)maxDistance, u = 0.0f, v = 0.0f;
+		int i;
+		a3demo_meshBVHSetRay(ray, origin, direction);
+		i = a3demo_meshBVHTrace(&distance, &u, &v, bvh, ray, 0.0f);
+		if (i >= 0)
+		{
+			a3demo_meshBVHRayHit(hit_out, bvh, i, ray->direction, distance, u, v);
+			return 1;
+		}
+		a3demo_meshBVHMiss(hit_out, maxDistance);
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_raycastMeshBVHPacket(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real maxDistance, const unsigned int count)
+{
+	if (hit_out && bvh && bvh->nodeCount && origin && direction)
+	{
+		unsigned int i, hits = 0;
+#if (a3demo_bvhWidth > 1)
+		for (i = 0; i < count; i += a3demo_bvhWidth)
+			hits += a3demo_meshBVHPacket(hit_out + i, bvh, origin + i * 3, direction + i * 3, maxDistance, a3minimum(count - i, a3demo_bvhWidth));
+#else	// scalar
+		for (i = 0; i < count; ++i)
+			hits += a3demo_raycastMeshBVH(hit_out + i, bvh, origin + i * 3, direction + i * 3, maxDistance);
+#endif	// a3demo_bvhWidth > 1
+		return hits;
+	}
+	return -1;
+}
+
+int a3demo_sphereCastMeshBVH(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real radius, const a3real maxDistance)
+{
+	if (hit_out && bvh && bvh->nodeCount && origin && direction && radius >= a3realZero)
+	{
+		a3_DemoMeshRay ray[1];
+		const float *triangle;
+		float distance = (float)maxDistance, u = 0.0f, v = 0.0f, center[3], point[3], n[3], e1[3], e2[3], length;
+		unsigned int k;
+		int i;
+
+		// a zero radius is a ray
+		if (radius <= a3realZero)
+			return a3demo_raycastMeshBVH(hit_out, bvh, origin, direction, maxDistance);
+		a3demo_meshBVHSetRay(ray, origin, direction);
+		i = a3demo_meshBVHTrace(&distance, &u, &v, bvh, ray, (float)radius);
+		if (i < 0)
+		{
+			a3demo_meshBVHMiss(hit_out, maxDistance);
+			return 0;
+		}
+
+		// normal from the touching point out to the center, or the face's
+		//	if the center is on the triangle
+		triangle = bvh->triangle + i * 9;
+		for (k = 0; k < 3; ++k)
+			center[k] = ray->origin[k] + ray->direction[k] * distance;
+		a3demo_meshBVHClosest(&u, &v, center, triangle);
+		for (k = 0; k < 3; ++k)
+			point[k] = triangle[k] + (triangle[3 + k] - triangle[k]) * u + (triangle[6 + k] - triangle[k]) * v;
+		a3demo_meshBVHDiff(n, center, point);
+		length = (float)sqrt(a3demo_meshBVHDot(n, n));
+		if (length <= FLT_EPSILON * (float)radius)
+		{
+			a3demo_meshBVHDiff(e1, triangle + 3, triangle);
+			a3demo_meshBVHDiff(e2, triangle + 6, triangle);
+			a3demo_meshBVHCross(n, e1, e2);
+			length = (float)sqrt(a3demo_meshBVHDot(n, n));
+			if (a3demo_meshBVHDot(n, ray->direction) > 0.0f)
+				length = -length;
+		}
+		length = length != 0.0f ? 1.0f / length : 0.0f;
+		hit_out->distance = (a3real)distance;
+		hit_out->u = (a3real)u;
+		hit_out->v = (a3real)v;
+		hit_out->normal[0] = (a3real)(n[0] * length);
+		hit_out->normal[1] = (a3real)(n[1] * length);
+		hit_out->normal[2] = (a3real)(n[2] * length);
+		hit_out->triangle = bvh->triangleIndex[i];
+		return 1;
+	}
+	return -1;
+}
+
+const char *a3demo_getMeshBVHKernelName()
+{
+#if defined(A3_SIMD_AVX)
+	return "AVX";
+#elif defined(A3_SIMD_SSE)
+	return "SSE";
+#elif defined(A3_SIMD_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif	// A3_SIMD_AVX
+}
+
+unsigned int a3demo_getMeshBVHPacketWidth()
+{
+	return a3demo_bvhWidth;
+}
+
+
+//-----------------------------------------------------------------------------
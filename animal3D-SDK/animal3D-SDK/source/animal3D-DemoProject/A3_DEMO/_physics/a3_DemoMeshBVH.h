@@ -0,0 +1,144 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMeshBVH.h
+	Bounding volume hierarchy over the triangles of a mesh: SAH build,
+		ray casts one at a time or in packets, and sphere casts.
+*/
+
+#ifndef __ANIMAL3D_DEMOMESHBVH_H
+#define __ANIMAL3D_DEMOMESHBVH_H
+
+
+#include "animal3D/a3math/A3DM.h"
+#include "animal3D/a3graphics/a3geometry/a3_GeometryData.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoMeshBVHNode	a3_DemoMeshBVHNode;
+	typedef struct a3_DemoMeshBVH		a3_DemoMeshBVH;
+	typedef struct a3_DemoMeshHit		a3_DemoMeshHit;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// tree constants
+	enum a3_DemoMeshBVHConstants
+	{
+		a3demo_meshBVHBins = 16,		// SAH split candidates per axis
+		a3demo_meshBVHLeafMax = 8,		// larger ranges are always split
+		a3demo_meshBVHTaskSize = 4096,	// subtrees this small are built as
+										//	separate jobs
+		a3demo_meshBVHMaxDepth = 48,	// deeper ranges become leaves, which
+										//	bounds the traversal stack
+	};
+
+
+	// node of the flattened tree, 32 bytes so two share a cache line; the
+	//	left child directly follows its parent (depth-first order), so
+	//	inner nodes only point at the right one
+	struct a3_DemoMeshBVHNode
+	{
+		float boundsMin[3];
+		unsigned int index;				// leaf: first triangle; inner: right child
+		float boundsMax[3];
+		unsigned int count;				// leaf: triangle count; inner: zero
+	};
+
+	// triangle tree; positions are stored as float, like geometry data,
+	//	and copied into leaf order so a leaf's triangles are contiguous
+	struct a3_DemoMeshBVH
+	{
+		a3_DemoMeshBVHNode *node;
+		float *triangle;				// nine floats (three corners) per triangle
+		unsigned int *triangleIndex;	// index in the source of each triangle
+		unsigned int nodeCount, triangleCount, depth;
+		void *memory;
+	};
+
+	// what a cast hit
+	//	member distance: along the ray in units of the direction's length;
+	//		for sphere casts, how far the center got
+	//	member u, v: barycentric weights of the triangle's second and third
+	//		corners at the hit (ray casts) or the touching point (sphere casts)
+	//	member normal: unit, facing back against the cast
+	struct a3_DemoMeshHit
+	{
+		a3real distance;
+		a3real u, v;
+		a3real normal[3];
+		unsigned int triangle;			// index in the source; -1 for a miss
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// build a tree over indexed triangles
+	//	param position: xyz per vertex
+	//	param index: three vertex indices per triangle; null takes
+	//		consecutive vertices
+	//	param jobs: small subtrees are built as jobs; null builds them
+	//		serially, with the same result
+	//	-> returns node count, -1 if invalid params
+	int a3demo_createMeshBVH(a3_DemoMeshBVH *bvh_out, const float *position, const unsigned int *index, const unsigned int triangleCount, a3_DemoJobSystem *jobs);
+
+	// build a tree over the triangles geometry data draws (lists, strips
+	//	or fans)
+	int a3demo_createMeshBVHGeometry(a3_DemoMeshBVH *bvh_out, const a3_GeometryData *geom, a3_DemoJobSystem *jobs);
+
+	// free tree storage
+	int a3demo_releaseMeshBVH(a3_DemoMeshBVH *bvh);
+
+	// nearest triangle (either side) along a ray, up to maxDistance
+	//	-> returns 1 if hit, 0 if not, -1 if invalid params
+	int a3demo_raycastMeshBVH(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real maxDistance);
+
+	// the same for many rays (xyz each), traced together in packets as wide
+	//	as the kernel; rays near each other (camera rays, neighbouring
+	//	probes) share most of their traversal, so they should be adjacent
+	//	-> returns hit count, -1 if invalid params
+	int a3demo_raycastMeshBVHPacket(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real maxDistance, const unsigned int count);
+
+	// first contact of a sphere moving along a direction; one already
+	//	touching the mesh hits at zero
+	//	-> returns 1 if hit, 0 if not, -1 if invalid params
+	int a3demo_sphereCastMeshBVH(a3_DemoMeshHit *hit_out, const a3_DemoMeshBVH *bvh, const a3real *origin, const a3real *direction, const a3real radius, const a3real maxDistance);
+
+	// name and width of the packet kernel the compiler was allowed to use
+	const char *a3demo_getMeshBVHKernelName();
+	unsigned int a3demo_getMeshBVHPacketWidth();
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOMESHBVH_H
@@ -0,0 +1,949 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoNarrowphase.c
+	Contact manifold generation.
+*/
+
+#include "a3_DemoNarrowphase.h"
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// narrowphase internal constants
+enum a3_DemoNarrowphaseInternal
+{
+	a3demo_contactMaxCandidates = 16,	// points before reduction
+	a3demo_contactBatch = 64,			// sphere pairs tested per pass
+	a3demo_contactFeatureEdge = 0x4000,	// box/box edge contact
+	a3demo_contactFeatureFlip = 0x8000,	// box/box reference face on b
+};
+
+// points this far apart are still kept once the shapes touch, so a
+//	resting body that rocks slightly keeps its full manifold; spheres
+//	report contacts this close before they touch, so a body stopped
+//	just short of a surface by the sweep is caught the step after
+static const a3real a3demo_contactMargin = 0.01f;
+
+// candidate points gathered before reduction
+typedef struct a3_DemoContactCandidates
+{
+	a3_DemoContactPoint point[a3demo_contactMaxCandidates];
+	unsigned int count;
+} a3_DemoContactCandidates;
+
+
+inline a3real a3demo_contactDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_contactCross(a3real *out, const a3real *a, const a3real *b)
+{
+	const a3real x = a[1] * b[2] - a[2] * b[1], y = a[2] * b[0] - a[0] * b[2], z = a[0] * b[1] - a[1] * b[0];
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+}
+
+// out = a + b * s
+inline void a3demo_contactMulAdd(a3real *out, const a3real *a, const a3real *b, const a3real s)
+{
+	out[0] = a[0] + b[0] * s;
+	out[1] = a[1] + b[1] * s;
+	out[2] = a[2] + b[2] * s;
+}
+
+inline void a3demo_contactDiff(a3real *out, const a3real *a, const a3real *b)
+{
+	out[0] = a[0] - b[0];
+	out[1] = a[1] - b[1];
+	out[2] = a[2] - b[2];
+}
+
+inline a3real a3demo_contactSign(const a3real x)
+{
+	return x < a3realZero ? -a3realOne : a3realOne;
+}
+
+// some unit vector perpendicular to v
+inline void a3demo_contactPerpendicular(a3real *out, const a3real *v)
+{
+	a3real tmp[3] = { a3realZero, a3realZero, a3realZero }, len;
+
+	// cross with the world axis least aligned with v
+	tmp[a3absolute(v[0]) < a3absolute(v[1]) ? (a3absolute(v[0]) < a3absolute(v[2]) ? 0 : 2) : (a3absolute(v[1]) < a3absolute(v[2]) ? 1 : 2)] = a3realOne;
+	a3demo_contactCross(out, v, tmp);
+	len = (a3real)sqrt(a3demo_contactDot(out, out));
+	out[0] /= len;
+	out[1] /= len;
+	out[2] /= len;
+}
+
+// start a manifold
+inline void a3demo_contactBegin(a3_DemoContactManifold *manifold, const a3real *normal)
+{
+	manifold->normal[0] = normal[0];
+	manifold->normal[1] = normal[1];
+	manifold->normal[2] = normal[2];
+	manifold->count = 0;
+}
+
+// add a point given where it touches the first shape's surface
+inline void a3demo_contactAdd(a3_DemoContactManifold *manifold, const a3real *surfaceA, const a3real depth, const unsigned int feature)
+{
+	a3_DemoContactPoint *point = manifold->point + manifold->count++;
+	a3demo_contactMulAdd(point->position, surfaceA, manifold->normal, -depth * a3realHalf);
+	point->depth = depth;
+	point->feature = feature;
+}
+
+// same, for candidates that may need reducing; clipping can produce the
+//	same point twice, so repeats are dropped
+inline void a3demo_contactAddCandidate(a3_DemoContactCandidates *candidates, const a3real *position, const a3real depth, const unsigned int feature)
+{
+	a3real d[3];
+	unsigned int i;
+	for (i = 0; i < candidates->count; ++i)
+	{
+		a3demo_contactDiff(d, candidates->point[i].position, position);
+		if (a3demo_contactDot(d, d) < 1.0e-8f)
+			return;
+	}
+	if (candidates->count < a3demo_contactMaxCandidates)
+	{
+		a3_DemoContactPoint *point = candidates->point + candidates->count++;
+		point->position[0] = position[0];
+		point->position[1] = position[1];
+		point->position[2] = position[2];
+		point->depth = depth;
+		point->feature = feature;
+	}
+}
+
+// signed area of (a, b, c) about the normal, doubled
+inline a3real a3demo_contactArea(const a3real *a, const a3real *b, const a3real *c, const a3real *normal)
+{
+	a3real ab[3], ac[3], n[3];
+	a3demo_contactDiff(ab, b, a);
+	a3demo_contactDiff(ac, c, a);
+	a3demo_contactCross(n, ab, ac);
+	return a3demo_contactDot(n, normal);
+}
+
+// keep up to four candidates covering the most area: the deepest, the
+//	one farthest from it, then the largest triangles on either side
+void a3demo_contactReduce(a3_DemoContactManifold *manifold, const a3_DemoContactCandidates *candidates)
+{
+	const a3_DemoContactPoint *p = candidates->point;
+	int keep[a3demo_contactMaxPoints] = { -1, -1, -1, -1 };
+	unsigned int i, k;
+	a3real best, value, d[3];
+
+	if (candidates->count <= a3demo_contactMaxPoints)
+	{
+		for (i = 0; i < candidates->count; ++i)
+			manifold->point[i] = p[i];
+		manifold->count = candidates->count;
+		return;
+	}
+
+	for (i = 1, keep[0] = 0; i < candidates->count; ++i)
+		if (p[i].depth > p[keep[0]].depth)
+			keep[0] = i;
+	for (i = 0, best = -a3realOne; i < candidates->count; ++i)
+	{
+		a3demo_contactDiff(d, p[i].position, p[keep[0]].position);
+		value = a3demo_contactDot(d, d);
+		if (value > best)
+		{
+			best = value;
+			keep[1] = i;
+		}
+	}
+	for (i = 0, best = a3realZero; i < candidates->count; ++i)
+	{
+		value = a3demo_contactArea(p[keep[0]].position, p[keep[1]].position, p[i].position, manifold->normal);
+		if (value > best)
+		{
+			best = value;
+			keep[2] = i;
+		}
+	}
+	for (i = 0, best = a3realZero; i < candidates->count; ++i)
+	{
+		value = a3demo_contactArea(p[keep[0]].position, p[keep[1]].position, p[i].position, manifold->normal);
+		if (value < best)
+		{
+			best = value;
+			keep[3] = i;
+		}
+	}
+	for (k = manifold->count = 0; k < a3demo_contactMaxPoints; ++k)
+		if (keep[k] >= 0 && (k != 1 || keep[1] != keep[0]))
+			manifold->point[manifold->count++] = p[keep[k]];
+}
+
+// closest points between segments p0-p1 and q0-q1
+void a3demo_contactClosestSegments(a3real *closestP_out, a3real *closestQ_out, const a3real *p0, const a3real *p1, const a3real *q0, const a3real *q1)
+{
+	a3real d1[3], d2[3], r[3], a, e, f, c, b, denom, s, t;
+	a3demo_contactDiff(d1, p1, p0);
+	a3demo_contactDiff(d2, q1, q0);
+	a3demo_contactDiff(r, p0, q0);
+	a = a3demo_contactDot(d1, d1);
+	e = a3demo_contactDot(d2, d2);
+	f = a3demo_contactDot(d2, r);
+
+	if (a <= a3realEpsilon && e <= a3realEpsilon)
+		s = t = a3realZero;
+	else if (a <= a3realEpsilon)
+	{
+		s = a3realZero;
+		t = a3minimum(a3maximum(f / e, a3realZero), a3realOne);
+	}
+	else
+	{
+		c = a3demo_contactDot(d1, r);
+		if (e <= a3realEpsilon)
+		{
+			t = a3realZero;
+			s = a3minimum(a3maximum(-c / a, a3realZero), a3realOne);
+		}
+		else
+		{
+			b = a3demo_contactDot(d1, d2);
+			denom = a * e - b * b;
+			s = denom > a3realEpsilon ? a3minimum(a3maximum((b * f - c * e) / denom, a3realZero), a3realOne) : a3realZero;
+			t = (b * s + f) / e;
+			if (t < a3realZero)
+			{
+				t = a3realZero;
+				s = a3minimum(a3maximum(-c / a, a3realZero), a3realOne);
+			}
+			else if (t > a3realOne)
+			{
+				t = a3realOne;
+				s = a3minimum(a3maximum((b - c) / a, a3realZero), a3realOne);
+			}
+		}
+	}
+	a3demo_contactMulAdd(closestP_out, p0, d1, s);
+	a3demo_contactMulAdd(closestQ_out, q0, d2, t);
+}
+
+// closest point on segment p0-p1 to x
+inline void a3demo_contactClosestOnSegment(a3real *out, const a3real *p0, const a3real *p1, const a3real *x)
+{
+	a3real d[3], r[3], len2, t;
+	a3demo_contactDiff(d, p1, p0);
+	a3demo_contactDiff(r, x, p0);
+	len2 = a3demo_contactDot(d, d);
+	t = len2 > a3realEpsilon ? a3minimum(a3maximum(a3demo_contactDot(r, d) / len2, a3realZero), a3realOne) : a3realZero;
+	a3demo_contactMulAdd(out, p0, d, t);
+}
+
+// segment endpoints of a capsule in world space
+inline void a3demo_contactCapsuleSegment(a3real *p0_out, a3real *p1_out, const a3_DemoCollider *capsule, const a3_DemoColliderPose *pose)
+{
+	a3real center[3], axis[3];
+	a3demo_getColliderWorldFrame(capsule, pose, center, axis);
+	a3demo_contactMulAdd(p0_out, center, axis, -capsule->halfLength);
+	a3demo_contactMulAdd(p1_out, center, axis, capsule->halfLength);
+}
+
+// deepest points of a round rim (center, unit axis, radius) toward -n;
+//	four points when the rim lies flat against the plane
+void a3demo_contactRim(a3_DemoContactCandidates *rim_out, const a3real *center, const a3real *axis, const a3real radius, const a3real *n, const unsigned int feature)
+{
+	a3real w[3], e[3], f[3], x[3], len;
+	a3demo_contactMulAdd(w, n, axis, -a3demo_contactDot(n, axis));
+	len = (a3real)sqrt(a3demo_contactDot(w, w));
+	if (len > 0.01f)
+	{
+		a3demo_contactMulAdd(x, center, w, -radius / len);
+		a3demo_contactAddCandidate(rim_out, x, a3realZero, feature);
+	}
+	else
+	{
+		a3demo_contactPerpendicular(e, axis);
+		a3demo_contactCross(f, axis, e);
+		a3demo_contactMulAdd(x, center, e, radius);
+		a3demo_contactAddCandidate(rim_out, x, a3realZero, feature + 0);
+		a3demo_contactMulAdd(x, center, f, radius);
+		a3demo_contactAddCandidate(rim_out, x, a3realZero, feature + 1);
+		a3demo_contactMulAdd(x, center, e, -radius);
+		a3demo_contactAddCandidate(rim_out, x, a3realZero, feature + 2);
+		a3demo_contactMulAdd(x, center, f, -radius);
+		a3demo_contactAddCandidate(rim_out, x, a3realZero, feature + 3);
+	}
+}
+
+// clip a polygon to the side of a plane where dot(x, n) <= d; each new
+//	point gets a tag naming the plane and the edge it came from
+unsigned int a3demo_contactClip(a3real(*out)[3], unsigned int *tagOut, const a3real(*in)[3], const unsigned int *tagIn, const unsigned int count, const a3real *n, const a3real d, const unsigned int plane)
+{
+	unsigned int i, j, result = 0;
+	a3real di, dj, t;
+	for (i = 0; i < count; ++i)
+	{
+		j = (i + 1) % count;
+		di = a3demo_contactDot(in[i], n) - d;
+		dj = a3demo_contactDot(in[j], n) - d;
+		if (di <= a3realZero)
+		{
+			out[result][0] = in[i][0];
+			out[result][1] = in[i][1];
+			out[result][2] = in[i][2];
+			tagOut[result++] = tagIn[i];
+		}
+		if ((di < a3realZero) != (dj < a3realZero))
+		{
+			t = di / (di - dj);
+			out[result][0] = in[i][0] + (in[j][0] - in[i][0]) * t;
+			out[result][1] = in[i][1] + (in[j][1] - in[i][1]) * t;
+			out[result][2] = in[i][2] + (in[j][2] - in[i][2]) * t;
+			tagOut[result++] = ((plane + 1) << 4) | (tagIn[i] & 0xf);
+		}
+	}
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_collideSphereSphere(a3_DemoContactManifold *manifold_out, const a3real *centerA, const a3real radiusA, const a3real *centerB, const a3real radiusB)
+{
+	if (manifold_out && centerA && centerB)
+	{
+		const a3real radius = radiusA + radiusB, reach = radius + a3demo_contactMargin;
+		a3real d[3], dist2, dist, surface[3];
+		a3demo_contactDiff(d, centerB, centerA);
+		dist2 = a3demo_contactDot(d, d);
+		manifold_out->count = 0;
+		if (dist2 > reach * reach)
+			return 0;
+
+		dist = (a3real)sqrt(dist2);
+		if (dist > a3realEpsilon)
+		{
+			d[0] /= dist;
+			d[1] /= dist;
+			d[2] /= dist;
+		}
+		else
+		{
+			d[0] = d[1] = a3realZero;
+			d[2] = a3realOne;
+		}
+		a3demo_contactBegin(manifold_out, d);
+		a3demo_contactMulAdd(surface, centerA, d, radiusA);
+		a3demo_contactAdd(manifold_out, surface, radius - dist, 0);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_collideSphereBox(a3_DemoContactManifold *manifold_out, const a3real *center, const a3real radius, const a3_DemoCollider *box, const a3_DemoColliderPose *boxPose)
+{
+	if (manifold_out && center && box && boxPose)
+	{
+		const a3real *h = box->halfExtent, reach = radius + a3demo_contactMargin;
+		a3real d[3], local[3], q[3], diff[3], n[3], surface[3], dist2, dist, gap, best;
+		unsigned int i, k;
+
+		// sphere center in box space and the closest point of the box
+		a3demo_contactDiff(d, center, boxPose->position);
+		for (i = 0; i < 3; ++i)
+		{
+			local[i] = a3demo_contactDot(d, boxPose->rotation[i]);
+			q[i] = a3minimum(a3maximum(local[i], -h[i]), h[i]);
+		}
+		a3demo_contactDiff(diff, q, local);
+		dist2 = a3demo_contactDot(diff, diff);
+		manifold_out->count = 0;
+		if (dist2 > reach * reach)
+			return 0;
+
+		if (dist2 > a3realEpsilon)
+		{
+			// outside: normal from the center toward the closest point
+			dist = (a3real)sqrt(dist2);
+			n[0] = n[1] = n[2] = a3realZero;
+			for (i = 0; i < 3; ++i)
+				a3demo_contactMulAdd(n, n, boxPose->rotation[i], diff[i] / dist);
+			a3demo_contactBegin(manifold_out, n);
+			a3demo_contactMulAdd(surface, center, n, radius);
+			a3demo_contactAdd(manifold_out, surface, radius - dist, 0);
+		}
+		else
+		{
+			// inside: out through the nearest face
+			for (i = 1, k = 0, best = h[0] - a3absolute(local[0]); i < 3; ++i)
+			{
+				gap = h[i] - a3absolute(local[i]);
+				if (gap < best)
+				{
+					best = gap;
+					k = i;
+				}
+			}
+			gap = -a3demo_contactSign(local[k]);
+			n[0] = boxPose->rotation[k][0] * gap;
+			n[1] = boxPose->rotation[k][1] * gap;
+			n[2] = boxPose->rotation[k][2] * gap;
+			a3demo_contactBegin(manifold_out, n);
+			a3demo_contactMulAdd(surface, center, n, radius);
+			a3demo_contactAdd(manifold_out, surface, radius + best, 1 + k);
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_collideSphereCapsule(a3_DemoContactManifold *manifold_out, const a3real *center, const a3real radius, const a3_DemoCollider *capsule, const a3_DemoColliderPose *capsulePose)
+{
+	if (manifold_out && center && capsule && capsulePose)
+	{
+		a3real p0[3], p1[3], closest[3];
+		a3demo_contactCapsuleSegment(p0, p1, capsule, capsulePose);
+		a3demo_contactClosestOnSegment(closest, p0, p1, center);
+		return a3demo_collideSphereSphere(manifold_out, center, radius, closest, capsule->radius);
+	}
+	return -1;
+}
+
+int a3demo_collideBoxBox(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *boxA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *boxB, const a3_DemoColliderPose *poseB)
+{
+	if (manifold_out && boxA && poseA && boxB && poseB)
+	{
+		const a3real *a = boxA->halfExtent, *b = boxB->halfExtent;
+		const a3real *axisA[3] = { poseA->rotation[0], poseA->rotation[1], poseA->rotation[2] };
+		const a3real *axisB[3] = { poseB->rotation[0], poseB->rotation[1], poseB->rotation[2] };
+		a3real R[3][3], absR[3][3], t[3], tb[3], d[3], n[3], L[3];
+		a3real sep, len, bestFace, bestEdge, tl, ra, rb;
+		unsigned int i, j, i1, i2, j1, j2, faceAxis = 0, edgeI = 0, edgeJ = 0, useEdge = 0;
+
+		manifold_out->count = 0;
+		a3demo_contactDiff(d, poseB->position, poseA->position);
+		for (i = 0; i < 3; ++i)
+		{
+			for (j = 0; j < 3; ++j)
+			{
+				R[i][j] = a3demo_contactDot(axisA[i], axisB[j]);
+				absR[i][j] = a3absolute(R[i][j]) + 1.0e-6f;
+			}
+			t[i] = a3demo_contactDot(d, axisA[i]);
+			tb[i] = a3demo_contactDot(d, axisB[i]);
+		}
+
+		// separating axis test: faces of a (0-2), faces of b (3-5), then
+		//	edge pairs; keep the axis of least penetration, preferring faces
+		//	of a, then faces of b, unless an edge is clearly better; boxes
+		//	within the margin still get their (not yet touching) points
+		bestFace = -1.0e30f;
+		for (i = 0; i < 3; ++i)
+		{
+			sep = a3absolute(t[i]) - (a[i] + b[0] * absR[i][0] + b[1] * absR[i][1] + b[2] * absR[i][2]);
+			if (sep > a3demo_contactMargin)
+				return 0;
+			if (sep > bestFace)
+			{
+				bestFace = sep;
+				faceAxis = i;
+			}
+		}
+		for (j = 0; j < 3; ++j)
+		{
+			sep = a3absolute(tb[j]) - (a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j] + b[j]);
+			if (sep > a3demo_contactMargin)
+				return 0;
+			if (sep > bestFace * 0.95f + 0.001f)
+			{
+				bestFace = sep;
+				faceAxis = 3 + j;
+			}
+		}
+		bestEdge = -1.0e30f;
+		for (i = 0; i < 3; ++i)
+			for (j = 0; j < 3; ++j)
+			{
+				a3demo_contactCross(L, axisA[i], axisB[j]);
+				len = (a3real)sqrt(a3demo_contactDot(L, L));
+				if (len < 1.0e-4f)
+					continue;
+				i1 = (i + 1) % 3;
+				i2 = (i + 2) % 3;
+				j1 = (j + 1) % 3;
+				j2 = (j + 2) % 3;
+				ra = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+				rb = b[j1] * absR[i][j2] + b[j2] * absR[i][j1];
+				tl = t[i2] * R[i1][j] - t[i1] * R[i2][j];
+				sep = (a3absolute(tl) - (ra + rb)) / len;
+				if (sep > a3demo_contactMargin)
+					return 0;
+				if (sep > bestEdge)
+				{
+					bestEdge = sep;
+					edgeI = i;
+					edgeJ = j;
+				}
+			}
+		useEdge = bestEdge > bestFace * 0.95f + 0.001f;
+
+		if (useEdge)
+		{
+			// closest points between the two edges that face each other
+			a3real pa[3], pb[3], ea0[3], ea1[3], eb0[3], eb1[3], ca[3], cb[3], mid[3];
+			unsigned int k;
+			a3demo_contactCross(n, axisA[edgeI], axisB[edgeJ]);
+			len = (a3real)sqrt(a3demo_contactDot(n, n));
+			sep = a3demo_contactSign(a3demo_contactDot(n, d)) / len;
+			n[0] *= sep;
+			n[1] *= sep;
+			n[2] *= sep;
+			pa[0] = poseA->position[0];
+			pa[1] = poseA->position[1];
+			pa[2] = poseA->position[2];
+			pb[0] = poseB->position[0];
+			pb[1] = poseB->position[1];
+			pb[2] = poseB->position[2];
+			for (k = 0; k < 3; ++k)
+			{
+				if (k != edgeI)
+					a3demo_contactMulAdd(pa, pa, axisA[k], a[k] * a3demo_contactSign(a3demo_contactDot(axisA[k], n)));
+				if (k != edgeJ)
+					a3demo_contactMulAdd(pb, pb, axisB[k], -b[k] * a3demo_contactSign(a3demo_contactDot(axisB[k], n)));
+			}
+			a3demo_contactMulAdd(ea0, pa, axisA[edgeI], -a[edgeI]);
+			a3demo_contactMulAdd(ea1, pa, axisA[edgeI], a[edgeI]);
+			a3demo_contactMulAdd(eb0, pb, axisB[edgeJ], -b[edgeJ]);
+			a3demo_contactMulAdd(eb1, pb, axisB[edgeJ], b[edgeJ]);
+			a3demo_contactClosestSegments(ca, cb, ea0, ea1, eb0, eb1);
+			a3demo_contactBegin(manifold_out, n);
+			mid[0] = (ca[0] + cb[0]) * a3realHalf;
+			mid[1] = (ca[1] + cb[1]) * a3realHalf;
+			mid[2] = (ca[2] + cb[2]) * a3realHalf;
+			a3demo_contactMulAdd(ca, mid, n, -bestEdge * a3realHalf);
+			a3demo_contactAdd(manifold_out, ca, -bestEdge, a3demo_contactFeatureEdge | (edgeI * 3 + edgeJ));
+		}
+		else
+		{
+			// reference face on one box, incident face on the other, clipped
+			//	to the reference face's sides
+			const unsigned int flip = faceAxis >= 3, k = faceAxis % 3;
+			const a3real *const *refAxis = flip ? axisB : axisA, *const *incAxis = flip ? axisA : axisB;
+			const a3real *refHalf = flip ? b : a, *incHalf = flip ? a : b;
+			const a3real *refCenter = flip ? poseB->position : poseA->position;
+			const a3real *incCenter = flip ? poseA->position : poseB->position;
+			a3real refNormal[3], faceCenter[3], incFace[3], polyA[8][3], polyB[8][3], side[3], x[3];
+			unsigned int tagA[8], tagB[8], count, m, u1, u2, p;
+			a3real dot, best, depth, s;
+			a3_DemoContactCandidates candidates[1];
+
+			// reference normal points toward the incident box; the manifold
+			//	normal always points from a to b
+			s = a3demo_contactSign(flip ? -tb[k] : t[k]);
+			refNormal[0] = refAxis[k][0] * s;
+			refNormal[1] = refAxis[k][1] * s;
+			refNormal[2] = refAxis[k][2] * s;
+			a3demo_contactMulAdd(faceCenter, refCenter, refNormal, refHalf[k]);
+			n[0] = flip ? -refNormal[0] : refNormal[0];
+			n[1] = flip ? -refNormal[1] : refNormal[1];
+			n[2] = flip ? -refNormal[2] : refNormal[2];
+
+			// incident face: most anti-parallel to the reference normal
+			for (i = 0, m = 0, best = -a3realOne; i < 3; ++i)
+			{
+				dot = a3absolute(a3demo_contactDot(incAxis[i], refNormal));
+				if (dot > best)
+				{
+					best = dot;
+					m = i;
+				}
+			}
+			s = -a3demo_contactSign(a3demo_contactDot(incAxis[m], refNormal));
+			a3demo_contactMulAdd(incFace, incCenter, incAxis[m], incHalf[m] * s);
+			u1 = (m + 1) % 3;
+			u2 = (m + 2) % 3;
+			for (p = 0; p < 4; ++p)
+			{
+				const a3real s1 = (p == 0 || p == 3) ? a3realOne : -a3realOne, s2 = (p < 2) ? a3realOne : -a3realOne;
+				a3demo_contactMulAdd(polyA[p], incFace, incAxis[u1], incHalf[u1] * s1);
+				a3demo_contactMulAdd(polyA[p], polyA[p], incAxis[u2], incHalf[u2] * s2);
+				tagA[p] = p;
+			}
+
+			// clip against the four side planes
+			count = 4;
+			for (p = 0; p < 4 && count; ++p)
+			{
+				const unsigned int sideAxis = (k + 1 + (p >> 1)) % 3;
+				s = (p & 1) ? -a3realOne : a3realOne;
+				side[0] = refAxis[sideAxis][0] * s;
+				side[1] = refAxis[sideAxis][1] * s;
+				side[2] = refAxis[sideAxis][2] * s;
+				if (p & 1)
+				{
+					count = a3demo_contactClip(polyA, tagA, (const a3real(*)[3])polyB, tagB, count, side,
+						a3demo_contactDot(refCenter, side) + refHalf[sideAxis], p);
+				}
+				else
+				{
+					count = a3demo_contactClip(polyB, tagB, (const a3real(*)[3])polyA, tagA, count, side,
+						a3demo_contactDot(refCenter, side) + refHalf[sideAxis], p);
+				}
+			}
+
+			// keep points below the reference face (or nearly)
+			candidates->count = 0;
+			for (p = 0; p < count; ++p)
+			{
+				depth = a3demo_contactDot(faceCenter, refNormal) - a3demo_contactDot(polyA[p], refNormal);
+				if (depth >= -a3demo_contactMargin)
+				{
+					// halfway between the incident point and the reference face
+					a3demo_contactMulAdd(x, polyA[p], refNormal, depth * a3realHalf);
+					a3demo_contactAddCandidate(candidates, x, depth,
+						(flip ? a3demo_contactFeatureFlip : 0) | (k << 12) | (m << 10) | tagA[p]);
+				}
+			}
+			a3demo_contactBegin(manifold_out, n);
+			a3demo_contactReduce(manifold_out, candidates);
+		}
+		return manifold_out->count;
+	}
+	return -1;
+}
+
+int a3demo_collideCapsuleCapsule(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *capsuleA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *capsuleB, const a3_DemoColliderPose *poseB)
+{
+	if (manifold_out && capsuleA && poseA && capsuleB && poseB)
+	{
+		const a3real radius = capsuleA->radius + capsuleB->radius;
+		a3real p0[3], p1[3], q0[3], q1[3], c1[3], c2[3], n[3], d1[3], d2[3], cross[3], x[3], y[3], surface[3];
+		a3real dist2, dist, len1, len2, lo, hi, s0, s1, depth;
+		unsigned int k;
+
+		a3demo_contactCapsuleSegment(p0, p1, capsuleA, poseA);
+		a3demo_contactCapsuleSegment(q0, q1, capsuleB, poseB);
+		a3demo_contactClosestSegments(c1, c2, p0, p1, q0, q1);
+		a3demo_contactDiff(n, c2, c1);
+		dist2 = a3demo_contactDot(n, n);
+		manifold_out->count = 0;
+		if (dist2 > radius * radius)
+			return 0;
+
+		a3demo_contactDiff(d1, p1, p0);
+		a3demo_contactDiff(d2, q1, q0);
+		dist = (a3real)sqrt(dist2);
+		if (dist > a3realEpsilon)
+		{
+			n[0] /= dist;
+			n[1] /= dist;
+			n[2] /= dist;
+		}
+		else if (a3demo_contactDot(d1, d1) > a3realEpsilon)
+			a3demo_contactPerpendicular(n, d1);
+		else
+		{
+			n[0] = n[1] = a3realZero;
+			n[2] = a3realOne;
+		}
+		a3demo_contactBegin(manifold_out, n);
+
+		// nearly parallel and overlapping along the axis: two points, at
+		//	the ends of the overlap, so the pair can rest side by side
+		len1 = a3demo_contactDot(d1, d1);
+		len2 = a3demo_contactDot(d2, d2);
+		a3demo_contactCross(cross, d1, d2);
+		if (len1 > a3realEpsilon && len2 > a3realEpsilon && a3demo_contactDot(cross, cross) < 1.0e-4f * len1 * len2)
+		{
+			a3demo_contactDiff(x, q0, p0);
+			s0 = a3demo_contactDot(x, d1) / len1;
+			a3demo_contactDiff(x, q1, p0);
+			s1 = a3demo_contactDot(x, d1) / len1;
+			lo = a3maximum(a3minimum(s0, s1), a3realZero);
+			hi = a3minimum(a3maximum(s0, s1), a3realOne);
+			if (hi > lo + 1.0e-3f)
+			{
+				for (k = 0; k < 2; ++k)
+				{
+					a3demo_contactMulAdd(x, p0, d1, k ? hi : lo);
+					a3demo_contactClosestOnSegment(y, q0, q1, x);
+					a3demo_contactDiff(c2, y, x);
+					depth = radius - a3demo_contactDot(c2, n);
+					if (depth >= a3realZero)
+					{
+						a3demo_contactMulAdd(surface, x, n, capsuleA->radius);
+						a3demo_contactAdd(manifold_out, surface, depth, 1 + k);
+					}
+				}
+				if (manifold_out->count)
+					return manifold_out->count;
+			}
+		}
+
+		a3demo_contactMulAdd(surface, c1, n, capsuleA->radius);
+		a3demo_contactAdd(manifold_out, surface, radius - dist, 0);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_collideShapePlane(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *shape, const a3_DemoColliderPose *shapePose, const a3_DemoCollider *plane, const a3_DemoColliderPose *planePose)
+{
+	if (manifold_out && shape && shapePose && plane && planePose && plane->type == a3demo_collider_plane)
+	{
+		a3_DemoContactCandidates candidates[1], deepest[1];
+		a3real planeNormal[3], normal[3], center[3], axis[3], x[3], end[3], depth;
+		const a3real *planePoint = planePose->position;
+		unsigned int i, j, k, vertex;
+
+		// the plane pushes along its normal, so the manifold normal (shape
+		//	into plane) is the opposite
+		planeNormal[0] = planePose->rotation[plane->axis][0] * plane->axisSign;
+		planeNormal[1] = planePose->rotation[plane->axis][1] * plane->axisSign;
+		planeNormal[2] = planePose->rotation[plane->axis][2] * plane->axisSign;
+		normal[0] = -planeNormal[0];
+		normal[1] = -planeNormal[1];
+		normal[2] = -planeNormal[2];
+		a3demo_getColliderWorldFrame(shape, shapePose, center, axis);
+
+		// deepest surface points of the shape
+		candidates->count = 0;
+		switch (shape->type)
+		{
+		case a3demo_collider_sphere:
+			a3demo_contactMulAdd(x, center, planeNormal, -shape->radius);
+			a3demo_contactAddCandidate(candidates, x, a3realZero, 0);
+			break;
+		case a3demo_collider_box:
+			for (i = 0; i < 8; ++i)
+			{
+				a3demo_contactMulAdd(x, shapePose->position, shapePose->rotation[0], (i & 1) ? shape->halfExtent[0] : -shape->halfExtent[0]);
+				a3demo_contactMulAdd(x, x, shapePose->rotation[1], (i & 2) ? shape->halfExtent[1] : -shape->halfExtent[1]);
+				a3demo_contactMulAdd(x, x, shapePose->rotation[2], (i & 4) ? shape->halfExtent[2] : -shape->halfExtent[2]);
+				a3demo_contactAddCandidate(candidates, x, a3realZero, i);
+			}
+			break;
+		case a3demo_collider_capsule:
+			for (i = 0; i < 2; ++i)
+			{
+				a3demo_contactMulAdd(end, center, axis, i ? shape->halfLength : -shape->halfLength);
+				a3demo_contactMulAdd(x, end, planeNormal, -shape->radius);
+				a3demo_contactAddCandidate(candidates, x, a3realZero, i);
+			}
+			break;
+		case a3demo_collider_cylinder:
+			for (i = 0; i < 2; ++i)
+			{
+				a3demo_contactMulAdd(end, center, axis, i ? shape->halfLength : -shape->halfLength);
+				a3demo_contactRim(candidates, end, axis, shape->radius, planeNormal, i * 4);
+			}
+			break;
+		case a3demo_collider_cone:
+			a3demo_contactMulAdd(x, center, axis, shape->halfLength);
+			a3demo_contactAddCandidate(candidates, x, a3realZero, 8);
+			a3demo_contactMulAdd(end, center, axis, -shape->halfLength);
+			a3demo_contactRim(candidates, end, axis, shape->radius, planeNormal, 0);
+			break;
+		case a3demo_collider_hull:
+			// lowest vertex and the ones around it, by vertex index
+			if (!shape->hull || !shape->hull->vertexCount)
+				return -1;
+			for (i = 0; i < 3; ++i)
+				end[i] = a3demo_contactDot(normal, shapePose->rotation[i]);
+			vertex = a3demo_getConvexHullSupport(x, shape->hull, end, 0);
+			for (j = shape->hull->neighborStart[vertex]; j <= shape->hull->neighborStart[vertex + 1]; ++j)
+			{
+				k = j < shape->hull->neighborStart[vertex + 1] ? shape->hull->neighbor[j] : vertex;
+				memcpy(x, shapePose->position, sizeof(a3real3));
+				for (i = 0; i < 3; ++i)
+					a3demo_contactMulAdd(x, x, shapePose->rotation[i], shape->hull->vertex[k * 3 + i]);
+				a3demo_contactAddCandidate(candidates, x, a3realZero, k);
+			}
+			break;
+		default:
+			return -1;
+		}
+
+		// keep those below the plane (or nearly)
+		deepest->count = 0;
+		for (i = 0; i < candidates->count; ++i)
+		{
+			a3demo_contactDiff(x, candidates->point[i].position, planePoint);
+			depth = -a3demo_contactDot(x, planeNormal);
+			if (depth >= -a3demo_contactMargin)
+			{
+				a3demo_contactMulAdd(x, candidates->point[i].position, planeNormal, depth * a3realHalf);
+				a3demo_contactAddCandidate(deepest, x, depth, candidates->point[i].feature);
+			}
+		}
+		a3demo_contactBegin(manifold_out, normal);
+		a3demo_contactReduce(manifold_out, deepest);
+		return manifold_out->count;
+	}
+	return -1;
+}
+
+int a3demo_canCollideColliders(const a3_DemoColliderType typeA, const a3_DemoColliderType typeB)
+{
+	const a3_DemoColliderType lo = typeA < typeB ? typeA : typeB, hi = typeA < typeB ? typeB : typeA;
+	if (lo == a3demo_collider_none || hi >= a3demo_collider_count)
+		return 0;
+	if (hi == a3demo_collider_plane)
+		return lo != a3demo_collider_plane;
+	switch (lo)
+	{
+	case a3demo_collider_sphere:
+		return hi <= a3demo_collider_capsule;
+	case a3demo_collider_box:
+		return hi == a3demo_collider_box;
+	case a3demo_collider_capsule:
+		return hi == a3demo_collider_capsule;
+	default:
+		return 0;
+	}
+}
+
+int a3demo_collideColliders(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache)
+{
+	if (manifold_out && colliderA && poseA && colliderB && poseB)
+	{
+		const unsigned int swap = colliderA->type > colliderB->type;
+		const a3_DemoCollider *first = swap ? colliderB : colliderA, *second = swap ? colliderA : colliderB;
+		const a3_DemoColliderPose *firstPose = swap ? poseB : poseA, *secondPose = swap ? poseA : poseB;
+		a3real center[3], axis[3], center2[3];
+		int result = -1;
+		unsigned int i;
+
+		manifold_out->count = 0;
+		if (!a3demo_canCollideColliders(first->type, second->type))
+			return a3demo_collideConvex(manifold_out, colliderA, poseA, colliderB, poseB, cache);
+
+		if (second->type == a3demo_collider_plane)
+			result = a3demo_collideShapePlane(manifold_out, first, firstPose, second, secondPose);
+		else if (first->type == a3demo_collider_sphere)
+		{
+			a3demo_getColliderWorldFrame(first, firstPose, center, axis);
+			switch (second->type)
+			{
+			case a3demo_collider_sphere:
+				a3demo_getColliderWorldFrame(second, secondPose, center2, axis);
+				result = a3demo_collideSphereSphere(manifold_out, center, first->radius, center2, second->radius);
+				break;
+			case a3demo_collider_box:
+				result = a3demo_collideSphereBox(manifold_out, center, first->radius, second, secondPose);
+				break;
+			case a3demo_collider_capsule:
+				result = a3demo_collideSphereCapsule(manifold_out, center, first->radius, second, secondPose);
+				break;
+			default:
+				break;
+			}
+		}
+		else if (first->type == a3demo_collider_box)
+			result = a3demo_collideBoxBox(manifold_out, first, firstPose, second, secondPose);
+		else if (first->type == a3demo_collider_capsule)
+			result = a3demo_collideCapsuleCapsule(manifold_out, first, firstPose, second, secondPose);
+
+		// tests ran b against a: turn the normal around
+		if (swap && result > 0)
+			for (i = 0; i < 3; ++i)
+				manifold_out->normal[i] = -manifold_out->normal[i];
+		return result;
+	}
+	return -1;
+}
+
+int a3demo_collideConvex(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache)
+{
+	if (manifold_out)
+	{
+		a3_DemoGJKResult result[1];
+
+		manifold_out->count = 0;
+		if (a3demo_queryGJKPenetration(result, colliderA, poseA, colliderB, poseB, cache) < 0)
+			return -1;
+		if (result->distance <= a3demo_contactMargin)
+		{
+			a3demo_contactBegin(manifold_out, result->normal);
+			a3demo_contactAdd(manifold_out, result->pointA, -result->distance, 0);
+		}
+		return manifold_out->count;
+	}
+	return -1;
+}
+
+int a3demo_collideBodySpheres(a3_DemoContactManifold *manifold_out, const unsigned int maxManifolds, const a3_DemoBodyPair *pair, const unsigned int pairCount, const a3_DemoBodyStore *bodies)
+{
+	if (manifold_out && (pair || !pairCount) && bodies)
+	{
+		const a3real *px = bodies->posX, *py = bodies->posY, *pz = bodies->posZ, *radius = bodies->radius;
+		unsigned int hit[a3demo_contactBatch];
+		unsigned int first, count, i, written = 0;
+		a3real dx, dy, dz, r, centerA[3], centerB[3];
+
+		for (first = 0; first < pairCount && written < maxManifolds; first += count)
+		{
+			// straight-line test over a batch; the compiler is free to
+			//	vectorize this since nothing in it branches
+			count = a3minimum(pairCount - first, a3demo_contactBatch);
+			for (i = 0; i < count; ++i)
+			{
+				const unsigned int a = pair[first + i].a, b = pair[first + i].b;
+				dx = px[b] - px[a];
+				dy = py[b] - py[a];
+				dz = pz[b] - pz[a];
+				r = radius[a] + radius[b];
+				hit[i] = dx * dx + dy * dy + dz * dz <= r * r;
+			}
+
+			// full manifolds only for the pairs that touch
+			for (i = 0; i < count && written < maxManifolds; ++i)
+				if (hit[i])
+				{
+					const unsigned int a = pair[first + i].a, b = pair[first + i].b;
+					centerA[0] = px[a];
+					centerA[1] = py[a];
+					centerA[2] = pz[a];
+					centerB[0] = px[b];
+					centerB[1] = py[b];
+					centerB[2] = pz[b];
+					if (a3demo_collideSphereSphere(manifold_out + written, centerA, radius[a], centerB, radius[b]) > 0)
+					{
+						manifold_out[written].a = a;
+						manifold_out[written].b = b;
+						++written;
+					}
+				}
+		}
+		return written;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
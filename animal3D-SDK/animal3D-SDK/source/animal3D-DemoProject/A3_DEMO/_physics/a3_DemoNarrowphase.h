@@ -0,0 +1,123 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoNarrowphase.h
+	Contact manifolds between analytic colliders.
+*/
+
+#ifndef __ANIMAL3D_DEMONARROWPHASE_H
+#define __ANIMAL3D_DEMONARROWPHASE_H
+
+
+#include "a3_DemoCollider.h"
+#include "a3_DemoBroadphase.h"
+#include "a3_DemoGJK.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoContactPoint		a3_DemoContactPoint;
+	typedef struct a3_DemoContactManifold	a3_DemoContactManifold;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// narrowphase constants
+	enum a3_DemoNarrowphaseConstants
+	{
+		a3demo_contactMaxPoints = 4,	// points kept per manifold
+	};
+
+
+	// one contact point, halfway between the two surfaces
+	//	member feature: identifies the pair of features that made the
+	//		point, stable while the shapes stay in the same configuration,
+	//		so solvers can match points from one step to the next
+	struct a3_DemoContactPoint
+	{
+		a3real3 position;
+		a3real depth;					// penetration; positive when overlapping
+		unsigned int feature;
+	};
+
+	// contact manifold between two shapes; the normal points from the
+	//	first shape (a) into the second (b)
+	// face and plane contacts keep points that are up to a centimeter
+	//	apart (negative depth) so that resting contacts do not flicker
+	//	member gjk: query state for pairs that go to GJK; the caller keeps
+	//		it per pair for the next step (see a3_DemoRigidWorld)
+	struct a3_DemoContactManifold
+	{
+		a3real3 normal;
+		a3_DemoContactPoint point[a3demo_contactMaxPoints];
+		unsigned int count;
+		unsigned int a, b;				// caller's indices for the two shapes
+		a3_DemoGJKCache gjk;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// contacts between two posed colliders; pairs are dispatched by type
+	//	and swapped as needed (the normal still points from a to b); pairs
+	//	with no analytic test (e.g. cylinder/box, hulls) go to GJK
+	//	param cache: optional, kept per pair across frames; only used by
+	//		pairs that go to GJK
+	//	-> returns point count (0 if separated), or -1 if invalid params
+	//		or the pair cannot collide (plane/plane)
+	int a3demo_collideColliders(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache);
+
+	// contact between any two convex colliders other than planes, by GJK
+	//	and EPA: a single point, between the deepest (or closest) points
+	//	param cache: optional, kept per pair across frames
+	//	-> returns point count (0 if separated), -1 if invalid params
+	int a3demo_collideConvex(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *colliderA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *colliderB, const a3_DemoColliderPose *poseB, a3_DemoGJKCache *cache);
+
+	// whether the pair of types has an analytic test
+	int a3demo_canCollideColliders(const a3_DemoColliderType typeA, const a3_DemoColliderType typeB);
+
+	// individual tests in canonical order (normal from first to second)
+	int a3demo_collideSphereSphere(a3_DemoContactManifold *manifold_out, const a3real *centerA, const a3real radiusA, const a3real *centerB, const a3real radiusB);
+	int a3demo_collideSphereBox(a3_DemoContactManifold *manifold_out, const a3real *center, const a3real radius, const a3_DemoCollider *box, const a3_DemoColliderPose *boxPose);
+	int a3demo_collideSphereCapsule(a3_DemoContactManifold *manifold_out, const a3real *center, const a3real radius, const a3_DemoCollider *capsule, const a3_DemoColliderPose *capsulePose);
+	int a3demo_collideBoxBox(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *boxA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *boxB, const a3_DemoColliderPose *poseB);
+	int a3demo_collideCapsuleCapsule(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *capsuleA, const a3_DemoColliderPose *poseA, const a3_DemoCollider *capsuleB, const a3_DemoColliderPose *poseB);
+	int a3demo_collideShapePlane(a3_DemoContactManifold *manifold_out, const a3_DemoCollider *shape, const a3_DemoColliderPose *shapePose, const a3_DemoCollider *plane, const a3_DemoColliderPose *planePose);
+
+	// sphere/sphere for every broadphase pair of bodies, using each
+	//	body's radius; branch-free test pass, then a compaction pass
+	//	-> returns manifolds written (at most maxManifolds)
+	int a3demo_collideBodySpheres(a3_DemoContactManifold *manifold_out, const unsigned int maxManifolds, const a3_DemoBodyPair *pair, const unsigned int pairCount, const a3_DemoBodyStore *bodies);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMONARROWPHASE_H
@@ -0,0 +1,1885 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPhysicsBenchmark.c
+	Physics benchmark implementations.
+*/
+
+#include "a3_DemoPhysicsBenchmark.h"
+#include "a3_DemoGravity.h"
+#include "a3_DemoIntegrator.h"
+#include "a3_DemoBroadphase.h"
+#include "a3_DemoRigidWorld.h"
+#include "a3_DemoSoftBody.h"
+#include "a3_DemoMassProperties.h"
+#include "a3_DemoConvexHull.h"
+#include "a3_DemoGJK.h"
+#include "a3_DemoMeshBVH.h"
+#include "../_utilities/a3_DemoRandom.h"
+
+#include "animal3D/a3utility/a3_Timer.h"
+#include "animal3D/a3graphics/a3geometry/a3_ProceduralGeometry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// uniform random in [0, 1)
+static inline a3real a3demo_benchmarkRandom()
+{
+	return (a3real)rand() / ((a3real)RAND_MAX + a3realOne);
+}
+
+// seconds since the last lap
+inline double a3demo_benchmarkLap(a3_Timer *timer)
+{
+	return (a3timerUpdate(timer) > 0) ? timer->previousTick : 0.0;
+}
+
+// collider fitted to a shape's generated mesh
+int a3demo_benchmarkCollider(a3_DemoCollider *collider_out, const a3_ProceduralGeometryDescriptor *shape)
+{
+	a3_GeometryData data[1] = { 0 };
+	int status;
+	a3proceduralGenerateGeometryData(data, shape);
+	status = a3demo_createColliderFromGeometry(collider_out, shape, data);
+	a3geometryReleaseData(data);
+	return status;
+}
+
+// pair order for comparing broadphase outputs
+int a3demo_benchmarkComparePairs(const a3_DemoBodyPair *a, const a3_DemoBodyPair *b)
+{
+	return a->a != b->a ? (a->a < b->a ? -1 : 1) : a->b != b->b ? (a->b < b->b ? -1 : 1) : 0;
+}
+
+// sorted copy of a broadphase's pairs
+a3_DemoBodyPair *a3demo_benchmarkSortedPairs(const a3_DemoBroadphase *broadphase)
+{
+	a3_DemoBodyPair *pair = (a3_DemoBodyPair *)malloc((broadphase->pairCount + 1) * sizeof(a3_DemoBodyPair));
+	if (pair)
+	{
+		memcpy(pair, broadphase->pair, broadphase->pairCount * sizeof(a3_DemoBodyPair));
+		qsort(pair, broadphase->pairCount, sizeof(a3_DemoBodyPair), (int(*)(const void *, const void *))a3demo_benchmarkComparePairs);
+	}
+	return pair;
+}
+
+
+// one volley at a thin slab: bodies that end up on the far side of it
+//	(and still over it) went through; time is per 60 Hz step
+int a3demo_benchmarkVolley(double *time_out, unsigned int *impacts_out, const a3_DemoCollider *shape, const a3real speed, const a3real sweepThreshold, const unsigned int substeps, a3_DemoJobSystem *jobs)
+{
+	const unsigned int count = 1000, side = 32, steps = 60;
+	const a3real dt = a3recip(60.0f), slabSize = 80.0f, slabHalfThickness = 0.05f, spacing = 2.0f;
+	a3_DemoRigidWorld world[1];
+	a3_DemoCollider slab[1];
+	a3_DemoRigidBody body[1];
+	a3_Timer timer[1];
+	unsigned int i, step, substep, through = 0;
+	const a3real *p;
+
+	if (a3demo_createRigidWorld(world, count + 1, jobs) < 0)
+		return -1;
+	world->sweepThreshold = sweepThreshold;
+	world->sleepSteps = 0;
+	a3demo_createColliderBox(slab, slabSize, slabSize, slabHalfThickness + slabHalfThickness);
+	a3demo_initRigidBody(body, slab, a3realZero, a3realZero, a3realZero, -slabHalfThickness);
+	a3demo_addRigidBody(world, body);
+	for (i = 0; i < count; ++i)
+	{
+		a3demo_initRigidBody(body, shape, a3realOne, ((i % side) - side / 2) * spacing, ((i / side) - side / 2) * spacing, 3.0f + 0.5f * a3demo_benchmarkRandom());
+		body->velocity[2] = -speed;
+		body->angularVelocity[0] = 20.0f * a3demo_benchmarkRandom();
+		body->angularVelocity[1] = 20.0f * a3demo_benchmarkRandom();
+		a3demo_addRigidBody(world, body);
+	}
+
+	*impacts_out = 0;
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	a3demo_benchmarkLap(timer);
+	for (step = 0; step < steps; ++step)
+		for (substep = 0; substep < substeps; ++substep)
+		{
+			a3demo_stepRigidWorld(world, dt / (a3real)substeps);
+			*impacts_out += world->impactCount;
+		}
+	*time_out = a3demo_benchmarkLap(timer) / steps;
+	a3timerStop(timer);
+
+	for (i = 1; i <= count; ++i)
+	{
+		p = world->body[i].pose.position;
+		through += p[2] < -slabHalfThickness && fabs(p[0]) < slabSize * a3realHalf && fabs(p[1]) < slabSize * a3realHalf;
+	}
+	a3demo_releaseRigidWorld(world);
+	return through;
+}
+
+// random rotation from a random unit quaternion, nudged by a small
+//	rotation step times a frame number
+void a3demo_benchmarkRandomRotation(a3real *q_out)
+{
+	a3real length;
+	do
+	{
+		q_out[0] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+		q_out[1] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+		q_out[2] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+		q_out[3] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+		length = q_out[0] * q_out[0] + q_out[1] * q_out[1] + q_out[2] * q_out[2] + q_out[3] * q_out[3];
+	} while (length > a3realOne || length < 0.01f);
+	length = a3recip((a3real)sqrt(length));
+	q_out[0] *= length;
+	q_out[1] *= length;
+	q_out[2] *= length;
+	q_out[3] *= length;
+}
+
+// collider pose with its center (not its origin) at a point, turned by
+//	the normalized sum of a quaternion and a multiple of another
+void a3demo_benchmarkPose(a3_DemoColliderPose *pose_out, const a3_DemoCollider *collider, const a3real *center, const a3real *q, const a3real *dq, const a3real t)
+{
+	a3real x, y, z, w, length, c[3], axis[3];
+	x = q[0] + dq[0] * t;
+	y = q[1] + dq[1] * t;
+	z = q[2] + dq[2] * t;
+	w = q[3] + dq[3] * t;
+	length = a3recip((a3real)sqrt(x * x + y * y + z * z + w * w));
+	x *= length;
+	y *= length;
+	z *= length;
+	w *= length;
+	pose_out->rotation[0][0] = a3realOne - a3realTwo * (y * y + z * z);
+	pose_out->rotation[0][1] = a3realTwo * (x * y + z * w);
+	pose_out->rotation[0][2] = a3realTwo * (x * z - y * w);
+	pose_out->rotation[1][0] = a3realTwo * (x * y - z * w);
+	pose_out->rotation[1][1] = a3realOne - a3realTwo * (x * x + z * z);
+	pose_out->rotation[1][2] = a3realTwo * (y * z + x * w);
+	pose_out->rotation[2][0] = a3realTwo * (x * z + y * w);
+	pose_out->rotation[2][1] = a3realTwo * (y * z - x * w);
+	pose_out->rotation[2][2] = a3realOne - a3realTwo * (x * x + y * y);
+	memcpy(pose_out->position, center, sizeof(a3real3));
+	a3demo_getColliderWorldFrame(collider, pose_out, c, axis);
+	pose_out->position[0] += center[0] - c[0];
+	pose_out->position[1] += center[1] - c[1];
+	pose_out->position[2] += center[2] - c[2];
+}
+
+// nearest hit of a ray over every triangle (Moller-Trumbore in double)
+//	-> returns distance, or the limit if none
+double a3demo_benchmarkRayBrute(const a3_DemoMeshBVH *mesh, const a3real *origin, const a3real *direction, double limit)
+{
+	const float *v;
+	double e1[3], e2[3], p[3], s[3], q[3], det, u, w, t;
+	unsigned int i, k;
+	for (i = 0, v = mesh->triangle; i < mesh->triangleCount; ++i, v += 9)
+	{
+		for (k = 0; k < 3; ++k)
+		{
+			e1[k] = (double)v[3 + k] - (double)v[k];
+			e2[k] = (double)v[6 + k] - (double)v[k];
+			s[k] = (double)origin[k] - (double)v[k];
+		}
+		p[0] = direction[1] * e2[2] - direction[2] * e2[1];
+		p[1] = direction[2] * e2[0] - direction[0] * e2[2];
+		p[2] = direction[0] * e2[1] - direction[1] * e2[0];
+		det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+		if (det == 0.0)
+			continue;
+		u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+		q[0] = s[1] * e1[2] - s[2] * e1[1];
+		q[1] = s[2] * e1[0] - s[0] * e1[2];
+		q[2] = s[0] * e1[1] - s[1] * e1[0];
+		w = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) / det;
+		t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+		if (u >= 0.0 && w >= 0.0 && u + w <= 1.0 && t >= 0.0 && t < limit)
+			limit = t;
+	}
+	return limit;
+}
+
+// distance from a point to the nearest triangle, by sampling each
+//	triangle's closest point (projection clamped to its edges)
+double a3demo_benchmarkPointBrute(const a3_DemoMeshBVH *mesh, const double *point)
+{
+	const float *v;
+	double a[3], ab[3], ac[3], ap[3], n[3], x[3], best = 1.0e30, d, u, w, t, len;
+	unsigned int i, k, e;
+	for (i = 0, v = mesh->triangle; i < mesh->triangleCount; ++i, v += 9)
+	{
+		for (k = 0; k < 3; ++k)
+		{
+			a[k] = v[k];
+			ab[k] = (double)v[3 + k] - a[k];
+			ac[k] = (double)v[6 + k] - a[k];
+			ap[k] = point[k] - a[k];
+		}
+		n[0] = ab[1] * ac[2] - ab[2] * ac[1];
+		n[1] = ab[2] * ac[0] - ab[0] * ac[2];
+		n[2] = ab[0] * ac[1] - ab[1] * ac[0];
+		len = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+
+		// inside the face: distance to the plane
+		if (len > 0.0)
+		{
+			t = (ap[0] * n[0] + ap[1] * n[1] + ap[2] * n[2]) / len;
+			for (k = 0; k < 3; ++k)
+				x[k] = ap[k] - n[k] * t;
+			d = (ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2]) * (ac[0] * ac[0] + ac[1] * ac[1] + ac[2] * ac[2]) - (ab[0] * ac[0] + ab[1] * ac[1] + ab[2] * ac[2]) * (ab[0] * ac[0] + ab[1] * ac[1] + ab[2] * ac[2]);
+			u = ((ac[0] * ac[0] + ac[1] * ac[1] + ac[2] * ac[2]) * (x[0] * ab[0] + x[1] * ab[1] + x[2] * ab[2]) - (ab[0] * ac[0] + ab[1] * ac[1] + ab[2] * ac[2]) * (x[0] * ac[0] + x[1] * ac[1] + x[2] * ac[2])) / d;
+			w = ((ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2]) * (x[0] * ac[0] + x[1] * ac[1] + x[2] * ac[2]) - (ab[0] * ac[0] + ab[1] * ac[1] + ab[2] * ac[2]) * (x[0] * ab[0] + x[1] * ab[1] + x[2] * ab[2])) / d;
+			if (u >= 0.0 && w >= 0.0 && u + w <= 1.0)
+				best = a3minimum(best, fabs(t) * sqrt(len));
+		}
+
+		// otherwise an edge
+		for (e = 0; e < 3; ++e)
+		{
+			for (k = 0; k < 3; ++k)
+			{
+				a[k] = v[e * 3 + k];
+				ab[k] = (double)v[(e + 1) % 3 * 3 + k] - a[k];
+				ap[k] = point[k] - a[k];
+			}
+			len = ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2];
+			t = len > 0.0 ? (ap[0] * ab[0] + ap[1] * ab[1] + ap[2] * ab[2]) / len : 0.0;
+			t = t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t;
+			for (k = 0; k < 3; ++k)
+				x[k] = ap[k] - ab[k] * t;
+			best = a3minimum(best, sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]));
+		}
+	}
+	return best;
+}
+
+// nearest body sphere along a ray by testing every body
+//	-> returns distance (units of the direction's length), the limit if
+//		none is hit
+double a3demo_benchmarkPickBrute(unsigned int *object_out, const a3_DemoBodyStore *store, const a3real *origin, const a3real *direction, const a3real pickRadius, double limit)
+{
+	double m[3], a, b, c, r, discriminant, t;
+	unsigned int i;
+	*object_out = (unsigned int)-1;
+	a = (double)direction[0] * direction[0] + (double)direction[1] * direction[1] + (double)direction[2] * direction[2];
+	for (i = 0; i < store->count; ++i)
+	{
+		r = a3maximum(store->radius[i], pickRadius);
+		m[0] = (double)origin[0] - store->posX[i];
+		m[1] = (double)origin[1] - store->posY[i];
+		m[2] = (double)origin[2] - store->posZ[i];
+		b = m[0] * direction[0] + m[1] * direction[1] + m[2] * direction[2];
+		c = m[0] * m[0] + m[1] * m[1] + m[2] * m[2] - r * r;
+		discriminant = b * b - a * c;
+		if (c <= 0.0)
+			t = 0.0;
+		else if (b >= 0.0 || discriminant < 0.0)
+			continue;
+		else
+			t = (-b - sqrt(discriminant)) / a;
+		if (t < limit)
+		{
+			limit = t;
+			*object_out = i;
+		}
+	}
+	return limit;
+}
+
+// distance from a point to a body's sphere, zero inside
+a3real a3demo_benchmarkSphereDistance(const a3_DemoBodyStore *store, const unsigned int object, const a3real *point)
+{
+	const a3real x = point[0] - store->posX[object], y = point[1] - store->posY[object], z = point[2] - store->posZ[object];
+	const a3real d = (a3real)sqrt(x * x + y * y + z * z) - store->radius[object];
+	return d > a3realZero ? d : a3realZero;
+}
+
+// put a body's box where the body is now
+inline int a3demo_benchmarkMoveBox(a3_DemoDynamicTree *tree, const a3_DemoBodyStore *store, const unsigned int i)
+{
+	const a3real r = store->radius[i];
+	const a3real boundsMin[3] = { store->posX[i] - r, store->posY[i] - r, store->posZ[i] - r };
+	const a3real boundsMax[3] = { store->posX[i] + r, store->posY[i] + r, store->posZ[i] + r };
+	return a3demo_moveDynamicTreeObject(tree, i, boundsMin, boundsMax);
+}
+
+// whether a box is wholly behind any of a frustum's planes
+int a3demo_benchmarkBoxCulled(const a3real *planes, const a3real *boundsMin, const a3real *boundsMax)
+{
+	const a3real *plane;
+	unsigned int p;
+	for (p = 0; p < 6; ++p)
+	{
+		plane = planes + p * 4;
+		if (plane[3] +
+			plane[0] * (plane[0] >= a3realZero ? boundsMax[0] : boundsMin[0]) +
+			plane[1] * (plane[1] >= a3realZero ? boundsMax[1] : boundsMin[1]) +
+			plane[2] * (plane[2] >= a3realZero ? boundsMax[2] : boundsMin[2]) < a3realZero)
+			return 1;
+	}
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int a3demo_generateBodyCluster(a3_DemoBodyStore *store, const unsigned int count, const a3real radius, const unsigned int seed)
+{
+	if (store && store->memory)
+	{
+		const a3real mass = a3recip((a3real)count);
+		a3real *const x = (a3real *)malloc(count * 4 * sizeof(a3real)), *const y = x + count, *const z = y + count, *const u = z + count;
+		a3_DemoRandom rng[1];
+		a3real position[3], r;
+		unsigned int i;
+		if (!x)
+			return -1;
+
+		// uniform directions, and Plummer radii from the inverse CDF,
+		//	clipped to keep the box sane
+		a3demo_seedRandom(rng, seed);
+		a3demo_fillRandomSphere(x, y, z, rng, count, a3realOne, 0);
+		a3demo_fillRandomUniform(u, rng, count, 0.005f, 0.995f, 0);
+		for (i = 0; i < count; ++i)
+		{
+			r = radius / sqrtf(powf(u[i], -2.0f / 3.0f) - a3realOne);
+			r = a3minimum(r, radius * 10.0f);
+			position[0] = r * x[i];
+			position[1] = r * y[i];
+			position[2] = r * z[i];
+
+			if (a3demo_addBody(store, position, 0, mass, radius * 0.01f) < 0)
+				break;
+		}
+		free(x);
+		return i;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_benchmarkGravity(const a3real theta, a3_DemoJobSystem *jobs)
+{
+	const unsigned int counts[] = { 1000, 10000, 100000 };
+	const unsigned int reps[] = { 20, 5, 2 };
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts);
+	const unsigned int maxSamples = 1000;
+	const a3real gravity = a3realOne, softening = 0.01f;
+
+	a3_DemoBodyStore store[1] = { 0 };
+	a3_DemoGravityTree tree[1];
+	a3_Timer timer[1];
+	a3real *sample;
+	double buildTime, walkTime, bruteTime, errorSq, magSq, dx, dy, dz;
+	unsigned int c, n, r, i, samples;
+
+	if (a3demo_createBodyStore(store, counts[numCounts - 1]) < 0)
+		return -1;
+	sample = (a3real *)malloc(maxSamples * 3 * sizeof(a3real));
+	if (!sample)
+	{
+		a3demo_releaseBodyStore(store);
+		return -1;
+	}
+
+	a3demo_initGravityTree(tree, gravity, softening, theta, 8, jobs);
+	a3timerSet(timer, 0.0);
+
+	printf("\n GRAVITY BENCHMARK (theta = %.2f, %u workers, %s integration)",
+		theta, jobs ? jobs->workerCount : 1, a3demo_getBodyStoreKernelName());
+	for (c = 0; c < numCounts; ++c)
+	{
+		n = counts[c];
+		samples = a3minimum(n, maxSamples);
+		a3demo_clearBodyStore(store);
+		a3demo_generateBodyCluster(store, n, a3realOne, 1234 + c);
+
+		// tree: build and walk timed separately
+		buildTime = walkTime = 0.0;
+		a3timerStart(timer);
+		for (r = 0; r < reps[c]; ++r)
+		{
+			a3demo_clearBodyAccelerations(store);
+			a3demo_benchmarkLap(timer);
+			if (a3demo_buildGravityTree(tree, store) < 0)
+			{
+				printf("\n  N = %6u | tree build failed (out of memory)\n", n);
+				a3demo_releaseGravityTree(tree);
+				a3demo_releaseBodyStore(store);
+				free(sample);
+				return -1;
+			}
+			buildTime += a3demo_benchmarkLap(timer);
+			a3demo_applyGravityTree(tree, store, 0, n);
+			walkTime += a3demo_benchmarkLap(timer);
+		}
+		buildTime /= (double)reps[c];
+		walkTime /= (double)reps[c];
+		for (i = 0; i < samples; ++i)
+		{
+			sample[i * 3 + 0] = store->accX[i];
+			sample[i * 3 + 1] = store->accY[i];
+			sample[i * 3 + 2] = store->accZ[i];
+		}
+
+		// brute force on a sample of targets, scaled up to all bodies
+		a3demo_clearBodyAccelerations(store);
+		a3demo_benchmarkLap(timer);
+		a3demo_applyGravityBruteForce(store, gravity, softening, 0, samples);
+		bruteTime = a3demo_benchmarkLap(timer) * (double)n / (double)samples;
+		a3timerStop(timer);
+
+		// tree error relative to exact
+		errorSq = magSq = 0.0;
+		for (i = 0; i < samples; ++i)
+		{
+			dx = sample[i * 3 + 0] - store->accX[i];
+			dy = sample[i * 3 + 1] - store->accY[i];
+			dz = sample[i * 3 + 2] - store->accZ[i];
+			errorSq += dx * dx + dy * dy + dz * dz;
+			magSq += store->accX[i] * store->accX[i] + store->accY[i] * store->accY[i] + store->accZ[i] * store->accZ[i];
+		}
+
+		printf("\n  N = %6u | tree: build %9.3f ms, walk %9.3f ms, %6u nodes | brute: %10.3f ms%s | speedup %7.1fx | rms error %.2e",
+			n, buildTime * 1000.0, walkTime * 1000.0, tree->nodeCount,
+			bruteTime * 1000.0, samples < n ? " (est.)" : "       ",
+			bruteTime / (buildTime + walkTime), magSq > 0.0 ? sqrt(errorSq / magSq) : 0.0);
+	}
+	printf("\n");
+
+	a3demo_releaseGravityTree(tree);
+	a3demo_releaseBodyStore(store);
+	free(sample);
+	return numCounts;
+}
+
+int a3demo_benchmarkIntegrators(const unsigned int steps, const a3real dt)
+{
+	const a3real gravity = a3realOne, softening = 0.05f, sunMass = 12.0f, planetMass = 0.001f;
+	const unsigned int planets = 4, sampleInterval = 1000;
+
+	a3_DemoBodyStore store[1] = { 0 };
+	a3_DemoGravityTree tree[1];
+	a3_DemoIntegrator integrator[1];
+	a3_Timer timer[1];
+	a3real position[3], velocity[3];
+	double kinetic, potential, energy0, energy, drift, maxDrift, momentum0[3], momentum[3], momentumDrift, seconds;
+	unsigned int type, step, i;
+
+	if (a3demo_createBodyStore(store, planets + 1) < 0)
+		return -1;
+
+	// theta of zero opens every cell, so forces are exact and all drift
+	//	comes from the integrator
+	a3demo_initGravityTree(tree, gravity, softening, a3realZero, 8, 0);
+	a3timerSet(timer, 0.0);
+
+	printf("\n INTEGRATOR BENCHMARK (%u steps, dt = %g s, sun + %u planets)", steps, dt, planets);
+	for (type = 0; type < a3demo_integrator_count; ++type)
+	{
+		// fresh circular orbits
+		a3demo_clearBodyStore(store);
+		position[0] = position[1] = position[2] = velocity[0] = velocity[1] = velocity[2] = a3realZero;
+		a3demo_addBody(store, position, velocity, sunMass, a3realOne);
+		for (i = 1; i <= planets; ++i)
+		{
+			position[0] = a3realFour * (a3real)i;
+			velocity[1] = sqrtf(gravity * sunMass / position[0]);
+			a3demo_addBody(store, position, velocity, planetMass, a3realHalf);
+		}
+		a3demo_initIntegrator(integrator, (a3_DemoIntegratorType)type, (a3_DemoAccelerationFunc)a3demo_accelerateGravityTree, tree);
+
+		a3demo_getGravityEnergy(store, gravity, softening, &kinetic, &potential);
+		energy0 = kinetic + potential;
+		a3demo_getBodyStoreAngularMomentum(store, momentum0);
+		maxDrift = 0.0;
+		seconds = 0.0;
+
+		a3timerStart(timer);
+		for (step = 1; step <= steps; ++step)
+		{
+			a3demo_stepIntegrator(integrator, store, dt);
+
+			// energy checks stay out of the timing
+			if (step % sampleInterval == 0 || step == steps)
+			{
+				seconds += a3demo_benchmarkLap(timer);
+				a3demo_getGravityEnergy(store, gravity, softening, &kinetic, &potential);
+				drift = fabs((kinetic + potential - energy0) / energy0);
+				maxDrift = a3maximum(maxDrift, drift);
+				a3demo_benchmarkLap(timer);
+			}
+		}
+		a3timerStop(timer);
+
+		a3demo_getGravityEnergy(store, gravity, softening, &kinetic, &potential);
+		energy = kinetic + potential;
+		a3demo_getBodyStoreAngularMomentum(store, momentum);
+		momentumDrift = sqrt(
+			(momentum[0] - momentum0[0]) * (momentum[0] - momentum0[0]) +
+			(momentum[1] - momentum0[1]) * (momentum[1] - momentum0[1]) +
+			(momentum[2] - momentum0[2]) * (momentum[2] - momentum0[2])) /
+			sqrt(momentum0[0] * momentum0[0] + momentum0[1] * momentum0[1] + momentum0[2] * momentum0[2]);
+
+		printf("\n  %-20s | %8.1f ns/body/step, %4.1f forces/step | energy drift %.2e (max %.2e) | angular momentum drift %.2e",
+			a3demo_getIntegratorName((a3_DemoIntegratorType)type),
+			seconds * 1.0e9 / ((double)steps * (double)store->count),
+			(double)integrator->evaluations / (double)steps,
+			fabs((energy - energy0) / energy0), maxDrift, momentumDrift);
+
+		a3demo_releaseIntegrator(integrator);
+	}
+	printf("\n");
+
+	a3demo_releaseGravityTree(tree);
+	a3demo_releaseBodyStore(store);
+	return a3demo_integrator_count;
+}
+
+
+int a3demo_benchmarkBroadphase(const unsigned int steps, a3_DemoJobSystem *jobs)
+{
+	const unsigned int counts[] = { 10000, 100000 };
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts);
+	const char *distribution[] = { "uniform", "clustered" };
+	const a3real radius = a3realHalf, spacing = 2.5f, dt = 0.02f;
+
+	// one broadphase per strategy, plus a serial spatial hash for scaling
+	enum { strategies = a3demo_broadphase_count, serialHash = a3demo_broadphase_count, runs };
+
+	a3_DemoBodyStore store[1] = { 0 };
+	a3_DemoBroadphase broadphase[runs];
+	a3_DemoBodyPair *pairs[runs];
+	a3_DemoRandom rng[1];
+	a3_Timer timer[1];
+	double first[runs], total[runs];
+	unsigned int swaps[runs];
+	unsigned int c, d, r, i, step, n, matched, passed = 1;
+	a3real position[3], side;
+
+	if (a3demo_createBodyStore(store, counts[numCounts - 1]) < 0)
+		return -1;
+	for (r = 0; r < runs; ++r)
+		a3demo_initBroadphase(broadphase + r, r == serialHash ? a3demo_broadphase_spatialHash : (a3_DemoBroadphaseType)r, r == serialHash ? 0 : jobs);
+	a3timerSet(timer, 0.0);
+
+	printf("\n BROADPHASE BENCHMARK (%u steps, sphere radius %.2f, %u workers)", steps, radius, jobs ? jobs->workerCount : 1);
+	for (c = 0; c < numCounts; ++c)
+	{
+		n = counts[c];
+		side = spacing * (a3real)pow((double)n, 1.0 / 3.0);
+		for (d = 0; d < 2; ++d)
+		{
+			// uniform cube at fixed average spacing, or a Plummer cluster of
+			//	the same bodies packed into the middle of it
+			a3demo_clearBodyStore(store);
+			if (d == 0)
+			{
+				a3demo_seedRandom(rng, 4321 + c);
+				for (i = 0; i < n; ++i)
+				{
+					position[0] = a3demo_randomRange(rng, -side * a3realHalf, side * a3realHalf);
+					position[1] = a3demo_randomRange(rng, -side * a3realHalf, side * a3realHalf);
+					position[2] = a3demo_randomRange(rng, -side * a3realHalf, side * a3realHalf);
+					a3demo_addBody(store, position, 0, a3realOne, radius);
+				}
+			}
+			else
+				a3demo_generateBodyCluster(store, n, side * 0.125f, 4321 + c);
+			a3demo_seedRandom(rng, 8765 + c);
+			for (i = 0; i < n; ++i)
+			{
+				store->radius[i] = radius;
+				store->velX[i] = a3demo_randomRange(rng, -a3realOne, a3realOne);
+				store->velY[i] = a3demo_randomRange(rng, -a3realOne, a3realOne);
+				store->velZ[i] = a3demo_randomRange(rng, -a3realOne, a3realOne);
+			}
+
+			// first update sorts from scratch; the rest move bodies a little
+			//	each step and reuse the previous order
+			for (r = 0; r < runs; ++r)
+			{
+				a3demo_setBroadphaseType(broadphase + r, broadphase[r].type);
+				total[r] = 0.0;
+				swaps[r] = 0;
+			}
+			a3timerStart(timer);
+			for (r = 0; r < runs; ++r)
+			{
+				a3demo_benchmarkLap(timer);
+				passed &= a3demo_updateBroadphase(broadphase + r, store) >= 0;
+				first[r] = a3demo_benchmarkLap(timer);
+			}
+			for (step = 0; step < steps; ++step)
+			{
+				a3demo_driftBodyStore(store, dt);
+				for (r = 0; r < runs; ++r)
+				{
+					a3demo_benchmarkLap(timer);
+					passed &= a3demo_updateBroadphase(broadphase + r, store) >= 0;
+					total[r] += a3demo_benchmarkLap(timer);
+					swaps[r] += broadphase[r].swaps;
+				}
+			}
+			a3timerStop(timer);
+
+			// every run, serial hash included, must find exactly the same pairs
+			for (r = 0, matched = 1; r < runs; ++r)
+			{
+				pairs[r] = a3demo_benchmarkSortedPairs(broadphase + r);
+				matched &= pairs[0] && pairs[r] && broadphase[r].pairCount == broadphase[0].pairCount
+					&& !memcmp(pairs[r], pairs[0], broadphase[0].pairCount * sizeof(a3_DemoBodyPair));
+			}
+			passed &= matched;
+			for (r = 0; r < runs; ++r)
+				free(pairs[r]);
+
+			printf("\n  N = %6u %-9s | %7u pairs %s", n, distribution[d], broadphase[0].pairCount, matched ? "(match)   " : "(MISMATCH)");
+			for (r = 0; r < strategies; ++r)
+				printf(" | %s: first %8.3f ms, step %8.3f ms, %6.0f swaps/step",
+					a3demo_getBroadphaseName((a3_DemoBroadphaseType)r), first[r] * 1000.0,
+					steps ? total[r] * 1000.0 / (double)steps : 0.0, steps ? (double)swaps[r] / (double)steps : 0.0);
+			printf(" | hash serial %8.3f ms/step, speedup %.2fx",
+				steps ? total[serialHash] * 1000.0 / (double)steps : 0.0,
+				total[a3demo_broadphase_spatialHash] > 0.0 ? total[serialHash] / total[a3demo_broadphase_spatialHash] : 0.0);
+		}
+	}
+	printf("\n  %s\n", passed ? "all strategies agree" : "STRATEGIES DISAGREE");
+
+	for (r = 0; r < runs; ++r)
+		a3demo_releaseBroadphase(broadphase + r);
+	a3demo_releaseBodyStore(store);
+	return passed ? (int)numCounts : -1;
+}
+
+
+int a3demo_benchmarkSolver(const unsigned int steps, a3_DemoJobSystem *jobs)
+{
+	const unsigned int counts[] = { 1000, 5000, 20000 };
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts);
+	const char *layout[] = { "stacks", "pyramids" };
+	const unsigned int stackHeight = 10, pyramidBase = 20, pyramidCount = pyramidBase * (pyramidBase + 1) / 2;
+	const a3real dt = a3recip(60.0f), gap = 0.01f, spacing = 2.0f;
+
+	a3_DemoRigidWorld world[1];
+	a3_ProceduralGeometryDescriptor boxShape[1];
+	a3_DemoCollider box[1], ground[1];
+	a3_DemoRigidBody body[1];
+	a3_Timer timer[1];
+	a3real3 *start;
+	double collideTime, solveTime, integrateTime;
+	double contacts, islands, largest, warm, residualFirst, residualLast;
+	a3real drift, d[3];
+	unsigned int c, l, w, i, n, step, row, column, side, level, slot, groups;
+	int passed = 1;
+
+	if (a3demo_createRigidWorld(world, counts[numCounts - 1] + 1, jobs) < 0)
+		return -1;
+	start = (a3real3 *)malloc(counts[numCounts - 1] * sizeof(a3real3));
+	if (!start)
+	{
+		a3demo_releaseRigidWorld(world);
+		return -1;
+	}
+	world->sleepSteps = 0;	// time the full step, not settled scenes
+	a3proceduralCreateDescriptorBox(boxShape, a3geomFlag_vanilla, 1.0f, 1.0f, 1.0f, 1, 1, 1);
+	a3demo_benchmarkCollider(box, boxShape);
+	a3demo_createColliderPlane(ground, 2);
+	a3timerSet(timer, 0.0);
+
+	printf("\n SOLVER BENCHMARK (%u steps at 60 Hz, %u iterations, %u workers)", steps, world->solver->iterations, jobs ? jobs->workerCount : 1);
+	for (c = 0; c < numCounts; ++c)
+		for (l = 0; l < 2; ++l)
+			for (w = 0; w < 2; ++w)
+			{
+				// columns of unit boxes, or triangular walls of them, laid
+				//	out on a square grid over a ground plane; rows of walls
+				//	are offset half a box so they do not line up
+				a3demo_clearRigidWorld(world);
+				world->solver->warmStart = !w;
+				a3demo_initRigidBody(body, ground, a3realZero, a3realZero, a3realZero, a3realZero);
+				a3demo_addRigidBody(world, body);
+				groups = l == 0 ? (counts[c] + stackHeight - 1) / stackHeight : (counts[c] + pyramidCount - 1) / pyramidCount;
+				for (side = 1; side * side < groups; ++side);
+				for (i = n = 0; n < counts[c]; ++i)
+				{
+					row = i / side;
+					column = i % side;
+					if (l == 0)
+						for (level = 0; level < stackHeight && n < counts[c]; ++level, ++n)
+						{
+							a3demo_initRigidBody(body, box, a3realOne, column * spacing + gap * (level % 3), row * spacing, a3realHalf + level * (a3realOne + gap));
+							a3demo_addRigidBody(world, body);
+						}
+					else
+						for (level = 0; level < pyramidBase && n < counts[c]; ++level)
+							for (slot = 0; slot < pyramidBase - level && n < counts[c]; ++slot, ++n)
+							{
+								a3demo_initRigidBody(body, box, a3realOne,
+									column * (pyramidBase + spacing) * (a3realOne + gap) + (slot + level * a3realHalf) * (a3realOne + gap) + (row % 2) * a3realHalf,
+									row * spacing, a3realHalf + level * (a3realOne + gap));
+								a3demo_addRigidBody(world, body);
+							}
+				}
+				for (i = 0; i < counts[c]; ++i)
+				{
+					start[i][0] = world->body[i + 1].pose.position[0];
+					start[i][1] = world->body[i + 1].pose.position[1];
+					start[i][2] = world->body[i + 1].pose.position[2];
+				}
+
+				// time each part of the step; the convergence figure is the
+				//	impulse still changing in the last iteration relative to
+				//	the first, so lower means closer to the exact answer
+				collideTime = solveTime = integrateTime = 0.0;
+				contacts = islands = largest = warm = residualFirst = residualLast = 0.0;
+				a3timerStart(timer);
+				for (step = 0; step < steps; ++step)
+				{
+					a3demo_benchmarkLap(timer);
+					passed &= a3demo_collideRigidWorld(world, dt) >= 0;
+					collideTime += a3demo_benchmarkLap(timer);
+					passed &= a3demo_solveRigidWorld(world, dt) >= 0;
+					solveTime += a3demo_benchmarkLap(timer);
+					passed &= a3demo_integrateRigidWorld(world, dt) >= 0;
+					integrateTime += a3demo_benchmarkLap(timer);
+
+					contacts += world->solver->constraintCount;
+					islands += world->solver->islandCount;
+					largest += world->solver->largestIsland;
+					warm += world->solver->warmStarted;
+					residualFirst += world->solver->residualFirst;
+					residualLast += world->solver->residualLast;
+				}
+				a3timerStop(timer);
+
+				// how far anything wandered from where it was placed
+				for (i = 0, drift = a3realZero; i < counts[c]; ++i)
+				{
+					d[0] = world->body[i + 1].pose.position[0] - start[i][0];
+					d[1] = world->body[i + 1].pose.position[1] - start[i][1];
+					d[2] = world->body[i + 1].pose.position[2] - start[i][2];
+					drift = a3maximum(drift, (a3real)sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]));
+				}
+
+				if (steps)
+				{
+					printf("\n  N = %5u %-8s warm %-3s | %6.0f contacts, %5.0f islands (largest %4.0f) | collide %8.3f ms, solve %8.3f ms, integrate %6.3f ms | residual %.4f, warm hits %5.1f%% | max drift %.3f",
+						counts[c], layout[l], w ? "off" : "on", contacts / steps, islands / steps, largest / steps,
+						collideTime * 1000.0 / steps, solveTime * 1000.0 / steps, integrateTime * 1000.0 / steps,
+						residualFirst > 0.0 ? residualLast / residualFirst : 0.0, contacts > 0.0 ? warm * 100.0 / contacts : 0.0, drift);
+				}
+			}
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+
+	free(start);
+	a3demo_releaseRigidWorld(world);
+	return passed ? (int)numCounts : -1;
+}
+
+
+int a3demo_benchmarkSleeping(const unsigned int steps, a3_DemoJobSystem *jobs)
+{
+	const unsigned int count = 5000, stackHeight = 10, report = 20;
+	const a3real dt = a3recip(60.0f), gap = 0.01f, spacing = 2.0f;
+
+	a3_DemoRigidWorld world[1];
+	a3_ProceduralGeometryDescriptor boxShape[1];
+	a3_DemoCollider box[1], ground[1];
+	a3_DemoRigidBody body[1];
+	a3_Timer timer[1];
+	double time, settled = 0.0;
+	unsigned int i, n, side, level, step;
+	int passed = 1;
+
+	if (a3demo_createRigidWorld(world, count + 1, jobs) < 0)
+		return -1;
+	a3proceduralCreateDescriptorBox(boxShape, a3geomFlag_vanilla, 1.0f, 1.0f, 1.0f, 1, 1, 1);
+	a3demo_benchmarkCollider(box, boxShape);
+	a3demo_createColliderPlane(ground, 2);
+	a3timerSet(timer, 0.0);
+
+	// columns of boxes as in the solver benchmark
+	a3demo_initRigidBody(body, ground, a3realZero, a3realZero, a3realZero, a3realZero);
+	a3demo_addRigidBody(world, body);
+	for (side = 1; side * side * stackHeight < count; ++side);
+	for (i = n = 0; n < count; ++i)
+		for (level = 0; level < stackHeight && n < count; ++level, ++n)
+		{
+			a3demo_initRigidBody(body, box, a3realOne, (i % side) * spacing + gap * (level % 3), (i / side) * spacing, a3realHalf + level * (a3realOne + gap));
+			a3demo_addRigidBody(world, body);
+		}
+
+	// let everything settle and fall asleep, then knock the bottom of one
+	//	column sideways halfway through; only that column should wake
+	printf("\n SLEEP BENCHMARK (%u boxes, %u steps at 60 Hz, sleep after %u steps below %.2f u/s, %.2f rad/s)",
+		count, steps, world->sleepSteps, world->sleepSpeed, world->sleepAngularSpeed);
+	a3timerStart(timer);
+	for (step = 0; step < steps; ++step)
+	{
+		if (step == steps / 2)
+		{
+			a3demo_wakeRigidBody(world, 1);
+			world->body[1].velocity[0] = 3.0f;
+		}
+		a3demo_benchmarkLap(timer);
+		passed &= a3demo_stepRigidWorld(world, dt) >= 0;
+		time = a3demo_benchmarkLap(timer);
+		if (step >= steps / 2 - report && step < steps / 2)
+			settled += time;
+		if (step % report == 0 || step == steps / 2)
+			printf("\n  step %4u: %5u awake, %5u contacts | %8.3f ms", step, world->awakeCount, world->manifoldCount, time * 1000.0);
+	}
+	a3timerStop(timer);
+	printf("\n  settled cost %.3f ms/step\n  %s\n", settled * 1000.0 / report, passed ? "done" : "FAILED");
+
+	n = world->awakeCount;
+	a3demo_releaseRigidWorld(world);
+	return passed ? (int)n : -1;
+}
+
+
+int a3demo_benchmarkContinuous(a3_DemoJobSystem *jobs)
+{
+	const a3real speed[] = { 10.0f, 50.0f, 200.0f, 1000.0f };
+	const unsigned int speeds = sizeof(speed) / sizeof(*speed), fine = 16;
+	const char *const shapeName[] = { "sphere r 0.1", "box 0.4x0.4x0.1" };
+	a3_DemoCollider shape[2];
+	double time[3];
+	unsigned int impacts[3], i, s;
+	int through[3], passed = 1;
+
+	a3demo_createColliderSphere(shape + 0, 0.1f);
+	a3demo_createColliderBox(shape + 1, 0.4f, 0.4f, 0.1f);
+
+	// the same volley three ways: plain 60 Hz steps, 60 Hz steps with
+	//	sweeping, and plain steps made fine enough to stand in for it
+	printf("\n CONTINUOUS COLLISION BENCHMARK (1000 spinning bodies at a 0.1 thick slab, 1 s)");
+	printf("\n  %-16s %6s | %-22s | %-30s | %-22s", "shape", "speed", "discrete 60 Hz", "swept 60 Hz", "discrete 960 Hz");
+	for (s = 0; s < 2; ++s)
+		for (i = 0; i < speeds; ++i)
+		{
+			srand(1);
+			through[0] = a3demo_benchmarkVolley(time + 0, impacts + 0, shape + s, speed[i], -a3realOne, 1, jobs);
+			srand(1);
+			through[1] = a3demo_benchmarkVolley(time + 1, impacts + 1, shape + s, speed[i], a3realHalf, 1, jobs);
+			srand(1);
+			through[2] = a3demo_benchmarkVolley(time + 2, impacts + 2, shape + s, speed[i], -a3realOne, fine, jobs);
+			passed &= through[0] >= 0 && through[1] == 0 && through[2] >= 0;
+			printf("\n  %-16s %6.0f | %4d through %7.3f ms | %4d through %7.3f ms %5u hits | %4d through %7.3f ms",
+				shapeName[s], speed[i], through[0], time[0] * 1000.0, through[1], time[1] * 1000.0, impacts[1], through[2], time[2] * 1000.0);
+		}
+	printf("\n  %s\n", passed ? "done" : "FAILED (swept bodies went through)");
+	return passed ? 1 : -1;
+}
+
+
+// step a soft body at 240 Hz; returns seconds spent, and the smallest
+//	volume it had relative to rest (closed bodies only)
+inline double a3demo_benchmarkSoftRun(a3_DemoSoftBody *body, const unsigned int steps, a3real *minVolume_out)
+{
+	a3_Timer timer[1];
+	double time = 0.0;
+	unsigned int step;
+
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	*minVolume_out = a3realOne;
+	for (step = 0; step < steps; ++step)
+	{
+		a3demo_benchmarkLap(timer);
+		a3demo_stepSoftBody(body, a3recip(240.0f));
+		time += a3demo_benchmarkLap(timer);
+		if (body->closed)
+			*minVolume_out = a3minimum(*minVolume_out, body->volume / body->restVolume);
+	}
+	a3timerStop(timer);
+	return time;
+}
+
+int a3demo_benchmarkSoftBody(const unsigned int steps, a3_DemoJobSystem *jobs)
+{
+	const char *const name[] = { "cloth 64x64", "sphere 32x24", "rope 64" };
+	const a3real corner[2][3] = { { -2.0f, +2.0f, a3realZero }, { +2.0f, +2.0f, a3realZero } };
+	const a3real origin[3] = { a3realZero }, ropeEnd[3] = { 4.0f, a3realZero, a3realZero }, lift[3] = { a3realZero, a3realZero, 2.0f };
+	a3_ProceduralGeometryDescriptor shape[1];
+	a3_GeometryData data[1] = { 0 };
+	a3_DemoSoftBody body[2][1] = { 0 };
+	double time[2];
+	a3real minVolume, error;
+	unsigned int i, k, substeps;
+	int passed = 1;
+
+	// the same body solved serially and with the job system; colors keep
+	//	the order of updates fixed, so both must end bit for bit the same
+	printf("\n SOFT BODY BENCHMARK (XPBD, %u steps at 240 Hz, default substeps and passes, %u workers)",
+		steps, jobs ? jobs->workerCount : 1);
+	printf("\n  %-13s %9s %11s %7s | %-19s | %-19s | %-24s", "body", "particles", "constraints", "colors", "serial", "parallel", "result");
+	for (i = 0; i < 3; ++i)
+	{
+		for (k = 0; k < 2; ++k)
+		{
+			switch (i)
+			{
+			case 0:
+				a3proceduralCreateDescriptorPlane(shape, a3geomFlag_vanilla, a3geomAxis_default, 4.0f, 4.0f, 64, 64);
+				a3proceduralGenerateGeometryData(data, shape);
+				a3demo_createSoftBody(body[k], data, a3realOne, a3realZero, 0.01f, a3realZero, k ? jobs : 0);
+				a3geometryReleaseData(data);
+				a3demo_pinSoftBodyNearest(body[k], corner[0], 1);
+				a3demo_pinSoftBodyNearest(body[k], corner[1], 1);
+				break;
+			case 1:
+				a3proceduralCreateDescriptorSphere(shape, a3geomFlag_vanilla, a3geomAxis_default, a3realOne, 32, 24);
+				a3proceduralGenerateGeometryData(data, shape);
+				a3demo_createSoftBody(body[k], data, a3realOne, 0.0001f, 0.01f, a3realZero, k ? jobs : 0);
+				a3geometryReleaseData(data);
+				a3demo_translateSoftBody(body[k], lift);
+				break;
+			case 2:
+				a3demo_createSoftRope(body[k], origin, ropeEnd, 64, a3realOne, a3realZero, 0.01f, k ? jobs : 0);
+				a3demo_pinSoftBodyNearest(body[k], origin, 1);
+				break;
+			}
+			body[k]->ground[2] = a3realOne;
+			body[k]->ground[3] = i == 1 ? a3realZero : -3.0f;
+			time[k] = a3demo_benchmarkSoftRun(body[k], steps, &minVolume);
+		}
+
+		for (k = 0, error = a3realZero; k < body[0]->particleCount * 3; ++k)
+			error = a3maximum(error, (a3real)fabs(body[0]->position[k] - body[1]->position[k]));
+		substeps = steps * body[0]->substeps;
+		passed &= body[0]->particleCount > 0 && error == a3realZero && (!body[0]->closed || body[0]->volume > 0.9f * body[0]->restVolume);
+		printf("\n  %-13s %9u %11u %3u+%-3u | %8.4f ms/substep | %8.4f ms/substep | ",
+			name[i], body[0]->particleCount, body[0]->constraintCount, body[0]->colorCount, body[0]->constraintCount - body[0]->serialStart,
+			time[0] * 1000.0 / substeps, time[1] * 1000.0 / substeps);
+		if (body[0]->closed)
+			printf("volume %.3f (min %.3f)", body[0]->volume / body[0]->restVolume, minVolume);
+		else
+			printf("stretch %.2f%%", body[0]->maxStrain * 100.0f);
+		if (error > a3realZero)
+			printf(" MISMATCH %g", error);
+
+		a3demo_releaseSoftBody(body[0]);
+		a3demo_releaseSoftBody(body[1]);
+	}
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkMassProperties()
+{
+	const char *const name[] = { "sphere", "box", "cylinder", "cone", "capsule" };
+	const unsigned char detail[2] = { 8, 64 };
+	const unsigned int repeats = 16;
+	a3_ProceduralGeometryDescriptor shape[1];
+	a3_GeometryData data[1] = { 0 };
+	a3_DemoMassProperties exact[1], mesh[1];
+	a3_Timer timer[1];
+	double time;
+	a3real volumeError, centerError, momentError;
+	unsigned int i, k, r, axis;
+	int passed = 1;
+
+	printf("\n MASS PROPERTIES BENCHMARK (mesh integration against analytic shapes, unit density)");
+	printf("\n  %-9s %9s | %-8s %-8s %-8s | %s", "shape", "triangles", "volume", "center", "moments", "time");
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	for (i = 0; i < 5; ++i)
+		for (k = 0; k < 2; ++k)
+		{
+			// off the default axis so placement along it is tested too
+			switch (i)
+			{
+			case 0:
+				a3proceduralCreateDescriptorSphere(shape, a3geomFlag_vanilla, a3geomAxis_default, 1.5f, detail[k], detail[k]);
+				break;
+			case 1:
+				a3proceduralCreateDescriptorBox(shape, a3geomFlag_vanilla, 1.0f, 2.0f, 3.0f, 1, 1, 1);
+				break;
+			case 2:
+				a3proceduralCreateDescriptorCylinder(shape, a3geomFlag_vanilla, a3geomAxis_x, 0.5f, 2.0f, detail[k], 1, 1);
+				break;
+			case 3:
+				a3proceduralCreateDescriptorCone(shape, a3geomFlag_vanilla, a3geomAxis_y_negative, 1.0f, 2.0f, detail[k], 1, 1);
+				break;
+			case 4:
+				a3proceduralCreateDescriptorCapsule(shape, a3geomFlag_vanilla, a3geomAxis_z, 0.5f, 1.0f, detail[k], detail[k] / 2, 1);
+				break;
+			}
+			a3demo_computeMassPropertiesDescriptor(exact, shape, a3realOne);
+			a3proceduralGenerateGeometryData(data, shape);
+
+			a3demo_benchmarkLap(timer);
+			for (r = 0; r < repeats; ++r)
+				a3demo_computeMassPropertiesMesh(mesh, data, a3realOne);
+			time = a3demo_benchmarkLap(timer) / (double)repeats;
+			a3geometryReleaseData(data);
+
+			// facets always sit inside the ideal shape, so coarse meshes
+			//	come out light; only the fine ones have to agree
+			volumeError = (a3real)fabs(mesh->volume - exact->volume) / exact->volume;
+			centerError = momentError = a3realZero;
+			for (axis = 0; axis < 3; ++axis)
+			{
+				centerError = a3maximum(centerError, (a3real)fabs(mesh->center[axis] - exact->center[axis]));
+				momentError = a3maximum(momentError, (a3real)fabs(mesh->moment[axis] - exact->moment[axis]) / exact->moment[2]);
+			}
+			if (k)
+				passed &= volumeError < 0.01f && centerError < 0.01f && momentError < 0.02f && mesh->openArea < 0.001f;
+			printf("\n  %-9s %9u | %7.3f%% %8.4f %7.3f%% | %8.1f us",
+				name[i], mesh->triangleCount, volumeError * 100.0f, centerError, momentError * 100.0f, time * 1000000.0);
+		}
+	a3timerStop(timer);
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+int a3demo_benchmarkConvexHull(a3_DemoJobSystem *jobs)
+{
+	const char *const name[] = { "ball", "sphere" };
+	const unsigned int counts[] = { 1000, 10000, 100000, 1000000 };
+	const unsigned int limits[] = { 16, 32, 64, 128 };
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts), numLimits = sizeof(limits) / sizeof(*limits);
+	const unsigned int samples = 1000, directions = 256;
+	a3_DemoConvexHull serial[1], parallel[1];
+	a3_Timer timer[1];
+	a3real *point, *p, direction[3], support[3], d, length, worst;
+	double serialTime, parallelTime;
+	unsigned int shape, n, i, k, f, hint, count;
+	int closed, inside, supported, passed = 1;
+
+	point = (a3real *)malloc(counts[numCounts - 1] * 3 * sizeof(a3real));
+	if (!point)
+		return -1;
+	srand(16);
+
+	printf("\n CONVEX HULL BENCHMARK (%u workers)", jobs ? jobs->workerCount : 1);
+	printf("\n  %-6s %8s | %7s %7s | %10s %10s %6s | %s", "cloud", "points", "verts", "faces", "serial", "parallel", "speed", "checks");
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	for (shape = 0; shape < 2; ++shape)
+		for (n = 0; n < numCounts; ++n)
+		{
+			// every point on a sphere is a vertex; a million is more than
+			//	the check can afford
+			count = counts[n];
+			if (shape && count > 100000)
+				continue;
+			for (i = 0, p = point; i < count; ++i, p += 3)
+			{
+				do
+				{
+					p[0] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					p[1] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					p[2] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					length = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+				} while (length > a3realOne || length < 0.01f);
+				if (shape)
+				{
+					length = a3recip((a3real)sqrt(length));
+					p[0] *= length;
+					p[1] *= length;
+					p[2] *= length;
+				}
+			}
+
+			a3demo_benchmarkLap(timer);
+			a3demo_createConvexHull(serial, point, count, 0, a3realZero, 0);
+			serialTime = a3demo_benchmarkLap(timer);
+			a3demo_createConvexHull(parallel, point, count, 0, a3realZero, jobs);
+			parallelTime = a3demo_benchmarkLap(timer);
+
+			// closed: Euler's formula for a sphere, and the same hull either way
+			closed = serial->vertexCount + serial->faceCount == serial->edgeCount + 2 &&
+				serial->faceCount * 3 == serial->edgeCount * 2 &&
+				serial->vertexCount == parallel->vertexCount && serial->faceCount == parallel->faceCount &&
+				!memcmp(serial->vertex, parallel->vertex, serial->vertexCount * 3 * sizeof(a3real));
+
+			// a spread of the input under every face plane
+			for (i = 0, worst = a3realZero; i < samples; ++i)
+			{
+				p = point + (i * (count / samples)) * 3;
+				for (f = 0; f < serial->faceCount; ++f)
+				{
+					d = serial->plane[f * 4 + 0] * p[0] + serial->plane[f * 4 + 1] * p[1] + serial->plane[f * 4 + 2] * p[2] - serial->plane[f * 4 + 3];
+					worst = a3maximum(worst, d);
+				}
+			}
+			inside = worst <= serial->tolerance * 4.0f;
+
+			// hill climbing from the last answer against a full search
+			for (i = 0, hint = 0, supported = 1; i < directions; ++i)
+			{
+				direction[0] = a3demo_benchmarkRandom() - a3realHalf;
+				direction[1] = a3demo_benchmarkRandom() - a3realHalf;
+				direction[2] = a3demo_benchmarkRandom() - a3realHalf;
+				a3demo_getConvexHullSupport(support, serial, direction, &hint);
+				d = support[0] * direction[0] + support[1] * direction[1] + support[2] * direction[2];
+				for (k = 0; k < serial->vertexCount; ++k)
+					supported &= serial->vertex[k * 3 + 0] * direction[0] + serial->vertex[k * 3 + 1] * direction[1] + serial->vertex[k * 3 + 2] * direction[2] <= d + serial->tolerance;
+			}
+
+			passed &= closed && inside && supported;
+			printf("\n  %-6s %8u | %7u %7u | %7.2f ms %7.2f ms %5.2fx | %s %s %s",
+				name[shape], count, serial->vertexCount, serial->faceCount, serialTime * 1000.0, parallelTime * 1000.0, serialTime / (parallelTime > 0.0 ? parallelTime : 1.0),
+				closed ? "closed" : "OPEN", inside ? "inside" : "OUTSIDE", supported ? "support" : "SUPPORT");
+			a3demo_releaseConvexHull(serial);
+			a3demo_releaseConvexHull(parallel);
+		}
+
+	// simplified proxies of the largest ball (still in the buffer)
+	printf("\n  %-6s %8s | %7s %7s | %10s %10s", "limit", "points", "verts", "faces", "time", "outside");
+	count = counts[numCounts - 1];
+	for (i = 0, p = point; i < count; ++i, p += 3)
+	{
+		do
+		{
+			p[0] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+			p[1] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+			p[2] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+			length = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+		} while (length > a3realOne);
+	}
+	for (n = 0; n < numLimits; ++n)
+	{
+		a3demo_benchmarkLap(timer);
+		a3demo_createConvexHull(parallel, point, count, limits[n], a3realZero, jobs);
+		parallelTime = a3demo_benchmarkLap(timer);
+		passed &= parallel->vertexCount <= limits[n];
+		printf("\n  %-6u %8u | %7u %7u | %7.2f ms %10.4f",
+			limits[n], count, parallel->vertexCount, parallel->faceCount, parallelTime * 1000.0, parallel->outside);
+		a3demo_releaseConvexHull(parallel);
+	}
+	a3timerStop(timer);
+	free(point);
+
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkGJK(const a3_DemoConvexHull *hull)
+{
+	const unsigned int poses = 2000, frames = 8, shapes = a3demo_collider_hull;
+	const a3real step = 0.005f;
+	a3_ProceduralGeometryDescriptor shape[1];
+	a3_DemoCollider collider[a3demo_collider_hull + 1];
+	a3_DemoColliderPose poseA[1], poseB[1];
+	a3_DemoConvexHull cloud[1] = { 0 };
+	a3_DemoContactManifold manifold[1];
+	a3_DemoGJKResult result[1];
+	a3_DemoGJKCache cache[1];
+	a3_Timer timer[1];
+	a3real point[64 * 3], *p, origin[3] = { a3realZero }, center[3], motion[3], qA[4], qB[4], dqA[4], dqB[4];
+	a3real reach, depth, error, worst, shallow, length;
+	double coldTime, warmTime, coldSteps, warmSteps, overlaps;
+	unsigned int i, j, a, b, k, frame, mismatch, analytic;
+	int passed = 1;
+
+	// a hull to pair with everything; a random cloud without one
+	if (!hull || !hull->vertexCount)
+	{
+		srand(17);
+		for (i = 0, p = point; i < 64; ++i, p += 3)
+		{
+			p[0] = (a3demo_benchmarkRandom() - a3realHalf) * 1.2f;
+			p[1] = (a3demo_benchmarkRandom() - a3realHalf) * 0.8f;
+			p[2] = (a3demo_benchmarkRandom() - a3realHalf) * 1.0f;
+		}
+		if (a3demo_createConvexHull(cloud, point, 64, 0, a3realZero, 0) <= 0)
+			return -1;
+		hull = cloud;
+	}
+	a3demo_createColliderSphere(collider + a3demo_collider_sphere, 0.5f);
+	a3demo_createColliderBox(collider + a3demo_collider_box, 1.0f, 0.6f, 0.8f);
+	a3demo_createColliderCapsule(collider + a3demo_collider_capsule, 2, 0.3f, 1.0f);
+	a3proceduralCreateDescriptorCylinder(shape, a3geomFlag_vanilla, a3geomAxis_default, 0.4f, 1.0f, 16, 1, 1);
+	a3demo_benchmarkCollider(collider + a3demo_collider_cylinder, shape);
+	a3proceduralCreateDescriptorCone(shape, a3geomFlag_vanilla, a3geomAxis_default, 0.5f, 1.0f, 16, 1, 1);
+	a3demo_benchmarkCollider(collider + a3demo_collider_cone, shape);
+	a3demo_createColliderHull(collider + a3demo_collider_hull, hull);
+
+	printf("\n GJK BENCHMARK (%u random poses per pair, then %u frames each with a cache; hull of %u vertices)", poses, frames, hull->vertexCount);
+	printf("\n  %-17s %7s | %-22s | %-22s | %s", "pair", "overlap", "cold", "warm", "against analytic test");
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	for (a = a3demo_collider_sphere; a <= shapes; ++a)
+		for (b = a; b <= shapes; ++b)
+		{
+			srand(a * 16 + b);
+			reach = collider[a].boundingRadius + collider[b].boundingRadius;
+			coldTime = warmTime = coldSteps = warmSteps = overlaps = 0.0;
+			mismatch = analytic = 0;
+			worst = shallow = a3realZero;
+			for (i = 0; i < poses; ++i)
+			{
+				// b somewhere from well inside a to just out of reach
+				do
+				{
+					center[0] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					center[1] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					center[2] = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+					length = center[0] * center[0] + center[1] * center[1] + center[2] * center[2];
+				} while (length > a3realOne || length < 0.01f);
+				length = reach * (0.2f + a3demo_benchmarkRandom()) / (a3real)sqrt(length);
+				for (k = 0; k < 3; ++k)
+				{
+					center[k] *= length;
+					motion[k] = (a3demo_benchmarkRandom() - a3realHalf) * step;
+				}
+				a3demo_benchmarkRandomRotation(qA);
+				a3demo_benchmarkRandomRotation(qB);
+				for (k = 0; k < 4; ++k)
+				{
+					dqA[k] = (a3demo_benchmarkRandom() - a3realHalf) * step;
+					dqB[k] = (a3demo_benchmarkRandom() - a3realHalf) * step;
+				}
+
+				// the pair moving a little each frame, from scratch and from
+				//	the last frame's simplex
+				a3demo_initGJKCache(cache);
+				for (frame = 0; frame < frames; ++frame)
+				{
+					a3demo_benchmarkPose(poseA, collider + a, origin, qA, dqA, (a3real)frame);
+					a3demo_benchmarkPose(poseB, collider + b, center, qB, dqB, (a3real)frame);
+					a3demo_benchmarkLap(timer);
+					a3demo_queryGJKPenetration(result, collider + a, poseA, collider + b, poseB, 0);
+					coldTime += a3demo_benchmarkLap(timer);
+					coldSteps += result->iterations;
+					a3demo_queryGJKPenetration(result, collider + a, poseA, collider + b, poseB, cache);
+					warmTime += a3demo_benchmarkLap(timer);
+					warmSteps += result->iterations;
+					for (k = 0; k < 3; ++k)
+						center[k] += motion[k];
+				}
+				overlaps += result->distance < a3realZero;
+
+				// where there is an analytic test: does it agree on overlap
+				//	(ignoring grazing contacts either could call), and how
+				//	does the depth compare with the overlap along its normal;
+				//	EPA finds the least, so it should never be deeper, but
+				//	may be shallower where a test prefers face axes (clipped
+				//	manifold points can be shallower still, so they are not
+				//	used)
+				if (a3demo_canCollideColliders(collider[a].type, collider[b].type))
+				{
+					a3demo_collideColliders(manifold, collider + a, poseA, collider + b, poseB, 0);
+					for (j = 0, depth = -a3realOne; j < manifold->count; ++j)
+						depth = a3maximum(depth, manifold->point[j].depth);
+					if (depth > 0.001f || result->distance < -0.001f)
+					{
+						++analytic;
+						if ((depth > a3realZero) != (result->distance < a3realZero))
+							++mismatch;
+						else
+						{
+							for (k = 0; k < 3; ++k)
+								motion[k] = -manifold->normal[k];
+							a3demo_getColliderSupport(point, collider + a, poseA, manifold->normal, 0);
+							a3demo_getColliderSupport(point + 3, collider + b, poseB, motion, 0);
+							depth = (point[0] - point[3]) * manifold->normal[0] + (point[1] - point[4]) * manifold->normal[1] + (point[2] - point[5]) * manifold->normal[2];
+							error = -result->distance - depth;
+							worst = a3maximum(worst, error);
+							shallow = a3maximum(shallow, -error);
+						}
+					}
+				}
+			}
+			printf("\n  %-8s %-8s %6.1f%% | %7.3f us %5.2f steps | %7.3f us %5.2f steps | ",
+				a3demo_getColliderName(collider[a].type), a3demo_getColliderName(collider[b].type), overlaps * 100.0 / poses,
+				coldTime * 1.0e6 / (poses * frames), coldSteps / (poses * frames), warmTime * 1.0e6 / (poses * frames), warmSteps / (poses * frames));
+			if (analytic)
+			{
+				printf("%u mismatched, depth +%.1e -%.1e", mismatch, worst, shallow);
+				passed &= !mismatch && worst < 0.001f;
+			}
+			else
+				printf("-");
+		}
+	a3timerStop(timer);
+	a3demo_releaseConvexHull(cloud);
+
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkMeshBVH(const a3_DemoMeshBVH *mesh, a3_DemoJobSystem *jobs)
+{
+	const unsigned int side = 512, rays = side * side, casts = 16384, checks = 256, stacks = 500, slices = 1000;
+	const char *const rayName[] = { "camera", "random" };
+	a3_DemoMeshBVH serial[1] = { 0 }, parallel[1] = { 0 };
+	a3_DemoMeshHit *hit;
+	a3_Timer timer[1];
+	a3real *origin, *direction, *ray, center[3], radius, eye[3], forward[3], right[3], up[3], x, y, length, angle;
+	float *sphere = 0, *v;
+	double serialTime, parallelTime, singleTime, packetTime, castTime, distance, reference, position[3];
+	unsigned int m, set, i, j, k, tx, ty, hits, wrong, castWrong;
+	int same, passed = 1;
+
+	origin = (a3real *)malloc(rays * 6 * sizeof(a3real));
+	hit = (a3_DemoMeshHit *)malloc(rays * sizeof(a3_DemoMeshHit));
+	if (!origin || !hit)
+	{
+		free(origin);
+		free(hit);
+		return -1;
+	}
+	direction = origin + rays * 3;
+	srand(18);
+
+	printf("\n MESH BVH BENCHMARK (%s packets of %u rays, %u workers)", a3demo_getMeshBVHKernelName(), a3demo_getMeshBVHPacketWidth(), jobs ? jobs->workerCount : 1);
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+	for (m = 0; m < 2; ++m)
+	{
+		// the given model, then a bumpy sphere of a million triangles
+		if (!m)
+		{
+			if (!mesh || !mesh->triangleCount)
+				continue;
+			v = mesh->triangle;
+			k = mesh->triangleCount;
+		}
+		else
+		{
+			k = stacks * slices * 2;
+			sphere = (float *)malloc(k * 9 * sizeof(float));
+			if (!sphere)
+				break;
+			for (i = 0, v = sphere; i < stacks; ++i)
+				for (j = 0; j < slices; ++j)
+					for (tx = 0; tx < 6; ++tx, v += 3)
+					{
+						// two triangles per quad, corners (i, j) (i+1, j) (i+1, j+1) (i, j+1)
+						static const unsigned int di[6] = { 0, 1, 1, 0, 1, 0 }, dj[6] = { 0, 0, 1, 0, 1, 1 };
+						angle = a3realPi * (a3real)(i + di[tx]) / (a3real)stacks;
+						x = a3realTwo * a3realPi * (a3real)(j + dj[tx]) / (a3real)slices;
+						length = a3realOne + 0.05f * (a3real)(sin(x * 7.0f) * sin(angle * 11.0f));
+						v[0] = (float)(length * sin(angle) * cos(x));
+						v[1] = (float)(length * sin(angle) * sin(x));
+						v[2] = (float)(length * cos(angle));
+					}
+			v = sphere;
+		}
+
+		a3demo_benchmarkLap(timer);
+		a3demo_createMeshBVH(serial, v, 0, k, 0);
+		serialTime = a3demo_benchmarkLap(timer);
+		a3demo_createMeshBVH(parallel, v, 0, k, jobs);
+		parallelTime = a3demo_benchmarkLap(timer);
+		same = serial->nodeCount == parallel->nodeCount &&
+			!memcmp(serial->node, parallel->node, serial->nodeCount * sizeof(a3_DemoMeshBVHNode)) &&
+			!memcmp(serial->triangleIndex, parallel->triangleIndex, serial->triangleCount * sizeof(unsigned int));
+		passed &= same;
+		printf("\n  %-6s %8u triangles | %7u nodes, depth %2u | build serial %8.2f ms, parallel %8.2f ms, %5.2fx %s",
+			m ? "sphere" : "model", k, serial->nodeCount, serial->depth, serialTime * 1000.0, parallelTime * 1000.0, serialTime / (parallelTime > 0.0 ? parallelTime : 1.0), same ? "(same)" : "(DIFFERENT)");
+		free(sphere);
+		sphere = 0;
+
+		// bounding sphere of the root box
+		for (k = 0; k < 3; ++k)
+			center[k] = (serial->node->boundsMin[k] + serial->node->boundsMax[k]) * a3realHalf;
+		x = serial->node->boundsMax[0] - serial->node->boundsMin[0];
+		y = serial->node->boundsMax[1] - serial->node->boundsMin[1];
+		length = serial->node->boundsMax[2] - serial->node->boundsMin[2];
+		radius = (a3real)sqrt(x * x + y * y + length * length) * a3realHalf;
+
+		for (set = 0; set < 2; ++set)
+		{
+			if (!set)
+			{
+				// camera rays in 4x2 tiles, so packets are neighbours
+				eye[0] = center[0] + radius * 1.6f;
+				eye[1] = center[1] + radius * 1.2f;
+				eye[2] = center[2] + radius * 1.4f;
+				for (k = 0; k < 3; ++k)
+					forward[k] = center[k] - eye[k];
+				length = a3recip((a3real)sqrt(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]));
+				for (k = 0; k < 3; ++k)
+					forward[k] *= length;
+				right[0] = forward[1];
+				right[1] = -forward[0];
+				right[2] = a3realZero;
+				length = a3recip((a3real)sqrt(right[0] * right[0] + right[1] * right[1]));
+				right[0] *= length;
+				right[1] *= length;
+				up[0] = right[1] * forward[2] - right[2] * forward[1];
+				up[1] = right[2] * forward[0] - right[0] * forward[2];
+				up[2] = right[0] * forward[1] - right[1] * forward[0];
+				for (i = 0, ray = origin; i < rays; ++i, ray += 3)
+				{
+					tx = (i / 8) % (side / 4) * 4 + i % 4;
+					ty = (i / 8) / (side / 4) * 2 + (i % 8) / 4;
+					x = ((a3real)tx + a3realHalf) / (a3real)side - a3realHalf;
+					y = ((a3real)ty + a3realHalf) / (a3real)side - a3realHalf;
+					for (k = 0; k < 3; ++k)
+					{
+						ray[k] = eye[k];
+						direction[i * 3 + k] = forward[k] + right[k] * x * 0.8f + up[k] * y * 0.8f;
+					}
+				}
+			}
+			else
+			{
+				// from anywhere around it toward anywhere in its box
+				for (i = 0, ray = origin; i < rays; ++i, ray += 3)
+				{
+					do
+					{
+						x = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+						y = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+						angle = a3demo_benchmarkRandom() * a3realTwo - a3realOne;
+						length = x * x + y * y + angle * angle;
+					} while (length > a3realOne || length < 0.01f);
+					length = radius * a3realTwo / (a3real)sqrt(length);
+					ray[0] = center[0] + x * length;
+					ray[1] = center[1] + y * length;
+					ray[2] = center[2] + angle * length;
+					for (k = 0; k < 3; ++k)
+						direction[i * 3 + k] = serial->node->boundsMin[k] + (serial->node->boundsMax[k] - serial->node->boundsMin[k]) * a3demo_benchmarkRandom() - ray[k];
+				}
+			}
+
+			a3demo_benchmarkLap(timer);
+			for (i = 0, hits = 0; i < rays; ++i)
+				hits += a3demo_raycastMeshBVH(hit + i, serial, origin + i * 3, direction + i * 3, radius * 4.0f);
+			singleTime = a3demo_benchmarkLap(timer);
+
+			// a spread of rays against every triangle, single and packet
+			for (i = 0, wrong = 0; i < checks; ++i)
+			{
+				j = i * (rays / checks) + i % 8;
+				reference = a3demo_benchmarkRayBrute(serial, origin + j * 3, direction + j * 3, radius * 4.0f);
+				wrong += fabs(reference - hit[j].distance) > radius * 1.0e-4f;
+			}
+			a3demo_benchmarkLap(timer);
+			a3demo_raycastMeshBVHPacket(hit, serial, origin, direction, radius * 4.0f, rays);
+			packetTime = a3demo_benchmarkLap(timer);
+			for (i = 0; i < checks; ++i)
+			{
+				j = i * (rays / checks) + i % 8;
+				reference = a3demo_benchmarkRayBrute(serial, origin + j * 3, direction + j * 3, radius * 4.0f);
+				wrong += fabs(reference - hit[j].distance) > radius * 1.0e-4f;
+			}
+			passed &= wrong <= checks / 100;
+			printf("\n    %-6s rays %7u | single %7.2f Mrays/s | packet %7.2f Mrays/s, %4.2fx | %5.1f%% hit | %u of %u checks off",
+				rayName[set], rays, rays * 1.0e-6 / singleTime, rays * 1.0e-6 / packetTime, singleTime / packetTime, hits * 100.0 / rays, wrong, checks * 2);
+		}
+
+		// sphere casts from the random set: at the hit the sphere touches,
+		//	halfway there it is clear
+		a3demo_benchmarkLap(timer);
+		for (i = 0, hits = 0; i < casts; ++i)
+			hits += a3demo_sphereCastMeshBVH(hit + i, serial, origin + i * 3, direction + i * 3, radius * 0.02f, radius * 4.0f);
+		castTime = a3demo_benchmarkLap(timer);
+		for (i = 0, castWrong = 0; i < checks / 4; ++i)
+		{
+			j = i * (casts / (checks / 4));
+			for (k = 0; k < 2; ++k)
+			{
+				distance = hit[j].triangle != (unsigned int)-1 ? hit[j].distance * (k ? 1.0 : 0.5) : radius * 4.0 * (k ? 1.0 : 0.5);
+				position[0] = origin[j * 3 + 0] + direction[j * 3 + 0] * distance;
+				position[1] = origin[j * 3 + 1] + direction[j * 3 + 1] * distance;
+				position[2] = origin[j * 3 + 2] + direction[j * 3 + 2] * distance;
+				reference = a3demo_benchmarkPointBrute(serial, position) - radius * 0.02f;
+				castWrong += (k && hit[j].triangle != (unsigned int)-1) ? (fabs(reference) > radius * 1.0e-4f) : (reference < -radius * 1.0e-4f);
+			}
+		}
+		passed &= castWrong <= checks / 100;
+		printf("\n    sphere casts %7u | %7.2f Mcasts/s | %5.1f%% hit | %u of %u checks off",
+			casts, casts * 1.0e-6 / castTime, hits * 100.0 / casts, castWrong, checks / 2);
+
+		a3demo_releaseMeshBVH(serial);
+		a3demo_releaseMeshBVH(parallel);
+	}
+	a3timerStop(timer);
+	free(origin);
+	free(hit);
+
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkPicking(const unsigned int frames)
+{
+	const unsigned int counts[] = { 1000, 100000 }, picks = 20000, checks = 500;
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts);
+	const char *distribution[] = { "uniform", "clustered" };
+	const a3real width = 1280.0f, height = 720.0f, dt = 1.0f / 60.0f, pickRadius = 0.25f, margin = a3realHalf;
+	a3_DemoBodyStore store[1] = { 0 };
+	a3_DemoDynamicTree tree[1] = { 0 };
+	a3_DemoSceneObject eye[1];
+	a3_DemoCamera camera[1];
+	a3_DemoPickHit hit[1];
+	a3_Timer timer[1];
+	a3real *cursor, origin[3], direction[3], side;
+	a3real4 point, view, clip;
+	double buildTime, updateTime, pickTime, bruteTime, reference, pixel, worstPixel;
+	unsigned int c, d, i, f, n, moved, hits, wrong, object;
+	int passed = 1;
+
+	cursor = (a3real *)malloc(picks * 2 * sizeof(a3real));
+	if (!cursor || a3demo_createBodyStore(store, counts[numCounts - 1]) < 0 || a3demo_createDynamicTree(tree, counts[numCounts - 1], margin) < 0)
+	{
+		free(cursor);
+		a3demo_releaseBodyStore(store);
+		return -1;
+	}
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+
+	printf("\n PICKING BENCHMARK (%u frames of drift, %.0fx%.0f viewport, pick radius %.2f, tree margin %.2f)", frames, width, height, pickRadius, margin);
+	for (c = 0; c < numCounts; ++c)
+	{
+		n = counts[c];
+		side = a3realTwo * (a3real)pow((double)n, 1.0 / 3.0);
+
+		// camera back along z looking at the middle of it all
+		a3demo_initSceneObject(eye);
+		a3real3Set(eye->position.v, a3realZero, a3realZero, side * 1.2f);
+		a3demo_updateSceneObject(eye);
+		a3demo_setCameraSceneObject(camera, eye);
+		a3demo_initCamera(camera);
+		camera->fovy = a3realSixty;
+		camera->aspect = width / height;
+		camera->znear = a3realOne;
+		camera->zfar = side * 3.0f;
+		a3real4x4MakePerspectiveProjection(camera->projectionMat.m, camera->projectionMatInv.m, camera->fovy, camera->aspect, camera->znear, camera->zfar);
+
+		for (d = 0; d < 2; ++d)
+		{
+			// a cube of bodies of mixed sizes, or a cluster of points
+			a3demo_clearBodyStore(store);
+			if (d == 0)
+			{
+				srand(1900 + c);
+				for (i = 0; i < n; ++i)
+				{
+					origin[0] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					origin[1] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					origin[2] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					a3demo_addBody(store, origin, 0, a3realOne, a3demo_benchmarkRandom() * a3realHalf);
+				}
+			}
+			else
+				a3demo_generateBodyCluster(store, n, side * 0.125f, 1900 + c);
+			srand(1901 + c);
+			for (i = 0; i < n; ++i)
+			{
+				store->velX[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+				store->velY[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+				store->velZ[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+			}
+			for (i = 0; i < picks; ++i)
+			{
+				cursor[i * 2 + 0] = (a3real)(int)(a3demo_benchmarkRandom() * width);
+				cursor[i * 2 + 1] = (a3real)(int)(a3demo_benchmarkRandom() * height);
+			}
+
+			// everything goes in at once, then drifts a frame at a time
+			a3demo_clearDynamicTree(tree);
+			a3demo_benchmarkLap(timer);
+			a3demo_updateBodyPickTree(tree, store, pickRadius);
+			buildTime = a3demo_benchmarkLap(timer);
+			for (f = 0, moved = 0, updateTime = 0.0; f < frames; ++f)
+			{
+				a3demo_integrateBodyStore(store, dt);
+				a3demo_benchmarkLap(timer);
+				moved += a3demo_updateBodyPickTree(tree, store, pickRadius);
+				updateTime += a3demo_benchmarkLap(timer);
+			}
+
+			// picks through the tree, each from its cursor position
+			a3demo_benchmarkLap(timer);
+			for (i = 0, hits = 0; i < picks; ++i)
+			{
+				a3demo_getCameraPickRay(origin, direction, camera, cursor[i * 2 + 0], cursor[i * 2 + 1], width, height);
+				hits += a3demo_pickBody(hit, tree, store, origin, direction, camera->zfar, pickRadius);
+			}
+			pickTime = a3demo_benchmarkLap(timer);
+
+			// the first few again against every body; ties at the same
+			//	distance may go either way
+			for (i = 0, wrong = 0, bruteTime = 0.0, worstPixel = 0.0; i < checks; ++i)
+			{
+				a3demo_getCameraPickRay(origin, direction, camera, cursor[i * 2 + 0], cursor[i * 2 + 1], width, height);
+				a3demo_pickBody(hit, tree, store, origin, direction, camera->zfar, pickRadius);
+				a3demo_benchmarkLap(timer);
+				reference = a3demo_benchmarkPickBrute(&object, store, origin, direction, pickRadius, camera->zfar);
+				bruteTime += a3demo_benchmarkLap(timer);
+				wrong += object != hit->object && fabs(reference - hit->distance) > side * 1.0e-5;
+				if (hit->object != (unsigned int)-1)
+				{
+					// where the hit lands on screen, in pixels from the cursor
+					a3real3SetReal3(point, hit->point);
+					point[3] = a3realOne;
+					a3real4Real4x4ProductR(view, eye->modelMatInv.m, point);
+					a3real4Real4x4ProductR(clip, camera->projectionMat.m, view);
+					pixel = fabs((clip[0] / clip[3] + 1.0) * width * 0.5 - 0.5 - cursor[i * 2 + 0]) +
+						fabs((1.0 - clip[1] / clip[3]) * height * 0.5 - 0.5 - cursor[i * 2 + 1]);
+					worstPixel = a3maximum(worstPixel, pixel);
+				}
+			}
+			passed &= wrong <= checks / 100 && worstPixel < 0.05;
+			printf("\n  %-9s %6u bodies | build %7.2f ms, height %2u | drift %6.3f ms/frame, %5.2f%% touched | pick %6.2f us (all bodies %8.2f us, %6.0fx) | %5.1f%% hit | %u of %u off, %.4f px",
+				distribution[d], n, buildTime * 1000.0, tree->node[tree->root].height,
+				updateTime * 1000.0 / (frames ? frames : 1), moved * 100.0 / ((double)n * (frames ? frames : 1)),
+				pickTime * 1.0e6 / picks, bruteTime * 1.0e6 / checks, bruteTime / checks / (pickTime > 0.0 ? pickTime / picks : 1.0),
+				hits * 100.0 / picks, wrong, checks, worstPixel);
+		}
+	}
+	a3timerStop(timer);
+	a3demo_releaseDynamicTree(tree);
+	a3demo_releaseBodyStore(store);
+	free(cursor);
+
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkDynamicTree(const unsigned int frames)
+{
+	const unsigned int counts[] = { 10000, 100000 }, queries = 2000, checks = 100, k = 8;
+	const unsigned int numCounts = sizeof(counts) / sizeof(*counts);
+	const a3real fractions[] = { 0.001f, 0.01f, 0.1f, 1.0f };
+	const unsigned int numFractions = sizeof(fractions) / sizeof(*fractions);
+	const char *distribution[] = { "uniform", "clustered" }, *rotation[] = { "plain", "rotated" };
+	const a3real dt = 1.0f / 60.0f, margin = a3realHalf, reach = a3realTwo;
+	a3_DemoBodyStore store[1] = { 0 };
+	a3_DemoDynamicTree tree[1] = { 0 };
+	a3_DemoSceneObject eye[1];
+	a3_DemoCamera camera[1];
+	a3_Timer timer[1];
+	a3real *query, *planes, *p, side, buildCost, boxMin[3], boxMax[3], nearestDistance[8], reference[8], d;
+	double buildTime, updateTime, overlapTime, nearestTime, frustumTime, overlapBrute, nearestBrute, frustumBrute;
+	unsigned int *found, nearest[8], c, t, r, i, j, f, n, m, o, got, wrong, buildHeight;
+	int passed = 1, count;
+	const a3_DemoDynamicTreeNode *leaf;
+
+	query = (a3real *)malloc(queries * (3 + 24) * sizeof(a3real));
+	found = (unsigned int *)malloc(counts[numCounts - 1] * sizeof(unsigned int));
+	if (!query || !found || a3demo_createBodyStore(store, counts[numCounts - 1]) < 0 || a3demo_createDynamicTree(tree, counts[numCounts - 1], margin) < 0)
+	{
+		free(query);
+		free(found);
+		a3demo_releaseBodyStore(store);
+		return -1;
+	}
+	planes = query + queries * 3;
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+
+	printf("\n DYNAMIC TREE BENCHMARK (%u frames of drift, margin %.2f; queries: boxes %.0f across, %u nearest, frusta; microseconds, every object tested in brackets)", frames, margin, reach * a3realTwo, k);
+	for (c = 0; c < numCounts; ++c)
+	{
+		n = counts[c];
+		side = a3realTwo * (a3real)pow((double)n, 1.0 / 3.0);
+		for (t = 0; t < 2; ++t)
+		{
+			// same bodies as the picking benchmark
+			a3demo_clearBodyStore(store);
+			if (t == 0)
+			{
+				srand(2000 + c);
+				for (i = 0; i < n; ++i)
+				{
+					boxMin[0] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					boxMin[1] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					boxMin[2] = (a3demo_benchmarkRandom() - a3realHalf) * side;
+					a3demo_addBody(store, boxMin, 0, a3realOne, a3demo_benchmarkRandom() * a3realHalf);
+				}
+			}
+			else
+				a3demo_generateBodyCluster(store, n, side * 0.125f, 2000 + c);
+			srand(2001 + c);
+			for (i = 0; i < n; ++i)
+			{
+				store->velX[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+				store->velY[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+				store->velZ[i] = a3demo_benchmarkRandom() * 4.0f - a3realTwo;
+			}
+
+			// query points among the bodies, and cameras at some of them
+			//	looking every which way
+			for (i = 0; i < queries; ++i)
+			{
+				j = (unsigned int)(a3demo_benchmarkRandom() * (n - 1));
+				query[i * 3 + 0] = store->posX[j];
+				query[i * 3 + 1] = store->posY[j];
+				query[i * 3 + 2] = store->posZ[j];
+				a3demo_initSceneObject(eye);
+				a3real3Set(eye->position.v, query[i * 3 + 0], query[i * 3 + 1], query[i * 3 + 2]);
+				a3demo_setSceneObjectEuler(eye, a3demo_benchmarkRandom() * 360.0f, a3demo_benchmarkRandom() * 360.0f, a3demo_benchmarkRandom() * 360.0f);
+				a3demo_updateSceneObject(eye);
+				a3demo_setCameraSceneObject(camera, eye);
+				a3demo_initCamera(camera);
+				a3real4x4MakePerspectiveProjection(camera->projectionMat.m, camera->projectionMatInv.m, a3realSixty, 16.0f / 9.0f, a3realOne, side * 0.25f);
+				a3demo_updateCameraViewProjection(camera);
+				a3demo_getCameraFrustumPlanes(planes + i * 24, camera);
+			}
+
+			for (r = 0; r < 2; ++r)
+			{
+				// one at a time, as they would arrive, then all drifting
+				a3demo_clearDynamicTree(tree);
+				tree->rotate = r;
+				a3demo_benchmarkLap(timer);
+				for (i = 0; i < n; ++i)
+					a3demo_benchmarkMoveBox(tree, store, i);
+				buildTime = a3demo_benchmarkLap(timer);
+				buildHeight = tree->node[tree->root].height;
+				buildCost = a3demo_getDynamicTreeCost(tree);
+				for (f = 0, updateTime = 0.0; f < frames; ++f)
+				{
+					a3demo_integrateBodyStore(store, dt);
+					a3demo_benchmarkLap(timer);
+					for (i = 0; i < n; ++i)
+						a3demo_benchmarkMoveBox(tree, store, i);
+					updateTime += a3demo_benchmarkLap(timer);
+				}
+
+				// queries through the tree...
+				a3demo_benchmarkLap(timer);
+				for (i = 0; i < queries; ++i)
+				{
+					p = query + i * 3;
+					boxMin[0] = p[0] - reach;
+					boxMin[1] = p[1] - reach;
+					boxMin[2] = p[2] - reach;
+					boxMax[0] = p[0] + reach;
+					boxMax[1] = p[1] + reach;
+					boxMax[2] = p[2] + reach;
+					a3demo_queryDynamicTreeOverlap(found, n, tree, boxMin, boxMax);
+				}
+				overlapTime = a3demo_benchmarkLap(timer);
+				for (i = 0; i < queries; ++i)
+					a3demo_queryDynamicTreeNearest(nearest, nearestDistance, k, tree, query + i * 3, FLT_MAX, (a3_DemoDynamicTreeDistanceFunc)a3demo_benchmarkSphereDistance, store);
+				nearestTime = a3demo_benchmarkLap(timer);
+				for (i = 0; i < queries; ++i)
+					a3demo_queryDynamicTreePlanes(found, n, tree, planes + i * 24, 6);
+				frustumTime = a3demo_benchmarkLap(timer);
+
+				// ...and the first few against every object: the same
+				//	number of boxes, the same nearest distances
+				for (i = 0, wrong = 0, overlapBrute = nearestBrute = frustumBrute = 0.0; i < checks; ++i)
+				{
+					p = query + i * 3;
+					boxMin[0] = p[0] - reach;
+					boxMin[1] = p[1] - reach;
+					boxMin[2] = p[2] - reach;
+					boxMax[0] = p[0] + reach;
+					boxMax[1] = p[1] + reach;
+					boxMax[2] = p[2] + reach;
+					count = a3demo_queryDynamicTreeOverlap(found, n, tree, boxMin, boxMax);
+					a3demo_benchmarkLap(timer);
+					for (j = 0; j < n; ++j)
+					{
+						leaf = tree->node + tree->leaf[j];
+						count -= leaf->boundsMin[0] <= boxMax[0] && leaf->boundsMin[1] <= boxMax[1] && leaf->boundsMin[2] <= boxMax[2] &&
+							leaf->boundsMax[0] >= boxMin[0] && leaf->boundsMax[1] >= boxMin[1] && leaf->boundsMax[2] >= boxMin[2];
+					}
+					overlapBrute += a3demo_benchmarkLap(timer);
+					wrong += count != 0;
+
+					m = a3demo_queryDynamicTreeNearest(nearest, nearestDistance, k, tree, p, FLT_MAX, (a3_DemoDynamicTreeDistanceFunc)a3demo_benchmarkSphereDistance, store);
+					a3demo_benchmarkLap(timer);
+					for (j = 0, got = 0; j < n; ++j)
+					{
+						d = a3demo_benchmarkSphereDistance(store, j, p);
+						if (got == k && d >= reference[k - 1])
+							continue;
+						if (got < k)
+							++got;
+						for (o = got - 1; o && reference[o - 1] > d; --o)
+							reference[o] = reference[o - 1];
+						reference[o] = d;
+					}
+					nearestBrute += a3demo_benchmarkLap(timer);
+					wrong += m != k || nearestDistance[k - 1] != reference[k - 1];
+
+					count = a3demo_queryDynamicTreePlanes(found, n, tree, planes + i * 24, 6);
+					a3demo_benchmarkLap(timer);
+					for (j = 0; j < n; ++j)
+					{
+						leaf = tree->node + tree->leaf[j];
+						count -= !a3demo_benchmarkBoxCulled(planes + i * 24, leaf->boundsMin, leaf->boundsMax);
+					}
+					frustumBrute += a3demo_benchmarkLap(timer);
+					wrong += count != 0;
+				}
+				passed &= wrong == 0;
+				printf("\n  %-9s %6u %-7s | build %7.2f ms, height %2u, cost %6.1f | drift %7.3f ms/frame, height %2u, cost %6.1f | overlap %6.2f (%7.2f) | nearest %6.2f (%7.2f) | frustum %7.2f (%8.2f) | %u of %u off",
+					distribution[t], n, rotation[r], buildTime * 1000.0, buildHeight, buildCost,
+					updateTime * 1000.0 / (frames ? frames : 1), tree->node[tree->root].height, a3demo_getDynamicTreeCost(tree),
+					overlapTime * 1.0e6 / queries, overlapBrute * 1.0e6 / checks, nearestTime * 1.0e6 / queries, nearestBrute * 1.0e6 / checks,
+					frustumTime * 1.0e6 / queries, frustumBrute * 1.0e6 / checks, wrong, checks * 3);
+			}
+		}
+	}
+
+	// upkeep against how many objects move, everything else asleep: the
+	//	cost should follow the moving count, not the total
+	n = counts[numCounts - 1];
+	printf("\n  upkeep, %s %u rotated, moving:", distribution[1], n);
+	for (i = 0; i < numFractions; ++i)
+	{
+		m = (unsigned int)(fractions[i] * n);
+		for (f = 0, updateTime = 0.0; f < frames; ++f)
+		{
+			for (j = 0; j < m; ++j)
+			{
+				store->posX[j] += store->velX[j] * dt;
+				store->posY[j] += store->velY[j] * dt;
+				store->posZ[j] += store->velZ[j] * dt;
+			}
+			a3demo_benchmarkLap(timer);
+			for (j = 0; j < m; ++j)
+				a3demo_benchmarkMoveBox(tree, store, j);
+			updateTime += a3demo_benchmarkLap(timer);
+		}
+		printf("%s %6.2f%% %7.3f ms/frame (%.3f us each)", i ? "," : "", fractions[i] * 100.0f,
+			updateTime * 1000.0 / (frames ? frames : 1), updateTime * 1.0e6 / ((double)m * (frames ? frames : 1)));
+	}
+	a3timerStop(timer);
+	a3demo_releaseDynamicTree(tree);
+	a3demo_releaseBodyStore(store);
+	free(query);
+	free(found);
+
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+	return passed ? 1 : -1;
+}
+
+
+
+//-----------------------------------------------------------------------------
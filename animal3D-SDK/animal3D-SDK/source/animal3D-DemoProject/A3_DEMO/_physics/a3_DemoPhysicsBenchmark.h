@@ -0,0 +1,132 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPhysicsBenchmark.h
+	Console benchmarks for the physics modules; results are printed.
+*/
+
+#ifndef __ANIMAL3D_DEMOPHYSICSBENCHMARK_H
+#define __ANIMAL3D_DEMOPHYSICSBENCHMARK_H
+
+
+#include "a3_DemoBodyStore.h"
+#include "a3_DemoConvexHull.h"
+#include "a3_DemoMeshBVH.h"
+#include "a3_DemoPicking.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fill store with a random Plummer-like cluster of equal-mass bodies
+	//	(total mass 1) around the origin; returns count added
+	int a3demo_generateBodyCluster(a3_DemoBodyStore *store, const unsigned int count, const a3real radius, const unsigned int seed);
+
+	// Barnes-Hut vs brute force at 1k, 10k and 100k bodies
+	int a3demo_benchmarkGravity(const a3real theta, a3_DemoJobSystem *jobs);
+
+	// every integrator on a sun and four planets: cost per body per step
+	//	against energy and angular momentum drift after the given steps
+	int a3demo_benchmarkIntegrators(const unsigned int steps, const a3real dt);
+
+	// both broadphase strategies on uniform and clustered spheres at 10k
+	//	and 100k bodies, moving a little every step; checks that they
+	//	report identical pairs and times the hash serially for scaling
+	int a3demo_benchmarkBroadphase(const unsigned int steps, a3_DemoJobSystem *jobs);
+
+	// box stacks and pyramids at 1k, 5k and 20k boxes settling on a plane,
+	//	with and without warm starting: time per step for contacts, solve
+	//	and integration, and how far the iterations converge
+	int a3demo_benchmarkSolver(const unsigned int steps, a3_DemoJobSystem *jobs);
+
+	// 5k boxes in columns settling until they sleep, then one column
+	//	knocked over: awake count and time per step as it goes
+	int a3demo_benchmarkSleeping(const unsigned int steps, a3_DemoJobSystem *jobs);
+
+	// spheres and thin spinning boxes fired at a thin slab at increasing
+	//	speeds: how many tunnel through, and the cost, for discrete steps,
+	//	swept steps, and discrete steps small enough to need no sweeping
+	int a3demo_benchmarkContinuous(a3_DemoJobSystem *jobs);
+
+	// XPBD cloth (64x64 plane), soft sphere and rope, each stepped the
+	//	given number of times serially and in parallel: time per substep,
+	//	how far cloth and rope stretch and how well the sphere keeps its
+	//	volume; the two runs must match exactly
+	int a3demo_benchmarkSoftBody(const unsigned int steps, a3_DemoJobSystem *jobs);
+
+	// mass properties integrated over generated meshes of each shape with
+	//	an analytic form, coarse and fine, against the exact ones: volume,
+	//	center and moment error, and time per integration; also checks
+	//	that the mesh generator puts each shape where the formulas assume
+	int a3demo_benchmarkMassProperties();
+
+	// Quickhull on random points in a ball (few on the hull) and on a
+	//	sphere (all on it) from 1k to 1M points, serially and in parallel:
+	//	hull size and time against input size, checked for a closed mesh,
+	//	every sampled point inside and support queries matching a full
+	//	search; then the same ball under vertex limits, with how far out
+	//	the points left over end up
+	int a3demo_benchmarkConvexHull(a3_DemoJobSystem *jobs);
+
+	// GJK and EPA for every pair of convex shapes (sphere, box, capsule,
+	//	cylinder, cone and the given hull, or a random one if null) at
+	//	random poses: time and support steps per query from scratch and
+	//	from a cache as the pair drifts, and the depth against the
+	//	analytic tests where the pair has one
+	int a3demo_benchmarkGJK(const a3_DemoConvexHull *hull);
+
+	// triangle BVH on the given model's triangles and on a bumpy sphere of
+	//	a million: build serially and in parallel (same tree), then camera
+	//	and random rays one at a time and in packets, and sphere casts, in
+	//	queries per second, with a spread checked against every triangle
+	int a3demo_benchmarkMeshBVH(const a3_DemoMeshBVH *mesh, a3_DemoJobSystem *jobs);
+
+	// picking among 1k and 100k bodies spread evenly or clustered: tree
+	//	build, upkeep while every body drifts for a number of frames,
+	//	and cursor picks in microseconds against testing every body,
+	//	checking that both find the same body and that the hit projects
+	//	back onto its pixel
+	int a3demo_benchmarkPicking(const unsigned int frames);
+
+	// dynamic tree at 10k and 100k boxes, evenly spread or clustered,
+	//	with and without rotations: height and SAH cost after inserting
+	//	one at a time and after every box drifts for a number of frames,
+	//	box, nearest and frustum queries against testing every box (same
+	//	answers), then upkeep with only some of the boxes moving
+	int a3demo_benchmarkDynamicTree(const unsigned int frames);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOPHYSICSBENCHMARK_H
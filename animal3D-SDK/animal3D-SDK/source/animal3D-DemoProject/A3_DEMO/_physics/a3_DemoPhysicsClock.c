@@ -0,0 +1,165 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPhysicsClock.c
+	Fixed-timestep physics clock implementation.
+*/
+
+#include "a3_DemoPhysicsClock.h"
+
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initPhysicsClock(a3_DemoPhysicsClock *clock, const double stepsPerSecond, const unsigned int substeps, const unsigned int maxStepsPerUpdate)
+{
+	if (clock && stepsPerSecond > 0.0)
+	{
+		clock->stepsPerSecond = stepsPerSecond;
+		clock->secondsPerStep = 1.0 / stepsPerSecond;
+		clock->substeps = substeps ? substeps : 1;
+		clock->secondsPerSubstep = clock->secondsPerStep / (double)clock->substeps;
+		clock->maxStepsPerUpdate = maxStepsPerUpdate ? maxStepsPerUpdate : 1;
+		clock->timeScale = 1.0;
+		clock->accumulator = 0.0;
+		clock->totalTime = 0.0;
+		clock->droppedTime = 0.0;
+		clock->alpha = 0.0;
+		clock->uncapped = 0;
+		clock->steps = 0;
+		clock->stepsLastUpdate = 0;
+		clock->droppedSteps = 0;
+
+		// zero rate: timer ticks on every update and reports elapsed time
+		a3timerSet(clock->timer, 0.0);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_startPhysicsClock(a3_DemoPhysicsClock *clock)
+{
+	if (clock)
+	{
+		clock->accumulator = 0.0;
+		return a3timerStart(clock->timer);
+	}
+	return -1;
+}
+
+int a3demo_setPhysicsClockTimeScale(a3_DemoPhysicsClock *clock, const double timeScale)
+{
+	if (clock && timeScale >= 0.0)
+	{
+		clock->timeScale = timeScale;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setPhysicsClockUncapped(a3_DemoPhysicsClock *clock, const unsigned int uncapped)
+{
+	if (clock)
+	{
+		clock->uncapped = uncapped;
+		clock->accumulator = 0.0;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+unsigned int a3demo_updatePhysicsClock(a3_DemoPhysicsClock *clock)
+{
+	if (clock)
+	{
+		// keep the timer ticking even when uncapped so switching back
+		//	does not see one giant frame
+		const double secondsElapsed = (a3timerUpdate(clock->timer) > 0) ? clock->timer->previousTick : 0.0;
+		return a3demo_updatePhysicsClockElapsed(clock, secondsElapsed);
+	}
+	return 0;
+}
+
+unsigned int a3demo_updatePhysicsClockElapsed(a3_DemoPhysicsClock *clock, const double secondsElapsed)
+{
+	unsigned int steps = 0;
+	if (clock)
+	{
+		if (clock->uncapped)
+		{
+			// headless/benchmark: simulate as fast as the caller can go
+			steps = clock->maxStepsPerUpdate;
+		}
+		else
+		{
+			clock->accumulator += secondsElapsed * clock->timeScale;
+			while (clock->accumulator >= clock->secondsPerStep && steps < clock->maxStepsPerUpdate)
+			{
+				clock->accumulator -= clock->secondsPerStep;
+				++steps;
+			}
+
+			// anything left over beyond one step is dropped: the sim slows
+			//	down gracefully instead of spiralling
+			if (clock->accumulator >= clock->secondsPerStep)
+			{
+				const double excess = floor(clock->accumulator / clock->secondsPerStep);
+				clock->accumulator -= excess * clock->secondsPerStep;
+				clock->droppedSteps += (unsigned int)excess;
+				clock->droppedTime += excess * clock->secondsPerStep;
+			}
+			clock->alpha = clock->accumulator / clock->secondsPerStep;
+		}
+
+		clock->steps += steps;
+		clock->stepsLastUpdate = steps;
+		clock->totalTime += (double)steps * clock->secondsPerStep;
+	}
+	return steps;
+}
+
+unsigned int a3demo_stepPhysicsClock(a3_DemoPhysicsClock *clock)
+{
+	if (clock)
+	{
+		++clock->steps;
+		clock->stepsLastUpdate = 1;
+		clock->totalTime += clock->secondsPerStep;
+		return 1;
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+double a3demo_getPhysicsClockWarpedTime(const a3_DemoPhysicsClock *clock)
+{
+	if (clock)
+		return clock->totalTime + clock->droppedTime;
+	return 0.0;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,99 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPhysicsClock.h
+	Fixed-timestep physics clock, decoupled from the render timer.
+*/
+
+#ifndef __ANIMAL3D_DEMOPHYSICSCLOCK_H
+#define __ANIMAL3D_DEMOPHYSICSCLOCK_H
+
+
+// timer
+#include "animal3D/a3utility/a3_Timer.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoPhysicsClock	a3_DemoPhysicsClock;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// physics clock: accumulates real elapsed time and hands out whole fixed
+	//	steps, so the simulation rate does not depend on the frame rate
+	struct a3_DemoPhysicsClock
+	{
+		a3_Timer timer[1];				// wall clock, ticks every update
+		double stepsPerSecond;			// fixed simulation rate
+		double secondsPerStep;			// fixed step length
+		double secondsPerSubstep;		// step length split across substeps
+		double timeScale;				// simulated seconds per real second
+		double accumulator;				// real time not yet simulated
+		double totalTime;				// total simulated time
+		double droppedTime;				// scaled time discarded by the clamp
+		double alpha;					// leftover fraction of a step (for interpolation)
+		unsigned int substeps;			// integration substeps per fixed step
+		unsigned int maxStepsPerUpdate;	// clamp so a stall cannot snowball
+		unsigned int uncapped;			// ignore wall clock, always take max steps
+		unsigned int steps;				// total steps taken
+		unsigned int stepsLastUpdate;	// steps handed out by the last update
+		unsigned int droppedSteps;		// steps discarded by the clamp
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup: rate in steps per second, substeps per step (at least 1) and
+	//	max steps taken per update (at least 1)
+	int a3demo_initPhysicsClock(a3_DemoPhysicsClock *clock, const double stepsPerSecond, const unsigned int substeps, const unsigned int maxStepsPerUpdate);
+	int a3demo_startPhysicsClock(a3_DemoPhysicsClock *clock);
+	int a3demo_setPhysicsClockTimeScale(a3_DemoPhysicsClock *clock, const double timeScale);
+	int a3demo_setPhysicsClockUncapped(a3_DemoPhysicsClock *clock, const unsigned int uncapped);
+
+	// measure real time and return the number of fixed steps to take now
+	unsigned int a3demo_updatePhysicsClock(a3_DemoPhysicsClock *clock);
+
+	// same as above but with externally-measured elapsed time
+	unsigned int a3demo_updatePhysicsClockElapsed(a3_DemoPhysicsClock *clock, const double secondsElapsed);
+
+	// hand out exactly one step whatever the elapsed time, e.g. to single
+	//	step while the time scale is zero
+	unsigned int a3demo_stepPhysicsClock(a3_DemoPhysicsClock *clock);
+
+	// simulated time plus whatever the clamp dropped: where anything that
+	//	can be evaluated in closed form should be, however far time warps
+	double a3demo_getPhysicsClockWarpedTime(const a3_DemoPhysicsClock *clock);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOPHYSICSCLOCK_H
@@ -0,0 +1,197 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPicking.c
+	Cursor rays and body picking.
+*/
+
+#include "a3_DemoPicking.h"
+
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// what the exact test needs to know about the bodies
+typedef struct a3_DemoPickBodies
+{
+	const a3_DemoBodyStore *bodies;
+	a3real pickRadius;
+} a3_DemoPickBodies;
+
+// ray against a body's sphere from outside; a ray starting inside one
+//	hits it right away
+// the gap is measured at the ray's closest approach rather than by the
+//	usual discriminant, which cancels to noise in float when the sphere
+//	is small and far away
+a3real a3demo_pickBodySphere(const a3_DemoPickBodies *pick, const unsigned int object, const a3real *origin, const a3real *direction, const a3real maxDistance)
+{
+	const a3_DemoBodyStore *const bodies = pick->bodies;
+	const a3real radius = a3maximum(bodies->radius[object], pick->pickRadius);
+	const a3real m[3] = { origin[0] - bodies->posX[object], origin[1] - bodies->posY[object], origin[2] - bodies->posZ[object] };
+	const a3real a = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+	const a3real b = m[0] * direction[0] + m[1] * direction[1] + m[2] * direction[2];
+	a3real q[3], gap, t;
+	if (m[0] * m[0] + m[1] * m[1] + m[2] * m[2] <= radius * radius)
+		return a3realZero;
+	if (b >= a3realZero || a <= a3realZero)
+		return maxDistance;
+	t = -b / a;
+	q[0] = m[0] + direction[0] * t;
+	q[1] = m[1] + direction[1] * t;
+	q[2] = m[2] + direction[2] * t;
+	gap = radius * radius - (q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+	if (gap < a3realZero)
+		return maxDistance;
+	t -= (a3real)sqrt(gap / a);
+	return t < maxDistance ? t : maxDistance;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_getCameraPickRay(a3real *origin_out, a3real *direction_out, const a3_DemoCamera *camera, const a3real cursorX, const a3real cursorY, const a3real viewportWidth, const a3real viewportHeight)
+{
+	if (origin_out && direction_out && camera && camera->sceneObject && viewportWidth > a3realZero && viewportHeight > a3realZero)
+	{
+		a3real4 clip[2], view[2], world[2];
+		a3real length;
+		unsigned int i;
+
+		// pixel center in normalized device coordinates (y up), on the
+		//	near and far planes
+		clip[0][0] = clip[1][0] = (cursorX + a3realHalf) * a3realTwo / viewportWidth - a3realOne;
+		clip[0][1] = clip[1][1] = a3realOne - (cursorY + a3realHalf) * a3realTwo / viewportHeight;
+		clip[0][2] = -a3realOne;
+		clip[1][2] = a3realOne;
+		clip[0][3] = clip[1][3] = a3realOne;
+
+		// back through the projection into view space, then into the scene
+		for (i = 0; i < 2; ++i)
+		{
+			a3real4Real4x4ProductR(view[i], camera->projectionMatInv.m, clip[i]);
+			a3real3MulS(view[i], a3recip(view[i][3]));
+			view[i][3] = a3realOne;
+			a3real4Real4x4ProductR(world[i], camera->sceneObject->modelMat.m, view[i]);
+		}
+		a3real3Diff(direction_out, world[1], world[0]);
+		length = a3real3Length(direction_out);
+		if (length <= a3realZero)
+			return -1;
+		a3real3MulS(direction_out, a3recip(length));
+		a3real3SetReal3(origin_out, world[0]);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_getCameraFrustumPlanes(a3real *planes_out, const a3_DemoCamera *camera)
+{
+	if (planes_out && camera)
+	{
+		const a3real4 *const m = camera->viewProjectionMat.m;
+		a3real *plane, length;
+		unsigned int i, j;
+
+		// a point is inside when -w <= x, y, z <= w in clip space, so each
+		//	plane is the last row of the matrix plus or minus another one
+		for (i = 0; i < 6; ++i)
+		{
+			plane = planes_out + i * 4;
+			for (j = 0; j < 4; ++j)
+				plane[j] = (i & 1) ? m[j][3] - m[j][i / 2] : m[j][3] + m[j][i / 2];
+			length = a3real3Length(plane);
+			if (length > a3realZero)
+			{
+				length = a3recip(length);
+				plane[0] *= length;
+				plane[1] *= length;
+				plane[2] *= length;
+				plane[3] *= length;
+			}
+		}
+		return 6;
+	}
+	return -1;
+}
+
+int a3demo_updateBodyPickTree(a3_DemoDynamicTree *tree, const a3_DemoBodyStore *bodies, const a3real pickRadius)
+{
+	if (tree && tree->memory && bodies && bodies->count <= tree->capacity)
+	{
+		a3real boundsMin[3], boundsMax[3], radius;
+		unsigned int i;
+		int moved = 0;
+
+		// bodies are removed by moving the last one into the gap, so the
+		//	tree holds exactly the indices below the count it last saw
+		for (i = bodies->count; tree->count > bodies->count; ++i)
+			a3demo_removeDynamicTreeObject(tree, i);
+		for (i = 0; i < bodies->count; ++i)
+		{
+			radius = a3maximum(bodies->radius[i], pickRadius);
+			boundsMin[0] = bodies->posX[i] - radius;
+			boundsMin[1] = bodies->posY[i] - radius;
+			boundsMin[2] = bodies->posZ[i] - radius;
+			boundsMax[0] = bodies->posX[i] + radius;
+			boundsMax[1] = bodies->posY[i] + radius;
+			boundsMax[2] = bodies->posZ[i] + radius;
+			moved += a3demo_moveDynamicTreeObject(tree, i, boundsMin, boundsMax);
+		}
+		return moved;
+	}
+	return -1;
+}
+
+int a3demo_pickBody(a3_DemoPickHit *hit_out, a3_DemoDynamicTree *tree, const a3_DemoBodyStore *bodies, const a3real *origin, const a3real *direction, const a3real maxDistance, const a3real pickRadius)
+{
+	if (hit_out && tree && bodies && origin && direction)
+	{
+		a3_DemoPickBodies pick[1];
+		a3real distance = maxDistance, length;
+		unsigned int object = (unsigned int)-1;
+		int status;
+
+		pick->bodies = bodies;
+		pick->pickRadius = pickRadius;
+		status = a3demo_raycastDynamicTree(&object, &distance, tree, origin, direction, (a3_DemoDynamicTreeRayFunc)a3demo_pickBodySphere, pick);
+		if (status < 0)
+			return -1;
+		if (status && object < bodies->count)
+		{
+			length = a3real3Length(direction);
+			hit_out->point[0] = origin[0] + direction[0] * distance;
+			hit_out->point[1] = origin[1] + direction[1] * distance;
+			hit_out->point[2] = origin[2] + direction[2] * distance;
+			hit_out->distance = distance * length;
+			hit_out->object = object;
+			return 1;
+		}
+		hit_out->point[0] = hit_out->point[1] = hit_out->point[2] = a3realZero;
+		hit_out->distance = maxDistance * a3real3Length(direction);
+		hit_out->object = (unsigned int)-1;
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
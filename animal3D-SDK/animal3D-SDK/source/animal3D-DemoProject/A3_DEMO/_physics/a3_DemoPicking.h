@@ -0,0 +1,94 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoPicking.h
+	What is under the cursor: rays through the camera, and the nearest
+		body along one, found through a dynamic tree over the bodies;
+		also the camera's frustum planes for culling through such a tree.
+*/
+
+#ifndef __ANIMAL3D_DEMOPICKING_H
+#define __ANIMAL3D_DEMOPICKING_H
+
+
+#include "a3_DemoBodyStore.h"
+#include "a3_DemoDynamicTree.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoPickHit	a3_DemoPickHit;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// what a pick found
+	struct a3_DemoPickHit
+	{
+		a3real3 point;					// where the ray met the body's sphere
+		a3real distance;				// from the ray origin, in world units
+		unsigned int object;			// body index; -1 for nothing
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// ray from the near plane through a pixel, by unprojecting it with
+	//	the camera's inverse projection and inverse view (its scene
+	//	object's model matrix)
+	//	param cursorX, cursorY: pixels from the viewport's top-left corner
+	//	param direction_out: unit
+	//	-> returns 1, -1 if invalid params
+	int a3demo_getCameraPickRay(a3real *origin_out, a3real *direction_out, const a3_DemoCamera *camera, const a3real cursorX, const a3real cursorY, const a3real viewportWidth, const a3real viewportHeight);
+
+	// the six planes around what the camera sees (left, right, bottom,
+	//	top, near, far), facing in, taken from its view-projection matrix
+	//	param planes_out: 24 values, xyzw each, xyz unit
+	//	-> returns 6, -1 if invalid params
+	int a3demo_getCameraFrustumPlanes(a3real *planes_out, const a3_DemoCamera *camera);
+
+	// bring a tree over the bodies' spheres up to date: new bodies go in,
+	//	removed ones come out, and moved ones are only touched once they
+	//	leave their fattened boxes
+	//	param pickRadius: spheres smaller than this (points, asteroids)
+	//		are picked as if they were this big
+	//	-> returns bodies whose leaves changed, -1 if invalid params
+	int a3demo_updateBodyPickTree(a3_DemoDynamicTree *tree, const a3_DemoBodyStore *bodies, const a3real pickRadius);
+
+	// nearest body along a ray, within maxDistance (units of the
+	//	direction's length); the tree must be current
+	//	-> returns 1 if hit, 0 if not, -1 if invalid params
+	int a3demo_pickBody(a3_DemoPickHit *hit_out, a3_DemoDynamicTree *tree, const a3_DemoBodyStore *bodies, const a3real *origin, const a3real *direction, const a3real maxDistance, const a3real pickRadius);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOPICKING_H
@@ -0,0 +1,191 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRigidBody.c
+	Rigid body setup and integration.
+*/
+
+#include "a3_DemoRigidBody.h"
+#include "../_utilities/a3_DemoQuaternion.h"
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// inverse of a principal moment, zero for degenerate or static shapes
+inline a3real a3demo_rigidBodyInvMoment(const a3real moment)
+{
+	return moment > a3realZero ? a3recip(moment) : a3realZero;
+}
+
+// principal moments about the collider center for the given mass;
+//	cylinders stand in for capsules and cones since their centers are
+//	already only approximately the center of mass
+void a3demo_rigidBodyInertia(a3real *moment_out, const a3_DemoCollider *collider, const a3real mass)
+{
+	const a3real r2 = collider->radius * collider->radius;
+	const a3real *h = collider->halfExtent;
+	a3real length, axial, lateral;
+	switch (collider->type)
+	{
+	case a3demo_collider_sphere:
+		moment_out[0] = moment_out[1] = moment_out[2] = 0.4f * mass * r2;
+		break;
+	case a3demo_collider_box:
+		moment_out[0] = mass * (h[1] * h[1] + h[2] * h[2]) / 3.0f;
+		moment_out[1] = mass * (h[0] * h[0] + h[2] * h[2]) / 3.0f;
+		moment_out[2] = mass * (h[0] * h[0] + h[1] * h[1]) / 3.0f;
+		break;
+	case a3demo_collider_capsule:
+	case a3demo_collider_cylinder:
+	case a3demo_collider_cone:
+		length = collider->halfLength * a3realTwo + (collider->type == a3demo_collider_capsule ? collider->radius * a3realTwo : a3realZero);
+		axial = a3realHalf * mass * r2;
+		lateral = mass * (3.0f * r2 + length * length) / 12.0f;
+		moment_out[0] = moment_out[1] = moment_out[2] = lateral;
+		moment_out[collider->axis] = axial;
+		break;
+	case a3demo_collider_hull:
+		// ball of the hull's radius until real mass properties are set
+		moment_out[0] = moment_out[1] = moment_out[2] = 0.4f * mass * collider->hull->radius * collider->hull->radius;
+		break;
+	default:
+		moment_out[0] = moment_out[1] = moment_out[2] = a3realZero;
+		break;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initRigidBody(a3_DemoRigidBody *body, const a3_DemoCollider *collider, const a3real mass, const a3real x, const a3real y, const a3real z)
+{
+	if (body && collider && mass >= a3realZero)
+	{
+		a3real moment[3];
+		memset(body, 0, sizeof(a3_DemoRigidBody));
+		body->collider = *collider;
+		body->orientation[3] = a3realOne;
+
+		// planes are always static
+		if (mass > a3realZero && collider->type != a3demo_collider_plane)
+		{
+			body->invMass = a3recip(mass);
+			a3demo_rigidBodyInertia(moment, collider, mass);
+			body->invInertiaLocal[0] = a3demo_rigidBodyInvMoment(moment[0]);
+			body->invInertiaLocal[1] = a3demo_rigidBodyInvMoment(moment[1]);
+			body->invInertiaLocal[2] = a3demo_rigidBodyInvMoment(moment[2]);
+		}
+		body->pose.position[0] = x;
+		body->pose.position[1] = y;
+		body->pose.position[2] = z;
+		a3demo_updateRigidBodyPose(body);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setRigidBodyMassProperties(a3_DemoRigidBody *body, const a3_DemoMassProperties *props)
+{
+	if (body && props && props->mass > a3realZero)
+	{
+		if (body->collider.type != a3demo_collider_plane)
+		{
+			body->invMass = a3recip(props->mass);
+			body->invInertiaLocal[0] = a3demo_rigidBodyInvMoment(props->inertia[0][0]);
+			body->invInertiaLocal[1] = a3demo_rigidBodyInvMoment(props->inertia[1][1]);
+			body->invInertiaLocal[2] = a3demo_rigidBodyInvMoment(props->inertia[2][2]);
+		}
+		return a3demo_updateRigidBodyPose(body);
+	}
+	return -1;
+}
+
+int a3demo_setRigidBodyRotation(a3_DemoRigidBody *body, const a3real axisX, const a3real axisY, const a3real axisZ, const a3real degrees)
+{
+	if (body)
+	{
+		a3real3 axis = { axisX, axisY, axisZ };
+		a3demo_quatSetAxisAngle(body->orientation, axis, degrees);
+		return a3demo_updateRigidBodyPose(body);
+	}
+	return -1;
+}
+
+int a3demo_updateRigidBodyPose(a3_DemoRigidBody *body)
+{
+	if (body)
+	{
+		const a3real *d = body->invInertiaLocal;
+		a3real(*R)[3] = body->pose.rotation, (*I)[3] = body->invInertia;
+		unsigned int i, j;
+
+		// columns are the body axes in world space
+		a3demo_real3x3SetQuat(R, body->orientation);
+
+		// R diag(d) R^T, symmetric
+		for (i = 0; i < 3; ++i)
+			for (j = i; j < 3; ++j)
+				I[i][j] = I[j][i] = R[0][i] * d[0] * R[0][j] + R[1][i] * d[1] * R[1][j] + R[2][i] * d[2] * R[2][j];
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_integrateRigidBody(a3_DemoRigidBody *body, const a3real dt)
+{
+	if (body)
+	{
+		a3real w[3] = {
+			body->angularVelocity[0] + body->pushAngularVelocity[0],
+			body->angularVelocity[1] + body->pushAngularVelocity[1],
+			body->angularVelocity[2] + body->pushAngularVelocity[2],
+		};
+
+		body->pose.position[0] += (body->velocity[0] + body->pushVelocity[0]) * dt;
+		body->pose.position[1] += (body->velocity[1] + body->pushVelocity[1]) * dt;
+		body->pose.position[2] += (body->velocity[2] + body->pushVelocity[2]) * dt;
+		body->pushVelocity[0] = body->pushVelocity[1] = body->pushVelocity[2] = a3realZero;
+		body->pushAngularVelocity[0] = body->pushAngularVelocity[1] = body->pushAngularVelocity[2] = a3realZero;
+
+		a3demo_quatIntegrate(body->orientation, w, dt);
+		return a3demo_updateRigidBodyPose(body);
+	}
+	return -1;
+}
+
+int a3demo_applyRigidBodyInvInertia(const a3_DemoRigidBody *body, a3real *out, const a3real *v)
+{
+	if (body && out && v)
+	{
+		const a3real(*I)[3] = (const a3real(*)[3])body->invInertia;
+		const a3real x = v[0], y = v[1], z = v[2];
+		out[0] = I[0][0] * x + I[1][0] * y + I[2][0] * z;
+		out[1] = I[0][1] * x + I[1][1] * y + I[2][1] * z;
+		out[2] = I[0][2] * x + I[1][2] * y + I[2][2] * z;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRigidBody.h
+	Rigid bodies with orientation for contact solving.
+*/
+
+#ifndef __ANIMAL3D_DEMORIGIDBODY_H
+#define __ANIMAL3D_DEMORIGIDBODY_H
+
+
+#include "a3_DemoCollider.h"
+#include "a3_DemoMassProperties.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoRigidBody			a3_DemoRigidBody;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// rigid body: the pose position is the center of mass and the
+	//	rotation is kept in step with the orientation quaternion
+	// bodies with zero inverse mass never move and are never written by
+	//	the solver, so any number of islands may share them
+	struct a3_DemoRigidBody
+	{
+		a3_DemoColliderPose pose;		// world position and rotation
+		a3real4 orientation;			// unit quaternion (x, y, z, w)
+		a3real3 velocity;				// linear velocity
+		a3real3 angularVelocity;		// world space, radians per second
+		a3real3 pushVelocity;			// overlap correction for one step only:
+		a3real3 pushAngularVelocity;	//	moves the pose but is never momentum
+		a3real3 invInertiaLocal;		// diagonal inverse inertia in body space
+		a3real3x3 invInertia;			// world inverse inertia (from the pose)
+		a3real invMass;					// zero is immovable
+		a3_DemoCollider collider;
+		unsigned int restSteps;			// consecutive steps below the sleep thresholds
+		unsigned int asleep;			// frozen until woken by a contact or a call
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// body at rest at a position with no rotation; mass properties come
+	//	from the collider's shape at uniform density (zero mass is static)
+	int a3demo_initRigidBody(a3_DemoRigidBody *body, const a3_DemoCollider *collider, const a3real mass, const a3real x, const a3real y, const a3real z);
+
+	// replace the shape's mass and inertia with measured ones (e.g. from
+	//	a loaded mesh); the body axes are the mesh axes, so only the
+	//	tensor's diagonal is used, which is exact when those axes are
+	//	principal (true of every procedural shape)
+	int a3demo_setRigidBodyMassProperties(a3_DemoRigidBody *body, const a3_DemoMassProperties *props);
+
+	// set orientation from a unit axis and angle in degrees
+	int a3demo_setRigidBodyRotation(a3_DemoRigidBody *body, const a3real axisX, const a3real axisY, const a3real axisZ, const a3real degrees);
+
+	// rebuild rotation and world inverse inertia from the orientation
+	int a3demo_updateRigidBodyPose(a3_DemoRigidBody *body);
+
+	// advance position and orientation by the current velocities plus the
+	//	push velocities, then clear the push
+	int a3demo_integrateRigidBody(a3_DemoRigidBody *body, const a3real dt);
+
+	// world inverse inertia times a vector
+	int a3demo_applyRigidBodyInvInertia(const a3_DemoRigidBody *body, a3real *out, const a3real *v);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMORIGIDBODY_H
@@ -0,0 +1,611 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRigidWorld.c
+	Rigid body world step.
+*/
+
+#include "a3_DemoRigidWorld.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// rigid world internal constants
+enum a3_DemoRigidWorldInternal
+{
+	a3demo_rigidWorldPairGrain = 256,	// narrowphase pairs per job at the finest split
+	a3demo_rigidWorldSleepSteps = 30,	// half a second at 60 Hz
+	a3demo_rigidWorldEmpty = ~0u,		// empty GJK cache slot
+};
+
+// arguments for the narrowphase jobs: a range of pairs starting here
+typedef struct a3_DemoRigidWorldTask
+{
+	a3_DemoRigidWorld *world;
+	unsigned int first;
+} a3_DemoRigidWorldTask;
+
+
+// dynamic and not asleep
+inline int a3demo_rigidWorldAwake(const a3_DemoRigidBody *body)
+{
+	return body->invMass > a3realZero && !body->asleep;
+}
+
+// how far any point of a body could move in a step: its velocity plus
+//	its spin at the bounding radius (spin moves no part of a sphere
+//	about its center out of the sphere)
+inline a3real a3demo_rigidWorldMotion(const a3_DemoRigidBody *body, const a3real dt)
+{
+	const a3real reach = (body->collider.type == a3demo_collider_sphere && body->collider.offset == a3realZero) ?
+		a3realZero : body->collider.boundingRadius;
+	const a3real v[3] = {
+		body->velocity[0] + body->pushVelocity[0],
+		body->velocity[1] + body->pushVelocity[1],
+		body->velocity[2] + body->pushVelocity[2],
+	};
+	const a3real w[3] = {
+		body->angularVelocity[0] + body->pushAngularVelocity[0],
+		body->angularVelocity[1] + body->pushAngularVelocity[1],
+		body->angularVelocity[2] + body->pushAngularVelocity[2],
+	};
+	return ((a3real)sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) +
+		(a3real)sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]) * reach) * dt;
+}
+
+// awake and moving further this step than the threshold allows
+inline int a3demo_rigidWorldFast(const a3_DemoRigidWorld *world, const a3_DemoRigidBody *body, const a3real dt)
+{
+	return a3demo_rigidWorldAwake(body) && a3demo_rigidWorldMotion(body, dt) > world->sweepThreshold * body->collider.boundingRadius;
+}
+
+// where a body starts and how far it moves this step (sleepers stay put)
+inline void a3demo_rigidWorldPath(a3real *start_out, a3real *move_out, const a3_DemoRigidBody *body, const a3real dt)
+{
+	const a3real scale = a3demo_rigidWorldAwake(body) ? dt : a3realZero;
+	start_out[0] = body->pose.position[0];
+	start_out[1] = body->pose.position[1];
+	start_out[2] = body->pose.position[2];
+	move_out[0] = (body->velocity[0] + body->pushVelocity[0]) * scale;
+	move_out[1] = (body->velocity[1] + body->pushVelocity[1]) * scale;
+	move_out[2] = (body->velocity[2] + body->pushVelocity[2]) * scale;
+}
+
+// record an impact, growing the list as needed
+void a3demo_rigidWorldAddImpact(a3_DemoRigidWorld *world, const unsigned int a, const unsigned int b, const a3real toi, const a3real *normal)
+{
+	a3_DemoImpactEvent *impact;
+	if (world->impactCount == world->impactCapacity)
+	{
+		const unsigned int capacity = world->impactCapacity ? world->impactCapacity + world->impactCapacity / 2 : 64;
+		impact = (a3_DemoImpactEvent *)realloc(world->impact, capacity * sizeof(a3_DemoImpactEvent));
+		if (!impact)
+			return;
+		world->impact = impact;
+		world->impactCapacity = capacity;
+	}
+	impact = world->impact + world->impactCount++;
+	impact->toi = toi;
+	impact->a = a;
+	impact->b = b;
+	impact->normal[0] = normal[0];
+	impact->normal[1] = normal[1];
+	impact->normal[2] = normal[2];
+}
+
+// how much of the step each awake body may take: fast ones stop at their
+//	first impact; events come out sorted
+void a3demo_rigidWorldSweep(a3_DemoRigidWorld *world, const a3real dt)
+{
+	const a3_DemoRigidBody *body, *other;
+	const a3_DemoBodyPair *pair;
+	a3real toi, startA[3], startB[3], moveA[3], moveB[3], velocity[3], spin[3], normal[3];
+	unsigned int i, p, a, b;
+
+	for (i = 0; i < world->count; ++i)
+		world->sweepTime[i] = a3realOne;
+
+	// against planes, which are not in the pair list
+	for (i = 0, body = world->body; i < world->count; ++i, ++body)
+	{
+		if (!a3demo_rigidWorldFast(world, body, dt))
+			continue;
+		a3demo_rigidWorldPath(startA, velocity, body, a3realOne);
+		spin[0] = body->angularVelocity[0] + body->pushAngularVelocity[0];
+		spin[1] = body->angularVelocity[1] + body->pushAngularVelocity[1];
+		spin[2] = body->angularVelocity[2] + body->pushAngularVelocity[2];
+		for (p = 0; p < world->planeCount; ++p)
+		{
+			other = world->body + world->plane[p];
+			if (a3demo_advanceCollider(&toi, normal, &body->collider, &body->pose, velocity, spin, dt, &other->collider, &other->pose))
+			{
+				a3demo_rigidWorldAddImpact(world, i, world->plane[p], toi, normal);
+				world->sweepTime[i] = a3minimum(world->sweepTime[i], toi);
+			}
+		}
+	}
+
+	// against other bodies: candidates already cover the step; a fast
+	//	body advances against a slow one as if the slow one held still
+	//	(relative motion, its spin ignored), and two fast bodies sweep
+	//	their bounding spheres, which stops them early rather than late;
+	//	once they touch the discrete test takes over
+	for (i = 0, pair = world->pair; i < world->pairCount; ++i, ++pair)
+	{
+		a = pair->a;
+		b = pair->b;
+		body = world->body + a;
+		other = world->body + b;
+		if (body->collider.type == a3demo_collider_plane || other->collider.type == a3demo_collider_plane)
+			continue;
+		if (!a3demo_rigidWorldFast(world, body, dt))
+		{
+			if (!a3demo_rigidWorldFast(world, other, dt))
+				continue;
+			body = world->body + b;
+			other = world->body + a;
+		}
+		a3demo_rigidWorldPath(startA, moveA, body, dt);
+		a3demo_rigidWorldPath(startB, moveB, other, dt);
+		if (a3demo_rigidWorldFast(world, other, dt))
+		{
+			if (!a3demo_sweepSpheres(&toi, normal, startA, moveA, body->collider.boundingRadius, startB, moveB, other->collider.boundingRadius))
+				continue;
+		}
+		else
+		{
+			velocity[0] = (moveA[0] - moveB[0]) / dt;
+			velocity[1] = (moveA[1] - moveB[1]) / dt;
+			velocity[2] = (moveA[2] - moveB[2]) / dt;
+			spin[0] = body->angularVelocity[0] + body->pushAngularVelocity[0];
+			spin[1] = body->angularVelocity[1] + body->pushAngularVelocity[1];
+			spin[2] = body->angularVelocity[2] + body->pushAngularVelocity[2];
+			if (!a3demo_advanceCollider(&toi, normal, &body->collider, &body->pose, velocity, spin, dt, &other->collider, &other->pose))
+				continue;
+		}
+
+		// events keep the pair's order, normal from a to b
+		if (body != world->body + a)
+		{
+			normal[0] = -normal[0];
+			normal[1] = -normal[1];
+			normal[2] = -normal[2];
+		}
+		a3demo_rigidWorldAddImpact(world, a, b, toi, normal);
+		if (a3demo_rigidWorldAwake(world->body + a))
+			world->sweepTime[a] = a3minimum(world->sweepTime[a], toi);
+		if (a3demo_rigidWorldAwake(world->body + b))
+			world->sweepTime[b] = a3minimum(world->sweepTime[b], toi);
+	}
+	a3demo_sortImpacts(world->impact, world->impactCount);
+}
+
+// GJK cache slot for a body pair
+inline unsigned int a3demo_rigidWorldHash(const unsigned int a, const unsigned int b, const unsigned int size)
+{
+	return (a * 73856093u ^ b * 19349663u) & (size - 1);
+}
+
+// GJK state a pair was left with last step, or a fresh one
+void a3demo_rigidWorldFindGJK(a3_DemoGJKCache *cache_out, const a3_DemoRigidWorld *world, const unsigned int a, const unsigned int b)
+{
+	const a3_DemoRigidWorldGJKEntry *entry;
+	unsigned int slot;
+	if (world->gjkCacheCount)
+		for (slot = a3demo_rigidWorldHash(a, b, world->gjkCacheSize); (entry = world->gjkCache + slot)->a != a3demo_rigidWorldEmpty; slot = (slot + 1) & (world->gjkCacheSize - 1))
+			if (entry->a == a && entry->b == b)
+			{
+				*cache_out = entry->gjk;
+				return;
+			}
+	a3demo_initGJKCache(cache_out);
+}
+
+// keep the GJK state of every candidate pair that goes to GJK, tested
+//	this step or not (pairs of sleepers carry theirs over)
+int a3demo_rigidWorldRebuildGJK(a3_DemoRigidWorld *world, const unsigned int tested)
+{
+	const a3_DemoRigidBody *bodyA, *bodyB;
+	a3_DemoRigidWorldGJKEntry *entry;
+	unsigned int i, size, slot, count;
+
+	for (i = count = 0; i < world->pairCount; ++i)
+	{
+		bodyA = world->body + world->pair[i].a;
+		bodyB = world->body + world->pair[i].b;
+		if (!a3demo_canCollideColliders(bodyA->collider.type, bodyB->collider.type))
+		{
+			if (i >= tested)
+				a3demo_rigidWorldFindGJK(&world->manifold[i].gjk, world, world->pair[i].a, world->pair[i].b);
+			++count;
+		}
+	}
+
+	for (size = 64; size < count * 2; size <<= 1);
+	if (world->gjkCacheSize != size)
+	{
+		free(world->gjkCache);
+		world->gjkCache = (a3_DemoRigidWorldGJKEntry *)malloc(size * sizeof(a3_DemoRigidWorldGJKEntry));
+		world->gjkCacheSize = world->gjkCache ? size : 0;
+		world->gjkCacheCount = 0;
+		if (!world->gjkCache)
+			return -1;
+	}
+	memset(world->gjkCache, 0xff, size * sizeof(a3_DemoRigidWorldGJKEntry));
+	for (i = world->gjkCacheCount = 0; i < world->pairCount; ++i)
+	{
+		bodyA = world->body + world->pair[i].a;
+		bodyB = world->body + world->pair[i].b;
+		if (a3demo_canCollideColliders(bodyA->collider.type, bodyB->collider.type))
+			continue;
+		for (slot = a3demo_rigidWorldHash(world->pair[i].a, world->pair[i].b, size); world->gjkCache[slot].a != a3demo_rigidWorldEmpty; slot = (slot + 1) & (size - 1));
+		entry = world->gjkCache + slot;
+		entry->a = world->pair[i].a;
+		entry->b = world->pair[i].b;
+		entry->gjk = world->manifold[i].gjk;
+		++world->gjkCacheCount;
+	}
+	return 1;
+}
+
+// one narrowphase test per candidate pair, into the pair's own slot;
+//	GJK pairs start from the state they were left with last step
+void a3demo_rigidWorldNarrowphase(a3_DemoRigidWorldTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoRigidWorld *world = task->world;
+	const a3_DemoRigidBody *bodyA, *bodyB;
+	a3_DemoContactManifold *manifold;
+	unsigned int i;
+	for (i = task->first + first; i < task->first + first + count; ++i)
+	{
+		manifold = world->manifold + i;
+		bodyA = world->body + world->pair[i].a;
+		bodyB = world->body + world->pair[i].b;
+		if (!a3demo_canCollideColliders(bodyA->collider.type, bodyB->collider.type))
+			a3demo_rigidWorldFindGJK(&manifold->gjk, world, world->pair[i].a, world->pair[i].b);
+		else
+			a3demo_initGJKCache(&manifold->gjk);
+		if (a3demo_collideColliders(manifold, &bodyA->collider, &bodyA->pose, &bodyB->collider, &bodyB->pose, &manifold->gjk) <= 0)
+			manifold->count = 0;
+		manifold->a = world->pair[i].a;
+		manifold->b = world->pair[i].b;
+	}
+}
+
+// grow pair and manifold storage
+int a3demo_rigidWorldReservePairs(a3_DemoRigidWorld *world, const unsigned int count)
+{
+	if (world->pairCapacity < count)
+	{
+		const unsigned int capacity = count + count / 2;
+		free(world->pair);
+		free(world->manifold);
+		world->pair = (a3_DemoBodyPair *)malloc(capacity * sizeof(a3_DemoBodyPair));
+		world->manifold = (a3_DemoContactManifold *)malloc(capacity * sizeof(a3_DemoContactManifold));
+		world->pairCapacity = (world->pair && world->manifold) ? capacity : 0;
+		if (!world->pairCapacity)
+			return -1;
+	}
+	return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createRigidWorld(a3_DemoRigidWorld *world, const unsigned int capacity, a3_DemoJobSystem *jobs)
+{
+	if (world && capacity)
+	{
+		memset(world, 0, sizeof(a3_DemoRigidWorld));
+		world->body = (a3_DemoRigidBody *)malloc(capacity * sizeof(a3_DemoRigidBody));
+		world->proxyBody = (unsigned int *)malloc(capacity * 3 * sizeof(unsigned int));
+		world->plane = world->proxyBody + capacity;
+		world->islandRest = world->plane + capacity;
+		world->sweepTime = (a3real *)malloc(capacity * sizeof(a3real));
+		if (!world->body || !world->proxyBody || !world->sweepTime || a3demo_createBodyStore(world->proxy, capacity) < 0)
+		{
+			a3demo_releaseRigidWorld(world);
+			return -1;
+		}
+		world->capacity = capacity;
+		world->jobs = jobs;
+		world->gravity[2] = -9.81f;
+		world->sleepSteps = a3demo_rigidWorldSleepSteps;
+		world->sleepSpeed = 0.05f;
+		world->sleepAngularSpeed = 0.1f;
+		world->sweepThreshold = a3realHalf;
+		a3demo_initBroadphase(world->broadphase, a3demo_broadphase_spatialHash, jobs);
+		world->broadphase->keepSleeping = 1;	// sleeper pairs keep their GJK state
+		a3demo_initContactSolver(world->solver, 0, jobs);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_releaseRigidWorld(a3_DemoRigidWorld *world)
+{
+	if (world)
+	{
+		a3demo_releaseContactSolver(world->solver);
+		a3demo_releaseBroadphase(world->broadphase);
+		a3demo_releaseBodyStore(world->proxy);
+		free(world->body);
+		free(world->proxyBody);
+		free(world->sweepTime);
+		free(world->impact);
+		free(world->pair);
+		free(world->manifold);
+		free(world->gjkCache);
+		world->body = 0;
+		world->sweepTime = 0;
+		world->impact = 0;
+		world->impactCount = world->impactCapacity = 0;
+		world->proxyBody = world->plane = world->islandRest = 0;
+		world->pair = 0;
+		world->manifold = 0;
+		world->gjkCache = 0;
+		world->gjkCacheSize = world->gjkCacheCount = 0;
+		world->count = world->capacity = world->planeCount = world->awakeCount = 0;
+		world->pairCount = world->manifoldCount = world->pairCapacity = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_clearRigidWorld(a3_DemoRigidWorld *world)
+{
+	if (world)
+	{
+		world->count = world->planeCount = world->awakeCount = 0;
+		world->pairCount = world->manifoldCount = world->impactCount = 0;
+		world->gjkCacheCount = 0;
+		a3demo_clearBodyStore(world->proxy);
+		a3demo_setBroadphaseType(world->broadphase, world->broadphase->type);
+		a3demo_resetContactSolver(world->solver);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_addRigidBody(a3_DemoRigidWorld *world, const a3_DemoRigidBody *body)
+{
+	if (world && body && world->count < world->capacity)
+	{
+		const unsigned int index = world->count++;
+		world->body[index] = *body;
+		world->body[index].restSteps = world->body[index].asleep = 0;
+		world->awakeCount += body->invMass > a3realZero;
+		if (body->collider.type == a3demo_collider_plane)
+			world->plane[world->planeCount++] = index;
+		else
+		{
+			world->proxyBody[world->proxy->count] = index;
+			a3demo_addBody(world->proxy, body->pose.position, body->velocity, a3realOne, body->collider.boundingRadius);
+		}
+		return index;
+	}
+	return -1;
+}
+
+int a3demo_wakeRigidBody(a3_DemoRigidWorld *world, const unsigned int index)
+{
+	if (world && index < world->count)
+	{
+		a3_DemoRigidBody *body = world->body + index;
+		body->restSteps = 0;
+		if (body->asleep)
+		{
+			body->asleep = 0;
+			++world->awakeCount;
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_stepRigidWorld(a3_DemoRigidWorld *world, const a3real dt)
+{
+	if (a3demo_collideRigidWorld(world, dt) < 0 || a3demo_solveRigidWorld(world, dt) < 0)
+		return -1;
+	return a3demo_integrateRigidWorld(world, dt);
+}
+
+int a3demo_collideRigidWorld(a3_DemoRigidWorld *world, const a3real dt)
+{
+	if (world && dt > a3realZero)
+	{
+		a3_DemoRigidWorldTask task[1];
+		a3_DemoRigidBody *body;
+		const a3_DemoBodyPair *candidate;
+		a3_DemoBodyPair *pair, swap;
+		a3real normal[3], center[3];
+		unsigned int i, p, count, done;
+
+		// a settled world costs nothing
+		world->pairCount = world->manifoldCount = 0;
+		if (!world->awakeCount)
+			return 0;
+
+		// gravity first, so resting contacts see it this step
+		for (i = 0, body = world->body; i < world->count; ++i, ++body)
+			if (a3demo_rigidWorldAwake(body))
+			{
+				body->velocity[0] += world->gravity[0] * dt;
+				body->velocity[1] += world->gravity[1] * dt;
+				body->velocity[2] += world->gravity[2] * dt;
+			}
+
+		// bounding spheres into the broadphase, grown to cover the step for
+		//	bodies that will be swept; sleepers have not moved
+		for (i = 0; i < world->proxy->count; ++i)
+		{
+			body = world->body + world->proxyBody[i];
+			if (body->asleep)
+				world->proxy->flags[i] |= a3demo_bodyFlag_sleeping;
+			else
+			{
+				world->proxy->flags[i] &= ~a3demo_bodyFlag_sleeping;
+				world->proxy->posX[i] = body->pose.position[0];
+				world->proxy->posY[i] = body->pose.position[1];
+				world->proxy->posZ[i] = body->pose.position[2];
+				world->proxy->radius[i] = body->collider.boundingRadius;
+				if (world->sweepThreshold >= a3realZero && a3demo_rigidWorldFast(world, body, dt))
+					world->proxy->radius[i] += a3demo_rigidWorldMotion(body, dt);
+			}
+		}
+		if (a3demo_updateBroadphase(world->broadphase, world->proxy) < 0)
+			return -1;
+
+		// candidates: broadphase pairs with something that moves, then
+		//	bodies whose bounding sphere reaches below a plane
+		if (a3demo_rigidWorldReservePairs(world, world->broadphase->pairCount + world->planeCount * world->count) < 0)
+			return -1;
+		pair = world->pair;
+		for (i = 0, candidate = world->broadphase->pair; i < world->broadphase->pairCount; ++i, ++candidate)
+		{
+			pair->a = world->proxyBody[candidate->a];
+			pair->b = world->proxyBody[candidate->b];
+			if (world->body[pair->a].invMass > a3realZero || world->body[pair->b].invMass > a3realZero)
+				++pair;
+		}
+		for (p = 0; p < world->planeCount; ++p)
+		{
+			const a3_DemoRigidBody *plane = world->body + world->plane[p];
+			a3demo_getColliderWorldFrame(&plane->collider, &plane->pose, center, normal);
+			for (i = 0, body = world->body; i < world->count; ++i, ++body)
+				if (body->invMass > a3realZero &&
+					(body->pose.position[0] - center[0]) * normal[0] +
+					(body->pose.position[1] - center[1]) * normal[1] +
+					(body->pose.position[2] - center[2]) * normal[2] <= body->collider.boundingRadius)
+				{
+					pair->a = i;
+					pair->b = world->plane[p];
+					++pair;
+				}
+		}
+		world->pairCount = (unsigned int)(pair - world->pair);
+
+		// exact tests in parallel, only for pairs with an awake body; any
+		//	sleeper found touching wakes, which can bring more pairs in, so
+		//	repeat on the pairs left over until nothing new wakes
+		task->world = world;
+		for (done = 0; ; done = count)
+		{
+			for (i = count = done; i < world->pairCount; ++i)
+				if (a3demo_rigidWorldAwake(world->body + world->pair[i].a) || a3demo_rigidWorldAwake(world->body + world->pair[i].b))
+				{
+					swap = world->pair[i];
+					world->pair[i] = world->pair[count];
+					world->pair[count++] = swap;
+				}
+			if (count == done)
+				break;
+			task->first = done;
+			a3demo_parallelFor(world->jobs, (a3_DemoJobFunc)a3demo_rigidWorldNarrowphase, task, count - done, a3demo_rigidWorldPairGrain);
+			for (i = done; i < count; ++i)
+				if (world->manifold[i].count)
+				{
+					if (world->body[world->manifold[i].a].asleep)
+						a3demo_wakeRigidBody(world, world->manifold[i].a);
+					if (world->body[world->manifold[i].b].asleep)
+						a3demo_wakeRigidBody(world, world->manifold[i].b);
+				}
+		}
+
+		// GJK state for next step, then keep the ones that touch
+		if (a3demo_rigidWorldRebuildGJK(world, done) < 0)
+			return -1;
+		for (i = count = 0; i < done; ++i)
+			if (world->manifold[i].count)
+				world->manifold[count++] = world->manifold[i];
+		world->manifoldCount = count;
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_solveRigidWorld(a3_DemoRigidWorld *world, const a3real dt)
+{
+	if (world)
+		return world->awakeCount ? a3demo_solveContacts(world->solver, world->body, world->count, world->manifold, world->manifoldCount, dt) : 0;
+	return -1;
+}
+
+int a3demo_integrateRigidWorld(a3_DemoRigidWorld *world, const a3real dt)
+{
+	if (world)
+	{
+		const a3real speedSq = world->sleepSpeed * world->sleepSpeed;
+		const a3real angularSq = world->sleepAngularSpeed * world->sleepAngularSpeed;
+		a3_DemoRigidBody *body;
+		unsigned int i, root;
+
+		if (!world->awakeCount)
+			return 0;
+
+		// fast bodies only go as far as their first impact
+		world->impactCount = 0;
+		if (world->sweepThreshold >= a3realZero)
+			a3demo_rigidWorldSweep(world, dt);
+		for (i = 0, body = world->body; i < world->count; ++i, ++body)
+			if (a3demo_rigidWorldAwake(body))
+			{
+				a3demo_integrateRigidBody(body, world->sweepThreshold >= a3realZero ? dt * world->sweepTime[i] : dt);
+				if (body->velocity[0] * body->velocity[0] + body->velocity[1] * body->velocity[1] + body->velocity[2] * body->velocity[2] < speedSq &&
+					body->angularVelocity[0] * body->angularVelocity[0] + body->angularVelocity[1] * body->angularVelocity[1] + body->angularVelocity[2] * body->angularVelocity[2] < angularSq)
+					++body->restSteps;
+				else
+					body->restSteps = 0;
+			}
+
+		// an island sleeps only when every body in it has rested long
+		//	enough, so nothing is left balanced on a body that still moves
+		if (world->sleepSteps && world->solver->bodyCount == world->count)
+		{
+			for (i = 0; i < world->count; ++i)
+				world->islandRest[i] = ~0u;
+			for (i = 0, body = world->body; i < world->count; ++i, ++body)
+				if (a3demo_rigidWorldAwake(body))
+				{
+					root = (unsigned int)a3demo_getContactIslandRoot(world->solver, i);
+					world->islandRest[root] = a3minimum(world->islandRest[root], body->restSteps);
+				}
+			for (i = 0, body = world->body; i < world->count; ++i, ++body)
+				if (a3demo_rigidWorldAwake(body) && world->islandRest[a3demo_getContactIslandRoot(world->solver, i)] >= world->sleepSteps)
+				{
+					body->asleep = 1;
+					body->velocity[0] = body->velocity[1] = body->velocity[2] = a3realZero;
+					body->angularVelocity[0] = body->angularVelocity[1] = body->angularVelocity[2] = a3realZero;
+					--world->awakeCount;
+				}
+		}
+		return world->awakeCount;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRigidWorld.h
+	Rigid body world: collision detection, contact solve, integration.
+*/
+
+#ifndef __ANIMAL3D_DEMORIGIDWORLD_H
+#define __ANIMAL3D_DEMORIGIDWORLD_H
+
+
+#include "a3_DemoContactSolver.h"
+#include "a3_DemoBroadphase.h"
+#include "a3_DemoContinuous.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoRigidWorldGJKEntry	a3_DemoRigidWorldGJKEntry;
+	typedef struct a3_DemoRigidWorld		a3_DemoRigidWorld;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// GJK state kept for one candidate pair
+	struct a3_DemoRigidWorldGJKEntry
+	{
+		unsigned int a, b;				// body indices; a is ~0 for an empty slot
+		a3_DemoGJKCache gjk;
+	};
+
+	// rigid body world
+	// planes are unbounded, so they stay out of the broadphase and are
+	//	tested against every other body's bounding sphere directly
+	// a contact island whose bodies have all stayed below the sleep speeds
+	//	for the set number of steps falls asleep as a whole; sleeping bodies
+	//	get no gravity, integration, proxy updates or narrowphase, and a
+	//	world with nothing awake skips the step entirely; touching an awake
+	//	body wakes a sleeper in the same step
+	// a body whose points could move further in one step than the sweep
+	//	threshold times its bounding radius is swept instead: its
+	//	broadphase sphere grows to cover the step, and it stops at its
+	//	first impact (by conservative advancement against planes and
+	//	slower bodies, by swept bounding spheres against other fast ones)
+	//	so the next step's contacts catch it rather than letting it pass
+	//	through
+	struct a3_DemoRigidWorld
+	{
+		a3_DemoJobSystem *jobs;			// scheduler for narrowphase and islands
+
+		// bodies (heap)
+		a3_DemoRigidBody *body;
+		unsigned int count, capacity;
+		unsigned int awakeCount;		// dynamic bodies not asleep
+		a3real3 gravity;
+
+		// sleep settings; zero steps never sleeps
+		unsigned int sleepSteps;
+		a3real sleepSpeed;				// linear, units per second
+		a3real sleepAngularSpeed;		// radians per second
+
+		// continuous collision; zero sweeps every moving body, negative
+		//	turns sweeping off
+		a3real sweepThreshold;			// motion per step, in bounding radii
+		a3real *sweepTime;				// per body: fraction of the step it may move
+		a3_DemoImpactEvent *impact;		// impacts in the last step, earliest first
+		unsigned int impactCount, impactCapacity;
+
+		// broadphase proxies: bounding spheres of the non-plane bodies
+		a3_DemoBodyStore proxy[1];
+		unsigned int *proxyBody;		// body index per proxy
+		unsigned int *plane;			// indices of plane bodies
+		unsigned int planeCount;
+		unsigned int *islandRest;		// per body: fewest rest steps in its island
+		a3_DemoBroadphase broadphase[1];
+
+		// candidate pairs (body indices) and one manifold slot per pair,
+		//	compacted down to the touching ones
+		a3_DemoBodyPair *pair;
+		a3_DemoContactManifold *manifold;
+		unsigned int pairCount, manifoldCount, pairCapacity;
+
+		// GJK state, one per candidate pair that goes to GJK, whether or
+		//	not it touched; open addressing, power-of-two size, rebuilt
+		//	after every narrowphase
+		a3_DemoRigidWorldGJKEntry *gjkCache;
+		unsigned int gjkCacheSize, gjkCacheCount;
+
+		a3_DemoContactSolver solver[1];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup and teardown
+	int a3demo_createRigidWorld(a3_DemoRigidWorld *world, const unsigned int capacity, a3_DemoJobSystem *jobs);
+	int a3demo_releaseRigidWorld(a3_DemoRigidWorld *world);
+
+	// remove all bodies and cached contacts
+	int a3demo_clearRigidWorld(a3_DemoRigidWorld *world);
+
+	// add a body (awake); returns its index or -1 if full
+	int a3demo_addRigidBody(a3_DemoRigidWorld *world, const a3_DemoRigidBody *body);
+
+	// wake a sleeping body, e.g. before pushing it from outside; returns 1
+	//	if it was asleep
+	int a3demo_wakeRigidBody(a3_DemoRigidWorld *world, const unsigned int index);
+
+	// full step: collide, solve, integrate
+	int a3demo_stepRigidWorld(a3_DemoRigidWorld *world, const a3real dt);
+
+	// the step in parts, for timing: gravity and contact generation...
+	int a3demo_collideRigidWorld(a3_DemoRigidWorld *world, const a3real dt);
+
+	// ...contact solve...
+	int a3demo_solveRigidWorld(a3_DemoRigidWorld *world, const a3real dt);
+
+	// ...and position update, then sleep; returns awake count
+	int a3demo_integrateRigidWorld(a3_DemoRigidWorld *world, const a3real dt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMORIGIDWORLD_H
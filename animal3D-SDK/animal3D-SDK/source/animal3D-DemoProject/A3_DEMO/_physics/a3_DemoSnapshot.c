@@ -0,0 +1,188 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSnapshot.c
+	Snapshot ring implementation.
+*/
+
+#include "a3_DemoSnapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// the store's arrays in snapshot order; position, velocity and
+//	acceleration are the first nine arrays of its block
+inline a3real *a3demo_snapshotStoreArray(const a3_DemoBodyStore *store, const unsigned int array)
+{
+	return store->posX + store->capacity * array;
+}
+
+// slot holding the frame so many steps before the newest
+inline unsigned int a3demo_snapshotSlot(const a3_DemoSnapshotRing *ring, const unsigned int back)
+{
+	return (ring->newest + ring->frames - back) % ring->frames;
+}
+
+// size the ring for a body count and point every frame at its data
+inline int a3demo_snapshotLayout(a3_DemoSnapshotRing *ring, const unsigned int count)
+{
+	const unsigned int stride = count * a3demo_snapshotArrays;
+	unsigned int i;
+
+	ring->frames = stride ? a3minimum(ring->maxFrames, ring->memoryCount / stride) : ring->maxFrames;
+	ring->bodyCount = count;
+	ring->newest = 0;
+	ring->size = 0;
+	for (i = 0; i < ring->frames; ++i)
+		ring->frame[i].data = ring->memory + stride * i;
+	return ring->frames;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSnapshotRing(a3_DemoSnapshotRing *ring, const unsigned int maxFrames, const unsigned int maxBytes)
+{
+	if (ring && !ring->frame && maxFrames && maxBytes >= sizeof(a3real))
+	{
+		ring->frame = (a3_DemoSnapshotFrame *)malloc(maxFrames * sizeof(a3_DemoSnapshotFrame));
+		ring->memory = (a3real *)malloc(maxBytes);
+		if (ring->frame && ring->memory)
+		{
+			memset(ring->frame, 0, maxFrames * sizeof(a3_DemoSnapshotFrame));
+			ring->memoryCount = maxBytes / sizeof(a3real);
+			ring->maxFrames = maxFrames;
+			ring->layout = 0;
+			a3demo_snapshotLayout(ring, 0);
+			return maxFrames;
+		}
+		free(ring->frame);
+		free(ring->memory);
+		ring->frame = 0;
+		ring->memory = 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseSnapshotRing(a3_DemoSnapshotRing *ring)
+{
+	if (ring && ring->frame)
+	{
+		free(ring->frame);
+		free(ring->memory);
+		memset(ring, 0, sizeof(a3_DemoSnapshotRing));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_clearSnapshotRing(a3_DemoSnapshotRing *ring)
+{
+	if (ring && ring->frame)
+	{
+		++ring->layout;
+		ring->newest = 0;
+		ring->size = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_captureSnapshot(a3_DemoSnapshotRing *ring, const a3_DemoBodyStore *bodies, const a3_DemoPhysicsClock *clock, const unsigned int pending, const a3_DemoIntegrator *integrator, const a3_DemoRandom *random)
+{
+	if (ring && ring->frame && bodies && bodies->memory && clock && pending <= clock->steps && integrator && random)
+	{
+		a3_DemoSnapshotFrame *frame;
+		const size_t arraySize = bodies->count * sizeof(a3real);
+		unsigned int i;
+
+		// a different body set means a new layout, sized for it
+		if (!ring->size || bodies->count != ring->bodyCount)
+		{
+			if (ring->size)
+				++ring->layout;
+			if (!a3demo_snapshotLayout(ring, bodies->count))
+				return -1;
+		}
+
+		ring->newest = ring->size ? (ring->newest + 1) % ring->frames : 0;
+		ring->size = a3minimum(ring->size + 1, ring->frames);
+
+		frame = ring->frame + ring->newest;
+		frame->version = a3demo_snapshotVersion;
+		frame->layout = ring->layout;
+		frame->step = clock->steps - pending;
+		frame->count = bodies->count;
+		frame->random = *random;
+		frame->accelerationValid = integrator->accelerationValid;
+		frame->totalTime = clock->totalTime - (double)pending * clock->secondsPerStep;
+		frame->droppedTime = clock->droppedTime;
+		for (i = 0; i < a3demo_snapshotArrays; ++i)
+			memcpy(frame->data + bodies->count * i, a3demo_snapshotStoreArray(bodies, i), arraySize);
+		return ring->size;
+	}
+	return -1;
+}
+
+const a3_DemoSnapshotFrame *a3demo_getSnapshotFrame(const a3_DemoSnapshotRing *ring, const unsigned int back)
+{
+	if (ring && ring->frame && back < ring->size)
+		return ring->frame + a3demo_snapshotSlot(ring, back);
+	return 0;
+}
+
+int a3demo_rewindSnapshot(a3_DemoSnapshotRing *ring, const unsigned int back, a3_DemoBodyStore *bodies, a3_DemoPhysicsClock *clock, a3_DemoIntegrator *integrator, a3_DemoRandom *random_out)
+{
+	const a3_DemoSnapshotFrame *frame = a3demo_getSnapshotFrame(ring, back);
+	if (frame && bodies && bodies->memory && clock && integrator &&
+		frame->version == a3demo_snapshotVersion && frame->layout == ring->layout && frame->count == bodies->count)
+	{
+		const size_t arraySize = bodies->count * sizeof(a3real);
+		unsigned int i;
+
+		for (i = 0; i < a3demo_snapshotArrays; ++i)
+			memcpy(a3demo_snapshotStoreArray(bodies, i), frame->data + bodies->count * i, arraySize);
+
+		// the integrator's carried accelerations came back with the bodies
+		integrator->accelerationValid = frame->accelerationValid;
+
+		// time goes back too; whatever real time was waiting to be
+		//	simulated belonged to the future that was just dropped
+		clock->steps = frame->step;
+		clock->totalTime = frame->totalTime;
+		clock->droppedTime = frame->droppedTime;
+		clock->accumulator = 0.0;
+		if (random_out)
+			*random_out = frame->random;
+
+		// the restored frame becomes the newest
+		ring->newest = a3demo_snapshotSlot(ring, back);
+		ring->size -= back;
+		return ring->size;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,129 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSnapshot.h
+	Ring of recent simulation states for stepping backwards and replay.
+*/
+
+#ifndef __ANIMAL3D_DEMOSNAPSHOT_H
+#define __ANIMAL3D_DEMOSNAPSHOT_H
+
+
+#include "a3_DemoBodyStore.h"
+#include "a3_DemoPhysicsClock.h"
+#include "a3_DemoIntegrator.h"
+#include "../_utilities/a3_DemoRandom.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSnapshotFrame	a3_DemoSnapshotFrame;
+	typedef struct a3_DemoSnapshotRing	a3_DemoSnapshotRing;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// snapshot constants
+	enum a3_DemoSnapshotConstants
+	{
+		a3demo_snapshotVersion = 2,		// bump whenever a frame's contents change
+		a3demo_snapshotArrays = 9,		// position, velocity, acceleration
+	};
+
+
+	// one captured step: the header plus the body arrays that change while
+	//	stepping; mass, radius and flags only change with the body set, so
+	//	they belong to the ring's layout instead of to every frame
+	// the ring lives on the heap and survives hotloads, so each frame
+	//	records the revision of the code that wrote it
+	struct a3_DemoSnapshotFrame
+	{
+		unsigned int version;			// a3demo_snapshotVersion when captured
+		unsigned int layout;			// ring layout it was captured in
+		unsigned int step;				// physics clock steps at capture
+		unsigned int count;				// bodies captured
+		unsigned int accelerationValid;	// integrator carry-over
+		a3_DemoRandom random;			// random stream at capture
+		double totalTime, droppedTime;	// physics clock times at capture
+		a3real *data;					// arrays back to back, count each (ring memory)
+	};
+
+
+	// snapshot ring: a fixed budget split into as many frames of the
+	//	current body count as fit (up to the frame limit); the newest
+	//	frame overwrites the oldest, and any frame can be found directly
+	//	from how many steps back it is
+	// adding or removing bodies starts a new layout, which drops the
+	//	history; other changes to the body set (e.g. putting bodies on
+	//	rails) must clear the ring themselves
+	struct a3_DemoSnapshotRing
+	{
+		a3_DemoSnapshotFrame *frame;	// headers (heap)
+		a3real *memory;					// frame data (heap)
+		unsigned int memoryCount;		// reals in frame data
+		unsigned int maxFrames;			// headers allocated
+		unsigned int frames;			// ring length in this layout
+		unsigned int bodyCount;			// bodies per frame in this layout
+		unsigned int layout;			// bumped every time history is dropped
+		unsigned int newest;			// slot of the most recent frame
+		unsigned int size;				// frames held
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// allocate at most the given number of frames within the byte budget
+	int a3demo_createSnapshotRing(a3_DemoSnapshotRing *ring, const unsigned int maxFrames, const unsigned int maxBytes);
+	int a3demo_releaseSnapshotRing(a3_DemoSnapshotRing *ring);
+
+	// drop all frames and start a new layout
+	int a3demo_clearSnapshotRing(a3_DemoSnapshotRing *ring);
+
+	// record the state after a step; the clock hands out a whole update's
+	//	steps at once, so pending is how many of those are still to be
+	//	taken; returns frames held, or -1 if one frame of this many bodies
+	//	does not fit
+	int a3demo_captureSnapshot(a3_DemoSnapshotRing *ring, const a3_DemoBodyStore *bodies, const a3_DemoPhysicsClock *clock, const unsigned int pending, const a3_DemoIntegrator *integrator, const a3_DemoRandom *random);
+
+	// frame the given number of steps before the newest (0 is the newest),
+	//	or null if not held
+	const a3_DemoSnapshotFrame *a3demo_getSnapshotFrame(const a3_DemoSnapshotRing *ring, const unsigned int back);
+
+	// put everything back the way it was that many steps before the newest
+	//	frame and forget the newer ones, so stepping again from there
+	//	replays the same steps bit for bit; returns frames still held, or
+	//	-1 if the frame is not held or does not match the bodies
+	int a3demo_rewindSnapshot(a3_DemoSnapshotRing *ring, const unsigned int back, a3_DemoBodyStore *bodies, a3_DemoPhysicsClock *clock, a3_DemoIntegrator *integrator, a3_DemoRandom *random_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSNAPSHOT_H
@@ -0,0 +1,799 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSoftBody.c
+	XPBD soft body implementation.
+*/
+
+#include "a3_DemoSoftBody.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// one side of a triangle while finding shared edges: the edge's
+//	particles in order, and the corner across from it
+typedef struct a3_DemoSoftEdge
+{
+	unsigned int lo, hi, opposite;
+} a3_DemoSoftEdge;
+
+// what a parallel range needs to know
+typedef struct a3_DemoSoftTask
+{
+	a3_DemoSoftBody *body;
+	a3real dt, invDt;
+	a3real alphaScale;			// one over dt squared, turns compliance into alpha tilde
+	a3real keep;				// velocity kept after damping
+	unsigned int base;			// first constraint of the color being solved
+} a3_DemoSoftTask;
+
+
+inline a3real a3demo_softDot(const a3real *a, const a3real *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+inline void a3demo_softCross(a3real *out, const a3real *a, const a3real *b)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+inline a3real a3demo_softDistance(const a3real *a, const a3real *b)
+{
+	const a3real d[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+	return (a3real)sqrt(a3demo_softDot(d, d));
+}
+
+// index of the n-th vertex the mesh draws
+inline unsigned int a3demo_softMeshIndex(const a3_GeometryData *geom, const unsigned int n)
+{
+	if (geom->indexData)
+		switch (geom->indexFormat->indexSize)
+		{
+		case 1:
+			return ((const unsigned char *)geom->indexData)[n];
+		case 2:
+			return ((const unsigned short *)geom->indexData)[n];
+		case 4:
+			return ((const unsigned int *)geom->indexData)[n];
+		}
+	return n;
+}
+
+// corners of the n-th triangle the mesh draws, in mesh vertices; strips
+//	flip every other triangle so they all wind the same way
+// returns 1 if the mesh has that triangle
+inline int a3demo_softMeshTriangle(unsigned int *corner_out, const a3_GeometryData *geom, const unsigned int n)
+{
+	const unsigned int count = geom->indexData ? geom->numIndices : geom->numVertices;
+	switch (geom->primType)
+	{
+	case a3prim_triangles:
+		if (n * 3 + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_softMeshIndex(geom, n * 3 + 0);
+		corner_out[1] = a3demo_softMeshIndex(geom, n * 3 + 1);
+		corner_out[2] = a3demo_softMeshIndex(geom, n * 3 + 2);
+		return 1;
+	case a3prim_triangleStrip:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_softMeshIndex(geom, n + (n & 1));
+		corner_out[1] = a3demo_softMeshIndex(geom, n + 1 - (n & 1));
+		corner_out[2] = a3demo_softMeshIndex(geom, n + 2);
+		return 1;
+	case a3prim_triangleFan:
+		if (n + 2 >= count)
+			return 0;
+		corner_out[0] = a3demo_softMeshIndex(geom, 0);
+		corner_out[1] = a3demo_softMeshIndex(geom, n + 1);
+		corner_out[2] = a3demo_softMeshIndex(geom, n + 2);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+// particle per mesh vertex: vertices on the same spot share one, so UV
+//	seams and poles hold together; positions are snapped to a grid much
+//	finer than the mesh and hashed
+// returns particle count; their positions are written in order of first use
+inline unsigned int a3demo_softWeld(unsigned int *particle_out, a3real *position_out, const float *vertex, const unsigned int count)
+{
+	unsigned int tableSize = 64, mask, slot, i, j, particles = 0;
+	unsigned int *table;
+	int *key;
+	a3real extent = a3realZero, cell;
+
+	while (tableSize < count * 2)
+		tableSize <<= 1;
+	mask = tableSize - 1;
+	table = (unsigned int *)malloc(tableSize * sizeof(unsigned int) + count * 3 * sizeof(int));
+	key = (int *)(table + tableSize);
+	memset(table, 0xff, tableSize * sizeof(unsigned int));
+
+	for (i = 0; i < count * 3; ++i)
+		extent = a3maximum(extent, (a3real)fabs(vertex[i]));
+	cell = extent > a3realZero ? extent * 1.0e-5f : a3realOne;
+
+	for (i = 0; i < count; ++i)
+	{
+		int *const k = key + i * 3;
+		k[0] = (int)floor(vertex[i * 3 + 0] / cell + 0.5f);
+		k[1] = (int)floor(vertex[i * 3 + 1] / cell + 0.5f);
+		k[2] = (int)floor(vertex[i * 3 + 2] / cell + 0.5f);
+		slot = ((unsigned int)k[0] * 73856093u ^ (unsigned int)k[1] * 19349663u ^ (unsigned int)k[2] * 83492791u) & mask;
+		for (;;)
+		{
+			j = table[slot];
+			if (j == 0xffffffff)
+			{
+				// first vertex here
+				table[slot] = i;
+				particle_out[i] = particles;
+				position_out[particles * 3 + 0] = vertex[i * 3 + 0];
+				position_out[particles * 3 + 1] = vertex[i * 3 + 1];
+				position_out[particles * 3 + 2] = vertex[i * 3 + 2];
+				++particles;
+				break;
+			}
+			if (key[j * 3 + 0] == k[0] && key[j * 3 + 1] == k[1] && key[j * 3 + 2] == k[2])
+			{
+				particle_out[i] = particle_out[j];
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+	}
+
+	free(table);
+	return particles;
+}
+
+int a3demo_softCompareEdge(const void *a, const void *b)
+{
+	const a3_DemoSoftEdge *const ea = (const a3_DemoSoftEdge *)a, *const eb = (const a3_DemoSoftEdge *)b;
+	if (ea->lo != eb->lo)
+		return ea->lo < eb->lo ? -1 : +1;
+	if (ea->hi != eb->hi)
+		return ea->hi < eb->hi ? -1 : +1;
+	return ea->opposite < eb->opposite ? -1 : ea->opposite > eb->opposite;
+}
+
+// allocate particle arrays and set defaults
+inline int a3demo_softAllocate(a3_DemoSoftBody *body, const unsigned int particleCount)
+{
+	const unsigned int n = particleCount;
+	memset(body, 0, sizeof(a3_DemoSoftBody));
+	body->memory = malloc(n * 17 * sizeof(a3real));
+	if (!body->memory)
+		return 0;
+	memset(body->memory, 0, n * 17 * sizeof(a3real));
+	body->position = (a3real *)body->memory;
+	body->previous = body->position + n * 3;
+	body->velocity = body->previous + n * 3;
+	body->rest = body->velocity + n * 3;
+	body->gradient = body->rest + n * 3;
+	body->inverseMass = body->gradient + n * 3;
+	body->mass = body->inverseMass + n;
+	body->particleCount = n;
+
+	body->volumeSign = a3realOne;
+	body->pressure = a3realOne;
+	body->gravity[2] = -9.81f;
+	body->damping = 0.1f;
+	body->substeps = 8;
+	body->iterations = 1;
+	return 1;
+}
+
+// add a two-particle constraint at its current length
+inline void a3demo_softAddConstraint(a3_DemoSoftBody *body, const unsigned int a, const unsigned int b, const a3_DemoSoftConstraintType type)
+{
+	a3_DemoSoftConstraint *const c = body->constraint + body->constraintCount++;
+	c->a = a;
+	c->b = b;
+	c->rest = a3demo_softDistance(body->position + a * 3, body->position + b * 3);
+	c->lambda = a3realZero;
+	c->type = type;
+}
+
+// greedy coloring: each constraint takes the lowest color neither of its
+//	particles has yet; then a counting sort groups them, keeping build
+//	order within each color so neighbours stay near each other in memory
+inline int a3demo_softColor(a3_DemoSoftBody *body)
+{
+	const unsigned int serial = a3demo_softMaxColors;
+	unsigned int *used = (unsigned int *)malloc(body->particleCount * sizeof(unsigned int) + body->constraintCount * sizeof(unsigned char));
+	unsigned char *color = (unsigned char *)(used + body->particleCount);
+	a3_DemoSoftConstraint *sorted = (a3_DemoSoftConstraint *)malloc(body->constraintCount * sizeof(a3_DemoSoftConstraint));
+	unsigned int count[a3demo_softMaxColors + 1] = { 0 };
+	unsigned int i, c, available;
+
+	if (!used || !sorted)
+	{
+		free(used);
+		free(sorted);
+		return 0;
+	}
+	memset(used, 0, body->particleCount * sizeof(unsigned int));
+
+	body->colorCount = 0;
+	for (i = 0; i < body->constraintCount; ++i)
+	{
+		const a3_DemoSoftConstraint *const k = body->constraint + i;
+		available = ~(used[k->a] | used[k->b]);
+		if (available)
+		{
+			for (c = 0; !(available & (1u << c)); ++c);
+			used[k->a] |= 1u << c;
+			used[k->b] |= 1u << c;
+			body->colorCount = a3maximum(body->colorCount, c + 1);
+		}
+		else
+			c = serial;
+		color[i] = (unsigned char)c;
+		++count[c];
+	}
+
+	// colors first, leftovers last
+	body->colorStart[0] = 0;
+	for (c = 0; c < body->colorCount; ++c)
+		body->colorStart[c + 1] = body->colorStart[c] + count[c];
+	body->serialStart = body->colorStart[body->colorCount];
+	for (c = 0; c < body->colorCount; ++c)
+		count[c] = body->colorStart[c];
+	count[serial] = body->serialStart;
+	for (i = 0; i < body->constraintCount; ++i)
+		sorted[count[color[i]]++] = body->constraint[i];
+
+	free(body->constraint);
+	body->constraint = sorted;
+	free(used);
+	return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// parallel ranges
+
+// gravity, then move to the predicted position
+void a3demo_softPredict(a3_DemoSoftTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoSoftBody *const body = task->body;
+	const a3real dt = task->dt;
+	a3real *x = body->position + first * 3, *p = body->previous + first * 3, *v = body->velocity + first * 3;
+	const a3real *w = body->inverseMass + first, *const end = w + count;
+
+	for (; w < end; ++w, x += 3, p += 3, v += 3)
+	{
+		p[0] = x[0];
+		p[1] = x[1];
+		p[2] = x[2];
+		if (*w > a3realZero)
+		{
+			v[0] += body->gravity[0] * dt;
+			v[1] += body->gravity[1] * dt;
+			v[2] += body->gravity[2] * dt;
+			x[0] += v[0] * dt;
+			x[1] += v[1] * dt;
+			x[2] += v[2] * dt;
+		}
+	}
+}
+
+// XPBD update of two-particle constraints; within a color no two share a
+//	particle, so ranges never touch the same positions
+void a3demo_softSolveRange(a3_DemoSoftTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoSoftBody *const body = task->body;
+	a3real *const position = body->position;
+	const a3real *const inverseMass = body->inverseMass;
+	a3_DemoSoftConstraint *k = body->constraint + task->base + first, *const end = k + count;
+	a3real alpha[a3demo_softConstraint_count];
+	a3real d[3], length, w, dLambda, s;
+	a3real *xa, *xb;
+	unsigned int i;
+
+	for (i = 0; i < a3demo_softConstraint_count; ++i)
+		alpha[i] = body->compliance[i] * task->alphaScale;
+
+	for (; k < end; ++k)
+	{
+		const a3real wa = inverseMass[k->a], wb = inverseMass[k->b];
+		w = wa + wb;
+		if (w <= a3realZero)
+			continue;
+		xa = position + k->a * 3;
+		xb = position + k->b * 3;
+		d[0] = xb[0] - xa[0];
+		d[1] = xb[1] - xa[1];
+		d[2] = xb[2] - xa[2];
+		length = (a3real)sqrt(a3demo_softDot(d, d));
+		if (length <= a3realZero)
+			continue;
+
+		// C = length - rest, gradient is the unit direction (negated for a)
+		dLambda = (k->rest - length - alpha[k->type] * k->lambda) / (w + alpha[k->type]);
+		k->lambda += dLambda;
+		s = dLambda / length;
+		xa[0] -= wa * s * d[0];
+		xa[1] -= wa * s * d[1];
+		xa[2] -= wa * s * d[2];
+		xb[0] += wb * s * d[0];
+		xb[1] += wb * s * d[1];
+		xb[2] += wb * s * d[2];
+	}
+}
+
+// keep out of the ground, then velocity from the distance moved
+void a3demo_softFinish(a3_DemoSoftTask *task, const unsigned int first, const unsigned int count)
+{
+	a3_DemoSoftBody *const body = task->body;
+	const a3real *const ground = body->ground;
+	const int hasGround = a3demo_softDot(ground, ground) > a3realZero;
+	a3real *x = body->position + first * 3, *v = body->velocity + first * 3;
+	const a3real *p = body->previous + first * 3;
+	const a3real *w = body->inverseMass + first, *const end = w + count;
+	a3real depth;
+
+	for (; w < end; ++w, x += 3, p += 3, v += 3)
+	{
+		if (*w <= a3realZero)
+		{
+			v[0] = v[1] = v[2] = a3realZero;
+			continue;
+		}
+		if (hasGround)
+		{
+			depth = ground[3] - a3demo_softDot(ground, x);
+			if (depth > a3realZero)
+			{
+				x[0] += ground[0] * depth;
+				x[1] += ground[1] * depth;
+				x[2] += ground[2] * depth;
+			}
+		}
+		v[0] = (x[0] - p[0]) * task->invDt * task->keep;
+		v[1] = (x[1] - p[1]) * task->invDt * task->keep;
+		v[2] = (x[2] - p[2]) * task->invDt * task->keep;
+	}
+}
+
+// enclosed volume and, optionally, its gradient per particle
+inline a3real a3demo_softVolume(const a3_DemoSoftBody *body, a3real *gradient_opt)
+{
+	const a3real *const x = body->position;
+	const unsigned int *t = body->triangle, *const end = t + body->triangleCount * 3;
+	const a3real sixth = body->volumeSign / 6.0f;
+	a3real volume = a3realZero, c[3];
+	unsigned int i;
+
+	if (gradient_opt)
+		memset(gradient_opt, 0, body->particleCount * 3 * sizeof(a3real));
+	for (; t < end; t += 3)
+	{
+		const a3real *const x0 = x + t[0] * 3, *const x1 = x + t[1] * 3, *const x2 = x + t[2] * 3;
+		a3demo_softCross(c, x1, x2);
+		volume += a3demo_softDot(x0, c);
+		if (gradient_opt)
+		{
+			a3real *g = gradient_opt + t[0] * 3;
+			g[0] += c[0];
+			g[1] += c[1];
+			g[2] += c[2];
+			a3demo_softCross(c, x2, x0);
+			g = gradient_opt + t[1] * 3;
+			g[0] += c[0];
+			g[1] += c[1];
+			g[2] += c[2];
+			a3demo_softCross(c, x0, x1);
+			g = gradient_opt + t[2] * 3;
+			g[0] += c[0];
+			g[1] += c[1];
+			g[2] += c[2];
+		}
+	}
+	if (gradient_opt)
+		for (i = 0; i < body->particleCount * 3; ++i)
+			gradient_opt[i] *= sixth;
+	return volume * sixth;
+}
+
+// the whole surface at once, so it stays serial
+inline void a3demo_softSolveVolume(a3_DemoSoftBody *body, const a3real alphaScale)
+{
+	const a3real alpha = body->volumeCompliance * alphaScale;
+	const a3real *g = body->gradient;
+	a3real *x = body->position;
+	a3real w = a3realZero, c, dLambda, s;
+	unsigned int i;
+
+	body->volume = a3demo_softVolume(body, body->gradient);
+	c = body->volume - body->pressure * body->restVolume;
+	for (i = 0; i < body->particleCount; ++i)
+		w += body->inverseMass[i] * a3demo_softDot(g + i * 3, g + i * 3);
+	if (w + alpha <= a3realZero)
+		return;
+
+	dLambda = (-c - alpha * body->volumeLambda) / (w + alpha);
+	body->volumeLambda += dLambda;
+	for (i = 0; i < body->particleCount; ++i, x += 3, g += 3)
+	{
+		s = body->inverseMass[i] * dLambda;
+		x[0] += s * g[0];
+		x[1] += s * g[1];
+		x[2] += s * g[2];
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSoftBody(a3_DemoSoftBody *body_out, const a3_GeometryData *geom, const a3real mass, const a3real distanceCompliance, const a3real bendingCompliance, const a3real volumeCompliance, a3_DemoJobSystem *jobs)
+{
+	if (body_out && !body_out->memory && geom && geom->attribData[a3attrib_geomPosition] && geom->numVertices && mass > a3realZero)
+	{
+		const float *const vertex = (const float *)geom->attribData[a3attrib_geomPosition];
+		unsigned int *particle = (unsigned int *)malloc(geom->numVertices * sizeof(unsigned int));
+		a3real *welded = (a3real *)malloc(geom->numVertices * 3 * sizeof(a3real));
+		a3_DemoSoftEdge *edge = 0;
+		unsigned int corner[3], n, i, j, run, edgeCount, particleCount, triangleCount = 0, open = 0;
+		a3real area, totalArea = a3realZero, e0[3], e1[3], c[3];
+
+		if (!particle || !welded)
+		{
+			free(particle);
+			free(welded);
+			return -1;
+		}
+
+		// particles
+		particleCount = a3demo_softWeld(particle, welded, vertex, geom->numVertices);
+		if (!a3demo_softAllocate(body_out, particleCount))
+		{
+			free(particle);
+			free(welded);
+			return -1;
+		}
+		memcpy(body_out->position, welded, particleCount * 3 * sizeof(a3real));
+		free(welded);
+
+		// triangles, minus any that welding (or the mesh) collapsed
+		for (n = 0; a3demo_softMeshTriangle(corner, geom, n); ++n);
+		body_out->triangle = (unsigned int *)malloc((n ? n : 1) * 3 * sizeof(unsigned int));
+		if (!body_out->triangle)
+		{
+			free(particle);
+			a3demo_releaseSoftBody(body_out);
+			return -1;
+		}
+		for (n = 0; a3demo_softMeshTriangle(corner, geom, n); ++n)
+		{
+			unsigned int *const t = body_out->triangle + triangleCount * 3;
+			if (corner[0] >= geom->numVertices || corner[1] >= geom->numVertices || corner[2] >= geom->numVertices)
+				continue;
+			t[0] = particle[corner[0]];
+			t[1] = particle[corner[1]];
+			t[2] = particle[corner[2]];
+			if (t[0] != t[1] && t[1] != t[2] && t[2] != t[0])
+				++triangleCount;
+		}
+		body_out->triangleCount = triangleCount;
+		free(particle);
+		if (!triangleCount)
+		{
+			a3demo_releaseSoftBody(body_out);
+			return 0;
+		}
+
+		// mass by area around each particle; a third of each triangle
+		for (n = 0; n < triangleCount; ++n)
+		{
+			const unsigned int *const t = body_out->triangle + n * 3;
+			const a3real *const x0 = body_out->position + t[0] * 3;
+			for (i = 0; i < 3; ++i)
+			{
+				e0[i] = body_out->position[t[1] * 3 + i] - x0[i];
+				e1[i] = body_out->position[t[2] * 3 + i] - x0[i];
+			}
+			a3demo_softCross(c, e0, e1);
+			area = (a3real)sqrt(a3demo_softDot(c, c)) * a3realHalf;
+			totalArea += area;
+			for (i = 0; i < 3; ++i)
+				body_out->mass[t[i]] += area;
+		}
+		for (i = 0; i < particleCount; ++i)
+		{
+			body_out->mass[i] = totalArea > a3realZero ? body_out->mass[i] * mass / (totalArea * 3.0f) : mass / (a3real)particleCount;
+			if (body_out->mass[i] <= a3realZero)
+				body_out->mass[i] = mass / (a3real)particleCount;
+		}
+
+		// edges: every side of every triangle, sorted so shared sides line up
+		edgeCount = triangleCount * 3;
+		edge = (a3_DemoSoftEdge *)malloc(edgeCount * sizeof(a3_DemoSoftEdge));
+		body_out->constraint = (a3_DemoSoftConstraint *)malloc(edgeCount * 2 * sizeof(a3_DemoSoftConstraint));
+		if (!edge || !body_out->constraint)
+		{
+			free(edge);
+			a3demo_releaseSoftBody(body_out);
+			return -1;
+		}
+		for (n = 0; n < triangleCount; ++n)
+			for (i = 0; i < 3; ++i)
+			{
+				const unsigned int a = body_out->triangle[n * 3 + i], b = body_out->triangle[n * 3 + (i + 1) % 3];
+				a3_DemoSoftEdge *const e = edge + n * 3 + i;
+				e->lo = a3minimum(a, b);
+				e->hi = a3maximum(a, b);
+				e->opposite = body_out->triangle[n * 3 + (i + 2) % 3];
+			}
+		qsort(edge, edgeCount, sizeof(a3_DemoSoftEdge), a3demo_softCompareEdge);
+
+		// distance constraints first, then bending, so greedy coloring
+		//	packs the stiff ones into the early colors
+		for (i = 0; i < edgeCount; i = j)
+		{
+			for (j = i + 1; j < edgeCount && edge[j].lo == edge[i].lo && edge[j].hi == edge[i].hi; ++j);
+			a3demo_softAddConstraint(body_out, edge[i].lo, edge[i].hi, a3demo_softConstraint_distance);
+			if (j - i != 2)
+				open = 1;
+		}
+		for (i = 0; i < edgeCount; i = j)
+		{
+			for (j = i + 1; j < edgeCount && edge[j].lo == edge[i].lo && edge[j].hi == edge[i].hi; ++j);
+			run = j - i;
+			if (run == 2 && edge[i].opposite != edge[i + 1].opposite)
+				a3demo_softAddConstraint(body_out, edge[i].opposite, edge[i + 1].opposite, a3demo_softConstraint_bending);
+		}
+		free(edge);
+
+		body_out->compliance[a3demo_softConstraint_distance] = distanceCompliance;
+		body_out->compliance[a3demo_softConstraint_bending] = bendingCompliance;
+		body_out->volumeCompliance = volumeCompliance;
+		body_out->jobs = jobs;
+
+		// a closed surface keeps its volume, whichever way it winds
+		body_out->closed = !open;
+		if (body_out->closed)
+		{
+			body_out->restVolume = a3demo_softVolume(body_out, 0);
+			if (body_out->restVolume < a3realZero)
+			{
+				body_out->volumeSign = -a3realOne;
+				body_out->restVolume = -body_out->restVolume;
+			}
+		}
+
+		if (!a3demo_softColor(body_out))
+		{
+			a3demo_releaseSoftBody(body_out);
+			return -1;
+		}
+		memcpy(body_out->rest, body_out->position, particleCount * 3 * sizeof(a3real));
+		a3demo_resetSoftBody(body_out);
+		return particleCount;
+	}
+	return -1;
+}
+
+int a3demo_releaseSoftBody(a3_DemoSoftBody *body)
+{
+	if (body && body->memory)
+	{
+		free(body->memory);
+		free(body->triangle);
+		free(body->constraint);
+		memset(body, 0, sizeof(a3_DemoSoftBody));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_createSoftRope(a3_DemoSoftBody *body_out, const a3real *start, const a3real *end, const unsigned int segments, const a3real mass, const a3real distanceCompliance, const a3real bendingCompliance, a3_DemoJobSystem *jobs)
+{
+	if (body_out && !body_out->memory && start && end && segments && mass > a3realZero)
+	{
+		const unsigned int particleCount = segments + 1;
+		a3real u;
+		unsigned int i;
+
+		if (!a3demo_softAllocate(body_out, particleCount))
+			return -1;
+		body_out->constraint = (a3_DemoSoftConstraint *)malloc(segments * 2 * sizeof(a3_DemoSoftConstraint));
+		if (!body_out->constraint)
+		{
+			a3demo_releaseSoftBody(body_out);
+			return -1;
+		}
+
+		for (i = 0; i < particleCount; ++i)
+		{
+			u = (a3real)i / (a3real)segments;
+			body_out->position[i * 3 + 0] = start[0] + (end[0] - start[0]) * u;
+			body_out->position[i * 3 + 1] = start[1] + (end[1] - start[1]) * u;
+			body_out->position[i * 3 + 2] = start[2] + (end[2] - start[2]) * u;
+			body_out->mass[i] = mass / (a3real)particleCount;
+		}
+		for (i = 0; i < segments; ++i)
+			a3demo_softAddConstraint(body_out, i, i + 1, a3demo_softConstraint_distance);
+		for (i = 0; i + 2 < particleCount; ++i)
+			a3demo_softAddConstraint(body_out, i, i + 2, a3demo_softConstraint_bending);
+
+		body_out->compliance[a3demo_softConstraint_distance] = distanceCompliance;
+		body_out->compliance[a3demo_softConstraint_bending] = bendingCompliance;
+		body_out->jobs = jobs;
+
+		if (!a3demo_softColor(body_out))
+		{
+			a3demo_releaseSoftBody(body_out);
+			return -1;
+		}
+		memcpy(body_out->rest, body_out->position, particleCount * 3 * sizeof(a3real));
+		a3demo_resetSoftBody(body_out);
+		return particleCount;
+	}
+	return -1;
+}
+
+int a3demo_translateSoftBody(a3_DemoSoftBody *body, const a3real *offset)
+{
+	if (body && body->memory && offset)
+	{
+		unsigned int i;
+		for (i = 0; i < body->particleCount * 3; ++i)
+		{
+			body->position[i] += offset[i % 3];
+			body->previous[i] += offset[i % 3];
+			body->rest[i] += offset[i % 3];
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_resetSoftBody(a3_DemoSoftBody *body)
+{
+	if (body && body->memory)
+	{
+		unsigned int i;
+		memcpy(body->position, body->rest, body->particleCount * 3 * sizeof(a3real));
+		memcpy(body->previous, body->rest, body->particleCount * 3 * sizeof(a3real));
+		memset(body->velocity, 0, body->particleCount * 3 * sizeof(a3real));
+		for (i = 0; i < body->particleCount; ++i)
+			body->inverseMass[i] = a3recip(body->mass[i]);
+		for (i = 0; i < body->constraintCount; ++i)
+			body->constraint[i].lambda = a3realZero;
+		body->volumeLambda = a3realZero;
+		body->volume = body->restVolume;
+		body->maxStrain = a3realZero;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_pinSoftBodyNearest(a3_DemoSoftBody *body, const a3real *point, const int pinned)
+{
+	if (body && body->memory && point)
+	{
+		a3real d, best = a3demo_softDistance(body->position, point);
+		unsigned int i, nearest = 0;
+		for (i = 1; i < body->particleCount; ++i)
+		{
+			d = a3demo_softDistance(body->position + i * 3, point);
+			if (d < best)
+			{
+				best = d;
+				nearest = i;
+			}
+		}
+		body->inverseMass[nearest] = pinned ? a3realZero : a3recip(body->mass[nearest]);
+		return nearest;
+	}
+	return -1;
+}
+
+int a3demo_stepSoftBody(a3_DemoSoftBody *body, const a3real dt)
+{
+	if (body && body->memory && dt > a3realZero)
+	{
+		a3_DemoSoftTask task[1];
+		unsigned int substep, iteration, color, i;
+		a3real strain;
+
+		task->body = body;
+		task->dt = dt / (a3real)a3maximum(body->substeps, 1);
+		task->invDt = a3recip(task->dt);
+		task->alphaScale = task->invDt * task->invDt;
+		task->keep = a3maximum(a3realOne - body->damping * task->dt, a3realZero);
+
+		// small steps with one pass each converge better than big steps with
+		//	many passes, so substeps are the main quality setting
+		for (substep = 0; substep < a3maximum(body->substeps, 1); ++substep)
+		{
+			a3demo_parallelFor(body->jobs, (a3_DemoJobFunc)a3demo_softPredict, task, body->particleCount, a3demo_softGrain);
+			for (i = 0; i < body->constraintCount; ++i)
+				body->constraint[i].lambda = a3realZero;
+			body->volumeLambda = a3realZero;
+
+			for (iteration = 0; iteration < a3maximum(body->iterations, 1); ++iteration)
+			{
+				for (color = 0; color < body->colorCount; ++color)
+				{
+					task->base = body->colorStart[color];
+					a3demo_parallelFor(body->jobs, (a3_DemoJobFunc)a3demo_softSolveRange, task,
+						body->colorStart[color + 1] - body->colorStart[color], a3demo_softGrain);
+				}
+				task->base = body->serialStart;
+				a3demo_softSolveRange(task, 0, body->constraintCount - body->serialStart);
+				if (body->closed)
+					a3demo_softSolveVolume(body, task->alphaScale);
+			}
+
+			a3demo_parallelFor(body->jobs, (a3_DemoJobFunc)a3demo_softFinish, task, body->particleCount, a3demo_softGrain);
+		}
+
+		// how far the cloth gave
+		body->maxStrain = a3realZero;
+		for (i = 0; i < body->constraintCount; ++i)
+			if (body->constraint[i].type == a3demo_softConstraint_distance && body->constraint[i].rest > a3realZero)
+			{
+				strain = a3demo_softDistance(body->position + body->constraint[i].a * 3, body->position + body->constraint[i].b * 3);
+				strain = (strain - body->constraint[i].rest) / body->constraint[i].rest;
+				body->maxStrain = a3maximum(body->maxStrain, strain);
+			}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_getSoftBodyEdges(const a3_DemoSoftBody *body, unsigned int *index_out, const unsigned int base)
+{
+	if (body && body->memory && index_out)
+	{
+		unsigned int i, count = 0;
+		for (i = 0; i < body->constraintCount; ++i)
+			if (body->constraint[i].type == a3demo_softConstraint_distance)
+			{
+				index_out[count++] = body->constraint[i].a + base;
+				index_out[count++] = body->constraint[i].b + base;
+			}
+		return count;
+	}
+	return -1;
+}
+
+a3real a3demo_getSoftBodyVolume(const a3_DemoSoftBody *body)
+{
+	if (body && body->memory && body->triangleCount)
+		return a3demo_softVolume(body, 0);
+	return a3realZero;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSoftBody.h
+	Deformable bodies (cloth, ropes, soft volumes) built from geometry data
+		and solved with extended position-based dynamics (XPBD).
+*/
+
+#ifndef __ANIMAL3D_DEMOSOFTBODY_H
+#define __ANIMAL3D_DEMOSOFTBODY_H
+
+
+#include "animal3D/a3math/A3DM.h"
+#include "animal3D/a3graphics/a3geometry/a3_GeometryData.h"
+#include "../_utilities/a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSoftConstraint	a3_DemoSoftConstraint;
+	typedef struct a3_DemoSoftBody			a3_DemoSoftBody;
+	typedef enum a3_DemoSoftConstraintType	a3_DemoSoftConstraintType;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// soft body constants
+	enum a3_DemoSoftBodyConstants
+	{
+		a3demo_softMaxColors = 32,		// independent batches; anything left over is solved serially
+		a3demo_softGrain = 256,			// constraints or particles per parallel range
+	};
+
+
+	// constraint kinds; all of them join two particles
+	//	distance:	keeps a mesh edge at its rest length
+	//	bending:	keeps the two corners across a shared edge at their rest
+	//				distance, which resists folding about that edge; cheap,
+	//				and it colors along with everything else
+	enum a3_DemoSoftConstraintType
+	{
+		a3demo_softConstraint_distance,
+		a3demo_softConstraint_bending,
+
+		a3demo_softConstraint_count
+	};
+
+
+	// two-particle constraint; lambda is its accumulated XPBD multiplier,
+	//	reset every substep
+	struct a3_DemoSoftConstraint
+	{
+		unsigned int a, b;
+		a3real rest;
+		a3real lambda;
+		a3_DemoSoftConstraintType type;
+	};
+
+
+	// soft body: one particle per distinct vertex position of the mesh it
+	//	was built from (seams and poles are welded), moved by constraints
+	//	instead of forces
+	// positions are packed xyz, so they go straight into a vertex buffer
+	//	of vec3 positions each frame
+	// constraints are grouped by color: no two in a color share a particle,
+	//	so each color is solved in parallel with Gauss-Seidel updates, and
+	//	colors run one after another
+	// closed meshes also get one volume constraint over the whole surface,
+	//	solved after the colors; pressure scales its rest volume
+	struct a3_DemoSoftBody
+	{
+		// particles (single allocation)
+		void *memory;
+		a3real *position;				// current (xyz)
+		a3real *previous;				// at the start of the substep (xyz)
+		a3real *velocity;				// (xyz)
+		a3real *rest;					// as built, for resets (xyz)
+		a3real *gradient;				// volume gradient workspace (xyz)
+		a3real *inverseMass;			// zero pins a particle
+		a3real *mass;					// kept so pins can be undone
+		unsigned int particleCount;
+
+		// surface triangles by particle (3 each), wound as in the mesh
+		unsigned int *triangle;
+		unsigned int triangleCount;
+
+		// constraints sorted by color, and where each color starts; the
+		//	last color may be the serial leftovers
+		a3_DemoSoftConstraint *constraint;
+		unsigned int constraintCount;
+		unsigned int colorStart[a3demo_softMaxColors + 2];
+		unsigned int colorCount;
+		unsigned int serialStart;		// first constraint that could not be colored
+
+		// volume
+		int closed;						// every edge shared by exactly two triangles
+		a3real restVolume;				// enclosed volume as built
+		a3real volumeSign;				// -1 if the mesh winds inward
+		a3real volumeLambda;
+		a3real pressure;				// target volume over rest volume
+
+		// compliance (inverse stiffness) per constraint type and volume;
+		//	zero is rigid
+		a3real compliance[a3demo_softConstraint_count];
+		a3real volumeCompliance;
+
+		// settings
+		a3real gravity[3];
+		a3real ground[4];				// half-space particles stay out of: normal xyz, offset
+		a3real damping;					// fraction of velocity lost per second
+		unsigned int substeps;			// per step call
+		unsigned int iterations;		// per substep
+		a3_DemoJobSystem *jobs;			// null is serial
+
+		// stats from the last step
+		a3real volume;					// current enclosed volume
+		a3real maxStrain;				// largest relative stretch of a distance constraint
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// build from geometry data (positions, with or without indexing, as
+	//	triangles, strips or fans): welds coincident vertices, spreads the
+	//	mass by surface area, and makes a distance constraint per edge and
+	//	a bending constraint per interior edge; a volume constraint is
+	//	added if the surface is closed
+	//	-> returns particle count, 0 if there are no triangles, -1 if
+	//		invalid params
+	int a3demo_createSoftBody(a3_DemoSoftBody *body_out, const a3_GeometryData *geom, const a3real mass, const a3real distanceCompliance, const a3real bendingCompliance, const a3real volumeCompliance, a3_DemoJobSystem *jobs);
+	int a3demo_releaseSoftBody(a3_DemoSoftBody *body);
+
+	// build a rope: a line of particles from start to end joined by
+	//	distance constraints, with bending constraints skipping one
+	int a3demo_createSoftRope(a3_DemoSoftBody *body_out, const a3real *start, const a3real *end, const unsigned int segments, const a3real mass, const a3real distanceCompliance, const a3real bendingCompliance, a3_DemoJobSystem *jobs);
+
+	// move every particle by an offset (also moves the rest state)
+	int a3demo_translateSoftBody(a3_DemoSoftBody *body, const a3real *offset);
+
+	// back to the built shape, at rest, with nothing pinned
+	int a3demo_resetSoftBody(a3_DemoSoftBody *body);
+
+	// pin or release the particle nearest a point; returns its index
+	int a3demo_pinSoftBodyNearest(a3_DemoSoftBody *body, const a3real *point, const int pinned);
+
+	// advance by dt in the body's substeps
+	int a3demo_stepSoftBody(a3_DemoSoftBody *body, const a3real dt);
+
+	// line list of the distance constraints (two indices each, offset by
+	//	base) for drawing as a wireframe; returns index count
+	int a3demo_getSoftBodyEdges(const a3_DemoSoftBody *body, unsigned int *index_out, const unsigned int base);
+
+	// enclosed volume of the surface as it is now
+	a3real a3demo_getSoftBodyVolume(const a3_DemoSoftBody *body);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSOFTBODY_H
@@ -0,0 +1,249 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoJobBenchmark.c
+	Job system benchmark implementation.
+*/
+
+#include "a3_DemoJobBenchmark.h"
+
+#include "animal3D/a3utility/a3_Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// benchmark constants
+enum a3_DemoJobBenchmarkInternal
+{
+	a3demo_jobBenchTinyJobs = 1 << 20,		// empty parallel-for items
+	a3demo_jobBenchSingleJobs = 1 << 16,	// individually submitted jobs
+	a3demo_jobBenchStages = 64,				// dependency chain length
+	a3demo_jobBenchStageWidth = 4096,		// items per stage
+	a3demo_jobBenchOuter = 64,				// nested parallel-for: outer items
+	a3demo_jobBenchInner = 1024,			// ...and inner items per outer
+	a3demo_jobBenchWorkItems = 1 << 18,	// compute-bound items
+};
+
+// shared test state; per-worker tallies avoid needing atomics here
+typedef struct a3_DemoJobBench
+{
+	a3_DemoJobSystem *jobs;
+	unsigned int tally[a3demo_jobMaxWorkers];
+	unsigned int *mark;
+	float *result;
+	unsigned int stage;
+	unsigned int failed;
+} a3_DemoJobBench;
+
+// a stage of the dependency chain
+typedef struct a3_DemoJobBenchStage
+{
+	a3_DemoJobBench *bench;
+	unsigned int stage;
+} a3_DemoJobBenchStage;
+
+
+// count items run, per worker
+void a3demo_jobBenchCount(a3_DemoJobBench *bench, const unsigned int first, const unsigned int count)
+{
+	bench->tally[a3demo_getJobWorkerIndex(bench->jobs)] += count;
+}
+
+// every item of the previous stage must be finished before this one runs
+void a3demo_jobBenchStage(a3_DemoJobBenchStage *stage, const unsigned int first, const unsigned int count)
+{
+	unsigned int i;
+	for (i = first; i < first + count; ++i)
+	{
+		if (stage->bench->mark[i] != stage->stage)
+			stage->bench->failed = 1;
+		stage->bench->mark[i] = stage->stage + 1;
+	}
+	a3demo_jobBenchCount(stage->bench, first, count);
+}
+
+// outer items run a parallel-for of their own and wait on it from a worker
+void a3demo_jobBenchNested(a3_DemoJobBench *bench, const unsigned int first, const unsigned int count)
+{
+	unsigned int i;
+	for (i = 0; i < count; ++i)
+		a3demo_parallelFor(bench->jobs, (a3_DemoJobFunc)a3demo_jobBenchCount, bench, a3demo_jobBenchInner, 16);
+}
+
+// something worth splitting
+void a3demo_jobBenchWork(a3_DemoJobBench *bench, const unsigned int first, const unsigned int count)
+{
+	unsigned int i, k;
+	float x;
+	for (i = first; i < first + count; ++i)
+	{
+		x = (float)i;
+		for (k = 0; k < 64; ++k)
+			x = sqrtf(x + (float)k);
+		bench->result[i] = x;
+	}
+}
+
+// reset tallies; returns the previous total
+unsigned int a3demo_jobBenchTake(a3_DemoJobBench *bench)
+{
+	unsigned int i, total = 0;
+	for (i = 0; i < a3demo_jobMaxWorkers; ++i)
+		total += bench->tally[i];
+	memset(bench->tally, 0, sizeof(bench->tally));
+	return total;
+}
+
+// seconds since the last lap
+inline double a3demo_jobBenchLap(a3_Timer *timer)
+{
+	return (a3timerUpdate(timer) > 0) ? timer->previousTick : 0.0;
+}
+
+// one pass/fail line
+inline int a3demo_jobBenchCheck(const char *name, const unsigned int got, const unsigned int expected, const double seconds, const unsigned int items)
+{
+	printf("\n  %-28s | %9u / %9u %s | %8.3f ms, %7.1f ns/item",
+		name, got, expected, got == expected ? "ok  " : "FAIL",
+		seconds * 1000.0, items ? seconds * 1.0e9 / (double)items : 0.0);
+	return got == expected;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_benchmarkJobSystem(a3_DemoJobSystem *jobs, const unsigned int rounds)
+{
+	a3_DemoJobBench bench[1];
+	a3_DemoJobBenchStage stage[a3demo_jobBenchStages];
+	a3_DemoJobCounter counter[a3demo_jobBenchStages + 1];
+	a3_DemoJob job;
+	a3_Timer timer[1];
+	double seconds, serial, parallel;
+	unsigned int round, i, passed = 1, executed = 0, stolen = 0;
+
+	if (!jobs || a3demo_getJobWorkerIndex(jobs) != 0)
+		return -1;
+
+	memset(bench, 0, sizeof(bench));
+	bench->jobs = jobs;
+	bench->mark = (unsigned int *)malloc(a3demo_jobBenchStageWidth * sizeof(unsigned int));
+	bench->result = (float *)malloc(a3demo_jobBenchWorkItems * sizeof(float));
+	if (!bench->mark || !bench->result)
+	{
+		free(bench->mark);
+		free(bench->result);
+		return -1;
+	}
+
+	for (i = 0; i < jobs->workerCount; ++i)
+		jobs->worker[i].executed = jobs->worker[i].stolen = 0;
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+
+	printf("\n JOB SYSTEM STRESS (%u workers, %u rounds)", jobs->workerCount, rounds);
+	for (round = 0; round < rounds; ++round)
+	{
+		// tiny items: pure scheduling overhead
+		a3demo_jobBenchLap(timer);
+		a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_jobBenchCount, bench, a3demo_jobBenchTinyJobs, 64);
+		seconds = a3demo_jobBenchLap(timer);
+		passed &= a3demo_jobBenchCheck("parallel-for, empty items", a3demo_jobBenchTake(bench), a3demo_jobBenchTinyJobs, seconds, a3demo_jobBenchTinyJobs);
+
+		// single jobs on one counter
+		a3demo_initJobCounter(counter);
+		job.func = (a3_DemoJobFunc)a3demo_jobBenchCount;
+		job.user = bench;
+		job.first = 0;
+		job.count = 1;
+		job.grain = 0;
+		job.counter = counter;
+		a3demo_jobBenchLap(timer);
+		for (i = 0; i < a3demo_jobBenchSingleJobs; ++i)
+			a3demo_submitJob(jobs, &job);
+		a3demo_waitJobCounter(jobs, counter);
+		seconds = a3demo_jobBenchLap(timer);
+		passed &= a3demo_jobBenchCheck("submit + wait, single jobs", a3demo_jobBenchTake(bench), a3demo_jobBenchSingleJobs, seconds, a3demo_jobBenchSingleJobs);
+
+		// chain: each stage waits on the previous stage's counter
+		memset(bench->mark, 0, a3demo_jobBenchStageWidth * sizeof(unsigned int));
+		bench->failed = 0;
+		for (i = 0; i <= a3demo_jobBenchStages; ++i)
+			a3demo_initJobCounter(counter + i);
+		a3demo_jobBenchLap(timer);
+		for (i = 0; i < a3demo_jobBenchStages; ++i)
+		{
+			stage[i].bench = bench;
+			stage[i].stage = i;
+			job.func = (a3_DemoJobFunc)a3demo_jobBenchStage;
+			job.user = stage + i;
+			job.first = 0;
+			job.count = a3demo_jobBenchStageWidth;
+			job.grain = 64;
+			job.counter = counter + i + 1;
+			if (i)
+				a3demo_submitJobAfter(jobs, &job, counter + i);
+			else
+				a3demo_submitJob(jobs, &job);
+		}
+		a3demo_waitJobCounter(jobs, counter + a3demo_jobBenchStages);
+		seconds = a3demo_jobBenchLap(timer);
+		passed &= a3demo_jobBenchCheck("dependency chain, in order", bench->failed ? 0 : a3demo_jobBenchTake(bench),
+			a3demo_jobBenchStages * a3demo_jobBenchStageWidth, seconds, a3demo_jobBenchStages * a3demo_jobBenchStageWidth);
+
+		// waits from inside jobs must help instead of deadlocking
+		a3demo_jobBenchLap(timer);
+		a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_jobBenchNested, bench, a3demo_jobBenchOuter, 1);
+		seconds = a3demo_jobBenchLap(timer);
+		passed &= a3demo_jobBenchCheck("nested parallel-for", a3demo_jobBenchTake(bench),
+			a3demo_jobBenchOuter * a3demo_jobBenchInner, seconds, a3demo_jobBenchOuter * a3demo_jobBenchInner);
+	}
+
+	for (i = 0; i < jobs->workerCount; ++i)
+	{
+		executed += jobs->worker[i].executed;
+		stolen += jobs->worker[i].stolen;
+	}
+	printf("\n  %u jobs executed, %u stolen (%.1f%%)", executed, stolen, executed ? 100.0 * stolen / executed : 0.0);
+
+	// scaling on compute-bound work
+	a3demo_jobBenchLap(timer);
+	a3demo_jobBenchWork(bench, 0, a3demo_jobBenchWorkItems);
+	serial = a3demo_jobBenchLap(timer);
+	a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_jobBenchWork, bench, a3demo_jobBenchWorkItems, 1024);
+	parallel = a3demo_jobBenchLap(timer);
+	a3timerStop(timer);
+	printf("\n  compute: serial %.3f ms, parallel-for %.3f ms, speedup %.2fx on %u workers",
+		serial * 1000.0, parallel * 1000.0, parallel > 0.0 ? serial / parallel : 0.0, jobs->workerCount);
+	printf("\n  %s\n", passed ? "all checks passed" : "CHECKS FAILED");
+
+	free(bench->mark);
+	free(bench->result);
+	return passed ? 1 : -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoJobBenchmark.h
+	Console stress test and benchmark for the job system.
+*/
+
+#ifndef __ANIMAL3D_DEMOJOBBENCHMARK_H
+#define __ANIMAL3D_DEMOJOBBENCHMARK_H
+
+
+#include "a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// hammer the scheduler (single jobs, parallel-for, dependency chains,
+	//	nested waits) checking every result, then time parallel-for
+	//	against a serial loop; must be called from the owning thread
+	//	-> returns 1 if every check passed, -1 otherwise
+	int a3demo_benchmarkJobSystem(a3_DemoJobSystem *jobs, const unsigned int rounds);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOJOBBENCHMARK_H
@@ -0,0 +1,668 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoJobSystem.c
+	Job scheduler implementation.
+*/
+
+#include "a3_DemoJobSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// platform: atomics, thread-local worker and the sleep/wake primitive
+
+#ifdef _WIN32
+#include <Windows.h>
+#define A3_JOB_THREAD_LOCAL	__declspec(thread)
+#else	// !_WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/time.h>
+#define A3_JOB_THREAD_LOCAL	__thread
+#endif	// _WIN32
+
+
+// worker running on this thread, if any
+A3_JOB_THREAD_LOCAL a3_DemoJobWorker *a3demo_jobCurrentWorker;
+
+
+// idle policy
+enum a3_DemoJobSystemInternal
+{
+	a3demo_jobSpinCount = 64,		// failed attempts spent spinning
+	a3demo_jobYieldCount = 256,		// ...then yielding, then parking
+	a3demo_jobParkMilliseconds = 2,	// parked workers recheck this often
+};
+
+
+#ifdef _WIN32
+
+// x86/x64: aligned volatile loads and stores are atomic and ordered
+//	enough; anything that needs a full barrier goes through Interlocked
+inline long a3demo_jobLoad(volatile long *p)
+{
+	const long v = *p;
+	_ReadWriteBarrier();
+	return v;
+}
+
+inline long a3demo_jobExchange(volatile long *p, const long v)
+{
+	return InterlockedExchange(p, v);
+}
+
+inline long a3demo_jobCompareExchange(volatile long *p, const long expected, const long desired)
+{
+	return InterlockedCompareExchange(p, desired, expected);
+}
+
+inline long a3demo_jobAdd(volatile long *p, const long v)
+{
+	return InterlockedExchangeAdd(p, v) + v;
+}
+
+inline void a3demo_jobFence()
+{
+	MemoryBarrier();
+}
+
+inline void a3demo_jobPause()
+{
+	YieldProcessor();
+}
+
+inline void a3demo_jobYield()
+{
+	SwitchToThread();
+}
+
+void *a3demo_jobCreateWake()
+{
+	return CreateSemaphore(0, 0, 0x7fffffff, 0);
+}
+
+void a3demo_jobReleaseWake(void *wake)
+{
+	CloseHandle((HANDLE)wake);
+}
+
+void a3demo_jobWait(void *wake, const unsigned int milliseconds)
+{
+	WaitForSingleObject((HANDLE)wake, milliseconds);
+}
+
+void a3demo_jobSignal(void *wake, const unsigned int count)
+{
+	ReleaseSemaphore((HANDLE)wake, (LONG)count, 0);
+}
+
+unsigned int a3demo_getHardwareThreadCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+}
+
+#else	// !_WIN32
+
+// counting wake tokens behind a mutex; condition variables exist
+//	everywhere pthreads do
+typedef struct a3_DemoJobWake
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	unsigned int tokens;
+} a3_DemoJobWake;
+
+inline long a3demo_jobLoad(volatile long *p)
+{
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline long a3demo_jobExchange(volatile long *p, const long v)
+{
+	return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline long a3demo_jobCompareExchange(volatile long *p, const long expected, const long desired)
+{
+	long e = expected;
+	__atomic_compare_exchange_n(p, &e, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return e;
+}
+
+inline long a3demo_jobAdd(volatile long *p, const long v)
+{
+	return __atomic_add_fetch(p, v, __ATOMIC_SEQ_CST);
+}
+
+inline void a3demo_jobFence()
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+inline void a3demo_jobPause()
+{
+#if (defined __i386__ || defined __x86_64__)
+	__builtin_ia32_pause();
+#endif	// x86
+}
+
+inline void a3demo_jobYield()
+{
+	sched_yield();
+}
+
+void *a3demo_jobCreateWake()
+{
+	a3_DemoJobWake *wake = (a3_DemoJobWake *)malloc(sizeof(a3_DemoJobWake));
+	if (wake)
+	{
+		pthread_mutex_init(&wake->mutex, 0);
+		pthread_cond_init(&wake->cond, 0);
+		wake->tokens = 0;
+	}
+	return wake;
+}
+
+void a3demo_jobReleaseWake(void *wake)
+{
+	a3_DemoJobWake *w = (a3_DemoJobWake *)wake;
+	pthread_cond_destroy(&w->cond);
+	pthread_mutex_destroy(&w->mutex);
+	free(w);
+}
+
+void a3demo_jobWait(void *wake, const unsigned int milliseconds)
+{
+	a3_DemoJobWake *w = (a3_DemoJobWake *)wake;
+	struct timeval now;
+	struct timespec until;
+
+	gettimeofday(&now, 0);
+	until.tv_sec = now.tv_sec;
+	until.tv_nsec = (now.tv_usec + milliseconds * 1000) * 1000;
+	until.tv_sec += until.tv_nsec / 1000000000;
+	until.tv_nsec %= 1000000000;
+
+	pthread_mutex_lock(&w->mutex);
+	if (!w->tokens)
+		pthread_cond_timedwait(&w->cond, &w->mutex, &until);
+	if (w->tokens)
+		--w->tokens;
+	pthread_mutex_unlock(&w->mutex);
+}
+
+void a3demo_jobSignal(void *wake, const unsigned int count)
+{
+	a3_DemoJobWake *w = (a3_DemoJobWake *)wake;
+	pthread_mutex_lock(&w->mutex);
+	w->tokens += count;
+	if (count > 1)
+		pthread_cond_broadcast(&w->cond);
+	else
+		pthread_cond_signal(&w->cond);
+	pthread_mutex_unlock(&w->mutex);
+}
+
+unsigned int a3demo_getHardwareThreadCount()
+{
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (unsigned int)count : 1;
+}
+
+#endif	// _WIN32
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// positions wrap, so sizes come from unsigned differences
+inline long a3demo_jobDequeSpan(const long bottom, const long top)
+{
+	return (long)((unsigned long)bottom - (unsigned long)top);
+}
+
+// owner only; fails if full
+int a3demo_jobDequePush(a3_DemoJobDeque *deque, const a3_DemoJob *job)
+{
+	const long b = deque->bottom;
+	const long t = a3demo_jobLoad(&deque->top);
+	if (a3demo_jobDequeSpan(b, t) >= a3demo_jobDequeSize)
+		return 0;
+	deque->job[(unsigned long)b & (a3demo_jobDequeSize - 1)] = *job;
+	a3demo_jobExchange(&deque->bottom, (long)((unsigned long)b + 1));
+	return 1;
+}
+
+// owner only; newest job first
+int a3demo_jobDequePop(a3_DemoJobDeque *deque, a3_DemoJob *job_out)
+{
+	const long b = (long)((unsigned long)deque->bottom - 1);
+	long t, span;
+	int taken = 1;
+
+	// claim the bottom slot before looking at the top (full barrier)
+	a3demo_jobExchange(&deque->bottom, b);
+	t = a3demo_jobLoad(&deque->top);
+	span = a3demo_jobDequeSpan(b, t);
+	if (span < 0)
+	{
+		// empty
+		a3demo_jobExchange(&deque->bottom, t);
+		return 0;
+	}
+
+	*job_out = deque->job[(unsigned long)b & (a3demo_jobDequeSize - 1)];
+	if (span == 0)
+	{
+		// last job: race thieves for it through the top
+		taken = a3demo_jobCompareExchange(&deque->top, t, (long)((unsigned long)t + 1)) == t;
+		a3demo_jobExchange(&deque->bottom, (long)((unsigned long)t + 1));
+	}
+	return taken;
+}
+
+// any thread; oldest job first
+int a3demo_jobDequeSteal(a3_DemoJobDeque *deque, a3_DemoJob *job_out)
+{
+	const long t = a3demo_jobLoad(&deque->top);
+	long b;
+	a3demo_jobFence();
+	b = a3demo_jobLoad(&deque->bottom);
+	if (a3demo_jobDequeSpan(b, t) <= 0)
+		return 0;
+
+	// the copy only counts if nobody else moved the top meanwhile
+	*job_out = deque->job[(unsigned long)t & (a3demo_jobDequeSize - 1)];
+	return a3demo_jobCompareExchange(&deque->top, t, (long)((unsigned long)t + 1)) == t;
+}
+
+inline int a3demo_jobDequeEmpty(a3_DemoJobDeque *deque)
+{
+	return a3demo_jobDequeSpan(a3demo_jobLoad(&deque->bottom), a3demo_jobLoad(&deque->top)) <= 0;
+}
+
+
+inline void a3demo_jobLock(volatile long *lock)
+{
+	while (a3demo_jobCompareExchange(lock, 0, 1) != 0)
+		a3demo_jobPause();
+}
+
+inline void a3demo_jobUnlock(volatile long *lock)
+{
+	a3demo_jobExchange(lock, 0);
+}
+
+// xorshift for victim selection
+inline unsigned int a3demo_jobRandom(a3_DemoJobWorker *worker)
+{
+	unsigned int x = worker->random;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return (worker->random = x);
+}
+
+inline a3_DemoJobWorker *a3demo_jobGetWorker(const a3_DemoJobSystem *jobs)
+{
+	a3_DemoJobWorker *const worker = a3demo_jobCurrentWorker;
+	return (worker && worker->system == jobs) ? worker : 0;
+}
+
+
+void a3demo_jobRun(a3_DemoJobSystem *jobs, a3_DemoJobWorker *worker, a3_DemoJob *job);
+
+// queue on this worker and wake someone to steal it; a full queue
+//	just runs the job now
+void a3demo_jobEnqueue(a3_DemoJobSystem *jobs, a3_DemoJobWorker *worker, a3_DemoJob *job)
+{
+	if (a3demo_jobDequePush(worker->deque, job))
+	{
+		a3demo_jobFence();
+		if (a3demo_jobLoad(&jobs->sleepers) > 0)
+			a3demo_jobSignal(jobs->wake, 1);
+	}
+	else
+		a3demo_jobRun(jobs, worker, job);
+}
+
+// one job done: the last one out holds the lock while publishing zero,
+//	so a waiter that sees zero and an unlocked counter may free it; a
+//	job submitted between the load and the decrement keeps the count
+//	up, and its own finish releases the continuations instead
+void a3demo_jobFinish(a3_DemoJobSystem *jobs, a3_DemoJobWorker *worker, a3_DemoJobCounter *counter)
+{
+	a3_DemoJob continuation[a3demo_jobMaxContinuations];
+	unsigned int i, n;
+	long v;
+
+	for (;;)
+	{
+		v = a3demo_jobLoad(&counter->value);
+		if (v > 1)
+		{
+			if (a3demo_jobCompareExchange(&counter->value, v, v - 1) == v)
+				return;
+		}
+		else
+		{
+			a3demo_jobLock(&counter->lock);
+			if (a3demo_jobAdd(&counter->value, -1) != 0)
+			{
+				a3demo_jobUnlock(&counter->lock);
+				return;
+			}
+			n = counter->continuationCount;
+			memcpy(continuation, counter->continuation, n * sizeof(a3_DemoJob));
+			counter->continuationCount = 0;
+			a3demo_jobUnlock(&counter->lock);
+
+			for (i = 0; i < n; ++i)
+				a3demo_jobEnqueue(jobs, worker, continuation + i);
+			return;
+		}
+	}
+}
+
+// execute a job, first splitting off upper halves for thieves until the
+//	range fits the grain
+void a3demo_jobRun(a3_DemoJobSystem *jobs, a3_DemoJobWorker *worker, a3_DemoJob *job)
+{
+	a3_DemoJob half;
+	while (job->grain && job->count > job->grain)
+	{
+		half = *job;
+		half.count = job->count / 2;
+		half.first = job->first + job->count - half.count;
+		job->count -= half.count;
+		if (job->counter)
+			a3demo_jobAdd(&job->counter->value, 1);
+		a3demo_jobEnqueue(jobs, worker, &half);
+	}
+
+	job->func(job->user, job->first, job->count);
+	++worker->executed;
+	if (job->counter)
+		a3demo_jobFinish(jobs, worker, job->counter);
+}
+
+// run one job from our own queue or someone else's
+int a3demo_jobTryRun(a3_DemoJobSystem *jobs, a3_DemoJobWorker *worker)
+{
+	a3_DemoJob job;
+	unsigned int i, victim;
+
+	if (a3demo_jobDequePop(worker->deque, &job))
+	{
+		a3demo_jobRun(jobs, worker, &job);
+		return 1;
+	}
+
+	// start at a random victim so thieves spread out
+	victim = a3demo_jobRandom(worker) % jobs->workerCount;
+	for (i = 0; i < jobs->workerCount; ++i, victim = (victim + 1) % jobs->workerCount)
+	{
+		if (victim != worker->index && a3demo_jobDequeSteal(jobs->worker[victim].deque, &job))
+		{
+			++worker->stolen;
+			a3demo_jobRun(jobs, worker, &job);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// anything queued anywhere
+int a3demo_jobAnyQueued(a3_DemoJobSystem *jobs)
+{
+	unsigned int i;
+	for (i = 0; i < jobs->workerCount; ++i)
+		if (!a3demo_jobDequeEmpty(jobs->worker[i].deque))
+			return 1;
+	return 0;
+}
+
+long a3demo_jobWorkerThread(a3_DemoJobWorker *worker)
+{
+	a3_DemoJobSystem *const jobs = worker->system;
+	unsigned int idle = 0;
+
+	a3demo_jobCurrentWorker = worker;
+	while (a3demo_jobLoad(&jobs->running))
+	{
+		if (a3demo_jobTryRun(jobs, worker))
+			idle = 0;
+		else if (++idle < a3demo_jobSpinCount)
+			a3demo_jobPause();
+		else if (idle < a3demo_jobYieldCount)
+			a3demo_jobYield();
+		else
+		{
+			// announce ourselves before the last look so a submitter
+			//	either sees us or we see its job
+			a3demo_jobAdd(&jobs->sleepers, 1);
+			if (!a3demo_jobAnyQueued(jobs) && a3demo_jobLoad(&jobs->running))
+				a3demo_jobWait(jobs->wake, a3demo_jobParkMilliseconds);
+			a3demo_jobAdd(&jobs->sleepers, -1);
+		}
+	}
+	a3demo_jobCurrentWorker = 0;
+	return worker->executed;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initJobSystem(a3_DemoJobSystem *jobs, const unsigned int workerCount)
+{
+	if (jobs && !jobs->memory)
+	{
+		const unsigned int count = workerCount ?
+			(workerCount < a3demo_jobMaxWorkers ? workerCount : a3demo_jobMaxWorkers) :
+			(a3demo_getHardwareThreadCount() < a3demo_jobMaxWorkers ? a3demo_getHardwareThreadCount() : a3demo_jobMaxWorkers);
+		const size_t size = sizeof(a3_DemoJobWorker) * count + a3demo_jobCacheLine;
+		a3_DemoJobWorker *worker;
+		unsigned int i;
+
+		jobs->memory = malloc(size);
+		jobs->wake = a3demo_jobCreateWake();
+		if (!jobs->memory || !jobs->wake)
+		{
+			free(jobs->memory);
+			if (jobs->wake)
+				a3demo_jobReleaseWake(jobs->wake);
+			memset(jobs, 0, sizeof(a3_DemoJobSystem));
+			return -1;
+		}
+		memset(jobs->memory, 0, size);
+		jobs->worker = (a3_DemoJobWorker *)(((size_t)jobs->memory + a3demo_jobCacheLine - 1) & ~((size_t)a3demo_jobCacheLine - 1));
+		jobs->workerCount = count;
+		jobs->running = 1;
+		jobs->sleepers = 0;
+
+		for (i = 0, worker = jobs->worker; i < count; ++i, ++worker)
+		{
+			worker->system = jobs;
+			worker->index = i;
+			worker->random = (i + 1) * 0x9e3779b9u;
+			sprintf(worker->name, "a3job%u", i);
+		}
+
+		// the calling thread is worker 0 and only runs jobs while waiting
+		a3demo_jobCurrentWorker = jobs->worker;
+		for (i = 1; i < count; ++i)
+			a3threadLaunch(jobs->worker[i].thread, (a3_threadfunc)a3demo_jobWorkerThread, jobs->worker + i, jobs->worker[i].name);
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_releaseJobSystem(a3_DemoJobSystem *jobs)
+{
+	if (jobs && jobs->memory)
+	{
+		unsigned int i;
+		a3demo_jobExchange(&jobs->running, 0);
+		a3demo_jobSignal(jobs->wake, jobs->workerCount);
+		for (i = 1; i < jobs->workerCount; ++i)
+			a3threadWait(jobs->worker[i].thread);
+
+		if (a3demo_jobCurrentWorker == jobs->worker)
+			a3demo_jobCurrentWorker = 0;
+		a3demo_jobReleaseWake(jobs->wake);
+		free(jobs->memory);
+		memset(jobs, 0, sizeof(a3_DemoJobSystem));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_initJobCounter(a3_DemoJobCounter *counter)
+{
+	if (counter)
+	{
+		counter->value = 0;
+		counter->lock = 0;
+		counter->continuationCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_submitJob(a3_DemoJobSystem *jobs, const a3_DemoJob *job)
+{
+	a3_DemoJobWorker *const worker = a3demo_jobGetWorker(jobs);
+	if (worker && job && job->func)
+	{
+		a3_DemoJob copy = *job;
+		if (copy.counter)
+			a3demo_jobAdd(&copy.counter->value, 1);
+		a3demo_jobEnqueue(jobs, worker, &copy);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_submitJobAfter(a3_DemoJobSystem *jobs, const a3_DemoJob *job, a3_DemoJobCounter *dependency)
+{
+	a3_DemoJobWorker *const worker = a3demo_jobGetWorker(jobs);
+	if (worker && job && job->func && dependency)
+	{
+		a3_DemoJob copy = *job;
+
+		// counted now, so waiting on the job's counter covers the delay
+		if (copy.counter)
+			a3demo_jobAdd(&copy.counter->value, 1);
+
+		// the finisher takes the lock to publish zero, so either it sees
+		//	the continuation or we see zero
+		a3demo_jobLock(&dependency->lock);
+		if (a3demo_jobLoad(&dependency->value) > 0 && dependency->continuationCount < a3demo_jobMaxContinuations)
+		{
+			dependency->continuation[dependency->continuationCount++] = copy;
+			a3demo_jobUnlock(&dependency->lock);
+			return 1;
+		}
+		a3demo_jobUnlock(&dependency->lock);
+
+		// already done, or no room to park it: wait it out here
+		a3demo_waitJobCounter(jobs, dependency);
+		a3demo_jobEnqueue(jobs, worker, &copy);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_waitJobCounter(a3_DemoJobSystem *jobs, a3_DemoJobCounter *counter)
+{
+	if (jobs && counter)
+	{
+		a3_DemoJobWorker *const worker = a3demo_jobGetWorker(jobs);
+		unsigned int idle = 0;
+
+		// help rather than block; a thread outside the system can only
+		//	back off
+		while (a3demo_jobLoad(&counter->value) > 0 || a3demo_jobLoad(&counter->lock))
+		{
+			if (worker && a3demo_jobTryRun(jobs, worker))
+				idle = 0;
+			else if (++idle < a3demo_jobSpinCount)
+				a3demo_jobPause();
+			else
+				a3demo_jobYield();
+		}
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_parallelFor(a3_DemoJobSystem *jobs, a3_DemoJobFunc func, void *user, const unsigned int count, const unsigned int grain)
+{
+	if (func)
+	{
+		a3_DemoJobWorker *const worker = jobs ? a3demo_jobGetWorker(jobs) : 0;
+		a3_DemoJobCounter counter[1];
+		a3_DemoJob job;
+
+		if (!count)
+			return 0;
+
+		// serial when there is nobody to share with or nothing to share
+		if (!worker || jobs->workerCount < 2 || count <= grain)
+		{
+			func(user, 0, count);
+			return 1;
+		}
+
+		// run the whole range here: it splits itself, leaving halves
+		//	behind for thieves, then we help with whatever is left
+		a3demo_initJobCounter(counter);
+		counter->value = 1;
+		job.func = func;
+		job.user = user;
+		job.first = 0;
+		job.count = count;
+		job.grain = grain ? grain : 1;
+		job.counter = counter;
+		a3demo_jobRun(jobs, worker, &job);
+		a3demo_waitJobCounter(jobs, counter);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_getJobWorkerIndex(const a3_DemoJobSystem *jobs)
+{
+	const a3_DemoJobWorker *const worker = a3demo_jobGetWorker(jobs);
+	return worker ? (int)worker->index : -1;
+}
+
+
+//-----------------------------------------------------------------------------
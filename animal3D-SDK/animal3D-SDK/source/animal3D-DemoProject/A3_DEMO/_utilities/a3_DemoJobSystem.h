@@ -0,0 +1,167 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoJobSystem.h
+	Work-stealing job scheduler on top of a3_Thread.
+*/
+
+#ifndef __ANIMAL3D_DEMOJOBSYSTEM_H
+#define __ANIMAL3D_DEMOJOBSYSTEM_H
+
+
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoJob			a3_DemoJob;
+	typedef struct a3_DemoJobCounter	a3_DemoJobCounter;
+	typedef struct a3_DemoJobDeque		a3_DemoJobDeque;
+	typedef struct a3_DemoJobWorker		a3_DemoJobWorker;
+	typedef struct a3_DemoJobSystem		a3_DemoJobSystem;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// job system constants
+	enum a3_DemoJobSystemConstants
+	{
+		a3demo_jobMaxWorkers = 64,			// including the thread that owns the system
+		a3demo_jobDequeSize = 4096,			// jobs per worker queue (power of two)
+		a3demo_jobMaxContinuations = 8,		// jobs that can wait on one counter
+		a3demo_jobCacheLine = 64,			// bytes; keeps hot atomics apart
+	};
+
+
+	// job function: every job covers a range of indices; single jobs just
+	//	use a count of one
+	typedef void(*a3_DemoJobFunc)(void *user, unsigned int first, unsigned int count);
+
+
+	// job descriptor, copied by value into the queues
+	//	member grain: ranges larger than this are split in half when they
+	//		run, and the upper half is left for others to steal; zero never
+	//		splits
+	//	member counter: optional; decremented when the job (and any halves
+	//		split off it) has finished
+	struct a3_DemoJob
+	{
+		a3_DemoJobFunc func;
+		void *user;
+		unsigned int first, count;
+		unsigned int grain;
+		a3_DemoJobCounter *counter;
+	};
+
+	// completion counter: number of jobs still outstanding; jobs queued
+	//	behind it are submitted by whichever thread brings it to zero
+	struct a3_DemoJobCounter
+	{
+		volatile long value;
+		volatile long lock;
+		unsigned int continuationCount;
+		a3_DemoJob continuation[a3demo_jobMaxContinuations];
+	};
+
+	// Chase-Lev deque: the owner pushes and pops at the bottom, thieves
+	//	take from the top; positions only grow and wrap as unsigned
+	struct a3_DemoJobDeque
+	{
+		volatile long top;
+		char pad0[a3demo_jobCacheLine - sizeof(long)];
+		volatile long bottom;
+		char pad1[a3demo_jobCacheLine - sizeof(long)];
+		a3_DemoJob job[a3demo_jobDequeSize];
+	};
+
+	// one per thread, including the owner at index 0
+	struct a3_DemoJobWorker
+	{
+		a3_DemoJobDeque deque[1];
+		a3_DemoJobSystem *system;
+		a3_Thread thread[1];
+		unsigned int index;
+		unsigned int random;			// victim selection state
+		unsigned int executed;			// jobs run by this worker
+		unsigned int stolen;			// of those, how many came from others
+		char name[16];
+	};
+
+	// scheduler: worker 0 is the thread that initialized it, and that
+	//	thread (or any job) is the only one allowed to submit
+	struct a3_DemoJobSystem
+	{
+		a3_DemoJobWorker *worker;		// worker array (heap)
+		void *memory;					// raw allocation behind the workers
+		void *wake;						// sleep/wake primitive (heap, platform)
+		unsigned int workerCount;
+		volatile long running;
+		volatile long sleepers;			// workers parked on the wake primitive
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// start the scheduler with the given number of workers including the
+	//	calling thread; zero uses one per hardware thread
+	int a3demo_initJobSystem(a3_DemoJobSystem *jobs, const unsigned int workerCount);
+
+	// stop and join all workers; queued jobs are discarded
+	int a3demo_releaseJobSystem(a3_DemoJobSystem *jobs);
+
+	// reset a counter before use
+	int a3demo_initJobCounter(a3_DemoJobCounter *counter);
+
+	// queue a job on the calling worker; if the queue is full it runs now
+	int a3demo_submitJob(a3_DemoJobSystem *jobs, const a3_DemoJob *job);
+
+	// queue a job to start once a counter reaches zero (submitted right
+	//	away if it already has); the dependency must not be reset until
+	//	it has released its continuations
+	int a3demo_submitJobAfter(a3_DemoJobSystem *jobs, const a3_DemoJob *job, a3_DemoJobCounter *dependency);
+
+	// run queued jobs on the calling thread until the counter reaches zero
+	int a3demo_waitJobCounter(a3_DemoJobSystem *jobs, a3_DemoJobCounter *counter);
+
+	// run func over [0, count) split into ranges no larger than grain and
+	//	wait for all of it, helping meanwhile; null jobs runs serially
+	int a3demo_parallelFor(a3_DemoJobSystem *jobs, a3_DemoJobFunc func, void *user, const unsigned int count, const unsigned int grain);
+
+	// calling thread's worker index, or -1 if it does not belong to jobs
+	int a3demo_getJobWorkerIndex(const a3_DemoJobSystem *jobs);
+
+	// hardware threads available
+	unsigned int a3demo_getHardwareThreadCount();
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOJOBSYSTEM_H
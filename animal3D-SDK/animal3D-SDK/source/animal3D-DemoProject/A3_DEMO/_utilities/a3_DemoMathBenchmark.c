@@ -0,0 +1,947 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMathBenchmark.c
+	Math kernel benchmark implementation.
+*/
+
+#include "a3_DemoMathBenchmark.h"
+#include "a3_DemoQuaternion.h"
+#include "a3_DemoTrig.h"
+#include "a3_DemoRandom.h"
+
+#include "animal3D/a3utility/a3_Timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// benchmark constants
+enum a3_DemoMathBenchmarkInternal
+{
+	a3demo_mathBenchItems = 1024,		// inputs of each kind, reused every round
+};
+
+// largest difference allowed, relative to the result's largest value:
+//	the kernels may sum in another order, but not lose more than a few
+//	units in the last place
+#define a3demo_mathBenchTolerance		((a3real)1.0e-5)
+
+// kernel signatures shared by the A3DM routines and their counterparts
+typedef a3real4r(*a3_DemoMathFuncVV)(a3real4p v_out, const a3real4p vL, const a3real4p vR);
+typedef a3real4r(*a3_DemoMathFuncVS)(a3real4p v_out, const a3real4p v, const a3real s);
+typedef a3real(*a3_DemoMathFuncDot)(const a3real4p vL, const a3real4p vR);
+typedef a3real4r(*a3_DemoMathFuncV)(a3real4p v_inout);
+typedef a3real4r(*a3_DemoMathFuncMV)(a3real4p v_out, const a3real4x4p m, const a3real4p v);
+typedef a3real4x4r(*a3_DemoMathFuncMM)(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR);
+typedef a3real4x4r(*a3_DemoMathFuncM)(a3real4x4p m_out, const a3real4x4p m);
+
+// inputs and both sets of results
+typedef struct a3_DemoMathBench
+{
+	a3real4x4 *mL, *mR, *mRef, *mOut, *mInvRef, *mInvOut;
+	a3real4 *vL, *vR, *vRef, *vOut;
+	a3real *s, *sRef, *sOut;
+	a3real *soa[3], *soaRef[3], *soaOut[3];
+	a3real4x4 viewProjection;		// projective; kept apart from the affine inputs
+	a3_Timer timer[1];
+	unsigned int rounds;
+	void *memory, *extra;
+} a3_DemoMathBench;
+
+
+// uniform random in [-1, 1)
+inline a3real a3demo_mathBenchRandom()
+{
+	return (a3real)rand() / ((a3real)RAND_MAX + a3realOne) * a3realTwo - a3realOne;
+}
+
+// seconds since the last lap
+inline double a3demo_mathBenchLap(a3_Timer *timer)
+{
+	return (a3timerUpdate(timer) > 0) ? timer->previousTick : 0.0;
+}
+
+// random rotation with each axis scaled by 1/2 to 2 and a translation
+//	within 10 units, as a scene object's model matrix would be
+void a3demo_mathBenchTransform(a3real4x4p m_out)
+{
+	a3real s;
+	unsigned int k;
+	a3real4x4SetRotateZYX(m_out, 180.0f * a3demo_mathBenchRandom(), 180.0f * a3demo_mathBenchRandom(), 180.0f * a3demo_mathBenchRandom());
+	for (k = 0; k < 3; ++k)
+	{
+		s = (a3real)pow(2.0, (double)a3demo_mathBenchRandom());
+		m_out[k][0] *= s;
+		m_out[k][1] *= s;
+		m_out[k][2] *= s;
+		m_out[3][k] = 10.0f * a3demo_mathBenchRandom();
+	}
+}
+
+// largest difference over groups of values, each relative to the largest
+//	reference value in its group (or 1 if they are all smaller)
+a3real a3demo_mathBenchError(const a3real *ref, const a3real *got, const unsigned int groups, const unsigned int groupSize)
+{
+	a3real error = a3realZero, size, diff, e;
+	unsigned int i, k;
+	for (i = 0; i < groups; ++i, ref += groupSize, got += groupSize)
+	{
+		size = a3realOne;
+		diff = a3realZero;
+		for (k = 0; k < groupSize; ++k)
+		{
+			if (size < (a3real)fabs(ref[k]))
+				size = (a3real)fabs(ref[k]);
+			e = (got[k] == got[k]) ? (a3real)fabs(got[k] - ref[k]) : (a3real)1.0e30;
+			if (diff < e)
+				diff = e;
+		}
+		e = diff / size;
+		if (error < e)
+			error = e;
+	}
+	return error;
+}
+
+// inputs of every kind from a fixed seed, and room for the results;
+//	extra bytes after them are for the caller
+int a3demo_mathBenchCreate(a3_DemoMathBench *bench, const unsigned int rounds, const unsigned int extra)
+{
+	const unsigned int matrices = a3demo_mathBenchItems * sizeof(a3real4x4), vectors = a3demo_mathBenchItems * sizeof(a3real4), scalars = a3demo_mathBenchItems * sizeof(a3real);
+	a3ubyte *memory;
+	unsigned int i, k;
+
+	memset(bench, 0, sizeof(*bench));
+	memory = (a3ubyte *)malloc(matrices * 6 + vectors * 4 + scalars * 12 + extra);
+	if (!memory)
+		return -1;
+	bench->memory = memory;
+	bench->extra = memory + matrices * 6 + vectors * 4 + scalars * 12;
+	bench->mL = (a3real4x4 *)memory;
+	bench->mR = bench->mL + a3demo_mathBenchItems;
+	bench->mRef = bench->mR + a3demo_mathBenchItems;
+	bench->mOut = bench->mRef + a3demo_mathBenchItems;
+	bench->mInvRef = bench->mOut + a3demo_mathBenchItems;
+	bench->mInvOut = bench->mInvRef + a3demo_mathBenchItems;
+	bench->vL = (a3real4 *)(bench->mInvOut + a3demo_mathBenchItems);
+	bench->vR = bench->vL + a3demo_mathBenchItems;
+	bench->vRef = bench->vR + a3demo_mathBenchItems;
+	bench->vOut = bench->vRef + a3demo_mathBenchItems;
+	bench->s = (a3real *)(bench->vOut + a3demo_mathBenchItems);
+	bench->sRef = bench->s + a3demo_mathBenchItems;
+	bench->sOut = bench->sRef + a3demo_mathBenchItems;
+	for (k = 0; k < 3; ++k)
+	{
+		bench->soa[k] = bench->sOut + a3demo_mathBenchItems * (k + 1);
+		bench->soaRef[k] = bench->soa[k] + a3demo_mathBenchItems * 3;
+		bench->soaOut[k] = bench->soaRef[k] + a3demo_mathBenchItems * 3;
+	}
+	bench->rounds = rounds;
+
+	srand(2021);
+	for (i = 0; i < a3demo_mathBenchItems; ++i)
+	{
+		a3demo_mathBenchTransform(bench->mL[i]);
+		a3demo_mathBenchTransform(bench->mR[i]);
+		for (k = 0; k < 4; ++k)
+		{
+			bench->vL[i][k] = 10.0f * a3demo_mathBenchRandom();
+			bench->vR[i][k] = 10.0f * a3demo_mathBenchRandom();
+		}
+		bench->s[i] = 4.0f * a3demo_mathBenchRandom();
+		for (k = 0; k < 3; ++k)
+			bench->soa[k][i] = bench->vL[i][k];
+	}
+	return 1;
+}
+
+
+// one result line
+int a3demo_mathBenchReport(const a3_DemoMathBench *bench, const char *name, const double reference, const double simd, const a3real error)
+{
+	const double calls = (double)bench->rounds * (double)a3demo_mathBenchItems;
+	const int passed = error <= a3demo_mathBenchTolerance;
+	printf("\n  %-30s | %7.2f ns | %7.2f ns | %5.2fx | %8.1e %s",
+		name, reference * 1.0e9 / calls, simd * 1.0e9 / calls, simd > 0.0 ? reference / simd : 0.0,
+		(double)error, passed ? "ok  " : "FAIL");
+	return passed;
+}
+
+
+int a3demo_mathBenchSumDiff(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncVV reference, a3_DemoMathFuncVV simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->vRef[i], bench->vL[i], bench->vR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->vOut[i], bench->vL[i], bench->vR[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+int a3demo_mathBenchProductS(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncVS reference, a3_DemoMathFuncVS simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->vRef[i], bench->vL[i], bench->s[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->vOut[i], bench->vL[i], bench->s[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+int a3demo_mathBenchDot(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncDot reference, a3_DemoMathFuncDot simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			bench->sRef[i] = reference(bench->vL[i], bench->vR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			bench->sOut[i] = simd(bench->vL[i], bench->vR[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(bench->sRef, bench->sOut, a3demo_mathBenchItems, 1));
+}
+
+
+int a3demo_mathBenchNormalize(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncV reference, a3_DemoMathFuncV simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+
+	// in place from copies of the raw vectors; they stay unit after the
+	//	first round, which costs the same
+	memcpy(bench->vRef, bench->vL, a3demo_mathBenchItems * sizeof(a3real4));
+	memcpy(bench->vOut, bench->vL, a3demo_mathBenchItems * sizeof(a3real4));
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->vRef[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->vOut[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+int a3demo_mathBenchMatrixVector(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncMV reference, a3_DemoMathFuncMV simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->vRef[i], bench->mL[i], bench->vR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->vOut[i], bench->mL[i], bench->vR[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+int a3demo_mathBenchMatrixMatrix(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncMM reference, a3_DemoMathFuncMM simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->mRef[i], bench->mL[i], bench->mR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->mOut[i], bench->mL[i], bench->mR[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+int a3demo_mathBenchMatrix(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncM reference, a3_DemoMathFuncM simd)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			reference(bench->mRef[i], bench->mL[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			simd(bench->mOut[i], bench->mL[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// what the demo does for every object it draws: bring the model matrix
+//	into the graphics frame, invert it for lighting and put it through the
+//	camera's view-projection (mR stands in for the graphics frame)
+int a3demo_mathBenchObjectPath(a3_DemoMathBench *bench, const char *name)
+{
+	a3real4x4 model;
+	a3real error, errorInv;
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+		{
+			a3real4x4Product(model, bench->mL[i], bench->mR[0]);
+			a3real4x4TransformInverseIgnoreScale(bench->mInvRef[i], model);
+			a3real4x4Product(bench->mRef[i], bench->viewProjection, model);
+		}
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+		{
+			a3demo_real4x4Product(model, bench->mL[i], bench->mR[0]);
+			a3demo_real4x4TransformInverseIgnoreScale(bench->mInvOut[i], model);
+			a3demo_real4x4Product(bench->mOut[i], bench->viewProjection, model);
+		}
+	ts = a3demo_mathBenchLap(bench->timer);
+	error = a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16);
+	errorInv = a3demo_mathBenchError(**bench->mInvRef, **bench->mInvOut, a3demo_mathBenchItems, 16);
+	return a3demo_mathBenchReport(bench, name, tr, ts, a3maximum(error, errorInv));
+}
+
+
+// one view-projection times every model matrix: a call each, or one
+//	call with the left matrix's stride at zero
+int a3demo_mathBenchProductArray(a3_DemoMathBench *bench, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4x4Product(bench->mRef[i], bench->viewProjection, bench->mL[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		a3demo_real4x4ProductArray(bench->mOut, sizeof(a3real4x4), &bench->viewProjection, 0, bench->mL, sizeof(a3real4x4), a3demo_mathBenchItems);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+int a3demo_mathBenchInverseArray(a3_DemoMathBench *bench, const char *name, const int scaled)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			if (scaled)
+				a3real4x4TransformInverse(bench->mRef[i], bench->mL[i]);
+			else
+				a3real4x4TransformInverseIgnoreScale(bench->mRef[i], bench->mL[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		if (scaled)
+			a3demo_real4x4TransformInverseArray(bench->mOut, sizeof(a3real4x4), bench->mL, sizeof(a3real4x4), a3demo_mathBenchItems);
+		else
+			a3demo_real4x4TransformInverseIgnoreScaleArray(bench->mOut, sizeof(a3real4x4), bench->mL, sizeof(a3real4x4), a3demo_mathBenchItems);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// points one vector apart, so the fourth value of each is left alone
+int a3demo_mathBenchPoints(a3_DemoMathBench *bench, const char *name)
+{
+	a3real4 p;
+	double tr, ts;
+	unsigned int r, i;
+	memcpy(bench->vRef, bench->vL, a3demo_mathBenchItems * sizeof(a3real4));
+	memcpy(bench->vOut, bench->vL, a3demo_mathBenchItems * sizeof(a3real4));
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+		{
+			p[0] = bench->vL[i][0];
+			p[1] = bench->vL[i][1];
+			p[2] = bench->vL[i][2];
+			p[3] = a3realOne;
+			a3real4Real4x4ProductR(p, bench->mR[0], p);
+			bench->vRef[i][0] = p[0];
+			bench->vRef[i][1] = p[1];
+			bench->vRef[i][2] = p[2];
+		}
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		a3demo_real4x4TransformPoints(*bench->vOut, sizeof(a3real4), bench->mR[0], *bench->vL, sizeof(a3real4), a3realOne, a3demo_mathBenchItems);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+int a3demo_mathBenchPointsSoA(a3_DemoMathBench *bench, const char *name)
+{
+	a3real4 p;
+	a3real error, e;
+	double tr, ts;
+	unsigned int r, i, k;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+		{
+			p[0] = bench->soa[0][i];
+			p[1] = bench->soa[1][i];
+			p[2] = bench->soa[2][i];
+			p[3] = a3realOne;
+			a3real4Real4x4ProductR(p, bench->mR[0], p);
+			bench->soaRef[0][i] = p[0];
+			bench->soaRef[1][i] = p[1];
+			bench->soaRef[2][i] = p[2];
+		}
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		a3demo_real4x4TransformPointsSoA(bench->soaOut[0], bench->soaOut[1], bench->soaOut[2], bench->mR[0],
+			bench->soa[0], bench->soa[1], bench->soa[2], a3realOne, a3demo_mathBenchItems);
+	ts = a3demo_mathBenchLap(bench->timer);
+	for (k = 0, error = a3realZero; k < 3; ++k)
+	{
+		e = a3demo_mathBenchError(bench->soaRef[k], bench->soaOut[k], a3demo_mathBenchItems, 1);
+		error = a3maximum(error, e);
+	}
+	return a3demo_mathBenchReport(bench, name, tr, ts, error);
+}
+
+
+// quaternion inputs: rotations from both sets of angles, and the rigid
+//	transforms mL and mR made of them as dual quaternions
+typedef struct a3_DemoMathBenchQuat
+{
+	a3real4 *qL, *qR;
+	a3_DemoDualQuat *dqL, *dqR;
+} a3_DemoMathBenchQuat;
+
+// a vector's first three values scaled to half turns, as euler angles
+#define a3demo_mathBenchAngles(v)	18.0f * (v)[0], 18.0f * (v)[1], 18.0f * (v)[2]
+
+
+// what a scene object pays when its angles change: the euler matrix, or
+//	the quaternion from the same angles and the matrix from that
+int a3demo_mathBenchQuatEuler(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4x4SetRotateZYX(bench->mRef[i], a3demo_mathBenchAngles(bench->vL[i]));
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_real4x4SetQuat(bench->mOut[i], a3demo_quatSetEulerZYX(bench->vOut[i], a3demo_mathBenchAngles(bench->vL[i])));
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// ...and when they did not: the euler matrix again, or the matrix from
+//	the quaternion kept since
+int a3demo_mathBenchQuatMatrix(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4x4SetRotateZYX(bench->mRef[i], a3demo_mathBenchAngles(bench->vL[i]));
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_real4x4SetQuat(bench->mOut[i], quat->qL[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// the rotation back out of a scaled model matrix (mInvRef holds them)
+//	and made a matrix again, against building it from the angles
+int a3demo_mathBenchQuatRoundTrip(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4x4SetRotateZYX(bench->mRef[i], a3demo_mathBenchAngles(bench->vL[i]));
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_real4x4SetQuat(bench->mOut[i], a3demo_quatSetReal4x4(bench->vOut[i], bench->mInvRef[i]));
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// points (vR with w at 1) through the rigid transform, as a matrix or as
+//	a dual quaternion
+int a3demo_mathBenchQuatPoint(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	for (i = 0; i < a3demo_mathBenchItems; ++i)
+		bench->vOut[i][3] = a3realOne;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4Real4x4ProductR(bench->vRef[i], bench->mL[i], bench->vR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_dualQuatTransformPoint(bench->vOut[i], quat->dqL + i, bench->vR[i]);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+
+// two rigid transforms composed, the dual quaternion one made a matrix
+int a3demo_mathBenchQuatCompose(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	a3_DemoDualQuat dq;
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3real4x4ProductTransform(bench->mRef[i], bench->mL[i], bench->mR[i]);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_real4x4SetDualQuat(bench->mOut[i], a3demo_dualQuatProduct(&dq, quat->dqL + i, quat->dqR + i));
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(**bench->mRef, **bench->mOut, a3demo_mathBenchItems, 16));
+}
+
+
+// halfway between two rotations slerp and nlerp agree, so the cheap one
+//	checks the other; their cost on the same pairs
+int a3demo_mathBenchQuatSlerp(a3_DemoMathBench *bench, const a3_DemoMathBenchQuat *quat, const char *name)
+{
+	double tr, ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_quatSlerp(bench->vRef[i], quat->qL[i], quat->qR[i], a3realHalf);
+	tr = a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			a3demo_quatNlerp(bench->vOut[i], quat->qL[i], quat->qR[i], a3realHalf);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchReport(bench, name, tr, ts,
+		a3demo_mathBenchError(*bench->vRef, *bench->vOut, a3demo_mathBenchItems, 4));
+}
+
+// trig: every way of getting sine and cosine of the angles in s, timed
+//	per angle (both values) and measured against libm in double
+typedef void(*a3_DemoMathFuncSinCos)(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier);
+
+// largest accepted error per tier: relative to one for the first two,
+//	in units in the last place for the full one
+static const double a3demo_mathBenchTrigBound[a3demo_trig_count] = { 6.0e-4, 2.0e-6, 4.0 };
+
+// A3DM table and libm in the same shape as the polynomials
+void a3demo_mathBenchSinCosTable(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier)
+{
+	*sin_out = a3sinr(x);
+	*cos_out = a3cosr(x);
+}
+
+void a3demo_mathBenchSinCosLibm(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier)
+{
+	*sin_out = (a3real)sin(x);
+	*cos_out = (a3real)cos(x);
+}
+
+// distance in units in the last place of the float nearest the reference
+double a3demo_mathBenchUlps(const double ref, const a3real got)
+{
+	int exponent;
+	frexp(ref, &exponent);
+	return fabs((double)got - ref) / ldexp(1.0, (exponent > -125 ? exponent : -125) - 24);
+}
+
+// errors of the results in sRef (sine) and sOut (cosine), then a line
+int a3demo_mathBenchTrigReport(a3_DemoMathBench *bench, const char *name, const double seconds, const int tier)
+{
+	const double calls = (double)bench->rounds * (double)a3demo_mathBenchItems;
+	double ulps = 0.0, error = 0.0, rs, rc;
+	unsigned int i;
+	int passed;
+	for (i = 0; i < a3demo_mathBenchItems; ++i)
+	{
+		rs = sin((double)bench->s[i]);
+		rc = cos((double)bench->s[i]);
+		ulps = a3maximum(ulps, a3demo_mathBenchUlps(rs, bench->sRef[i]));
+		ulps = a3maximum(ulps, a3demo_mathBenchUlps(rc, bench->sOut[i]));
+		error = a3maximum(error, fabs((double)bench->sRef[i] - rs));
+		error = a3maximum(error, fabs((double)bench->sOut[i] - rc));
+	}
+	passed = tier < 0 || (tier == a3demo_trig_full ? ulps : error) <= a3demo_mathBenchTrigBound[tier];
+	printf("\n  %-30s | %7.2f ns | %10.1f | %8.1e %s",
+		name, seconds * 1.0e9 / calls, ulps, error, tier < 0 ? "" : passed ? "ok  " : "FAIL");
+	return passed;
+}
+
+
+// one call per angle; tier -1 for the references, which are not judged
+int a3demo_mathBenchSinCos(a3_DemoMathBench *bench, const char *name, a3_DemoMathFuncSinCos func, const int tier)
+{
+	const a3_DemoTrigTier t = tier < 0 ? a3demo_trig_full : (a3_DemoTrigTier)tier;
+	double ts;
+	unsigned int r, i;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		for (i = 0; i < a3demo_mathBenchItems; ++i)
+			func(bench->s[i], bench->sRef + i, bench->sOut + i, t);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchTrigReport(bench, name, ts, tier);
+}
+
+
+int a3demo_mathBenchSinCosArray(a3_DemoMathBench *bench, const char *name, const a3_DemoTrigTier tier)
+{
+	double ts;
+	unsigned int r;
+	a3demo_mathBenchLap(bench->timer);
+	for (r = 0; r < bench->rounds; ++r)
+		a3demo_sinCosrArray(bench->sRef, bench->sOut, bench->s, a3demo_mathBenchItems, tier);
+	ts = a3demo_mathBenchLap(bench->timer);
+	return a3demo_mathBenchTrigReport(bench, name, ts, tier);
+}
+
+// random: each fill from the same seed alone and over the workers, which
+//	must agree bit for bit, and its moments against the distribution's
+typedef int(*a3_DemoMathFuncFill)(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, a3_DemoJobSystem *jobs);
+
+// items per fill, and the largest accepted difference of a mean or mean
+//	square from its expected value (about ten standard errors)
+#define a3demo_mathBenchRandomItems		(1u << 20)
+#define a3demo_mathBenchRandomTolerance	(1.0e-2)
+
+// the fills in one shape; uniform in [0, 1), standard normal, unit sphere
+int a3demo_mathBenchFillUniform(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, a3_DemoJobSystem *jobs)
+{
+	return a3demo_fillRandomUniform(x_out, rng, count, a3realZero, a3realOne, jobs);
+}
+
+int a3demo_mathBenchFillNormal(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, a3_DemoJobSystem *jobs)
+{
+	return a3demo_fillRandomNormal(x_out, rng, count, a3realZero, a3realOne, jobs);
+}
+
+int a3demo_mathBenchFillSphere(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, a3_DemoJobSystem *jobs)
+{
+	return a3demo_fillRandomSphere(x_out, y_out, z_out, rng, count, a3realOne, jobs);
+}
+
+// largest difference of the mean and mean square of each array from
+//	the expected ones
+double a3demo_mathBenchMoments(a3real *const v[3], const unsigned int arrays, const double mean, const double square)
+{
+	double m, q, error = 0.0;
+	unsigned int i, k;
+	for (k = 0; k < arrays; ++k)
+	{
+		m = q = 0.0;
+		for (i = 0; i < a3demo_mathBenchRandomItems; ++i)
+		{
+			m += (double)v[k][i];
+			q += (double)v[k][i] * (double)v[k][i];
+		}
+		m /= (double)a3demo_mathBenchRandomItems;
+		q /= (double)a3demo_mathBenchRandomItems;
+		error = a3maximum(error, a3maximum(fabs(m - mean), fabs(q - square)));
+	}
+	return error;
+}
+
+int a3demo_mathBenchFill(a3_Timer *timer, a3real *const serial[3], a3real *const parallel[3], const char *name, a3_DemoMathFuncFill fill, const unsigned int arrays, const double mean, const double square, a3_DemoJobSystem *jobs)
+{
+	a3_DemoRandom rng[1];
+	double ts, tp, error;
+	unsigned int k;
+	int same = 1, passed;
+
+	// once untimed, so both runs start warm
+	a3demo_seedRandom(rng, 2021);
+	fill(parallel[0], parallel[1], parallel[2], rng, a3demo_mathBenchRandomItems, jobs);
+
+	a3demo_seedRandom(rng, 2021);
+	a3demo_mathBenchLap(timer);
+	fill(serial[0], serial[1], serial[2], rng, a3demo_mathBenchRandomItems, 0);
+	ts = a3demo_mathBenchLap(timer);
+
+	a3demo_seedRandom(rng, 2021);
+	a3demo_mathBenchLap(timer);
+	fill(parallel[0], parallel[1], parallel[2], rng, a3demo_mathBenchRandomItems, jobs);
+	tp = a3demo_mathBenchLap(timer);
+
+	for (k = 0; k < arrays; ++k)
+		same &= !memcmp(serial[k], parallel[k], a3demo_mathBenchRandomItems * sizeof(a3real));
+	error = a3demo_mathBenchMoments(serial, arrays, mean, square);
+	passed = same && error <= a3demo_mathBenchRandomTolerance;
+	printf("\n  %-30s | %7.2f ms | %7.2f ms | %5.2fx | %8.1e %s %s",
+		name, ts * 1000.0, tp * 1000.0, tp > 0.0 ? ts / tp : 0.0, error, same ? "same" : "DIFF", passed ? "ok  " : "FAIL");
+	return passed;
+}
+
+//-----------------------------------------------------------------------------
+
+int a3demo_benchmarkSIMD(const unsigned int rounds)
+{
+	a3_DemoMathBench bench[1];
+	a3real4x4 projection;
+	int passed = 1;
+
+	if (!rounds || a3demo_mathBenchCreate(bench, rounds, 0) < 0)
+		return -1;
+
+	// a general (projective) matrix for the camera's side of the path,
+	//	on its own: the mR inputs stay affine for the transform kernels
+	a3real4x4SetIdentity(projection);
+	projection[2][3] = -a3realOne;
+	projection[3][2] = -a3realTwo;
+	projection[3][3] = a3realZero;
+	a3real4x4Product(bench->viewProjection, projection, bench->mR[1]);
+
+	a3timerSet(bench->timer, 0.0);
+	a3timerStart(bench->timer);
+
+	printf("\n SIMD MATH BENCHMARK (%s kernels, %u items x %u rounds)", a3demo_getSIMDName(), a3demo_mathBenchItems, rounds);
+	printf("\n  %-30s | %10s | %10s | %6s | %8s", "kernel", "A3DM", "kernel", "speed", "rel err");
+	passed &= a3demo_mathBenchSumDiff(bench, "real4Sum", a3real4Sum, a3demo_real4Sum);
+	passed &= a3demo_mathBenchSumDiff(bench, "real4Diff", a3real4Diff, a3demo_real4Diff);
+	passed &= a3demo_mathBenchProductS(bench, "real4ProductS", a3real4ProductS, a3demo_real4ProductS);
+	passed &= a3demo_mathBenchDot(bench, "real4Dot", a3real4Dot, a3demo_real4Dot);
+	passed &= a3demo_mathBenchNormalize(bench, "real4Normalize", a3real4Normalize, a3demo_real4Normalize);
+	passed &= a3demo_mathBenchMatrixVector(bench, "real4Real4x4ProductR", a3real4Real4x4ProductR, a3demo_real4Real4x4ProductR);
+	passed &= a3demo_mathBenchMatrixMatrix(bench, "real4x4Product", a3real4x4Product, a3demo_real4x4Product);
+	passed &= a3demo_mathBenchMatrixMatrix(bench, "real4x4ProductTransform", a3real4x4ProductTransform, a3demo_real4x4ProductTransform);
+	passed &= a3demo_mathBenchMatrix(bench, "real4x4GetTransposed", a3real4x4GetTransposed, a3demo_real4x4GetTransposed);
+	passed &= a3demo_mathBenchMatrix(bench, "real4x4TransformInverse", a3real4x4TransformInverse, a3demo_real4x4TransformInverse);
+	passed &= a3demo_mathBenchMatrix(bench, "real4x4TransformInverseIgnoreS", a3real4x4TransformInverseIgnoreScale, a3demo_real4x4TransformInverseIgnoreScale);
+	passed &= a3demo_mathBenchObjectPath(bench, "per object: model, inv, MVP");
+	printf("\n  batched, against one A3DM call per item:");
+	passed &= a3demo_mathBenchProductArray(bench, "VP x model, array");
+	passed &= a3demo_mathBenchInverseArray(bench, "inverse, array", 1);
+	passed &= a3demo_mathBenchInverseArray(bench, "inverse ignoring scale, array", 0);
+	passed &= a3demo_mathBenchPoints(bench, "points, strided xyz");
+	passed &= a3demo_mathBenchPointsSoA(bench, "points, x y z arrays");
+	a3timerStop(bench->timer);
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+
+	free(bench->memory);
+	return passed ? 1 : -1;
+}
+
+
+int a3demo_benchmarkQuaternion(const unsigned int rounds)
+{
+	const unsigned int quats = a3demo_mathBenchItems * sizeof(a3real4), duals = a3demo_mathBenchItems * sizeof(a3_DemoDualQuat);
+	a3_DemoMathBench bench[1];
+	a3_DemoMathBenchQuat quat[1];
+	a3real scale;
+	unsigned int i, k;
+	int passed = 1;
+
+	if (!rounds || a3demo_mathBenchCreate(bench, rounds, quats * 2 + duals * 2) < 0)
+		return -1;
+	quat->qL = (a3real4 *)bench->extra;
+	quat->qR = quat->qL + a3demo_mathBenchItems;
+	quat->dqL = (a3_DemoDualQuat *)(quat->qR + a3demo_mathBenchItems);
+	quat->dqR = quat->dqL + a3demo_mathBenchItems;
+
+	// rigid transforms from the angles in vL and vR, each moved by the
+	//	other's first three values, and a scaled copy of the left ones;
+	//	vR then doubles as the points
+	for (i = 0; i < a3demo_mathBenchItems; ++i)
+	{
+		a3demo_quatSetEulerZYX(quat->qL[i], a3demo_mathBenchAngles(bench->vL[i]));
+		a3demo_quatSetEulerZYX(quat->qR[i], a3demo_mathBenchAngles(bench->vR[i]));
+		a3demo_dualQuatSet(quat->dqL + i, quat->qL[i], bench->vR[i]);
+		a3demo_dualQuatSet(quat->dqR + i, quat->qR[i], bench->vL[i]);
+		a3real4x4SetRotateZYX(bench->mL[i], a3demo_mathBenchAngles(bench->vL[i]));
+		a3real4x4SetRotateZYX(bench->mR[i], a3demo_mathBenchAngles(bench->vR[i]));
+		memcpy(bench->mInvRef[i], bench->mL[i], sizeof(a3real4x4));
+		for (k = 0; k < 3; ++k)
+		{
+			bench->mL[i][3][k] = bench->vR[i][k];
+			bench->mR[i][3][k] = bench->vL[i][k];
+			scale = (a3real)pow(2.0, (double)a3demo_mathBenchRandom());
+			bench->mInvRef[i][k][0] *= scale;
+			bench->mInvRef[i][k][1] *= scale;
+			bench->mInvRef[i][k][2] *= scale;
+		}
+		bench->vR[i][3] = a3realOne;
+	}
+
+	a3timerSet(bench->timer, 0.0);
+	a3timerStart(bench->timer);
+
+	printf("\n QUATERNION BENCHMARK (%u items x %u rounds)", a3demo_mathBenchItems, rounds);
+	printf("\n  %-30s | %10s | %10s | %6s | %8s", "operation", "matrix", "quat", "speed", "rel err");
+	passed &= a3demo_mathBenchQuatEuler(bench, quat, "euler angles to matrix");
+	passed &= a3demo_mathBenchQuatMatrix(bench, quat, "matrix, angles unchanged");
+	passed &= a3demo_mathBenchQuatRoundTrip(bench, quat, "rotation out of scaled matrix");
+	passed &= a3demo_mathBenchQuatPoint(bench, quat, "rigid transform of a point");
+	passed &= a3demo_mathBenchQuatCompose(bench, quat, "rigid transforms composed");
+	printf("\n  slerp (left) against nlerp:");
+	passed &= a3demo_mathBenchQuatSlerp(bench, quat, "halfway between rotations");
+	a3timerStop(bench->timer);
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+
+	free(bench->memory);
+	return passed ? 1 : -1;
+}
+
+int a3demo_benchmarkTrig(const unsigned int rounds)
+{
+	static const char *tierName[a3demo_trig_count][2] = {
+		{ "fast, one at a time", "fast, batch" },
+		{ "medium, one at a time", "medium, batch" },
+		{ "full, one at a time", "full, batch" },
+	};
+	a3_DemoMathBench bench[1];
+	unsigned int i;
+	int passed = 1;
+
+	if (!rounds || a3demo_mathBenchCreate(bench, rounds, 0) < 0)
+		return -1;
+
+	// a full turn, the table's range
+	for (i = 0; i < a3demo_mathBenchItems; ++i)
+		bench->s[i] = (a3demo_mathBenchRandom() + a3realOne) * a3realPi;
+
+	a3timerSet(bench->timer, 0.0);
+	a3timerStart(bench->timer);
+
+	printf("\n TRIG BENCHMARK (%s batches, %u angles in [0, 2pi) x %u rounds)", a3demo_getSIMDName(), a3demo_mathBenchItems, rounds);
+	printf("\n  %-30s | %10s | %10s | %8s", "sine and cosine", "per angle", "max ulp", "max err");
+	a3demo_mathBenchSinCos(bench, "A3DM table (a3sinr, a3cosr)", a3demo_mathBenchSinCosTable, -1);
+	a3demo_mathBenchSinCos(bench, "libm (sin, cos)", a3demo_mathBenchSinCosLibm, -1);
+	for (i = 0; i < a3demo_trig_count; ++i)
+	{
+		passed &= a3demo_mathBenchSinCos(bench, tierName[i][0], a3demo_sinCosr, i);
+		passed &= a3demo_mathBenchSinCosArray(bench, tierName[i][1], (a3_DemoTrigTier)i);
+	}
+	a3timerStop(bench->timer);
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+
+	free(bench->memory);
+	return passed ? 1 : -1;
+}
+
+int a3demo_benchmarkRandomStreams(a3_DemoJobSystem *jobs)
+{
+	a3_Timer timer[1];
+	a3_DemoRandom rng[1];
+	a3real *serial[3], *parallel[3], *memory;
+	double t;
+	unsigned int i, k;
+	int passed = 1;
+
+	memory = (a3real *)malloc(a3demo_mathBenchRandomItems * 6 * sizeof(a3real));
+	if (!memory)
+		return -1;
+
+	// touch every page first so the fills are timed, not the page faults
+	memset(memory, 0, a3demo_mathBenchRandomItems * 6 * sizeof(a3real));
+	for (k = 0; k < 3; ++k)
+	{
+		serial[k] = memory + a3demo_mathBenchRandomItems * k;
+		parallel[k] = memory + a3demo_mathBenchRandomItems * (k + 3);
+	}
+
+	a3timerSet(timer, 0.0);
+	a3timerStart(timer);
+
+	printf("\n RANDOM BENCHMARK (%s, %u workers, %u items per fill)", a3demo_getSIMDName(), jobs ? jobs->workerCount : 1, a3demo_mathBenchRandomItems);
+
+	// one at a time, for scale: the C library's generator and a stream
+	srand(2021);
+	a3demo_mathBenchLap(timer);
+	for (i = 0; i < a3demo_mathBenchRandomItems; ++i)
+		serial[0][i] = (a3real)rand() / ((a3real)RAND_MAX + a3realOne);
+	t = a3demo_mathBenchLap(timer);
+	printf("\n  %-30s | %7.2f ms", "rand(), one at a time", t * 1000.0);
+	a3demo_seedRandom(rng, 2021);
+	a3demo_mathBenchLap(timer);
+	for (i = 0; i < a3demo_mathBenchRandomItems; ++i)
+		serial[0][i] = a3demo_randomUniform(rng);
+	t = a3demo_mathBenchLap(timer);
+	printf("\n  %-30s | %7.2f ms", "stream, one at a time", t * 1000.0);
+
+	printf("\n  %-30s | %10s | %10s | %6s | %8s", "bulk fill", "alone", "workers", "speed", "moments");
+	passed &= a3demo_mathBenchFill(timer, serial, parallel, "uniform [0, 1)", a3demo_mathBenchFillUniform, 1, 0.5, 1.0 / 3.0, jobs);
+	passed &= a3demo_mathBenchFill(timer, serial, parallel, "normal (0, 1)", a3demo_mathBenchFillNormal, 1, 0.0, 1.0, jobs);
+	passed &= a3demo_mathBenchFill(timer, serial, parallel, "unit sphere, x y z arrays", a3demo_mathBenchFillSphere, 3, 0.0, 1.0 / 3.0, jobs);
+	a3timerStop(timer);
+	printf("\n  %s\n", passed ? "done" : "FAILED");
+
+	free(memory);
+	return passed ? 1 : -1;
+}
+
+
+//-----------------------------------------------------------------------------
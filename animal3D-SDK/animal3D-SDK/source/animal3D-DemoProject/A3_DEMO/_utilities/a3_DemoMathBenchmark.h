@@ -0,0 +1,82 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoMathBenchmark.h
+	Console conformance check and benchmark for the math kernels.
+*/
+
+#ifndef __ANIMAL3D_DEMOMATHBENCHMARK_H
+#define __ANIMAL3D_DEMOMATHBENCHMARK_H
+
+
+#include "a3_DemoSIMD.h"
+#include "a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// every four-wide kernel against its A3DM namesake on random vectors
+	//	and affine transforms: largest difference relative to the
+	//	result's size, and time per call for both over the given rounds;
+	//	then the whole per-object path (model, its inverse and the
+	//	model-view-projection) as the demo runs it; last the batched
+	//	forms against one A3DM call per item
+	//	-> returns 1 if every kernel matched, -1 otherwise
+	int a3demo_benchmarkSIMD(const unsigned int rounds);
+
+	// the quaternion and dual quaternion routines against the matrix
+	//	work they replace: building from euler angles or from a kept
+	//	quaternion, the rotation out of a scaled matrix, rigid transforms
+	//	of points and of each other, and slerp checked against nlerp
+	//	halfway; time per call for both
+	//	-> returns 1 if every result matched, -1 otherwise
+	int a3demo_benchmarkQuaternion(const unsigned int rounds);
+
+	// sine and cosine over a full turn from the A3DM table, libm and each
+	//	polynomial tier alone and batched: time per angle, largest error
+	//	in units in the last place and absolute, against libm in double
+	//	-> returns 1 if every tier kept to its accuracy, -1 otherwise
+	int a3demo_benchmarkTrig(const unsigned int rounds);
+
+	// a million uniform, normal and on-sphere numbers from one seed,
+	//	filled alone and over the workers: time for both, whether they
+	//	agree bit for bit, and how far the means and mean squares are
+	//	from the distribution's; rand() and single draws for scale
+	//	-> returns 1 if every fill agreed and looked right, -1 otherwise
+	int a3demo_benchmarkRandomStreams(a3_DemoJobSystem *jobs);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOMATHBENCHMARK_H
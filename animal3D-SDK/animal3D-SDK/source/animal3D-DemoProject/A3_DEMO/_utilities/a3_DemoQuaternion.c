@@ -0,0 +1,448 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoQuaternion.c
+	Quaternion and dual quaternion implementation.
+*/
+
+#include "a3_DemoQuaternion.h"
+#include "a3_DemoTrig.h"
+
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// past this cosine two rotations are too close for slerp's division
+#define a3demo_quatSlerpLimit	((a3real)0.9995)
+
+inline a3real a3demo_quatDot(const a3real4p qL, const a3real4p qR)
+{
+	return qL[0] * qR[0] + qL[1] * qR[1] + qL[2] * qR[2] + qL[3] * qR[3];
+}
+
+// qL + qR s
+inline void a3demo_quatMulAdd(a3real4p q_out, const a3real4p qL, const a3real4p qR, const a3real s)
+{
+	q_out[0] = qL[0] + qR[0] * s;
+	q_out[1] = qL[1] + qR[1] * s;
+	q_out[2] = qL[2] + qR[2] * s;
+	q_out[3] = qL[3] + qR[3] * s;
+}
+
+// the translation quaternion (t, 0) times q
+inline void a3demo_quatPureProduct(a3real4p q_out, const a3real3p t, const a3real4p q)
+{
+	const a3real x = q[0], y = q[1], z = q[2], w = q[3];
+	q_out[0] = t[0] * w + t[1] * z - t[2] * y;
+	q_out[1] = t[1] * w + t[2] * x - t[0] * z;
+	q_out[2] = t[2] * w + t[0] * y - t[1] * x;
+	q_out[3] = -(t[0] * x + t[1] * y + t[2] * z);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3real4r a3demo_quatSetIdentity(a3real4p q_out)
+{
+	q_out[0] = q_out[1] = q_out[2] = a3realZero;
+	q_out[3] = a3realOne;
+	return q_out;
+}
+
+a3real4r a3demo_quatSetAxisAngle(a3real4p q_out, const a3real3p axis, const a3real degrees)
+{
+	const a3real half = a3deg2rad(degrees) * a3realHalf;
+	const a3real len = (a3real)sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	a3real s, c;
+	a3demo_sinCosr(half, &s, &c, a3demo_trig_full);
+	s = len > a3realZero ? s / len : a3realZero;
+	q_out[0] = axis[0] * s;
+	q_out[1] = axis[1] * s;
+	q_out[2] = axis[2] * s;
+	q_out[3] = c;
+	return q_out;
+}
+
+a3real4r a3demo_quatSetEulerZYX(a3real4p q_out, const a3real degrees_x, const a3real degrees_y, const a3real degrees_z)
+{
+	// qz qy qx multiplied out
+	const a3real hx = a3deg2rad(degrees_x) * a3realHalf, hy = a3deg2rad(degrees_y) * a3realHalf, hz = a3deg2rad(degrees_z) * a3realHalf;
+	a3real sx, cx, sy, cy, sz, cz;
+	a3demo_sinCosr(hx, &sx, &cx, a3demo_trig_full);
+	a3demo_sinCosr(hy, &sy, &cy, a3demo_trig_full);
+	a3demo_sinCosr(hz, &sz, &cz, a3demo_trig_full);
+	q_out[0] = cz * cy * sx - sz * sy * cx;
+	q_out[1] = cz * sy * cx + sz * cy * sx;
+	q_out[2] = sz * cy * cx - cz * sy * sx;
+	q_out[3] = cz * cy * cx + sz * sy * sx;
+	return q_out;
+}
+
+a3real a3demo_quatGetAxisAngle(a3real3p axis_out, const a3real4p q)
+{
+	const a3real w = q[3] > a3realOne ? a3realOne : q[3] < -a3realOne ? -a3realOne : q[3];
+	const a3real s = (a3real)sqrt(a3realOne - w * w);
+	if (s > (a3real)1.0e-6)
+	{
+		axis_out[0] = q[0] / s;
+		axis_out[1] = q[1] / s;
+		axis_out[2] = q[2] / s;
+	}
+	else
+	{
+		axis_out[0] = a3realOne;
+		axis_out[1] = axis_out[2] = a3realZero;
+	}
+	return a3rad2deg((a3real)acos(w) * a3realTwo);
+}
+
+
+a3real4r a3demo_quatProduct(a3real4p q_out, const a3real4p qL, const a3real4p qR)
+{
+	const a3real lx = qL[0], ly = qL[1], lz = qL[2], lw = qL[3];
+	const a3real rx = qR[0], ry = qR[1], rz = qR[2], rw = qR[3];
+	q_out[0] = lw * rx + rw * lx + ly * rz - lz * ry;
+	q_out[1] = lw * ry + rw * ly + lz * rx - lx * rz;
+	q_out[2] = lw * rz + rw * lz + lx * ry - ly * rx;
+	q_out[3] = lw * rw - lx * rx - ly * ry - lz * rz;
+	return q_out;
+}
+
+a3real4r a3demo_quatConjugate(a3real4p q_out, const a3real4p q)
+{
+	q_out[0] = -q[0];
+	q_out[1] = -q[1];
+	q_out[2] = -q[2];
+	q_out[3] = q[3];
+	return q_out;
+}
+
+a3real4r a3demo_quatNormalize(a3real4p q_inout)
+{
+	a3real len = (a3real)sqrt(a3demo_quatDot(q_inout, q_inout));
+	if (len > a3realZero)
+	{
+		len = a3recip(len);
+		q_inout[0] *= len;
+		q_inout[1] *= len;
+		q_inout[2] *= len;
+		q_inout[3] *= len;
+	}
+	return q_inout;
+}
+
+a3real3r a3demo_quatRotate(a3real3p v_out, const a3real4p q, const a3real3p v)
+{
+	// v + w t + u x t, where t = 2 u x v
+	const a3real x = q[0], y = q[1], z = q[2], w = q[3];
+	const a3real vx = v[0], vy = v[1], vz = v[2];
+	const a3real tx = a3realTwo * (y * vz - z * vy), ty = a3realTwo * (z * vx - x * vz), tz = a3realTwo * (x * vy - y * vx);
+	v_out[0] = vx + w * tx + (y * tz - z * ty);
+	v_out[1] = vy + w * ty + (z * tx - x * tz);
+	v_out[2] = vz + w * tz + (x * ty - y * tx);
+	return v_out;
+}
+
+
+a3real4r a3demo_quatNlerp(a3real4p q_out, const a3real4p q0, const a3real4p q1, const a3real t)
+{
+	const a3real s = a3demo_quatDot(q0, q1) < a3realZero ? -t : t;
+	a3real4 r;
+	r[0] = q0[0] * (a3realOne - t) + q1[0] * s;
+	r[1] = q0[1] * (a3realOne - t) + q1[1] * s;
+	r[2] = q0[2] * (a3realOne - t) + q1[2] * s;
+	r[3] = q0[3] * (a3realOne - t) + q1[3] * s;
+	q_out[0] = r[0];
+	q_out[1] = r[1];
+	q_out[2] = r[2];
+	q_out[3] = r[3];
+	return a3demo_quatNormalize(q_out);
+}
+
+a3real4r a3demo_quatSlerp(a3real4p q_out, const a3real4p q0, const a3real4p q1, const a3real t)
+{
+	a3real d = a3demo_quatDot(q0, q1), sign = a3realOne, angle, s, a, b;
+	a3real4 r;
+	if (d < a3realZero)
+	{
+		d = -d;
+		sign = -a3realOne;
+	}
+	if (d > a3demo_quatSlerpLimit)
+		return a3demo_quatNlerp(q_out, q0, q1, t);
+
+	angle = (a3real)acos(d);
+	s = a3recip(a3demo_sinr(angle, a3demo_trig_full));
+	a = a3demo_sinr((a3realOne - t) * angle, a3demo_trig_full) * s;
+	b = a3demo_sinr(t * angle, a3demo_trig_full) * s * sign;
+	r[0] = q0[0] * a + q1[0] * b;
+	r[1] = q0[1] * a + q1[1] * b;
+	r[2] = q0[2] * a + q1[2] * b;
+	r[3] = q0[3] * a + q1[3] * b;
+	q_out[0] = r[0];
+	q_out[1] = r[1];
+	q_out[2] = r[2];
+	q_out[3] = r[3];
+	return q_out;
+}
+
+a3real4r a3demo_quatIntegrate(a3real4p q_inout, const a3real3p angularVelocity, const a3real dt)
+{
+	// q += (w, 0) q dt / 2, then renormalize
+	a3real4 dq;
+	a3demo_quatPureProduct(dq, angularVelocity, q_inout);
+	q_inout[0] += dq[0] * a3realHalf * dt;
+	q_inout[1] += dq[1] * a3realHalf * dt;
+	q_inout[2] += dq[2] * a3realHalf * dt;
+	q_inout[3] += dq[3] * a3realHalf * dt;
+	return a3demo_quatNormalize(q_inout);
+}
+
+
+a3real3x3r a3demo_real3x3SetQuat(a3real3x3p m_out, const a3real4p q)
+{
+	const a3real x = q[0], y = q[1], z = q[2], w = q[3];
+	m_out[0][0] = a3realOne - a3realTwo * (y * y + z * z);
+	m_out[0][1] = a3realTwo * (x * y + w * z);
+	m_out[0][2] = a3realTwo * (x * z - w * y);
+	m_out[1][0] = a3realTwo * (x * y - w * z);
+	m_out[1][1] = a3realOne - a3realTwo * (x * x + z * z);
+	m_out[1][2] = a3realTwo * (y * z + w * x);
+	m_out[2][0] = a3realTwo * (x * z + w * y);
+	m_out[2][1] = a3realTwo * (y * z - w * x);
+	m_out[2][2] = a3realOne - a3realTwo * (x * x + y * y);
+	return m_out;
+}
+
+a3real4x4r a3demo_real4x4SetQuat(a3real4x4p m_out, const a3real4p q)
+{
+	const a3real x = q[0], y = q[1], z = q[2], w = q[3];
+	m_out[0][0] = a3realOne - a3realTwo * (y * y + z * z);
+	m_out[0][1] = a3realTwo * (x * y + w * z);
+	m_out[0][2] = a3realTwo * (x * z - w * y);
+	m_out[1][0] = a3realTwo * (x * y - w * z);
+	m_out[1][1] = a3realOne - a3realTwo * (x * x + z * z);
+	m_out[1][2] = a3realTwo * (y * z + w * x);
+	m_out[2][0] = a3realTwo * (x * z + w * y);
+	m_out[2][1] = a3realTwo * (y * z - w * x);
+	m_out[2][2] = a3realOne - a3realTwo * (x * x + y * y);
+	m_out[0][3] = m_out[1][3] = m_out[2][3] = a3realZero;
+	m_out[3][0] = m_out[3][1] = m_out[3][2] = a3realZero;
+	m_out[3][3] = a3realOne;
+	return m_out;
+}
+
+a3real4r a3demo_quatSetReal3x3(a3real4p q_out, const a3real3x3p m)
+{
+	// unit axes, then whichever of w, x, y or z is largest is found from
+	//	the diagonal and the others from the off-diagonal pairs
+	a3real3x3 r;
+	a3real s;
+	unsigned int j;
+	for (j = 0; j < 3; ++j)
+	{
+		s = (a3real)sqrt(m[j][0] * m[j][0] + m[j][1] * m[j][1] + m[j][2] * m[j][2]);
+		s = s > a3realZero ? a3recip(s) : a3realZero;
+		r[j][0] = m[j][0] * s;
+		r[j][1] = m[j][1] * s;
+		r[j][2] = m[j][2] * s;
+	}
+
+	if (r[0][0] + r[1][1] + r[2][2] > a3realZero)
+	{
+		s = (a3real)sqrt(a3realOne + r[0][0] + r[1][1] + r[2][2]) * a3realTwo;
+		q_out[3] = s * (a3real)0.25;
+		s = a3recip(s);
+		q_out[0] = (r[1][2] - r[2][1]) * s;
+		q_out[1] = (r[2][0] - r[0][2]) * s;
+		q_out[2] = (r[0][1] - r[1][0]) * s;
+	}
+	else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+	{
+		s = (a3real)sqrt(a3realOne + r[0][0] - r[1][1] - r[2][2]) * a3realTwo;
+		q_out[0] = s * (a3real)0.25;
+		s = a3recip(s);
+		q_out[1] = (r[1][0] + r[0][1]) * s;
+		q_out[2] = (r[2][0] + r[0][2]) * s;
+		q_out[3] = (r[1][2] - r[2][1]) * s;
+	}
+	else if (r[1][1] > r[2][2])
+	{
+		s = (a3real)sqrt(a3realOne + r[1][1] - r[0][0] - r[2][2]) * a3realTwo;
+		q_out[1] = s * (a3real)0.25;
+		s = a3recip(s);
+		q_out[0] = (r[1][0] + r[0][1]) * s;
+		q_out[2] = (r[2][1] + r[1][2]) * s;
+		q_out[3] = (r[2][0] - r[0][2]) * s;
+	}
+	else
+	{
+		s = (a3real)sqrt(a3realOne + r[2][2] - r[0][0] - r[1][1]) * a3realTwo;
+		q_out[2] = s * (a3real)0.25;
+		s = a3recip(s);
+		q_out[0] = (r[2][0] + r[0][2]) * s;
+		q_out[1] = (r[2][1] + r[1][2]) * s;
+		q_out[3] = (r[0][1] - r[1][0]) * s;
+	}
+	return a3demo_quatNormalize(q_out);
+}
+
+a3real4r a3demo_quatSetReal4x4(a3real4p q_out, const a3real4x4p m)
+{
+	a3real3x3 r;
+	unsigned int j;
+	for (j = 0; j < 3; ++j)
+	{
+		r[j][0] = m[j][0];
+		r[j][1] = m[j][1];
+		r[j][2] = m[j][2];
+	}
+	return a3demo_quatSetReal3x3(q_out, r);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3_DemoDualQuat *a3demo_dualQuatSetIdentity(a3_DemoDualQuat *dq_out)
+{
+	a3demo_quatSetIdentity(dq_out->r);
+	dq_out->d[0] = dq_out->d[1] = dq_out->d[2] = dq_out->d[3] = a3realZero;
+	return dq_out;
+}
+
+a3_DemoDualQuat *a3demo_dualQuatSet(a3_DemoDualQuat *dq_out, const a3real4p rotation, const a3real3p translation)
+{
+	// d = (t, 0) r / 2
+	a3real4 d;
+	a3demo_quatPureProduct(d, translation, rotation);
+	dq_out->r[0] = rotation[0];
+	dq_out->r[1] = rotation[1];
+	dq_out->r[2] = rotation[2];
+	dq_out->r[3] = rotation[3];
+	dq_out->d[0] = d[0] * a3realHalf;
+	dq_out->d[1] = d[1] * a3realHalf;
+	dq_out->d[2] = d[2] * a3realHalf;
+	dq_out->d[3] = d[3] * a3realHalf;
+	return dq_out;
+}
+
+a3real3r a3demo_dualQuatGetTranslation(a3real3p translation_out, const a3_DemoDualQuat *dq)
+{
+	// vector part of 2 d r*
+	a3real4 c, t;
+	a3demo_quatProduct(t, dq->d, a3demo_quatConjugate(c, dq->r));
+	translation_out[0] = t[0] * a3realTwo;
+	translation_out[1] = t[1] * a3realTwo;
+	translation_out[2] = t[2] * a3realTwo;
+	return translation_out;
+}
+
+a3_DemoDualQuat *a3demo_dualQuatProduct(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dqL, const a3_DemoDualQuat *dqR)
+{
+	// (Lr, Ld)(Rr, Rd) = (Lr Rr, Lr Rd + Ld Rr)
+	a3real4 r, d, e;
+	a3demo_quatProduct(r, dqL->r, dqR->r);
+	a3demo_quatProduct(d, dqL->r, dqR->d);
+	a3demo_quatProduct(e, dqL->d, dqR->r);
+	dq_out->r[0] = r[0];
+	dq_out->r[1] = r[1];
+	dq_out->r[2] = r[2];
+	dq_out->r[3] = r[3];
+	a3demo_quatMulAdd(dq_out->d, d, e, a3realOne);
+	return dq_out;
+}
+
+a3_DemoDualQuat *a3demo_dualQuatConjugate(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dq)
+{
+	a3demo_quatConjugate(dq_out->r, dq->r);
+	a3demo_quatConjugate(dq_out->d, dq->d);
+	return dq_out;
+}
+
+a3_DemoDualQuat *a3demo_dualQuatNormalize(a3_DemoDualQuat *dq_inout)
+{
+	// unit rotation, and the dual part made perpendicular to it again
+	a3real len = (a3real)sqrt(a3demo_quatDot(dq_inout->r, dq_inout->r));
+	if (len > a3realZero)
+	{
+		len = a3recip(len);
+		dq_inout->r[0] *= len;
+		dq_inout->r[1] *= len;
+		dq_inout->r[2] *= len;
+		dq_inout->r[3] *= len;
+		dq_inout->d[0] *= len;
+		dq_inout->d[1] *= len;
+		dq_inout->d[2] *= len;
+		dq_inout->d[3] *= len;
+		a3demo_quatMulAdd(dq_inout->d, dq_inout->d, dq_inout->r, -a3demo_quatDot(dq_inout->r, dq_inout->d));
+	}
+	return dq_inout;
+}
+
+a3real3r a3demo_dualQuatTransformPoint(a3real3p v_out, const a3_DemoDualQuat *dq, const a3real3p v)
+{
+	a3real3 t;
+	a3demo_dualQuatGetTranslation(t, dq);
+	a3demo_quatRotate(v_out, dq->r, v);
+	v_out[0] += t[0];
+	v_out[1] += t[1];
+	v_out[2] += t[2];
+	return v_out;
+}
+
+int a3demo_dualQuatBlend(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dq, const a3real *weight, const unsigned int count)
+{
+	if (dq_out && dq && weight && count)
+	{
+		a3_DemoDualQuat b;
+		a3real w;
+		unsigned int i;
+		b.r[0] = b.r[1] = b.r[2] = b.r[3] = a3realZero;
+		b.d[0] = b.d[1] = b.d[2] = b.d[3] = a3realZero;
+		for (i = 0; i < count; ++i)
+		{
+			w = a3demo_quatDot(dq[i].r, dq->r) < a3realZero ? -weight[i] : weight[i];
+			a3demo_quatMulAdd(b.r, b.r, dq[i].r, w);
+			a3demo_quatMulAdd(b.d, b.d, dq[i].d, w);
+		}
+		if (a3demo_quatDot(b.r, b.r) <= (a3real)1.0e-12)
+			return 0;
+		*dq_out = b;
+		a3demo_dualQuatNormalize(dq_out);
+		return count;
+	}
+	return -1;
+}
+
+a3real4x4r a3demo_real4x4SetDualQuat(a3real4x4p m_out, const a3_DemoDualQuat *dq)
+{
+	a3real3 t;
+	a3demo_dualQuatGetTranslation(t, dq);
+	a3demo_real4x4SetQuat(m_out, dq->r);
+	m_out[3][0] = t[0];
+	m_out[3][1] = t[1];
+	m_out[3][2] = t[2];
+	return m_out;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,131 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoQuaternion.h
+	Rotation quaternions and dual quaternions (rotation with translation)
+		in the style of the A3DM vector and matrix routines: composing,
+		blending and converting to and from matrices without going
+		through Euler angles.
+*/
+
+#ifndef __ANIMAL3D_DEMOQUATERNION_H
+#define __ANIMAL3D_DEMOQUATERNION_H
+
+
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoDualQuat	a3_DemoDualQuat;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// quaternions are a3real4 stored (x, y, z, w), w being the real part,
+	//	as rigid body orientations are; angles are in degrees as in A3DM,
+	//	and matrices are column-major with the axes as columns
+
+	// rigid transform: rotation r and translation folded into d
+	struct a3_DemoDualQuat
+	{
+		a3real4 r;						// rotation, unit
+		a3real4 d;						// half the translation times r
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// setup; euler angles apply X first, then Y, then Z, the same rotation
+	//	as a3real4x4SetRotateZYX
+	a3real4r a3demo_quatSetIdentity(a3real4p q_out);
+	a3real4r a3demo_quatSetAxisAngle(a3real4p q_out, const a3real3p axis, const a3real degrees);
+	a3real4r a3demo_quatSetEulerZYX(a3real4p q_out, const a3real degrees_x, const a3real degrees_y, const a3real degrees_z);
+
+	// angle in degrees (0 to 360) and unit axis; any axis for no rotation
+	a3real a3demo_quatGetAxisAngle(a3real3p axis_out, const a3real4p q);
+
+	// the product applies qR first, then qL, as matrices do; outputs may
+	//	alias inputs
+	a3real4r a3demo_quatProduct(a3real4p q_out, const a3real4p qL, const a3real4p qR);
+	a3real4r a3demo_quatConjugate(a3real4p q_out, const a3real4p q);
+	a3real4r a3demo_quatNormalize(a3real4p q_inout);
+
+	// rotate a vector (v_out may be v)
+	a3real3r a3demo_quatRotate(a3real3p v_out, const a3real4p q, const a3real3p v);
+
+	// blends along the shorter way round; nlerp is a normalized straight
+	//	blend (cheap, uneven speed), slerp keeps the angular speed even
+	a3real4r a3demo_quatNlerp(a3real4p q_out, const a3real4p q0, const a3real4p q1, const a3real t);
+	a3real4r a3demo_quatSlerp(a3real4p q_out, const a3real4p q0, const a3real4p q1, const a3real t);
+
+	// one step of angular velocity (radians per second, world frame),
+	//	first order and renormalized, with no trig
+	a3real4r a3demo_quatIntegrate(a3real4p q_inout, const a3real3p angularVelocity, const a3real dt);
+
+	// matrices: rotation only, the rest of a 4x4 set to identity
+	a3real3x3r a3demo_real3x3SetQuat(a3real3x3p m_out, const a3real4p q);
+	a3real4x4r a3demo_real4x4SetQuat(a3real4x4p m_out, const a3real4p q);
+
+	// back from a rotation; scaled axes are normalized first
+	a3real4r a3demo_quatSetReal3x3(a3real4p q_out, const a3real3x3p m);
+	a3real4r a3demo_quatSetReal4x4(a3real4p q_out, const a3real4x4p m);
+
+
+//-----------------------------------------------------------------------------
+
+	// dual quaternions: rigid transforms that compose and blend like
+	//	quaternions, e.g. for skinning without the candy-wrapper collapse
+	//	of blended matrices
+	a3_DemoDualQuat *a3demo_dualQuatSetIdentity(a3_DemoDualQuat *dq_out);
+	a3_DemoDualQuat *a3demo_dualQuatSet(a3_DemoDualQuat *dq_out, const a3real4p rotation, const a3real3p translation);
+	a3real3r a3demo_dualQuatGetTranslation(a3real3p translation_out, const a3_DemoDualQuat *dq);
+
+	// dqR first, then dqL; outputs may alias inputs
+	a3_DemoDualQuat *a3demo_dualQuatProduct(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dqL, const a3_DemoDualQuat *dqR);
+	a3_DemoDualQuat *a3demo_dualQuatConjugate(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dq);
+	a3_DemoDualQuat *a3demo_dualQuatNormalize(a3_DemoDualQuat *dq_inout);
+
+	// a point through the transform (v_out may be v)
+	a3real3r a3demo_dualQuatTransformPoint(a3real3p v_out, const a3_DemoDualQuat *dq, const a3real3p v);
+
+	// weighted blend of transforms, each flipped onto the first one's
+	//	side, then normalized (dual quaternion linear blending)
+	//	-> returns count, 0 if the weights cancel out, -1 if invalid params
+	int a3demo_dualQuatBlend(a3_DemoDualQuat *dq_out, const a3_DemoDualQuat *dq, const a3real *weight, const unsigned int count);
+
+	// as a model matrix
+	a3real4x4r a3demo_real4x4SetDualQuat(a3real4x4p m_out, const a3_DemoDualQuat *dq);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOQUATERNION_H
@@ -0,0 +1,366 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRandom.c
+	Random number stream implementation.
+*/
+
+#include "a3_DemoRandom.h"
+#include "a3_DemoTrig.h"
+#include "a3_DemoSIMDLane.h"
+
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// random internal constants
+enum a3_DemoRandomInternal
+{
+	a3demo_randomScratch = 256,		// items per batch inside a block (stack)
+};
+
+// 24 random bits to [0, 1)
+#define a3demo_randomUnit		((a3real)(1.0 / 16777216.0))
+
+
+// a bulk fill: one pass of blocks, each with its own stream, and where
+//	and how they are written
+typedef struct a3_DemoRandomFill a3_DemoRandomFill;
+typedef void(*a3_DemoRandomBlockFunc)(const a3_DemoRandomFill *fill, a3_DemoRandom *rng, const unsigned int first, const unsigned int count);
+struct a3_DemoRandomFill
+{
+	a3_DemoRandom stream[a3demo_randomPass];
+	a3_DemoRandomBlockFunc block;
+	a3real *out[3];
+	a3real a, b;					// distribution parameters
+	unsigned int first, count;		// items in this pass
+};
+
+
+inline unsigned long long a3demo_randomRotate(const unsigned long long x, const int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256++ step
+inline unsigned long long a3demo_randomNext(unsigned long long *s)
+{
+	const unsigned long long result = a3demo_randomRotate(s[0] + s[3], 23) + s[0];
+	const unsigned long long t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = a3demo_randomRotate(s[3], 45);
+	return result;
+}
+
+// splitmix64 step, to spread a seed over the state
+inline unsigned long long a3demo_randomSplitMix(unsigned long long *x)
+{
+	unsigned long long z = (*x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+// both 24-bit halves of a draw
+inline a3real a3demo_randomHigh(const unsigned long long bits)
+{
+	return (a3real)(unsigned int)(bits >> 40) * a3demo_randomUnit;
+}
+
+inline a3real a3demo_randomLow(const unsigned long long bits)
+{
+	return (a3real)((unsigned int)(bits >> 8) & 0xffffffu) * a3demo_randomUnit;
+}
+
+// count uniform numbers in [0, 1), two per draw
+inline void a3demo_randomUnits(a3real *out, a3_DemoRandom *rng, const unsigned int count)
+{
+	unsigned long long bits;
+	unsigned int i;
+	for (i = 0; i + 1 < count; i += 2)
+	{
+		bits = a3demo_randomNext(rng->state);
+		out[i] = a3demo_randomHigh(bits);
+		out[i + 1] = a3demo_randomLow(bits);
+	}
+	if (i < count)
+		out[i] = a3demo_randomHigh(a3demo_randomNext(rng->state));
+}
+
+// v * scale + offset in place, a lane at a time where there are lanes
+inline void a3demo_randomScale(a3real *v, const unsigned int count, const a3real scale, const a3real offset)
+{
+	unsigned int i = 0;
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	const a3_DemoSIMDLane s = a3demo_simdSet(scale), o = a3demo_simdSet(offset);
+	for (; i + 4 <= count; i += 4)
+		a3demo_simdStore(v + i, a3demo_simdAdd(a3demo_simdMul(a3demo_simdLoad(v + i), s), o));
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	for (; i < count; ++i)
+		v[i] = v[i] * scale + offset;
+}
+
+
+// block kernels: count items from first, all from the block's stream
+
+void a3demo_randomBlockUniform(const a3_DemoRandomFill *fill, a3_DemoRandom *rng, const unsigned int first, const unsigned int count)
+{
+	a3real *const out = fill->out[0] + first;
+	a3demo_randomUnits(out, rng, count);
+	a3demo_randomScale(out, count, fill->b - fill->a, fill->a);
+}
+
+void a3demo_randomBlockNormal(const a3_DemoRandomFill *fill, a3_DemoRandom *rng, const unsigned int first, const unsigned int count)
+{
+	a3real u[a3demo_randomScratch], s[a3demo_randomScratch / 2], c[a3demo_randomScratch / 2];
+	a3real *const out = fill->out[0] + first;
+	unsigned int i, j, n, pairs;
+	for (i = 0; i < count; i += n)
+	{
+		n = a3minimum(count - i, a3demo_randomScratch);
+		pairs = (n + 1) / 2;
+
+		// radii from the first half of the numbers (1 - u is never zero),
+		//	angles from the second
+		a3demo_randomUnits(u, rng, pairs * 2);
+		for (j = 0; j < pairs; ++j)
+		{
+			u[j] = fill->b * (a3real)sqrtf(-2.0f * logf(a3realOne - u[j]));
+			u[pairs + j] *= a3realTwoPi;
+		}
+		a3demo_sinCosrArray(s, c, u + pairs, pairs, a3demo_trig_full);
+
+		for (j = 0; j + 1 < n; j += 2)
+		{
+			out[i + j] = fill->a + u[j / 2] * c[j / 2];
+			out[i + j + 1] = fill->a + u[j / 2] * s[j / 2];
+		}
+		if (j < n)
+			out[i + j] = fill->a + u[j / 2] * c[j / 2];
+	}
+}
+
+void a3demo_randomBlockSphere(const a3_DemoRandomFill *fill, a3_DemoRandom *rng, const unsigned int first, const unsigned int count)
+{
+	a3real *const x = fill->out[0] + first, *const y = fill->out[1] + first, *const z = fill->out[2] + first;
+	a3real u[a3demo_randomScratch];
+	unsigned int i, j, n;
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	const a3_DemoSIMDLane one = a3demo_simdSet(a3realOne), radius = a3demo_simdSet(fill->a);
+	a3_DemoSIMDLane h, r;
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	for (i = 0; i < count; i += n)
+	{
+		n = a3minimum(count - i, a3demo_randomScratch / 2);
+
+		// height uniform in [-1, 1) (equal areas, Archimedes), angle
+		//	uniform around it
+		a3demo_randomUnits(u, rng, n * 2);
+		a3demo_randomScale(u, n, a3realTwo, -a3realOne);
+		a3demo_randomScale(u + n, n, a3realTwoPi, a3realZero);
+		a3demo_sinCosrArray(y + i, x + i, u + n, n, a3demo_trig_full);
+
+		// scale the circle to the height's ring
+		j = 0;
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+		for (; j + 4 <= n; j += 4)
+		{
+			h = a3demo_simdLoad(u + j);
+			r = a3demo_simdMul(radius, a3demo_simdSqrt(a3demo_simdSub(one, a3demo_simdMul(h, h))));
+			a3demo_simdStore(x + i + j, a3demo_simdMul(a3demo_simdLoad(x + i + j), r));
+			a3demo_simdStore(y + i + j, a3demo_simdMul(a3demo_simdLoad(y + i + j), r));
+			a3demo_simdStore(z + i + j, a3demo_simdMul(radius, h));
+		}
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+		for (; j < n; ++j)
+		{
+			u[n + j] = fill->a * (a3real)sqrtf(a3realOne - u[j] * u[j]);
+			x[i + j] *= u[n + j];
+			y[i + j] *= u[n + j];
+			z[i + j] = fill->a * u[j];
+		}
+	}
+}
+
+
+// job: a range of blocks in the current pass
+void a3demo_randomFillJob(a3_DemoRandomFill *fill, const unsigned int first, const unsigned int count)
+{
+	unsigned int b, i;
+	for (b = first; b < first + count; ++b)
+	{
+		i = b * a3demo_randomBlock;
+		fill->block(fill, fill->stream + b, fill->first + i, a3minimum(fill->count - i, a3demo_randomBlock));
+	}
+}
+
+// hand out the streams a pass at a time; the split only depends on count
+int a3demo_randomFill(a3_DemoRandomFill *fill, a3_DemoRandom *rng, const unsigned int count, a3_DemoJobSystem *jobs)
+{
+	unsigned int blocks;
+	for (fill->first = 0; fill->first < count; fill->first += fill->count)
+	{
+		fill->count = a3minimum(count - fill->first, a3demo_randomBlock * a3demo_randomPass);
+		blocks = (fill->count + a3demo_randomBlock - 1) / a3demo_randomBlock;
+		a3demo_splitRandom(fill->stream, rng, blocks);
+		a3demo_parallelFor(jobs, (a3_DemoJobFunc)a3demo_randomFillJob, fill, blocks, 1);
+	}
+	return count;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_seedRandom(a3_DemoRandom *rng, const unsigned long long seed)
+{
+	if (rng)
+	{
+		unsigned long long x = seed;
+		rng->state[0] = a3demo_randomSplitMix(&x);
+		rng->state[1] = a3demo_randomSplitMix(&x);
+		rng->state[2] = a3demo_randomSplitMix(&x);
+		rng->state[3] = a3demo_randomSplitMix(&x);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_jumpRandom(a3_DemoRandom *rng)
+{
+	// the step polynomial raised to 2^128, applied bit by bit
+	static const unsigned long long jump[4] = {
+		0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull,
+	};
+	if (rng)
+	{
+		unsigned long long s[4] = { 0 };
+		unsigned int i, b;
+		for (i = 0; i < 4; ++i)
+			for (b = 0; b < 64; ++b)
+			{
+				if (jump[i] & (1ull << b))
+				{
+					s[0] ^= rng->state[0];
+					s[1] ^= rng->state[1];
+					s[2] ^= rng->state[2];
+					s[3] ^= rng->state[3];
+				}
+				a3demo_randomNext(rng->state);
+			}
+		rng->state[0] = s[0];
+		rng->state[1] = s[1];
+		rng->state[2] = s[2];
+		rng->state[3] = s[3];
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_splitRandom(a3_DemoRandom *streams_out, a3_DemoRandom *source, const unsigned int count)
+{
+	if (streams_out && source)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+		{
+			streams_out[i] = *source;
+			a3demo_jumpRandom(source);
+		}
+		return count;
+	}
+	return -1;
+}
+
+
+unsigned long long a3demo_randomBits(a3_DemoRandom *rng)
+{
+	return a3demo_randomNext(rng->state);
+}
+
+a3real a3demo_randomUniform(a3_DemoRandom *rng)
+{
+	return a3demo_randomHigh(a3demo_randomNext(rng->state));
+}
+
+a3real a3demo_randomRange(a3_DemoRandom *rng, const a3real lo, const a3real hi)
+{
+	return lo + (hi - lo) * a3demo_randomHigh(a3demo_randomNext(rng->state));
+}
+
+a3real a3demo_randomNormal(a3_DemoRandom *rng)
+{
+	// one Box-Muller pair from the two halves of a draw, half of it used
+	const unsigned long long bits = a3demo_randomNext(rng->state);
+	const a3real r = (a3real)sqrtf(-2.0f * logf(a3realOne - a3demo_randomHigh(bits)));
+	return r * a3demo_cosr(a3demo_randomLow(bits) * a3realTwoPi, a3demo_trig_full);
+}
+
+
+int a3demo_fillRandomUniform(a3real *out, a3_DemoRandom *rng, const unsigned int count, const a3real lo, const a3real hi, a3_DemoJobSystem *jobs)
+{
+	if (out && rng)
+	{
+		a3_DemoRandomFill fill[1];
+		fill->block = a3demo_randomBlockUniform;
+		fill->out[0] = out;
+		fill->a = lo;
+		fill->b = hi;
+		return a3demo_randomFill(fill, rng, count, jobs);
+	}
+	return -1;
+}
+
+int a3demo_fillRandomNormal(a3real *out, a3_DemoRandom *rng, const unsigned int count, const a3real mean, const a3real deviation, a3_DemoJobSystem *jobs)
+{
+	if (out && rng)
+	{
+		a3_DemoRandomFill fill[1];
+		fill->block = a3demo_randomBlockNormal;
+		fill->out[0] = out;
+		fill->a = mean;
+		fill->b = deviation;
+		return a3demo_randomFill(fill, rng, count, jobs);
+	}
+	return -1;
+}
+
+int a3demo_fillRandomSphere(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, const a3real radius, a3_DemoJobSystem *jobs)
+{
+	if (x_out && y_out && z_out && rng)
+	{
+		a3_DemoRandomFill fill[1];
+		fill->block = a3demo_randomBlockSphere;
+		fill->out[0] = x_out;
+		fill->out[1] = y_out;
+		fill->out[2] = z_out;
+		fill->a = radius;
+		return a3demo_randomFill(fill, rng, count, jobs);
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
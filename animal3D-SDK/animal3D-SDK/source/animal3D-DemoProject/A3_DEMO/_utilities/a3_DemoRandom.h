@@ -0,0 +1,115 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRandom.h
+	Random number streams (xoshiro256++): each stream is a small value
+		that any thread can own, copy or save, streams split from one seed
+		by jumping ahead, and bulk fills that come out the same however
+		many workers share them.
+*/
+
+#ifndef __ANIMAL3D_DEMORANDOM_H
+#define __ANIMAL3D_DEMORANDOM_H
+
+
+#include "animal3D/a3math/A3DM.h"
+#include "a3_DemoJobSystem.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoRandom	a3_DemoRandom;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// random constants
+	enum a3_DemoRandomConstants
+	{
+		a3demo_randomBlock = 8192,		// items per stream in bulk fills
+		a3demo_randomPass = 64,			// blocks handed to the workers at once
+	};
+
+
+	// one stream; never all zero once seeded
+	struct a3_DemoRandom
+	{
+		unsigned long long state[4];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// start a stream from one number; the number is spread over the whole
+	//	state first (splitmix64), so neighbouring seeds are unrelated
+	int a3demo_seedRandom(a3_DemoRandom *rng, const unsigned long long seed);
+
+	// skip 2^128 draws: each jump starts a stream that no realistic run of
+	//	the one before it will reach
+	int a3demo_jumpRandom(a3_DemoRandom *rng);
+
+	// one stream each for count users (e.g. one per worker): stream i is
+	//	the source jumped i times, and the source is left jumped count
+	//	times so it can be split again
+	//	-> returns count, -1 if invalid params
+	int a3demo_splitRandom(a3_DemoRandom *streams_out, a3_DemoRandom *source, const unsigned int count);
+
+
+	// single draws: 64 random bits, uniform in [0, 1) (24 bits, so
+	//	exactly representable and never one), uniform in [lo, hi), and
+	//	normal with mean zero and deviation one
+	unsigned long long a3demo_randomBits(a3_DemoRandom *rng);
+	a3real a3demo_randomUniform(a3_DemoRandom *rng);
+	a3real a3demo_randomRange(a3_DemoRandom *rng, const a3real lo, const a3real hi);
+	a3real a3demo_randomNormal(a3_DemoRandom *rng);
+
+
+	// bulk fills: the items are cut into blocks of a3demo_randomBlock, and
+	//	block b is drawn from the source jumped b times, so the numbers
+	//	only depend on the source and the count; blocks are spread over
+	//	jobs (null runs them all here), and the source is left jumped once
+	//	per block
+	//	-> each returns count, -1 if invalid params
+
+	// uniform in [lo, hi)
+	int a3demo_fillRandomUniform(a3real *out, a3_DemoRandom *rng, const unsigned int count, const a3real lo, const a3real hi, a3_DemoJobSystem *jobs);
+
+	// normal with the given mean and deviation (Box-Muller, in pairs)
+	int a3demo_fillRandomNormal(a3real *out, a3_DemoRandom *rng, const unsigned int count, const a3real mean, const a3real deviation, a3_DemoJobSystem *jobs);
+
+	// uniform on the surface of a sphere of the given radius about the
+	//	origin, into separate x, y and z arrays
+	int a3demo_fillRandomSphere(a3real *x_out, a3real *y_out, a3real *z_out, a3_DemoRandom *rng, const unsigned int count, const a3real radius, a3_DemoJobSystem *jobs);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMORANDOM_H
@@ -0,0 +1,485 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSIMD.c
+	Four-wide vector and matrix kernels.
+*/
+
+#include "a3_DemoSIMD.h"
+#include "a3_DemoSIMDLane.h"
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+
+// multiply to zero the w of an axis, and the w axis of a transform
+static const float a3demo_simdMaskW[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+static const float a3demo_simdUnitW[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+#if defined(A3_SIMD_NEON)
+#if !defined(__aarch64__) && !defined(_M_ARM64)
+// ARMv7 NEON has only estimates for these; two refinement steps bring
+//	them to within a unit or so in the last place
+inline float32x4_t a3demo_neonRecip(const float32x4_t a)
+{
+	float32x4_t r = vrecpeq_f32(a);
+	r = vmulq_f32(r, vrecpsq_f32(a, r));
+	return vmulq_f32(r, vrecpsq_f32(a, r));
+}
+
+inline float32x4_t a3demo_neonSqrt(const float32x4_t a)
+{
+	float32x4_t r = vrsqrteq_f32(a);
+	r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+	r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+	return vmulq_f32(a, r);
+}
+#endif	// !__aarch64__
+
+inline void a3demo_neonTranspose(float32x4_t *a, float32x4_t *b, float32x4_t *c, float32x4_t *d)
+{
+	const float32x4x2_t ab = vtrnq_f32(*a, *b), cd = vtrnq_f32(*c, *d);
+	*a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+	*b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+	*c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+	*d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+#endif	// A3_SIMD_NEON
+
+// dot product in every lane
+inline a3_DemoSIMDLane a3demo_simdDot(const a3_DemoSIMDLane a, const a3_DemoSIMDLane b)
+{
+#if defined(A3_SIMD_SSE)
+	const __m128 p = _mm_mul_ps(a, b);
+	const __m128 s = _mm_add_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+#else	// !A3_SIMD_SSE
+	const float32x4_t p = vmulq_f32(a, b);
+	float32x2_t s = vadd_f32(vget_low_f32(p), vget_high_f32(p));
+	s = vpadd_f32(s, s);
+	return vdupq_lane_f32(s, 0);
+#endif	// A3_SIMD_SSE
+}
+
+// column combination: m's columns weighted by v's components
+inline a3_DemoSIMDLane a3demo_simdCombine(const a3_DemoSIMDLane c0, const a3_DemoSIMDLane c1, const a3_DemoSIMDLane c2, const a3_DemoSIMDLane c3, const a3_DemoSIMDLane v)
+{
+	a3_DemoSIMDLane r = a3demo_simdMul(c0, a3demo_simdSplat(v, 0));
+	r = a3demo_simdAdd(r, a3demo_simdMul(c1, a3demo_simdSplat(v, 1)));
+	r = a3demo_simdAdd(r, a3demo_simdMul(c2, a3demo_simdSplat(v, 2)));
+	return a3demo_simdAdd(r, a3demo_simdMul(c3, a3demo_simdSplat(v, 3)));
+}
+
+// affine inverse from axes already divided by their squared lengths (or
+//	not, to ignore scale): the rotation part transposes and the
+//	translation goes back through it
+void a3demo_simdTransformInverse(a3real4x4p m_out, a3_DemoSIMDLane c0, a3_DemoSIMDLane c1, a3_DemoSIMDLane c2, const a3_DemoSIMDLane t)
+{
+	a3_DemoSIMDLane c3 = a3demo_simdZero(), r;
+	a3demo_simdTranspose(c0, c1, c2, c3);
+	r = a3demo_simdMul(c0, a3demo_simdSplat(t, 0));
+	r = a3demo_simdAdd(r, a3demo_simdMul(c1, a3demo_simdSplat(t, 1)));
+	r = a3demo_simdAdd(r, a3demo_simdMul(c2, a3demo_simdSplat(t, 2)));
+	a3demo_simdStore(m_out[0], c0);
+	a3demo_simdStore(m_out[1], c1);
+	a3demo_simdStore(m_out[2], c2);
+	a3demo_simdStore(m_out[3], a3demo_simdSub(a3demo_simdLoad(a3demo_simdUnitW), r));
+}
+
+#else	// plain C
+
+inline void a3demo_scalarTransformInverse(a3real4x4p m_out, const a3real4x4p m, const int scaled)
+{
+	a3real4x4 inv;
+	a3real s;
+	unsigned int c, k;
+	for (k = 0; k < 3; ++k)
+	{
+		s = scaled ? a3recip(m[k][0] * m[k][0] + m[k][1] * m[k][1] + m[k][2] * m[k][2]) : a3realOne;
+		for (c = 0; c < 3; ++c)
+			inv[c][k] = m[k][c] * s;
+		inv[k][3] = a3realZero;
+	}
+	for (k = 0; k < 3; ++k)
+		inv[3][k] = -(inv[0][k] * m[3][0] + inv[1][k] * m[3][1] + inv[2][k] * m[3][2]);
+	inv[3][3] = a3realOne;
+	memcpy(m_out, inv, sizeof(inv));
+}
+
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+
+
+// one matrix product, for single calls and batches alike
+inline void a3demo_simdProduct(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR)
+{
+#if defined(A3_SIMD_AVX)
+	// two result columns at a time, one in each half; every column of
+	//	the right matrix is read before its result is stored
+	const __m128 l0 = _mm_loadu_ps(mL[0]), l1 = _mm_loadu_ps(mL[1]), l2 = _mm_loadu_ps(mL[2]), l3 = _mm_loadu_ps(mL[3]);
+	const __m256 c0 = _mm256_insertf128_ps(_mm256_castps128_ps256(l0), l0, 1);
+	const __m256 c1 = _mm256_insertf128_ps(_mm256_castps128_ps256(l1), l1, 1);
+	const __m256 c2 = _mm256_insertf128_ps(_mm256_castps128_ps256(l2), l2, 1);
+	const __m256 c3 = _mm256_insertf128_ps(_mm256_castps128_ps256(l3), l3, 1);
+	__m256 b, r;
+	unsigned int j;
+	for (j = 0; j < 4; j += 2)
+	{
+		b = _mm256_loadu_ps(mR[j]);
+		r = _mm256_mul_ps(c0, _mm256_permute_ps(b, 0x00));
+		r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(b, 0x55)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(b, 0xaa)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(b, 0xff)));
+		_mm256_storeu_ps(m_out[j], r);
+	}
+#elif defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	const a3_DemoSIMDLane c0 = a3demo_simdLoad(mL[0]), c1 = a3demo_simdLoad(mL[1]), c2 = a3demo_simdLoad(mL[2]), c3 = a3demo_simdLoad(mL[3]);
+	unsigned int j;
+	for (j = 0; j < 4; ++j)
+		a3demo_simdStore(m_out[j], a3demo_simdCombine(c0, c1, c2, c3, a3demo_simdLoad(mR[j])));
+#else
+	a3real4x4 r;
+	unsigned int i, j;
+	for (j = 0; j < 4; ++j)
+		for (i = 0; i < 4; ++i)
+			r[j][i] = mL[0][i] * mR[j][0] + mL[1][i] * mR[j][1] + mL[2][i] * mR[j][2] + mL[3][i] * mR[j][3];
+	memcpy(m_out, r, sizeof(r));
+#endif	// A3_SIMD_AVX
+}
+
+// one point or direction; only three values are read and written, since
+//	packed triples leave no room for a fourth
+inline void a3demo_simdTransformPoint(a3real *v_out, const a3real4x4p m, const a3real *v, const a3real w)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3real4 r;
+	a3_DemoSIMDLane p = a3demo_simdMul(a3demo_simdLoad(m[0]), a3demo_simdSet(v[0]));
+	p = a3demo_simdAdd(p, a3demo_simdMul(a3demo_simdLoad(m[1]), a3demo_simdSet(v[1])));
+	p = a3demo_simdAdd(p, a3demo_simdMul(a3demo_simdLoad(m[2]), a3demo_simdSet(v[2])));
+	p = a3demo_simdAdd(p, a3demo_simdMul(a3demo_simdLoad(m[3]), a3demo_simdSet(w)));
+	a3demo_simdStore(r, p);
+	v_out[0] = r[0];
+	v_out[1] = r[1];
+	v_out[2] = r[2];
+#else
+	const a3real x = v[0], y = v[1], z = v[2];
+	v_out[0] = m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0] * w;
+	v_out[1] = m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1] * w;
+	v_out[2] = m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2] * w;
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+}
+
+// element i of a strided array
+#define a3demo_simdAt(base, stride, i)		((a3real4 *)((a3ubyte *)(base) + (size_t)(i) * (size_t)(stride)))
+#define a3demo_simdAtReal(base, stride, i)	((a3real *)((a3ubyte *)(base) + (size_t)(i) * (size_t)(stride)))
+
+
+//-----------------------------------------------------------------------------
+
+const char *a3demo_getSIMDName()
+{
+#if defined(A3_SIMD_AVX)
+	return "AVX";
+#elif defined(A3_SIMD_SSE)
+	return "SSE2";
+#elif defined(A3_SIMD_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif	// A3_SIMD_AVX
+}
+
+
+a3real4r a3demo_real4Sum(a3real4p v_out, const a3real4p vL, const a3real4p vR)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3demo_simdStore(v_out, a3demo_simdAdd(a3demo_simdLoad(vL), a3demo_simdLoad(vR)));
+#else
+	v_out[0] = vL[0] + vR[0];
+	v_out[1] = vL[1] + vR[1];
+	v_out[2] = vL[2] + vR[2];
+	v_out[3] = vL[3] + vR[3];
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return v_out;
+}
+
+a3real4r a3demo_real4Diff(a3real4p v_out, const a3real4p vL, const a3real4p vR)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3demo_simdStore(v_out, a3demo_simdSub(a3demo_simdLoad(vL), a3demo_simdLoad(vR)));
+#else
+	v_out[0] = vL[0] - vR[0];
+	v_out[1] = vL[1] - vR[1];
+	v_out[2] = vL[2] - vR[2];
+	v_out[3] = vL[3] - vR[3];
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return v_out;
+}
+
+a3real4r a3demo_real4ProductS(a3real4p v_out, const a3real4p v, const a3real s)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3demo_simdStore(v_out, a3demo_simdMul(a3demo_simdLoad(v), a3demo_simdSet(s)));
+#else
+	v_out[0] = v[0] * s;
+	v_out[1] = v[1] * s;
+	v_out[2] = v[2] * s;
+	v_out[3] = v[3] * s;
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return v_out;
+}
+
+a3real a3demo_real4Dot(const a3real4p vL, const a3real4p vR)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	return a3demo_simdFirst(a3demo_simdDot(a3demo_simdLoad(vL), a3demo_simdLoad(vR)));
+#else
+	return vL[0] * vR[0] + vL[1] * vR[1] + vL[2] * vR[2] + vL[3] * vR[3];
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+}
+
+a3real4r a3demo_real4Normalize(a3real4p v_inout)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	// one scalar root and reciprocal cost less than four-wide ones
+	const a3_DemoSIMDLane v = a3demo_simdLoad(v_inout);
+	const float d = a3demo_simdFirst(a3demo_simdDot(v, v));
+	if (d > 0.0f)
+		a3demo_simdStore(v_inout, a3demo_simdMul(v, a3demo_simdSet(1.0f / sqrtf(d))));
+#else
+	const a3real d = v_inout[0] * v_inout[0] + v_inout[1] * v_inout[1] + v_inout[2] * v_inout[2] + v_inout[3] * v_inout[3];
+	if (d > a3realZero)
+	{
+		const a3real s = a3recip((a3real)sqrt(d));
+		v_inout[0] *= s;
+		v_inout[1] *= s;
+		v_inout[2] *= s;
+		v_inout[3] *= s;
+	}
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return v_inout;
+}
+
+
+a3real4r a3demo_real4Real4x4ProductR(a3real4p v_out, const a3real4x4p m, const a3real4p v)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3demo_simdStore(v_out, a3demo_simdCombine(a3demo_simdLoad(m[0]), a3demo_simdLoad(m[1]), a3demo_simdLoad(m[2]), a3demo_simdLoad(m[3]), a3demo_simdLoad(v)));
+#else
+	a3real4 r;
+	unsigned int i;
+	for (i = 0; i < 4; ++i)
+		r[i] = m[0][i] * v[0] + m[1][i] * v[1] + m[2][i] * v[2] + m[3][i] * v[3];
+	memcpy(v_out, r, sizeof(r));
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return v_out;
+}
+
+a3real4x4r a3demo_real4x4Product(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR)
+{
+	a3demo_simdProduct(m_out, mL, mR);
+	return m_out;
+}
+
+a3real4x4r a3demo_real4x4ProductTransform(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	// the right matrix' bottom row is taken as 0 0 0 1
+	const a3_DemoSIMDLane c0 = a3demo_simdLoad(mL[0]), c1 = a3demo_simdLoad(mL[1]), c2 = a3demo_simdLoad(mL[2]), c3 = a3demo_simdLoad(mL[3]);
+	a3_DemoSIMDLane b, r;
+	unsigned int j;
+	for (j = 0; j < 4; ++j)
+	{
+		b = a3demo_simdLoad(mR[j]);
+		r = a3demo_simdMul(c0, a3demo_simdSplat(b, 0));
+		r = a3demo_simdAdd(r, a3demo_simdMul(c1, a3demo_simdSplat(b, 1)));
+		r = a3demo_simdAdd(r, a3demo_simdMul(c2, a3demo_simdSplat(b, 2)));
+		a3demo_simdStore(m_out[j], j < 3 ? r : a3demo_simdAdd(r, c3));
+	}
+#else
+	a3real4x4 r;
+	unsigned int i, j;
+	for (j = 0; j < 4; ++j)
+		for (i = 0; i < 4; ++i)
+			r[j][i] = mL[0][i] * mR[j][0] + mL[1][i] * mR[j][1] + mL[2][i] * mR[j][2] + (j < 3 ? a3realZero : mL[3][i]);
+	memcpy(m_out, r, sizeof(r));
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return m_out;
+}
+
+a3real4x4r a3demo_real4x4GetTransposed(a3real4x4p m_out, const a3real4x4p m)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	a3_DemoSIMDLane c0 = a3demo_simdLoad(m[0]), c1 = a3demo_simdLoad(m[1]), c2 = a3demo_simdLoad(m[2]), c3 = a3demo_simdLoad(m[3]);
+	a3demo_simdTranspose(c0, c1, c2, c3);
+	a3demo_simdStore(m_out[0], c0);
+	a3demo_simdStore(m_out[1], c1);
+	a3demo_simdStore(m_out[2], c2);
+	a3demo_simdStore(m_out[3], c3);
+#else
+	a3real4x4 r;
+	unsigned int i, j;
+	for (j = 0; j < 4; ++j)
+		for (i = 0; i < 4; ++i)
+			r[j][i] = m[i][j];
+	memcpy(m_out, r, sizeof(r));
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return m_out;
+}
+
+a3real4x4r a3demo_real4x4TransformInverse(a3real4x4p m_out, const a3real4x4p m)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	const a3_DemoSIMDLane mask = a3demo_simdLoad(a3demo_simdMaskW);
+	a3_DemoSIMDLane c0 = a3demo_simdMul(a3demo_simdLoad(m[0]), mask), c1 = a3demo_simdMul(a3demo_simdLoad(m[1]), mask), c2 = a3demo_simdMul(a3demo_simdLoad(m[2]), mask);
+	c0 = a3demo_simdDiv(c0, a3demo_simdDot(c0, c0));
+	c1 = a3demo_simdDiv(c1, a3demo_simdDot(c1, c1));
+	c2 = a3demo_simdDiv(c2, a3demo_simdDot(c2, c2));
+	a3demo_simdTransformInverse(m_out, c0, c1, c2, a3demo_simdLoad(m[3]));
+#else
+	a3demo_scalarTransformInverse(m_out, m, 1);
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return m_out;
+}
+
+a3real4x4r a3demo_real4x4TransformInverseIgnoreScale(a3real4x4p m_out, const a3real4x4p m)
+{
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+	const a3_DemoSIMDLane mask = a3demo_simdLoad(a3demo_simdMaskW);
+	a3demo_simdTransformInverse(m_out, a3demo_simdMul(a3demo_simdLoad(m[0]), mask), a3demo_simdMul(a3demo_simdLoad(m[1]), mask), a3demo_simdMul(a3demo_simdLoad(m[2]), mask), a3demo_simdLoad(m[3]));
+#else
+	a3demo_scalarTransformInverse(m_out, m, 0);
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+	return m_out;
+}
+
+
+
+int a3demo_real4x4ProductArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *mL, const unsigned int strideL, const a3real4x4 *mR, const unsigned int strideR, const unsigned int count)
+{
+	if (m_out && mL && mR)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+			a3demo_simdProduct(a3demo_simdAt(m_out, strideOut, i), a3demo_simdAt(mL, strideL, i), a3demo_simdAt(mR, strideR, i));
+		return count;
+	}
+	return -1;
+}
+
+// one matrix already fills the lanes; transposing four at a time into
+//	lanes of their own measured slower, even with fewer divisions
+int a3demo_real4x4TransformInverseArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *m, const unsigned int strideIn, const unsigned int count)
+{
+	if (m_out && m)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+			a3demo_real4x4TransformInverse(a3demo_simdAt(m_out, strideOut, i), a3demo_simdAt(m, strideIn, i));
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_real4x4TransformInverseIgnoreScaleArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *m, const unsigned int strideIn, const unsigned int count)
+{
+	if (m_out && m)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+			a3demo_real4x4TransformInverseIgnoreScale(a3demo_simdAt(m_out, strideOut, i), a3demo_simdAt(m, strideIn, i));
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_real4x4TransformPoints(a3real *v_out, const unsigned int strideOut, const a3real4x4p m, const a3real *v, const unsigned int strideIn, const a3real w, const unsigned int count)
+{
+	if (v_out && m && v)
+	{
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+			a3demo_simdTransformPoint(a3demo_simdAtReal(v_out, strideOut, i), m, a3demo_simdAtReal(v, strideIn, i), w);
+		return count;
+	}
+	return -1;
+}
+
+int a3demo_real4x4TransformPointsSoA(a3real *x_out, a3real *y_out, a3real *z_out, const a3real4x4p m, const a3real *x, const a3real *y, const a3real *z, const a3real w, const unsigned int count)
+{
+	if (x_out && y_out && z_out && m && x && y && z)
+	{
+		// the matrix' terms spread over every lane, the last with w in it
+		const a3real tx = m[3][0] * w, ty = m[3][1] * w, tz = m[3][2] * w;
+		a3real px, py, pz;
+		unsigned int i = 0;
+#if defined(A3_SIMD_AVX)
+		const __m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]);
+		const __m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]);
+		const __m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]);
+		const __m256 t0 = _mm256_set1_ps(tx), t1 = _mm256_set1_ps(ty), t2 = _mm256_set1_ps(tz);
+		__m256 vx, vy, vz;
+		for (; i + 8 <= count; i += 8)
+		{
+			vx = _mm256_loadu_ps(x + i);
+			vy = _mm256_loadu_ps(y + i);
+			vz = _mm256_loadu_ps(z + i);
+			_mm256_storeu_ps(x_out + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m10, vy)), _mm256_mul_ps(m20, vz)), t0));
+			_mm256_storeu_ps(y_out + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m21, vz)), t1));
+			_mm256_storeu_ps(z_out + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, vx), _mm256_mul_ps(m12, vy)), _mm256_mul_ps(m22, vz)), t2));
+		}
+#elif defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+		const a3_DemoSIMDLane m00 = a3demo_simdSet(m[0][0]), m01 = a3demo_simdSet(m[0][1]), m02 = a3demo_simdSet(m[0][2]);
+		const a3_DemoSIMDLane m10 = a3demo_simdSet(m[1][0]), m11 = a3demo_simdSet(m[1][1]), m12 = a3demo_simdSet(m[1][2]);
+		const a3_DemoSIMDLane m20 = a3demo_simdSet(m[2][0]), m21 = a3demo_simdSet(m[2][1]), m22 = a3demo_simdSet(m[2][2]);
+		const a3_DemoSIMDLane t0 = a3demo_simdSet(tx), t1 = a3demo_simdSet(ty), t2 = a3demo_simdSet(tz);
+		a3_DemoSIMDLane vx, vy, vz;
+		for (; i + 4 <= count; i += 4)
+		{
+			vx = a3demo_simdLoad(x + i);
+			vy = a3demo_simdLoad(y + i);
+			vz = a3demo_simdLoad(z + i);
+			a3demo_simdStore(x_out + i, a3demo_simdAdd(a3demo_simdAdd(a3demo_simdAdd(a3demo_simdMul(m00, vx), a3demo_simdMul(m10, vy)), a3demo_simdMul(m20, vz)), t0));
+			a3demo_simdStore(y_out + i, a3demo_simdAdd(a3demo_simdAdd(a3demo_simdAdd(a3demo_simdMul(m01, vx), a3demo_simdMul(m11, vy)), a3demo_simdMul(m21, vz)), t1));
+			a3demo_simdStore(z_out + i, a3demo_simdAdd(a3demo_simdAdd(a3demo_simdAdd(a3demo_simdMul(m02, vx), a3demo_simdMul(m12, vy)), a3demo_simdMul(m22, vz)), t2));
+		}
+#endif	// A3_SIMD_AVX
+
+		// the rest one at a time
+		for (; i < count; ++i)
+		{
+			px = x[i];
+			py = y[i];
+			pz = z[i];
+			x_out[i] = m[0][0] * px + m[1][0] * py + m[2][0] * pz + tx;
+			y_out[i] = m[0][1] * px + m[1][1] * py + m[2][1] * pz + ty;
+			z_out[i] = m[0][2] * px + m[1][2] * py + m[2][2] * pz + tz;
+		}
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSIMD.h
+	Four-wide versions of the A3DM 4D vector and 4x4 matrix routines on
+		per-object paths: same arguments, same column-major layout, same
+		results to rounding; the instruction set (AVX, SSE2 or NEON, else
+		plain C) is picked when compiling. Also batched forms that run
+		over arrays of matrices and points in one call.
+*/
+
+#ifndef __ANIMAL3D_DEMOSIMD_H
+#define __ANIMAL3D_DEMOSIMD_H
+
+
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// which instruction set the kernels were built with
+	const char *a3demo_getSIMDName();
+
+	// 4D vectors, as their A3DM namesakes (a3real4Sum etc.)
+	a3real4r a3demo_real4Sum(a3real4p v_out, const a3real4p vL, const a3real4p vR);
+	a3real4r a3demo_real4Diff(a3real4p v_out, const a3real4p vL, const a3real4p vR);
+	a3real4r a3demo_real4ProductS(a3real4p v_out, const a3real4p v, const a3real s);
+	a3real a3demo_real4Dot(const a3real4p vL, const a3real4p vR);
+	a3real4r a3demo_real4Normalize(a3real4p v_inout);
+
+	// 4x4 matrices, as their A3DM namesakes; outputs may alias inputs
+	a3real4r a3demo_real4Real4x4ProductR(a3real4p v_out, const a3real4x4p m, const a3real4p v);
+	a3real4x4r a3demo_real4x4Product(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR);
+	a3real4x4r a3demo_real4x4ProductTransform(a3real4x4p m_out, const a3real4x4p mL, const a3real4x4p mR);
+	a3real4x4r a3demo_real4x4GetTransposed(a3real4x4p m_out, const a3real4x4p m);
+
+	// inverse of an affine transform whose axes are perpendicular: with
+	//	each axis' scale undone, or taking the axes as unit
+	a3real4x4r a3demo_real4x4TransformInverse(a3real4x4p m_out, const a3real4x4p m);
+	a3real4x4r a3demo_real4x4TransformInverseIgnoreScale(a3real4x4p m_out, const a3real4x4p m);
+
+
+	// batches: count results in one pass; each array is walked with a
+	//	stride in bytes, so the matrices or points may sit inside larger
+	//	structs (scene objects, vertices), and a stride of zero uses the
+	//	same input for every result; outputs may alias their own inputs
+	//	-> each returns count, -1 if invalid params
+
+	// products, e.g. one view-projection times every model matrix
+	int a3demo_real4x4ProductArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *mL, const unsigned int strideL, const a3real4x4 *mR, const unsigned int strideR, const unsigned int count);
+
+	// inverses of affine transforms as above
+	int a3demo_real4x4TransformInverseArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *m, const unsigned int strideIn, const unsigned int count);
+	int a3demo_real4x4TransformInverseIgnoreScaleArray(a3real4x4 *m_out, const unsigned int strideOut, const a3real4x4 *m, const unsigned int strideIn, const unsigned int count);
+
+	// xyz triples through an affine transform (its bottom row is not
+	//	read), as points if w is 1 or directions if it is 0
+	int a3demo_real4x4TransformPoints(a3real *v_out, const unsigned int strideOut, const a3real4x4p m, const a3real *v, const unsigned int strideIn, const a3real w, const unsigned int count);
+
+	// the same from and to separate x, y and z arrays (structure of
+	//	arrays), four or eight points at a time; packed, any alignment
+	int a3demo_real4x4TransformPointsSoA(a3real *x_out, a3real *y_out, a3real *z_out, const a3real4x4p m, const a3real *x, const a3real *y, const a3real *z, const a3real w, const unsigned int count);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSIMD_H
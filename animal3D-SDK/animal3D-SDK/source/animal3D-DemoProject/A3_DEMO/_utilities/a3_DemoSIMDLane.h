@@ -0,0 +1,118 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSIMDLane.h
+	Instruction set choice and four-wide lane operations shared by the
+		kernel sources; include from source files only.
+*/
+
+#ifndef __ANIMAL3D_DEMOSIMDLANE_H
+#define __ANIMAL3D_DEMOSIMDLANE_H
+
+
+#include "animal3D/a3math/A3DM.h"
+
+
+// pick the widest kernels the compiler is allowed to emit; lanes hold
+//	floats, so other real types keep to plain C
+#if !defined(A3_REAL_F64) && !defined(A3_REAL_F128) && !defined(A3_USING_INTRIN)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define A3_SIMD_AVX
+#define A3_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define A3_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define A3_SIMD_NEON
+#endif
+#endif
+
+// lane operations; no fused multiply-add, so products and sums round
+//	the same way the scalar routines do
+// comparisons give a mask lane (all bits set where true) that the
+//	bitwise operations and select take; any is nonzero if a lane is set
+// bits clear loads four unsigned ints and gives the mask of those that
+//	have none of the bits asked for
+#if defined(A3_SIMD_SSE)
+typedef __m128 a3_DemoSIMDLane;
+#define a3demo_simdLoad(p)					_mm_loadu_ps(p)
+#define a3demo_simdStore(p, a)				_mm_storeu_ps(p, a)
+#define a3demo_simdSet(x)					_mm_set1_ps(x)
+#define a3demo_simdZero()					_mm_setzero_ps()
+#define a3demo_simdAdd(a, b)				_mm_add_ps(a, b)
+#define a3demo_simdSub(a, b)				_mm_sub_ps(a, b)
+#define a3demo_simdMul(a, b)				_mm_mul_ps(a, b)
+#define a3demo_simdDiv(a, b)				_mm_div_ps(a, b)
+#define a3demo_simdSqrt(a)					_mm_sqrt_ps(a)
+#define a3demo_simdRound(a)					_mm_cvtepi32_ps(_mm_cvtps_epi32(a))
+#define a3demo_simdMin(a, b)				_mm_min_ps(a, b)
+#define a3demo_simdMax(a, b)				_mm_max_ps(a, b)
+#define a3demo_simdSetBits(x)				_mm_castsi128_ps(_mm_set1_epi32(x))
+#define a3demo_simdEqual(a, b)				_mm_cmpeq_ps(a, b)
+#define a3demo_simdLess(a, b)				_mm_cmplt_ps(a, b)
+#define a3demo_simdLessEqual(a, b)			_mm_cmple_ps(a, b)
+#define a3demo_simdBitsClear(p, bits)		_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i *)(p)), _mm_set1_epi32(bits)), _mm_setzero_si128()))
+#define a3demo_simdAny(m)					_mm_movemask_ps(m)
+#define a3demo_simdAnd(a, b)				_mm_and_ps(a, b)
+#define a3demo_simdOr(a, b)					_mm_or_ps(a, b)
+#define a3demo_simdXor(a, b)				_mm_xor_ps(a, b)
+#define a3demo_simdSelect(m, a, b)			_mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define a3demo_simdFirst(a)					_mm_cvtss_f32(a)
+#define a3demo_simdSplat(a, i)				_mm_shuffle_ps(a, a, _MM_SHUFFLE(i, i, i, i))
+#define a3demo_simdTranspose(a, b, c, d)	_MM_TRANSPOSE4_PS(a, b, c, d)
+#elif defined(A3_SIMD_NEON)
+typedef float32x4_t a3_DemoSIMDLane;
+#define a3demo_simdLoad(p)					vld1q_f32(p)
+#define a3demo_simdStore(p, a)				vst1q_f32(p, a)
+#define a3demo_simdSet(x)					vdupq_n_f32(x)
+#define a3demo_simdZero()					vdupq_n_f32(0.0f)
+#define a3demo_simdAdd(a, b)				vaddq_f32(a, b)
+#define a3demo_simdSub(a, b)				vsubq_f32(a, b)
+#define a3demo_simdMul(a, b)				vmulq_f32(a, b)
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define a3demo_simdDiv(a, b)				vdivq_f32(a, b)
+#define a3demo_simdSqrt(a)					vsqrtq_f32(a)
+#define a3demo_simdRound(a)					vrndnq_f32(a)
+#else	// ARMv7
+#define a3demo_simdDiv(a, b)				vmulq_f32(a, a3demo_neonRecip(b))
+#define a3demo_simdSqrt(a)					a3demo_neonSqrt(a)
+#define a3demo_simdRound(a)					vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a, vbslq_f32(vcltq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f)))))
+#endif	// __aarch64__
+#define a3demo_simdMin(a, b)				vminq_f32(a, b)
+#define a3demo_simdMax(a, b)				vmaxq_f32(a, b)
+#define a3demo_simdSetBits(x)				vreinterpretq_f32_s32(vdupq_n_s32(x))
+#define a3demo_simdEqual(a, b)				vreinterpretq_f32_u32(vceqq_f32(a, b))
+#define a3demo_simdLess(a, b)				vreinterpretq_f32_u32(vcltq_f32(a, b))
+#define a3demo_simdLessEqual(a, b)			vreinterpretq_f32_u32(vcleq_f32(a, b))
+#define a3demo_simdBitsClear(p, bits)		vreinterpretq_f32_u32(vceqq_u32(vandq_u32(vld1q_u32(p), vdupq_n_u32(bits)), vdupq_n_u32(0)))
+#define a3demo_simdAny(m)					vget_lane_u32(vpmax_u32(vpmax_u32(vget_low_u32(vreinterpretq_u32_f32(m)), vget_high_u32(vreinterpretq_u32_f32(m))), vdup_n_u32(0)), 0)
+#define a3demo_simdAnd(a, b)				vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)))
+#define a3demo_simdOr(a, b)					vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)))
+#define a3demo_simdXor(a, b)				vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)))
+#define a3demo_simdSelect(m, a, b)			vbslq_f32(vreinterpretq_u32_f32(m), a, b)
+#define a3demo_simdFirst(a)					vgetq_lane_f32(a, 0)
+#define a3demo_simdSplat(a, i)				vdupq_n_f32(vgetq_lane_f32(a, i))
+#define a3demo_simdTranspose(a, b, c, d)	a3demo_neonTranspose(&(a), &(b), &(c), &(d))
+#endif	// A3_SIMD_SSE
+
+
+#endif	// !__ANIMAL3D_DEMOSIMDLANE_H
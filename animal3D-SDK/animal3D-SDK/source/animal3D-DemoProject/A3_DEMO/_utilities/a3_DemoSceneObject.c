@@ -17,7 +17,7 @@
 /*
 	animal3D SDK: Minimal 3D Animation Framework
 	By Daniel S. Buckstein
-	
+
 	a3_DemoSceneObject.c
 	Example of demo utility source file.
 */
@@ -36,6 +36,8 @@ project on its database.
 */
 
 #include "a3_DemoSceneObject.h"
+#include "a3_DemoSIMD.h"
+#include "a3_DemoQuaternion.h"
 
 
 //-----------------------------------------------------------------------------
@@ -45,25 +47,82 @@ extern inline void a3demo_initSceneObject(a3_DemoSceneObject *sceneObject)
 {
 	a3real4x4SetIdentity(sceneObject->modelMat.m);
 	a3real4x4SetIdentity(sceneObject->modelMatInv.m);
-	a3real3Set(sceneObject->euler.v, a3realZero, a3realZero, a3realZero);
+	a3demo_quatSetIdentity(sceneObject->orientation.v);
 	a3real3Set(sceneObject->position.v, a3realZero, a3realZero, a3realZero);
+	sceneObject->awake = 1;
+}
+
+extern inline int a3demo_updateSceneObject(a3_DemoSceneObject *sceneObject)
+{
+	if (sceneObject->awake)
+	{
+		// the matrix comes straight from the quaternion, no trig
+		a3demo_real4x4SetQuat(sceneObject->modelMat.m, sceneObject->orientation.v);
+		sceneObject->modelMat.v3.xyz = sceneObject->position;
+		a3demo_real4x4TransformInverseIgnoreScale(sceneObject->modelMatInv.m, sceneObject->modelMat.m);
+		sceneObject->awake = 0;
+		return 1;
+	}
+	return 0;
 }
 
-extern inline void a3demo_updateSceneObject(a3_DemoSceneObject *sceneObject)
+extern inline void a3demo_wakeSceneObject(a3_DemoSceneObject *sceneObject)
 {
-	a3real4x4SetRotateZYX(sceneObject->modelMat.m, sceneObject->euler.x, sceneObject->euler.y, sceneObject->euler.z);
-	sceneObject->modelMat.v3.xyz = sceneObject->position;
-	a3real4x4TransformInverseIgnoreScale(sceneObject->modelMatInv.m, sceneObject->modelMat.m);
+	sceneObject->awake = 1;
+}
+
+extern inline void a3demo_setSceneObjectEuler(a3_DemoSceneObject *sceneObject, const a3real degrees_x, const a3real degrees_y, const a3real degrees_z)
+{
+	a3demo_quatSetEulerZYX(sceneObject->orientation.v, degrees_x, degrees_y, degrees_z);
+	sceneObject->awake = 1;
 }
 
 extern inline int a3demo_rotateSceneObject(a3_DemoSceneObject *sceneObject, const a3real speed, const a3real deltaX, const a3real deltaY, const a3real deltaZ)
 {
 	if (speed && (deltaX || deltaY || deltaZ))
 	{
-		// validate angles so they don't get zero'd out (trig functions have a limit)
-		sceneObject->euler.x = a3trigValid_sind(sceneObject->euler.x + speed * deltaX);
-		sceneObject->euler.y = a3trigValid_sind(sceneObject->euler.y + speed * deltaY);
-		sceneObject->euler.z = a3trigValid_sind(sceneObject->euler.z + speed * deltaZ);
+		// pitch goes on the right (object's own X), yaw and roll on the
+		//	left (world Y and Z), so turns made in between are kept
+		a3real4 delta;
+		a3real3 axis;
+		if (deltaX)
+		{
+			a3real3Set(axis, a3realOne, a3realZero, a3realZero);
+			a3demo_quatSetAxisAngle(delta, axis, speed * deltaX);
+			a3demo_quatProduct(sceneObject->orientation.v, sceneObject->orientation.v, delta);
+		}
+		if (deltaY)
+		{
+			a3real3Set(axis, a3realZero, a3realOne, a3realZero);
+			a3demo_quatSetAxisAngle(delta, axis, speed * deltaY);
+			a3demo_quatProduct(sceneObject->orientation.v, delta, sceneObject->orientation.v);
+		}
+		if (deltaZ)
+		{
+			a3real3Set(axis, a3realZero, a3realZero, a3realOne);
+			a3demo_quatSetAxisAngle(delta, axis, speed * deltaZ);
+			a3demo_quatProduct(sceneObject->orientation.v, delta, sceneObject->orientation.v);
+		}
+		a3demo_quatNormalize(sceneObject->orientation.v);
+		sceneObject->awake = 1;
+
+		return 1;
+	}
+	return 0;
+}
+
+extern inline int a3demo_turnSceneObject(a3_DemoSceneObject *sceneObject, const a3real speed, const a3real axisX, const a3real axisY, const a3real axisZ)
+{
+	if (speed && (axisX || axisY || axisZ))
+	{
+		// the local axis taken to the world as an angular velocity over
+		//	one unit of time
+		a3real3 axis;
+		a3real3Set(axis, axisX, axisY, axisZ);
+		a3real3MulS(axis, a3deg2rad(speed) * a3real3LengthInverse(axis));
+		a3demo_quatRotate(axis, sceneObject->orientation.v, axis);
+		a3demo_quatIntegrate(sceneObject->orientation.v, axis, a3realOne);
+		sceneObject->awake = 1;
 
 		return 1;
 	}
@@ -82,6 +141,7 @@ extern inline int a3demo_moveSceneObject(a3_DemoSceneObject *sceneObject, const
 		a3real3Add(delta[0], delta[2]);
 		a3real3MulS(delta[0], speed * a3real3LengthInverse(delta[0]));	// normalize and scale by speed
 		a3real3Add(sceneObject->position.v, delta[0]);					// add delta to current
+		sceneObject->awake = 1;
 
 		return 1;
 	}
@@ -110,7 +170,7 @@ extern inline void a3demo_initCamera(a3_DemoCamera *camera)
 
 extern inline void a3demo_updateCameraViewProjection(a3_DemoCamera *camera)
 {
-	a3real4x4Product(camera->viewProjectionMat.m, camera->projectionMat.m, camera->sceneObject->modelMatInv.m);
+	a3demo_real4x4Product(camera->viewProjectionMat.m, camera->projectionMat.m, camera->sceneObject->modelMatInv.m);
 }
 
 
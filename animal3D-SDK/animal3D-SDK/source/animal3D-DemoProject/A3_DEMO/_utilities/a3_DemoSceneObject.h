@@ -17,7 +17,7 @@
 /*
 	animal3D SDK: Minimal 3D Animation Framework
 	By Daniel S. Buckstein
-	
+
 	a3_DemoSceneObject.h
 	Example of demo utility header file.
 */
@@ -40,7 +40,7 @@ extern "C"
 	typedef struct a3_DemoCamera		a3_DemoCamera;
 #endif	// __cplusplus
 
-	
+
 //-----------------------------------------------------------------------------
 
 
@@ -49,8 +49,9 @@ extern "C"
 	{
 		a3mat4 modelMat;	// model matrix: transform relative to scene
 		a3mat4 modelMatInv;	// inverse model matrix: scene relative to this
-		a3vec3 euler;		// euler angles for direct rotation control
+		a3vec4 orientation;	// unit quaternion; the only record of rotation
 		a3vec3 position;	// scene position for direct control
+		int awake;			// orientation or position changed since the last update
 	};
 
 	// camera/viewer
@@ -71,10 +72,22 @@ extern "C"
 
 //-----------------------------------------------------------------------------
 
-	// scene object initializers and updates
+	// scene object initializers and updates; objects sleep once their
+	//	matrices are current, so update skips them (returns 0) until a
+	//	rotate, move or wake (for direct writes to position); rotation is
+	//	kept only as a quaternion, which every call below composes onto
 	inline void a3demo_initSceneObject(a3_DemoSceneObject *sceneObject);
-	inline void a3demo_updateSceneObject(a3_DemoSceneObject *sceneObject);
+	inline int a3demo_updateSceneObject(a3_DemoSceneObject *sceneObject);
+	inline void a3demo_wakeSceneObject(a3_DemoSceneObject *sceneObject);
+	// replace the orientation with euler angles (X, then Y, then Z)
+	inline void a3demo_setSceneObjectEuler(a3_DemoSceneObject *sceneObject, const a3real degrees_x, const a3real degrees_y, const a3real degrees_z);
+	// pitch about the object's own X axis, yaw and roll about the world
+	//	Y and Z axes, by the given degrees; the same as adding to euler
+	//	angles while either yaw or roll stays zero, as the camera controls do
 	inline int a3demo_rotateSceneObject(a3_DemoSceneObject *sceneObject, const a3real speed, const a3real deltaX, const a3real deltaY, const a3real deltaZ);
+	// spin about one of the object's own axes by the given degrees with no
+	//	trig
+	inline int a3demo_turnSceneObject(a3_DemoSceneObject *sceneObject, const a3real speed, const a3real axisX, const a3real axisY, const a3real axisZ);
 	inline int a3demo_moveSceneObject(a3_DemoSceneObject *sceneObject, const a3real speed, const a3real deltaX, const a3real deltaY, const a3real deltaZ);
 	inline void a3demo_setCameraSceneObject(a3_DemoCamera *camera, a3_DemoSceneObject *sceneObject);
 	inline void a3demo_initCamera(a3_DemoCamera *camera);
@@ -0,0 +1,292 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoTrig.c
+	Polynomial sine and cosine implementation.
+*/
+
+#include "a3_DemoTrig.h"
+#include "a3_DemoSIMDLane.h"
+
+
+//-----------------------------------------------------------------------------
+// internal
+
+// quarter turns: 2 / pi, and pi / 2 split in three so that the first two
+//	parts times any whole number of quarter turns up to 2^13 are exact
+#define a3demo_trigQuarterInv	((a3real)0.636619772367581343)
+#define a3demo_trigQuarter0		((a3real)1.5703125)
+#define a3demo_trigQuarter1		((a3real)4.837512969970703125e-4)
+#define a3demo_trigQuarter2		((a3real)7.54978995489188216e-8)
+#define a3demo_trigDegToRad		((a3real)0.0174532925199432958)
+
+// minimax fits on [-pi/4, pi/4] for relative error, with the leading
+//	terms kept exact:
+//	sin r = r + r^3 (S0 + S1 r^2 + S2 r^4)
+//	cos r = 1 - r^2 / 2 + r^4 (C0 + C1 r^2 + C2 r^4)
+#define a3demo_trigFastS0		((a3real)-1.624279154e-1)
+#define a3demo_trigFastC0		((a3real)4.089930542e-2)
+#define a3demo_trigMediumS0		((a3real)-1.666339038e-1)
+#define a3demo_trigMediumS1		((a3real)8.163281921e-3)
+#define a3demo_trigMediumC0		((a3real)4.166107131e-2)
+#define a3demo_trigMediumC1		((a3real)-1.364871438e-3)
+#define a3demo_trigFullS0		((a3real)-1.6666654611e-1)
+#define a3demo_trigFullS1		((a3real)8.3321608736e-3)
+#define a3demo_trigFullS2		((a3real)-1.9515295891e-4)
+#define a3demo_trigFullC0		((a3real)4.166664568298827e-2)
+#define a3demo_trigFullC1		((a3real)-1.388731625493765e-3)
+#define a3demo_trigFullC2		((a3real)2.443315711809948e-5)
+
+
+// both polynomials for an already reduced input
+inline void a3demo_trigPolynomials(const a3real r, a3real *s_out, a3real *c_out, const a3_DemoTrigTier tier)
+{
+	const a3real z = r * r;
+	a3real ps, pc;
+	switch (tier)
+	{
+	case a3demo_trig_fast:
+		ps = a3demo_trigFastS0;
+		pc = a3demo_trigFastC0;
+		break;
+	case a3demo_trig_medium:
+		ps = a3demo_trigMediumS1 * z + a3demo_trigMediumS0;
+		pc = a3demo_trigMediumC1 * z + a3demo_trigMediumC0;
+		break;
+	default:
+		ps = (a3demo_trigFullS2 * z + a3demo_trigFullS1) * z + a3demo_trigFullS0;
+		pc = (a3demo_trigFullC2 * z + a3demo_trigFullC1) * z + a3demo_trigFullC0;
+		break;
+	}
+	*s_out = ps * z * r + r;
+	*c_out = pc * z * z - a3realHalf * z + a3realOne;
+}
+
+// sine and cosine of the reduced input moved back to its quarter turn
+inline void a3demo_trigQuadrant(const a3real r, const int quadrant, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier)
+{
+	a3real s, c;
+	a3demo_trigPolynomials(r, &s, &c, tier);
+	switch (quadrant & 3)
+	{
+	case 0:
+		*sin_out = s;
+		*cos_out = c;
+		break;
+	case 1:
+		*sin_out = c;
+		*cos_out = -s;
+		break;
+	case 2:
+		*sin_out = -s;
+		*cos_out = -c;
+		break;
+	default:
+		*sin_out = -c;
+		*cos_out = s;
+		break;
+	}
+}
+
+// nearest whole number of quarter turns
+inline int a3demo_trigNearest(const a3real x)
+{
+	return (int)(x < a3realZero ? x - a3realHalf : x + a3realHalf);
+}
+
+
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+
+// the widest lane there is: eight with AVX, otherwise the four-wide ones
+#if defined(A3_SIMD_AVX)
+typedef __m256 a3_DemoTrigLane;
+#define a3demo_trigWidth			8
+#define a3demo_trigLoad(p)			_mm256_loadu_ps(p)
+#define a3demo_trigStore(p, a)		_mm256_storeu_ps(p, a)
+#define a3demo_trigSet(x)			_mm256_set1_ps(x)
+#define a3demo_trigAdd(a, b)		_mm256_add_ps(a, b)
+#define a3demo_trigSub(a, b)		_mm256_sub_ps(a, b)
+#define a3demo_trigMul(a, b)		_mm256_mul_ps(a, b)
+#define a3demo_trigRound(a)			_mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define a3demo_trigEqual(a, b)		_mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+#define a3demo_trigAnd(a, b)		_mm256_and_ps(a, b)
+#define a3demo_trigOr(a, b)			_mm256_or_ps(a, b)
+#define a3demo_trigXor(a, b)		_mm256_xor_ps(a, b)
+#define a3demo_trigSelect(m, a, b)	_mm256_or_ps(_mm256_and_ps(m, a), _mm256_andnot_ps(m, b))
+#else	// !A3_SIMD_AVX
+typedef a3_DemoSIMDLane a3_DemoTrigLane;
+#define a3demo_trigWidth			4
+#define a3demo_trigLoad(p)			a3demo_simdLoad(p)
+#define a3demo_trigStore(p, a)		a3demo_simdStore(p, a)
+#define a3demo_trigSet(x)			a3demo_simdSet(x)
+#define a3demo_trigAdd(a, b)		a3demo_simdAdd(a, b)
+#define a3demo_trigSub(a, b)		a3demo_simdSub(a, b)
+#define a3demo_trigMul(a, b)		a3demo_simdMul(a, b)
+#define a3demo_trigRound(a)			a3demo_simdRound(a)
+#define a3demo_trigEqual(a, b)		a3demo_simdEqual(a, b)
+#define a3demo_trigAnd(a, b)		a3demo_simdAnd(a, b)
+#define a3demo_trigOr(a, b)			a3demo_simdOr(a, b)
+#define a3demo_trigXor(a, b)		a3demo_simdXor(a, b)
+#define a3demo_trigSelect(m, a, b)	a3demo_simdSelect(m, a, b)
+#endif	// A3_SIMD_AVX
+
+// the same steps across a lane; the quarter turn is kept as a float
+//	from -2 to 2 and turned into masks, since AVX has no integer lanes
+inline void a3demo_trigLane(const a3_DemoTrigLane x, a3_DemoTrigLane *sin_out, a3_DemoTrigLane *cos_out, const a3_DemoTrigTier tier)
+{
+	const a3_DemoTrigLane q = a3demo_trigRound(a3demo_trigMul(x, a3demo_trigSet(a3demo_trigQuarterInv)));
+	const a3_DemoTrigLane r = a3demo_trigSub(a3demo_trigSub(a3demo_trigSub(x,
+		a3demo_trigMul(q, a3demo_trigSet(a3demo_trigQuarter0))),
+		a3demo_trigMul(q, a3demo_trigSet(a3demo_trigQuarter1))),
+		a3demo_trigMul(q, a3demo_trigSet(a3demo_trigQuarter2)));
+	const a3_DemoTrigLane z = a3demo_trigMul(r, r);
+	const a3_DemoTrigLane a = a3demo_trigSub(q, a3demo_trigMul(a3demo_trigSet(4.0f), a3demo_trigRound(a3demo_trigMul(q, a3demo_trigSet(0.25f)))));
+	const a3_DemoTrigLane a2 = a3demo_trigMul(a, a);
+	const a3_DemoTrigLane odd = a3demo_trigEqual(a2, a3demo_trigSet(1.0f));
+	const a3_DemoTrigLane opposite = a3demo_trigEqual(a2, a3demo_trigSet(4.0f));
+	const a3_DemoTrigLane sign = a3demo_trigSet(-0.0f);
+	a3_DemoTrigLane ps, pc, s, c;
+	switch (tier)
+	{
+	case a3demo_trig_fast:
+		ps = a3demo_trigSet(a3demo_trigFastS0);
+		pc = a3demo_trigSet(a3demo_trigFastC0);
+		break;
+	case a3demo_trig_medium:
+		ps = a3demo_trigAdd(a3demo_trigMul(a3demo_trigSet(a3demo_trigMediumS1), z), a3demo_trigSet(a3demo_trigMediumS0));
+		pc = a3demo_trigAdd(a3demo_trigMul(a3demo_trigSet(a3demo_trigMediumC1), z), a3demo_trigSet(a3demo_trigMediumC0));
+		break;
+	default:
+		ps = a3demo_trigAdd(a3demo_trigMul(a3demo_trigAdd(a3demo_trigMul(a3demo_trigSet(a3demo_trigFullS2), z), a3demo_trigSet(a3demo_trigFullS1)), z), a3demo_trigSet(a3demo_trigFullS0));
+		pc = a3demo_trigAdd(a3demo_trigMul(a3demo_trigAdd(a3demo_trigMul(a3demo_trigSet(a3demo_trigFullC2), z), a3demo_trigSet(a3demo_trigFullC1)), z), a3demo_trigSet(a3demo_trigFullC0));
+		break;
+	}
+	s = a3demo_trigAdd(a3demo_trigMul(a3demo_trigMul(ps, z), r), r);
+	c = a3demo_trigAdd(a3demo_trigSub(a3demo_trigMul(a3demo_trigMul(pc, z), z), a3demo_trigMul(a3demo_trigSet(0.5f), z)), a3demo_trigSet(1.0f));
+
+	// odd quarters swap the two; sine is negative in quarters 2 and 3
+	//	(-1), cosine in quarters 1 and 2
+	*sin_out = a3demo_trigXor(a3demo_trigSelect(odd, c, s), a3demo_trigAnd(a3demo_trigOr(opposite, a3demo_trigEqual(a, a3demo_trigSet(-1.0f))), sign));
+	*cos_out = a3demo_trigXor(a3demo_trigSelect(odd, s, c), a3demo_trigAnd(a3demo_trigOr(opposite, a3demo_trigEqual(a, a3demo_trigSet(1.0f))), sign));
+}
+
+// whole lanes of a batch; returns how many were done
+inline unsigned int a3demo_trigLaneBatch(a3real *sin_out, a3real *cos_out, const a3real *x, const unsigned int count, const a3_DemoTrigTier tier)
+{
+	a3_DemoTrigLane s, c;
+	unsigned int i;
+	for (i = 0; i + a3demo_trigWidth <= count; i += a3demo_trigWidth)
+	{
+		a3demo_trigLane(a3demo_trigLoad(x + i), &s, &c, tier);
+		if (sin_out)
+			a3demo_trigStore(sin_out + i, s);
+		if (cos_out)
+			a3demo_trigStore(cos_out + i, c);
+	}
+	return i;
+}
+
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+
+
+//-----------------------------------------------------------------------------
+
+a3real a3demo_sinr(const a3real x, const a3_DemoTrigTier tier)
+{
+	a3real s, c;
+	a3demo_sinCosr(x, &s, &c, tier);
+	return s;
+}
+
+a3real a3demo_cosr(const a3real x, const a3_DemoTrigTier tier)
+{
+	a3real s, c;
+	a3demo_sinCosr(x, &s, &c, tier);
+	return c;
+}
+
+a3real a3demo_sind(const a3real x, const a3_DemoTrigTier tier)
+{
+	a3real s, c;
+	a3demo_sinCosd(x, &s, &c, tier);
+	return s;
+}
+
+a3real a3demo_cosd(const a3real x, const a3_DemoTrigTier tier)
+{
+	a3real s, c;
+	a3demo_sinCosd(x, &s, &c, tier);
+	return c;
+}
+
+void a3demo_sinCosr(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier)
+{
+	const int quadrant = a3demo_trigNearest(x * a3demo_trigQuarterInv);
+	const a3real q = (a3real)quadrant;
+	a3demo_trigQuadrant(x - q * a3demo_trigQuarter0 - q * a3demo_trigQuarter1 - q * a3demo_trigQuarter2, quadrant, sin_out, cos_out, tier);
+}
+
+void a3demo_sinCosd(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier)
+{
+	// whole quarter turns come off exactly in degrees
+	const int quadrant = a3demo_trigNearest(x * (a3real)(1.0 / 90.0));
+	a3demo_trigQuadrant((x - (a3real)quadrant * a3realNinety) * a3demo_trigDegToRad, quadrant, sin_out, cos_out, tier);
+}
+
+
+int a3demo_sinCosrArray(a3real *sin_out, a3real *cos_out, const a3real *x, const unsigned int count, const a3_DemoTrigTier tier)
+{
+	if ((sin_out || cos_out) && x && tier < a3demo_trig_count)
+	{
+		a3real s, c;
+		unsigned int i = 0;
+
+#if defined(A3_SIMD_SSE) || defined(A3_SIMD_NEON)
+		// each tier its own loop so the polynomials are fixed inside it
+		switch (tier)
+		{
+		case a3demo_trig_fast:
+			i = a3demo_trigLaneBatch(sin_out, cos_out, x, count, a3demo_trig_fast);
+			break;
+		case a3demo_trig_medium:
+			i = a3demo_trigLaneBatch(sin_out, cos_out, x, count, a3demo_trig_medium);
+			break;
+		default:
+			i = a3demo_trigLaneBatch(sin_out, cos_out, x, count, a3demo_trig_full);
+			break;
+		}
+#endif	// A3_SIMD_SSE || A3_SIMD_NEON
+
+		// the rest one at a time
+		for (; i < count; ++i)
+		{
+			a3demo_sinCosr(x[i], &s, &c, tier);
+			if (sin_out)
+				sin_out[i] = s;
+			if (cos_out)
+				cos_out[i] = c;
+		}
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoTrig.h
+	Sine and cosine from minimax polynomials instead of the A3DM lookup
+		table: no table to fill or keep in cache, any input range, a
+		choice of accuracy, and batches four or eight at a time.
+*/
+
+#ifndef __ANIMAL3D_DEMOTRIG_H
+#define __ANIMAL3D_DEMOTRIG_H
+
+
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef enum a3_DemoTrigTier	a3_DemoTrigTier;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// accuracy tiers, largest relative error of the polynomials
+	//	themselves (the argument reduction adds about one unit in the
+	//	last place on top)
+	enum a3_DemoTrigTier
+	{
+		a3demo_trig_fast,		// about 6e-4: placement, visuals
+		a3demo_trig_medium,		// about 2e-6
+		a3demo_trig_full,		// within a few units in the last place of a float
+
+		a3demo_trig_count
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// the input is folded to within an eighth of a turn of zero, so any
+	//	angle works, though precision drops past about 10^4 radians
+	//	(or 5 * 10^5 degrees)
+	a3real a3demo_sinr(const a3real x, const a3_DemoTrigTier tier);
+	a3real a3demo_cosr(const a3real x, const a3_DemoTrigTier tier);
+	a3real a3demo_sind(const a3real x, const a3_DemoTrigTier tier);
+	a3real a3demo_cosd(const a3real x, const a3_DemoTrigTier tier);
+
+	// both at the cost of about one
+	void a3demo_sinCosr(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier);
+	void a3demo_sinCosd(const a3real x, a3real *sin_out, a3real *cos_out, const a3_DemoTrigTier tier);
+
+	// batches in radians, eight at a time with AVX and four with SSE2 or
+	//	NEON; either output may be null, and may be the input
+	//	-> returns count, -1 if invalid params
+	int a3demo_sinCosrArray(a3real *sin_out, a3real *cos_out, const a3real *x, const unsigned int count, const a3_DemoTrigTier tier);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOTRIG_H
@@ -41,6 +41,8 @@ project on its database.
 */
 
 #include "a3_DemoState.h"
+#include "_utilities/a3_DemoSIMD.h"
+#include "_utilities/a3_DemoTrig.h"
 
 
 //-----------------------------------------------------------------------------
@@ -56,6 +58,18 @@ project on its database.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+
+// gravity settings (G = 1); with this sun the inner planet orbits at 
+//	about the speed the old scripted orbit used
+static const a3real a3demo_sunMass = 12.0f;
+static const a3real a3demo_planetMass = 0.001f;
+static const a3real a3demo_asteroidMass = 0.000001f;
+
+// bodies smaller than this (asteroids are points) are picked as if they 
+//	were this big
+static const a3real a3demo_pickRadius = 0.1f;
 
 
 //-----------------------------------------------------------------------------
@@ -91,6 +105,18 @@ void a3demo_setDefaultGraphicsState()
 //-----------------------------------------------------------------------------
 // LOADING AND UNLOADING
 
+// mass properties of the procedural shapes and the teapot at unit density: 
+//	exact for shapes that have a formula, integrated over the mesh otherwise
+inline void a3demo_computeSceneMassProperties(a3_DemoState *demoState, const a3_ProceduralGeometryDescriptor *proceduralShapes, 
+	const a3_GeometryData *proceduralShapesData, const unsigned int proceduralShapesCount, const a3_GeometryData *loadedModelsData)
+{
+	unsigned int i;
+	for (i = 0; i < proceduralShapesCount; ++i)
+		if (!a3demo_computeMassPropertiesDescriptor(demoState->shapeMassProperties + i, proceduralShapes + i, a3realOne))
+			a3demo_computeMassPropertiesMesh(demoState->shapeMassProperties + i, proceduralShapesData + i, a3realOne);
+	a3demo_computeMassPropertiesMesh(demoState->teapotMassProperties, loadedModelsData + 0, a3realOne);
+}
+
 // utility to load geometry
 void a3demo_loadGeometry(a3_DemoState *demoState)
 {
@@ -114,6 +140,7 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	// file streaming (if requested)
 	a3_FileStream fileStream[1] = { 0 };
 	const char *const geometryStream = "./data/geom_data.dat";
+	unsigned int massPropertiesStreamed = 0;
 
 	// geometry data
 	a3_GeometryData sceneShapesData[3] = { 0 };
@@ -126,6 +153,14 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	// common index format
 	a3_IndexFormatDescriptor sceneCommonIndexFormat[1] = { 0 };
 
+	// procedural shape descriptors, needed for colliders even when the 
+	//	geometry itself comes from the stream
+	a3_ProceduralGeometryDescriptor proceduralShapes[4] = { a3geomShape_none };
+	a3proceduralCreateDescriptorPlane(proceduralShapes + 0, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 1.0f, 1, 1);
+	a3proceduralCreateDescriptorSphere(proceduralShapes + 1, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 32, 24);
+	a3proceduralCreateDescriptorCylinder(proceduralShapes + 2, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 1.0f, 32, 1, 1);
+	a3proceduralCreateDescriptorTorus(proceduralShapes + 3, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 0.1f, 32, 24);
+
 
 	// procedural scene objects
 	// attempt to load stream if requested
@@ -145,6 +180,11 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		for (i = 0; i < loadedModelsCount; ++i)
 			a3fileStreamReadObject(fileStream, loadedModelsData + i, (a3_FileStreamReadFunc)a3geometryLoadDataBinary);
 
+		// their mass properties, if the stream was written with them
+		for (i = 0; i < proceduralShapesCount; ++i)
+			massPropertiesStreamed += a3fileStreamReadObject(fileStream, demoState->shapeMassProperties + i, (a3_FileStreamReadFunc)a3demo_loadMassPropertiesBinary) > 0;
+		massPropertiesStreamed += a3fileStreamReadObject(fileStream, demoState->teapotMassProperties, (a3_FileStreamReadFunc)a3demo_loadMassPropertiesBinary) > 0;
+
 		// done
 		a3fileStreamClose(fileStream);
 	}
@@ -153,7 +193,6 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	{
 		// create new data
 		a3_ProceduralGeometryDescriptor sceneShapes[3] = { a3geomShape_none };
-		a3_ProceduralGeometryDescriptor proceduralShapes[4] = { a3geomShape_none };
 		a3_ProceduralGeometryDescriptor loadedModelShapes[1] = { a3geomShape_none };
 
 		// static scene procedural objects
@@ -168,10 +207,6 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		}
 
 		// other procedurally-generated objects
-		a3proceduralCreateDescriptorPlane(proceduralShapes + 0, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 1.0f, 1, 1);
-		a3proceduralCreateDescriptorSphere(proceduralShapes + 1, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 32, 24);
-		a3proceduralCreateDescriptorCylinder(proceduralShapes + 2, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 1.0f, 32, 1, 1);
-		a3proceduralCreateDescriptorTorus(proceduralShapes + 3, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 0.1f, 32, 24);
 		for (i = 0; i < proceduralShapesCount; ++i)
 		{
 			a3proceduralGenerateGeometryData(proceduralShapesData + i, proceduralShapes + i);
@@ -183,10 +218,34 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		for (i = 0; i < loadedModelsCount; ++i)
 			a3fileStreamWriteObject(fileStream, loadedModelsData + i, (a3_FileStreamWriteFunc)a3geometrySaveDataBinary);
 
+		// mass properties last, so streams from before them still load
+		a3demo_computeSceneMassProperties(demoState, proceduralShapes, proceduralShapesData, proceduralShapesCount, loadedModelsData);
+		for (i = 0; i < proceduralShapesCount; ++i)
+			a3fileStreamWriteObject(fileStream, demoState->shapeMassProperties + i, (a3_FileStreamWriteFunc)a3demo_saveMassPropertiesBinary);
+		a3fileStreamWriteObject(fileStream, demoState->teapotMassProperties, (a3_FileStreamWriteFunc)a3demo_saveMassPropertiesBinary);
+		massPropertiesStreamed = proceduralShapesCount + 1;
+
 		// done
 		a3fileStreamClose(fileStream);
 	}
 
+	// a stream from before mass properties were kept has none
+	if (massPropertiesStreamed < proceduralShapesCount + 1)
+		a3demo_computeSceneMassProperties(demoState, proceduralShapes, proceduralShapesData, proceduralShapesCount, loadedModelsData);
+
+	// colliders fit the meshes as generated (or streamed); a mesh that is 
+	//	not the shape its collider would be gets no collider
+	for (i = 0; i < proceduralShapesCount; ++i)
+		if (a3demo_createColliderFromGeometry(demoState->shapeCollider + i, proceduralShapes + i, proceduralShapesData + i) < 0)
+			printf("\n A3 Warning: Procedural shape %u does not match its collider.", i);
+
+	// the teapot collides as the hull of 64 of its points rather than as 
+	//	its thousands of triangles
+	a3demo_createConvexHullGeometry(demoState->teapotHull, loadedModelsData + 0, 64, a3realZero, demoState->jobSystem);
+
+	// casts against the teapot use its actual triangles
+	a3demo_createMeshBVHGeometry(demoState->teapotBVH, loadedModelsData + 0, demoState->jobSystem);
+
 
 	// GPU data upload process: 
 	//	- determine storage requirements
@@ -270,6 +329,51 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		a3geometryReleaseData(proceduralShapesData + i);
 	for (i = 0; i < loadedModelsCount; ++i)
 		a3geometryReleaseData(loadedModelsData + i);
+
+
+	// body points: positions only, rewritten every frame
+	{
+		a3_VertexAttributeDescriptor bodyPointAttrib[1];
+		a3_VertexFormatDescriptor bodyPointFormat[1];
+		a3vertexAttribCreateDescriptor(bodyPointAttrib, a3attrib_position, a3attrib_vec3);
+		a3vertexCreateFormatDescriptor(bodyPointFormat, bodyPointAttrib, 1);
+
+		vbo_ibo = demoState->vbo_bodyPointBuffer;
+		a3bufferCreate(vbo_ibo, a3buffer_vertex, a3vertexStorageSpaceRequired(bodyPointFormat, demoStateMaxCount_body), 0);
+		vao = demoState->vao_bodyPoints;
+		a3vertexArrayCreateDescriptor(vao, vbo_ibo, bodyPointFormat, 0);
+		currentDrawable = demoState->draw_bodyPoints;
+		a3vertexCreateDrawable(currentDrawable, vao, a3prim_points, 0, demoStateMaxCount_body);
+		currentDrawable->count = 0;
+	}
+
+	// soft bodies: particles of both, one after the other, rewritten every 
+	//	frame and drawn as their edges; they are built before this
+	if (demoState->softBody[0].memory && demoState->softBody[1].memory)
+	{
+		a3_VertexAttributeDescriptor softBodyAttrib[1];
+		a3_VertexFormatDescriptor softBodyFormat[1];
+		a3_IndexFormatDescriptor softBodyIndexFormat[1];
+		const a3_DemoSoftBody *const cloth = demoState->softBody, *const ball = demoState->softBody + 1;
+		unsigned int *edges = (unsigned int *)malloc((cloth->constraintCount + ball->constraintCount) * 2 * sizeof(unsigned int));
+		unsigned int clothEdges, ballEdges;
+		a3vertexAttribCreateDescriptor(softBodyAttrib, a3attrib_position, a3attrib_vec3);
+		a3vertexCreateFormatDescriptor(softBodyFormat, softBodyAttrib, 1);
+		a3indexCreateFormatDescriptor(softBodyIndexFormat, a3index_int);
+
+		clothEdges = a3demo_getSoftBodyEdges(cloth, edges, 0);
+		ballEdges = a3demo_getSoftBodyEdges(ball, edges + clothEdges, cloth->particleCount);
+		vbo_ibo = demoState->ibo_softBodyEdges;
+		a3bufferCreate(vbo_ibo, a3buffer_index, (clothEdges + ballEdges) * sizeof(unsigned int), edges);
+		free(edges);
+
+		vbo_ibo = demoState->vbo_softBodyBuffer;
+		a3bufferCreate(vbo_ibo, a3buffer_vertex, a3vertexStorageSpaceRequired(softBodyFormat, cloth->particleCount + ball->particleCount), 0);
+		vao = demoState->vao_softBody;
+		a3vertexArrayCreateDescriptor(vao, vbo_ibo, softBodyFormat, 0);
+		a3vertexCreateDrawableIndexed(demoState->draw_softBody + 0, vao, demoState->ibo_softBodyEdges, softBodyIndexFormat, a3prim_lines, 0, clothEdges);
+		a3vertexCreateDrawableIndexed(demoState->draw_softBody + 1, vao, demoState->ibo_softBodyEdges, softBodyIndexFormat, a3prim_lines, clothEdges * sizeof(unsigned int), ballEdges);
+	}
 }
 
 
@@ -420,6 +524,9 @@ void a3demo_unloadGeometry(a3_DemoState *demoState)
 		a3vertexArrayReleaseDescriptor(currentVAO++);
 	while (currentDraw < endDraw)
 		a3vertexReleaseDrawable(currentDraw++);
+
+	a3demo_releaseConvexHull(demoState->teapotHull);
+	a3demo_releaseMeshBVH(demoState->teapotBVH);
 }
 
 
@@ -466,9 +573,7 @@ void a3demo_initScene(a3_DemoState *demoState)
 		demoState->sceneCamera->sceneObject->position.x = +cameraAxisPos;
 		demoState->sceneCamera->sceneObject->position.y = +cameraAxisPos;
 		demoState->sceneCamera->sceneObject->position.z = +cameraAxisPos;
-		demoState->sceneCamera->sceneObject->euler.x = -30.0f;
-		demoState->sceneCamera->sceneObject->euler.y = 45.0f;
-		demoState->sceneCamera->sceneObject->euler.z = 0.0f;
+		a3demo_setSceneObjectEuler(demoState->sceneCamera->sceneObject, -30.0f, 45.0f, 0.0f);
 	}
 	else
 	{
@@ -476,9 +581,7 @@ void a3demo_initScene(a3_DemoState *demoState)
 		demoState->sceneCamera->sceneObject->position.x = +cameraAxisPos;
 		demoState->sceneCamera->sceneObject->position.y = -cameraAxisPos;
 		demoState->sceneCamera->sceneObject->position.z = +cameraAxisPos;
-		demoState->sceneCamera->sceneObject->euler.x = 60.0f;
-		demoState->sceneCamera->sceneObject->euler.y = 0.0f;
-		demoState->sceneCamera->sceneObject->euler.z = 45.0f;
+		a3demo_setSceneObjectEuler(demoState->sceneCamera->sceneObject, 60.0f, 0.0f, 45.0f);
 	}
 
 	// same fovy to start
@@ -504,6 +607,18 @@ void a3demo_initScene(a3_DemoState *demoState)
 	demoState->planetColorIndices[3] = 3;
 	demoState->planetColorIndices[4] = 4;
 
+	// bodies mirror the planets; each starts on a circular orbit
+	a3demo_clearKeplerOrbits(demoState->keplerOrbits, demoState->bodyStore);
+	a3demo_clearBodyStore(demoState->bodyStore);
+	a3demo_resetIntegrator(demoState->integrator);
+	for (i = 0; i < demoState->planetCount; ++i)
+	{
+		const a3real speed = i ? (a3real)a3sqrt(demoState->gravityTree->gravity * a3demo_sunMass / demoState->planetObject[i].position.x) : a3realZero;
+		const a3real velocity[3] = { a3realZero, speed, a3realZero };
+		a3demo_addBody(demoState->bodyStore, demoState->planetObject[i].position.v, velocity, 
+			i ? a3demo_planetMass : a3demo_sunMass, i ? demoState->planetScales[i] : a3realOne);
+	}
+
 	demoState->displayPlanetNames = 1;
 
 
@@ -513,6 +628,230 @@ void a3demo_initScene(a3_DemoState *demoState)
 }
 
 
+// build the soft bodies from procedural shapes on the CPU (so this works 
+//	without a rendering context too): a 4x4 cloth over the ground to one 
+//	side of the system, and a soft ball next to it; both start switched off
+int a3demo_createSoftBodies(a3_DemoState *demoState)
+{
+	const a3real clothOffset[3] = { a3realZero, -8.0f, +4.0f }, ballOffset[3] = { +6.0f, -8.0f, +4.0f };
+	a3_ProceduralGeometryDescriptor shape[1];
+	a3_GeometryData data[1] = { 0 };
+	a3_DemoSoftBody *const cloth = demoState->softBody, *const ball = demoState->softBody + 1;
+	unsigned int i;
+
+	a3proceduralCreateDescriptorPlane(shape, a3geomFlag_vanilla, a3geomAxis_default, 4.0f, 4.0f, 32, 32);
+	a3proceduralGenerateGeometryData(data, shape);
+	a3demo_createSoftBody(cloth, data, a3realOne, a3realZero, 0.01f, a3realZero, demoState->jobSystem);
+	a3geometryReleaseData(data);
+	a3demo_translateSoftBody(cloth, clothOffset);
+
+	a3proceduralCreateDescriptorSphere(shape, a3geomFlag_vanilla, a3geomAxis_default, a3realOne, 16, 12);
+	a3proceduralGenerateGeometryData(data, shape);
+	a3demo_createSoftBody(ball, data, a3realOne, 0.0001f, 0.01f, a3realZero, demoState->jobSystem);
+	a3geometryReleaseData(data);
+	a3demo_translateSoftBody(ball, ballOffset);
+
+	// the system's orbital plane doubles as their ground; fewer substeps 
+	//	than the default, since they share every physics step with gravity
+	for (i = 0; i < 2; ++i)
+	{
+		demoState->softBody[i].ground[2] = a3realOne;
+		demoState->softBody[i].substeps = 4;
+	}
+	demoState->softBodiesActive = 0;
+	return (cloth->memory && ball->memory) ? 1 : -1;
+}
+
+// switch the soft bodies on, starting over from how they were built with 
+//	the cloth hung by its two far corners, or off, leaving them frozen
+int a3demo_toggleSoftBodies(a3_DemoState *demoState)
+{
+	a3_DemoSoftBody *const cloth = demoState->softBody;
+	if (!cloth->memory)
+		return -1;
+	demoState->softBodiesActive = !demoState->softBodiesActive;
+	if (demoState->softBodiesActive)
+	{
+		const a3real corner[2][3] = { { -2.0f, -6.0f, +4.0f }, { +2.0f, -6.0f, +4.0f } };
+		a3demo_resetSoftBody(cloth);
+		a3demo_resetSoftBody(demoState->softBody + 1);
+		a3demo_pinSoftBodyNearest(cloth, corner[0], 1);
+		a3demo_pinSoftBodyNearest(cloth, corner[1], 1);
+	}
+	return demoState->softBodiesActive;
+}
+
+
+// add a ring of small bodies on circular orbits around the sun
+int a3demo_addAsteroidBelt(a3_DemoState *demoState, const unsigned int count, const a3real innerRadius, const a3real outerRadius)
+{
+	a3_DemoBodyStore *const bodies = demoState->bodyStore;
+	const a3real *const sun = demoState->planetObject[0].position.v;
+	a3real *const r = (a3real *)malloc(count * 4 * sizeof(a3real)), *const s = r + count, *const c = s + count, *const h = c + count;
+	a3real position[3], velocity[3], speed;
+	unsigned int i;
+	if (!r)
+		return -1;
+
+	// radius, angle (sine in place of it) and height off the plane
+	a3demo_fillRandomUniform(r, demoState->random, count, innerRadius, outerRadius, demoState->jobSystem);
+	a3demo_fillRandomUniform(s, demoState->random, count, a3realZero, a3realTwoPi, demoState->jobSystem);
+	a3demo_fillRandomUniform(h, demoState->random, count, -a3realQuarter, a3realQuarter, demoState->jobSystem);
+	a3demo_sinCosrArray(s, c, s, count, a3demo_trig_full);
+	for (i = 0; i < count; ++i)
+	{
+		speed = (a3real)a3sqrt(demoState->gravityTree->gravity * a3demo_sunMass / r[i]);
+		position[0] = sun[0] + r[i] * c[i];
+		position[1] = sun[1] + r[i] * s[i];
+		position[2] = sun[2] + h[i];
+		velocity[0] = -speed * s[i];
+		velocity[1] = +speed * c[i];
+		velocity[2] = a3realZero;
+		if (a3demo_addBody(bodies, position, velocity, a3demo_asteroidMass, a3realZero) < 0)
+			break;
+	}
+	free(r);
+	a3demo_resetIntegrator(demoState->integrator);
+	a3demo_clearSnapshotRing(demoState->snapshotRing);
+	return i;
+}
+
+// drop everything that is not a planet
+int a3demo_removeExtraBodies(a3_DemoState *demoState)
+{
+	a3_DemoBodyStore *const bodies = demoState->bodyStore;
+	while (bodies->count > demoState->planetCount)
+		a3demo_removeBody(bodies, bodies->count - 1);
+	a3demo_pruneKeplerOrbits(demoState->keplerOrbits, bodies);
+	a3demo_resetIntegrator(demoState->integrator);
+	a3demo_clearSnapshotRing(demoState->snapshotRing);
+	return bodies->count;
+}
+
+// put everything orbiting the sun on rails, or give it all back to the 
+//	integrator; returns the number of bodies on rails
+int a3demo_toggleKeplerOrbits(a3_DemoState *demoState)
+{
+	a3_DemoBodyStore *const bodies = demoState->bodyStore;
+	a3_DemoKeplerOrbits *const orbits = demoState->keplerOrbits;
+	const double time = a3demo_getPhysicsClockWarpedTime(demoState->physicsClock);
+	unsigned int i;
+
+	if (orbits->count)
+		a3demo_clearKeplerOrbits(orbits, bodies);
+	else for (i = 1; i < bodies->count; ++i)
+		a3demo_addKeplerOrbit(orbits, bodies, i, 0, demoState->gravityTree->gravity, time);
+	a3demo_resetIntegrator(demoState->integrator);
+	a3demo_clearSnapshotRing(demoState->snapshotRing);
+	return orbits->count;
+}
+
+// stop or restart physics; returns 1 if now paused
+int a3demo_togglePhysicsPause(a3_DemoState *demoState)
+{
+	a3_DemoPhysicsClock *const clock = demoState->physicsClock;
+	if (clock->timeScale > 0.0)
+	{
+		demoState->pausedTimeScale = clock->timeScale;
+		a3demo_setPhysicsClockTimeScale(clock, 0.0);
+		return 1;
+	}
+	a3demo_setPhysicsClockTimeScale(clock, demoState->pausedTimeScale > 0.0 ? demoState->pausedTimeScale : 1.0);
+	return 0;
+}
+
+// go back some physics steps (pausing, so the result stays on screen); 
+//	stepping forward from there repeats exactly what happened before
+// returns steps still held behind the current one, or -1 if not that many
+int a3demo_rewindPhysics(a3_DemoState *demoState, const unsigned int steps)
+{
+	const int held = a3demo_rewindSnapshot(demoState->snapshotRing, steps, demoState->bodyStore, 
+		demoState->physicsClock, demoState->integrator, demoState->random);
+	if (demoState->physicsClock->timeScale > 0.0)
+		a3demo_togglePhysicsPause(demoState);
+	return held > 0 ? held - 1 : -1;
+}
+
+// take one physics step while paused; returns 1 if stepped
+int a3demo_stepPhysicsForward(a3_DemoState *demoState)
+{
+	if (demoState->physicsClock->timeScale > 0.0 || !a3demo_stepPhysicsClock(demoState->physicsClock))
+		return 0;
+	a3demo_stepPhysics(demoState, 0);
+	return 1;
+}
+
+// how far a planet's drawn shape reaches from its center: the unit 
+//	sphere scaled, or for the sun, the teapot
+a3real a3demo_getPlanetReach(const a3_DemoState *demoState, const unsigned int i)
+{
+	if (i)
+		return demoState->planetScales[i];
+	if (demoState->teapotBVH->nodeCount)
+	{
+		const a3_DemoMeshBVHNode *const root = demoState->teapotBVH->node;
+		const a3real x = a3maximum(-root->boundsMin[0], root->boundsMax[0]);
+		const a3real y = a3maximum(-root->boundsMin[1], root->boundsMax[1]);
+		const a3real z = a3maximum(-root->boundsMin[2], root->boundsMax[2]);
+		return (a3real)a3sqrt(x * x + y * y + z * z);
+	}
+	return a3realOne;
+}
+
+// distance from a point to a planet in the scene tree, for nearest 
+//	queries; zero inside it
+a3real a3demo_getPlanetDistance(const a3_DemoState *demoState, const unsigned int object, const a3real *point)
+{
+	const unsigned int i = object - (unsigned int)(demoState->planetObject - demoState->sceneObject);
+	a3real3 d;
+	a3real3Diff(d, point, demoState->planetObject[i].position.v);
+	return a3maximum(a3real3Length(d) - a3demo_getPlanetReach(demoState, i), a3realZero);
+}
+
+// keep a planet's box in the scene tree where the planet is now
+int a3demo_updateScenePlanetBox(a3_DemoState *demoState, const unsigned int i)
+{
+	const a3_DemoSceneObject *const planet = demoState->planetObject + i;
+	const a3real reach = a3demo_getPlanetReach(demoState, i);
+	a3real3 boundsMin, boundsMax;
+	a3real3Set(boundsMin, planet->position.x - reach, planet->position.y - reach, planet->position.z - reach);
+	a3real3Set(boundsMax, planet->position.x + reach, planet->position.y + reach, planet->position.z + reach);
+	return a3demo_moveDynamicTreeObject(demoState->sceneTree, (unsigned int)(planet - demoState->sceneObject), boundsMin, boundsMax);
+}
+
+// find the body under a window position and keep it as the pick, with 
+//	the planet nearest to it (other than itself); returns 1 if there 
+//	was one
+int a3demo_pickAtCursor(a3_DemoState *demoState, const int cursorX, const int cursorY)
+{
+	const unsigned int firstPlanet = (unsigned int)(demoState->planetObject - demoState->sceneObject);
+	a3real origin[3], direction[3], distance[2];
+	unsigned int object[2];
+	int i, count;
+
+	demoState->pickNearestPlanet = -1;
+	if (a3demo_getCameraPickRay(origin, direction, demoState->camera, 
+		(a3real)(cursorX + demoState->frameBorder), (a3real)(cursorY + demoState->frameBorder), 
+		(a3real)demoState->frameWidth, (a3real)demoState->frameHeight) < 0)
+		return 0;
+	if (a3demo_pickBody(demoState->pick, demoState->pickTree, demoState->bodyStore, 
+		origin, direction, demoState->camera->zfar, a3demo_pickRadius) <= 0)
+		return 0;
+
+	// a picked body wakes, so it is moved and tested again 
+	demoState->bodyStore->flags[demoState->pick->object] &= ~a3demo_bodyFlag_sleeping;
+	count = a3demo_queryDynamicTreeNearest(object, distance, 2, demoState->sceneTree, demoState->pick->point, 
+		demoState->camera->zfar, (a3_DemoDynamicTreeDistanceFunc)a3demo_getPlanetDistance, demoState);
+	for (i = 0; i < count; ++i)
+		if (object[i] - firstPlanet != demoState->pick->object)
+		{
+			demoState->pickNearestPlanet = (int)(object[i] - firstPlanet);
+			break;
+		}
+	return 1;
+}
+
+
 //-----------------------------------------------------------------------------
 
 // the handle release callbacks are no longer valid; since the library was 
@@ -534,6 +873,15 @@ void a3demo_refresh(a3_DemoState *demoState)
 		a3vertexArrayHandleUpdateReleaseCallback(currentVAO++);
 	while (currentProg < endProg)
 		a3shaderProgramHandleUpdateReleaseCallback((currentProg++)->program);
+
+	// same goes for the integrator's force callback, and the state itself 
+	//	may have moved
+	demoState->integrator->accelerate = (a3_DemoAccelerationFunc)a3demo_accelerateGravityTree;
+	demoState->integrator->user = demoState->gravityTree;
+	demoState->gravityTree->jobs = demoState->jobSystem;
+	demoState->broadphase->jobs = demoState->jobSystem;
+	demoState->softBody[0].jobs = demoState->jobSystem;
+	demoState->softBody[1].jobs = demoState->jobSystem;
 }
 
 
@@ -641,44 +989,125 @@ void a3demo_input(a3_DemoState *demoState, double dt)
 	}
 }
 
+void a3demo_updatePhysics(a3_DemoState *demoState, double dt, double time)
+{
+	a3_DemoBodyStore *const bodies = demoState->bodyStore;
+	unsigned int i;
+
+	// move everything: bodies on rails jump to where they are at the end 
+	//	of the step (warped time, so they keep up however far time warps) 
+	//	and the integrator leaves them there; it asks the gravity tree for 
+	//	forces as many times as its scheme needs, and the last of those 
+	//	already sees the rails at the end of the step, so nothing it 
+	//	carries over goes stale
+	a3demo_beginContinuous(demoState->continuous, bodies);
+	a3demo_propagateKeplerOrbits(demoState->keplerOrbits, bodies, time);
+	a3demo_stepIntegrator(demoState->integrator, bodies, (a3real)dt);
+
+	// collision candidates along the paths just taken
+	a3demo_sweepContinuous(demoState->continuous, bodies);
+	a3demo_updateBroadphase(demoState->broadphase, demoState->continuous->swept);
+
+	// fast pairs that crossed during the step go back to where they first 
+	//	touched, so the contact test below sees them instead of letting 
+	//	them pass through; moved bodies invalidate the integrator's state
+	if (a3demo_collectImpacts(demoState->continuous, 
+		demoState->broadphase->pair, demoState->broadphase->pairCount, bodies) > 0 && 
+		a3demo_applyImpacts(demoState->continuous, bodies) > 0)
+		a3demo_resetIntegrator(demoState->integrator);
+
+	// bodies are spheres, so pairs go through the batched sphere test; 
+	//	the contacts are then solved, which changes velocities and pushes 
+	//	overlapping bodies apart, so the integrator starts over
+	demoState->contactCount = (unsigned int)a3demo_collideBodySpheres(demoState->contact, demoStateMaxCount_contact, 
+		demoState->broadphase->pair, demoState->broadphase->pairCount, bodies);
+	if (a3demo_solveBodyStoreContacts(demoState->contactSolver, bodies, 
+		demoState->contact, demoState->contactCount, (a3real)dt) > 0)
+		a3demo_resetIntegrator(demoState->integrator);
+
+	// spin in degrees per second now that steps are not tied to frames
+	//	(30 matches the old one degree per 30 Hz frame); turned by 
+	//	quaternion about the local axis so no angles are rebuilt
+	for (i = 1; i < demoState->planetCount; i++)
+		a3demo_turnSceneObject(demoState->sceneObject + i, (a3real)dt * 30.0f, 0, 0, 1);
+
+	// soft bodies in their own substeps
+	if (demoState->softBodiesActive)
+		for (i = 0; i < 2; ++i)
+			a3demo_stepSoftBody(demoState->softBody + i, (a3real)dt);
+}
+
+// one fixed step of the physics clock split into its substeps, then a 
+//	snapshot of the result; pending is the number of steps the clock has 
+//	already handed out that are still to be taken after this one
+void a3demo_stepPhysics(a3_DemoState *demoState, const unsigned int pending)
+{
+	const a3_DemoPhysicsClock *const clock = demoState->physicsClock;
+	unsigned int substep;
+
+	// the clock has already counted every pending step, so this one ends 
+	//	that many steps before its warped time
+	const double time = a3demo_getPhysicsClockWarpedTime(clock) - (double)pending * clock->secondsPerStep;
+	for (substep = 0; substep < clock->substeps; ++substep)
+		a3demo_updatePhysics(demoState, clock->secondsPerSubstep, 
+			time - (double)(clock->substeps - 1 - substep) * clock->secondsPerSubstep);
+	a3demo_captureSnapshot(demoState->snapshotRing, demoState->bodyStore, demoState->physicsClock, pending, 
+		demoState->integrator, demoState->random);
+}
+
 void a3demo_update(a3_DemoState *demoState, double dt)
 {
 	unsigned int i;
 
-	const double daysPerHour = 1.0 / 24.0;
+	// pull simulated positions for rendering
+	a3demo_writeBodyPositions(demoState->bodyStore, demoState->planetObject, 0, demoState->planetCount);
 
+	// only the bodies that left their boxes in the pick tree move in it
+	if (!demoState->headless)
+		a3demo_updateBodyPickTree(demoState->pickTree, demoState->bodyStore, a3demo_pickRadius);
 
-	for (unsigned int i = 1; i < demoState->planetCount; i++)
+	// stream the rest as points
+	i = demoState->bodyStore->count > demoState->planetCount ? demoState->bodyStore->count - demoState->planetCount : 0;
+	if (!demoState->headless)
 	{
-		if (demoState->verticalAxis)
+		if (i)
 		{
-			// y-up
+			a3demo_packBodyPositions(demoState->bodyStore, demoState->bodyPointData, demoState->planetCount, i);
+			a3bufferFillOffset(demoState->vbo_bodyPointBuffer, 0, 0, i * 3 * sizeof(a3real), demoState->bodyPointData, 0);
 		}
-		else
-		{
-			// z-up
-			a3real x = demoState->planetObject[i].position.x;
-			a3real y = demoState->planetObject[i].position.y;
-
-			//Calculate speed based on how far planet is from sun, farther planets away move slower
-			a3real distToSun = (a3real)a3sqrt((a3f64)(x * x) + (a3f64)(y * y));
-			a3real speed = (1/distToSun) * 100;
-			
-			//Move positions using simple trig
-			a3real newX = x*a3cosd((a3real)dt * speed) - y*a3sind((a3real)dt * speed);
-			a3real newY = x*a3sind((a3real)dt * speed) + y*a3cosd((a3real)dt * speed);
-
-			a3vec3 newPos;
-			newPos.x = newX;
-			newPos.y = newY;
-			newPos.z = 0;
+		demoState->draw_bodyPoints->count = i;
 
-			demoState->planetObject[i].position = newPos;
-			a3demo_rotateSceneObject(demoState->sceneObject + i, 1, 0, 0, 1);
+		// soft body particles go up as they are
+		if (demoState->softBodiesActive)
+		{
+			a3bufferFillOffset(demoState->vbo_softBodyBuffer, 0, 0, 
+				demoState->softBody[0].particleCount * 3 * sizeof(a3real), demoState->softBody[0].position, 0);
+			a3bufferFillOffset(demoState->vbo_softBodyBuffer, 0, demoState->softBody[0].particleCount * 3 * sizeof(a3real), 
+				demoState->softBody[1].particleCount * 3 * sizeof(a3real), demoState->softBody[1].position, 0);
 		}
 	}
 
-	// update scene objects
+	// update planets first: the raw geometry is all unit size so we apply 
+	//	scale as needed, but only to matrices rebuilt this frame, since a 
+	//	sleeping object keeps its scaled matrix
+	// do not change the raw geometry's size as this will complicate things later
+	for (i = 0; i < demoState->planetCount; ++i)
+		if (a3demo_updateSceneObject(demoState->planetObject + i))
+		{
+			if (i)
+			{
+				// hint: multiply the rotation columns in the model matrix
+				//	by the appropriate scale value, whatever that may be...
+				a3real3MulS(demoState->planetObject[i].modelMat.m[0], demoState->planetScales[i]);
+				a3real3MulS(demoState->planetObject[i].modelMat.m[1], demoState->planetScales[i]);
+				a3real3MulS(demoState->planetObject[i].modelMat.m[2], demoState->planetScales[i]);
+			}
+
+			// the same objects, and only those, move in the scene tree
+			a3demo_updateScenePlanetBox(demoState, i);
+		}
+
+	// update whatever else changed; everything else is asleep and skipped
 	for (i = 0; i < demoStateMaxCount_sceneObject; ++i)
 		a3demo_updateSceneObject(demoState->sceneObject + i);
 
@@ -686,16 +1115,18 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 	for (i = 0; i < demoStateMaxCount_camera; ++i)
 		a3demo_updateCameraViewProjection(demoState->camera + i);
 
-
-	// the raw geometry is all unit size so we apply scale as needed
-	// do not change the raw geometry's size as this will complicate things later
-	for (i = 1; i < demoState->planetCount; ++i)
+	// what the camera can see, from the scene tree
+	if (!demoState->headless)
 	{
-		// hint: multiply the rotation columns in the model matrix
-		//	by the appropriate scale value, whatever that may be...
-		a3real3MulS(demoState->planetObject[i].modelMat.m[0], demoState->planetScales[i]);
-		a3real3MulS(demoState->planetObject[i].modelMat.m[1], demoState->planetScales[i]);
-		a3real3MulS(demoState->planetObject[i].modelMat.m[2], demoState->planetScales[i]);
+		a3real planes[24];
+		unsigned int visible[demoStateMaxCount_sceneObject];
+		int count;
+		memset(demoState->sceneObjectVisible, 0, sizeof(demoState->sceneObjectVisible));
+		a3demo_getCameraFrustumPlanes(planes, demoState->camera);
+		count = a3demo_queryDynamicTreePlanes(visible, demoStateMaxCount_sceneObject, demoState->sceneTree, planes, 6);
+		demoState->sceneVisibleCount = count > 0 ? (unsigned int)count : 0;
+		for (i = 0; i < demoState->sceneVisibleCount; ++i)
+			demoState->sceneObjectVisible[visible[i]] = 1;
 	}
 }
 
@@ -757,9 +1188,12 @@ void a3demo_render(const a3_DemoState *demoState)
 		0.0f, 0.0f, 0.0f, +1.0f,
 	};
 
-	// final model matrix and full matrix stack
-	a3mat4 modelMat = a3identityMat4, modelMatInv = a3identityMat4, modelMatOrig = a3identityMat4,
-		modelViewProjectionMat = a3identityMat4;
+	// full matrix stack
+	a3mat4 modelViewProjectionMat = a3identityMat4;
+
+	// model matrices and stacks for every planet, worked out in one pass each
+	a3mat4 planetModelMat[demoStateMaxCount_sceneObject], planetModelMatInv[demoStateMaxCount_sceneObject],
+		planetModelViewProjectionMat[demoStateMaxCount_sceneObject];
 
 	// current scene object being rendered, for convenience
 	const a3_DemoSceneObject *currentSceneObject;
@@ -811,6 +1245,18 @@ void a3demo_render(const a3_DemoState *demoState)
 	//	- send uniforms
 	//	- draw
 
+	// planet matrices: scene objects keep theirs a struct apart, and the 
+	//	conversion and view-projection are the same for all (stride zero)
+	if (!useVerticalY)
+		a3demo_real4x4ProductArray(&planetModelMat->m, sizeof(a3mat4), 
+			&demoState->planetObject->modelMat.m, sizeof(a3_DemoSceneObject), &convertY2Z.m, 0, demoState->planetCount);
+	else
+		for (i = 0; i < demoState->planetCount; ++i)
+			planetModelMat[i] = demoState->planetObject[i].modelMat;
+	a3demo_real4x4TransformInverseIgnoreScaleArray(&planetModelMatInv->m, sizeof(a3mat4), &planetModelMat->m, sizeof(a3mat4), demoState->planetCount);
+	a3demo_real4x4ProductArray(&planetModelViewProjectionMat->m, sizeof(a3mat4), 
+		&demoState->camera->viewProjectionMat.m, 0, &planetModelMat->m, sizeof(a3mat4), demoState->planetCount);
+
 	// draw models
 	currentDemoProgram = demoState->prog_drawColorUnif;
 	a3shaderProgramActivate(currentDemoProgram->program);
@@ -823,14 +1269,10 @@ void a3demo_render(const a3_DemoState *demoState)
 	{
 		currentDrawable = demoState->draw_sphere;
 		currentSceneObject = demoState->planetObject + i;
+		if (!demoState->sceneObjectVisible[currentSceneObject - demoState->sceneObject])
+			continue;
 
-		modelMatOrig = currentSceneObject->modelMat;
-		if (!useVerticalY)
-			a3real4x4Product(modelMat.m, modelMatOrig.m, convertY2Z.m);
-		else
-			modelMat = modelMatOrig;
-		a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-		a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
+		modelViewProjectionMat = planetModelViewProjectionMat[i];
 
 		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
 		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, planetColor[demoState->planetColorIndices[i]]);
@@ -838,22 +1280,38 @@ void a3demo_render(const a3_DemoState *demoState)
 	}
 
 	
+	// extra bodies: positions are already in scene space
+	currentDrawable = demoState->draw_bodyPoints;
+	if (currentDrawable->count)
+	{
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, demoState->camera->viewProjectionMat.mm);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, grey);
+		a3vertexActivateAndRenderDrawable(currentDrawable);
+	}
+
+	// soft bodies: also in scene space, as wireframes
+	if (demoState->softBodiesActive)
+	{
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, demoState->camera->viewProjectionMat.mm);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, skyblue);
+		a3vertexActivateAndRenderDrawable(demoState->draw_softBody + 0);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, magenta);
+		a3vertexActivateAndRenderDrawable(demoState->draw_softBody + 1);
+	}
+
+	
 	// teapot
 	i = 0;
 	currentDrawable = demoState->draw_teapot;
 	currentSceneObject = demoState->planetObject;	// the sun is now a teapot
+	if (demoState->sceneObjectVisible[currentSceneObject - demoState->sceneObject])
+	{
+		modelViewProjectionMat = planetModelViewProjectionMat[i];	// teapot's axis is Y too
 
-	modelMatOrig = currentSceneObject->modelMat;
-	if (!useVerticalY)	// teapot's axis is Y
-		a3real4x4Product(modelMat.m, modelMatOrig.m, convertY2Z.m);
-	else
-		modelMat = modelMatOrig;
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, yellow);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, yellow);
+		a3vertexActivateAndRenderDrawable(currentDrawable);
+	}
 
 
 	glDisable(GL_DEPTH_TEST);
@@ -935,10 +1393,53 @@ void a3demo_render(const a3_DemoState *demoState)
 		a3textDraw(demoState->text, -0.98f, +0.90f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
 			"Demo mode (%u / %u): ", demoState->demoMode + 1, demoState->demoModeCount);
 		a3textDraw(demoState->text, -0.98f, +0.80f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-			"    %s", demoModeText[demoState->demoMode]);
+			"    %s | picked: %s %d (nearest planet %d) | in view: %u of %u planets", demoModeText[demoState->demoMode], 
+			demoState->pick->object >= demoState->bodyStore->count ? "nothing" : demoState->pick->object < demoState->planetCount ? "planet" : "body", 
+			demoState->pick->object < demoState->bodyStore->count ? (int)demoState->pick->object : -1, 
+			demoState->pickNearestPlanet, demoState->sceneVisibleCount, demoState->planetCount);
+		a3textDraw(demoState->text, -0.98f, +0.70f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"Physics: %.0f Hz x %u substeps, %s (%u steps last update, %u dropped)", 
+			demoState->physicsClock->stepsPerSecond, demoState->physicsClock->substeps, 
+			a3demo_getIntegratorName(demoState->integrator->type), 
+			demoState->physicsClock->stepsLastUpdate, demoState->physicsClock->droppedSteps);
+		a3textDraw(demoState->text, -0.98f, +0.60f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"Bodies: %u (Barnes-Hut theta %.1f, %u nodes, %u workers)", 
+			demoState->bodyStore->count, demoState->gravityTree->theta, demoState->gravityTree->nodeCount, 
+			demoState->jobSystem->workerCount);
+		a3textDraw(demoState->text, -0.98f, +0.50f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"Time warp: %.0fx (t = %.1f s) | Kepler: %u on rails, %u Newton passes", 
+			demoState->physicsClock->timeScale, a3demo_getPhysicsClockWarpedTime(demoState->physicsClock), 
+			demoState->keplerOrbits->count, demoState->keplerOrbits->iterations);
+		a3textDraw(demoState->text, -0.98f, +0.40f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"Broadphase: %s, %u pairs (%u swaps, %u re-sorts), %u contacts, %u fast, %u impacts", 
+			a3demo_getBroadphaseName(demoState->broadphase->type), demoState->broadphase->pairCount, 
+			demoState->broadphase->swaps, demoState->broadphase->rebuilds, demoState->contactCount, 
+			demoState->continuous->fastCount, demoState->continuous->eventCount);
+		a3textDraw(demoState->text, -0.98f, +0.30f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"Replay: %s at step %u, %u of %u steps back held", 
+			demoState->physicsClock->timeScale > 0.0 ? "running" : "PAUSED", demoState->physicsClock->steps, 
+			demoState->snapshotRing->size ? demoState->snapshotRing->size - 1 : 0, demoState->snapshotRing->frames);
+		if (demoState->softBodiesActive)
+			a3textDraw(demoState->text, -0.98f, +0.20f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+				"Soft bodies: cloth %u particles, %.1f%% stretch | ball %u particles, volume %.3f", 
+				demoState->softBody[0].particleCount, demoState->softBody[0].maxStrain * 100.0f, 
+				demoState->softBody[1].particleCount, demoState->softBody[1].restVolume > a3realZero ? demoState->softBody[1].volume / demoState->softBody[1].restVolume : a3realZero);
 
 
 		// display controls
+		a3textDraw(demoState->text, -0.98f, -0.40f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Bodies: 'b' add belt | 'B' clear extras | '[' ']' theta | 'g' gravity benchmark | 'j' 'J' job system stress, random fills | 'o' 'O' 'U' SIMD, quaternion, trig benchmarks ");
+		a3textDraw(demoState->text, -0.98f, -0.30f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Integrator: 'i' cycle | 'I' drift benchmark (10^6 steps) ");
+		a3textDraw(demoState->text, -0.98f, -0.20f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Orbits: 'k' toggle Kepler rails | '-' '=' time warp /10 x10 ");
+		a3textDraw(demoState->text, -0.98f, -0.10f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Collision: 'c' cycle broadphase | 'C' broadphase benchmark | 'V' contact solver benchmark | 'Z' sleep benchmark | 'X' tunneling benchmark | 'h' hull benchmark | 'G' GJK benchmark | 'y' mesh BVH benchmark | 'u' picking benchmark | 'n' dynamic tree benchmark ");
+		a3textDraw(demoState->text, -0.98f, +0.10f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Soft bodies: 'l' drop cloth and ball / hide | 'L' XPBD benchmark | 'm' mass properties check ");
+		a3textDraw(demoState->text, -0.98f, +0.00f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+			"    Replay: 'p' pause/resume | 'r' step back | 'f' step forward | 'R' back to oldest ");
+
 		if (a3XboxControlIsConnected(demoState->xcontrol))
 		{
 			a3textDraw(demoState->text, -0.98f, -0.50f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
@@ -951,7 +1452,7 @@ void a3demo_render(const a3_DemoState *demoState)
 			a3textDraw(demoState->text, -0.98f, -0.50f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
 				"Keyboard/mouse camera control: ");
 			a3textDraw(demoState->text, -0.98f, -0.60f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-				"    Left click and drag = rotate | WASDEQ = move");
+				"    Left click and drag = rotate | Right click = pick | WASDEQ = move");
 		}
 
 		a3textDraw(demoState->text, -0.98f, -0.70f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
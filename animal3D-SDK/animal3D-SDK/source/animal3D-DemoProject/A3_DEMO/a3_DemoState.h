@@ -41,6 +41,23 @@
 
 #include "_utilities/a3_DemoSceneObject.h"
 #include "_utilities/a3_DemoShaderProgram.h"
+#include "_utilities/a3_DemoJobSystem.h"
+#include "_utilities/a3_DemoRandom.h"
+#include "_physics/a3_DemoPhysicsClock.h"
+#include "_physics/a3_DemoBodyStore.h"
+#include "_physics/a3_DemoGravity.h"
+#include "_physics/a3_DemoIntegrator.h"
+#include "_physics/a3_DemoKepler.h"
+#include "_physics/a3_DemoBroadphase.h"
+#include "_physics/a3_DemoContinuous.h"
+#include "_physics/a3_DemoNarrowphase.h"
+#include "_physics/a3_DemoContactSolver.h"
+#include "_physics/a3_DemoSnapshot.h"
+#include "_physics/a3_DemoSoftBody.h"
+#include "_physics/a3_DemoMassProperties.h"
+#include "_physics/a3_DemoConvexHull.h"
+#include "_physics/a3_DemoMeshBVH.h"
+#include "_physics/a3_DemoPicking.h"
 
 
 //-----------------------------------------------------------------------------
@@ -64,10 +81,13 @@ enum a3_DemoStateObjectMaxCounts
 	demoStateMaxCount_sceneObject = 25,
 	demoStateMaxCount_camera = 1,
 	demoStateMaxCount_timer = 1,
-	demoStateMaxCount_drawDataBuffer = 1,
-	demoStateMaxCount_vertexArray = 4,
-	demoStateMaxCount_drawable = 8,
+	demoStateMaxCount_drawDataBuffer = 4,
+	demoStateMaxCount_vertexArray = 6,
+	demoStateMaxCount_drawable = 11,
 	demoStateMaxCount_shaderProgram = 2,
+	demoStateMaxCount_body = 131072,
+	demoStateMaxCount_contact = 65536,
+	demoStateMaxCount_shapeCollider = 4,
 };
 
 
@@ -88,6 +108,10 @@ struct a3_DemoState
 	// asset streaming between loads enabled (careful!)
 	int streaming;
 
+	// loaded without a window or rendering context: nothing is drawn or 
+	//	uploaded, and physics steps as fast as it is idled
+	int headless;
+
 	// window and full-frame dimensions
 	unsigned int windowWidth, windowHeight;
 	unsigned int frameWidth, frameHeight;
@@ -106,8 +130,10 @@ struct a3_DemoState
 	a3_KeyboardInput keyboard[1];
 	a3_XboxControllerInput xcontrol[4];
 
-	// pointer to fast trig table
-	float trigTable[4096 * 4];
+	// pointer to fast trig table; kept on the heap since only the 
+	//	prebuilt A3DM and A3DG routines still read it, the demo's own 
+	//	sine and cosine come from the polynomials (a3_DemoTrig)
+	float *trigTable;
 
 	int planetColorIndices[demoStateMaxCount_sceneObject];
 	float planetScales[demoStateMaxCount_sceneObject];
@@ -157,13 +183,89 @@ struct a3_DemoState
 		};
 	};
 
+	// work-stealing scheduler; this thread is worker 0
+	a3_DemoJobSystem jobSystem[1];
+
+	// fixed-step physics clock (runs alongside the render timer); paused 
+	//	by zeroing its time scale, which is kept here meanwhile
+	a3_DemoPhysicsClock physicsClock[1];
+	double pausedTimeScale;
+
+	// recent physics steps for stepping backwards, and the demo's random 
+	//	stream, which they restore along with the bodies
+	a3_DemoSnapshotRing snapshotRing[1];
+	a3_DemoRandom random[1];
+
+	// simulated bodies (heap, SoA); planets are the first bodies
+	a3_DemoBodyStore bodyStore[1];
+
+	// gravity solver and time integrator that drives it
+	a3_DemoGravityTree gravityTree[1];
+	a3_DemoIntegrator integrator[1];
+
+	// bodies on analytic orbits instead of the integrator
+	a3_DemoKeplerOrbits keplerOrbits[1];
+
+	// collision candidates, refreshed every physics step; the broadphase 
+	//	runs on spheres around each body's whole step, so bodies that 
+	//	passed through each other are still paired and caught
+	a3_DemoBroadphase broadphase[1];
+	a3_DemoContinuous continuous[1];
+
+	// contacts between touching bodies (heap) and the solver that 
+	//	resolves them each step, and analytic colliders matching the 
+	//	procedural shapes (ground plane, sphere, cylinder, torus)
+	a3_DemoContactManifold *contact;
+	unsigned int contactCount;
+	a3_DemoContactSolver contactSolver[1];
+	a3_DemoCollider shapeCollider[demoStateMaxCount_shapeCollider];
+
+	// mass properties at unit density of the same shapes and of the 
+	//	teapot; they go in the geometry stream along with the meshes
+	a3_DemoMassProperties shapeMassProperties[demoStateMaxCount_shapeCollider];
+	a3_DemoMassProperties teapotMassProperties[1];
+
+	// convex proxy standing in for the teapot's triangles in collision 
+	//	queries, built with the geometry (heap)
+	a3_DemoConvexHull teapotHull[1];
+
+	// tree over the teapot's own triangles for exact ray and sphere 
+	//	casts, built with the geometry (heap)
+	a3_DemoMeshBVH teapotBVH[1];
+
+	// tree over the bodies for picking with the cursor, kept up to date 
+	//	every frame, and what the last pick found
+	a3_DemoDynamicTree pickTree[1];
+	a3_DemoPickHit pick[1];
+
+	// tree over the scene objects' boxes, where only objects rebuilt in 
+	//	a frame move; it picks out the planets in the camera's frustum 
+	//	to draw and the planet nearest the last pick
+	a3_DemoDynamicTree sceneTree[1];
+	int sceneObjectVisible[demoStateMaxCount_sceneObject];
+	unsigned int sceneVisibleCount;
+	int pickNearestPlanet;
+
+	// interleaved positions of extra bodies, staged for upload (heap)
+	a3real *bodyPointData;
+
+	// deformable bodies off to the side of the system on their own ground 
+	//	(a cloth hanging from two corners, then a soft ball); they step 
+	//	with the physics clock while switched on, but are not kept in 
+	//	snapshots, so stepping back leaves them where they are
+	a3_DemoSoftBody softBody[2];
+	int softBodiesActive;
+
 
 	// draw data buffers
 	union {
 		a3_VertexBuffer drawDataBuffer[demoStateMaxCount_drawDataBuffer];
 		struct {
 			a3_VertexBuffer
-				vbo_staticSceneObjectDrawBuffer[1];			// buffer to hold all data for static scene objects (e.g. grid)
+				vbo_staticSceneObjectDrawBuffer[1],			// buffer to hold all data for static scene objects (e.g. grid)
+				vbo_bodyPointBuffer[1],						// buffer streamed with body positions every frame
+				vbo_softBodyBuffer[1],						// buffer streamed with soft body particles every frame
+				ibo_softBodyEdges[1];						// edges of the soft bodies as lines
 		};
 	};
 
@@ -175,7 +277,9 @@ struct a3_DemoState
 				vao_position[1],							// VAO for vertex format with only position
 				vao_position_color[1],						// VAO for vertex format with position and color
 				vao_position_texcoord[1],					// VAO for vertex format with position and UVs
-				vao_tangent_basis[1];						// VAO for vertex format with full tangent basis
+				vao_tangent_basis[1],						// VAO for vertex format with full tangent basis
+				vao_bodyPoints[1],							// VAO for streamed body positions
+				vao_softBody[1];							// VAO for streamed soft body particles
 		};
 	};
 
@@ -191,7 +295,9 @@ struct a3_DemoState
 				draw_sphere[1],								// high-res sphere mesh
 				draw_cylinder[1],							// high-res cylinder mesh
 				draw_torus[1],								// high-res torus mesh
-				draw_teapot[1];								// can't not have a Utah teapot
+				draw_teapot[1],								// can't not have a Utah teapot
+				draw_bodyPoints[1],							// extra bodies (belts, clusters) as points
+				draw_softBody[2];							// soft body wireframes
 		};
 	};
 
@@ -226,6 +332,15 @@ void a3demo_unloadGeometry(a3_DemoState *demoState);
 void a3demo_unloadShaders(a3_DemoState *demoState);
 
 void a3demo_initScene(a3_DemoState *demoState);
+int a3demo_addAsteroidBelt(a3_DemoState *demoState, const unsigned int count, const a3real innerRadius, const a3real outerRadius);
+int a3demo_removeExtraBodies(a3_DemoState *demoState);
+int a3demo_toggleKeplerOrbits(a3_DemoState *demoState);
+int a3demo_togglePhysicsPause(a3_DemoState *demoState);
+int a3demo_rewindPhysics(a3_DemoState *demoState, const unsigned int steps);
+int a3demo_stepPhysicsForward(a3_DemoState *demoState);
+int a3demo_createSoftBodies(a3_DemoState *demoState);
+int a3demo_toggleSoftBodies(a3_DemoState *demoState);
+int a3demo_pickAtCursor(a3_DemoState *demoState, const int cursorX, const int cursorY);
 
 void a3demo_refresh(a3_DemoState *demoState);
 
@@ -233,6 +348,8 @@ void a3demo_validateUnload(const a3_DemoState *demoState);
 
 // main loop
 void a3demo_input(a3_DemoState *demoState, double dt);
+void a3demo_updatePhysics(a3_DemoState *demoState, double dt, double time);
+void a3demo_stepPhysics(a3_DemoState *demoState, const unsigned int pending);
 void a3demo_update(a3_DemoState *demoState, double dt);
 void a3demo_render(const a3_DemoState *demoState);
 
@@ -30,6 +30,9 @@
 
 #include "a3_dylib_config_export.h"
 #include "a3_DemoState.h"
+#include "_physics/a3_DemoPhysicsBenchmark.h"
+#include "_utilities/a3_DemoJobBenchmark.h"
+#include "_utilities/a3_DemoMathBenchmark.h"
 
 
 #include <stdio.h>
@@ -60,6 +63,90 @@ inline void a3demo_initializeText(a3_TextRenderer *text)
 }
 
 
+// load everything; headless skips the window's rendering context and 
+//	anything that needs it, and steps physics as fast as it is idled 
+//	instead of in real time, so runs do not depend on the machine
+a3_DemoState *a3demo_load(const int headless)
+{
+	// HEAP allocate persistent state
+	// stack object will be deleted at the end of the function
+	// good idea to set the whole block of memory to zero
+	const unsigned int stateSize = a3demo_getPersistentStateSize();
+	a3_DemoState *demoState = (a3_DemoState *)malloc(stateSize);
+	memset(demoState, 0, stateSize);
+	demoState->headless = headless;
+
+	// set up trig table (A3DM)
+	demoState->trigTable = (float *)malloc(sizeof(float) * 4096 * 4);
+	a3trigInit(4, demoState->trigTable);
+
+	// initialize state variables
+	// e.g. timer, thread, etc.
+	a3timerSet(demoState->renderTimer, headless ? 0.0 : 30.0);
+	a3timerStart(demoState->renderTimer);
+
+	// one worker per hardware thread, counting this one
+	a3demo_initJobSystem(demoState->jobSystem, 0);
+
+	// physics steps on its own fixed clock, independent of rendering
+	a3demo_initPhysicsClock(demoState->physicsClock, 240.0, 1, 16);
+	a3demo_setPhysicsClockUncapped(demoState->physicsClock, headless);
+	a3demo_startPhysicsClock(demoState->physicsClock);
+
+	// a second of steps to go back through, fewer if there are many bodies
+	a3demo_createSnapshotRing(demoState->snapshotRing, 240, 64 * 1024 * 1024);
+	a3demo_seedRandom(demoState->random, 1);
+
+	// body storage and gravity
+	a3demo_createBodyStore(demoState->bodyStore, demoStateMaxCount_body);
+	demoState->bodyPointData = (a3real *)malloc(demoStateMaxCount_body * 3 * sizeof(a3real));
+	a3demo_initGravityTree(demoState->gravityTree, 1.0f, 0.05f, 0.5f, 8, demoState->jobSystem);
+	a3demo_initIntegrator(demoState->integrator, a3demo_integrator_velocityVerlet, 
+		(a3_DemoAccelerationFunc)a3demo_accelerateGravityTree, demoState->gravityTree);
+	a3demo_createKeplerOrbits(demoState->keplerOrbits, demoStateMaxCount_body);
+	a3demo_initBroadphase(demoState->broadphase, a3demo_broadphase_spatialHash, demoState->jobSystem);
+	a3demo_createContinuous(demoState->continuous, demoStateMaxCount_body, 0.5f);
+	a3demo_createDynamicTree(demoState->pickTree, demoStateMaxCount_body, 0.5f);
+	demoState->pick->object = -1;
+	a3demo_createDynamicTree(demoState->sceneTree, demoStateMaxCount_sceneObject, 0.5f);
+	demoState->pickNearestPlanet = -1;
+	demoState->contact = (a3_DemoContactManifold *)malloc(demoStateMaxCount_contact * sizeof(a3_DemoContactManifold));
+	a3demo_initContactSolver(demoState->contactSolver, 0, demoState->jobSystem);
+	demoState->contactSolver->warmStart = 0;
+	a3demo_createSoftBodies(demoState);
+
+	// use Y-"up"
+//	demoState->verticalAxis = 1;
+
+	// enable asset streaming between loads
+//	demoState->streaming = 1;
+
+
+	if (!headless)
+	{
+		// text
+		a3demo_initializeText(demoState->text);
+		demoState->textInit = demoState->showText = 1;
+
+		// set default GL state
+		a3demo_setDefaultGraphicsState();
+
+		// geometry
+		a3demo_loadGeometry(demoState);
+
+		// shaders
+		a3demo_loadShaders(demoState);
+	}
+
+	// scene objects
+	a3demo_initScene(demoState);
+
+
+	// return persistent state pointer
+	return demoState;
+}
+
+
 //-----------------------------------------------------------------------------
 // callback prototypes
 // NOTE: do not move to header; they should be private to this file
@@ -77,6 +164,7 @@ extern "C"
 #endif	// __cplusplus
 
 	A3API a3_DemoState *a3test_load();
+	A3API a3_DemoState *a3test_loadHeadless();
 	A3API void a3test_unload(a3_DemoState *demoState, int hotload);
 	A3API a3_DemoState *a3test_hotload(a3_DemoState *demoState);
 	A3API int a3test_display(a3_DemoState *demoState);
@@ -108,48 +196,13 @@ extern "C"
 // demo is loaded
 A3API a3_DemoState *a3test_load()
 {
-	// HEAP allocate persistent state
-	// stack object will be deleted at the end of the function
-	// good idea to set the whole block of memory to zero
-	const unsigned int stateSize = a3demo_getPersistentStateSize();
-	a3_DemoState *demoState = (a3_DemoState *)malloc(stateSize);
-	memset(demoState, 0, stateSize);
-
-	// set up trig table (A3DM)
-	a3trigInit(4, demoState->trigTable);
-
-	// initialize state variables
-	// e.g. timer, thread, etc.
-	a3timerSet(demoState->renderTimer, 30.0);
-	a3timerStart(demoState->renderTimer);
-
-	// text
-	a3demo_initializeText(demoState->text);
-	demoState->textInit = demoState->showText = 1;
-
-
-	// use Y-"up"
-//	demoState->verticalAxis = 1;
-
-	// enable asset streaming between loads
-//	demoState->streaming = 1;
-
-
-	// set default GL state
-	a3demo_setDefaultGraphicsState();
-
-	// geometry
-	a3demo_loadGeometry(demoState);
-
-	// shaders
-	a3demo_loadShaders(demoState);
-
-	// scene objects
-	a3demo_initScene(demoState);
-
+	return a3demo_load(0);
+}
 
-	// return persistent state pointer
-	return demoState;
+// demo is loaded by a host with no window (e.g. the headless runner)
+A3API a3_DemoState *a3test_loadHeadless()
+{
+	return a3demo_load(1);
 }
 
 // demo is unloaded; option to unload to prep for hotload
@@ -157,7 +210,8 @@ A3API void a3test_unload(a3_DemoState *demoState, int hotload)
 {
 	// release things that need releasing always, whether hotloading or not
 	// e.g. kill thread
-	// nothing in this example, but then...
+	// workers run code from this library, so they stop either way
+	a3demo_releaseJobSystem(demoState->jobSystem);
 
 	// release persistent state if not hotloading
 	// good idea to release in reverse order that things were loaded...
@@ -166,18 +220,44 @@ A3API void a3test_unload(a3_DemoState *demoState, int hotload)
 	//	no need to reverse!
 	if (!hotload)
 	{
+		// a headless run reports what it got through
+		if (demoState->headless)
+			printf("\n HEADLESS RUN: %u physics steps (%u substeps each) in %.3f s, %.1f steps/s, %u bodies, t = %.1f s simulated\n",
+				demoState->physicsClock->steps, demoState->physicsClock->substeps, demoState->physicsClock->timer->totalTime, 
+				demoState->physicsClock->timer->totalTime > 0.0 ? demoState->physicsClock->steps / demoState->physicsClock->timer->totalTime : 0.0, 
+				demoState->bodyStore->count, demoState->physicsClock->totalTime);
+
 		// free fixed objects
-		a3textRelease(demoState->text);
+		if (!demoState->headless)
+			a3textRelease(demoState->text);
+		a3demo_releaseSnapshotRing(demoState->snapshotRing);
+		a3demo_releaseContactSolver(demoState->contactSolver);
+		free(demoState->contact);
+		a3demo_releaseContinuous(demoState->continuous);
+		a3demo_releaseDynamicTree(demoState->pickTree);
+		a3demo_releaseDynamicTree(demoState->sceneTree);
+		a3demo_releaseBroadphase(demoState->broadphase);
+		a3demo_releaseKeplerOrbits(demoState->keplerOrbits);
+		a3demo_releaseIntegrator(demoState->integrator);
+		a3demo_releaseGravityTree(demoState->gravityTree);
+		a3demo_releaseBodyStore(demoState->bodyStore);
+		free(demoState->bodyPointData);
+		a3demo_releaseSoftBody(demoState->softBody + 0);
+		a3demo_releaseSoftBody(demoState->softBody + 1);
 
 		// free graphics objects
-		a3demo_unloadGeometry(demoState);
-		a3demo_unloadShaders(demoState);
+		if (!demoState->headless)
+		{
+			a3demo_unloadGeometry(demoState);
+			a3demo_unloadShaders(demoState);
 
-		// validate unload
-		a3demo_validateUnload(demoState);
+			// validate unload
+			a3demo_validateUnload(demoState);
+		}
 
 		// erase other stuff
 		a3trigFree();
+		free(demoState->trigTable);
 
 		// erase persistent state
 		free(demoState);
@@ -195,16 +275,22 @@ A3API a3_DemoState *a3test_hotload(a3_DemoState *demoState)
 	else
 	{
 		const unsigned int stateSize = a3demo_getPersistentStateSize();
-		a3_DemoState copy = *demoState;
-
-		// example 1: copy memory directly
+		a3_DemoState *moved = (a3_DemoState *)malloc(stateSize);
+
+		// example 1: copy memory directly, block to block; going through 
+		//	a copy on the stack would move the whole state twice, and 
+		//	everything big that is simulated (bodies, snapshots) is on 
+		//	the heap and only needs its pointers carried over
+		memset(moved, 0, stateSize);
+		memcpy(moved, demoState, sizeof(a3_DemoState));
 		free(demoState);
-		demoState = (a3_DemoState *)malloc(stateSize);
-		memset(demoState, 0, stateSize);
-		*demoState = copy;
+		demoState = moved;
 
 		a3demo_refresh(demoState);
 		a3trigInitSetTables(4, demoState->trigTable);
+
+		// workers were stopped on unload; restart them in the new code
+		a3demo_initJobSystem(demoState->jobSystem, 0);
 	}
 
 	// return pointer to new persistent state
@@ -226,12 +312,19 @@ A3API int a3test_idle(a3_DemoState *demoState)
 	// perform any idle tasks, such as rendering
 	if (!demoState->exitFlag)
 	{
+		// physics runs every idle, taking however many fixed steps have 
+		//	accumulated since the last one; rendering stalls do not slow it
+		unsigned int steps = a3demo_updatePhysicsClock(demoState->physicsClock);
+		while (steps--)
+			a3demo_stepPhysics(demoState, steps);
+
 		if (a3timerUpdate(demoState->renderTimer) > 0)
 		{
 			// render timer ticked, update demo state and draw
 			a3demo_update(demoState, demoState->renderTimer->secondsPerTick);
 			a3demo_input(demoState, demoState->renderTimer->secondsPerTick);
-			a3demo_render(demoState);
+			if (!demoState->headless)
+				a3demo_render(demoState);
 
 			// update input
 			a3mouseUpdate(demoState->mouse);
@@ -290,7 +383,8 @@ A3API void a3test_windowResize(a3_DemoState *demoState, int newWindowWidth, int
 	demoState->frameHeight = frameHeight;
 
 	// use framebuffer deactivate utility to set viewport
-	a3framebufferDeactivateSetViewport(a3fbo_depthDisable, -frameBorder, -frameBorder, demoState->frameWidth, demoState->frameHeight);
+	if (!demoState->headless)
+		a3framebufferDeactivateSetViewport(a3fbo_depthDisable, -frameBorder, -frameBorder, demoState->frameWidth, demoState->frameHeight);
 
 	// viewing info for projection matrix
 	demoState->camera->aspect = (a3real)frameWidth / (a3real)frameHeight;
@@ -339,6 +433,8 @@ A3API void a3test_keyCharPress(a3_DemoState *demoState, int asciiKey)
 
 		// reload (T) or toggle (t) text
 	case 'T': 
+		if (demoState->headless)
+			break;
 		if (!a3textIsInitialized(demoState->text))
 		{
 			a3demo_initializeText(demoState->text);
@@ -356,6 +452,8 @@ A3API void a3test_keyCharPress(a3_DemoState *demoState, int asciiKey)
 
 		// reload all shaders in real-time
 	case 'P': 
+		if (demoState->headless)
+			break;
 		a3demo_unloadShaders(demoState);
 		a3demo_loadShaders(demoState);
 		break;
@@ -367,6 +465,121 @@ A3API void a3test_keyCharPress(a3_DemoState *demoState, int asciiKey)
 	case ',':
 		demoState->demoMode = (demoState->demoMode + demoState->demoModeCount - 1) % demoState->demoModeCount;
 		break;
+
+		// add asteroid belt (b) or remove all extra bodies (B)
+	case 'b':
+		a3demo_addAsteroidBelt(demoState, 8192, 9.5f, 10.5f);
+		break;
+	case 'B':
+		a3demo_removeExtraBodies(demoState);
+		break;
+
+		// gravity opening angle
+	case '[':
+		a3demo_setGravityTreeTheta(demoState->gravityTree, a3maximum(demoState->gravityTree->theta - 0.1f, 0.0f));
+		break;
+	case ']':
+		a3demo_setGravityTreeTheta(demoState->gravityTree, demoState->gravityTree->theta + 0.1f);
+		break;
+
+		// cycle integrators
+	case 'i':
+		a3demo_setIntegratorType(demoState->integrator, (demoState->integrator->type + 1) % a3demo_integrator_count);
+		break;
+
+		// analytic orbits and time warp (integrated bodies fall behind 
+		//	once the step clamp kicks in; bodies on rails do not)
+	case 'k':
+		a3demo_toggleKeplerOrbits(demoState);
+		break;
+	case '-':
+		a3demo_setPhysicsClockTimeScale(demoState->physicsClock, a3maximum(demoState->physicsClock->timeScale * 0.1, 1.0));
+		break;
+	case '=':
+		a3demo_setPhysicsClockTimeScale(demoState->physicsClock, a3minimum(demoState->physicsClock->timeScale * 10.0, 10000.0));
+		break;
+
+		// broadphase strategy
+	case 'c':
+		a3demo_setBroadphaseType(demoState->broadphase, (demoState->broadphase->type + 1) % a3demo_broadphase_count);
+		break;
+
+		// benchmarks (block; results go to the console)
+	case 'g':
+		a3demo_benchmarkGravity(demoState->gravityTree->theta, demoState->jobSystem);
+		break;
+	case 'j':
+		a3demo_benchmarkJobSystem(demoState->jobSystem, 4);
+		break;
+	case 'o':
+		a3demo_benchmarkSIMD(64);
+		break;
+	case 'O':
+		a3demo_benchmarkQuaternion(64);
+		break;
+	case 'U':
+		a3demo_benchmarkTrig(64);
+		break;
+	case 'J':
+		a3demo_benchmarkRandomStreams(demoState->jobSystem);
+		break;
+	case 'I':
+		a3demo_benchmarkIntegrators(1000000, (a3real)demoState->physicsClock->secondsPerSubstep);
+		break;
+	case 'C':
+		a3demo_benchmarkBroadphase(10, demoState->jobSystem);
+		break;
+	case 'V':
+		a3demo_benchmarkSolver(60, demoState->jobSystem);
+		break;
+	case 'Z':
+		a3demo_benchmarkSleeping(600, demoState->jobSystem);
+		break;
+	case 'X':
+		a3demo_benchmarkContinuous(demoState->jobSystem);
+		break;
+	case 'L':
+		a3demo_benchmarkSoftBody(480, demoState->jobSystem);
+		break;
+	case 'm':
+		a3demo_benchmarkMassProperties();
+		break;
+	case 'h':
+		a3demo_benchmarkConvexHull(demoState->jobSystem);
+		printf("\n teapot hull: %u of %u points, %u faces, points outside by up to %.4f\n", 
+			demoState->teapotHull->vertexCount, demoState->teapotHull->inputCount, demoState->teapotHull->faceCount, demoState->teapotHull->outside);
+		break;
+	case 'G':
+		a3demo_benchmarkGJK(demoState->teapotHull);
+		break;
+	case 'y':
+		a3demo_benchmarkMeshBVH(demoState->teapotBVH, demoState->jobSystem);
+		break;
+	case 'u':
+		a3demo_benchmarkPicking(60);
+		break;
+	case 'n':
+		a3demo_benchmarkDynamicTree(60);
+		break;
+
+		// drop the cloth and soft ball again, or put them away
+	case 'l':
+		a3demo_toggleSoftBodies(demoState);
+		break;
+
+		// pause, step back and forth through recent physics steps
+	case 'p':
+		a3demo_togglePhysicsPause(demoState);
+		break;
+	case 'r':
+		a3demo_rewindPhysics(demoState, 1);
+		break;
+	case 'R':
+		a3demo_rewindPhysics(demoState, demoState->snapshotRing->size ? demoState->snapshotRing->size - 1 : 0);
+		break;
+	case 'f':
+		a3demo_stepPhysicsForward(demoState);
+		break;
 	}
 }
 
@@ -383,6 +596,11 @@ A3API void a3test_mouseClick(a3_DemoState *demoState, int button, int cursorX, i
 	// persistent state update
 	a3mouseSetState(demoState->mouse, (a3_MouseButton)button, a3input_down);
 	a3mouseSetPosition(demoState->mouse, cursorX, cursorY);
+
+	// left drags the camera, right picks whatever is under the cursor
+	if (button == a3mouse_right && a3demo_pickAtCursor(demoState, cursorX, cursorY))
+		printf("\n picked %s %u, %.2f away\n", demoState->pick->object < demoState->planetCount ? "planet" : "body", 
+			demoState->pick->object, demoState->pick->distance);
 }
 
 // mouse button is double-clicked